@@ -0,0 +1,83 @@
+#pragma once
+
+#include "esp_err.h"
+#include "communication.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Alarm path for critical sensor events (CO2/CO over threshold, water or door override contacts).
+// Alarms do not go through the metrics queue: report_alarm() puts them on a small reserved queue served by
+// a higher-priority task that publishes each one immediately with QoS 1 to sensor/$mac/alarms/<alarm>,
+// without the metrics publish slot or pacing. While an alarm is raised the status LED flashes and the
+// optional alarm GPIO is driven high. Alarms that cannot be published (offline) are kept in NVS and sent
+// after reconnect, including across a reboot.
+//
+// Payload: {"alarm":"co2","state":"raised"|"cleared","value":2150,"threshold":2000,"ts":"...",
+//           "latency_ms":3,"tags":{...}}
+// latency_ms is the time from the sample to the publish call.
+
+// Report an alarm transition (task context, not ISR). The tags are copied at the call, so drivers may
+// reuse their collection for the next pin or channel right away.
+esp_err_t report_alarm(const char* alarm_name, bool raised, float value, float threshold, TagCollection* tags);
+
+// Start the alarm task and reload alarms persisted while offline
+esp_err_t initialize_alarm_system(void);
+
+#ifdef __cplusplus
+namespace alarms {
+
+// Threshold alarm evaluated by a driver at sample time, one per source. Raises when value reaches the
+// threshold and clears once it falls below threshold * (1 - hysteresis_pct / 100); only transitions are
+// reported. Disabling the threshold clears a raised alarm.
+struct ThresholdAlarm {
+    bool active = false;
+
+    void update(const char* alarm_name, float value, bool enabled, float threshold, float hysteresis_pct,
+                TagCollection* tags) {
+        if (!enabled) {
+            if (active) {
+                active = false;
+                report_alarm(alarm_name, false, value, threshold, tags);
+            }
+            return;
+        }
+        if (!active && value >= threshold) {
+            active = true;
+            report_alarm(alarm_name, true, value, threshold, tags);
+        } else if (active && value < threshold * (1.0f - hysteresis_pct / 100.0f)) {
+            active = false;
+            report_alarm(alarm_name, false, value, threshold, tags);
+        }
+    }
+};
+
+// Contact alarm for one input pin. Evaluated on every poll rather than on level changes: a contact already
+// closed at start raises, an open one reports nothing, and a change to the alarm contacts or the pin name
+// applies on the next poll. The clear goes out under the name the alarm was raised with, so the alarm task
+// pairs it with the raise even after a rename.
+struct ContactAlarm {
+    static constexpr size_t kNameLen = 32;
+    bool active = false;
+    char name[kNameLen] = {};
+
+    // alarmed: the pin is an alarm contact (its name matches) and is closed. report(raised, name) sends
+    // the transition with the driver's tags.
+    template <typename Report>
+    void update(bool alarmed, const char* pin_name, Report&& report) {
+        if (pin_name == nullptr) pin_name = "";
+        if (active && (!alarmed || strncmp(name, pin_name, kNameLen - 1) != 0)) {
+            active = false;
+            report(false, static_cast<const char*>(name));
+        }
+        if (!active && alarmed) {
+            active = true;
+            strncpy(name, pin_name, kNameLen - 1);
+            name[kNameLen - 1] = '\0';
+            report(true, static_cast<const char*>(name));
+        }
+    }
+};
+
+} // namespace alarms
+#endif
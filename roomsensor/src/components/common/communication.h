@@ -36,8 +36,11 @@ typedef struct {
     // Store pointer to statically known metric name instead of copying
     const char* metric_name;
     float value;
-    // We store a pointer to the tag collection that must be managed by the caller
+    // Tags of the source. report_metric points this at the metrics system's own copy of the caller's tags
+    // (one per distinct content), so the caller may reuse its collection for the next source right away.
     TagCollection* tags;
+    // esp_timer time of the report, so a publish deferred to the device's slot keeps the sample time
+    int64_t timestamp_us;
 } MetricReport;
 
 // Structure to hold a stored metric value with timestamp
@@ -65,6 +68,15 @@ void free_tag_collection(TagCollection* collection);
 esp_err_t initialize_metrics_system(void);
 esp_err_t report_metric(const char* metric_name, float value, TagCollection* tags);
 
+// Reports lost since boot, by cause (published with the device status)
+typedef struct {
+    uint32_t queue_full;     // handoff queue full at report time
+    uint32_t batch_full;     // more reports in one publish interval than the batch holds
+    uint32_t offline;        // discarded after waiting 30 s for the connection
+    uint32_t untracked_tags; // not a drop: sent with the caller's tags because the snapshot table was full
+} MetricsDropCounts;
+void get_metrics_drop_counts(MetricsDropCounts* out);
+
 // Get latest metrics values
 StoredMetricCollection* get_latest_metrics(void);
 void free_metric_collection(StoredMetricCollection* collection);
@@ -19,6 +19,13 @@
 // MQTT Configuration
 #define MQTT_RECONNECT_TIMEOUT_MS 5000
 #define MQTT_OPERATION_TIMEOUT_MS 10000
+// Extra reconnect delay spread over the fleet by MAC so devices do not reconnect in lockstep after an outage
+#define MQTT_RECONNECT_SPREAD_MS  5000
+
+// Metrics publish slotting (see publish_slot.h): queued metrics go out as one batch per interval, at a
+// MAC-derived offset aligned to SNTP time. 0 publishes each metric as soon as it is reported.
+#define METRICS_PUBLISH_SLOT_MS   SENSOR_TASK_INTERVAL_MS
+#define METRICS_PUBLISH_JITTER_MS 500
 
 // OTA Configuration
 #define OTA_CHECK_INTERVAL_MS     1000000   // Check for updates every 1000 seconds
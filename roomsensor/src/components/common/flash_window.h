@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Flash-write coordinator. Writing or erasing flash (NVS, LittleFS, OTA partition) disables the flash and
+// PSRAM cache for the duration; the LED update task stalls on its PSRAM framebuffers and non-IRAM ISRs
+// wait. Writers therefore defer into the gap right after the LED task has handed its frames to RMT and
+// before it starts rendering the next ones. Writers that arrive together go out in the same gap.
+// - The LED update task opens the window after its flushes and closes it when the next tick starts.
+// - A writer waits at most max_defer_ms for the window, then writes anyway. Without LED output (the
+//   window was not opened recently) and on the LED task itself nothing waits.
+// - The wire output itself keeps running during a write: RMT ISRs, encoders and TX buffers live in
+//   IRAM / internal RAM (CONFIG_RMT_ISR_IRAM_SAFE).
+// - Best effort: the gap is about one tick interval (~5 ms). A page program fits; an NVS page erase or a
+//   LittleFS block erase (tens of ms) does not, so the next tick still stalls and shows up in overlaps
+//   and the LED manager's late_ticks.
+// - Operations that are known to be long (OTA partition erase, image validation, otadata update) pause
+//   the LED update loop instead: the LED task parks at the start of its next tick and the strips hold
+//   their last frame until the pause ends. Long writes that can be split (OTA image data) go out in
+//   pieces of FLASH_WINDOW_WRITE_PIECE bytes, one window each.
+//
+// Usable from C (cmd_nvs.c); flash_window::Scope and flash_window::Pause are the C++ wrappers.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Default bound on how long a writer defers: about two frames at the default LED cadence
+#define FLASH_WINDOW_DEFAULT_DEFER_MS 25
+// Largest write expected to finish inside one gap: four 256-byte page programs, ~3 ms worst case
+#define FLASH_WINDOW_WRITE_PIECE 1024
+
+// Writer side. begin() returns the milliseconds spent waiting; every begin() needs an end().
+uint32_t flash_window_begin(uint32_t max_defer_ms);
+void flash_window_end(void);
+
+// LED update task: frames are out, no frame work for about gap_us
+void flash_window_open(uint32_t gap_us);
+// Long operations. pause_begin() waits at most max_wait_ms for the LED task to park and returns the
+// milliseconds spent waiting; every pause_begin() needs a pause_end(). Pauses nest and overlap; the LED
+// task resumes when the last one ends. Not for use on the LED update task.
+uint32_t flash_window_pause_begin(uint32_t max_wait_ms);
+void flash_window_pause_end(void);
+
+// LED update task: frame work starts. Parks here while a pause is active; returns true if it did.
+bool flash_window_close(void);
+
+typedef struct {
+    uint32_t writes;       // begin() calls
+    uint32_t deferred;     // writes that waited for a window
+    uint32_t timed_out;    // writes that gave up waiting
+    uint32_t max_wait_ms;  // longest wait
+    uint32_t overlaps;     // LED ticks that started while a write was still running
+    uint32_t pauses;       // pause_begin() calls
+    uint32_t max_pause_ms; // longest time the LED task stayed parked
+} flash_window_stats_t;
+
+// Counters since the previous call
+void flash_window_take_stats(flash_window_stats_t* out);
+
+#ifdef __cplusplus
+}
+
+namespace flash_window {
+
+class Scope {
+public:
+    explicit Scope(uint32_t max_defer_ms = FLASH_WINDOW_DEFAULT_DEFER_MS) { flash_window_begin(max_defer_ms); }
+    ~Scope() { flash_window_end(); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+
+// Pauses the LED update loop for an operation longer than a frame gap
+class Pause {
+public:
+    explicit Pause(uint32_t max_wait_ms = FLASH_WINDOW_DEFAULT_DEFER_MS) { flash_window_pause_begin(max_wait_ms); }
+    ~Pause() { flash_window_pause_end(); }
+    Pause(const Pause&) = delete;
+    Pause& operator=(const Pause&) = delete;
+};
+
+} // namespace flash_window
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "lock_stats.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Mutex with contention accounting, a drop-in for xSemaphoreCreateMutex/Take/Give on shared hot paths
+// (metrics store, console buffer). Per lock and per reporting window it counts acquisitions, contended
+// takes and timeouts, and keeps wait- and hold-time histograms (lock_stats.h).
+// - A wait at or over slow_wait_us is recorded with the waiter and the task that held the lock when the
+//   waiter blocked, with both priorities; a lower-priority holder counts as an inversion.
+// - Nothing is logged on the lock path (the console buffer lock sits under every log line); the
+//   telemetry task publishes and logs the windows (instrumented_lock_take_stats).
+// - Cost on an uncontended take: one extra non-blocking take attempt, two timer reads and two short
+//   critical sections.
+//
+// Usable from C (console_buffer.c).
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct instrumented_lock instrumented_lock_t;
+
+// NULL when out of memory. name must outlive the lock.
+instrumented_lock_t* instrumented_lock_create(const char* name, uint32_t slow_wait_us);
+void instrumented_lock_delete(instrumented_lock_t* lock);
+
+bool instrumented_lock_take(instrumented_lock_t* lock, TickType_t timeout);
+void instrumented_lock_give(instrumented_lock_t* lock);
+
+// Visit every lock with its counters since the previous call, then reset them
+typedef void (*instrumented_lock_stats_cb)(const char* name, const lock_stats_t* window, void* ctx);
+void instrumented_lock_take_stats(instrumented_lock_stats_cb cb, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Contention accounting for instrumented_lock.h. Pure: callers pass in measured times and task
+// identities, so the same code runs against FreeRTOS on the device and against std::thread on a host.
+// Times are microseconds.
+//
+// Histogram buckets are decades: <10us, <100us, <1ms, <10ms, <100ms, <1s, <10s, >=10s.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOCK_STATS_BUCKETS 8
+#define LOCK_STATS_SLOW_WAITS 4  // most recent slow waits kept per window
+#define LOCK_STATS_NAME_LEN 16   // configMAX_TASK_NAME_LEN
+
+typedef struct {
+    uint32_t count[LOCK_STATS_BUCKETS];
+    uint32_t max_us;
+    uint64_t total_us;
+} lock_histogram_t;
+
+// A wait over the lock's threshold, with who held the lock when the waiter blocked
+typedef struct {
+    char waiter[LOCK_STATS_NAME_LEN];
+    char owner[LOCK_STATS_NAME_LEN];
+    uint8_t waiter_prio;
+    uint8_t owner_prio;  // before priority inheritance raised it
+    uint32_t wait_us;
+    uint64_t at_us;
+} lock_slow_wait_t;
+
+typedef struct {
+    uint32_t acquisitions;
+    uint32_t contended;   // had to block
+    uint32_t timeouts;    // gave up
+    uint32_t slow_waits;  // waits over the threshold
+    uint32_t inversions;  // contended while a lower-priority task held the lock
+    lock_histogram_t wait;
+    lock_histogram_t hold;
+    lock_slow_wait_t slow[LOCK_STATS_SLOW_WAITS]; // ring, slow_waits % LOCK_STATS_SLOW_WAITS is next
+} lock_stats_t;
+
+// Who held the lock when a waiter found it taken
+typedef struct {
+    const char* waiter;
+    const char* owner;
+    uint8_t waiter_prio;
+    uint8_t owner_prio;
+} lock_contention_t;
+
+static inline int lock_histogram_bucket(uint32_t us) {
+    int b = 0;
+    for (uint32_t limit = 10; b < LOCK_STATS_BUCKETS - 1 && us >= limit; limit *= 10) ++b;
+    return b;
+}
+
+static inline void lock_histogram_add(lock_histogram_t* h, uint32_t us) {
+    h->count[lock_histogram_bucket(us)]++;
+    h->total_us += us;
+    if (us > h->max_us) h->max_us = us;
+}
+
+static inline void lock_stats_copy_name(char* dst, const char* src) {
+    if (!src) src = "?";
+    size_t n = 0;
+    while (n < LOCK_STATS_NAME_LEN - 1 && src[n]) ++n;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+}
+
+// After a successful take. who is NULL for an uncontended take.
+static inline void lock_stats_on_acquired(lock_stats_t* s, uint32_t wait_us, const lock_contention_t* who,
+                                          uint32_t slow_wait_us, uint64_t now_us) {
+    s->acquisitions++;
+    lock_histogram_add(&s->wait, wait_us);
+    if (!who) return;
+    s->contended++;
+    if (who->owner_prio < who->waiter_prio) s->inversions++;
+    if (slow_wait_us && wait_us >= slow_wait_us) {
+        lock_slow_wait_t* w = &s->slow[s->slow_waits % LOCK_STATS_SLOW_WAITS];
+        lock_stats_copy_name(w->waiter, who->waiter);
+        lock_stats_copy_name(w->owner, who->owner);
+        w->waiter_prio = who->waiter_prio;
+        w->owner_prio = who->owner_prio;
+        w->wait_us = wait_us;
+        w->at_us = now_us;
+        s->slow_waits++;
+    }
+}
+
+static inline void lock_stats_on_timeout(lock_stats_t* s, const lock_contention_t* who) {
+    s->timeouts++;
+    if (who && who->owner_prio < who->waiter_prio) s->inversions++;
+}
+
+// Before the give
+static inline void lock_stats_on_release(lock_stats_t* s, uint32_t hold_us) { lock_histogram_add(&s->hold, hold_us); }
+
+// Slow waits of the window, oldest first
+static inline uint32_t lock_stats_slow_count(const lock_stats_t* s) {
+    return s->slow_waits < LOCK_STATS_SLOW_WAITS ? s->slow_waits : LOCK_STATS_SLOW_WAITS;
+}
+
+static inline const lock_slow_wait_t* lock_stats_slow_at(const lock_stats_t* s, uint32_t i) {
+    const uint32_t n = lock_stats_slow_count(s);
+    return &s->slow[(s->slow_waits - n + i) % LOCK_STATS_SLOW_WAITS];
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// In-process metrics bus: a short history of every metric reported through report_metric(), readable by
+// other components (e.g. LED dashboard patterns) without a round trip through MQTT.
+// - Publishing is lock-free and safe from ISRs: a series is a ring of slots guarded by per-slot sequence
+//   numbers (seqlock), so a writer never waits for readers.
+// - Reading is copy-free: subscribers keep a Series* and read slots in place; a read that raced with an
+//   overwrite reports failure instead of returning a torn sample.
+// - Storage is static. A series is created on the first publish of a (metric, source) pair and never
+//   removed, so a Series* found once stays valid for the lifetime of the program. When the table is full,
+//   new series are dropped and counted.
+// Series are keyed by the metric name and a source key hashed from the source's tag values (SourceKey;
+// report_metric hashes the whole TagCollection), and carry a label (the source's "name" tag) for lookups
+// such as find("temperature", "environment"). The key is content, not an address: drivers reuse one
+// TagCollection for several sources (the MCP23008 rewrites "index"/"name" before each pin's report), and
+// each of those must land in its own series.
+namespace metrics_bus {
+
+static constexpr size_t kMaxSeries = 40;
+static constexpr size_t kHistory = 32; // samples kept per series; power of two
+static constexpr size_t kLabelLen = 24;
+
+// FNV-1a over a sequence of strings, each terminated so that ("ab","c") and ("a","bc") differ
+class SourceKey {
+public:
+    SourceKey& add(const char* s) {
+        if (s) {
+            for (; *s; ++s) h_ = (h_ ^ static_cast<uint8_t>(*s)) * 16777619u;
+        }
+        h_ = (h_ ^ 0xFFu) * 16777619u;
+        return *this;
+    }
+    uint32_t value() const { return h_; }
+
+private:
+    uint32_t h_ = 2166136261u;
+};
+
+struct Sample {
+    float value = 0.0f;
+    uint32_t t_ms = 0; // publisher's timestamp (esp_timer milliseconds)
+};
+
+class Series {
+public:
+    const char* metric() const { return metric_.load(std::memory_order_acquire); }
+    const char* label() const { return label_; }
+
+    // Number of samples published so far; a change means new data.
+    uint32_t sequence() const { return head_.load(std::memory_order_acquire); }
+
+    // Read the sample with publish index 'seq'. Returns false if it was never written, is still being
+    // written, or has already been overwritten (older than kHistory samples).
+    bool read(uint32_t seq, Sample& out) const {
+        const Slot& s = slots_[seq & (kHistory - 1)];
+        uint32_t tag = s.seq.load(std::memory_order_acquire);
+        if (tag != seq + 1) return false;
+        out.value = s.value.load(std::memory_order_relaxed);
+        out.t_ms = s.t_ms.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return s.seq.load(std::memory_order_relaxed) == tag;
+    }
+
+    // Most recent complete sample; false if none.
+    bool latest(Sample& out) const {
+        uint32_t head = sequence();
+        for (uint32_t back = 1; back <= kHistory && back <= head; ++back) {
+            if (read(head - back, out)) return true;
+        }
+        return false;
+    }
+
+    void publish(float value, uint32_t t_ms) {
+        uint32_t seq = head_.fetch_add(1, std::memory_order_acq_rel);
+        Slot& s = slots_[seq & (kHistory - 1)];
+        s.seq.store(0, std::memory_order_relaxed); // mark in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        s.value.store(value, std::memory_order_relaxed);
+        s.t_ms.store(t_ms, std::memory_order_relaxed);
+        s.seq.store(seq + 1, std::memory_order_release);
+    }
+
+private:
+    friend Series* find_or_create(const char* metric, uint32_t source_key, const char* label);
+
+    struct Slot {
+        std::atomic<uint32_t> seq{0}; // publish index + 1 when complete; 0 => empty or being written
+        std::atomic<float> value{0.0f};
+        std::atomic<uint32_t> t_ms{0};
+    };
+
+    std::atomic<const char*> metric_{nullptr}; // set last at registration; null => slot not ready
+    uint32_t source_key_ = 0;
+    char label_[kLabelLen] = {};
+    std::atomic<uint32_t> head_{0};
+    Slot slots_[kHistory];
+};
+
+namespace detail {
+inline Series g_series[kMaxSeries];
+inline std::atomic<uint32_t> g_claimed{0};
+inline std::atomic<uint32_t> g_dropped{0};
+} // namespace detail
+
+inline size_t series_count() {
+    uint32_t n = detail::g_claimed.load(std::memory_order_acquire);
+    return n < kMaxSeries ? n : kMaxSeries;
+}
+
+// Series by index (0..series_count()-1); null while that series is still being registered.
+inline const Series* series_at(size_t i) {
+    if (i >= series_count()) return nullptr;
+    const Series* s = &detail::g_series[i];
+    return s->metric() ? s : nullptr;
+}
+
+inline uint32_t dropped_series() { return detail::g_dropped.load(std::memory_order_relaxed); }
+
+// 'metric' must point to storage that outlives the program (report_metric names are string literals).
+// Two publishers registering the same new pair at the same instant may create a duplicate series; lookups
+// return the first, which is harmless for the single-publisher-per-source case used by the sensors.
+inline Series* find_or_create(const char* metric, uint32_t source_key, const char* label) {
+    size_t n = series_count();
+    for (size_t i = 0; i < n; ++i) {
+        Series& s = detail::g_series[i];
+        const char* m = s.metric();
+        if (m && s.source_key_ == source_key && (m == metric || strcmp(m, metric) == 0)) return &s;
+    }
+    uint32_t idx = detail::g_claimed.fetch_add(1, std::memory_order_acq_rel);
+    if (idx >= kMaxSeries) {
+        detail::g_claimed.store(kMaxSeries, std::memory_order_relaxed);
+        detail::g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Series& s = detail::g_series[idx];
+    s.source_key_ = source_key;
+    if (label) {
+        const size_t len = strnlen(label, kLabelLen - 1);
+        memcpy(s.label_, label, len);
+        s.label_[len] = '\0';
+    }
+    s.metric_.store(metric, std::memory_order_release);
+    return &s;
+}
+
+inline bool publish(const char* metric, uint32_t source_key, const char* label, float value, uint32_t t_ms) {
+    if (!metric) return false;
+    Series* s = find_or_create(metric, source_key, label);
+    if (!s) return false;
+    s->publish(value, t_ms);
+    return true;
+}
+
+// First series with this metric name and, if 'label' is given, that label.
+inline const Series* find(const char* metric, const char* label = nullptr) {
+    if (!metric) return nullptr;
+    size_t n = series_count();
+    for (size_t i = 0; i < n; ++i) {
+        const Series* s = series_at(i);
+        if (!s || strcmp(s->metric(), metric) != 0) continue;
+        if (label && label[0] && strcmp(s->label(), label) != 0) continue;
+        return s;
+    }
+    return nullptr;
+}
+
+} // namespace metrics_bus
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+
+// Fleet-wide publish slotting. Every device gets a fixed offset within the reporting interval, derived
+// from its MAC, and publishes its batch when wall-clock time reaches that offset. Devices therefore spread
+// evenly over the interval instead of bunching up at whatever phase their boot (or the last outage) left
+// them in.
+// - With SNTP time the slots line up fleet-wide (epoch milliseconds modulo the interval).
+// - Before time sync the same offset is applied to the boot clock: publishing stays periodic and nothing
+//   is held back, the spread is just not coordinated yet.
+// Header-only and free of ESP-IDF calls so the schedule can be simulated on a host.
+namespace publish_slot {
+
+// Offset of this device's slot in [0, interval_ms). Sequential MACs land far apart.
+inline uint32_t offset_for_mac(const uint8_t mac[6], uint32_t interval_ms) {
+    if (interval_ms == 0) return 0;
+    uint32_t h = 2166136261u; // FNV-1a
+    for (int i = 0; i < 6; ++i) {
+        h ^= mac[i];
+        h *= 16777619u;
+    }
+    // murmur3 finalizer: FNV alone leaves the low bits of near-identical inputs correlated
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h % interval_ms;
+}
+
+// Milliseconds from now_ms until the start of the next slot (0 if now_ms is exactly on it), plus
+// jitter_ms * jitter_fraction where jitter_fraction in [0, 1) comes from the caller's RNG. The jitter keeps
+// devices whose offsets happen to collide from publishing in lockstep.
+inline uint32_t ms_until_slot(uint64_t now_ms, uint32_t interval_ms, uint32_t offset_ms, uint32_t jitter_ms,
+                              float jitter_fraction) {
+    if (interval_ms == 0) return 0;
+    uint32_t phase = static_cast<uint32_t>(now_ms % interval_ms);
+    uint32_t wait = (offset_ms % interval_ms + interval_ms - phase) % interval_ms;
+    if (jitter_fraction < 0.0f) jitter_fraction = 0.0f;
+    if (jitter_fraction > 1.0f) jitter_fraction = 1.0f;
+    return wait + static_cast<uint32_t>(static_cast<float>(jitter_ms) * jitter_fraction);
+}
+
+} // namespace publish_slot
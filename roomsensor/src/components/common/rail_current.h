@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+// Latest measured load current per ADS1115 channel configured as BTS7002 (high-side switch current sense).
+// Written by the ADS1115 driver on every poll; read by the LED current limiter to close the loop on a
+// rail's actual draw. Lock-free: each slot is a pair of atomics, readers may see a value one sample old.
+//
+// Slots are addressed by A2D module index (1..4, a2d1..a2d4 => ADS1115 0x48..0x4B) and channel (1..4).
+namespace rail_current {
+
+struct Sample {
+    float amps = 0.0f;
+    uint64_t timestamp_us = 0; // esp_timer time of the sample; 0 => never sampled
+};
+
+namespace detail {
+inline std::atomic<float> g_amps[4][4];
+inline std::atomic<uint64_t> g_timestamp_us[4][4];
+} // namespace detail
+
+inline bool valid_slot(int module_index, int channel) {
+    return module_index >= 1 && module_index <= 4 && channel >= 1 && channel <= 4;
+}
+
+inline void publish(int module_index, int channel, float amps, uint64_t timestamp_us) {
+    if (!valid_slot(module_index, channel)) return;
+    detail::g_amps[module_index - 1][channel - 1].store(amps, std::memory_order_relaxed);
+    detail::g_timestamp_us[module_index - 1][channel - 1].store(timestamp_us, std::memory_order_release);
+}
+
+inline Sample latest(int module_index, int channel) {
+    Sample s;
+    if (!valid_slot(module_index, channel)) return s;
+    s.timestamp_us = detail::g_timestamp_us[module_index - 1][channel - 1].load(std::memory_order_acquire);
+    s.amps = detail::g_amps[module_index - 1][channel - 1].load(std::memory_order_relaxed);
+    return s;
+}
+
+} // namespace rail_current
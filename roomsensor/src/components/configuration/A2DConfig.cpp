@@ -27,11 +27,11 @@ A2DConfig::A2DConfig(const char* instance_name) : name_(instance_name ? instance
 		char k1[16]; snprintf(k1, sizeof(k1), "ch%d.enabled", ch);
 		descriptors_.push_back({strdup(k1), ConfigValueType::String, nullptr, true});
 		char k2[12]; snprintf(k2, sizeof(k2), "ch%d.gain", ch);
-		descriptors_.push_back({strdup(k2), ConfigValueType::String, nullptr, true});
+		descriptors_.push_back({strdup(k2), ConfigValueType::String, nullptr, true, kA2DEnumMaxLen});
 		char k3[14]; snprintf(k3, sizeof(k3), "ch%d.sensor", ch);
-		descriptors_.push_back({strdup(k3), ConfigValueType::String, nullptr, true});
+		descriptors_.push_back({strdup(k3), ConfigValueType::String, nullptr, true, kA2DEnumMaxLen});
 		char k4[12]; snprintf(k4, sizeof(k4), "ch%d.name", ch);
-		descriptors_.push_back({strdup(k4), ConfigValueType::String, nullptr, true});
+		descriptors_.push_back({strdup(k4), ConfigValueType::String, nullptr, true, kA2DNameMaxLen});
 	}
 }
 
@@ -39,8 +39,9 @@ const char* A2DConfig::name() const { return name_.c_str(); }
 
 const std::vector<ConfigurationValueDescriptor>& A2DConfig::descriptors() const { return descriptors_; }
 
-esp_err_t A2DConfig::apply_update(const char* key, const char* value_str) {
+esp_err_t A2DConfig::apply_value(const char* key, const ConfigValue& value) {
 	if (!key) return ESP_ERR_INVALID_ARG;
+	const char* value_str = value.c_str();
 
 	// Expect keys like ch1.enabled, ch1.gain, ch1.sensor, ch1.name
 	if (strncmp(key, "ch", 2) != 0) return ESP_ERR_NOT_FOUND;
@@ -94,7 +95,7 @@ esp_err_t A2DConfig::apply_update(const char* key, const char* value_str) {
 			cfg.name_set = false;
 			return ESP_OK;
 		}
-		cfg.name = value_str;
+		if (!cfg.name.assign(value_str)) return ESP_ERR_INVALID_SIZE;
 		cfg.name_set = true;
 		return ESP_OK;
 	}
@@ -1,7 +1,6 @@
 #pragma once
 
 #include "ConfigurationModule.h"
-#include <string>
 #include <array>
 
 namespace config {
@@ -49,18 +48,22 @@ enum class A2DSensorKind {
 	RSUV,
 };
 
+// Longest accepted values, per channel
+constexpr uint16_t kA2DEnumMaxLen = 15;
+constexpr uint16_t kA2DNameMaxLen = 31;
+
 struct A2DChannelConfig {
 	bool enabled = true;
 	bool enabled_set = false;
 
-	std::string gain; // textual enum
+	BoundedString<kA2DEnumMaxLen> gain; // textual enum
 	bool gain_set = false;
 
-	std::string sensor; // textual enum
+	BoundedString<kA2DEnumMaxLen> sensor; // textual enum
 	bool sensor_set = false;
 
 	// Optional friendly name; when set, included as a metric tag "name"
-	std::string name;
+	BoundedString<kA2DNameMaxLen> name;
 	bool name_set = false;
 
 	bool any_set() const { return enabled_set || gain_set || sensor_set || name_set; }
@@ -72,14 +75,14 @@ public:
 
 	const char* name() const override;
 	const std::vector<ConfigurationValueDescriptor>& descriptors() const override;
-	esp_err_t apply_update(const char* key, const char* value_str) override;
+	esp_err_t apply_value(const char* key, const ConfigValue& value) override;
 	esp_err_t to_json(struct cJSON* root_object) const override;
 
 	// Access per-channel config (1-based channel index: 1..4)
 	const A2DChannelConfig& channel_config(int channel) const;
 
 private:
-	std::string name_;
+	BoundedString<15> name_;
 	std::vector<ConfigurationValueDescriptor> descriptors_;
 	std::array<A2DChannelConfig, 4> channels_;
 };
@@ -0,0 +1,118 @@
+#include "AlarmConfig.h"
+#include "cJSON.h"
+#include <cstring>
+
+namespace config {
+
+AlarmConfig::AlarmConfig() {
+    descriptors_.push_back({"co2_ppm", ConfigValueType::I32, nullptr, true});
+    descriptors_.push_back({"co_ppm", ConfigValueType::F32, nullptr, true});
+    descriptors_.push_back({"hysteresis_pct", ConfigValueType::I32, "10", true});
+    descriptors_.push_back({"contacts", ConfigValueType::String, ".door.override,.water", true, kContactsMaxLen});
+    descriptors_.push_back({"gpio", ConfigValueType::I32, nullptr, true});
+    contact_suffixes_.store(parse_contacts(contacts_.c_str()));
+}
+
+const char* AlarmConfig::name() const {
+    return "alarm";
+}
+
+const std::vector<ConfigurationValueDescriptor>& AlarmConfig::descriptors() const {
+    return descriptors_;
+}
+
+// Comma-separated pin name suffixes, spaces around them ignored; empty disables contact alarms
+std::shared_ptr<const AlarmConfig::ContactSuffixes> AlarmConfig::parse_contacts(const char* list) {
+    auto suffixes = std::make_shared<ContactSuffixes>();
+    const char* p = list ? list : "";
+    while (*p) {
+        while (*p == ' ' || *p == ',') p++;
+        const char* start = p;
+        while (*p && *p != ',') p++;
+        const char* end = p;
+        while (end > start && end[-1] == ' ') end--;
+        if (end > start) suffixes->emplace_back(start, end - start);
+    }
+    return suffixes;
+}
+
+bool AlarmConfig::is_alarm_contact(const char* pin_name) const {
+    if (pin_name == nullptr) return false;
+    size_t n = strlen(pin_name);
+    const std::shared_ptr<const ContactSuffixes> suffixes = contact_suffixes_.load();
+    for (const std::string& suffix : *suffixes) {
+        if (suffix.size() <= n && strcmp(pin_name + n - suffix.size(), suffix.c_str()) == 0) return true;
+    }
+    return false;
+}
+
+esp_err_t AlarmConfig::apply_value(const char* key, const ConfigValue& value) {
+    if (key == nullptr) return ESP_ERR_INVALID_ARG;
+    const char* value_str = value.c_str();
+
+    if (strcmp(key, "co2_ppm") == 0) {
+        int32_t v = value.as_i32(0);
+        if (value.is_set && v <= 0) return ESP_ERR_INVALID_ARG;
+        co2_ppm_set_ = value.is_set;
+        co2_ppm_ = static_cast<float>(v);
+        return ESP_OK;
+    }
+    if (strcmp(key, "co_ppm") == 0) {
+        float v = value.as_f32(0.0f);
+        if (value.is_set && !(v > 0.0f)) return ESP_ERR_INVALID_ARG;
+        co_ppm_set_ = value.is_set;
+        co_ppm_ = v;
+        return ESP_OK;
+    }
+    if (strcmp(key, "hysteresis_pct") == 0) {
+        int32_t v = value.as_i32(10);
+        if (v < 0 || v > 50) return ESP_ERR_INVALID_ARG;
+        hysteresis_pct_ = v;
+        return ESP_OK;
+    }
+    if (strcmp(key, "contacts") == 0) {
+        if (!contacts_.assign(value_str)) return ESP_ERR_INVALID_SIZE;
+        contact_suffixes_.store(parse_contacts(contacts_.c_str()));
+        return ESP_OK;
+    }
+    if (strcmp(key, "gpio") == 0) {
+        gpio_set_ = value.is_set;
+        gpio_ = value.as_i32(-1);
+        if (gpio_ < 0) gpio_set_ = false;
+        return ESP_OK;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t AlarmConfig::get_value(const char* key, ConfigValue& out) const {
+    if (key == nullptr) return ESP_ERR_INVALID_ARG;
+    if (strcmp(key, "co2_ppm") == 0) {
+        out = co2_ppm_set_ ? ConfigValue::of_i32(static_cast<int32_t>(co2_ppm_)) : ConfigValue::unset(ConfigValueType::I32);
+        return ESP_OK;
+    }
+    if (strcmp(key, "co_ppm") == 0) {
+        out = co_ppm_set_ ? ConfigValue::of_f32(co_ppm_) : ConfigValue::unset(ConfigValueType::F32);
+        return ESP_OK;
+    }
+    if (strcmp(key, "hysteresis_pct") == 0) { out = ConfigValue::of_i32(hysteresis_pct_); return ESP_OK; }
+    if (strcmp(key, "contacts") == 0) { out = ConfigValue::of_string(contacts_.c_str()); return ESP_OK; }
+    if (strcmp(key, "gpio") == 0) {
+        out = gpio_set_ ? ConfigValue::of_i32(gpio_) : ConfigValue::unset(ConfigValueType::I32);
+        return ESP_OK;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t AlarmConfig::to_json(cJSON* root_object) const {
+    if (!root_object) return ESP_ERR_INVALID_ARG;
+    cJSON* obj = cJSON_CreateObject();
+    if (co2_ppm_set_) cJSON_AddNumberToObject(obj, "co2_ppm", co2_ppm_);
+    if (co_ppm_set_) cJSON_AddNumberToObject(obj, "co_ppm", co_ppm_);
+    cJSON_AddNumberToObject(obj, "hysteresis_pct", hysteresis_pct_);
+    cJSON_AddStringToObject(obj, "contacts", contacts_.c_str());
+    if (gpio_set_) cJSON_AddNumberToObject(obj, "gpio", gpio_);
+    cJSON_AddItemToObject(root_object, name(), obj);
+    return ESP_OK;
+}
+
+} // namespace config
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "ConfigurationModule.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct cJSON;
+
+namespace config {
+
+// MQTT configuration usage
+//
+// Thresholds for the alarm path (alarms.h). Drivers evaluate them at sample time; alarms bypass the
+// metrics queue and publish immediately to sensor/$mac/alarms/<alarm> with QoS 1.
+//
+// The device subscribes to: sensor/$mac/config/+/+
+// So to update a field publish to: sensor/$mac/config/alarm/<key>
+//
+// Examples (replace <HOST> and <mac> with your broker and device MAC string):
+// - Raise "co2" at 2000 ppm (SCD4x); clears below 2000 * (1 - hysteresis_pct/100):
+//   mosquitto_pub -h <HOST> -t "sensor/<mac>/config/alarm/co2_ppm" -m "2000"
+//
+// - Raise "co" at 50 ppm (CO_SPEC channel on an ADS1115):
+//   mosquitto_pub -h <HOST> -t "sensor/<mac>/config/alarm/co_ppm" -m "50"
+//
+// - Raise "contact" when an IO SENSOR pin whose name ends in one of these suffixes closes:
+//   mosquitto_pub -h <HOST> -t "sensor/<mac>/config/alarm/contacts" -m ".door.override,.water"
+//
+// - Drive a buzzer/relay on GPIO 14 (active high) while any alarm is raised:
+//   mosquitto_pub -h <HOST> -t "sensor/<mac>/config/alarm/gpio" -m "14"
+//
+// - Disable the CO2 alarm:
+//   mosquitto_pub -h <HOST> -t "sensor/<mac>/config/alarm/co2_ppm" -n
+class AlarmConfig : public ConfigurationModule {
+public:
+    static constexpr uint16_t kContactsMaxLen = 95;
+
+    AlarmConfig();
+    ~AlarmConfig() override = default;
+
+    // ConfigurationModule API
+    const char* name() const override;
+    const std::vector<ConfigurationValueDescriptor>& descriptors() const override;
+    esp_err_t apply_value(const char* key, const ConfigValue& value) override;
+    esp_err_t get_value(const char* key, ConfigValue& out) const override;
+    esp_err_t to_json(struct cJSON* root_object) const override;
+
+    // Accessors
+    bool has_co2_ppm() const { return co2_ppm_set_; }
+    float co2_ppm() const { return co2_ppm_; }
+    bool has_co_ppm() const { return co_ppm_set_; }
+    float co_ppm() const { return co_ppm_; }
+    float hysteresis_pct() const { return static_cast<float>(hysteresis_pct_); }
+    // True when a SENSOR pin with this name raises the contact alarm. Safe from any task.
+    bool is_alarm_contact(const char* pin_name) const;
+    bool has_gpio() const { return gpio_set_; }
+    int gpio() const { return gpio_; }
+
+private:
+    std::vector<ConfigurationValueDescriptor> descriptors_;
+
+    bool co2_ppm_set_ = false;
+    float co2_ppm_ = 0.0f;
+    bool co_ppm_set_ = false;
+    float co_ppm_ = 0.0f;
+    int hysteresis_pct_ = 10;
+    using ContactSuffixes = std::vector<std::string>;
+    static std::shared_ptr<const ContactSuffixes> parse_contacts(const char* list);
+
+    BoundedString<kContactsMaxLen> contacts_ = ".door.override,.water";
+    // Parsed from contacts_ on the configuration task and read by the I2C drivers on every poll: a new
+    // list replaces the pointer, so a reader keeps the list it loaded until it is done with it
+    std::atomic<std::shared_ptr<const ContactSuffixes>> contact_suffixes_;
+    bool gpio_set_ = false;
+    int gpio_ = -1;
+};
+
+} // namespace config
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <string_view>
+
+namespace config {
+
+// String storage for configuration values. Values are reassigned on every update and read on every LED
+// tick and publish; std::string members turned each update into a free and a malloc of small blocks in
+// internal RAM, which fragment it over weeks of uptime. These types never allocate after construction:
+// - BoundedString<N>: up to N chars inline in the module. For names, enums, hosts, tags.
+// - PooledString: capacity fixed at construction, storage carved once from the PSRAM blob pool
+//   (ConfigBlobPool.h). For large values such as Life seeds and marquee text.
+// assign() refuses values over capacity (the module returns ESP_ERR_INVALID_SIZE); the descriptors
+// declare the same limits as max_len, so ConfigurationManager rejects oversize values before a module
+// sees them.
+//
+// The read side mirrors const std::string (c_str, size, empty, iteration, comparison with strings and
+// literals) and converts to std::string_view.
+
+template <typename Derived>
+class StringReadOps {
+public:
+    const char* c_str() const { return self().data(); }
+    size_t length() const { return self().size(); }
+    bool empty() const { return self().size() == 0; }
+    const char* begin() const { return self().data(); }
+    const char* end() const { return self().data() + self().size(); }
+    char operator[](size_t i) const { return self().data()[i]; }
+    std::string_view view() const { return std::string_view(self().data(), self().size()); }
+    operator std::string_view() const { return view(); }
+
+    bool operator==(std::string_view other) const { return view() == other; }
+    bool operator!=(std::string_view other) const { return view() != other; }
+    bool operator==(const char* other) const { return other && view() == std::string_view(other); }
+    bool operator!=(const char* other) const { return !(*this == other); }
+
+private:
+    const Derived& self() const { return static_cast<const Derived&>(*this); }
+};
+
+template <size_t N>
+class BoundedString : public StringReadOps<BoundedString<N>> {
+    static_assert(N > 0 && N < 256, "inline strings are for short values; use PooledString");
+
+public:
+    static constexpr size_t kCapacity = N;
+
+    BoundedString() = default;
+    // Defaults in member initializers; must fit
+    BoundedString(const char* s) { assign(s); }
+
+    bool assign(const char* s, size_t n) {
+        if (n > N) return false;
+        if (n) memmove(buf_, s, n);
+        buf_[n] = '\0';
+        size_ = static_cast<uint8_t>(n);
+        return true;
+    }
+    bool assign(const char* s) { return s ? assign(s, strlen(s)) : (clear(), true); }
+    bool assign(std::string_view s) { return assign(s.data(), s.size()); }
+    void clear() {
+        buf_[0] = '\0';
+        size_ = 0;
+    }
+
+    const char* data() const { return buf_; }
+    size_t size() const { return size_; }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    char buf_[N + 1] = {};
+    uint8_t size_ = 0;
+};
+
+class PooledString : public StringReadOps<PooledString> {
+public:
+    // Reserves capacity + 1 bytes from the blob pool. Modules live for the whole uptime, so the storage
+    // is never returned. Without pool memory the capacity is 0 and only empty values fit.
+    explicit PooledString(size_t capacity);
+    PooledString(const PooledString&) = delete;
+    PooledString& operator=(const PooledString&) = delete;
+
+    bool assign(const char* s, size_t n) {
+        if (n > capacity_) return false;
+        if (n) memmove(buf_, s, n);
+        buf_[n] = '\0';
+        size_ = n;
+        return true;
+    }
+    bool assign(const char* s) { return s ? assign(s, strlen(s)) : (clear(), true); }
+    void clear() {
+        if (capacity_) buf_[0] = '\0';
+        size_ = 0;
+    }
+
+    const char* data() const { return capacity_ ? buf_ : ""; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    char* buf_ = nullptr;
+    size_t capacity_ = 0;
+    size_t size_ = 0;
+};
+
+} // namespace config
@@ -0,0 +1,72 @@
+#include "ConfigBlobPool.h"
+#include "BoundedString.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+namespace config {
+
+static const char* TAG = "ConfigBlobPool";
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t* s_chunk = nullptr;
+static size_t s_chunk_left = 0;
+static size_t s_reserved = 0;
+static size_t s_used = 0;
+static bool s_psram = true;
+
+void* ConfigBlobPool::allocate(size_t bytes) {
+    bytes = (bytes + 3) & ~static_cast<size_t>(3);
+    taskENTER_CRITICAL(&s_lock);
+    if (bytes <= s_chunk_left) {
+        void* p = s_chunk;
+        s_chunk += bytes;
+        s_chunk_left -= bytes;
+        s_used += bytes;
+        taskEXIT_CRITICAL(&s_lock);
+        return p;
+    }
+    taskEXIT_CRITICAL(&s_lock);
+
+    // Modules are built during boot from one task; allocating outside the spinlock is fine
+    const size_t chunk = bytes > kChunkBytes ? bytes : kChunkBytes;
+    void* mem = heap_caps_malloc(chunk, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    bool psram = true;
+    if (!mem) {
+        mem = heap_caps_malloc(chunk, MALLOC_CAP_8BIT);
+        psram = false;
+    }
+    if (!mem) {
+        ESP_LOGE(TAG, "Out of memory for %u bytes", (unsigned)bytes);
+        return nullptr;
+    }
+    if (!psram) ESP_LOGW(TAG, "No PSRAM; large config values use internal RAM");
+
+    taskENTER_CRITICAL(&s_lock);
+    // The rest of the previous chunk is abandoned; chunks are sized so this is a few bytes
+    s_chunk = static_cast<uint8_t*>(mem) + bytes;
+    s_chunk_left = chunk - bytes;
+    s_reserved += chunk;
+    s_used += bytes;
+    s_psram = s_psram && psram;
+    taskEXIT_CRITICAL(&s_lock);
+    return mem;
+}
+
+ConfigBlobPool::Stats ConfigBlobPool::stats() {
+    taskENTER_CRITICAL(&s_lock);
+    Stats st{s_reserved, s_used, s_psram && s_reserved > 0};
+    taskEXIT_CRITICAL(&s_lock);
+    return st;
+}
+
+PooledString::PooledString(size_t capacity) {
+    buf_ = static_cast<char*>(ConfigBlobPool::allocate(capacity + 1));
+    if (buf_) {
+        capacity_ = capacity;
+        buf_[0] = '\0';
+    }
+}
+
+} // namespace config
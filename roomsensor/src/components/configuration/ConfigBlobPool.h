@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stddef.h>
+
+namespace config {
+
+// Dedicated PSRAM pool for large configuration values (PooledString). Bump allocation from chunks
+// taken from PSRAM as needed; nothing is ever freed, because the only users are configuration modules
+// that live for the whole uptime. Keeps kilobyte-sized seeds and messages out of internal RAM and out of
+// the general PSRAM heap. Falls back to internal RAM when the board has no PSRAM.
+class ConfigBlobPool {
+public:
+    static constexpr size_t kChunkBytes = 4096;
+
+    // nullptr when out of memory
+    static void* allocate(size_t bytes);
+
+    struct Stats {
+        size_t reserved; // taken from the heap
+        size_t used;     // handed out
+        bool psram;
+    };
+    static Stats stats();
+};
+
+} // namespace config
@@ -0,0 +1,183 @@
+#include "ConfigSnapshot.h"
+#include "esp_rom_crc.h"
+#include "nvs.h"
+#include <string.h>
+
+namespace config {
+
+static void put_u16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+static void put_u32_at(std::vector<uint8_t>& out, size_t pos, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out[pos + i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+static uint16_t get_u16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+static uint32_t get_u32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Encoded size of a value of 'type', or 0 for variable-length types
+static size_t fixed_size(ConfigValueType type) {
+    switch (type) {
+        case ConfigValueType::Bool: return 1;
+        case ConfigValueType::I32:
+        case ConfigValueType::U32:
+        case ConfigValueType::F32: return 4;
+        case ConfigValueType::I64: return 8;
+        case ConfigValueType::String:
+        case ConfigValueType::Blob: return 0;
+    }
+    return 0;
+}
+
+static bool valid_type(uint8_t t) { return t <= static_cast<uint8_t>(ConfigValueType::F32); }
+
+void ConfigSnapshot::set(const char* module, const char* key, const ConfigValue& value) {
+    // Entries stay grouped by module: a new key goes right after the module's last entry
+    size_t insert_at = entries_.size();
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (strcmp(entries_[i].module, module) != 0) continue;
+        insert_at = i + 1;
+        if (strcmp(entries_[i].key, key) != 0) continue;
+        if (!value.is_set) {
+            entries_.erase(entries_.begin() + i);
+            return;
+        }
+        encode_value(value, entries_[i]);
+        return;
+    }
+    if (!value.is_set) return;
+    Entry e{module, key, value.type, {}};
+    encode_value(value, e);
+    entries_.insert(entries_.begin() + insert_at, std::move(e));
+}
+
+void ConfigSnapshot::encode_value(const ConfigValue& value, Entry& e) {
+    e.type = value.type;
+    e.bytes.clear();
+    switch (value.type) {
+        case ConfigValueType::String: {
+            const char* s = value.c_str();
+            e.bytes.assign(s, s + value.size + 1);
+            break;
+        }
+        case ConfigValueType::Blob: {
+            const uint8_t* d = static_cast<const uint8_t*>(value.data);
+            e.bytes.assign(d, d + value.size);
+            break;
+        }
+        case ConfigValueType::Bool: e.bytes.push_back(value.b ? 1 : 0); break;
+        case ConfigValueType::I32:
+        case ConfigValueType::U32:
+        case ConfigValueType::F32:
+            e.bytes.resize(4);
+            memcpy(e.bytes.data(), &value.u32, 4);
+            break;
+        case ConfigValueType::I64:
+            e.bytes.resize(8);
+            memcpy(e.bytes.data(), &value.i64, 8);
+            break;
+    }
+}
+
+void ConfigSnapshot::serialize(std::vector<uint8_t>& out) const {
+    out.assign(kHeaderBytes, 0);
+    uint16_t modules = 0;
+    size_t i = 0;
+    while (i < entries_.size()) {
+        const char* module = entries_[i].module;
+        size_t j = i;
+        while (j < entries_.size() && strcmp(entries_[j].module, module) == 0) ++j;
+        size_t mlen = strlen(module);
+        out.push_back(static_cast<uint8_t>(mlen));
+        out.insert(out.end(), module, module + mlen);
+        put_u16(out, static_cast<uint16_t>(j - i));
+        for (; i < j; ++i) {
+            const Entry& e = entries_[i];
+            size_t klen = strlen(e.key);
+            out.push_back(static_cast<uint8_t>(klen));
+            out.insert(out.end(), e.key, e.key + klen);
+            out.push_back(static_cast<uint8_t>(e.type));
+            put_u16(out, static_cast<uint16_t>(e.bytes.size()));
+            out.insert(out.end(), e.bytes.begin(), e.bytes.end());
+        }
+        ++modules;
+    }
+    size_t payload = out.size() - kHeaderBytes;
+    put_u32_at(out, 0, kMagic);
+    out[4] = static_cast<uint8_t>(kVersion);
+    out[5] = static_cast<uint8_t>(kVersion >> 8);
+    out[6] = static_cast<uint8_t>(modules);
+    out[7] = static_cast<uint8_t>(modules >> 8);
+    put_u32_at(out, 8, static_cast<uint32_t>(payload));
+    put_u32_at(out, 12, esp_rom_crc32_le(0, out.data() + kHeaderBytes, static_cast<uint32_t>(payload)));
+}
+
+esp_err_t ConfigSnapshot::verify(const uint8_t* data, size_t len, uint16_t* modules) {
+    if (data == nullptr || len < kHeaderBytes || get_u32(data) != kMagic) return ESP_ERR_INVALID_SIZE;
+    if (get_u16(data + 4) != kVersion) return ESP_ERR_INVALID_VERSION;
+    size_t payload = get_u32(data + 8);
+    if (payload != len - kHeaderBytes) return ESP_ERR_INVALID_SIZE;
+    if (esp_rom_crc32_le(0, data + kHeaderBytes, static_cast<uint32_t>(payload)) != get_u32(data + 12)) {
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    // Walk the structure so parse() can decode without bounds checks
+    const uint8_t* p = data + kHeaderBytes;
+    const uint8_t* end = data + len;
+    uint16_t count_modules = get_u16(data + 6);
+    for (uint16_t m = 0; m < count_modules; ++m) {
+        if (end - p < 1 || end - p < 1 + p[0] + 2 || p[0] == 0) return ESP_ERR_INVALID_SIZE;
+        p += 1 + p[0];
+        uint16_t count = get_u16(p);
+        p += 2;
+        for (uint16_t i = 0; i < count; ++i) {
+            if (end - p < 1 || end - p < 1 + p[0] + 3 || p[0] == 0) return ESP_ERR_INVALID_SIZE;
+            p += 1 + p[0];
+            uint8_t type = *p++;
+            size_t vlen = get_u16(p);
+            p += 2;
+            if (!valid_type(type) || static_cast<size_t>(end - p) < vlen) return ESP_ERR_INVALID_SIZE;
+            size_t fixed = fixed_size(static_cast<ConfigValueType>(type));
+            if (fixed && vlen != fixed) return ESP_ERR_INVALID_SIZE;
+            if (static_cast<ConfigValueType>(type) == ConfigValueType::String && (vlen == 0 || p[vlen - 1] != 0)) {
+                return ESP_ERR_INVALID_SIZE;
+            }
+            p += vlen;
+        }
+    }
+    if (p != end) return ESP_ERR_INVALID_SIZE;
+    *modules = count_modules;
+    return ESP_OK;
+}
+
+ConfigValue ConfigSnapshot::decode_value(ConfigValueType type, const uint8_t* p, size_t n, bool* ok) {
+    *ok = true;
+    switch (type) {
+        case ConfigValueType::String: return ConfigValue::of_string(reinterpret_cast<const char*>(p));
+        case ConfigValueType::Blob: return ConfigValue::of_blob(p, n);
+        case ConfigValueType::Bool: return ConfigValue::of_bool(p[0] != 0);
+        case ConfigValueType::I32: { int32_t v; memcpy(&v, p, 4); return ConfigValue::of_i32(v); }
+        case ConfigValueType::U32: { uint32_t v; memcpy(&v, p, 4); return ConfigValue::of_u32(v); }
+        case ConfigValueType::F32: { float v; memcpy(&v, p, 4); return ConfigValue::of_f32(v); }
+        case ConfigValueType::I64: { int64_t v; memcpy(&v, p, 8); return ConfigValue::of_i64(v); }
+    }
+    *ok = false;
+    return ConfigValue();
+}
+
+} // namespace config
+
+extern "C" esp_err_t config_snapshot_invalidate(void) {
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(CONFIG_SNAPSHOT_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) return err;
+    err = nvs_erase_key(handle, CONFIG_SNAPSHOT_KEY);
+    if (err == ESP_OK) err = nvs_commit(handle);
+    nvs_close(handle);
+    return (err == ESP_ERR_NVS_NOT_FOUND) ? ESP_OK : err;
+}
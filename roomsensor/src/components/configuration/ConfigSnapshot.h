@@ -0,0 +1,111 @@
+#pragma once
+
+#include "esp_err.h"
+
+// Versioned single-blob snapshot of all persisted configuration.
+//
+// The per-module NVS namespaces stay the source of truth (console nvs_* commands, provisioning
+// images); the snapshot mirrors every configuration key found there so boot needs one blob read
+// instead of one or two lookups per descriptor. When the snapshot is missing, fails its CRC or has a
+// different version, boot falls back to the per-key load and writes a fresh snapshot.
+//
+// Updates only write per-key values. The first one after boot erases the snapshot beforehand, and the
+// next boot rebuilds it from the per-key namespaces, so an update never rewrites the whole blob and an
+// interrupted one leaves no snapshot rather than a stale one.
+#define CONFIG_SNAPSHOT_NAMESPACE "cfgsnap"
+#define CONFIG_SNAPSHOT_KEY "snapshot"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Drop the snapshot so the next boot reloads from the per-key namespaces. For code that edits those
+// namespaces directly (serial console).
+esp_err_t config_snapshot_invalidate(void);
+
+#ifdef __cplusplus
+}
+
+#include "configuration_types.h"
+#include <vector>
+
+namespace config {
+
+// Blob layout (little-endian):
+//   u32 kMagic, u16 kVersion, u16 module count, u32 payload bytes, u32 CRC-32 of payload
+//   payload, per module: u8 name len, name, u16 entry count,
+//            per entry:  u8 key len, key, u8 ConfigValueType, u16 value len, value
+// Values: String with its NUL, Bool 1 byte, I32/U32/F32 4 bytes, I64 8 bytes, Blob raw.
+class ConfigSnapshot {
+public:
+    static constexpr uint32_t kMagic = 0x53474643; // "CFGS"
+    static constexpr uint16_t kVersion = 1;
+    static constexpr size_t kHeaderBytes = 16;
+
+    // Record the NVS state of one key; an unset value removes it. 'module' and 'key' must outlive the
+    // snapshot (module names and descriptor names do).
+    void set(const char* module, const char* key, const ConfigValue& value);
+    void clear() { entries_.clear(); }
+    size_t entry_count() const { return entries_.size(); }
+
+    void serialize(std::vector<uint8_t>& out) const;
+
+    // Verify a serialized snapshot and call fn(module, key, value) for every entry. Nothing is reported
+    // unless the whole blob checks out. Returns ESP_ERR_INVALID_VERSION, ESP_ERR_INVALID_CRC or
+    // ESP_ERR_INVALID_SIZE on mismatch; 'entries' receives the entry count on success.
+    template <typename Fn>
+    static esp_err_t parse(const uint8_t* data, size_t len, Fn&& fn, size_t* entries = nullptr);
+
+private:
+    struct Entry {
+        const char* module;
+        const char* key;
+        ConfigValueType type;
+        std::vector<uint8_t> bytes;
+    };
+
+    static void encode_value(const ConfigValue& value, Entry& e);
+    static esp_err_t verify(const uint8_t* data, size_t len, uint16_t* modules);
+    static ConfigValue decode_value(ConfigValueType type, const uint8_t* p, size_t n, bool* ok);
+
+    std::vector<Entry> entries_; // grouped by module in insertion order
+};
+
+template <typename Fn>
+esp_err_t ConfigSnapshot::parse(const uint8_t* data, size_t len, Fn&& fn, size_t* entries) {
+    uint16_t modules = 0;
+    esp_err_t err = verify(data, len, &modules);
+    if (err != ESP_OK) return err;
+    // verify() walked the structure already; decoding below cannot run past the end
+    size_t total = 0;
+    const uint8_t* p = data + kHeaderBytes;
+    for (uint16_t m = 0; m < modules; ++m) {
+        char module[256];
+        size_t mlen = *p++;
+        memcpy(module, p, mlen);
+        module[mlen] = '\0';
+        p += mlen;
+        uint16_t count = static_cast<uint16_t>(p[0] | (p[1] << 8));
+        p += 2;
+        for (uint16_t i = 0; i < count; ++i) {
+            char key[256];
+            size_t klen = *p++;
+            memcpy(key, p, klen);
+            key[klen] = '\0';
+            p += klen;
+            ConfigValueType type = static_cast<ConfigValueType>(*p++);
+            size_t vlen = static_cast<size_t>(p[0] | (p[1] << 8));
+            p += 2;
+            bool ok = false;
+            ConfigValue value = decode_value(type, p, vlen, &ok);
+            p += vlen;
+            if (ok) fn(static_cast<const char*>(module), static_cast<const char*>(key), value);
+            ++total;
+        }
+    }
+    if (entries) *entries = total;
+    return ESP_OK;
+}
+
+} // namespace config
+#endif
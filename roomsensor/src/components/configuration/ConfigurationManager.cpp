@@ -6,13 +6,18 @@
 #include "GameOfLifeConfig.h"
 #include "A2DConfig.h"
 #include "IOConfig.h"
+#include "PWMConfig.h"
+#include "AlarmConfig.h"
 #include "MotionConfig.h"
 #include "cJSON.h"
 #include "I2CConfig.h"
+#include "ConfigBlobPool.h"
 #include "nvs.h"
 #include "nvs_flash.h"
 #include "esp_log.h"
 #include "esp_mac.h"
+#include "esp_timer.h"
+#include "flash_window.h"
 #include <string.h>
 #include <strings.h>
 #include <algorithm>
@@ -43,6 +48,15 @@ void ConfigurationManager::register_modules() {
     modules_.push_back(led3_module_.get());
     led4_module_.reset(new LEDConfig("led4"));
     modules_.push_back(led4_module_.get());
+    // led5..led8 only fit the four RMT TX channels when LEDManager time-shares channels between strips
+    led5_module_.reset(new LEDConfig("led5"));
+    modules_.push_back(led5_module_.get());
+    led6_module_.reset(new LEDConfig("led6"));
+    modules_.push_back(led6_module_.get());
+    led7_module_.reset(new LEDConfig("led7"));
+    modules_.push_back(led7_module_.get());
+    led8_module_.reset(new LEDConfig("led8"));
+    modules_.push_back(led8_module_.get());
 
     // A2D modules for ADS1115 addresses
     a2d1_module_.reset(new A2DConfig("a2d1"));
@@ -68,6 +82,16 @@ void ConfigurationManager::register_modules() {
     io7_module_.reset(new IOConfig("io7")); modules_.push_back(io7_module_.get());
     io8_module_.reset(new IOConfig("io8")); modules_.push_back(io8_module_.get());
 
+    // PWM outputs => LEDC channels 0..3
+    pwm1_module_.reset(new PWMConfig("pwm1")); modules_.push_back(pwm1_module_.get());
+    pwm2_module_.reset(new PWMConfig("pwm2")); modules_.push_back(pwm2_module_.get());
+    pwm3_module_.reset(new PWMConfig("pwm3")); modules_.push_back(pwm3_module_.get());
+    pwm4_module_.reset(new PWMConfig("pwm4")); modules_.push_back(pwm4_module_.get());
+
+    // Alarm thresholds
+    alarm_module_.reset(new AlarmConfig());
+    modules_.push_back(alarm_module_.get());
+
     // I2C address mapping module
     i2cmap_module_.reset(new I2CConfig());
     modules_.push_back(i2cmap_module_.get());
@@ -97,6 +121,10 @@ LEDConfig& ConfigurationManager::led1() { return *led1_module_; }
 LEDConfig& ConfigurationManager::led2() { return *led2_module_; }
 LEDConfig& ConfigurationManager::led3() { return *led3_module_; }
 LEDConfig& ConfigurationManager::led4() { return *led4_module_; }
+LEDConfig& ConfigurationManager::led5() { return *led5_module_; }
+LEDConfig& ConfigurationManager::led6() { return *led6_module_; }
+LEDConfig& ConfigurationManager::led7() { return *led7_module_; }
+LEDConfig& ConfigurationManager::led8() { return *led8_module_; }
 GameOfLifeConfig& ConfigurationManager::life() { return *life_module_; }
 
 A2DConfig& ConfigurationManager::a2d1() { return *a2d1_module_; }
@@ -113,6 +141,13 @@ IOConfig& ConfigurationManager::io6() { return *io6_module_; }
 IOConfig& ConfigurationManager::io7() { return *io7_module_; }
 IOConfig& ConfigurationManager::io8() { return *io8_module_; }
 
+PWMConfig& ConfigurationManager::pwm1() { return *pwm1_module_; }
+PWMConfig& ConfigurationManager::pwm2() { return *pwm2_module_; }
+PWMConfig& ConfigurationManager::pwm3() { return *pwm3_module_; }
+PWMConfig& ConfigurationManager::pwm4() { return *pwm4_module_; }
+
+AlarmConfig& ConfigurationManager::alarm() { return *alarm_module_; }
+
 MotionConfig& ConfigurationManager::motion() { return *motion_module_; }
 
 I2CConfig& ConfigurationManager::i2cmap() { return *i2cmap_module_; }
@@ -123,10 +158,111 @@ std::vector<LEDConfig*> ConfigurationManager::active_leds() const {
     if (led2_module_ && led2_module_->has_data_gpio()) result.push_back(led2_module_.get());
     if (led3_module_ && led3_module_->has_data_gpio()) result.push_back(led3_module_.get());
     if (led4_module_ && led4_module_->has_data_gpio()) result.push_back(led4_module_.get());
+    if (led5_module_ && led5_module_->has_data_gpio()) result.push_back(led5_module_.get());
+    if (led6_module_ && led6_module_->has_data_gpio()) result.push_back(led6_module_.get());
+    if (led7_module_ && led7_module_->has_data_gpio()) result.push_back(led7_module_.get());
+    if (led8_module_ && led8_module_->has_data_gpio()) result.push_back(led8_module_.get());
     return result;
 }
 
-static esp_err_t nvs_load_module(const char* ns_name, ConfigurationModule* module) {
+// NVS holds every value in its descriptor type, so loading hands the module a typed value directly.
+// F32 is stored as its IEEE-754 bit pattern (NVS has no float type). String and Blob payloads land in
+// 'scratch', which the returned value borrows.
+static esp_err_t nvs_read_value(nvs_handle_t handle, const ConfigurationValueDescriptor& desc, std::string& scratch,
+                                ConfigValue& out) {
+    esp_err_t err = ESP_OK;
+    switch (desc.type) {
+        case ConfigValueType::String: {
+            size_t len = 0;
+            err = nvs_get_str(handle, desc.name, nullptr, &len);
+            if (err != ESP_OK) return err;
+            if (len == 0) return ESP_ERR_NVS_NOT_FOUND;
+            scratch.resize(len);
+            err = nvs_get_str(handle, desc.name, scratch.data(), &len);
+            if (err == ESP_OK) out = ConfigValue::of_string(scratch.c_str());
+            return err;
+        }
+        case ConfigValueType::Blob: {
+            size_t len = 0;
+            err = nvs_get_blob(handle, desc.name, nullptr, &len);
+            if (err != ESP_OK) return err;
+            scratch.resize(len);
+            err = nvs_get_blob(handle, desc.name, scratch.data(), &len);
+            if (err == ESP_OK) out = ConfigValue::of_blob(scratch.data(), len);
+            return err;
+        }
+        case ConfigValueType::Bool: {
+            uint8_t v = 0;
+            err = nvs_get_u8(handle, desc.name, &v);
+            if (err == ESP_OK) out = ConfigValue::of_bool(v != 0);
+            return err;
+        }
+        case ConfigValueType::I32: {
+            int32_t v = 0;
+            err = nvs_get_i32(handle, desc.name, &v);
+            if (err == ESP_OK) out = ConfigValue::of_i32(v);
+            return err;
+        }
+        case ConfigValueType::U32: {
+            uint32_t v = 0;
+            err = nvs_get_u32(handle, desc.name, &v);
+            if (err == ESP_OK) out = ConfigValue::of_u32(v);
+            return err;
+        }
+        case ConfigValueType::I64: {
+            int64_t v = 0;
+            err = nvs_get_i64(handle, desc.name, &v);
+            if (err == ESP_OK) out = ConfigValue::of_i64(v);
+            return err;
+        }
+        case ConfigValueType::F32: {
+            uint32_t bits = 0;
+            err = nvs_get_u32(handle, desc.name, &bits);
+            if (err == ESP_OK) {
+                float f;
+                memcpy(&f, &bits, sizeof(f));
+                out = ConfigValue::of_f32(f);
+            }
+            return err;
+        }
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+// Store 'value' under 'key' as 'type'; an unset value erases the key
+static esp_err_t nvs_write_value(nvs_handle_t handle, const char* key, ConfigValueType type, const ConfigValue& value) {
+    if (!value.is_set) {
+        esp_err_t err = nvs_erase_key(handle, key);
+        return (err == ESP_ERR_NVS_NOT_FOUND) ? ESP_OK : err;
+    }
+    switch (type) {
+        case ConfigValueType::String:
+            if (value.type != ConfigValueType::String) return ESP_ERR_INVALID_ARG;
+            return nvs_set_str(handle, key, value.c_str());
+        case ConfigValueType::Blob:
+            if (value.type != ConfigValueType::Blob && value.type != ConfigValueType::String) return ESP_ERR_INVALID_ARG;
+            return nvs_set_blob(handle, key, value.data, value.size);
+        case ConfigValueType::Bool:
+            return nvs_set_u8(handle, key, value.as_bool(false) ? 1 : 0);
+        case ConfigValueType::I32:
+            return nvs_set_i32(handle, key, value.as_i32(0));
+        case ConfigValueType::U32:
+            return nvs_set_u32(handle, key, static_cast<uint32_t>(value.as_i64(0)));
+        case ConfigValueType::I64:
+            return nvs_set_i64(handle, key, value.as_i64(0));
+        case ConfigValueType::F32: {
+            float f = value.as_f32(0.0f);
+            uint32_t bits;
+            memcpy(&bits, &f, sizeof(bits));
+            return nvs_set_u32(handle, key, bits);
+        }
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+// Per-key boot load (first boot, migration, or a missing/corrupt snapshot). Everything found is also
+// recorded in 'capture' so a fresh snapshot can be written afterwards.
+static esp_err_t nvs_load_module(const char* ns_name, ConfigurationModule* module, ConfigSnapshot& capture) {
     nvs_handle_t handle;
     esp_err_t err = nvs_open(ns_name, NVS_READONLY, &handle);
     if (err == ESP_ERR_NVS_NOT_FOUND) {
@@ -137,74 +273,119 @@ static esp_err_t nvs_load_module(const char* ns_name, ConfigurationModule* modul
         return err;
     }
 
+    std::string scratch;
+    scratch.reserve(64);
     for (const auto& desc : module->descriptors()) {
-        switch (desc.type) {
-            case ConfigValueType::String: {
-                size_t len = 0;
-                err = nvs_get_str(handle, desc.name, nullptr, &len);
-                if (err == ESP_OK && len > 0) {
-                    std::string buf(len, '\0');
-                    err = nvs_get_str(handle, desc.name, buf.data(), &len);
-                    if (err == ESP_OK) {
-                        module->apply_update(desc.name, buf.c_str());
-                        ESP_LOGD(TAG, "Loaded persisted config (str): %s.%s", ns_name, desc.name);
-                    }
-                }
-                break;
-            }
-            case ConfigValueType::Bool: {
-                uint8_t v = 0; err = nvs_get_u8(handle, desc.name, &v);
-                if (err == ESP_OK) {
-                    const char* s = v ? "1" : "0";
-                    module->apply_update(desc.name, s);
-                    ESP_LOGD(TAG, "Loaded persisted config (bool): %s.%s=%u", ns_name, desc.name, (unsigned)v);
-                }
-                break;
-            }
-            case ConfigValueType::I32: {
-                int32_t v = 0; err = nvs_get_i32(handle, desc.name, &v);
-                if (err == ESP_OK) {
-                    std::string s = std::to_string(v);
-                    module->apply_update(desc.name, s.c_str());
-                    ESP_LOGD(TAG, "Loaded persisted config (i32): %s.%s=%ld", ns_name, desc.name, (long)v);
-                }
-                break;
-            }
-            case ConfigValueType::U32: {
-                uint32_t v = 0; err = nvs_get_u32(handle, desc.name, &v);
-                if (err == ESP_OK) {
-                    std::string s = std::to_string(v);
-                    module->apply_update(desc.name, s.c_str());
-                    ESP_LOGD(TAG, "Loaded persisted config (u32): %s.%s=%lu", ns_name, desc.name, (unsigned long)v);
-                }
-                break;
-            }
-            case ConfigValueType::I64: {
-                int64_t v = 0; err = nvs_get_i64(handle, desc.name, &v);
-                if (err == ESP_OK) {
-                    std::string s = std::to_string((long long)v);
-                    module->apply_update(desc.name, s.c_str());
-                    ESP_LOGD(TAG, "Loaded persisted config (i64): %s.%s", ns_name, desc.name);
-                }
-                break;
-            }
-            case ConfigValueType::F32:
-            case ConfigValueType::Blob:
-                // Not supported for generic load in this project
-                break;
+        ConfigValue value;
+        if (nvs_read_value(handle, desc, scratch, value) != ESP_OK) continue;
+        err = ConfigurationModule::check_size(&desc, value);
+        if (err == ESP_OK) {
+            capture.set(ns_name, desc.name, value); // oversize values stay out of the snapshot
+            err = module->apply_value(desc.name, value);
+        }
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Ignoring persisted config %s.%s: %s", ns_name, desc.name, esp_err_to_name(err));
+            continue;
         }
+        ESP_LOGD(TAG, "Loaded persisted config: %s.%s", ns_name, desc.name);
     }
 
     nvs_close(handle);
     return ESP_OK;
 }
 
+esp_err_t ConfigurationManager::load_snapshot(size_t* entries, size_t* bytes) {
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(CONFIG_SNAPSHOT_NAMESPACE, NVS_READONLY, &handle);
+    if (err != ESP_OK) return err;
+    size_t len = 0;
+    err = nvs_get_blob(handle, CONFIG_SNAPSHOT_KEY, nullptr, &len);
+    std::vector<uint8_t> blob;
+    if (err == ESP_OK) {
+        blob.resize(len);
+        err = nvs_get_blob(handle, CONFIG_SNAPSHOT_KEY, blob.data(), &len);
+    }
+    nvs_close(handle);
+    if (err != ESP_OK) return err;
+
+    size_t dropped = 0;
+    err = ConfigSnapshot::parse(blob.data(), len, [&](const char* module, const char* key, const ConfigValue& value) {
+        ConfigurationModule* mod = find_module(module);
+        const ConfigurationValueDescriptor* desc = mod ? mod->find_descriptor(key) : nullptr;
+        // Keys this firmware no longer declares (or declares with another type) are left to the per-key
+        // namespaces, exactly as the per-key loader would ignore them
+        if (!desc || desc->type != value.type) {
+            ++dropped;
+            return;
+        }
+        esp_err_t aerr = ConfigurationModule::check_size(desc, value);
+        if (aerr == ESP_OK) aerr = mod->apply_value(desc->name, value);
+        if (aerr != ESP_OK) {
+            ESP_LOGW(TAG, "Ignoring persisted config %s.%s: %s", module, key, esp_err_to_name(aerr));
+        }
+    }, entries);
+    if (err == ESP_OK && dropped) ESP_LOGW(TAG, "Config snapshot: skipped %u unknown keys", (unsigned)dropped);
+    if (bytes) *bytes = len;
+    return err;
+}
+
+esp_err_t ConfigurationManager::save_snapshot(const ConfigSnapshot& snapshot) {
+    std::vector<uint8_t> blob;
+    snapshot.serialize(blob);
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(CONFIG_SNAPSHOT_NAMESPACE, NVS_READWRITE, &handle);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(handle, CONFIG_SNAPSHOT_KEY, blob.data(), blob.size());
+        if (err == ESP_OK) err = nvs_commit(handle);
+        nvs_close(handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to write config snapshot: %s", esp_err_to_name(err));
+    } else {
+        ESP_LOGD(TAG, "Config snapshot written: %u values, %u bytes", (unsigned)snapshot.entry_count(), (unsigned)blob.size());
+    }
+    return err;
+}
+
+esp_err_t ConfigurationManager::invalidate_snapshot() {
+    if (!snapshot_stored_) return ESP_OK;
+    esp_err_t err = config_snapshot_invalidate();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to erase config snapshot: %s", esp_err_to_name(err));
+        return err;
+    }
+    snapshot_stored_ = false;
+    ESP_LOGD(TAG, "Config snapshot erased; rebuilt at next boot");
+    return ESP_OK;
+}
+
 esp_err_t ConfigurationManager::initialize() {
     register_modules();
-
-    // Load persisted values from NVS
-    for (ConfigurationModule* mod : modules_) {
-        nvs_load_module(mod->name(), mod);
+    const ConfigBlobPool::Stats pool = ConfigBlobPool::stats();
+    ESP_LOGI(TAG, "Config blob pool: %u of %u bytes in %s", (unsigned)pool.used, (unsigned)pool.reserved,
+             pool.psram ? "PSRAM" : "internal RAM");
+
+    // Load persisted values: one snapshot blob when valid, otherwise every per-key namespace
+    int64_t t0 = esp_timer_get_time();
+    size_t entries = 0, bytes = 0;
+    esp_err_t snap = load_snapshot(&entries, &bytes);
+    if (snap == ESP_OK) {
+        snapshot_stored_ = true;
+        ESP_LOGI(TAG, "Loaded %u config values from snapshot (%u bytes) in %lld us", (unsigned)entries,
+                 (unsigned)bytes, (long long)(esp_timer_get_time() - t0));
+    } else {
+        if (snap != ESP_ERR_NVS_NOT_FOUND) {
+            ESP_LOGW(TAG, "Config snapshot unusable (%s); loading per-key values", esp_err_to_name(snap));
+        }
+        // Missing (first boot, migration) or invalidated by an update last session: rebuild it once here
+        ConfigSnapshot capture;
+        for (ConfigurationModule* mod : modules_) {
+            nvs_load_module(mod->name(), mod, capture);
+        }
+        ESP_LOGI(TAG, "Loaded %u config values from per-key NVS in %lld us", (unsigned)capture.entry_count(),
+                 (long long)(esp_timer_get_time() - t0));
+        flash_window::Scope flash; // the LED task may already be running from its boot record
+        snapshot_stored_ = save_snapshot(capture) == ESP_OK;
     }
 
     // No global log level changes here; UART logging remains controlled by sdkconfig/menuconfig.
@@ -261,8 +442,36 @@ esp_err_t ConfigurationManager::publish_full_configuration() {
 esp_err_t ConfigurationManager::handle_update(const char* module_name, const char* key, const char* value_str, bool persist_if_supported) {
     ConfigurationModule* mod = find_module(module_name);
     if (!mod) return ESP_ERR_NOT_FOUND;
+    if (!key) return ESP_ERR_INVALID_ARG;
 
-    esp_err_t err = mod->apply_update(key, value_str);
+    // Text edge: parse once according to the descriptor; everything past this point is typed
+    const ConfigurationValueDescriptor* desc = mod->find_descriptor(key);
+    ConfigValue value;
+    esp_err_t err = ConfigValue::parse(desc ? desc->type : ConfigValueType::String, value_str, value);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Config update rejected: %s.%s='%s' is not a valid value", module_name, key, value_str);
+        return err;
+    }
+    return apply_and_persist(mod, desc, key, value, persist_if_supported);
+}
+
+esp_err_t ConfigurationManager::handle_update(const char* module_name, const char* key, const ConfigValue& value, bool persist_if_supported) {
+    ConfigurationModule* mod = find_module(module_name);
+    if (!mod) return ESP_ERR_NOT_FOUND;
+    if (!key) return ESP_ERR_INVALID_ARG;
+    return apply_and_persist(mod, mod->find_descriptor(key), key, value, persist_if_supported);
+}
+
+esp_err_t ConfigurationManager::apply_and_persist(ConfigurationModule* mod, const ConfigurationValueDescriptor* desc,
+                                                  const char* key, const ConfigValue& value, bool persist_if_supported) {
+    const char* module_name = mod->name();
+    esp_err_t err = ConfigurationModule::check_size(desc, value);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Config update rejected: %s.%s is %u bytes, at most %u", module_name, key,
+                 (unsigned)value.size, (unsigned)desc->max_len);
+        return err;
+    }
+    err = mod->apply_value(key, value);
     if (err != ESP_OK) {
         ESP_LOGW(TAG, "Config update failed: %s.%s -> %s", module_name, key, esp_err_to_name(err));
         return err;
@@ -271,106 +480,57 @@ esp_err_t ConfigurationManager::handle_update(const char* module_name, const cha
     mod->mark_updated();
 
     {
-        const char* log_value = (value_str && value_str[0] != '\0') ? value_str : "(unset)";
+        char buf[64];
+        const char* log_value = value.format(buf, sizeof(buf));
+        if (value.type == ConfigValueType::String && value.size == 0) log_value = "(unset)";
         ESP_LOGI(TAG, "Config update applied: %s.%s=%s", module_name, key, log_value);
     }
 
     // Special handling: Only one strip may claim the DMA RMT channel at a time.
     // If dma=true is set on one LED module, clear it (unset) on all other LED modules.
-    if (key && strcmp(key, "dma") == 0 && value_str) {
-        bool requested_true = (strcasecmp(value_str, "1") == 0 || strcasecmp(value_str, "true") == 0 ||
-                               strcasecmp(value_str, "on") == 0 || strcasecmp(value_str, "yes") == 0);
-        if (requested_true) {
-            // Determine which LED module was updated by comparing names
-            LEDConfig* updated_led = nullptr;
-            if (led1_module_ && strcmp(module_name, led1_module_->name()) == 0) updated_led = led1_module_.get();
-            else if (led2_module_ && strcmp(module_name, led2_module_->name()) == 0) updated_led = led2_module_.get();
-            else if (led3_module_ && strcmp(module_name, led3_module_->name()) == 0) updated_led = led3_module_.get();
-            else if (led4_module_ && strcmp(module_name, led4_module_->name()) == 0) updated_led = led4_module_.get();
-
-            if (updated_led) {
-                const char* clear_value = nullptr; // nullptr => unset/auto-assign
-                if (led1_module_ && led1_module_.get() != updated_led) led1_module_->apply_update("dma", clear_value);
-                if (led2_module_ && led2_module_.get() != updated_led) led2_module_->apply_update("dma", clear_value);
-                if (led3_module_ && led3_module_.get() != updated_led) led3_module_->apply_update("dma", clear_value);
-                if (led4_module_ && led4_module_.get() != updated_led) led4_module_->apply_update("dma", clear_value);
+    if (strcmp(key, "dma") == 0 && value.as_bool(false)) {
+        LEDConfig* const leds[] = {led1_module_.get(), led2_module_.get(), led3_module_.get(), led4_module_.get(),
+                                   led5_module_.get(), led6_module_.get(), led7_module_.get(), led8_module_.get()};
+        // Determine which LED module was updated
+        LEDConfig* updated_led = nullptr;
+        for (LEDConfig* led : leds) {
+            if (led && mod == led) updated_led = led;
+        }
+
+        if (updated_led) {
+            const ConfigValue clear_value = ConfigValue::unset(ConfigValueType::Bool); // unset => auto-assign
+            for (LEDConfig* led : leds) {
+                if (led && led != updated_led) led->apply_value("dma", clear_value);
             }
         }
     }
 
-    if (persist_if_supported) {
-        // Check descriptor for persistence
-        for (const auto& desc : mod->descriptors()) {
-            if (strcmp(desc.name, key) == 0 && desc.persisted) {
-                nvs_handle_t handle;
-                err = nvs_open(module_name, NVS_READWRITE, &handle);
-                if (err == ESP_OK) {
-                    // Persist according to declared type
-                    switch (desc.type) {
-                        case ConfigValueType::String:
-                            err = nvs_set_str(handle, key, value_str ? value_str : "");
-                            break;
-                        case ConfigValueType::Bool: {
-                            if (value_str == nullptr || value_str[0] == '\0') {
-                                err = nvs_erase_key(handle, key);
-                            } else {
-                                bool v = (strcasecmp(value_str, "1") == 0 || strcasecmp(value_str, "true") == 0 ||
-                                          strcasecmp(value_str, "on") == 0 || strcasecmp(value_str, "yes") == 0);
-                                err = nvs_set_u8(handle, key, v ? 1 : 0);
-                            }
-                            break;
-                        }
-                        case ConfigValueType::I32: {
-                            if (value_str == nullptr || value_str[0] == '\0') {
-                                err = nvs_erase_key(handle, key);
-                            } else {
-                                int32_t v = atoi(value_str);
-                                err = nvs_set_i32(handle, key, v);
-                            }
-                            break;
-                        }
-                        case ConfigValueType::U32: {
-                            if (value_str == nullptr || value_str[0] == '\0') {
-                                err = nvs_erase_key(handle, key);
-                            } else {
-                                uint32_t v = (uint32_t)strtoul(value_str, nullptr, 10);
-                                err = nvs_set_u32(handle, key, v);
-                            }
-                            break;
-                        }
-                        case ConfigValueType::I64: {
-                            if (value_str == nullptr || value_str[0] == '\0') {
-                                err = nvs_erase_key(handle, key);
-                            } else {
-                                int64_t v = (int64_t)strtoll(value_str, nullptr, 10);
-                                err = nvs_set_i64(handle, key, v);
-                            }
-                            break;
-                        }
-                        case ConfigValueType::F32:
-                        case ConfigValueType::Blob:
-                            // Not supported for generic persist in this project
-                            err = ESP_OK; // do nothing
-                            break;
-                    }
-                    if (err == ESP_OK) {
-                        esp_err_t cmt = nvs_commit(handle);
-                        if (cmt == ESP_OK) {
-                            ESP_LOGD(TAG, "Persisted config: %s.%s", module_name, key);
-                        } else {
-                            ESP_LOGE(TAG, "Failed to commit persisted config %s.%s: %s", module_name, key, esp_err_to_name(cmt));
-                        }
-                    }
-                    else {
-                        ESP_LOGE(TAG, "Failed to set NVS value for %s.%s: %s", module_name, key, esp_err_to_name(err));
-                    }
-                    nvs_close(handle);
-                }
-                else {
-                    ESP_LOGE(TAG, "Failed to open NVS for %s: %s", module_name, esp_err_to_name(err));
+    if (persist_if_supported && desc && desc->persisted) {
+        // Persist the module's normalized value (clamped, canonical enum text) when it can report one
+        ConfigValue stored;
+        if (mod->get_value(key, stored) != ESP_OK) stored = value;
+        // Per-key write (and, on the first update since boot, the snapshot erase) in one LED frame gap
+        flash_window::Scope flash;
+        nvs_handle_t handle;
+        err = invalidate_snapshot();
+        if (err == ESP_OK) err = nvs_open(module_name, NVS_READWRITE, &handle);
+        if (err == ESP_OK) {
+            err = nvs_write_value(handle, key, desc->type, stored);
+            if (err == ESP_OK) {
+                esp_err_t cmt = nvs_commit(handle);
+                if (cmt == ESP_OK) {
+                    ESP_LOGD(TAG, "Persisted config: %s.%s", module_name, key);
+                } else {
+                    ESP_LOGE(TAG, "Failed to commit persisted config %s.%s: %s", module_name, key, esp_err_to_name(cmt));
                 }
-                break;
             }
+            else {
+                ESP_LOGE(TAG, "Failed to set NVS value for %s.%s: %s", module_name, key, esp_err_to_name(err));
+            }
+            nvs_close(handle);
+        }
+        else {
+            ESP_LOGE(TAG, "Failed to persist %s.%s: %s", module_name, key, esp_err_to_name(err));
         }
     }
 
@@ -386,6 +546,49 @@ std::string ConfigurationManager::get_mqtt_reset_subscription_topic() const {
     return "sensor/" + mac_to_string() + "/config/reset";
 }
 
+// JSON edge: convert a scalar cJSON item to the descriptor type directly instead of printing and
+// re-parsing it. Numbers and booleans for string-typed keys are rendered into 'scratch'.
+static esp_err_t value_from_json(const cJSON* item, ConfigValueType type, char* scratch, size_t scratch_len, ConfigValue& out) {
+    out = ConfigValue::unset(type);
+    if (cJSON_IsNull(item)) return ESP_OK;
+    if (cJSON_IsString(item)) return ConfigValue::parse(type, item->valuestring, out);
+    const bool is_bool = cJSON_IsBool(item);
+    if (!is_bool && !cJSON_IsNumber(item)) return ESP_ERR_INVALID_ARG; // nested objects/arrays
+    const double d = is_bool ? (cJSON_IsTrue(item) ? 1.0 : 0.0) : item->valuedouble;
+    switch (type) {
+        case ConfigValueType::String:
+            if (is_bool) {
+                out = ConfigValue::of_string(cJSON_IsTrue(item) ? "true" : "false");
+            } else {
+                if (double_fits(d, INT64_MIN, INT64_MAX) && d == (double)(long long)d) snprintf(scratch, scratch_len, "%lld", (long long)d);
+                else snprintf(scratch, scratch_len, "%g", d);
+                out = ConfigValue::of_string(scratch);
+            }
+            return ESP_OK;
+        case ConfigValueType::Bool:
+            out = ConfigValue::of_bool(d != 0.0);
+            return ESP_OK;
+        case ConfigValueType::I32:
+            if (!double_fits(d, INT32_MIN, INT32_MAX)) return ESP_ERR_INVALID_ARG;
+            out = ConfigValue::of_i32((int32_t)d);
+            return ESP_OK;
+        case ConfigValueType::U32:
+            if (!double_fits(d, 0, UINT32_MAX)) return ESP_ERR_INVALID_ARG;
+            out = ConfigValue::of_u32((uint32_t)d);
+            return ESP_OK;
+        case ConfigValueType::I64:
+            if (!double_fits(d, INT64_MIN, INT64_MAX)) return ESP_ERR_INVALID_ARG;
+            out = ConfigValue::of_i64((int64_t)d);
+            return ESP_OK;
+        case ConfigValueType::F32:
+            out = ConfigValue::of_f32((float)d);
+            return ESP_OK;
+        case ConfigValueType::Blob:
+            break;
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
 esp_err_t ConfigurationManager::handle_config_reset(const char* payload) {
     cJSON* root = cJSON_Parse(payload);
     if (!root) {
@@ -394,8 +597,18 @@ esp_err_t ConfigurationManager::handle_config_reset(const char* payload) {
     }
 
     ESP_LOGI(TAG, "Starting full configuration reset from MQTT");
+    {
+        flash_window::Scope flash;
+        if (invalidate_snapshot() != ESP_OK) {
+            // A surviving snapshot would override the reset on the next boot
+            cJSON_Delete(root);
+            return ESP_FAIL;
+        }
+    }
 
     for (ConfigurationModule* mod : modules_) {
+        // One LED frame gap per module: its erases, writes and commit
+        flash_window::Scope flash;
         nvs_handle_t handle;
         esp_err_t err = nvs_open(mod->name(), NVS_READWRITE, &handle);
         if (err != ESP_OK) {
@@ -415,59 +628,23 @@ esp_err_t ConfigurationManager::handle_config_reset(const char* payload) {
             cJSON* item = nullptr;
             cJSON_ArrayForEach(item, module_json) {
                 const char* key = item->string;
-                char* value_str = cJSON_Print(item); // Note: cJSON_Print returns a string representation of the value.
-                if (value_str) {
-                    // For string values, cJSON_Print adds quotes, which we need to remove.
-                    char* effective_value = value_str;
-                    if (item->type == cJSON_String) {
-                        size_t len = strlen(value_str);
-                        if (len >= 2 && value_str[0] == '"' && value_str[len - 1] == '"') {
-                            value_str[len - 1] = '\0';
-                            effective_value = value_str + 1;
-                        }
-                    }
-                    
-                    err = mod->apply_update(key, effective_value);
-                    if (err != ESP_OK) {
-                        ESP_LOGW(TAG, "Config reset failed to apply: %s.%s -> %s", mod->name(), key, esp_err_to_name(err));
-                    } else {
-                        // Persist this value, bypassing the 'persisted' flag.
-                        const auto& descriptors = mod->descriptors();
-                        auto it = std::find_if(descriptors.begin(), descriptors.end(), [&](const ConfigurationValueDescriptor& d) {
-                            return strcmp(d.name, key) == 0;
-                        });
-
-                        if (it != descriptors.end()) {
-                            const auto& desc = *it;
-                            switch (desc.type) {
-                                case ConfigValueType::String:
-                                    err = nvs_set_str(handle, key, effective_value);
-                                    break;
-                                case ConfigValueType::Bool: {
-                                    bool v = (strcasecmp(effective_value, "1") == 0 || strcasecmp(effective_value, "true") == 0 ||
-                                              strcasecmp(effective_value, "on") == 0 || strcasecmp(effective_value, "yes") == 0);
-                                    err = nvs_set_u8(handle, key, v ? 1 : 0);
-                                    break;
-                                }
-                                case ConfigValueType::I32:
-                                    err = nvs_set_i32(handle, key, atoi(effective_value));
-                                    break;
-                                case ConfigValueType::U32:
-                                    err = nvs_set_u32(handle, key, (uint32_t)strtoul(effective_value, nullptr, 10));
-                                    break;
-                                case ConfigValueType::I64:
-                                    err = nvs_set_i64(handle, key, (int64_t)strtoll(effective_value, nullptr, 10));
-                                    break;
-                                default:
-                                    // Types not supported for persistence.
-                                    break;
-                            }
-                            if (err != ESP_OK) {
-                                ESP_LOGE(TAG, "Failed to persist %s.%s during reset: %s", mod->name(), key, esp_err_to_name(err));
-                            }
-                        }
-                    }
-                    cJSON_free(value_str);
+                const ConfigurationValueDescriptor* desc = mod->find_descriptor(key);
+                char scratch[32];
+                ConfigValue value;
+                err = value_from_json(item, desc ? desc->type : ConfigValueType::String, scratch, sizeof(scratch), value);
+                if (err == ESP_OK) err = ConfigurationModule::check_size(desc, value);
+                if (err == ESP_OK) err = mod->apply_value(key, value);
+                if (err != ESP_OK) {
+                    ESP_LOGW(TAG, "Config reset failed to apply: %s.%s -> %s", mod->name(), key, esp_err_to_name(err));
+                    continue;
+                }
+                if (!desc) continue;
+                // Persist this value, bypassing the 'persisted' flag.
+                ConfigValue stored;
+                if (mod->get_value(key, stored) != ESP_OK) stored = value;
+                err = nvs_write_value(handle, key, desc->type, stored);
+                if (err != ESP_OK) {
+                    ESP_LOGE(TAG, "Failed to persist %s.%s during reset: %s", mod->name(), key, esp_err_to_name(err));
                 }
             }
         }
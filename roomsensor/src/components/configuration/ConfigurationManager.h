@@ -2,6 +2,7 @@
 
 #include "esp_err.h"
 #include "ConfigurationModule.h"
+#include "ConfigSnapshot.h"
 #include "communication.h"
 #include <memory>
 #include <vector>
@@ -19,6 +20,8 @@ class GameOfLifeConfig;
 class LEDConfig;
 class A2DConfig;
 class IOConfig;
+class PWMConfig;
+class AlarmConfig;
 class MotionConfig;
 class I2CConfig;
 
@@ -33,8 +36,11 @@ public:
     // Publish full configuration to sensor/$mac/config/current (retained)
     esp_err_t publish_full_configuration();
 
-    // Handle a single update (from console or MQTT)
+    // Handle a single update (from console or MQTT). value_str is parsed according to the key's
+    // descriptor type; nullptr clears the key.
     esp_err_t handle_update(const char* module_name, const char* key, const char* value_str, bool persist_if_supported);
+    // Typed variant for callers that already hold the value in its descriptor type
+    esp_err_t handle_update(const char* module_name, const char* key, const ConfigValue& value, bool persist_if_supported);
 
     // Accessors for modules
     WifiConfig& wifi();
@@ -46,6 +52,10 @@ public:
     LEDConfig& led2();
     LEDConfig& led3();
     LEDConfig& led4();
+    LEDConfig& led5();
+    LEDConfig& led6();
+    LEDConfig& led7();
+    LEDConfig& led8();
     A2DConfig& a2d1();
     A2DConfig& a2d2();
     A2DConfig& a2d3();
@@ -61,6 +71,13 @@ public:
     IOConfig& io6();
     IOConfig& io7();
     IOConfig& io8();
+    // LEDC PWM outputs on native GPIOs
+    PWMConfig& pwm1();
+    PWMConfig& pwm2();
+    PWMConfig& pwm3();
+    PWMConfig& pwm4();
+    // Alarm thresholds and annunciation
+    AlarmConfig& alarm();
     // I2C address->driver mapping
     I2CConfig& i2cmap();
 
@@ -82,6 +99,17 @@ private:
     // Finds module by name
     ConfigurationModule* find_module(const char* module_name);
 
+    // Boot load from the single-blob snapshot; fails (and applies nothing) if it is missing or corrupt
+    esp_err_t load_snapshot(size_t* entries, size_t* bytes);
+    // Write the snapshot blob after a per-key boot load; callers hold a flash_window::Scope
+    esp_err_t save_snapshot(const ConfigSnapshot& snapshot);
+    // Erase the snapshot before the first per-key write since boot; a no-op once it is gone
+    esp_err_t invalidate_snapshot();
+
+    // Applies a typed update, persists it when allowed and republishes the configuration
+    esp_err_t apply_and_persist(ConfigurationModule* mod, const ConfigurationValueDescriptor* desc, const char* key,
+                                const ConfigValue& value, bool persist_if_supported);
+
     // Builds a cJSON object with the entire configuration
     cJSON* build_full_config_json() const;
 
@@ -94,6 +122,10 @@ private:
     std::unique_ptr<LEDConfig> led2_module_;
     std::unique_ptr<LEDConfig> led3_module_;
     std::unique_ptr<LEDConfig> led4_module_;
+    std::unique_ptr<LEDConfig> led5_module_;
+    std::unique_ptr<LEDConfig> led6_module_;
+    std::unique_ptr<LEDConfig> led7_module_;
+    std::unique_ptr<LEDConfig> led8_module_;
     std::unique_ptr<A2DConfig> a2d1_module_;
     std::unique_ptr<A2DConfig> a2d2_module_;
     std::unique_ptr<A2DConfig> a2d3_module_;
@@ -107,8 +139,15 @@ private:
     std::unique_ptr<IOConfig> io6_module_;
     std::unique_ptr<IOConfig> io7_module_;
     std::unique_ptr<IOConfig> io8_module_;
+    std::unique_ptr<PWMConfig> pwm1_module_;
+    std::unique_ptr<PWMConfig> pwm2_module_;
+    std::unique_ptr<PWMConfig> pwm3_module_;
+    std::unique_ptr<PWMConfig> pwm4_module_;
+    std::unique_ptr<AlarmConfig> alarm_module_;
     std::unique_ptr<I2CConfig> i2cmap_module_;
     std::vector<ConfigurationModule*> modules_;
+    // The snapshot blob in NVS matches the per-key namespaces; cleared by the first persisted update
+    bool snapshot_stored_ = false;
 };
 
 // Global singleton accessor
@@ -2,6 +2,8 @@
 
 #include "esp_err.h"
 #include "configuration_types.h"
+#include "BoundedString.h"
+#include <string.h>
 #include <string>
 #include <vector>
 
@@ -17,9 +19,48 @@ public:
     // Static descriptors of supported values (ownership remains with module)
     virtual const std::vector<ConfigurationValueDescriptor>& descriptors() const = 0;
 
-    // Apply an update coming from NVS load, console, or MQTT
-    // value is provided as a string; module performs parsing based on descriptor type
-    virtual esp_err_t apply_update(const char* key, const char* value_str) = 0;
+    // Apply an update coming from NVS load, console, MQTT or a JSON reset. The caller has already
+    // converted the value to the key's descriptor type (or it is unset, which clears the key), so
+    // modules validate ranges and enums but never parse numbers or booleans.
+    virtual esp_err_t apply_value(const char* key, const ConfigValue& value) = 0;
+
+    // Current value of a key in its descriptor type; unset when not configured. ConfigurationManager
+    // persists this normalized value after an update. Modules may return ESP_ERR_NOT_SUPPORTED (for
+    // everything or per key), in which case the value as applied is persisted instead.
+    virtual esp_err_t get_value(const char* key, ConfigValue& out) const {
+        (void)key;
+        (void)out;
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    // Text edge for console/MQTT payloads: parse value_str according to the key's descriptor and apply.
+    // Keys without a descriptor are passed through as strings so modules with computed key spaces can
+    // still validate them.
+    esp_err_t apply_update(const char* key, const char* value_str) {
+        if (key == nullptr) return ESP_ERR_INVALID_ARG;
+        const ConfigurationValueDescriptor* desc = find_descriptor(key);
+        ConfigValue value;
+        esp_err_t err = ConfigValue::parse(desc ? desc->type : ConfigValueType::String, value_str, value);
+        if (err == ESP_OK) err = check_size(desc, value);
+        if (err != ESP_OK) return err;
+        return apply_value(key, value);
+    }
+
+    // Size edge: ESP_ERR_INVALID_SIZE for a String/Blob value longer than the descriptor's max_len.
+    // Module storage is sized from the same constants (BoundedString.h), so a value that passes fits.
+    static esp_err_t check_size(const ConfigurationValueDescriptor* desc, const ConfigValue& value) {
+        if (!desc || desc->max_len == 0 || !value.is_set) return ESP_OK;
+        if (value.type != ConfigValueType::String && value.type != ConfigValueType::Blob) return ESP_OK;
+        return value.size > desc->max_len ? ESP_ERR_INVALID_SIZE : ESP_OK;
+    }
+
+    const ConfigurationValueDescriptor* find_descriptor(const char* key) const {
+        if (key == nullptr) return nullptr;
+        for (const auto& d : descriptors()) {
+            if (strcmp(d.name, key) == 0) return &d;
+        }
+        return nullptr;
+    }
 
     // Serialize current module configuration into a provided cJSON object
     // The method should add an object under this module's name with key/value pairs
@@ -5,7 +5,7 @@
 namespace config {
 
 const std::vector<ConfigurationValueDescriptor> DeviceConfig::descriptors_ = {
-    { "type", ConfigValueType::String, nullptr, true },
+    { "type", ConfigValueType::String, nullptr, true, kTypeMaxLen },
 };
 
 DeviceConfig::DeviceConfig() {}
@@ -15,9 +15,17 @@ const std::vector<ConfigurationValueDescriptor>& DeviceConfig::descriptors() con
     return descriptors_;
 }
 
-esp_err_t DeviceConfig::apply_update(const char* key, const char* value_str) {
+esp_err_t DeviceConfig::apply_value(const char* key, const ConfigValue& value) {
     if (strcmp(key, "type") == 0) {
-        type_ = value_str ? value_str : "";
+        const char* value_str = value.c_str();
+        return type_.assign(value_str) ? ESP_OK : ESP_ERR_INVALID_SIZE;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t DeviceConfig::get_value(const char* key, ConfigValue& out) const {
+    if (strcmp(key, "type") == 0) {
+        out = ConfigValue::of_string(type_.c_str());
         return ESP_OK;
     }
     return ESP_ERR_NOT_FOUND;
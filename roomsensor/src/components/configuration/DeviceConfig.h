@@ -1,26 +1,28 @@
 #pragma once
 
 #include "ConfigurationModule.h"
-#include <string>
 #include <vector>
 
 namespace config {
 
 class DeviceConfig : public ConfigurationModule {
 public:
+    static constexpr uint16_t kTypeMaxLen = 31;
+
     DeviceConfig();
     ~DeviceConfig() override;
 
     const char* name() const override { return "device"; }
     const std::vector<ConfigurationValueDescriptor>& descriptors() const override;
 
-    esp_err_t apply_update(const char* key, const char* value_str) override;
+    esp_err_t apply_value(const char* key, const ConfigValue& value) override;
+    esp_err_t get_value(const char* key, ConfigValue& out) const override;
     esp_err_t to_json(cJSON* root_object) const override;
 
-    const std::string& type() const { return type_; }
+    const BoundedString<kTypeMaxLen>& type() const { return type_; }
 
 private:
-    std::string type_;
+    BoundedString<kTypeMaxLen> type_;
     static const std::vector<ConfigurationValueDescriptor> descriptors_;
 };
 
@@ -4,39 +4,61 @@
 
 namespace config {
 
-esp_err_t GameOfLifeConfig::apply_update(const char* key, const char* value_str) {
+esp_err_t GameOfLifeConfig::apply_value(const char* key, const ConfigValue& value) {
     if (!key) return ESP_ERR_INVALID_ARG;
+    const char* value_str = value.c_str();
     if (strcmp(key, "start") == 0) {
         if (value_str == nullptr || value_str[0] == '\0') {
             start_set_ = false;
             start_seed_.clear();
         } else {
+            if (!start_seed_.assign(value_str)) return ESP_ERR_INVALID_SIZE;
             start_set_ = true;
-            start_seed_ = value_str;
         }
         // generation bumped centrally by ConfigurationManager
         return ESP_OK;
     }
     if (strcmp(key, "restart") == 0) {
         // Tri-state: if unset, revert to default true
+        restart_set_ = value.is_set;
+        restart_ = value.as_bool(true);
+        return ESP_OK;
+    }
+    if (strcmp(key, "rule") == 0) {
         if (value_str == nullptr || value_str[0] == '\0') {
-            restart_set_ = false;
-            restart_ = true;
-            return ESP_OK;
-        }
-        if (strcasecmp(value_str, "1") == 0 || strcasecmp(value_str, "true") == 0 ||
-            strcasecmp(value_str, "on") == 0 || strcasecmp(value_str, "yes") == 0) {
-            restart_set_ = true;
-            restart_ = true;
-            return ESP_OK;
-        }
-        if (strcasecmp(value_str, "0") == 0 || strcasecmp(value_str, "false") == 0 ||
-            strcasecmp(value_str, "off") == 0 || strcasecmp(value_str, "no") == 0) {
-            restart_set_ = true;
-            restart_ = false;
-            return ESP_OK;
+            rule_set_ = false;
+            rule_.clear();
+        } else {
+            if (!rule_.assign(value_str)) return ESP_ERR_INVALID_SIZE;
+            rule_set_ = true;
         }
-        return ESP_ERR_INVALID_ARG;
+        return ESP_OK;
+    }
+    if (strcmp(key, "wrap") == 0) {
+        wrap_set_ = value.is_set;
+        wrap_ = value.as_bool(true);
+        return ESP_OK;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t GameOfLifeConfig::get_value(const char* key, ConfigValue& out) const {
+    if (!key) return ESP_ERR_INVALID_ARG;
+    if (strcmp(key, "start") == 0) {
+        out = start_set_ ? ConfigValue::of_string(start_seed_.c_str()) : ConfigValue::unset(ConfigValueType::String);
+        return ESP_OK;
+    }
+    if (strcmp(key, "restart") == 0) {
+        out = restart_set_ ? ConfigValue::of_bool(restart_) : ConfigValue::unset(ConfigValueType::Bool);
+        return ESP_OK;
+    }
+    if (strcmp(key, "rule") == 0) {
+        out = rule_set_ ? ConfigValue::of_string(rule_.c_str()) : ConfigValue::unset(ConfigValueType::String);
+        return ESP_OK;
+    }
+    if (strcmp(key, "wrap") == 0) {
+        out = wrap_set_ ? ConfigValue::of_bool(wrap_) : ConfigValue::unset(ConfigValueType::Bool);
+        return ESP_OK;
     }
     return ESP_ERR_NOT_FOUND;
 }
@@ -50,6 +72,12 @@ esp_err_t GameOfLifeConfig::to_json(cJSON* root_object) const {
     if (restart_set_) {
         cJSON_AddBoolToObject(obj, "restart", restart_);
     }
+    if (rule_set_) {
+        cJSON_AddStringToObject(obj, "rule", rule_.c_str());
+    }
+    if (wrap_set_) {
+        cJSON_AddBoolToObject(obj, "wrap", wrap_);
+    }
     cJSON_AddItemToObject(root_object, name(), obj);
     return ESP_OK;
 }
@@ -1,12 +1,14 @@
 #pragma once
 
 #include "ConfigurationModule.h"
-#include <string>
 
 namespace config {
 
 class GameOfLifeConfig : public ConfigurationModule {
 public:
+    static constexpr uint16_t kStartMaxLen = 1023; // seed pattern, in the PSRAM pool
+    static constexpr uint16_t kRuleMaxLen = 31;
+
     GameOfLifeConfig() = default;
     ~GameOfLifeConfig() override = default;
 
@@ -16,28 +18,41 @@ public:
     // Descriptors: game-of-life specific controls
     const std::vector<ConfigurationValueDescriptor>& descriptors() const override { return descriptors_; }
 
-    // Updates come as strings; parse and store
-    esp_err_t apply_update(const char* key, const char* value_str) override;
+    // Typed updates (see ConfigurationModule::apply_value)
+    esp_err_t apply_value(const char* key, const ConfigValue& value) override;
+    esp_err_t get_value(const char* key, ConfigValue& out) const override;
 
     // Serialize to JSON
     esp_err_t to_json(struct cJSON* root_object) const override;
 
     // Accessors
     bool has_start() const { return start_set_; }
-    const std::string& start() const { return start_seed_; }
+    const PooledString& start() const { return start_seed_; }
     // Restart behavior (non-persisted, defaults to true)
     bool restart_enabled() const { return restart_; }
     bool has_restart() const { return restart_set_; }
+    // Cellular automaton rule (non-persisted): B/S[/C] notation or a name such as HIGHLIFE, BRIAN,
+    // WIREWORLD. Empty => Conway's B3/S23.
+    bool has_rule() const { return rule_set_; }
+    const BoundedString<kRuleMaxLen>& rule() const { return rule_; }
+    // Edge handling (non-persisted): true wraps around (torus, default), false treats outside cells as dead
+    bool wrap() const { return wrap_; }
 
 private:
     bool start_set_ = false;
-    std::string start_seed_;
+    PooledString start_seed_{kStartMaxLen};
     bool restart_set_ = false;
     bool restart_ = true; // default to true unless explicitly set
+    bool rule_set_ = false;
+    BoundedString<kRuleMaxLen> rule_;
+    bool wrap_set_ = false;
+    bool wrap_ = true;
     std::vector<ConfigurationValueDescriptor> descriptors_{
         // Keep non-persisted to avoid flash wear on frequent tuning; still load if pre-provisioned
-        {"start", ConfigValueType::String, nullptr, false},
+        {"start", ConfigValueType::String, nullptr, false, kStartMaxLen},
         {"restart", ConfigValueType::Bool, "true", false},
+        {"rule", ConfigValueType::String, nullptr, false, kRuleMaxLen},
+        {"wrap", ConfigValueType::Bool, "true", false},
     };
 };
 
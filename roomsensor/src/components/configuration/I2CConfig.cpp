@@ -59,7 +59,8 @@ bool I2CConfig::normalize_hex_key(const char* key_in, std::string& normalized) {
     return true;
 }
 
-esp_err_t I2CConfig::apply_update(const char* key, const char* value_str) {
+esp_err_t I2CConfig::apply_value(const char* key, const ConfigValue& value) {
+    const char* value_str = value.c_str();
     std::string norm;
     if (!normalize_hex_key(key, norm)) {
         ESP_LOGW(TAG, "Invalid I2C address key: %s", key ? key : "(null)");
@@ -16,7 +16,7 @@ IOConfig::IOConfig(const char* instance_name) : name_(instance_name ? instance_n
     for (int i = 1; i <= 8; ++i) {
         char key[16];
         snprintf(key, sizeof(key), "pin%dname", i);
-        descriptors_.push_back({strdup(key), ConfigValueType::String, nullptr, true});
+        descriptors_.push_back({strdup(key), ConfigValueType::String, nullptr, true, kPinNameMaxLen});
     }
     // Persisted descriptor: logic (optional)
     descriptors_.push_back({strdup("logic"), ConfigValueType::String, nullptr, true});
@@ -77,8 +77,9 @@ const char* IOConfig::logic_to_string(IOConfig::Logic lgc) {
     }
 }
 
-esp_err_t IOConfig::apply_update(const char* key, const char* value_str) {
+esp_err_t IOConfig::apply_value(const char* key, const ConfigValue& value) {
     if (!key) return ESP_ERR_INVALID_ARG;
+    const char* value_str = value.c_str();
 
     // pinNconfig
     if (strncmp(key, "pin", 3) == 0 && strstr(key, "config") != nullptr) {
@@ -97,8 +98,8 @@ esp_err_t IOConfig::apply_update(const char* key, const char* value_str) {
     if (strncmp(key, "pin", 3) == 0 && strstr(key, "name") != nullptr) {
         int idx = 0; // 1..8
         if (sscanf(key, "pin%dname", &idx) == 1 && idx >= 1 && idx <= 8) {
+            if (!pin_names_[idx - 1].assign(value_str)) return ESP_ERR_INVALID_SIZE;
             pin_name_set_[idx - 1] = (value_str != nullptr);
-            pin_names_[idx - 1] = (value_str != nullptr) ? value_str : "";
             return ESP_OK;
         }
         return ESP_ERR_INVALID_ARG;
@@ -120,19 +121,8 @@ esp_err_t IOConfig::apply_update(const char* key, const char* value_str) {
     if (strncmp(key, "switch", 6) == 0 || (strncmp(key, "pin", 3) == 0 && strstr(key, "switch") != nullptr)) {
         int idx = 0;
         if ((sscanf(key, "switch%d", &idx) == 1 || sscanf(key, "pin%dswitch", &idx) == 1) && idx >= 1 && idx <= 8) {
-            // Interpret truthy/falsy
-            bool v = false;
-            if (value_str) {
-                if (strcasecmp(value_str, "1") == 0 || strcasecmp(value_str, "true") == 0 ||
-                    strcasecmp(value_str, "on") == 0 || strcasecmp(value_str, "yes") == 0) {
-                    v = true;
-                } else if (strcasecmp(value_str, "0") == 0 || strcasecmp(value_str, "false") == 0 ||
-                           strcasecmp(value_str, "off") == 0 || strcasecmp(value_str, "no") == 0) {
-                    v = false;
-                } else {
-                    return ESP_ERR_INVALID_ARG;
-                }
-            }
+            // Unset reads as off
+            bool v = value.as_bool(false);
             // Update base and effective states
             base_switch_states_[idx - 1] = v;
             base_switch_state_set_[idx - 1] = true;
@@ -147,18 +137,7 @@ esp_err_t IOConfig::apply_update(const char* key, const char* value_str) {
     if (strncmp(key, "pin", 3) == 0 && strstr(key, "contact") != nullptr) {
         int idx = 0;
         if (sscanf(key, "pin%dcontact", &idx) == 1 && idx >= 1 && idx <= 8) {
-            bool v = false;
-            if (value_str) {
-                if (strcasecmp(value_str, "1") == 0 || strcasecmp(value_str, "true") == 0 ||
-                    strcasecmp(value_str, "on") == 0 || strcasecmp(value_str, "yes") == 0) {
-                    v = true;
-                } else if (strcasecmp(value_str, "0") == 0 || strcasecmp(value_str, "false") == 0 ||
-                           strcasecmp(value_str, "off") == 0 || strcasecmp(value_str, "no") == 0) {
-                    v = false;
-                } else {
-                    return ESP_ERR_INVALID_ARG;
-                }
-            }
+            bool v = value.as_bool(false);
             contact_states_[idx - 1] = v;
             contact_state_set_[idx - 1] = true;
             return ESP_OK;
@@ -2,7 +2,6 @@
 
 #include "ConfigurationModule.h"
 #include "configuration_types.h"
-#include <string>
 #include <vector>
 
 // Forward declare to avoid heavy include in header
@@ -25,13 +24,15 @@ public:
         LOCK_KEYPAD,
     };
 
+    static constexpr uint16_t kPinNameMaxLen = 31;
+
     explicit IOConfig(const char* instance_name);
     ~IOConfig() override = default;
 
     // ConfigurationModule API
     const char* name() const override;
     const std::vector<ConfigurationValueDescriptor>& descriptors() const override;
-    esp_err_t apply_update(const char* key, const char* value_str) override;
+    esp_err_t apply_value(const char* key, const ConfigValue& value) override;
     esp_err_t to_json(struct cJSON* root_object) const override;
 
     // Accessors
@@ -68,7 +69,7 @@ public:
     static const char* logic_to_string(Logic lgc);
 
 private:
-    std::string name_;
+    BoundedString<15> name_;
     std::vector<ConfigurationValueDescriptor> descriptors_;
 
     PinMode pin_modes_[8] = {PinMode::INVALID, PinMode::INVALID, PinMode::INVALID, PinMode::INVALID,
@@ -81,7 +82,7 @@ private:
     bool base_switch_state_set_[8] = {false, false, false, false, false, false, false, false};
 
     // Persisted pin names (pin1name..pin8name)
-    std::string pin_names_[8] = {"", "", "", "", "", "", "", ""};
+    BoundedString<kPinNameMaxLen> pin_names_[8];
     bool pin_name_set_[8] = {false, false, false, false, false, false, false, false};
 
     // Non-persisted contact states for SENSOR pins
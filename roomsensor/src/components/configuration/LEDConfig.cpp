@@ -1,6 +1,7 @@
 #include "LEDConfig.h"
 #include "cJSON.h"
 #include <cstring>
+#include <cstdio>
 
 namespace config {
 
@@ -8,21 +9,26 @@ LEDConfig::LEDConfig(const char* instance_name) : name_(instance_name ? instance
     // Persisted descriptors
     descriptors_.push_back({"dataGPIO", ConfigValueType::I32, nullptr, true});
     descriptors_.push_back({"enabledGPIO", ConfigValueType::I32, nullptr, true});
-    descriptors_.push_back({"enabledGPIOs", ConfigValueType::String, nullptr, true});
-    descriptors_.push_back({"chip", ConfigValueType::String, "WS2812", true});
+    descriptors_.push_back({"enabledGPIOs", ConfigValueType::String, nullptr, true, kGpioListMaxLen});
+    descriptors_.push_back({"chip", ConfigValueType::String, "WS2812", true, kEnumMaxLen});
     descriptors_.push_back({"num_columns", ConfigValueType::I32, "1", true});
     descriptors_.push_back({"num_rows", ConfigValueType::I32, "1", true});
     descriptors_.push_back({"segment_rows", ConfigValueType::I32, nullptr, true});
-    descriptors_.push_back({"layout", ConfigValueType::String, "ROW_MAJOR", true});
-    descriptors_.push_back({"name", ConfigValueType::String, nullptr, true});
-    descriptors_.push_back({"message", ConfigValueType::String, nullptr, true});
+    descriptors_.push_back({"layout", ConfigValueType::String, "ROW_MAJOR", true, kEnumMaxLen});
+    descriptors_.push_back({"name", ConfigValueType::String, nullptr, true, kDisplayNameMaxLen});
+    descriptors_.push_back({"message", ConfigValueType::String, nullptr, true, kMessageMaxLen});
+    descriptors_.push_back({"max_current_ma", ConfigValueType::I32, nullptr, true});
+    descriptors_.push_back({"current_sense", ConfigValueType::String, nullptr, true, kCurrentSenseMaxLen});
+    descriptors_.push_back({"crossfade_ms", ConfigValueType::I32, nullptr, true});
 
     // Non-persisted runtime values (still declared so they can be updated and optionally loaded once)
     // NOTE: The following keys are intentionally NOT persisted to avoid flash wear from frequent updates:
     //   - pattern, speed, brightness, R, G, B, W, dma
     // ConfigurationManager will still read any pre-provisioned string values from NVS (e.g., pattern)
     // regardless of the 'persisted' flag, allowing device-specific defaults without ongoing writes.
-    descriptors_.push_back({"pattern", ConfigValueType::String, nullptr, false});
+    // After a reboot LEDManager keeps the LED boot record's values for these until they are set again
+    // (leds/LEDBootFallback.h).
+    descriptors_.push_back({"pattern", ConfigValueType::String, nullptr, false, kEnumMaxLen});
     descriptors_.push_back({"R", ConfigValueType::I32, nullptr, false});
     descriptors_.push_back({"G", ConfigValueType::I32, nullptr, false});
     descriptors_.push_back({"B", ConfigValueType::I32, nullptr, false});
@@ -46,6 +52,7 @@ LEDConfig::Chip LEDConfig::parse_chip(const char* value) {
     if (strcmp(value, "SK6812") == 0) return Chip::SK6812;
     if (strcmp(value, "WS2814") == 0) return Chip::WS2814;
     if (strcmp(value, "FLIPDOT") == 0) return Chip::FLIPDOT;
+    if (strcmp(value, "FLIPDOT_PACKED") == 0) return Chip::FLIPDOT_PACKED;
     return Chip::INVALID;
 }
 
@@ -55,6 +62,7 @@ const char* LEDConfig::chip_to_string(LEDConfig::Chip c) {
         case Chip::SK6812: return "SK6812";
         case Chip::WS2814: return "WS2814";
         case Chip::FLIPDOT: return "FLIPDOT";
+        case Chip::FLIPDOT_PACKED: return "FLIPDOT_PACKED";
         case Chip::INVALID: default: return "WS2812";
     }
 }
@@ -100,6 +108,7 @@ LEDConfig::Pattern LEDConfig::parse_pattern(const char* value) {
     if (strcmp(value, "CROSS_FADE") == 0) return Pattern::CROSS_FADE;
     if (strcmp(value, "FIREWORKS") == 0) return Pattern::FIREWORKS;
     if (strcmp(value, "MARQUEE") == 0) return Pattern::MARQUEE;
+    if (strcmp(value, "DASHBOARD") == 0) return Pattern::DASHBOARD;
     return Pattern::INVALID;
 }
 
@@ -124,22 +133,24 @@ const char* LEDConfig::pattern_to_string(LEDConfig::Pattern p) {
         case Pattern::CROSS_FADE: return "CROSS_FADE";
         case Pattern::FIREWORKS: return "FIREWORKS";
         case Pattern::MARQUEE: return "MARQUEE";
+        case Pattern::DASHBOARD: return "DASHBOARD";
     }
     return "OFF";
 }
 
-esp_err_t LEDConfig::apply_update(const char* key, const char* value_str) {
+esp_err_t LEDConfig::apply_value(const char* key, const ConfigValue& value) {
     if (key == nullptr) return ESP_ERR_INVALID_ARG;
+    const char* value_str = value.c_str(); // string-typed keys
 
     if (strcmp(key, "dataGPIO") == 0) {
-        data_gpio_set_ = (value_str != nullptr);
-        data_gpio_ = value_str ? atoi(value_str) : -1;
+        data_gpio_set_ = value.is_set;
+        data_gpio_ = value.as_i32(-1);
         /* generation bumped centrally */
         return ESP_OK;
     }
     if (strcmp(key, "enabledGPIO") == 0) {
-        enabled_gpio_set_ = (value_str != nullptr);
-        enabled_gpio_ = value_str ? atoi(value_str) : -1;
+        enabled_gpio_set_ = value.is_set;
+        enabled_gpio_ = value.as_i32(-1);
         /* generation bumped centrally */
         return ESP_OK;
     }
@@ -188,20 +199,20 @@ esp_err_t LEDConfig::apply_update(const char* key, const char* value_str) {
         return ESP_ERR_INVALID_ARG;
     }
     if (strcmp(key, "num_columns") == 0) {
-        num_columns_ = value_str ? atoi(value_str) : 1;
+        num_columns_ = value.as_i32(1);
         if (num_columns_ <= 0) num_columns_ = 1;
         /* generation bumped centrally */
         return ESP_OK;
     }
     if (strcmp(key, "num_rows") == 0) {
-        num_rows_ = value_str ? atoi(value_str) : 1;
+        num_rows_ = value.as_i32(1);
         if (num_rows_ <= 0) num_rows_ = 1;
         /* generation bumped centrally */
         return ESP_OK;
     }
     if (strcmp(key, "segment_rows") == 0) {
-        segment_rows_set_ = (value_str != nullptr);
-        segment_rows_ = value_str ? atoi(value_str) : 0;
+        segment_rows_set_ = value.is_set;
+        segment_rows_ = value.as_i32(0);
         if (segment_rows_ < 0) segment_rows_ = 0; // 0 => whole height
         /* generation bumped centrally */
         return ESP_OK;
@@ -220,7 +231,7 @@ esp_err_t LEDConfig::apply_update(const char* key, const char* value_str) {
             /* generation bumped centrally */
             return ESP_OK;
         }
-        display_name_ = value_str;
+        if (!display_name_.assign(value_str)) return ESP_ERR_INVALID_SIZE;
         name_set_ = true;
         /* generation bumped centrally */
         return ESP_OK;
@@ -230,13 +241,52 @@ esp_err_t LEDConfig::apply_update(const char* key, const char* value_str) {
             message_.clear();
             message_set_ = false;
         } else {
-            message_ = value_str;
+            if (!message_.assign(value_str)) return ESP_ERR_INVALID_SIZE;
             message_set_ = true;
         }
         /* generation bumped centrally */
         return ESP_OK;
     }
 
+    if (strcmp(key, "max_current_ma") == 0) {
+        current_limit_ma_ = value.as_i32(0);
+        if (current_limit_ma_ < 0) current_limit_ma_ = 0;
+        current_limit_set_ = value.is_set && current_limit_ma_ > 0; // 0 => unlimited
+        /* generation bumped centrally */
+        return ESP_OK;
+    }
+    if (strcmp(key, "current_sense") == 0) {
+        // Format: "a2d<1-4>.ch<1-4>" naming an ADS1115 channel configured as BTS7002 current sense
+        if (value_str == nullptr || *value_str == '\0') {
+            current_sense_set_ = false;
+            current_sense_.clear();
+            current_sense_module_ = 0;
+            current_sense_channel_ = 0;
+            /* generation bumped centrally */
+            return ESP_OK;
+        }
+        int module = 0, channel = 0;
+        if (sscanf(value_str, "a2d%d.ch%d", &module, &channel) != 2 ||
+            module < 1 || module > 4 || channel < 1 || channel > 4) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (!current_sense_.assign(value_str)) return ESP_ERR_INVALID_SIZE;
+        current_sense_module_ = module;
+        current_sense_channel_ = channel;
+        current_sense_set_ = true;
+        /* generation bumped centrally */
+        return ESP_OK;
+    }
+
+    if (strcmp(key, "crossfade_ms") == 0) {
+        crossfade_ms_ = value.as_i32(0);
+        if (crossfade_ms_ < 0) crossfade_ms_ = 0;
+        if (crossfade_ms_ > 10000) crossfade_ms_ = 10000;
+        crossfade_set_ = value.is_set;
+        /* generation bumped centrally */
+        return ESP_OK;
+    }
+
     // Non-persisted
     if (strcmp(key, "pattern") == 0) {
         Pattern parsed = parse_pattern(value_str);
@@ -249,53 +299,74 @@ esp_err_t LEDConfig::apply_update(const char* key, const char* value_str) {
         }
         return ESP_ERR_INVALID_ARG;
     }
-    if (strcmp(key, "R") == 0) { r_ = value_str ? atoi(value_str) : 0; r_set_ = (value_str != nullptr); bump_generation(); return ESP_OK; }
-    if (strcmp(key, "G") == 0) { g_ = value_str ? atoi(value_str) : 0; g_set_ = (value_str != nullptr); bump_generation(); return ESP_OK; }
-    if (strcmp(key, "B") == 0) { b_ = value_str ? atoi(value_str) : 0; b_set_ = (value_str != nullptr); bump_generation(); return ESP_OK; }
-    if (strcmp(key, "W") == 0) { w_ = value_str ? atoi(value_str) : 0; w_set_ = (value_str != nullptr); bump_generation(); return ESP_OK; }
+    if (strcmp(key, "R") == 0) { r_ = value.as_i32(0); r_set_ = value.is_set; bump_generation(); return ESP_OK; }
+    if (strcmp(key, "G") == 0) { g_ = value.as_i32(0); g_set_ = value.is_set; bump_generation(); return ESP_OK; }
+    if (strcmp(key, "B") == 0) { b_ = value.as_i32(0); b_set_ = value.is_set; bump_generation(); return ESP_OK; }
+    if (strcmp(key, "W") == 0) { w_ = value.as_i32(0); w_set_ = value.is_set; bump_generation(); return ESP_OK; }
     if (strcmp(key, "brightness") == 0) {
-        brightness_ = value_str ? atoi(value_str) : 100;
+        brightness_ = value.as_i32(100);
         if (brightness_ < 0) brightness_ = 0;
         if (brightness_ > 100) brightness_ = 100;
-        brightness_set_ = (value_str != nullptr);
+        brightness_set_ = value.is_set;
         /* generation bumped centrally */
         return ESP_OK;
     }
     if (strcmp(key, "speed") == 0) {
-        speed_ = value_str ? atoi(value_str) : 100;
+        speed_ = value.as_i32(100);
         if (speed_ < 0) speed_ = 0;
         if (speed_ > 100) speed_ = 100;
-        speed_set_ = (value_str != nullptr);
+        speed_set_ = value.is_set;
         /* generation bumped centrally */
         return ESP_OK;
     }
     if (strcmp(key, "dma") == 0) {
-        // Tri-state: if value_str is null, clear; otherwise parse truthy/falsy
-        if (value_str == nullptr || value_str[0] == '\0') {
-            dma_set_ = false; // unset -> auto-assign
-            dma_ = false;
-            bump_generation();
-            return ESP_OK;
-        }
-        // Accept common boolean strings
-        if (strcasecmp(value_str, "1") == 0 || strcasecmp(value_str, "true") == 0 || strcasecmp(value_str, "on") == 0 || strcasecmp(value_str, "yes") == 0) {
-            dma_set_ = true;
-            dma_ = true;
-            bump_generation();
-            return ESP_OK;
-        }
-        if (strcasecmp(value_str, "0") == 0 || strcasecmp(value_str, "false") == 0 || strcasecmp(value_str, "off") == 0 || strcasecmp(value_str, "no") == 0) {
-            dma_set_ = true;
-            dma_ = false;
-            bump_generation();
-            return ESP_OK;
-        }
-        return ESP_ERR_INVALID_ARG;
+        // Tri-state: unset clears (auto-assign); otherwise explicit on/off
+        dma_set_ = value.is_set;
+        dma_ = value.as_bool(false);
+        bump_generation();
+        return ESP_OK;
     }
 
     return ESP_ERR_NOT_FOUND;
 }
 
+esp_err_t LEDConfig::get_value(const char* key, ConfigValue& out) const {
+    if (key == nullptr) return ESP_ERR_INVALID_ARG;
+    auto i32 = [&out](bool set, int v) {
+        out = set ? ConfigValue::of_i32(v) : ConfigValue::unset(ConfigValueType::I32);
+        return ESP_OK;
+    };
+    auto str = [&out](bool set, std::string_view v) {
+        out = set ? ConfigValue::of_string(v.data()) : ConfigValue::unset(ConfigValueType::String);
+        return ESP_OK;
+    };
+    if (strcmp(key, "dataGPIO") == 0) return i32(data_gpio_set_, data_gpio_);
+    if (strcmp(key, "enabledGPIO") == 0) return i32(enabled_gpio_set_, enabled_gpio_);
+    if (strcmp(key, "enabledGPIOs") == 0) return ESP_ERR_NOT_SUPPORTED; // stored as a parsed list
+    if (strcmp(key, "chip") == 0) return str(true, chip_);
+    if (strcmp(key, "num_columns") == 0) return i32(true, num_columns_);
+    if (strcmp(key, "num_rows") == 0) return i32(true, num_rows_);
+    if (strcmp(key, "segment_rows") == 0) return i32(segment_rows_set_, segment_rows_);
+    if (strcmp(key, "layout") == 0) return str(true, layout_);
+    if (strcmp(key, "name") == 0) return str(name_set_, display_name_);
+    if (strcmp(key, "message") == 0) return str(message_set_, message_);
+    if (strcmp(key, "max_current_ma") == 0) return i32(current_limit_set_, current_limit_ma_);
+    if (strcmp(key, "current_sense") == 0) return str(current_sense_set_, current_sense_);
+    if (strcmp(key, "crossfade_ms") == 0) return i32(crossfade_set_, crossfade_ms_);
+    if (strcmp(key, "pattern") == 0) return str(pattern_set_, pattern_);
+    if (strcmp(key, "R") == 0) return i32(r_set_, r_);
+    if (strcmp(key, "G") == 0) return i32(g_set_, g_);
+    if (strcmp(key, "B") == 0) return i32(b_set_, b_);
+    if (strcmp(key, "W") == 0) return i32(w_set_, w_);
+    if (strcmp(key, "brightness") == 0) return i32(brightness_set_, brightness_);
+    if (strcmp(key, "speed") == 0) return i32(speed_set_, speed_);
+    if (strcmp(key, "dma") == 0) {
+        out = dma_set_ ? ConfigValue::of_bool(dma_) : ConfigValue::unset(ConfigValueType::Bool);
+        return ESP_OK;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
 esp_err_t LEDConfig::to_json(cJSON* root_object) const {
     if (!root_object) return ESP_ERR_INVALID_ARG;
     cJSON* obj = cJSON_CreateObject();
@@ -321,6 +392,9 @@ esp_err_t LEDConfig::to_json(cJSON* root_object) const {
     cJSON_AddStringToObject(obj, "layout", layout_.c_str());
     if (name_set_) cJSON_AddStringToObject(obj, "name", display_name_.c_str());
     if (message_set_) cJSON_AddStringToObject(obj, "message", message_.c_str());
+    if (current_limit_set_) cJSON_AddNumberToObject(obj, "max_current_ma", current_limit_ma_);
+    if (current_sense_set_) cJSON_AddStringToObject(obj, "current_sense", current_sense_.c_str());
+    if (crossfade_set_) cJSON_AddNumberToObject(obj, "crossfade_ms", crossfade_ms_);
 
     // Non-persisted runtime fields (include only if set)
     if (pattern_set_) cJSON_AddStringToObject(obj, "pattern", pattern_.c_str());
@@ -1,7 +1,6 @@
 #pragma once
 
 #include "ConfigurationModule.h"
-#include <string>
 #include <vector>
 #include <algorithm>
 
@@ -9,11 +8,19 @@ namespace config {
 
 class LEDConfig : public ConfigurationModule {
 public:
+    // Longest accepted values; the descriptors and the storage below use the same limits
+    static constexpr uint16_t kEnumMaxLen = 23;        // chip, layout, pattern names
+    static constexpr uint16_t kGpioListMaxLen = 63;    // enabledGPIOs, parsed into a list
+    static constexpr uint16_t kDisplayNameMaxLen = 31;
+    static constexpr uint16_t kMessageMaxLen = 511;    // marquee text, in the PSRAM pool
+    static constexpr uint16_t kCurrentSenseMaxLen = 15;
+
     explicit LEDConfig(const char* instance_name);
 
     const char* name() const override;
     const std::vector<ConfigurationValueDescriptor>& descriptors() const override;
-    esp_err_t apply_update(const char* key, const char* value_str) override;
+    esp_err_t apply_value(const char* key, const ConfigValue& value) override;
+    esp_err_t get_value(const char* key, ConfigValue& out) const override;
     esp_err_t to_json(struct cJSON* root_object) const override;
 
     // Available LED patterns for internal use
@@ -36,7 +43,8 @@ public:
         CROSS_WIPE,
         CROSS_FADE,
         FIREWORKS,
-        MARQUEE
+        MARQUEE,
+        DASHBOARD
     };
 
     // Supported LED chips for internal use
@@ -46,7 +54,9 @@ public:
         SK6812,
         WS2814,
         FLIPDOT,
+        FLIPDOT_PACKED, // bit-packed flipdot protocol (leds/FlipdotPacket.h); needs matching receivers
     };
+    static bool is_flipdot(Chip c) { return c == Chip::FLIPDOT || c == Chip::FLIPDOT_PACKED; }
 
     // Grid layout for mapping logical (row,col) to physical. Defaults to ROW_MAJOR.
     enum class Layout {
@@ -79,17 +89,17 @@ public:
         pins.erase(std::unique(pins.begin(), pins.end()), pins.end());
         return pins;
     }
-    const std::string& chip() const { return chip_; }
+    const BoundedString<kEnumMaxLen>& chip() const { return chip_; }
     Chip chip_enum() const { return chip_enum_; }
     int num_columns() const { return num_columns_; }
     int num_rows() const { return num_rows_; }
     bool has_segment_rows() const { return segment_rows_set_; }
     int segment_rows() const { return segment_rows_; }
-    const std::string& layout() const { return layout_; }
+    const BoundedString<kEnumMaxLen>& layout() const { return layout_; }
     Layout layout_enum() const { return layout_enum_; }
 
     bool has_pattern() const { return pattern_set_; }
-    const std::string& pattern() const { return pattern_; }
+    const BoundedString<kEnumMaxLen>& pattern() const { return pattern_; }
     Pattern pattern_enum() const { return pattern_enum_; }
     bool has_r() const { return r_set_; }
     int r() const { return r_; }
@@ -107,10 +117,25 @@ public:
     bool dma() const { return dma_; }
     // Optional user-provided display name
     bool has_display_name() const { return name_set_; }
-    const std::string& display_name() const { return display_name_; }
+    const BoundedString<kDisplayNameMaxLen>& display_name() const { return display_name_; }
     // Optional marquee/message text
     bool has_message() const { return message_set_; }
-    const std::string& message() const { return message_; }
+    const PooledString& message() const { return message_; }
+    // Optional supply current budget for the strip in mA (0/unset => unlimited)
+    bool has_current_limit() const { return current_limit_set_; }
+    int current_limit_ma() const { return current_limit_ma_; }
+    // Optional measured rail current source ("a2d2.ch1"): A2D module index and channel, both 1-based
+    bool has_current_sense() const { return current_sense_set_; }
+    const BoundedString<kCurrentSenseMaxLen>& current_sense() const { return current_sense_; }
+    int current_sense_module() const { return current_sense_module_; }
+    int current_sense_channel() const { return current_sense_channel_; }
+    // Crossfade duration when switching patterns (0/unset => hard cut at a frame boundary)
+    int crossfade_ms() const { return crossfade_set_ ? crossfade_ms_ : 0; }
+
+    // True for the named enumerators, for values stored as integers (LED boot record). INVALID is not valid.
+    static bool is_valid(Pattern p) { return parse_pattern(pattern_to_string(p)) == p; }
+    static bool is_valid(Chip c) { return parse_chip(chip_to_string(c)) == c; }
+    static bool is_valid(Layout l) { return parse_layout(layout_to_string(l)) == l; }
 
 private:
     // Parse from external string representation to internal enum. Returns INVALID on failure.
@@ -121,7 +146,7 @@ private:
     static Layout parse_layout(const char* value);
     static const char* layout_to_string(Layout l);
 
-    std::string name_;
+    BoundedString<15> name_;
 
     // Persisted fields
     bool data_gpio_set_ = false;
@@ -130,19 +155,19 @@ private:
     int enabled_gpio_ = -1;
     bool enabled_gpios_set_ = false;
     std::vector<int> enabled_gpios_;
-    std::string chip_ = "WS2812"; // external/string representation
+    BoundedString<kEnumMaxLen> chip_ = "WS2812"; // external/string representation
     Chip chip_enum_ = Chip::WS2812; // internal representation
     int num_columns_ = 1;
     int num_rows_ = 1;
     bool segment_rows_set_ = false; int segment_rows_ = 0; // 0 or unset => whole height
-    std::string layout_ = "ROW_MAJOR";
+    BoundedString<kEnumMaxLen> layout_ = "ROW_MAJOR";
     Layout layout_enum_ = Layout::ROW_MAJOR;
     // Optional persisted display name
-    bool name_set_ = false; std::string display_name_;
+    bool name_set_ = false; BoundedString<kDisplayNameMaxLen> display_name_;
 
     // Non-persisted runtime fields (loaded from NVS if present)
     bool pattern_set_ = false;
-    std::string pattern_;
+    BoundedString<kEnumMaxLen> pattern_;
     Pattern pattern_enum_ = Pattern::OFF; // Internal representation
     bool r_set_ = false; int r_ = 0;
     bool g_set_ = false; int g_ = 0;
@@ -154,7 +179,14 @@ private:
 
     // Optional message string (persisted)
     bool message_set_ = false;
-    std::string message_;
+    PooledString message_{kMessageMaxLen};
+
+    // Optional current limiting (persisted)
+    bool current_limit_set_ = false; int current_limit_ma_ = 0;
+    bool current_sense_set_ = false; BoundedString<kCurrentSenseMaxLen> current_sense_;
+    int current_sense_module_ = 0; int current_sense_channel_ = 0;
+    // Pattern switch crossfade (persisted)
+    bool crossfade_set_ = false; int crossfade_ms_ = 0;
 
     std::vector<ConfigurationValueDescriptor> descriptors_;
 };
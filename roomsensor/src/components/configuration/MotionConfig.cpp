@@ -17,17 +17,26 @@ const std::vector<ConfigurationValueDescriptor>& MotionConfig::descriptors() con
     return descriptors_;
 }
 
-esp_err_t MotionConfig::apply_update(const char* key, const char* value_str) {
+esp_err_t MotionConfig::apply_value(const char* key, const ConfigValue& value) {
     if (key == nullptr) return ESP_ERR_INVALID_ARG;
     if (strcmp(key, "gpio") == 0) {
         // Nullable: if no value provided, clear the setting
-        if (value_str == nullptr || value_str[0] == '\0') {
+        if (!value.is_set) {
             gpio_set_ = false;
             gpio_ = -1;
             return ESP_OK;
         }
         gpio_set_ = true;
-        gpio_ = atoi(value_str);
+        gpio_ = value.as_i32(-1);
+        return ESP_OK;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t MotionConfig::get_value(const char* key, ConfigValue& out) const {
+    if (key == nullptr) return ESP_ERR_INVALID_ARG;
+    if (strcmp(key, "gpio") == 0) {
+        out = gpio_set_ ? ConfigValue::of_i32(gpio_) : ConfigValue::unset(ConfigValueType::I32);
         return ESP_OK;
     }
     return ESP_ERR_NOT_FOUND;
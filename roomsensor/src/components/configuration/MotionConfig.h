@@ -17,7 +17,8 @@ public:
     // ConfigurationModule API
     const char* name() const override;
     const std::vector<ConfigurationValueDescriptor>& descriptors() const override;
-    esp_err_t apply_update(const char* key, const char* value_str) override;
+    esp_err_t apply_value(const char* key, const ConfigValue& value) override;
+    esp_err_t get_value(const char* key, ConfigValue& out) const override;
     esp_err_t to_json(struct cJSON* root_object) const override;
 
     // Accessors
@@ -0,0 +1,144 @@
+#include "PWMConfig.h"
+#include "cJSON.h"
+#include <cstdio>
+#include <cstring>
+
+namespace config {
+
+PWMConfig::PWMConfig(const char* instance_name) : name_(instance_name ? instance_name : "pwm") {
+    // Persisted
+    descriptors_.push_back({"gpio", ConfigValueType::I32, nullptr, true});
+    descriptors_.push_back({"freq_hz", ConfigValueType::I32, "1000", true});
+    descriptors_.push_back({"resolution_bits", ConfigValueType::I32, "12", true});
+    descriptors_.push_back({"gamma", ConfigValueType::F32, "2.2", true});
+    descriptors_.push_back({"fade_ms", ConfigValueType::I32, "500", true});
+    descriptors_.push_back({"active_low", ConfigValueType::Bool, "false", true});
+    descriptors_.push_back({"follow", ConfigValueType::String, nullptr, true, kFollowMaxLen});
+    descriptors_.push_back({"name", ConfigValueType::String, nullptr, true, kDisplayNameMaxLen});
+
+    // Non-persisted
+    descriptors_.push_back({"level", ConfigValueType::I32, nullptr, false});
+}
+
+const char* PWMConfig::name() const { return name_.c_str(); }
+
+const std::vector<ConfigurationValueDescriptor>& PWMConfig::descriptors() const { return descriptors_; }
+
+esp_err_t PWMConfig::apply_value(const char* key, const ConfigValue& value) {
+    if (key == nullptr) return ESP_ERR_INVALID_ARG;
+    const char* value_str = value.c_str();
+
+    if (strcmp(key, "gpio") == 0) {
+        gpio_set_ = value.is_set;
+        gpio_ = value.as_i32(-1);
+        if (gpio_ < 0) gpio_set_ = false;
+        return ESP_OK;
+    }
+    if (strcmp(key, "freq_hz") == 0) {
+        int32_t v = value.as_i32(1000);
+        if (v < 1 || v > 40000000) return ESP_ERR_INVALID_ARG;
+        freq_hz_ = static_cast<uint32_t>(v);
+        return ESP_OK;
+    }
+    if (strcmp(key, "resolution_bits") == 0) {
+        int32_t v = value.as_i32(12);
+        if (v < 1 || v > 14) return ESP_ERR_INVALID_ARG; // LEDC on ESP32-S3 tops out at 14 bits
+        resolution_bits_ = v;
+        return ESP_OK;
+    }
+    if (strcmp(key, "gamma") == 0) {
+        float v = value.as_f32(2.2f);
+        if (!(v >= 0.1f && v <= 5.0f)) return ESP_ERR_INVALID_ARG;
+        gamma_ = v;
+        return ESP_OK;
+    }
+    if (strcmp(key, "fade_ms") == 0) {
+        int32_t v = value.as_i32(500);
+        if (v < 0) v = 0;
+        if (v > 60000) v = 60000;
+        fade_ms_ = static_cast<uint32_t>(v);
+        return ESP_OK;
+    }
+    if (strcmp(key, "active_low") == 0) {
+        active_low_ = value.as_bool(false);
+        return ESP_OK;
+    }
+    if (strcmp(key, "follow") == 0) {
+        // Format: "io<1-8>.pin<1-8>" naming a switch pin on an IO expander
+        if (value_str == nullptr || *value_str == '\0') {
+            follow_.clear();
+            follow_module_ = 0;
+            follow_pin_ = 0;
+            return ESP_OK;
+        }
+        int module = 0, pin = 0;
+        if (sscanf(value_str, "io%d.pin%d", &module, &pin) != 2 || module < 1 || module > 8 || pin < 1 || pin > 8) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (!follow_.assign(value_str)) return ESP_ERR_INVALID_SIZE;
+        follow_module_ = module;
+        follow_pin_ = pin;
+        return ESP_OK;
+    }
+    if (strcmp(key, "name") == 0) {
+        return display_name_.assign(value_str) ? ESP_OK : ESP_ERR_INVALID_SIZE;
+    }
+
+    // Non-persisted
+    if (strcmp(key, "level") == 0) {
+        level_ = value.as_i32(0);
+        if (level_ < 0) level_ = 0;
+        if (level_ > 100) level_ = 100;
+        level_set_ = value.is_set;
+        return ESP_OK;
+    }
+
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t PWMConfig::get_value(const char* key, ConfigValue& out) const {
+    if (key == nullptr) return ESP_ERR_INVALID_ARG;
+    if (strcmp(key, "gpio") == 0) {
+        out = gpio_set_ ? ConfigValue::of_i32(gpio_) : ConfigValue::unset(ConfigValueType::I32);
+        return ESP_OK;
+    }
+    if (strcmp(key, "freq_hz") == 0) { out = ConfigValue::of_i32(static_cast<int32_t>(freq_hz_)); return ESP_OK; }
+    if (strcmp(key, "resolution_bits") == 0) { out = ConfigValue::of_i32(resolution_bits_); return ESP_OK; }
+    if (strcmp(key, "gamma") == 0) { out = ConfigValue::of_f32(gamma_); return ESP_OK; }
+    if (strcmp(key, "fade_ms") == 0) { out = ConfigValue::of_i32(static_cast<int32_t>(fade_ms_)); return ESP_OK; }
+    if (strcmp(key, "active_low") == 0) { out = ConfigValue::of_bool(active_low_); return ESP_OK; }
+    if (strcmp(key, "follow") == 0) {
+        out = has_follow() ? ConfigValue::of_string(follow_.c_str()) : ConfigValue::unset(ConfigValueType::String);
+        return ESP_OK;
+    }
+    if (strcmp(key, "name") == 0) {
+        out = has_display_name() ? ConfigValue::of_string(display_name_.c_str())
+                                 : ConfigValue::unset(ConfigValueType::String);
+        return ESP_OK;
+    }
+    if (strcmp(key, "level") == 0) {
+        out = level_set_ ? ConfigValue::of_i32(level_) : ConfigValue::unset(ConfigValueType::I32);
+        return ESP_OK;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t PWMConfig::to_json(cJSON* root_object) const {
+    if (!root_object) return ESP_ERR_INVALID_ARG;
+    // Only include module if an output pin is configured
+    if (!gpio_set_) return ESP_OK;
+    cJSON* obj = cJSON_CreateObject();
+    cJSON_AddNumberToObject(obj, "gpio", gpio_);
+    cJSON_AddNumberToObject(obj, "freq_hz", freq_hz_);
+    cJSON_AddNumberToObject(obj, "resolution_bits", resolution_bits_);
+    cJSON_AddNumberToObject(obj, "gamma", gamma_);
+    cJSON_AddNumberToObject(obj, "fade_ms", fade_ms_);
+    cJSON_AddBoolToObject(obj, "active_low", active_low_);
+    if (has_follow()) cJSON_AddStringToObject(obj, "follow", follow_.c_str());
+    if (has_display_name()) cJSON_AddStringToObject(obj, "name", display_name_.c_str());
+    if (level_set_) cJSON_AddNumberToObject(obj, "level", level_);
+    cJSON_AddItemToObject(root_object, name(), obj);
+    return ESP_OK;
+}
+
+} // namespace config
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ConfigurationModule.h"
+#include <vector>
+
+struct cJSON;
+
+namespace config {
+
+// MQTT configuration usage
+//
+// pwm1..pwm4 are dimmable outputs on native GPIOs, driven by the LEDC peripheral with hardware fades
+// (LEDC channel/timer N-1 for pwmN). IO expander (io1..io8) pins cannot be driven by LEDC; to dim a load
+// switched from an expander pin, wire the load to a native GPIO and link it with 'follow'.
+//
+// The device subscribes to: sensor/$mac/config/+/+
+// So to update a field publish to: sensor/$mac/config/<module>/<key>
+//
+// Examples (replace <HOST> and <mac> with your broker and device MAC string):
+// - Drive a MOSFET on GPIO 12 at 20 kHz (inaudible for fans):
+//   mosquitto_pub -h <HOST> -t "sensor/<mac>/config/pwm1/gpio" -m "12"
+//   mosquitto_pub -h <HOST> -t "sensor/<mac>/config/pwm1/freq_hz" -m "20000"
+//
+// - Set the level in percent (not persisted, like LED pattern knobs); fades take fade_ms for 0..100%:
+//   mosquitto_pub -h <HOST> -t "sensor/<mac>/config/pwm1/level" -m "40"
+//
+// - Follow a switch pin: on => level (100 when unset), off => 0. Local rules that override the switch
+//   (e.g. LOCK_KEYPAD) fade the output too:
+//   mosquitto_pub -h <HOST> -t "sensor/<mac>/config/pwm1/follow" -m "io1.pin3"
+//
+// - Linear output for fans (gamma 1.0); LED tape looks linear to the eye at the default 2.2:
+//   mosquitto_pub -h <HOST> -t "sensor/<mac>/config/pwm1/gamma" -m "1.0"
+//
+// resolution_bits is capped to what the frequency allows on the 80 MHz APB clock (14 bits at most).
+class PWMConfig : public ConfigurationModule {
+public:
+    static constexpr uint16_t kFollowMaxLen = 15;
+    static constexpr uint16_t kDisplayNameMaxLen = 31;
+
+    explicit PWMConfig(const char* instance_name);
+    ~PWMConfig() override = default;
+
+    // ConfigurationModule API
+    const char* name() const override;
+    const std::vector<ConfigurationValueDescriptor>& descriptors() const override;
+    esp_err_t apply_value(const char* key, const ConfigValue& value) override;
+    esp_err_t get_value(const char* key, ConfigValue& out) const override;
+    esp_err_t to_json(struct cJSON* root_object) const override;
+
+    // Accessors
+    bool has_gpio() const { return gpio_set_; }
+    int gpio() const { return gpio_; }
+    uint32_t freq_hz() const { return freq_hz_; }
+    int resolution_bits() const { return resolution_bits_; }
+    float gamma() const { return gamma_; }
+    uint32_t fade_ms() const { return fade_ms_; }
+    bool active_low() const { return active_low_; }
+    bool has_follow() const { return follow_module_ > 0; }
+    int follow_module() const { return follow_module_; } // io1..io8 => 1..8
+    int follow_pin() const { return follow_pin_; }       // 1..8
+    bool has_display_name() const { return !display_name_.empty(); }
+    const BoundedString<kDisplayNameMaxLen>& display_name() const { return display_name_; }
+    bool has_level() const { return level_set_; }
+    int level() const { return level_; } // 0..100 %
+
+private:
+    BoundedString<15> name_;
+    std::vector<ConfigurationValueDescriptor> descriptors_;
+
+    bool gpio_set_ = false;
+    int gpio_ = -1;
+    uint32_t freq_hz_ = 1000;
+    int resolution_bits_ = 12;
+    float gamma_ = 2.2f;
+    uint32_t fade_ms_ = 500;
+    bool active_low_ = false;
+    BoundedString<kFollowMaxLen> follow_;
+    int follow_module_ = 0;
+    int follow_pin_ = 0;
+    BoundedString<kDisplayNameMaxLen> display_name_;
+
+    // Non-persisted
+    bool level_set_ = false;
+    int level_ = 0;
+};
+
+} // namespace config
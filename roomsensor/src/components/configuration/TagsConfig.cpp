@@ -9,9 +9,9 @@ static const char* TAG = "TagsConfig";
 
 TagsConfig::TagsConfig() {
     // Persisted descriptors for user-provided values
-    descriptors_.push_back({"area", ConfigValueType::String, nullptr, true});
-    descriptors_.push_back({"room", ConfigValueType::String, nullptr, true});
-    descriptors_.push_back({"id", ConfigValueType::String, nullptr, true});
+    descriptors_.push_back({"area", ConfigValueType::String, nullptr, true, kTagMaxLen});
+    descriptors_.push_back({"room", ConfigValueType::String, nullptr, true, kTagMaxLen});
+    descriptors_.push_back({"id", ConfigValueType::String, nullptr, true, kTagMaxLen});
 
     compute_mac_and_defaults();
 }
@@ -38,21 +38,22 @@ void TagsConfig::compute_mac_and_defaults() {
     default_id_.assign(id_buf);
 }
 
-esp_err_t TagsConfig::apply_update(const char* key, const char* value_str) {
+esp_err_t TagsConfig::apply_value(const char* key, const ConfigValue& value) {
     if (key == nullptr) return ESP_ERR_INVALID_ARG;
+    const char* value_str = value.c_str();
 
     if (strcmp(key, "area") == 0) {
-        area_.assign(value_str ? value_str : "");
+        if (!area_.assign(value_str)) return ESP_ERR_INVALID_SIZE;
         area_set_ = (value_str != nullptr);
         return ESP_OK;
     }
     if (strcmp(key, "room") == 0) {
-        room_.assign(value_str ? value_str : "");
+        if (!room_.assign(value_str)) return ESP_ERR_INVALID_SIZE;
         room_set_ = (value_str != nullptr);
         return ESP_OK;
     }
     if (strcmp(key, "id") == 0) {
-        id_.assign(value_str ? value_str : "");
+        if (!id_.assign(value_str)) return ESP_ERR_INVALID_SIZE;
         id_set_ = (value_str != nullptr);
         return ESP_OK;
     }
@@ -60,6 +61,18 @@ esp_err_t TagsConfig::apply_update(const char* key, const char* value_str) {
     return ESP_ERR_NOT_FOUND;
 }
 
+esp_err_t TagsConfig::get_value(const char* key, ConfigValue& out) const {
+    if (key == nullptr) return ESP_ERR_INVALID_ARG;
+    const TagString* v = nullptr;
+    bool set = false;
+    if (strcmp(key, "area") == 0) { v = &area_; set = area_set_; }
+    else if (strcmp(key, "room") == 0) { v = &room_; set = room_set_; }
+    else if (strcmp(key, "id") == 0) { v = &id_; set = id_set_; }
+    else return ESP_ERR_NOT_FOUND;
+    out = set ? ConfigValue::of_string(v->c_str()) : ConfigValue::unset(ConfigValueType::String);
+    return ESP_OK;
+}
+
 esp_err_t TagsConfig::to_json(cJSON* root_object) const {
     if (!root_object) return ESP_ERR_INVALID_ARG;
 
@@ -1,7 +1,6 @@
 #pragma once
 
 #include "ConfigurationModule.h"
-#include <string>
 
 namespace config {
 
@@ -9,17 +8,22 @@ namespace config {
 // mac and sensor (room-id) are computed and never persisted.
 class TagsConfig : public ConfigurationModule {
 public:
+    // Tags become metric tag values (MAX_TAG_VALUE_LEN with its NUL)
+    static constexpr uint16_t kTagMaxLen = 63;
+    using TagString = BoundedString<kTagMaxLen>;
+
     TagsConfig();
 
     const char* name() const override;
     const std::vector<ConfigurationValueDescriptor>& descriptors() const override;
-    esp_err_t apply_update(const char* key, const char* value_str) override;
+    esp_err_t apply_value(const char* key, const ConfigValue& value) override;
+    esp_err_t get_value(const char* key, ConfigValue& out) const override;
     esp_err_t to_json(struct cJSON* root_object) const override;
 
     // Accessors (always available; may be default-derived)
-    const std::string& area() const { return area_.empty() ? default_area_ : area_; }
-    const std::string& room() const { return room_.empty() ? default_room_ : room_; }
-    const std::string& id() const { return id_.empty() ? default_id_ : id_; }
+    const TagString& area() const { return area_.empty() ? default_area_ : area_; }
+    const TagString& room() const { return room_.empty() ? default_room_ : room_; }
+    const TagString& id() const { return id_.empty() ? default_id_ : id_; }
 
     // Presence helpers (true if explicitly set via NVS/MQTT/console)
     bool has_area() const { return area_set_ && !area_.empty(); }
@@ -30,19 +34,19 @@ public:
 private:
     void compute_mac_and_defaults();
 
-    std::string area_;
-    std::string room_;
-    std::string id_;
+    TagString area_;
+    TagString room_;
+    TagString id_;
 
     bool area_set_ = false;
     bool room_set_ = false;
     bool id_set_ = false;
 
     // Derived/non-persisted values (internal only)
-    std::string mac_;
-    std::string default_area_ = "unknown";
-    std::string default_room_ = "unknown";
-    std::string default_id_; // derived from MAC
+    BoundedString<12> mac_;
+    TagString default_area_ = "unknown";
+    TagString default_room_ = "unknown";
+    TagString default_id_; // derived from MAC
 
     std::vector<ConfigurationValueDescriptor> descriptors_;
 };
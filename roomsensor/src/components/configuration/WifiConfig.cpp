@@ -8,13 +8,15 @@ namespace config {
 static const char* TAG = "WifiConfig";
 
 WifiConfig::WifiConfig() {
-    descriptors_.push_back({"ssid", ConfigValueType::String, nullptr, true});
-    descriptors_.push_back({"password", ConfigValueType::String, nullptr, true});
-    descriptors_.push_back({"mqtt_broker", ConfigValueType::String, nullptr, true});
-    descriptors_.push_back({"channel", ConfigValueType::String, nullptr, true});
+    descriptors_.push_back({"ssid", ConfigValueType::String, nullptr, true, kSsidMaxLen});
+    descriptors_.push_back({"password", ConfigValueType::String, nullptr, true, kPasswordMaxLen});
+    descriptors_.push_back({"mqtt_broker", ConfigValueType::String, nullptr, true, kBrokerMaxLen});
+    descriptors_.push_back({"channel", ConfigValueType::String, nullptr, true, kChannelMaxLen});
     // Default loglevel warn (2). Persisted to NVS and applied at runtime.
     descriptors_.push_back({"loglevel", ConfigValueType::I32, "2", true});
     descriptors_.push_back({"statusGPIO", ConfigValueType::I32, "-1", false});
+    descriptors_.push_back({"power_save", ConfigValueType::String, "AUTO", true, kPowerSaveMaxLen});
+    descriptors_.push_back({"max_tx_dbm", ConfigValueType::I32, "20", true});
 }
 
 const char* WifiConfig::name() const {
@@ -25,8 +27,9 @@ const std::vector<ConfigurationValueDescriptor>& WifiConfig::descriptors() const
     return descriptors_;
 }
 
-esp_err_t WifiConfig::apply_update(const char* key, const char* value_str) {
+esp_err_t WifiConfig::apply_value(const char* key, const ConfigValue& value) {
     if (key == nullptr) return ESP_ERR_INVALID_ARG;
+    const char* value_str = value.c_str();
 
     if (strcmp(key, "ssid") == 0) {
         // Allow unset (nullptr) to clear
@@ -72,20 +75,20 @@ esp_err_t WifiConfig::apply_update(const char* key, const char* value_str) {
         return ESP_OK;
     }
     if (strcmp(key, "mqtt_broker") == 0) {
-        mqtt_broker_.assign(value_str ? value_str : "");
+        if (!mqtt_broker_.assign(value_str)) return ESP_ERR_INVALID_SIZE;
         mqtt_broker_set_ = (value_str != nullptr);
         return ESP_OK;
     }
 
     if (strcmp(key, "channel") == 0) {
-        channel_.assign(value_str ? value_str : "");
+        if (!channel_.assign(value_str)) return ESP_ERR_INVALID_SIZE;
         channel_set_ = (value_str != nullptr);
         return ESP_OK;
     }
 
     if (strcmp(key, "loglevel") == 0) {
         // Accept numeric 0..5 mapping to esp_log_level_t
-        int lvl = value_str ? atoi(value_str) : 2;
+        int lvl = value.as_i32(2);
         if (lvl < (int)ESP_LOG_NONE) lvl = (int)ESP_LOG_NONE;
         if (lvl > (int)ESP_LOG_VERBOSE) lvl = (int)ESP_LOG_VERBOSE;
         loglevel_ = lvl;
@@ -93,18 +96,69 @@ esp_err_t WifiConfig::apply_update(const char* key, const char* value_str) {
     }
 
     if (strcmp(key, "statusGPIO") == 0) {
-        int gpio = value_str ? atoi(value_str) : -1;
+        int gpio = value.as_i32(-1);
         // You might want to add validation for the GPIO pin number here
         status_gpio_ = gpio;
         status_gpio_set_ = true;
         return ESP_OK;
     }
 
+    if (strcmp(key, "power_save") == 0) {
+        if (value_str == nullptr || *value_str == '\0') {
+            power_save_ = "AUTO";
+            return ESP_OK;
+        }
+        if (strcmp(value_str, "AUTO") != 0 && strcmp(value_str, "NONE") != 0 && strcmp(value_str, "MIN_MODEM") != 0 &&
+            strcmp(value_str, "MAX_MODEM") != 0) {
+            ESP_LOGE(TAG, "Invalid power_save '%s' (AUTO, NONE, MIN_MODEM, MAX_MODEM)", value_str);
+            return ESP_ERR_INVALID_ARG;
+        }
+        power_save_.assign(value_str);
+        return ESP_OK;
+    }
+
+    if (strcmp(key, "max_tx_dbm") == 0) {
+        // esp_wifi_set_max_tx_power accepts 2..20 dBm
+        int dbm = value.as_i32(20);
+        if (dbm < 2) dbm = 2;
+        if (dbm > 20) dbm = 20;
+        tx_power_max_dbm_ = dbm;
+        return ESP_OK;
+    }
 
     ESP_LOGW(TAG, "Unknown key '%s'", key);
     return ESP_ERR_NOT_FOUND;
 }
 
+esp_err_t WifiConfig::get_value(const char* key, ConfigValue& out) const {
+    if (key == nullptr) return ESP_ERR_INVALID_ARG;
+    auto str = [&out](const char* v, bool set) {
+        out = set ? ConfigValue::of_string(v) : ConfigValue::unset(ConfigValueType::String);
+        return ESP_OK;
+    };
+    if (strcmp(key, "ssid") == 0) return str(ssid_.c_str(), ssid_set_);
+    if (strcmp(key, "password") == 0) return str(password_.c_str(), password_set_);
+    if (strcmp(key, "mqtt_broker") == 0) return str(mqtt_broker_.c_str(), mqtt_broker_set_);
+    if (strcmp(key, "channel") == 0) return str(channel_.c_str(), channel_set_);
+    if (strcmp(key, "loglevel") == 0) {
+        out = ConfigValue::of_i32(loglevel_);
+        return ESP_OK;
+    }
+    if (strcmp(key, "power_save") == 0) {
+        out = ConfigValue::of_string(power_save_.c_str());
+        return ESP_OK;
+    }
+    if (strcmp(key, "max_tx_dbm") == 0) {
+        out = ConfigValue::of_i32(tx_power_max_dbm_);
+        return ESP_OK;
+    }
+    if (strcmp(key, "statusGPIO") == 0) {
+        out = status_gpio_set_ ? ConfigValue::of_i32(status_gpio_) : ConfigValue::unset(ConfigValueType::I32);
+        return ESP_OK;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
 esp_err_t WifiConfig::to_json(cJSON* root_object) const {
     if (!root_object) return ESP_ERR_INVALID_ARG;
 
@@ -133,6 +187,9 @@ esp_err_t WifiConfig::to_json(cJSON* root_object) const {
         cJSON_AddNumberToObject(wifi_obj, "statusGPIO", status_gpio_);
         added++;
     }
+    cJSON_AddStringToObject(wifi_obj, "power_save", power_save_.c_str());
+    cJSON_AddNumberToObject(wifi_obj, "max_tx_dbm", tx_power_max_dbm_);
+    added += 2;
     
     if (added > 0) {
         cJSON_AddItemToObject(root_object, name(), wifi_obj);
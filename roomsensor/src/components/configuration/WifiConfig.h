@@ -1,26 +1,38 @@
 #pragma once
 
 #include "ConfigurationModule.h"
-#include <string>
 
 namespace config {
 
 class WifiConfig : public ConfigurationModule {
 public:
+    // Longest accepted values; the descriptors and the storage below use the same limits
+    static constexpr uint16_t kSsidMaxLen = 32;
+    static constexpr uint16_t kPasswordMaxLen = 64;   // 8..63 chars, or a 64-hex PSK
+    static constexpr uint16_t kBrokerMaxLen = 127;    // mqtt(s)://host:port
+    static constexpr uint16_t kChannelMaxLen = 31;
+    static constexpr uint16_t kPowerSaveMaxLen = 15;
+
     WifiConfig();
 
     const char* name() const override;
     const std::vector<ConfigurationValueDescriptor>& descriptors() const override;
-    esp_err_t apply_update(const char* key, const char* value_str) override;
+    esp_err_t apply_value(const char* key, const ConfigValue& value) override;
+    esp_err_t get_value(const char* key, ConfigValue& out) const override;
     esp_err_t to_json(struct cJSON* root_object) const override;
 
     // Accessors
-    const std::string& ssid() const { return ssid_; }
-    const std::string& password() const { return password_; }
-    const std::string& mqtt_broker() const { return mqtt_broker_; }
-    const std::string& channel() const { return channel_; }
+    const BoundedString<kSsidMaxLen>& ssid() const { return ssid_; }
+    const BoundedString<kPasswordMaxLen>& password() const { return password_; }
+    const BoundedString<kBrokerMaxLen>& mqtt_broker() const { return mqtt_broker_; }
+    const BoundedString<kChannelMaxLen>& channel() const { return channel_; }
     int loglevel() const { return loglevel_; }
     int status_gpio() const { return status_gpio_; }
+    // Power save: "AUTO" (link manager decides), or pinned to "NONE", "MIN_MODEM", "MAX_MODEM"
+    const BoundedString<kPowerSaveMaxLen>& power_save() const { return power_save_; }
+    bool power_save_auto() const { return power_save_ == "AUTO"; }
+    // Upper bound for the adaptive TX power, in dBm
+    int tx_power_max_dbm() const { return tx_power_max_dbm_; }
 
     // Presence helpers (true only if loaded from NVS or set via update and non-empty)
     bool has_ssid() const { return ssid_set_ && !ssid_.empty(); }
@@ -30,10 +42,10 @@ public:
     bool has_status_gpio() const { return status_gpio_set_ && status_gpio_ != -1; }
 
 private:
-    std::string ssid_;
-    std::string password_;
-    std::string mqtt_broker_;
-    std::string channel_;
+    BoundedString<kSsidMaxLen> ssid_;
+    BoundedString<kPasswordMaxLen> password_;
+    BoundedString<kBrokerMaxLen> mqtt_broker_;
+    BoundedString<kChannelMaxLen> channel_;
     int status_gpio_ = -1;
     bool ssid_set_ = false;
     bool password_set_ = false;
@@ -41,6 +53,8 @@ private:
     bool channel_set_ = false;
     bool status_gpio_set_ = false;
     int loglevel_ = 2; // default warn (ESP_LOG_WARN)
+    BoundedString<kPowerSaveMaxLen> power_save_ = "AUTO";
+    int tx_power_max_dbm_ = 20;
     std::vector<ConfigurationValueDescriptor> descriptors_;
 };
 
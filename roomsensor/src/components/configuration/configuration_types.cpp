@@ -0,0 +1,150 @@
+#include "configuration_types.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+namespace config {
+
+int64_t ConfigValue::as_i64(int64_t fallback) const {
+    if (!is_set) return fallback;
+    switch (type) {
+        case ConfigValueType::I32: return i32;
+        case ConfigValueType::U32: return u32;
+        case ConfigValueType::I64: return i64;
+        case ConfigValueType::Bool: return b ? 1 : 0;
+        case ConfigValueType::F32: return static_cast<int64_t>(f32);
+        case ConfigValueType::String:
+        case ConfigValueType::Blob:
+            break;
+    }
+    return fallback;
+}
+
+int32_t ConfigValue::as_i32(int32_t fallback) const {
+    int64_t v = as_i64(fallback);
+    if (v < INT32_MIN) return INT32_MIN;
+    if (v > INT32_MAX) return INT32_MAX;
+    return static_cast<int32_t>(v);
+}
+
+bool ConfigValue::as_bool(bool fallback) const {
+    if (!is_set) return fallback;
+    if (type == ConfigValueType::Bool) return b;
+    if (type == ConfigValueType::F32) return f32 != 0.0f;
+    if (type == ConfigValueType::String || type == ConfigValueType::Blob) return fallback;
+    return as_i64(0) != 0;
+}
+
+float ConfigValue::as_f32(float fallback) const {
+    if (!is_set) return fallback;
+    if (type == ConfigValueType::F32) return f32;
+    if (type == ConfigValueType::String || type == ConfigValueType::Blob) return fallback;
+    return static_cast<float>(as_i64(0));
+}
+
+static bool parse_bool_text(const char* s, bool& out) {
+    if (strcasecmp(s, "1") == 0 || strcasecmp(s, "true") == 0 || strcasecmp(s, "on") == 0 || strcasecmp(s, "yes") == 0) {
+        out = true;
+        return true;
+    }
+    if (strcasecmp(s, "0") == 0 || strcasecmp(s, "false") == 0 || strcasecmp(s, "off") == 0 || strcasecmp(s, "no") == 0) {
+        out = false;
+        return true;
+    }
+    return false;
+}
+
+static bool only_space(const char* p) {
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') ++p;
+    return *p == '\0';
+}
+
+// Integer text; a decimal such as "12.0" (what JSON tooling tends to send) truncates toward zero
+static bool parse_int_text(const char* s, bool is_unsigned, long long lo, long long hi, long long& out) {
+    if (is_unsigned) {
+        const char* p = s;
+        while (*p == ' ' || *p == '\t') ++p;
+        if (*p == '-') return false;
+    }
+    errno = 0;
+    char* end = nullptr;
+    long long v = strtoll(s, &end, 10);
+    if (end == s) return false;
+    if (!only_space(end)) {
+        if (*end != '.' && *end != 'e' && *end != 'E') return false;
+        double d = strtod(s, &end);
+        if (!only_space(end) || !double_fits(d, lo, hi)) return false;
+        v = static_cast<long long>(d);
+    }
+    if (errno == ERANGE || v < lo || v > hi) return false;
+    out = v;
+    return true;
+}
+
+esp_err_t ConfigValue::parse(ConfigValueType type, const char* text, ConfigValue& out) {
+    out = unset(type);
+    if (text == nullptr) return ESP_OK;
+    if (type == ConfigValueType::String) {
+        out = of_string(text);
+        return ESP_OK;
+    }
+    if (text[0] == '\0') return ESP_OK;
+
+    long long v = 0;
+    switch (type) {
+        case ConfigValueType::I32:
+            if (!parse_int_text(text, false, INT32_MIN, INT32_MAX, v)) return ESP_ERR_INVALID_ARG;
+            out = of_i32(static_cast<int32_t>(v));
+            return ESP_OK;
+        case ConfigValueType::U32:
+            if (!parse_int_text(text, true, 0, UINT32_MAX, v)) return ESP_ERR_INVALID_ARG;
+            out = of_u32(static_cast<uint32_t>(v));
+            return ESP_OK;
+        case ConfigValueType::I64:
+            if (!parse_int_text(text, false, INT64_MIN, INT64_MAX, v)) return ESP_ERR_INVALID_ARG;
+            out = of_i64(static_cast<int64_t>(v));
+            return ESP_OK;
+        case ConfigValueType::Bool: {
+            bool bv = false;
+            if (!parse_bool_text(text, bv)) return ESP_ERR_INVALID_ARG;
+            out = of_bool(bv);
+            return ESP_OK;
+        }
+        case ConfigValueType::F32: {
+            char* end = nullptr;
+            float f = strtof(text, &end);
+            if (end == text || !only_space(end)) return ESP_ERR_INVALID_ARG;
+            out = of_f32(f);
+            return ESP_OK;
+        }
+        case ConfigValueType::Blob:
+            // Text payloads for blob keys are stored verbatim (without the terminator)
+            out = of_blob(text, strlen(text));
+            return ESP_OK;
+        case ConfigValueType::String:
+            break;
+    }
+    return ESP_ERR_INVALID_ARG;
+}
+
+const char* ConfigValue::format(char* buf, size_t n) const {
+    if (!buf || n == 0) return "";
+    if (!is_set) {
+        snprintf(buf, n, "(unset)");
+        return buf;
+    }
+    switch (type) {
+        case ConfigValueType::String: snprintf(buf, n, "%s", static_cast<const char*>(data)); break;
+        case ConfigValueType::I32: snprintf(buf, n, "%" PRId32, i32); break;
+        case ConfigValueType::U32: snprintf(buf, n, "%" PRIu32, u32); break;
+        case ConfigValueType::I64: snprintf(buf, n, "%" PRId64, i64); break;
+        case ConfigValueType::Bool: snprintf(buf, n, "%s", b ? "true" : "false"); break;
+        case ConfigValueType::F32: snprintf(buf, n, "%g", (double)f32); break;
+        case ConfigValueType::Blob: snprintf(buf, n, "(%u byte blob)", (unsigned)size); break;
+    }
+    return buf;
+}
+
+} // namespace config
@@ -3,6 +3,7 @@
 #include "esp_err.h"
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 #include <string>
 #include <vector>
 
@@ -24,12 +25,71 @@ enum class ConfigValueType : uint8_t {
 
 // Descriptor for a single configuration value
 struct ConfigurationValueDescriptor {
-    const char* name;                 // Key name (e.g., "ssid")
+    const char* name;                 // Key name (e.g., "ssid"); at most 15 characters, the NVS key limit
     ConfigValueType type;             // Value type
     const char* default_value;        // Optional default as string (nullptr if none)
     bool persisted;                   // True if stored in NVS
+    uint16_t max_len = 0;             // String/Blob: longest accepted value in bytes; 0 => not bounded
 };
 
+// Typed configuration value exchanged between the edges (NVS, MQTT/console text, JSON reset) and the
+// modules. Edges convert to the key's descriptor type once; modules read the typed field directly.
+// String and Blob payloads are borrowed from the caller and only valid for the duration of the call.
+// An unset value clears the key (what a null value_str meant for apply_update).
+struct ConfigValue {
+    ConfigValueType type = ConfigValueType::String;
+    bool is_set = false;
+    union {
+        int32_t i32;
+        uint32_t u32;
+        int64_t i64;
+        bool b;
+        float f32;
+    };
+    const void* data = nullptr; // String (NUL-terminated) or Blob bytes
+    size_t size = 0;            // String length without the NUL, or Blob length
+
+    ConfigValue() : i64(0) {}
+
+    static ConfigValue unset(ConfigValueType t) { ConfigValue v; v.type = t; return v; }
+    static ConfigValue of_string(const char* s) {
+        ConfigValue v;
+        v.type = ConfigValueType::String;
+        if (s) { v.is_set = true; v.data = s; v.size = strlen(s); }
+        return v;
+    }
+    static ConfigValue of_blob(const void* p, size_t n) {
+        ConfigValue v; v.type = ConfigValueType::Blob; v.is_set = true; v.data = p; v.size = n; return v;
+    }
+    static ConfigValue of_i32(int32_t x) { ConfigValue v; v.type = ConfigValueType::I32; v.is_set = true; v.i32 = x; return v; }
+    static ConfigValue of_u32(uint32_t x) { ConfigValue v; v.type = ConfigValueType::U32; v.is_set = true; v.u32 = x; return v; }
+    static ConfigValue of_i64(int64_t x) { ConfigValue v; v.type = ConfigValueType::I64; v.is_set = true; v.i64 = x; return v; }
+    static ConfigValue of_bool(bool x) { ConfigValue v; v.type = ConfigValueType::Bool; v.is_set = true; v.b = x; return v; }
+    static ConfigValue of_f32(float x) { ConfigValue v; v.type = ConfigValueType::F32; v.is_set = true; v.f32 = x; return v; }
+
+    // String payload, or nullptr when unset or not a string
+    const char* c_str() const {
+        return (is_set && type == ConfigValueType::String) ? static_cast<const char*>(data) : nullptr;
+    }
+    // Numeric reads convert between the numeric types and Bool; 'fallback' when unset, String or Blob
+    int32_t as_i32(int32_t fallback) const;
+    int64_t as_i64(int64_t fallback) const;
+    bool as_bool(bool fallback) const;
+    float as_f32(float fallback) const;
+
+    // Text edge: parse 'text' as 'type'. nullptr is unset; so is "" for non-string types. Returns
+    // ESP_ERR_INVALID_ARG for malformed numbers/booleans. String results borrow 'text'.
+    static esp_err_t parse(ConfigValueType type, const char* text, ConfigValue& out);
+    // Text edge: render into buf (logs, string consumers). Unset renders as "(unset)".
+    const char* format(char* buf, size_t n) const;
+};
+
+// True if d is in [lo, hi + 1), so truncating it to an integer in [lo, hi] is defined. The upper bound is
+// exclusive: (double)INT64_MAX rounds up to 2^63, which 'd > (double)hi' would let through. NaN never fits.
+inline bool double_fits(double d, long long lo, long long hi) {
+    return d >= (double)lo && d < (double)hi + 1.0;
+}
+
 } // namespace config
 
 
@@ -0,0 +1,147 @@
+#include "flash_window.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/task.h"
+#include <atomic>
+
+// Lives in the configuration component because it is the lowest layer shared by every flash writer
+// (configuration, LED boot record, console, main) and by the LED manager.
+
+static constexpr EventBits_t kOpenBit = BIT0;
+static constexpr EventBits_t kParkedBit = BIT1; // LED task is parked for a pause
+static constexpr EventBits_t kResumeBit = BIT2; // last pause ended
+// No window opened for this long => no LED output to protect
+static constexpr uint64_t kIdleAfterUs = 200 * 1000;
+
+static StaticEventGroup_t s_group_storage;
+static std::atomic<EventGroupHandle_t> s_group{nullptr};
+static std::atomic<TaskHandle_t> s_led_task{nullptr};
+static std::atomic<uint64_t> s_open_until_us{0};
+static std::atomic<uint64_t> s_last_open_us{0};
+static std::atomic<uint32_t> s_active_writers{0};
+static std::atomic<uint32_t> s_pausers{0};
+
+static std::atomic<uint32_t> s_writes{0};
+static std::atomic<uint32_t> s_deferred{0};
+static std::atomic<uint32_t> s_timed_out{0};
+static std::atomic<uint32_t> s_max_wait_ms{0};
+static std::atomic<uint32_t> s_overlaps{0};
+static std::atomic<uint32_t> s_pauses{0};
+static std::atomic<uint32_t> s_max_pause_ms{0};
+
+static void store_max(std::atomic<uint32_t>& slot, uint32_t v) {
+    uint32_t prev = slot.load();
+    while (v > prev && !slot.compare_exchange_weak(prev, v)) {}
+}
+
+uint32_t flash_window_begin(uint32_t max_defer_ms) {
+    s_writes.fetch_add(1);
+    EventGroupHandle_t group = s_group.load();
+    if (!group || xTaskGetCurrentTaskHandle() == s_led_task.load()) {
+        s_active_writers.fetch_add(1);
+        return 0;
+    }
+
+    const uint64_t start = esp_timer_get_time();
+    const uint64_t deadline = start + static_cast<uint64_t>(max_defer_ms) * 1000;
+    bool waited = false;
+    while (true) {
+        const uint64_t now = esp_timer_get_time();
+        if (now - s_last_open_us.load() > kIdleAfterUs) break;
+        const EventBits_t bits = xEventGroupGetBits(group);
+        if (bits & kParkedBit) break; // no frame work until the pause ends
+        const bool open = (bits & kOpenBit) != 0;
+        if (open && now < s_open_until_us.load()) break;
+        if (now >= deadline) {
+            s_timed_out.fetch_add(1);
+            break;
+        }
+        waited = true;
+        if (open) {
+            // Gap used up but the LED task has not closed it yet; it is about to
+            vTaskDelay(1);
+            continue;
+        }
+        TickType_t ticks = pdMS_TO_TICKS((deadline - now + 999) / 1000);
+        if (ticks == 0) ticks = 1;
+        xEventGroupWaitBits(group, kOpenBit, pdFALSE, pdFALSE, ticks);
+    }
+
+    const uint32_t waited_ms = static_cast<uint32_t>((esp_timer_get_time() - start) / 1000);
+    if (waited) s_deferred.fetch_add(1);
+    store_max(s_max_wait_ms, waited_ms);
+    s_active_writers.fetch_add(1);
+    return waited_ms;
+}
+
+void flash_window_end(void) {
+    uint32_t cur = s_active_writers.load();
+    while (cur > 0 && !s_active_writers.compare_exchange_weak(cur, cur - 1)) {}
+}
+
+uint32_t flash_window_pause_begin(uint32_t max_wait_ms) {
+    s_pauses.fetch_add(1);
+    s_pausers.fetch_add(1);
+    EventGroupHandle_t group = s_group.load();
+    if (!group) return 0;
+    const uint64_t start = esp_timer_get_time();
+    // The LED task parks when its next tick starts; without LED output there is nothing to wait for
+    if (start - s_last_open_us.load() <= kIdleAfterUs) {
+        TickType_t ticks = pdMS_TO_TICKS(max_wait_ms);
+        if (ticks == 0) ticks = 1;
+        if (!(xEventGroupWaitBits(group, kParkedBit, pdFALSE, pdFALSE, ticks) & kParkedBit)) s_timed_out.fetch_add(1);
+    }
+    return static_cast<uint32_t>((esp_timer_get_time() - start) / 1000);
+}
+
+void flash_window_pause_end(void) {
+    uint32_t cur = s_pausers.load();
+    while (cur > 0 && !s_pausers.compare_exchange_weak(cur, cur - 1)) {}
+    EventGroupHandle_t group = s_group.load();
+    if (cur == 1 && group) xEventGroupSetBits(group, kResumeBit);
+}
+
+void flash_window_open(uint32_t gap_us) {
+    EventGroupHandle_t group = s_group.load();
+    if (!group) {
+        // Only the LED update task opens the window, so creation cannot race
+        s_led_task.store(xTaskGetCurrentTaskHandle());
+        group = xEventGroupCreateStatic(&s_group_storage);
+        s_group.store(group);
+    }
+    const uint64_t now = esp_timer_get_time();
+    s_last_open_us.store(now);
+    s_open_until_us.store(now + gap_us);
+    xEventGroupSetBits(group, kOpenBit);
+}
+
+bool flash_window_close(void) {
+    EventGroupHandle_t group = s_group.load();
+    if (!group) return false;
+    xEventGroupClearBits(group, kOpenBit);
+    if (s_active_writers.load() > 0) s_overlaps.fetch_add(1);
+    if (s_pausers.load() == 0) return false;
+
+    // Strips hold the last frame; RMT is idle. A resume bit left over from an earlier pause only costs
+    // one extra pass through the loop.
+    const uint64_t start = esp_timer_get_time();
+    xEventGroupSetBits(group, kParkedBit);
+    while (s_pausers.load() > 0) {
+        xEventGroupWaitBits(group, kResumeBit, pdTRUE, pdFALSE, pdMS_TO_TICKS(1000));
+    }
+    xEventGroupClearBits(group, kParkedBit);
+    store_max(s_max_pause_ms, static_cast<uint32_t>((esp_timer_get_time() - start) / 1000));
+    return true;
+}
+
+void flash_window_take_stats(flash_window_stats_t* out) {
+    if (!out) return;
+    out->writes = s_writes.exchange(0);
+    out->deferred = s_deferred.exchange(0);
+    out->timed_out = s_timed_out.exchange(0);
+    out->max_wait_ms = s_max_wait_ms.exchange(0);
+    out->overlaps = s_overlaps.exchange(0);
+    out->pauses = s_pauses.exchange(0);
+    out->max_pause_ms = s_max_pause_ms.exchange(0);
+}
@@ -0,0 +1,112 @@
+#include "instrumented_lock.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <cstdlib>
+
+struct instrumented_lock {
+    SemaphoreHandle_t mutex;
+    const char* name;
+    uint32_t slow_wait_us;
+    uint64_t acquired_us; // written by the holder
+    lock_stats_t stats;   // s_stats_lock
+    instrumented_lock* next;
+};
+
+// Guards every lock's stats and the registry; held for a few hundred cycles at most
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static instrumented_lock* s_locks = nullptr;
+
+instrumented_lock_t* instrumented_lock_create(const char* name, uint32_t slow_wait_us) {
+    instrumented_lock* lock = static_cast<instrumented_lock*>(calloc(1, sizeof(instrumented_lock)));
+    if (!lock) return nullptr;
+    lock->mutex = xSemaphoreCreateMutex();
+    if (!lock->mutex) {
+        free(lock);
+        return nullptr;
+    }
+    lock->name = name;
+    lock->slow_wait_us = slow_wait_us;
+    taskENTER_CRITICAL(&s_stats_lock);
+    lock->next = s_locks;
+    s_locks = lock;
+    taskEXIT_CRITICAL(&s_stats_lock);
+    return lock;
+}
+
+void instrumented_lock_delete(instrumented_lock_t* lock) {
+    if (!lock) return;
+    taskENTER_CRITICAL(&s_stats_lock);
+    for (instrumented_lock** p = &s_locks; *p; p = &(*p)->next) {
+        if (*p == lock) {
+            *p = lock->next;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL(&s_stats_lock);
+    vSemaphoreDelete(lock->mutex);
+    free(lock);
+}
+
+bool instrumented_lock_take(instrumented_lock_t* lock, TickType_t timeout) {
+    if (xSemaphoreTake(lock->mutex, 0) == pdTRUE) {
+        const uint64_t now = esp_timer_get_time();
+        lock->acquired_us = now;
+        taskENTER_CRITICAL(&s_stats_lock);
+        lock_stats_on_acquired(&lock->stats, 0, nullptr, lock->slow_wait_us, now);
+        taskEXIT_CRITICAL(&s_stats_lock);
+        return true;
+    }
+
+    // Contended: note the holder before blocking, while its priority is still its own
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    TaskHandle_t owner = xSemaphoreGetMutexHolder(lock->mutex);
+    lock_contention_t who = {pcTaskGetName(self), owner ? pcTaskGetName(owner) : "?",
+                             static_cast<uint8_t>(uxTaskPriorityGet(self)),
+                             static_cast<uint8_t>(owner ? uxTaskPriorityGet(owner) : 0)};
+    char owner_name[LOCK_STATS_NAME_LEN];
+    lock_stats_copy_name(owner_name, who.owner); // the owner may rename or exit while we wait
+    who.owner = owner_name;
+
+    const uint64_t start = esp_timer_get_time();
+    const bool ok = xSemaphoreTake(lock->mutex, timeout) == pdTRUE;
+    const uint64_t now = esp_timer_get_time();
+    const uint64_t waited = now - start;
+    if (ok) lock->acquired_us = now;
+    taskENTER_CRITICAL(&s_stats_lock);
+    if (ok) {
+        lock_stats_on_acquired(&lock->stats, waited > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(waited), &who,
+                               lock->slow_wait_us, now);
+    } else {
+        lock_stats_on_timeout(&lock->stats, &who);
+    }
+    taskEXIT_CRITICAL(&s_stats_lock);
+    return ok;
+}
+
+void instrumented_lock_give(instrumented_lock_t* lock) {
+    const uint64_t held = esp_timer_get_time() - lock->acquired_us;
+    taskENTER_CRITICAL(&s_stats_lock);
+    lock_stats_on_release(&lock->stats, held > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(held));
+    taskEXIT_CRITICAL(&s_stats_lock);
+    xSemaphoreGive(lock->mutex);
+}
+
+void instrumented_lock_take_stats(instrumented_lock_stats_cb cb, void* ctx) {
+    if (!cb) return;
+    // Copy out under the spinlock, call back outside it. Locks are created at init and not deleted in
+    // normal operation, so walking the list between copies is safe.
+    taskENTER_CRITICAL(&s_stats_lock);
+    instrumented_lock* lock = s_locks;
+    taskEXIT_CRITICAL(&s_stats_lock);
+    while (lock) {
+        lock_stats_t window;
+        taskENTER_CRITICAL(&s_stats_lock);
+        window = lock->stats;
+        memset(&lock->stats, 0, sizeof(lock->stats));
+        instrumented_lock* next = lock->next;
+        taskEXIT_CRITICAL(&s_stats_lock);
+        cb(lock->name, &window, ctx);
+        lock = next;
+    }
+}
@@ -5,6 +5,9 @@
 #include <string>
 #include "ConfigurationManager.h"
 #include "A2DConfig.h"
+#include "AlarmConfig.h"
+#include "rail_current.h"
+#include "esp_timer.h"
 
 static const char *TAG = "ADS1115Sensor";
 
@@ -266,6 +269,11 @@ void ADS1115Sensor::poll() {
             // ppm = I / S
             float ppm = i_co / s_amps_per_ppm;
 
+            // Alarm at sample time, ahead of the routine metric (alarms.h)
+            const config::AlarmConfig& alarm_cfg = config::GetConfigurationManager().alarm();
+            _co_alarms[ch].update("co", ppm, alarm_cfg.has_co_ppm(), alarm_cfg.co_ppm(), alarm_cfg.hysteresis_pct(),
+                                  _channel_tags[ch]);
+
             // Report CO ppm as separate metric
             report_metric("co_ppm", ppm, _channel_tags[ch]);
         }
@@ -281,6 +289,8 @@ void ADS1115Sensor::poll() {
 				float i_is_amps = volts / sense_resistance_ohms;
 				float i_load_amps = i_is_amps * kILIS;
 				report_metric("amps", i_load_amps, _channel_tags[ch]);
+				// Make the reading available to the LED current limiter on the same rail
+				rail_current::publish(index(), ch + 1, i_load_amps, (uint64_t)esp_timer_get_time());
 			}
 		}
 	}
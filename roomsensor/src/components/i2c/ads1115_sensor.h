@@ -3,6 +3,7 @@
 #include "i2c_sensor.h"
 #include "esp_err.h"
 #include "communication.h"
+#include "alarms.h"
 #include <string>
 
 /**
@@ -62,4 +63,5 @@ private:
 	uint8_t _i2c_addr;
 	bool _initialized;
 	TagCollection* _channel_tags[4];
+	alarms::ThresholdAlarm _co_alarms[4]; // "co" alarm per CO_SPEC channel
 };
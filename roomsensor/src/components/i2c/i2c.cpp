@@ -17,6 +17,7 @@
 #include "freertos/task.h"
 #include "esp_timer.h"
 #include <vector>
+#include <cstring>
 
 static const char* TAG = "I2C";
 
@@ -55,6 +56,60 @@ static TaskHandle_t s_polling_task_handle = nullptr;
 // Create a semaphore to signal interrupt events
 static SemaphoreHandle_t s_sensorInterruptSemaphore = nullptr;
 
+// Topology found by the boot scan. After that only these addresses are probed: a presence check is
+// one address byte per known device instead of a sweep of all 112 addresses, and the full retained
+// document is republished only when the digest of what it would contain changes.
+static const uint16_t TOPOLOGY_PROBE_TIMEOUT_MS = 50;
+static const uint32_t TOPOLOGY_CHECK_INTERVAL_MS = 60 * 1000;       // presence checks
+static const uint32_t TOPOLOGY_DIGEST_INTERVAL_MS = 15 * 60 * 1000; // digest heartbeat
+static bool s_claimed[s_sensor_count] = {};  // driver chosen for this entry by the boot scan
+static bool s_present[s_sensor_count] = {};  // ...and its address answered the last probe
+static uint8_t s_unrecognized_addrs[32];
+static int s_unrecognized_count = 0;
+static uint8_t s_unrecognized_seen[sizeof(s_unrecognized_addrs)]; // subset that answered last probe
+static int s_unrecognized_seen_count = 0;
+static uint32_t s_topology_digest = 0;
+static bool s_topology_published = false;
+
+static uint32_t current_topology_digest() {
+    return i2c_topology_digest((const I2CSensor* const*)s_sensors, s_present, s_sensor_count,
+                               s_unrecognized_seen, s_unrecognized_seen_count);
+}
+
+static void publish_topology_if_changed() {
+    uint32_t digest = current_topology_digest();
+    if (s_topology_published && digest == s_topology_digest) return;
+    s_topology_digest = digest;
+    s_topology_published = true;
+    publish_i2c_topology((const I2CSensor* const*)s_sensors,
+                         s_present,
+                         s_sensor_count,
+                         s_unrecognized_seen,
+                         s_unrecognized_seen_count);
+}
+
+// Probe the addresses found at boot. Devices that disappear (unplugged, bus fault) or come back, and
+// drivers that lost their initialized state, change the digest. New addresses are picked up by the
+// next boot scan.
+static void check_topology_presence() {
+    for (int i = 0; i < s_sensor_count; i++) {
+        if (!s_claimed[i]) continue;
+        bool present = (i2c_master_probe(s_i2c_bus, s_sensors[i]->addr(), TOPOLOGY_PROBE_TIMEOUT_MS) == ESP_OK);
+        if (present != s_present[i]) {
+            ESP_LOGW(TAG, "%s at 0x%02X %s", s_sensors[i]->name().c_str(), s_sensors[i]->addr(),
+                     present ? "is back on the bus" : "stopped answering");
+            s_present[i] = present;
+        }
+    }
+    s_unrecognized_seen_count = 0;
+    for (int i = 0; i < s_unrecognized_count; i++) {
+        if (i2c_master_probe(s_i2c_bus, s_unrecognized_addrs[i], TOPOLOGY_PROBE_TIMEOUT_MS) == ESP_OK) {
+            s_unrecognized_seen[s_unrecognized_seen_count++] = s_unrecognized_addrs[i];
+        }
+    }
+    publish_topology_if_changed();
+}
+
 // Sensor polling task function
 static void sensor_polling_task(void* pvParameters) {
     const TickType_t polling_interval = pdMS_TO_TICKS(100); // Poll every 100ms
@@ -65,6 +120,8 @@ static void sensor_polling_task(void* pvParameters) {
 
     // Track last poll time per sensor (ms)
     std::vector<uint32_t> last_polled_ms(s_sensor_count, 0);
+    uint32_t last_topology_check_ms = esp_timer_get_time() / 1000;
+    uint32_t last_digest_ms = last_topology_check_ms;
 
     while (true) {
         // Block until signaled or the short polling interval expires
@@ -119,6 +176,15 @@ static void sensor_polling_task(void* pvParameters) {
                 last_polled_ms[i] = current_time;
             }
         }
+
+        if (current_time - last_topology_check_ms >= TOPOLOGY_CHECK_INTERVAL_MS) {
+            check_topology_presence();
+            last_topology_check_ms = current_time;
+        }
+        if (current_time - last_digest_ms >= TOPOLOGY_DIGEST_INTERVAL_MS) {
+            publish_i2c_topology_digest(s_topology_digest);
+            last_digest_ms = current_time;
+        }
     }
 }
 
@@ -140,21 +206,13 @@ bool init_i2c() {
     }
 
     // Scan the I2C bus once and try to initialize any recognized sensors
-    const uint16_t probe_timeout_ms = 50;
     int found_count = 0;
     int initialized_count = 0;
-    // Collect unrecognized device addresses
-    uint8_t unrecognized_addrs[32];
-    int unrecognized_count = 0;
 
     ESP_LOGI(TAG, "Scanning I2C bus for devices...");
 
-    // Track which entries in s_sensors were recognized (address matched on bus)
-    bool recognized_flags[s_sensor_count];
-    for (int i = 0; i < s_sensor_count; ++i) recognized_flags[i] = false;
-
     for (uint8_t addr = 0x08; addr < 0x78; addr++) {
-        esp_err_t ret = i2c_master_probe(s_i2c_bus, addr, probe_timeout_ms);
+        esp_err_t ret = i2c_master_probe(s_i2c_bus, addr, TOPOLOGY_PROBE_TIMEOUT_MS);
 
         if (ret == ESP_OK) {
             found_count++;
@@ -218,7 +276,8 @@ bool init_i2c() {
                 }
 
                 if (chosen_index >= 0) {
-                    recognized_flags[chosen_index] = true;
+                    s_claimed[chosen_index] = true;
+                    s_present[chosen_index] = true;
                     ESP_LOGI(TAG, "Found device at address 0x%02X: %s", addr, s_sensors[chosen_index]->name().c_str());
 
                     if (!s_sensors[chosen_index]->isInitialized()) {
@@ -238,8 +297,8 @@ bool init_i2c() {
 
             if (!recognized) {
                 ESP_LOGW(TAG, "Found unrecognized device at address 0x%02X", addr);
-                if (unrecognized_count < (int)(sizeof(unrecognized_addrs)/sizeof(unrecognized_addrs[0]))) {
-                    unrecognized_addrs[unrecognized_count++] = addr;
+                if (s_unrecognized_count < (int)sizeof(s_unrecognized_addrs)) {
+                    s_unrecognized_addrs[s_unrecognized_count++] = addr;
                 }
             }
         }
@@ -249,11 +308,9 @@ bool init_i2c() {
              found_count, initialized_count);
 
     // Publish I2C topology retained message
-    publish_i2c_topology((const I2CSensor* const*)s_sensors,
-                         recognized_flags,
-                         s_sensor_count,
-                         unrecognized_addrs,
-                         unrecognized_count);
+    memcpy(s_unrecognized_seen, s_unrecognized_addrs, s_unrecognized_count);
+    s_unrecognized_seen_count = s_unrecognized_count;
+    publish_topology_if_changed();
 
     // Start the sensor polling task if we have at least one initialized sensor
     if (initialized_count > 0) {
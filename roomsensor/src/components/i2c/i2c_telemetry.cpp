@@ -6,6 +6,7 @@
 #include "system_state.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "esp_rom_crc.h"
 #include <cstring>
 
 extern const uint8_t* get_device_mac(void);
@@ -17,7 +18,10 @@ static void format_mac_nosep_lower(char* out, size_t out_len) {
 }
 
 // Deferred topology publisher
-static TaskHandle_t s_topology_task = nullptr;
+// Topology updates can come from init and from the polling task's presence checks, so the
+// pending document is handed over under a lock.
+static portMUX_TYPE s_pending_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool s_topology_task_running = false;
 static char* s_pending_json = nullptr;
 static char s_pending_topic[96] = {0};
 
@@ -25,19 +29,67 @@ static void i2c_topology_publisher_task(void* arg) {
 	(void)arg;
 	const TickType_t wait_ticks = pdMS_TO_TICKS(1000);
 	for (;;) {
-		if (get_system_state() == FULLY_CONNECTED && s_pending_json != nullptr && s_pending_topic[0] != '\0') {
-			publish_to_topic(s_pending_topic, s_pending_json, 1, 1);
-			cJSON_free(s_pending_json);
+		if (get_system_state() == FULLY_CONNECTED) {
+			char topic[sizeof(s_pending_topic)];
+			taskENTER_CRITICAL(&s_pending_lock);
+			char* json = s_pending_json;
 			s_pending_json = nullptr;
+			memcpy(topic, s_pending_topic, sizeof(topic));
 			s_pending_topic[0] = '\0';
-			TaskHandle_t self = s_topology_task;
-			s_topology_task = nullptr;
-			vTaskDelete(self);
+			s_topology_task_running = false;
+			taskEXIT_CRITICAL(&s_pending_lock);
+			if (json != nullptr && topic[0] != '\0') {
+				publish_to_topic(topic, json, 1, 1);
+			}
+			cJSON_free(json);
+			vTaskDelete(nullptr);
 		}
 		vTaskDelay(wait_ticks);
 	}
 }
 
+static uint32_t crc_str(uint32_t crc, const char* s) {
+	// Length first so adjacent fields cannot run into each other
+	uint8_t len = (uint8_t)strnlen(s, 255);
+	crc = esp_rom_crc32_le(crc, &len, 1);
+	return esp_rom_crc32_le(crc, (const uint8_t*)s, len);
+}
+
+uint32_t i2c_topology_digest(const I2CSensor* const* sensors,
+                             const bool* recognized,
+                             int num_sensors,
+                             const uint8_t* unrecognized_addrs,
+                             int num_unrecognized) {
+	uint32_t crc = 0;
+	for (int i = 0; sensors && recognized && i < num_sensors; ++i) {
+		if (!recognized[i]) continue;
+		const I2CSensor* s = sensors[i];
+		if (s == nullptr) continue;
+		uint8_t fixed[3] = {s->addr(), (uint8_t)(s->index() + 1), (uint8_t)(s->isInitialized() ? 1 : 0)};
+		crc = esp_rom_crc32_le(crc, fixed, sizeof(fixed));
+		crc = crc_str(crc, s->name().c_str());
+		crc = crc_str(crc, s->config_module_name().c_str());
+	}
+	// Separator keeps a sensor list and an unrecognized list of the same bytes apart
+	const uint8_t sep = 0xFF;
+	crc = esp_rom_crc32_le(crc, &sep, 1);
+	if (unrecognized_addrs && num_unrecognized > 0) {
+		crc = esp_rom_crc32_le(crc, unrecognized_addrs, (uint32_t)num_unrecognized);
+	}
+	return crc;
+}
+
+void publish_i2c_topology_digest(uint32_t digest) {
+	if (get_system_state() != FULLY_CONNECTED) return;
+	char mac[13];
+	format_mac_nosep_lower(mac, sizeof(mac));
+	char topic[96];
+	snprintf(topic, sizeof(topic), "sensor/%s/device/i2c/digest", mac);
+	char payload[24];
+	snprintf(payload, sizeof(payload), "{\"digest\":\"%08lx\"}", (unsigned long)digest);
+	publish_to_topic(topic, payload, 0, 0);
+}
+
 void publish_i2c_topology(const I2CSensor* const* sensors,
                           const bool* recognized,
                           int num_sensors,
@@ -56,6 +108,11 @@ void publish_i2c_topology(const I2CSensor* const* sensors,
 	strftime(iso_ts, sizeof(iso_ts), "%Y-%m-%dT%H:%M:%SZ", &tm_utc);
 	cJSON_AddStringToObject(root, "ts", iso_ts);
 
+	char digest_str[9];
+	snprintf(digest_str, sizeof(digest_str), "%08lx",
+	         (unsigned long)i2c_topology_digest(sensors, recognized, num_sensors, unrecognized_addrs, num_unrecognized));
+	cJSON_AddStringToObject(root, "digest", digest_str);
+
 	// Sensors array
 	cJSON* arr = cJSON_AddArrayToObject(root, "sensors");
 	for (int i = 0; i < num_sensors; ++i) {
@@ -70,6 +127,7 @@ void publish_i2c_topology(const I2CSensor* const* sensors,
 		if (idx >= 0) cJSON_AddNumberToObject(obj, "index", idx);
 		std::string mod = s->config_module_name();
 		if (!mod.empty()) cJSON_AddStringToObject(obj, "module", mod.c_str());
+		cJSON_AddBoolToObject(obj, "ok", s->isInitialized());
 		cJSON_AddItemToArray(arr, obj);
 	}
 
@@ -97,17 +155,22 @@ void publish_i2c_topology(const I2CSensor* const* sensors,
 		return;
 	}
 
-	// Defer publish until connected
-	if (s_pending_json) {
-		cJSON_free(s_pending_json);
-		s_pending_json = nullptr;
-	}
+	// Defer publish until connected; a newer document replaces one still waiting
+	taskENTER_CRITICAL(&s_pending_lock);
+	char* stale = s_pending_json;
 	s_pending_json = json;
 	strncpy(s_pending_topic, topic, sizeof(s_pending_topic) - 1);
 	s_pending_topic[sizeof(s_pending_topic) - 1] = '\0';
-
-	if (s_topology_task == nullptr) {
-		xTaskCreate(i2c_topology_publisher_task, "i2c_topo_pub", 3072, nullptr, tskIDLE_PRIORITY + 1, &s_topology_task);
+	bool start_task = !s_topology_task_running;
+	s_topology_task_running = true;
+	taskEXIT_CRITICAL(&s_pending_lock);
+	cJSON_free(stale);
+
+	if (start_task &&
+	    xTaskCreate(i2c_topology_publisher_task, "i2c_topo_pub", 3072, nullptr, tskIDLE_PRIORITY + 1, nullptr) != pdPASS) {
+		taskENTER_CRITICAL(&s_pending_lock);
+		s_topology_task_running = false;
+		taskEXIT_CRITICAL(&s_pending_lock);
 	}
 }
 
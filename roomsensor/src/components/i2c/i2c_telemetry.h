@@ -11,4 +11,14 @@ void publish_i2c_topology(const I2CSensor* const* sensors,
 	const uint8_t* unrecognized_addrs,
 	int num_unrecognized);
 
+// CRC-32 over everything publish_i2c_topology() would put in the document except its timestamp.
+// Two topologies with the same digest publish the same document.
+uint32_t i2c_topology_digest(const I2CSensor* const* sensors,
+	const bool* recognized,
+	int num_sensors,
+	const uint8_t* unrecognized_addrs,
+	int num_unrecognized);
 
+// Publish the digest alone to sensor/$mac/device/i2c/digest (not retained, dropped while offline).
+// Lets the backend confirm the retained document is current without receiving it again.
+void publish_i2c_topology_digest(uint32_t digest);
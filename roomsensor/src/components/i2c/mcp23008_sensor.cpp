@@ -3,6 +3,8 @@
 #include "esp_log.h"
 #include "ConfigurationManager.h"
 #include "IOConfig.h"
+#include "AlarmConfig.h"
+#include "alarms.h"
 #include "mcp23088_keypad.h"
 
 static const char *TAG = "MCP23008Sensor";
@@ -173,27 +175,33 @@ void MCP23008Sensor::poll() {
     // Also update IOConfig contact states for SENSOR pins.
     uint8_t changed = gpio ^ _gpio_cached_last;
     bool any_contact_change = false;
+    const config::AlarmConfig& alarm_cfg = config::GetConfigurationManager().alarm();
     for (int i = 0; i < 8; ++i) {
         config::IOConfig::PinMode mode = config::IOConfig::PinMode::INVALID;
         if (_config_ptr) mode = _config_ptr->pin_mode(i + 1);
 
         bool bit_now_high = ((gpio >> i) & 0x01) != 0;
         bool is_low_now = !bit_now_high; // active low => closed when low
+        const bool sensor = mode == config::IOConfig::PinMode::SENSOR;
+        const char* pname = _config_ptr ? _config_ptr->pin_name(i + 1) : "";
 
-        if (_config_ptr && mode == config::IOConfig::PinMode::SENSOR) {
+        if (_config_ptr && sensor) {
             _config_ptr->set_contact_state(i + 1, is_low_now);
         }
 
+        // Water and door override contacts: closed raises, open clears (alarms.h). Every poll, so a
+        // contact closed at boot or newly named as an alarm contact raises without an edge.
+        _contact_alarms[i].update(sensor && is_low_now && alarm_cfg.is_alarm_contact(pname), pname,
+                                  [&](bool raised, const char* name) {
+                                      set_pin_tags(i + 1, name);
+                                      report_alarm("contact", raised, is_low_now ? 1.0f : 0.0f, 1.0f,
+                                                   _tag_collection);
+                                  });
+
         if (((changed >> i) & 0x01) == 0) continue; // no electrical change on this pin
 
-        if (mode == config::IOConfig::PinMode::SENSOR) {
-            // Update tag with pin index (1..8)
-            char index_buf[4]; snprintf(index_buf, sizeof(index_buf), "%d", i + 1);
-            add_tag_to_collection(_tag_collection, "index", index_buf);
-            const char* pname = _config_ptr ? _config_ptr->pin_name(i + 1) : "";
-            if (pname && pname[0] != '\0') {
-                add_tag_to_collection(_tag_collection, "name", pname);
-            }
+        if (sensor) {
+            set_pin_tags(i + 1, pname);
             ESP_LOGI(TAG, "io%d pin%d contact %s", _io_index, i + 1, is_low_now ? "closed" : "open");
             report_metric("contact", is_low_now ? 1.0f : 0.0f, _tag_collection);
             any_contact_change = true;
@@ -254,6 +262,17 @@ void MCP23008Sensor::poll() {
     }
 }
 
+void MCP23008Sensor::set_pin_tags(int pin, const char* name) {
+    char index_buf[4]; snprintf(index_buf, sizeof(index_buf), "%d", pin);
+    add_tag_to_collection(_tag_collection, "index", index_buf);
+    // The collection is shared by all pins: an unnamed pin must not carry the previous pin's name
+    if (name && name[0] != '\0') {
+        add_tag_to_collection(_tag_collection, "name", name);
+    } else {
+        remove_tag_from_collection(_tag_collection, "name");
+    }
+}
+
 float MCP23008Sensor::getLevel() const {
     return _level;
 }
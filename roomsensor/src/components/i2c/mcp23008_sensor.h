@@ -3,6 +3,7 @@
 #include "i2c_sensor.h"
 #include "esp_err.h"
 #include "communication.h"
+#include "alarms.h"
 #include <string>
 
 namespace config { class IOConfig; }
@@ -59,6 +60,8 @@ private:
     void configureGpio0AsInput();
     void configureFromConfig(bool force_write = false);
     int addrToIndex(uint8_t addr) const;
+    // Point the shared tag collection at one pin (1..8): index, and name when it has one
+    void set_pin_tags(int pin, const char* name);
 
     uint8_t _i2c_addr;
     bool _initialized;
@@ -75,6 +78,7 @@ private:
     config::IOConfig* _config_ptr = nullptr; // non-owning
 
     bool _initial_state_published = false;
+    alarms::ContactAlarm _contact_alarms[8]; // per pin, SENSOR pins named as alarm contacts
 };
 
 
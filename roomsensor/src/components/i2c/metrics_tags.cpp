@@ -2,7 +2,6 @@
 #include "ConfigurationManager.h"
 #include "TagsConfig.h"
 #include <string.h>
-#include <string>
 #include "esp_mac.h"
 #include <stdio.h>
 
@@ -60,9 +59,8 @@ TagCollection* create_tag_collection(void) {
     if (collection->count < MAX_DEVICE_TAGS) {
         strncpy(collection->tags[collection->count].key, "sensor", MAX_TAG_KEY_LEN - 1);
         collection->tags[collection->count].key[MAX_TAG_KEY_LEN - 1] = '\0';
-        std::string sensor = tags.room() + std::string("-") + tags.id();
-        strncpy(collection->tags[collection->count].value, sensor.c_str(), MAX_TAG_VALUE_LEN - 1);
-        collection->tags[collection->count].value[MAX_TAG_VALUE_LEN - 1] = '\0';
+        snprintf(collection->tags[collection->count].value, MAX_TAG_VALUE_LEN, "%s-%s",
+                 tags.room().c_str(), tags.id().c_str());
         collection->count++;
     }
 
@@ -2,6 +2,8 @@
 #include "esp_log.h"
 #include <string.h>
 #include "esp_timer.h"
+#include "ConfigurationManager.h"
+#include "AlarmConfig.h"
 
 static const char *TAG = "SCD4xSensor";
 
@@ -181,6 +183,10 @@ void SCD4xSensor::poll() {
     if (is_warming_up()) {
         return;
     }
+    // Alarms first: they take their own queue and publish path (alarms.h)
+    const config::AlarmConfig& alarm_cfg = config::GetConfigurationManager().alarm();
+    _co2_alarm.update("co2", _co2, alarm_cfg.has_co2_ppm(), alarm_cfg.co2_ppm(), alarm_cfg.hysteresis_pct(),
+                      _tag_collection);
     report_metric(METRIC_CO2, _co2, _tag_collection);
     report_metric(METRIC_TEMPERATURE, getTemperatureFahrenheit(), _tag_collection);
     report_metric(METRIC_HUMIDITY, _humidity, _tag_collection);
@@ -3,6 +3,7 @@
 #include "i2c_sensor.h"
 #include "esp_err.h"
 #include "communication.h"
+#include "alarms.h"
 #include <string>
 
 /**
@@ -100,6 +101,7 @@ private:
     float _humidity;     ///< Relative humidity in %
     bool _initialized;   ///< Initialization state
     TagCollection* _tag_collection; ///< Tag collection for metrics
+    alarms::ThresholdAlarm _co2_alarm; ///< "co2" alarm state (thresholds in the alarm config module)
 
     // SCD4x I2C address
     static constexpr uint8_t SCD4X_I2C_ADDR = 0x62;
@@ -0,0 +1,292 @@
+#include "CellularAutomaton.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
+namespace leds {
+namespace internal {
+
+namespace {
+
+// Parse neighbour-count digits (0..8) into a bit mask; stops at '/' or end. Returns false on bad input.
+bool parse_counts(const char*& p, uint16_t& mask) {
+    mask = 0;
+    while (*p && *p != '/') {
+        if (*p < '0' || *p > '8') return false;
+        mask |= static_cast<uint16_t>(1u << (*p - '0'));
+        ++p;
+    }
+    return true;
+}
+
+inline uint32_t bit_at(const uint32_t* row, size_t c) { return (row[c >> 5] >> (c & 31)) & 1u; }
+
+} // namespace
+
+bool CARule::parse(const char* text, CARule& out) {
+    if (!text) return false;
+    while (*text == ' ' || *text == '\t') ++text;
+    if (strcasecmp(text, "LIFE") == 0 || strcasecmp(text, "CONWAY") == 0) return parse("B3/S23", out);
+    if (strcasecmp(text, "HIGHLIFE") == 0) return parse("B36/S23", out);
+    if (strcasecmp(text, "SEEDS") == 0) return parse("B2/S", out);
+    if (strcasecmp(text, "DAYNIGHT") == 0 || strcasecmp(text, "DAY_NIGHT") == 0) return parse("B3678/S34678", out);
+    if (strcasecmp(text, "BRIAN") == 0 || strcasecmp(text, "BRIANS_BRAIN") == 0) return parse("B2/S/C3", out);
+    if (strcasecmp(text, "WIREWORLD") == 0) {
+        CARule r;
+        r.kind = Kind::WIREWORLD;
+        r.birth = (1u << 1) | (1u << 2); // conductor fires with 1 or 2 neighbouring heads
+        r.survive = 0;
+        r.states = 4;
+        out = r;
+        return true;
+    }
+
+    CARule r;
+    r.birth = 0;
+    r.survive = 0;
+    long states = 2;
+    bool have_rule = false;
+    // Sections separated by '/'. Tagged sections (B.., S.., C..) may come in any order; untagged
+    // sections follow the classic S/B/C order ("23/3", "/2", "345/2/4").
+    const char* p = text;
+    for (int section = 0; section < 3 && *p; ++section) {
+        char tag = static_cast<char>(toupper(static_cast<unsigned char>(*p)));
+        if (tag == 'B' || tag == 'S' || tag == 'C' || tag == 'G') ++p;
+        else tag = (section == 0) ? 'S' : (section == 1) ? 'B' : 'C';
+        if (tag == 'C' || tag == 'G') {
+            char* endp = nullptr;
+            states = strtol(p, &endp, 10);
+            if (endp == p || states < 2 || states > 255) return false;
+            p = endp;
+        } else {
+            uint16_t m = 0;
+            if (!parse_counts(p, m)) return false;
+            if (tag == 'B') r.birth = m; else r.survive = m;
+            have_rule = true;
+        }
+        if (*p == '/') ++p;
+        else if (*p) return false;
+    }
+    if (!have_rule || *p) return false;
+    r.states = static_cast<uint8_t>(states);
+    r.kind = (states > 2) ? Kind::GENERATIONS : Kind::LIFE_LIKE;
+    out = r;
+    return true;
+}
+
+void CellularAutomaton::configure(size_t rows, size_t cols, const CARule& rule, bool wrap) {
+    rule_ = rule;
+    wrap_ = wrap;
+    rows_ = rows;
+    cols_ = cols;
+    wpr_ = (cols + 31) / 32;
+    last_mask_ = (cols & 31) ? ((1u << (cols & 31)) - 1u) : 0xFFFFFFFFu;
+    switch (rule_.kind) {
+        case CARule::Kind::LIFE_LIKE: planes_ = 1; break;
+        case CARule::Kind::WIREWORLD: planes_ = 2; break;
+        case CARule::Kind::GENERATIONS: {
+            planes_ = 1;
+            while ((1u << planes_) < rule_.states) ++planes_;
+            break;
+        }
+    }
+    cur_.assign(planes_ * rows_ * wpr_, 0);
+    next_.assign(planes_ * rows_ * wpr_, 0);
+    alive_.assign(rows_ * wpr_, 0);
+    scratch_.assign(11 * wpr_, 0);
+    if (!ages_.empty()) ages_.assign(rows_ * cols_, 0);
+}
+
+void CellularAutomaton::clear() {
+    std::fill(cur_.begin(), cur_.end(), 0u);
+    std::fill(ages_.begin(), ages_.end(), 0u);
+}
+
+void CellularAutomaton::set_track_age(bool on) {
+    if (on && ages_.empty()) ages_.assign(rows_ * cols_, 0);
+    if (!on) decltype(ages_)().swap(ages_);
+}
+
+uint8_t CellularAutomaton::state(size_t row, size_t col) const {
+    if (row >= rows_ || col >= cols_) return 0;
+    const size_t plane_words = rows_ * wpr_;
+    const size_t w = row * wpr_ + (col >> 5);
+    uint8_t s = 0;
+    for (size_t k = 0; k < planes_; ++k) s |= static_cast<uint8_t>(((cur_[k * plane_words + w] >> (col & 31)) & 1u) << k);
+    return s;
+}
+
+void CellularAutomaton::set_state(size_t row, size_t col, uint8_t state) {
+    if (row >= rows_ || col >= cols_) return;
+    if (state >= rule_.states) state = static_cast<uint8_t>(rule_.states - 1);
+    const size_t plane_words = rows_ * wpr_;
+    const size_t w = row * wpr_ + (col >> 5);
+    const uint32_t bit = 1u << (col & 31);
+    for (size_t k = 0; k < planes_; ++k) {
+        if (state & (1u << k)) cur_[k * plane_words + w] |= bit;
+        else cur_[k * plane_words + w] &= ~bit;
+    }
+    if (!ages_.empty()) ages_[row * cols_ + col] = 0;
+}
+
+bool CellularAutomaton::any_nonzero() const {
+    for (uint32_t v : cur_) if (v) return true;
+    return false;
+}
+
+void CellularAutomaton::shifted_rows(const uint32_t* row, uint32_t* west, uint32_t* east) {
+    // west[c] = cell(c - 1), east[c] = cell(c + 1)
+    for (size_t w = 0; w < wpr_; ++w) {
+        uint32_t x = row[w];
+        uint32_t prev = (w > 0) ? row[w - 1] : 0u;
+        uint32_t nxt = (w + 1 < wpr_) ? row[w + 1] : 0u;
+        west[w] = (x << 1) | (prev >> 31);
+        east[w] = (x >> 1) | (nxt << 31);
+    }
+    if (wrap_) {
+        west[0] |= bit_at(row, cols_ - 1);
+        east[wpr_ - 1] |= bit_at(row, 0) << ((cols_ - 1) & 31);
+    }
+    west[wpr_ - 1] &= last_mask_;
+    east[wpr_ - 1] &= last_mask_;
+}
+
+void CellularAutomaton::neighbour_counts(const uint32_t* alive, size_t row,
+                                         uint32_t* b0, uint32_t* b1, uint32_t* b2, uint32_t* b3) {
+    // Scratch layout: [zero row][nw][ne][cw][ce][sw][se][b0..b3]
+    uint32_t* zero = scratch_.data();
+    uint32_t* nw = zero + wpr_;
+    uint32_t* ne = nw + wpr_;
+    uint32_t* cw = ne + wpr_;
+    uint32_t* ce = cw + wpr_;
+    uint32_t* sw = ce + wpr_;
+    uint32_t* se = sw + wpr_;
+    const uint32_t* n;
+    const uint32_t* s;
+    if (row > 0) n = alive + (row - 1) * wpr_;
+    else n = wrap_ ? alive + (rows_ - 1) * wpr_ : zero;
+    if (row + 1 < rows_) s = alive + (row + 1) * wpr_;
+    else s = wrap_ ? alive : zero;
+    const uint32_t* c = alive + row * wpr_;
+    shifted_rows(n, nw, ne);
+    shifted_rows(c, cw, ce);
+    shifted_rows(s, sw, se);
+    for (size_t w = 0; w < wpr_; ++w) {
+        // Sum eight 1-bit inputs per lane with a carry-save adder tree into a 4-bit count (0..8)
+        uint32_t t1 = nw[w] ^ n[w], s1 = t1 ^ ne[w], c1 = (nw[w] & n[w]) | (t1 & ne[w]);
+        uint32_t t2 = cw[w] ^ ce[w], s2 = t2 ^ sw[w], c2 = (cw[w] & ce[w]) | (t2 & sw[w]);
+        uint32_t s3 = s[w] ^ se[w], c3 = s[w] & se[w];
+        uint32_t t4 = s1 ^ s2, ones = t4 ^ s3, c4 = (s1 & s2) | (t4 & s3);
+        uint32_t t5 = c1 ^ c2, twos_a = t5 ^ c3, c5 = (c1 & c2) | (t5 & c3);
+        uint32_t twos = twos_a ^ c4, c6 = twos_a & c4;
+        b0[w] = ones;
+        b1[w] = twos;
+        b2[w] = c5 ^ c6;
+        b3[w] = c5 & c6;
+    }
+}
+
+uint32_t CellularAutomaton::count_mask(uint16_t set, uint32_t b0, uint32_t b1, uint32_t b2, uint32_t b3) const {
+    uint32_t m = 0;
+    for (unsigned k = 0; k <= 8; ++k) {
+        if (!(set & (1u << k))) continue;
+        m |= ((k & 1) ? b0 : ~b0) & ((k & 2) ? b1 : ~b1) & ((k & 4) ? b2 : ~b2) & ((k & 8) ? b3 : ~b3);
+    }
+    return m;
+}
+
+void CellularAutomaton::step() {
+    if (rows_ == 0 || cols_ == 0) return;
+    const size_t plane_words = rows_ * wpr_;
+
+    // Plane of cells in state 1; these are the ones neighbours count
+    const uint32_t* alive = cur_.data();
+    if (planes_ > 1) {
+        for (size_t i = 0; i < plane_words; ++i) {
+            uint32_t higher = 0;
+            for (size_t k = 1; k < planes_; ++k) higher |= cur_[k * plane_words + i];
+            alive_[i] = cur_[i] & ~higher;
+        }
+        alive = alive_.data();
+    }
+
+    uint32_t* b0 = scratch_.data() + 7 * wpr_;
+    uint32_t* b1 = b0 + wpr_;
+    uint32_t* b2 = b1 + wpr_;
+    uint32_t* b3 = b2 + wpr_;
+    for (size_t r = 0; r < rows_; ++r) {
+        neighbour_counts(alive, r, b0, b1, b2, b3);
+        for (size_t w = 0; w < wpr_; ++w) {
+            const size_t i = r * wpr_ + w;
+            const uint32_t valid = (w + 1 == wpr_) ? last_mask_ : 0xFFFFFFFFu;
+            const uint32_t born = count_mask(rule_.birth, b0[w], b1[w], b2[w], b3[w]);
+            switch (rule_.kind) {
+                case CARule::Kind::LIFE_LIKE: {
+                    const uint32_t a = cur_[i];
+                    const uint32_t stay = count_mask(rule_.survive, b0[w], b1[w], b2[w], b3[w]);
+                    next_[i] = ((~a & born) | (a & stay)) & valid;
+                    break;
+                }
+                case CARule::Kind::WIREWORLD: {
+                    // 0 empty, 1 head, 2 tail, 3 conductor: head->tail, tail->conductor,
+                    // conductor->head when 'birth' (1 or 2 neighbouring heads)
+                    const uint32_t p0 = cur_[i], p1 = cur_[plane_words + i];
+                    const uint32_t head = p0 & ~p1, tail = ~p0 & p1, cond = p0 & p1;
+                    const uint32_t fire = cond & born;
+                    next_[i] = p1 & valid;
+                    next_[plane_words + i] = (head | tail | (cond & ~fire)) & valid;
+                    break;
+                }
+                case CARule::Kind::GENERATIONS: {
+                    const uint32_t a = alive[i];
+                    uint32_t any = 0;
+                    for (size_t k = 0; k < planes_; ++k) any |= cur_[k * plane_words + i];
+                    const uint32_t stay = count_mask(rule_.survive, b0[w], b1[w], b2[w], b3[w]);
+                    // Refractory cells, and live cells that fail to survive, advance one state
+                    uint32_t carry = (any & ~a) | (a & ~stay);
+                    uint32_t is_limit = 0xFFFFFFFFu;
+                    for (size_t k = 0; k < planes_; ++k) {
+                        const uint32_t pk = cur_[k * plane_words + i];
+                        const uint32_t nk = pk ^ carry;
+                        carry = pk & carry;
+                        next_[k * plane_words + i] = nk;
+                        is_limit &= (rule_.states & (1u << k)) ? nk : ~nk;
+                    }
+                    // Reaching state C means dead again; empty cells may be born into state 1
+                    const uint32_t birth_mask = ~any & born;
+                    for (size_t k = 0; k < planes_; ++k) {
+                        uint32_t v = next_[k * plane_words + i] & ~is_limit;
+                        if (k == 0) v |= birth_mask;
+                        next_[k * plane_words + i] = v & valid;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    if (!ages_.empty()) update_ages();
+    cur_.swap(next_);
+}
+
+void CellularAutomaton::update_ages() {
+    const size_t plane_words = rows_ * wpr_;
+    for (size_t r = 0; r < rows_; ++r) {
+        uint8_t* age_row = &ages_[r * cols_];
+        for (size_t w = 0; w < wpr_; ++w) {
+            const size_t i = r * wpr_ + w;
+            uint32_t changed = 0;
+            for (size_t k = 0; k < planes_; ++k) changed |= cur_[k * plane_words + i] ^ next_[k * plane_words + i];
+            const size_t c0 = w * 32;
+            const size_t n = (cols_ - c0 < 32) ? (cols_ - c0) : 32;
+            for (size_t b = 0; b < n; ++b) {
+                uint8_t& a = age_row[c0 + b];
+                if ((changed >> b) & 1u) a = 0;
+                else if (a != 255) ++a;
+            }
+        }
+    }
+}
+
+} // namespace internal
+} // namespace leds
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "PsramAllocator.h"
+
+namespace leds {
+namespace internal {
+
+// Rule for CellularAutomaton.
+// - LIFE_LIKE: outer-totalistic two-state rules in B/S notation ("B3/S23", "B36/S23", "B2/S", "B3678/S34678")
+// - GENERATIONS: multi-state B/S/C rules; a live cell that fails to survive ages through C-2 refractory
+//   states before dying ("B2/S/C3" is Brian's Brain)
+// - WIREWORLD: empty / electron head / electron tail / conductor
+struct CARule {
+    enum class Kind { LIFE_LIKE, GENERATIONS, WIREWORLD };
+    Kind kind = Kind::LIFE_LIKE;
+    uint16_t birth = 1u << 3;                 // bit n set => born with n live neighbours
+    uint16_t survive = (1u << 2) | (1u << 3); // bit n set => survives with n live neighbours
+    uint8_t states = 2;                       // number of cell states (2 for LIFE_LIKE, 4 for WIREWORLD)
+
+    // Parse a rule string; accepts B/S[/C] notation (case-insensitive, also "23/3" S/B order)
+    // and the names LIFE, HIGHLIFE, SEEDS, DAYNIGHT, BRIAN, WIREWORLD. Returns false on error.
+    static bool parse(const char* text, CARule& out);
+};
+
+// Bit-sliced cellular automaton on a rows x cols grid.
+// Cell states are stored as bit-planes of 32-bit words (one bit per cell per plane, rows padded to whole
+// words), and neighbour counts are computed with bit-parallel adders, so one generation costs a few dozen
+// ALU operations per 32 cells regardless of rule. Edges either wrap (torus) or are bounded (outside dead).
+// State 0 is always empty; state 1 is "alive" (the state neighbours count). Pure logic, no IDF dependency.
+class CellularAutomaton {
+public:
+    void configure(size_t rows, size_t cols, const CARule& rule, bool wrap);
+    void clear();
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    const CARule& rule() const { return rule_; }
+
+    uint8_t state(size_t row, size_t col) const;
+    void set_state(size_t row, size_t col, uint8_t state);
+    // Consecutive generations the cell has spent in its current state (saturates at 255). Only maintained
+    // when age tracking is enabled, since it costs a per-cell pass.
+    uint8_t age(size_t row, size_t col) const { return ages_.empty() ? 0 : ages_[row * cols_ + col]; }
+    void set_track_age(bool on);
+
+    // Advance one generation.
+    void step();
+
+    bool any_nonzero() const;
+    // Raw state words (planes() planes of rows() * words_per_row() words) for snapshots and hashing
+    const std::vector<uint32_t>& words() const { return cur_; }
+    size_t planes() const { return planes_; }
+    size_t words_per_row() const { return wpr_; }
+
+private:
+    void neighbour_counts(const uint32_t* alive, size_t row, uint32_t* b0, uint32_t* b1, uint32_t* b2, uint32_t* b3);
+    void shifted_rows(const uint32_t* row, uint32_t* west, uint32_t* east);
+    uint32_t count_mask(uint16_t set, uint32_t b0, uint32_t b1, uint32_t b2, uint32_t b3) const;
+    void update_ages();
+
+    CARule rule_;
+    bool wrap_ = true;
+    size_t rows_ = 0, cols_ = 0;
+    size_t wpr_ = 0;     // 32-bit words per row
+    size_t planes_ = 1;  // bit-planes per cell
+    uint32_t last_mask_ = 0xFFFFFFFFu; // valid bits of the last word in each row
+    // State words are small (1 bit per cell per plane) and touched every generation: keep them in internal RAM
+    std::vector<uint32_t> cur_;
+    std::vector<uint32_t> next_;
+    std::vector<uint8_t, PsramAllocator<uint8_t>> ages_;
+    // Scratch rows: alive plane (state == 1) for every row, plus shifted neighbours and count bit-planes
+    std::vector<uint32_t> alive_;
+    std::vector<uint32_t> scratch_;
+};
+
+} // namespace internal
+} // namespace leds
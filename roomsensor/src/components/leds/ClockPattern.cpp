@@ -119,10 +119,10 @@ void ClockPattern::draw_outline(LEDStrip& strip) {
     if (!kClockDrawOutline) return;
     struct timeval tv{}; gettimeofday(&tv, nullptr);
     time_t now = tv.tv_sec; struct tm lt; localtime_r(&now, &lt);
-    float sec_in_min = static_cast<float>(lt.tm_sec) + static_cast<float>(tv.tv_usec) / 1000000.0f;
-    float frac = sec_in_min / 60.0f;
-    // Head position goes around the perimeter (same 60-step mapping); snake length limited to kSnakeLen
-    int head_seg = static_cast<int>(frac * 60.0f + 0.5f) % 60;
+    // Head position goes around the perimeter (one step per second, rounded to the nearest second);
+    // snake length limited to kSnakeLen
+    int64_t us_in_min = static_cast<int64_t>(lt.tm_sec) * 1000000 + static_cast<int64_t>(tv.tv_usec);
+    int head_seg = static_cast<int>((us_in_min + 500000) / 1000000) % 60;
     auto scale = [this](uint8_t c) -> uint8_t { return static_cast<uint8_t>((static_cast<int>(c) * brightness_percent_) / 100); };
     uint8_t rr = scale(r_), gg = scale(g_), bb = scale(b_), ww = scale(w_);
 
@@ -0,0 +1,300 @@
+#include "DashboardPattern.h"
+#include "LEDStrip.h"
+#include "font6x6.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace leds {
+
+namespace {
+static inline uint8_t scale_channel(uint8_t c, int percent) {
+    if (percent <= 0) return 0;
+    if (percent >= 100) return c;
+    return static_cast<uint8_t>((static_cast<int>(c) * percent) / 100);
+}
+
+// Value as text without printf (newlib's float formatting allocates): integers from 100 up,
+// one decimal below that.
+static void format_value(float v, char* out, size_t n) {
+    char tmp[16];
+    size_t len = 0;
+    bool neg = v < 0.0f;
+    if (neg) v = -v;
+    bool decimal = v < 100.0f;
+    uint32_t scaled = (v > 99999999.0f) ? 999999999u : static_cast<uint32_t>(v * (decimal ? 10.0f : 1.0f) + 0.5f);
+    int digits = 0;
+    do {
+        if (decimal && digits == 1) tmp[len++] = '.';
+        tmp[len++] = static_cast<char>('0' + scaled % 10u);
+        scaled /= 10u;
+        ++digits;
+    } while ((scaled != 0 || (decimal && digits < 2)) && len < sizeof(tmp) - 2);
+    if (neg) tmp[len++] = '-';
+    size_t o = 0;
+    while (len > 0 && o + 1 < n) out[o++] = tmp[--len];
+    out[o] = '\0';
+}
+
+// Copy 'src' into 'dst' (size n), truncating; always terminated
+static void copy_truncated(char* dst, size_t n, const char* src) {
+    size_t i = 0;
+    for (; i + 1 < n && src[i]; ++i) dst[i] = src[i];
+    dst[i] = '\0';
+}
+
+// Pixel interval for scrolling text that does not fit the panel
+static constexpr uint64_t kScrollStepUs = 60'000ULL;
+// How often to retry resolving a series that has not been published yet
+static constexpr uint64_t kLookupIntervalUs = 500'000ULL;
+} // namespace
+
+void DashboardPattern::set_solid_color(uint8_t r, uint8_t g, uint8_t b, uint8_t w) {
+    r_ = r; g_ = g; b_ = b; w_ = w;
+    needs_render_ = true;
+}
+
+void DashboardPattern::set_brightness_percent(int brightness_percent) {
+    if (brightness_percent < 0) brightness_percent = 0;
+    if (brightness_percent > 100) brightness_percent = 100;
+    brightness_percent_ = brightness_percent;
+    needs_render_ = true;
+}
+
+void DashboardPattern::set_speed_percent(int speed_percent) {
+    if (speed_percent < 0) speed_percent = 0;
+    if (speed_percent > 100) speed_percent = 100;
+    speed_percent_ = speed_percent;
+}
+
+void DashboardPattern::set_start_string(const char* spec) {
+    entry_count_ = 0;
+    entries_ = {};
+    const char* p = (spec && *spec) ? spec : "co2";
+    while (*p && entry_count_ < kMaxEntries) {
+        const char* end = strchr(p, ',');
+        size_t len = end ? static_cast<size_t>(end - p) : strlen(p);
+        char item[64];
+        if (len >= sizeof(item)) len = sizeof(item) - 1;
+        memcpy(item, p, len);
+        item[len] = '\0';
+
+        Entry& e = entries_[entry_count_];
+        // metric[@label][:warn[:alarm]]
+        char* thresholds = strchr(item, ':');
+        if (thresholds) *thresholds++ = '\0';
+        char* at = strchr(item, '@');
+        if (at) {
+            *at++ = '\0';
+            copy_truncated(e.label, sizeof(e.label), at);
+        }
+        copy_truncated(e.metric, sizeof(e.metric), item);
+        if (thresholds && *thresholds) {
+            char* next = nullptr;
+            e.warn = strtof(thresholds, &next);
+            e.has_warn = (next != thresholds);
+            if (next && *next == ':') {
+                const char* a = next + 1;
+                e.alarm = strtof(a, &next);
+                e.has_alarm = (next != a);
+            }
+        }
+        if (e.metric[0]) ++entry_count_;
+        if (!end) break;
+        p = end + 1;
+    }
+    current_ = 0;
+    seen_seq_ = 0;
+    hist_len_ = 0;
+    have_value_ = false;
+    needs_render_ = true;
+}
+
+void DashboardPattern::reset(LEDStrip& strip, uint64_t now_us) {
+    if (entry_count_ == 0) set_start_string(nullptr);
+    current_ = 0;
+    entry_start_us_ = now_us;
+    last_lookup_us_ = 0;
+    seen_seq_ = 0;
+    hist_len_ = 0;
+    have_value_ = false;
+    scroll_px_ = 0;
+    last_scroll_us_ = now_us;
+    refresh_samples(now_us);
+    render(strip);
+}
+
+int DashboardPattern::level_for(const Entry& e, float v) const {
+    if (!e.has_warn && !e.has_alarm) return 0;
+    // Inverted scale when warn > alarm (low values are bad)
+    bool inverted = e.has_warn && e.has_alarm && e.warn > e.alarm;
+    auto beyond = [inverted](float x, float t) { return inverted ? (x <= t) : (x >= t); };
+    if (e.has_alarm && beyond(v, e.alarm)) return 2;
+    if (e.has_warn && beyond(v, e.warn)) return 1;
+    return 0;
+}
+
+void DashboardPattern::color_for(int level, uint8_t& r, uint8_t& g, uint8_t& b, uint8_t& w) const {
+    switch (level) {
+        case 2: r = 255; g = 0; b = 0; w = 0; break;   // alarm: red
+        case 1: r = 255; g = 120; b = 0; w = 0; break; // warn: amber
+        default: r = r_; g = g_; b = b_; w = w_; break;
+    }
+    r = scale_channel(r, brightness_percent_);
+    g = scale_channel(g, brightness_percent_);
+    b = scale_channel(b, brightness_percent_);
+    w = scale_channel(w, brightness_percent_);
+}
+
+bool DashboardPattern::refresh_samples(uint64_t now_us) {
+    if (entry_count_ == 0) return false;
+    Entry& e = entries_[current_];
+    if (!e.series) {
+        if (last_lookup_us_ != 0 && (now_us - last_lookup_us_) < kLookupIntervalUs) return false;
+        last_lookup_us_ = now_us;
+        e.series = metrics_bus::find(e.metric, e.label[0] ? e.label : nullptr);
+        if (!e.series) {
+            if (have_value_ || text_[0] != '-') {
+                have_value_ = false;
+                hist_len_ = 0;
+                strcpy(text_, "--");
+                text_px_ = 16;
+                return true;
+            }
+            return false;
+        }
+    }
+    uint32_t seq = e.series->sequence();
+    if (seq == seen_seq_ && have_value_) return false;
+    seen_seq_ = seq;
+
+    // Copy the readable tail of the ring, oldest first (skips slots overwritten mid-read)
+    hist_len_ = 0;
+    uint32_t count = seq < metrics_bus::kHistory ? seq : static_cast<uint32_t>(metrics_bus::kHistory);
+    for (uint32_t s = seq - count; s != seq; ++s) {
+        metrics_bus::Sample sample;
+        if (e.series->read(s, sample)) hist_[hist_len_++] = sample.value;
+    }
+    have_value_ = hist_len_ > 0;
+    if (have_value_) {
+        format_value(hist_[hist_len_ - 1], text_, sizeof(text_));
+    } else {
+        strcpy(text_, "--");
+    }
+    text_px_ = static_cast<int>(strlen(text_)) * 8;
+    return true;
+}
+
+void DashboardPattern::update(LEDStrip& strip, uint64_t now_us) {
+    bool changed = needs_render_;
+
+    // Cycle between entries; dwell 20s (speed 0) .. 2s (speed 100)
+    if (entry_count_ > 1) {
+        uint64_t dwell_us = 2'000'000ULL + static_cast<uint64_t>(100 - speed_percent_) * 180'000ULL;
+        if ((now_us - entry_start_us_) >= dwell_us) {
+            current_ = (current_ + 1) % entry_count_;
+            entry_start_us_ = now_us;
+            last_lookup_us_ = 0;
+            seen_seq_ = 0;
+            have_value_ = false;
+            scroll_px_ = 0;
+            changed = true;
+        }
+    }
+
+    if (refresh_samples(now_us)) changed = true;
+
+    // Scroll text that is wider than the panel
+    if (strip.rows() >= 8 && text_px_ > static_cast<int>(strip.cols()) && (now_us - last_scroll_us_) >= kScrollStepUs) {
+        last_scroll_us_ = now_us;
+        scroll_px_ = (scroll_px_ + 1) % (text_px_ + static_cast<int>(strip.cols()));
+        changed = true;
+    }
+
+    if (changed) render(strip);
+}
+
+void DashboardPattern::render(LEDStrip& strip) {
+    needs_render_ = false;
+    if (strip.rows() >= 8) render_grid(strip);
+    else render_bar(strip);
+}
+
+void DashboardPattern::render_grid(LEDStrip& strip) {
+    const size_t rows = strip.rows();
+    const size_t cols = strip.cols();
+    for (size_t i = 0; i < strip.length(); ++i) strip.set_pixel(i, 0, 0, 0, 0);
+    if (entry_count_ == 0) return;
+    const Entry& e = entries_[current_];
+
+    uint8_t r, g, b, w;
+    int level = have_value_ ? level_for(e, hist_[hist_len_ - 1]) : 0;
+    color_for(level, r, g, b, w);
+    if (!have_value_) {
+        // Dim placeholder until the first sample arrives
+        r /= 4; g /= 4; b /= 4; w /= 4;
+    }
+    int x;
+    if (text_px_ <= static_cast<int>(cols)) {
+        x = (static_cast<int>(cols) - text_px_) / 2;
+    } else {
+        x = static_cast<int>(cols) - scroll_px_;
+    }
+    font6x6::draw_text_scrolling(strip, text_, 0, x, r, g, b, w);
+
+    // Sparkline below the value: newest sample in the rightmost column, one column per sample
+    if (rows < 12 || hist_len_ == 0) return;
+    const size_t top = 8;
+    const size_t height = rows - top;
+    size_t n = hist_len_ < cols ? hist_len_ : cols;
+    const float* v = &hist_[hist_len_ - n];
+    float lo = v[0], hi = v[0];
+    for (size_t i = 1; i < n; ++i) {
+        if (v[i] < lo) lo = v[i];
+        if (v[i] > hi) hi = v[i];
+    }
+    float span = hi - lo;
+    for (size_t i = 0; i < n; ++i) {
+        size_t col = cols - n + i;
+        size_t h = (span > 0.0f) ? 1 + static_cast<size_t>((v[i] - lo) / span * static_cast<float>(height - 1) + 0.5f)
+                                 : (height + 1) / 2;
+        if (h > height) h = height;
+        uint8_t cr, cg, cb, cw;
+        color_for(level_for(e, v[i]), cr, cg, cb, cw);
+        for (size_t k = 0; k < h; ++k) {
+            size_t row = rows - 1 - k;
+            // Bar body at half intensity, top pixel full
+            bool tip = (k + 1 == h);
+            strip.set_pixel(strip.index_for_row_col(row, col),
+                            tip ? cr : cr / 2, tip ? cg : cg / 2, tip ? cb : cb / 2, tip ? cw : cw / 2);
+        }
+    }
+}
+
+void DashboardPattern::render_bar(LEDStrip& strip) {
+    const size_t len = strip.length();
+    if (len == 0) return;
+    if (entry_count_ == 0 || !have_value_) {
+        for (size_t i = 0; i < len; ++i) strip.set_pixel(i, 0, 0, 0, 0);
+        return;
+    }
+    const Entry& e = entries_[current_];
+    float v = hist_[hist_len_ - 1];
+    // Full scale: the alarm (or warn) threshold if configured, else the recent maximum
+    float full = 0.0f;
+    if (e.has_alarm && !(e.has_warn && e.warn > e.alarm)) full = e.alarm;
+    else if (e.has_warn && !e.has_alarm) full = e.warn;
+    if (full <= 0.0f) {
+        for (size_t i = 0; i < hist_len_; ++i) if (hist_[i] > full) full = hist_[i];
+    }
+    size_t lit = (full > 0.0f && v > 0.0f) ? static_cast<size_t>(v / full * static_cast<float>(len) + 0.5f) : 0;
+    if (lit > len) lit = len;
+    if (lit == 0 && v > 0.0f) lit = 1;
+    uint8_t r, g, b, w;
+    color_for(level_for(e, v), r, g, b, w);
+    for (size_t i = 0; i < len; ++i) {
+        if (i < lit) strip.set_pixel(i, r, g, b, w);
+        else strip.set_pixel(i, 0, 0, 0, 0);
+    }
+}
+
+} // namespace leds
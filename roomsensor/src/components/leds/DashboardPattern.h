@@ -0,0 +1,74 @@
+#pragma once
+
+#include "LEDPattern.h"
+#include "metrics_bus.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace leds {
+
+// Live sensor dashboard fed by the in-process metrics bus (no MQTT round trip).
+// The message knob selects up to four series: comma-separated "metric[@label][:warn[:alarm]]", e.g.
+// "co2:1000:1500,temperature@environment:78:85". With several entries the display cycles between them
+// (speed sets the dwell time).
+// - Grids: latest value in font6x6 on the top 8 rows (scrolling if wider than the panel) and, with at
+//   least 12 rows, a sparkline of recent samples below that scrolls left as samples arrive.
+// - Single-row strips: a level bar.
+// Color follows the thresholds: configured color below warn, amber at warn, red at alarm (if warn > alarm
+// the scale is inverted, i.e. low values are bad). Redraws only when a new sample arrives or the text
+// scrolls, within one frame of the sample; update() does not allocate.
+class DashboardPattern final : public LEDPattern {
+public:
+    const char* name() const override { return "DASHBOARD"; }
+    void reset(LEDStrip& strip, uint64_t now_us) override;
+    void update(LEDStrip& strip, uint64_t now_us) override;
+
+    void set_solid_color(uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) override;
+    void set_brightness_percent(int brightness_percent) override;
+    void set_speed_percent(int speed_percent) override;
+    void set_start_string(const char* spec) override;
+
+private:
+    struct Entry {
+        char metric[32] = {};
+        char label[metrics_bus::kLabelLen] = {};
+        bool has_warn = false, has_alarm = false;
+        float warn = 0.0f, alarm = 0.0f;
+        const metrics_bus::Series* series = nullptr;
+    };
+    static constexpr size_t kMaxEntries = 4;
+
+    // 0 = normal, 1 = warn, 2 = alarm
+    int level_for(const Entry& e, float v) const;
+    void color_for(int level, uint8_t& r, uint8_t& g, uint8_t& b, uint8_t& w) const;
+    // Refresh hist_ / text_ from the current entry's series; returns true if anything changed
+    bool refresh_samples(uint64_t now_us);
+    void render(LEDStrip& strip);
+    void render_grid(LEDStrip& strip);
+    void render_bar(LEDStrip& strip);
+
+    std::array<Entry, kMaxEntries> entries_{};
+    size_t entry_count_ = 0;
+    size_t current_ = 0;
+    uint64_t entry_start_us_ = 0;
+    uint64_t last_lookup_us_ = 0;
+    uint32_t seen_seq_ = 0;
+
+    // Snapshot of the current series, oldest first
+    std::array<float, metrics_bus::kHistory> hist_{};
+    size_t hist_len_ = 0;
+    bool have_value_ = false;
+    char text_[16] = {};
+    int text_px_ = 0;
+
+    int scroll_px_ = 0;
+    uint64_t last_scroll_us_ = 0;
+    bool needs_render_ = true;
+
+    uint8_t r_ = 0, g_ = 160, b_ = 0, w_ = 0;
+    int brightness_percent_ = 100;
+    int speed_percent_ = 50;
+};
+
+} // namespace leds
@@ -35,23 +35,28 @@ void FadePattern::update(LEDStrip& strip, uint64_t now_us) {
     const float gamma = 2.2f;
     tg = powf(tg, 1.0f / gamma);
 
-    auto lerp_u8 = [](uint8_t a, uint8_t b, float u) -> uint8_t {
-        float af = static_cast<float>(a);
-        float bf = static_cast<float>(b);
+    // Interpolate at 16-bit precision so slow fades between nearby dim levels do not step
+    auto lerp_u16 = [](uint8_t a, uint8_t b, float u) -> uint16_t {
+        float af = static_cast<float>(widen_u8(a));
+        float bf = static_cast<float>(widen_u8(b));
         float vf = af + (bf - af) * u;
         if (vf < 0.0f) {
             vf = 0.0f;
         }
-        if (vf > 255.0f) {
-            vf = 255.0f;
+        if (vf > 65535.0f) {
+            vf = 65535.0f;
         }
-        return static_cast<uint8_t>(vf + 0.5f);
+        return static_cast<uint16_t>(vf + 0.5f);
     };
 
-    uint8_t r = lerp_u8(start_r_, target_r_, tg);
-    uint8_t g = lerp_u8(start_g_, target_g_, tg);
-    uint8_t b = lerp_u8(start_b_, target_b_, tg);
-    uint8_t w = lerp_u8(start_w_, target_w_, tg);
+    uint16_t r16 = lerp_u16(start_r_, target_r_, tg);
+    uint16_t g16 = lerp_u16(start_g_, target_g_, tg);
+    uint16_t b16 = lerp_u16(start_b_, target_b_, tg);
+    uint16_t w16 = lerp_u16(start_w_, target_w_, tg);
+    uint8_t r = narrow_u16(r16);
+    uint8_t g = narrow_u16(g16);
+    uint8_t b = narrow_u16(b16);
+    uint8_t w = narrow_u16(w16);
 
     // Fade brightness duty between start and target as well, matching SolidPattern spacing:
     // - brightness <= 0  : all OFF
@@ -70,7 +75,7 @@ void FadePattern::update(LEDStrip& strip, uint64_t now_us) {
     }
     if (bp >= 100) {
         for (size_t i = 0; i < strip.length(); ++i) {
-            strip.set_pixel(i, r, g, b, w);
+            strip.set_pixel16(i, r16, g16, b16, w16);
         }
         last_out_r_ = r; last_out_g_ = g; last_out_b_ = b; last_out_w_ = w;
         last_out_brightness_percent_ = 100;
@@ -86,7 +91,7 @@ void FadePattern::update(LEDStrip& strip, uint64_t now_us) {
         return;
     }
     if (on_count >= total) {
-        for (size_t i = 0; i < total; ++i) strip.set_pixel(i, r, g, b, w);
+        for (size_t i = 0; i < total; ++i) strip.set_pixel16(i, r16, g16, b16, w16);
         last_out_r_ = r; last_out_g_ = g; last_out_b_ = b; last_out_w_ = w;
         last_out_brightness_percent_ = 100;
         return;
@@ -97,7 +102,7 @@ void FadePattern::update(LEDStrip& strip, uint64_t now_us) {
         acc += on_count;
         bool on = false;
         if (acc >= total) { on = true; acc -= total; }
-        if (on) strip.set_pixel(i, r, g, b, w);
+        if (on) strip.set_pixel16(i, r16, g16, b16, w16);
         else strip.set_pixel(i, 0, 0, 0, 0);
     }
     // last_out_* tracks the representative ON color
@@ -2,7 +2,6 @@
 #include "LEDStrip.h"
 #include "esp_random.h"
 #include <algorithm>
-#include <cmath>
 
 namespace leds {
 
@@ -68,25 +67,33 @@ void FireworksPattern::ensure_rocket(uint64_t now_us) {
     }
 }
 
+// Elapsed time as Q16 seconds (one division per frame instead of one per coordinate)
+static inline q16_t dt_seconds(uint64_t dt_us) {
+    if (dt_us > 10'000'000ull) dt_us = 10'000'000ull;
+    return static_cast<q16_t>((dt_us << 16) / 1'000'000u);
+}
+
 void FireworksPattern::spawn_rocket(uint64_t now_us) {
     rocket_.active = true;
     rocket_.start_us = now_us;
     rocket_.last_us = now_us;
 
     uint32_t r = esp_random();
-    float bottom = static_cast<float>(major_len_ - 1);
+    q16_t bottom = static_cast<q16_t>(major_len_ - 1) * kQ16One;
     rocket_.u = bottom;
-    rocket_.minor = static_cast<float>(r % minor_len_);
+    rocket_.minor = static_cast<q16_t>(r % minor_len_) * kQ16One;
 
     // Upward velocity so rocket reaches near top in ~40% of its lifetime
-    float life_s = static_cast<float>(lifetime_us()) / 1'000'000.0f;
-    float flight_s = life_s * 0.4f;
-    if (flight_s <= 0.1f) flight_s = 0.1f;
-    rocket_.vu = -bottom / flight_s;
+    int64_t life_us = static_cast<int64_t>(lifetime_us());
+    int64_t flight_us = life_us * 4 / 10;
+    if (flight_us <= 100000) flight_us = 100000;
+    rocket_.vu = static_cast<q16_t>(-static_cast<int64_t>(bottom) * 1'000'000 / flight_us);
 
-    // Small lateral motion
-    float dir = (r & 1u) ? 1.0f : -1.0f;
-    rocket_.vminor = dir * (static_cast<float>((r >> 8) & 0xFF) / 255.0f) * (static_cast<float>(minor_len_) / life_s) * 0.1f;
+    // Small lateral motion: up to 10% of the minor axis per lifetime
+    int64_t dir = (r & 1u) ? 1 : -1;
+    int64_t jitter = (r >> 8) & 0xFF; // 0..255
+    rocket_.vminor = static_cast<q16_t>(dir * jitter * static_cast<int64_t>(minor_len_) * kQ16One * 1'000'000 /
+                                        (255 * 10 * life_us));
 
     last_launch_us_ = now_us;
 }
@@ -111,17 +118,18 @@ void FireworksPattern::explode_rocket(uint64_t now_us) {
         default: num_sparks = 24; break;          // ring: default density
     }
 
-    float dur_s = static_cast<float>(duration_seconds_ <= 0 ? 5 : duration_seconds_);
+    int32_t dur_s = duration_seconds_ <= 0 ? 5 : duration_seconds_;
     // Randomize explosion size by varying base_speed
-    float size_jitter = static_cast<float>((rnd >> 8) & 0xFF) / 255.0f; // 0..1
-    float size_scale = 0.4f + size_jitter * 1.2f; // 0.4x .. 1.6x
-    float base_speed = (static_cast<float>(major_len_) / (dur_s * 1.5f)) * size_scale;
+    q16_t size_jitter = static_cast<q16_t>(((rnd >> 8) & 0xFF) * kQ16One / 255); // 0..1
+    q16_t size_scale = q16_const(0.4) + q16_mul(size_jitter, q16_const(1.2)); // 0.4x .. 1.6x
+    // major_len / (dur * 1.5) cells per second
+    q16_t base_speed = q16_mul(static_cast<q16_t>(major_len_) * kQ16One * 2 / (3 * dur_s), size_scale);
 
     // Base lifetime; individual sparks will jitter around this.
-    float life_base = dur_s * 0.6f;
+    uint32_t life_base_us = static_cast<uint32_t>(dur_s) * 600'000u;
 
-    float u0 = rocket_.u;
-    float m0 = rocket_.minor;
+    q16_t u0 = rocket_.u;
+    q16_t m0 = rocket_.minor;
 
     for (int i = 0; i < num_sparks; ++i) {
         Spark s;
@@ -132,30 +140,28 @@ void FireworksPattern::explode_rocket(uint64_t now_us) {
         s.start_us = now_us;
         s.last_us = now_us;
         // Per-spark lifetime jitter for more organic fades
-        float lj = static_cast<float>((esp_random() >> 16) & 0xFF) / 255.0f; // 0..1
-        s.life_s = life_base * (0.7f + lj * 0.6f); // ~0.7x..1.3x of base
+        uint32_t lj = (esp_random() >> 16) & 0xFF; // 0..255
+        s.life_us = static_cast<uint32_t>(static_cast<uint64_t>(life_base_us) * (700u + lj * 600u / 255u) / 1000u); // ~0.7x..1.3x of base
 
-        float angle;
+        uint16_t angle;
         if (mode == 1) {
             // Spokes: snap to a smaller set of discrete angles so rays are clear
             const int spoke_count = 8;
-            angle = static_cast<float>(i % spoke_count) *
-                    (2.0f * static_cast<float>(M_PI) / static_cast<float>(spoke_count));
+            angle = static_cast<uint16_t>((i % spoke_count) * (kAngleTurn / spoke_count));
         } else {
             // Ring / solid: uniform distribution
-            angle = static_cast<float>(i) *
-                    (2.0f * static_cast<float>(M_PI) / static_cast<float>(num_sparks));
+            angle = static_cast<uint16_t>(static_cast<uint32_t>(i) * kAngleTurn / static_cast<uint32_t>(num_sparks));
         }
 
         // Solid-ish bursts: vary speed radially for a filled effect
-        float speed = base_speed;
+        q16_t speed = base_speed;
         if (mode == 2) {
-            float sj = static_cast<float>((esp_random() >> 8) & 0xFF) / 255.0f; // 0..1
-            speed *= (0.4f + sj * 1.4f); // wide spread of radii
+            q16_t sj = static_cast<q16_t>(((esp_random() >> 8) & 0xFF) * kQ16One / 255); // 0..1
+            speed = q16_mul(speed, q16_const(0.4) + q16_mul(sj, q16_const(1.4))); // wide spread of radii
         }
 
-        s.vu = std::sin(angle) * speed;
-        s.vminor = std::cos(angle) * speed;
+        s.vu = q16_mul(q16_sin(angle), speed);
+        s.vminor = q16_mul(q16_cos(angle), speed);
 
         // Color and mode
         s.r = base_r_;
@@ -170,14 +176,13 @@ void FireworksPattern::explode_rocket(uint64_t now_us) {
 
 void FireworksPattern::update_rocket(uint64_t now_us) {
     if (!rocket_.active) return;
-    float dt = static_cast<float>(now_us - rocket_.last_us) / 1'000'000.0f;
-    if (dt < 0.0f) dt = 0.0f;
+    q16_t dt = dt_seconds((now_us > rocket_.last_us) ? (now_us - rocket_.last_us) : 0);
     rocket_.last_us = now_us;
 
-    rocket_.u += rocket_.vu * dt;
-    rocket_.minor += rocket_.vminor * dt;
+    rocket_.u += q16_mul(rocket_.vu, dt);
+    rocket_.minor += q16_mul(rocket_.vminor, dt);
 
-    float apex = static_cast<float>(major_len_) * 0.3f;
+    q16_t apex = static_cast<q16_t>(major_len_) * kQ16One * 3 / 10;
     uint64_t max_flight_us = lifetime_us() / 2;
     if (rocket_.u <= apex || (rocket_.last_us - rocket_.start_us) >= max_flight_us) {
         explode_rocket(now_us);
@@ -185,37 +190,34 @@ void FireworksPattern::update_rocket(uint64_t now_us) {
 }
 
 void FireworksPattern::update_sparks(uint64_t now_us) {
-    float life_scale = static_cast<float>(brightness_percent_) / 100.0f;
-    if (life_scale <= 0.0f) {
+    if (brightness_percent_ <= 0) {
         sparks_.clear();
         return;
     }
 
     for (auto& s : sparks_) {
         if (!s.active && s.start_us == 0) continue;
-        float dt = static_cast<float>(now_us - s.last_us) / 1'000'000.0f;
-        if (dt < 0.0f) dt = 0.0f;
+        q16_t dt = dt_seconds((now_us > s.last_us) ? (now_us - s.last_us) : 0);
         s.last_us = now_us;
 
         // For "rain" explosions, apply a simple gravity so sparks arc up then fall.
         if (s.mode == 4) {
-            float dur_s = static_cast<float>(duration_seconds_ <= 0 ? 5 : duration_seconds_);
+            int32_t dur_s = duration_seconds_ <= 0 ? 5 : duration_seconds_;
             // Gravity tuned so that sparks fall back toward the ground over their lifetime.
-            float g = (static_cast<float>(major_len_) / (dur_s * dur_s)) * 2.0f;
-            s.vu += g * dt;
+            q16_t g = static_cast<q16_t>(major_len_) * kQ16One * 2 / (dur_s * dur_s);
+            s.vu += q16_mul(g, dt);
         }
 
-        s.u += s.vu * dt;
-        s.minor += s.vminor * dt;
+        s.u += q16_mul(s.vu, dt);
+        s.minor += q16_mul(s.vminor, dt);
     }
 
     // Remove dead sparks
     sparks_.erase(
         std::remove_if(sparks_.begin(), sparks_.end(),
                        [now_us](const Spark& s) {
-                           float elapsed_s = static_cast<float>(now_us - s.start_us) / 1'000'000.0f;
                            // Also cull once they've lived their life
-                           return elapsed_s >= s.life_s;
+                           return (now_us - s.start_us) >= s.life_us;
                        }),
         sparks_.end());
 }
@@ -224,18 +226,19 @@ void FireworksPattern::render(LEDStrip& strip) {
     size_t length = strip.length();
     if (length == 0) return;
 
-    // Accumulate contributions additively into a temporary buffer, then write once.
-    std::vector<float> acc_r(length, 0.0f);
-    std::vector<float> acc_g(length, 0.0f);
-    std::vector<float> acc_b(length, 0.0f);
+    // Accumulate contributions additively (8.8 fixed point per channel), then write once.
+    // The buffer is kept across frames so rendering does not allocate.
+    acc_.assign(length * 3, 0u);
 
-    auto map_to_rc = [&](float u, float minor, size_t& row, size_t& col) -> bool {
+    const q16_t major_max = static_cast<q16_t>(major_len_ - 1) * kQ16One;
+    const q16_t minor_max = static_cast<q16_t>(minor_len_ - 1) * kQ16One;
+    auto map_to_rc = [&](q16_t u, q16_t minor, size_t& row, size_t& col) -> bool {
         // World is NOT a torus: treat coordinates outside [0, len) as off-screen.
-        if (u < 0.0f || u > static_cast<float>(major_len_ - 1)) return false;
-        if (minor < 0.0f || minor > static_cast<float>(minor_len_ - 1)) return false;
+        if (u < 0 || u > major_max) return false;
+        if (minor < 0 || minor > minor_max) return false;
 
-        size_t ui = static_cast<size_t>(u + 0.5f);
-        size_t mi = static_cast<size_t>(minor + 0.5f);
+        size_t ui = static_cast<size_t>((u + kQ16One / 2) >> 16);
+        size_t mi = static_cast<size_t>((minor + kQ16One / 2) >> 16);
         if (ui >= major_len_) return false;
         if (mi >= minor_len_) return false;
 
@@ -253,126 +256,92 @@ void FireworksPattern::render(LEDStrip& strip) {
         }
         return true;
     };
+    auto add = [&](q16_t u, q16_t minor, uint32_t r, uint32_t g, uint32_t b) {
+        size_t row = 0, col = 0;
+        if (!map_to_rc(u, minor, row, col)) return;
+        size_t idx = strip.index_for_row_col(row, col);
+        if (idx >= length) return;
+        uint32_t* px = &acc_[idx * 3];
+        px[0] += r;
+        px[1] += g;
+        px[2] += b;
+    };
 
-    float global_scale = static_cast<float>(brightness_percent_) / 100.0f;
-    if (global_scale < 0.0f) global_scale = 0.0f;
-    if (global_scale > 1.0f) global_scale = 1.0f;
+    q16_t global_scale = static_cast<q16_t>(std::min(std::max(brightness_percent_, 0), 100)) * kQ16One / 100;
 
     // Draw rocket as a bright head
     if (rocket_.active) {
-        size_t row = 0, col = 0;
-        if (map_to_rc(rocket_.u, rocket_.minor, row, col)) {
-            size_t idx = strip.index_for_row_col(row, col);
-            if (idx < length) {
-                float r = 255.0f * global_scale;
-                float g = 255.0f * global_scale;
-                float b = 255.0f * global_scale;
-                acc_r[idx] += r;
-                acc_g[idx] += g;
-                acc_b[idx] += b;
-            }
-        }
+        uint32_t v = static_cast<uint32_t>(255 * global_scale) >> 8;
+        add(rocket_.u, rocket_.minor, v, v, v);
     }
 
     // Draw sparks
     for (const auto& s : sparks_) {
-        float elapsed_s = static_cast<float>(s.last_us - s.start_us) / 1'000'000.0f;
-        if (elapsed_s < 0.0f || elapsed_s >= s.life_s) continue;
-        float life_frac = elapsed_s / s.life_s; // 0..1
-        float amp = (1.0f - life_frac);
-        if (amp <= 0.0f) continue;
-        float scale = amp * global_scale;
-        float r = static_cast<float>(s.r) * scale;
-        float g = static_cast<float>(s.g) * scale;
-        float b = static_cast<float>(s.b) * scale;
+        uint64_t elapsed_us = s.last_us - s.start_us;
+        if (s.last_us < s.start_us || elapsed_us >= s.life_us) continue;
+        q16_t life_frac = static_cast<q16_t>((elapsed_us << 16) / s.life_us); // 0..1
+        q16_t amp = kQ16One - life_frac;
+        if (amp <= 0) continue;
+        q16_t scale = q16_mul(amp, global_scale);
+        uint32_t r = (s.r * static_cast<uint32_t>(scale)) >> 8;
+        uint32_t g = (s.g * static_cast<uint32_t>(scale)) >> 8;
+        uint32_t b = (s.b * static_cast<uint32_t>(scale)) >> 8;
 
         if (s.mode == 1) {
             // Radiating line: draw a solid segment from origin to current position.
-            float du = s.u - s.origin_u;
-            float dm = s.minor - s.origin_minor;
-            int steps = static_cast<int>(std::max(std::fabs(du), std::fabs(dm)) + 1.0f);
-            if (steps < 1) steps = 1;
+            q16_t du = s.u - s.origin_u;
+            q16_t dm = s.minor - s.origin_minor;
+            int steps = (std::max(q16_abs(du), q16_abs(dm)) >> 16) + 1;
+            q16_t step_u = du / steps, step_m = dm / steps;
+            q16_t u = s.origin_u, m = s.origin_minor;
             for (int k = 0; k <= steps; ++k) {
-                float t = static_cast<float>(k) / static_cast<float>(steps);
-                float u = s.origin_u + du * t;
-                float m = s.origin_minor + dm * t;
-                size_t row = 0, col = 0;
-                if (!map_to_rc(u, m, row, col)) continue;
-                size_t idx = strip.index_for_row_col(row, col);
-                if (idx < length) {
-                    acc_r[idx] += r;
-                    acc_g[idx] += g;
-                    acc_b[idx] += b;
-                }
+                add(u, m, r, g, b);
+                u += step_u;
+                m += step_m;
             }
         } else if (s.mode == 3) {
             // Concentric circles: multiple rings around the origin that expand and fade over time.
             const int ring_count = 3;
             const int samples_per_ring = 32;
-            float max_radius = static_cast<float>(major_len_) * 0.4f;
-            if (max_radius < 1.0f) max_radius = 1.0f;
+            q16_t max_radius = static_cast<q16_t>(major_len_) * kQ16One * 2 / 5;
+            if (max_radius < kQ16One) max_radius = kQ16One;
             // Use life_frac to drive expansion: start near center, grow to max_radius.
-            float radial_phase = 1.0f - amp; // 0 at start, 1 near end
-            if (radial_phase < 0.0f) radial_phase = 0.0f;
-            if (radial_phase > 1.0f) radial_phase = 1.0f;
+            q16_t radial_phase = q16_clamp01(kQ16One - amp); // 0 at start, 1 near end
 
             for (int ri = 0; ri < ring_count; ++ri) {
-                float ring_norm = static_cast<float>(ri + 1) / static_cast<float>(ring_count);
-                float radius = max_radius * radial_phase * ring_norm;
-                if (radius <= 0.0f) continue;
+                q16_t radius = q16_mul(max_radius, radial_phase) * (ri + 1) / ring_count;
+                if (radius <= 0) continue;
                 for (int j = 0; j < samples_per_ring; ++j) {
-                    float ang = 2.0f * static_cast<float>(M_PI) * static_cast<float>(j) / static_cast<float>(samples_per_ring);
-                    float u = s.origin_u + std::sin(ang) * radius;
-                    float m = s.origin_minor + std::cos(ang) * radius;
-                    size_t row = 0, col = 0;
-                    if (!map_to_rc(u, m, row, col)) continue;
-                    size_t idx = strip.index_for_row_col(row, col);
-                    if (idx < length) {
-                        acc_r[idx] += r;
-                        acc_g[idx] += g;
-                        acc_b[idx] += b;
-                    }
+                    uint16_t ang = static_cast<uint16_t>(j * (kAngleTurn / samples_per_ring));
+                    q16_t u = s.origin_u + q16_mul(q16_sin(ang), radius);
+                    q16_t m = s.origin_minor + q16_mul(q16_cos(ang), radius);
+                    add(u, m, r, g, b);
                 }
             }
         } else {
             // Ring / solid / rain: single spark point, with optional "twinkle" for rain.
-            size_t row = 0, col = 0;
-            if (!map_to_rc(s.u, s.minor, row, col)) continue;
-            size_t idx = strip.index_for_row_col(row, col);
-            if (idx < length) {
-                float rr = r, gg = g, bb = b;
-                if (s.mode == 4) {
-                    // Twinkle by modulating with a fast temporal sinusoid and a
-                    // per-spark spatial phase; this looks good on RGB and degrades
-                    // to on/off flicker on flip-dot.
-                    float base = (s.origin_u * 13.0f + s.origin_minor * 7.0f);
-                    float t = static_cast<float>(s.last_us - s.start_us) / 1'000'000.0f;
-                    float tw = 0.5f + 0.5f * std::sin(base * 0.15f + t * 12.0f);
-                    rr *= tw; gg *= tw; bb *= tw;
-                }
-                acc_r[idx] += rr;
-                acc_g[idx] += gg;
-                acc_b[idx] += bb;
+            uint32_t rr = r, gg = g, bb = b;
+            if (s.mode == 4) {
+                // Twinkle by modulating with a fast temporal sinusoid (12 rad/s) and a
+                // per-spark spatial phase (0.15 rad per unit); this looks good on RGB and
+                // degrades to on/off flicker on flip-dot.
+                q16_t base = s.origin_u * 13 + s.origin_minor * 7;
+                uint32_t spatial = static_cast<uint32_t>((static_cast<int64_t>(base) * 1565) >> 16);
+                uint32_t temporal = static_cast<uint32_t>(elapsed_us * 125163u / 1'000'000u);
+                q16_t tw = kQ16One / 2 + q16_sin(static_cast<uint16_t>(spatial + temporal)) / 2;
+                rr = (rr * static_cast<uint32_t>(tw)) >> 16;
+                gg = (gg * static_cast<uint32_t>(tw)) >> 16;
+                bb = (bb * static_cast<uint32_t>(tw)) >> 16;
             }
+            add(s.u, s.minor, rr, gg, bb);
         }
     }
 
     // Write accumulated buffer to strip with clamping; pixels with no contributions fade smoothly.
     for (size_t i = 0; i < length; ++i) {
-        float r = acc_r[i];
-        float g = acc_g[i];
-        float b = acc_b[i];
-        if (r < 0.0f) r = 0.0f;
-        if (g < 0.0f) g = 0.0f;
-        if (b < 0.0f) b = 0.0f;
-        if (r > 255.0f) r = 255.0f;
-        if (g > 255.0f) g = 255.0f;
-        if (b > 255.0f) b = 255.0f;
-        strip.set_pixel(i,
-                        static_cast<uint8_t>(r + 0.5f),
-                        static_cast<uint8_t>(g + 0.5f),
-                        static_cast<uint8_t>(b + 0.5f),
-                        0);
+        const uint32_t* px = &acc_[i * 3];
+        auto to_u8 = [](uint32_t v) -> uint8_t { v = (v + 128u) >> 8; return static_cast<uint8_t>(v > 255u ? 255u : v); };
+        strip.set_pixel(i, to_u8(px[0]), to_u8(px[1]), to_u8(px[2]), 0);
     }
 }
 
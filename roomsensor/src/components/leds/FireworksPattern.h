@@ -1,6 +1,7 @@
 #pragma once
 
 #include "LEDPattern.h"
+#include "LEDFixedMath.h"
 #include <cstddef>
 #include <vector>
 
@@ -22,26 +23,27 @@ public:
     void set_solid_color(uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) override;
 
 private:
+    // Coordinates are Q16 cells, velocities Q16 cells per second
     struct Rocket {
-        float u = 0.0f;      // vertical coordinate along major axis
-        float minor = 0.0f;  // horizontal/secondary coordinate
-        float vu = 0.0f;     // vertical speed
-        float vminor = 0.0f; // horizontal speed
+        q16_t u = 0;      // vertical coordinate along major axis
+        q16_t minor = 0;  // horizontal/secondary coordinate
+        q16_t vu = 0;     // vertical speed
+        q16_t vminor = 0; // horizontal speed
         uint64_t start_us = 0;
         uint64_t last_us = 0;
         bool active = false;
     };
 
     struct Spark {
-        float u = 0.0f;
-        float minor = 0.0f;
-        float vu = 0.0f;
-        float vminor = 0.0f;
-        float origin_u = 0.0f;
-        float origin_minor = 0.0f;
+        q16_t u = 0;
+        q16_t minor = 0;
+        q16_t vu = 0;
+        q16_t vminor = 0;
+        q16_t origin_u = 0;
+        q16_t origin_minor = 0;
         uint64_t start_us = 0;
         uint64_t last_us = 0;
-        float life_s = 0.0f;
+        uint32_t life_us = 0;
         uint8_t r = 255, g = 200, b = 120;
         uint8_t mode = 0; // 0=ring, 1=spokes, 2=solid
         bool active = true;
@@ -60,6 +62,7 @@ private:
 
     Rocket rocket_;
     std::vector<Spark> sparks_;
+    std::vector<uint32_t> acc_; // per-pixel RGB accumulator for render()
     uint64_t last_launch_us_ = 0;
     uint8_t last_explosion_mode_ = 0; // for diagnostics if needed
 
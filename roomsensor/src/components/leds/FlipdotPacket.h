@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace leds { namespace flipdot {
+
+// Bit-packed flipdot wire protocol (chip FLIPDOT_PACKED).
+//
+// Dots travel in chain order, the order FlipdotGridMapper lays them out, so 64 consecutive dots make up
+// one 8x8 module ("box"). A box is 8 bytes: byte j holds box positions 8j..8j+7, LSB first, and a set bit
+// means the dot shows its bright side (the legacy FLIPDOT encoding sends it as channel value 0).
+//
+// One packet per transmission; the line idles low for at least kMinGapUs between packets. Little-endian:
+//   0  u8   kMagic
+//   1  u8   kVersion
+//   2  u8   flags: kFlagFull => the records are boxes 0..count-1 without box indices (keyframe)
+//   3  u8   sequence number (increments per packet)
+//   4  u16  record count
+//   6  u16  total boxes on the chain
+//   8  records: [u16 box index] (omitted when kFlagFull) + 8 bitmap bytes
+//   .. u16  CRC-16/CCITT-FALSE over all preceding bytes
+// Bits are clocked MSB first with WS2812 symbol timing, so a packet costs 1.25 us per bit on the wire.
+
+static constexpr uint8_t kMagic = 0xFD;
+static constexpr uint8_t kVersion = 1;
+static constexpr uint8_t kFlagFull = 0x01;
+static constexpr size_t kHeaderBytes = 8;
+static constexpr size_t kCrcBytes = 2;
+static constexpr size_t kBoxDots = 64;
+static constexpr size_t kBoxBytes = 8;
+static constexpr uint32_t kMinGapUs = 80;
+
+inline size_t boxes_for_dots(size_t dots) { return (dots + kBoxDots - 1) / kBoxDots; }
+
+// Largest packet for a chain of 'boxes' modules: a keyframe (indices are only sent when that is smaller).
+inline size_t max_packet_bytes(size_t boxes) { return kHeaderBytes + boxes * kBoxBytes + kCrcBytes; }
+
+inline uint16_t crc16_ccitt(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF) {
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (int b = 0; b < 8; ++b) crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+    }
+    return crc;
+}
+
+inline void put_u16(uint8_t* p, uint16_t v) { p[0] = static_cast<uint8_t>(v); p[1] = static_cast<uint8_t>(v >> 8); }
+inline uint16_t get_u16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+
+// Build a packet from packed box bitmaps ('bitmaps' = boxes * kBoxBytes). Boxes whose bitmap equals
+// 'previous' are skipped unless 'full' is set or 'previous' is null; a dirty set that would not be smaller
+// than a keyframe is sent as one. Returns the packet length, or 0 if nothing changed.
+// 'out' must hold max_packet_bytes(boxes).
+inline size_t encode_packet(const uint8_t* bitmaps, const uint8_t* previous, size_t boxes, bool full, uint8_t seq,
+                            uint8_t* out) {
+    size_t dirty = 0;
+    if (!full && previous) {
+        for (size_t b = 0; b < boxes; ++b) {
+            if (memcmp(bitmaps + b * kBoxBytes, previous + b * kBoxBytes, kBoxBytes) != 0) ++dirty;
+        }
+        if (dirty == 0) return 0;
+        full = (dirty * (kBoxBytes + 2) >= boxes * kBoxBytes);
+    } else {
+        full = true;
+    }
+
+    uint8_t* p = out + kHeaderBytes;
+    if (full) {
+        memcpy(p, bitmaps, boxes * kBoxBytes);
+        p += boxes * kBoxBytes;
+    } else {
+        for (size_t b = 0; b < boxes; ++b) {
+            const uint8_t* bm = bitmaps + b * kBoxBytes;
+            if (memcmp(bm, previous + b * kBoxBytes, kBoxBytes) == 0) continue;
+            put_u16(p, static_cast<uint16_t>(b));
+            memcpy(p + 2, bm, kBoxBytes);
+            p += 2 + kBoxBytes;
+        }
+    }
+    out[0] = kMagic;
+    out[1] = kVersion;
+    out[2] = full ? kFlagFull : 0;
+    out[3] = seq;
+    put_u16(out + 4, static_cast<uint16_t>(full ? boxes : dirty));
+    put_u16(out + 6, static_cast<uint16_t>(boxes));
+    size_t body = static_cast<size_t>(p - out);
+    put_u16(p, crc16_ccitt(out, body));
+    return body + kCrcBytes;
+}
+
+// Reference decoder for receiver firmware: applies packets to a chain of 'boxes' bitmaps it owns.
+class PacketDecoder {
+public:
+    enum class Result { OK, BAD_LENGTH, BAD_HEADER, BAD_CRC, BAD_BOX };
+
+    PacketDecoder(uint8_t* bitmaps, size_t boxes) : bitmaps_(bitmaps), boxes_(boxes) {}
+
+    // On anything but OK the frame is left untouched; a receiver should then wait for the next keyframe
+    // (or the next update of the affected boxes).
+    Result apply(const uint8_t* pkt, size_t len) {
+        if (len < kHeaderBytes + kCrcBytes) return Result::BAD_LENGTH;
+        if (pkt[0] != kMagic || pkt[1] != kVersion) return Result::BAD_HEADER;
+        if (crc16_ccitt(pkt, len - kCrcBytes) != get_u16(pkt + len - kCrcBytes)) return Result::BAD_CRC;
+        bool full = (pkt[2] & kFlagFull) != 0;
+        size_t count = get_u16(pkt + 4);
+        if (get_u16(pkt + 6) != boxes_) return Result::BAD_BOX;
+        size_t rec = full ? kBoxBytes : kBoxBytes + 2;
+        if (kHeaderBytes + count * rec + kCrcBytes != len) return Result::BAD_LENGTH;
+        if (full && count != boxes_) return Result::BAD_BOX;
+        const uint8_t* p = pkt + kHeaderBytes;
+        for (size_t i = 0; i < count; ++i, p += rec) {
+            if (!full && get_u16(p) >= boxes_) return Result::BAD_BOX;
+        }
+        p = pkt + kHeaderBytes;
+        for (size_t i = 0; i < count; ++i, p += rec) {
+            size_t box = full ? i : get_u16(p);
+            memcpy(bitmaps_ + box * kBoxBytes, full ? p : p + 2, kBoxBytes);
+        }
+        last_seq_ = pkt[3];
+        return Result::OK;
+    }
+
+    // Dot state by chain index
+    bool dot(size_t chain_index) const {
+        return (bitmaps_[chain_index / 8] >> (chain_index % 8)) & 1u;
+    }
+    uint8_t last_sequence() const { return last_seq_; }
+
+private:
+    uint8_t* bitmaps_;
+    size_t boxes_;
+    uint8_t last_seq_ = 0;
+};
+
+} } // namespace leds::flipdot
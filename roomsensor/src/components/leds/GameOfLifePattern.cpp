@@ -22,14 +22,14 @@ GameOfLifePattern::Hash256 GameOfLifePattern::compute_state_hash() const {
     h.x[1] = 0xbb67ae8584caa73bULL;
     h.x[2] = 0x3c6ef372fe94f82bULL;
     h.x[3] = 0xa54ff53a5f1d36f1ULL;
-    const size_t n = current_.size();
+    const auto& words = ca_.words();
+    const size_t n = words.size();
     uint64_t lane = 0;
     for (size_t i = 0; i < n; ++i) {
-        uint64_t bit = static_cast<uint64_t>(current_[i] & 1u);
-        // spread bit with index-dependent rotation
-        uint64_t mix = (bit ? 0x9e3779b97f4a7c15ULL : 0ULL) ^ (static_cast<uint64_t>(i) * 0x9e3779b97f4a7c15ULL);
+        // spread each 32-cell word with index-dependent rotation
+        uint64_t mix = (static_cast<uint64_t>(words[i]) * 0x9e3779b97f4a7c15ULL) ^ (static_cast<uint64_t>(i + 1) * 0xc2b2ae3d27d4eb4fULL);
         uint32_t r = static_cast<uint32_t>((i * 13u) & 63u);
-        mix = (mix << r) | (mix >> (64 - r));
+        mix = (mix << r) | (mix >> ((64 - r) & 63));
         h.x[lane] ^= mix;
         // avalanche per step
         h.x[lane] *= 0xbf58476d1ce4e5b9ULL;
@@ -149,8 +149,7 @@ bool GameOfLifePattern::apply_rle_seed(const char* rle, size_t rows, size_t cols
             size_t rr = off_r + r;
             size_t cc = off_c + c;
             if (rr < rows && cc < cols) {
-                size_t idx = cc * rows + rr;
-                current_[idx] = live ? 1 : 0;
+                ca_.set_state(rr, cc, live ? 1 : 0);
             }
             ++c;
         }
@@ -248,11 +247,12 @@ void GameOfLifePattern::reset(LEDStrip& strip, uint64_t now_us) {
     if (life_cfg.has_start()) start_string_ = life_cfg.start();
     else start_string_.clear();
     last_life_generation_ = life_cfg.generation();
+    if (life_cfg.has_rule()) rule_string_ = life_cfg.rule();
+    else rule_string_.clear();
+    wrap_ = life_cfg.wrap();
     const size_t rows = strip.rows();
     const size_t cols = strip.cols();
-    const size_t total = rows * cols;
-    current_.assign(total, 0);
-    next_.assign(total, 0);
+    configure_automaton(rows, cols);
     generation_count_ = 0;
     steady_reported_ = false;
     // Allocate ring buffers in SPI RAM on first use
@@ -273,10 +273,9 @@ void GameOfLifePattern::reset(LEDStrip& strip, uint64_t now_us) {
         // Blinker: three cells in a row away from edges, near top-left area
         size_t r = rows / 2; // middle row
         size_t c = 2;        // a bit away from left edge
-        auto idx_of = [rows](size_t rr, size_t cc){ return cc * rows + rr; };
-        current_[idx_of(r, c - 1)] = 1;
-        current_[idx_of(r, c    )] = 1;
-        current_[idx_of(r, c + 1)] = 1;
+        ca_.set_state(r, c - 1, 1);
+        ca_.set_state(r, c, 1);
+        ca_.set_state(r, c + 1, 1);
     } else {
         // RANDOM - seed from provided numeric seed (if any), else current time
         uint32_t seed;
@@ -305,7 +304,9 @@ void GameOfLifePattern::update(LEDStrip& strip, uint64_t now_us) {
         if (life_cfg.has_start()) start_string_ = life_cfg.start();
         else start_string_.clear();
         last_life_generation_ = life_cfg.generation();
-        if (allow_restart) {
+        // A different rule or edge mode cannot continue the current state meaningfully
+        bool rule_changed = (life_cfg.has_rule() ? life_cfg.rule().view() : std::string_view()) != rule_string_ || life_cfg.wrap() != wrap_;
+        if (allow_restart || rule_changed) {
             reset(strip, now_us);
             render_current(strip);
             return;
@@ -330,10 +331,8 @@ void GameOfLifePattern::update(LEDStrip& strip, uint64_t now_us) {
     const size_t rows = strip.rows();
     const size_t cols = strip.cols();
     if (rows == 0 || cols == 0) return;
-    const size_t total = rows * cols;
-    if (current_.size() != total) {
-        current_.assign(total, 0);
-        next_.assign(total, 0);
+    if (ca_.rows() != rows || ca_.cols() != cols) {
+        configure_automaton(rows, cols);
         prev1_.clear();
         prev2_.clear();
         uint64_t t = esp_timer_get_time();
@@ -342,34 +341,22 @@ void GameOfLifePattern::update(LEDStrip& strip, uint64_t now_us) {
         randomize_state(rows, cols, seed);
     }
 
-    // Evolve using toroidal wrap-around
-    auto idx_of = [rows, cols](size_t r, size_t c) -> size_t { return c * rows + r; };
-    for (size_t r = 0; r < rows; ++r) {
-        for (size_t c = 0; c < cols; ++c) {
-            unsigned n = count_live_neighbors(rows, cols, r, c);
-            uint8_t alive = current_[idx_of(r, c)];
-            uint8_t next_alive = 0;
-            if (alive) {
-                // Survives with 2 or 3 neighbors
-                next_alive = (n == 2 || n == 3) ? 1 : 0;
-            } else {
-                // Birth with exactly 3 neighbors
-                next_alive = (n == 3) ? 1 : 0;
-            }
-            next_[idx_of(r, c)] = next_alive;
-        }
-    }
+    // Evolve one generation (bit-sliced; edges per life.wrap)
+    // Copy into a member buffer: the three history buffers rotate, so this reuses capacity, no allocation
+    step_before_.assign(ca_.words().begin(), ca_.words().end());
+    ca_.step();
+    const std::vector<uint32_t>& after = ca_.words();
 
     // Detect repeats and extinct states in RANDOM mode; re-seed if extinct or after 10s of repetition
-    bool any_alive = std::any_of(next_.begin(), next_.end(), [](uint8_t v){ return v != 0; });
+    bool any_alive = ca_.any_nonzero();
     // Check for repeating next state (period 1 or 2), regardless of mode for metrics purposes
-    bool eq1 = (!prev1_.empty() && prev1_.size() == next_.size() && std::equal(next_.begin(), next_.end(), prev1_.begin()));
-    bool eq2 = (!prev2_.empty() && prev2_.size() == next_.size() && std::equal(next_.begin(), next_.end(), prev2_.begin()));
+    bool eq1 = (!prev1_.empty() && prev1_ == after);
+    bool eq2 = (!prev2_.empty() && prev2_ == after);
     bool repeating_next_any_mode = eq1 || eq2;
 
     // On first time we detect a steady condition (extinction or repetition), publish metrics
     if (!steady_reported_ && (!any_alive || repeating_next_any_mode)) {
-        uint32_t gens_to_report = generation_count_ + 1; // next_ would be applied next
+        uint32_t gens_to_report = generation_count_ + 1; // generation just computed
         ESP_LOGI(TAG, "life steady detected after %u generations", (unsigned)gens_to_report);
         publish_life_complete_json(gens_to_report, initial_seed_, simple_mode_, 0);
         report_generations_metric(gens_to_report);
@@ -413,10 +400,9 @@ void GameOfLifePattern::update(LEDStrip& strip, uint64_t now_us) {
             }
         }
 
-        // Shift history: prev2_ <- prev1_, prev1_ <- current, then current <- next
-        prev2_ = prev1_;
-        prev1_ = current_;
-        current_.swap(next_);
+        // Shift history: prev2_ <- prev1_, prev1_ <- state before this step
+        prev2_.swap(prev1_);
+        prev1_.swap(step_before_);
         generation_count_++;
 
         // Cycle detection using 256-bit hash and 100-slot circular buffer
@@ -466,58 +452,77 @@ void GameOfLifePattern::update(LEDStrip& strip, uint64_t now_us) {
     render_current(strip);
 }
 
-void GameOfLifePattern::randomize_state(size_t rows, size_t cols, uint32_t seed) {
-    const size_t total = rows * cols;
-    current_.assign(total, 0);
-    next_.assign(total, 0);
-    // Simple LCG
-    uint32_t x = seed ? seed : 0xA5A5A5A5u;
-    for (size_t i = 0; i < total; ++i) {
-        x = x * 1664525u + 1013904223u;
-        // Initialize ~35% alive to avoid immediate overcrowding
-        current_[i] = ((x >> 28) & 0xF) < 6 ? 1 : 0;
+void GameOfLifePattern::configure_automaton(size_t rows, size_t cols) {
+    internal::CARule rule;
+    if (!rule_string_.empty() && !internal::CARule::parse(rule_string_.c_str(), rule)) {
+        ESP_LOGW(TAG, "invalid life rule '%s'; using B3/S23", rule_string_.c_str());
+        rule = internal::CARule();
     }
+    ca_.configure(rows, cols, rule, wrap_);
+    ca_.set_track_age(true);
 }
 
-unsigned GameOfLifePattern::count_live_neighbors(size_t rows, size_t cols, size_t r, size_t c) const {
-    auto idx_of = [rows](size_t rr, size_t cc) -> size_t { return cc * rows + rr; };
-    auto wrap = [](size_t v, size_t max) -> size_t { return (v + max) % max; };
-    unsigned cnt = 0;
-    for (int dr = -1; dr <= 1; ++dr) {
-        for (int dc = -1; dc <= 1; ++dc) {
-            if (dr == 0 && dc == 0) continue;
-            size_t rr = wrap(static_cast<size_t>(static_cast<int>(r) + dr), rows);
-            size_t cc = wrap(static_cast<size_t>(static_cast<int>(c) + dc), cols);
-            cnt += current_[idx_of(rr, cc)] ? 1u : 0u;
+void GameOfLifePattern::randomize_state(size_t rows, size_t cols, uint32_t seed) {
+    ca_.clear();
+    const bool wireworld = ca_.rule().kind == internal::CARule::Kind::WIREWORLD;
+    // Simple LCG
+    uint32_t x = seed ? seed : 0xA5A5A5A5u;
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            x = x * 1664525u + 1013904223u;
+            // Initialize ~35% alive to avoid immediate overcrowding
+            bool on = ((x >> 28) & 0xF) < 6;
+            if (!on) continue;
+            if (wireworld) {
+                // Mostly conductor with a sprinkling of electron heads
+                ca_.set_state(r, c, ((x >> 20) & 0xF) == 0 ? 1 : 3);
+            } else {
+                ca_.set_state(r, c, 1);
+            }
         }
     }
-    return cnt;
 }
 
 void GameOfLifePattern::render_current(LEDStrip& strip) const {
     const size_t rows = strip.rows();
     const size_t cols = strip.cols();
-    if (rows == 0 || cols == 0) return;
-    const size_t total = rows * cols;
-    uint8_t r = base_r_, g = base_g_, b = base_b_, w = base_w_;
-    if (brightness_percent_ < 100) {
-        r = static_cast<uint8_t>((static_cast<uint16_t>(r) * brightness_percent_) / 100);
-        g = static_cast<uint8_t>((static_cast<uint16_t>(g) * brightness_percent_) / 100);
-        b = static_cast<uint8_t>((static_cast<uint16_t>(b) * brightness_percent_) / 100);
-        w = static_cast<uint8_t>((static_cast<uint16_t>(w) * brightness_percent_) / 100);
-    }
+    if (rows == 0 || cols == 0 || ca_.rows() != rows || ca_.cols() != cols) return;
+    const int bright = brightness_percent_;
+    auto scale = [bright](uint32_t v, uint32_t num, uint32_t den) -> uint8_t {
+        return static_cast<uint8_t>((v * num * static_cast<uint32_t>(bright)) / (den * 100u));
+    };
+    const internal::CARule& rule = ca_.rule();
+    const bool wireworld = rule.kind == internal::CARule::Kind::WIREWORLD;
     // Row-major logical mapping; adapter/mapper will translate to physical layout
     for (size_t row = 0; row < rows; ++row) {
         for (size_t col = 0; col < cols; ++col) {
-            size_t logical_i = col * rows + row; // current_ is column-major (col*rows + row)
             size_t physical_idx = strip.index_for_row_col(row, col);
-            if (logical_i < current_.size()) {
-                if (current_[logical_i]) {
-                    strip.set_pixel(physical_idx, r, g, b, w);
-                } else {
-                    strip.set_pixel(physical_idx, 0, 0, 0, 0);
-                }
+            uint8_t st = ca_.state(row, col);
+            if (st == 0) {
+                strip.set_pixel(physical_idx, 0, 0, 0, 0);
+                continue;
+            }
+            if (wireworld) {
+                // Classic palette: blue heads, red tails, dim amber conductors
+                if (st == 1) strip.set_pixel(physical_idx, scale(60, 1, 1), scale(120, 1, 1), scale(255, 1, 1), 0);
+                else if (st == 2) strip.set_pixel(physical_idx, scale(255, 1, 1), scale(40, 1, 1), 0, 0);
+                else strip.set_pixel(physical_idx, scale(64, 1, 1), scale(40, 1, 1), 0, 0);
+                continue;
+            }
+            if (st == 1) {
+                // Live cells start at full base color and settle to ~40% over ~48 generations unchanged
+                uint32_t age = ca_.age(row, col);
+                if (age > 48) age = 48;
+                uint32_t num = 255 - age * 3;
+                strip.set_pixel(physical_idx, scale(base_r_, num, 255), scale(base_g_, num, 255),
+                                scale(base_b_, num, 255), scale(base_w_, num, 255));
+                continue;
             }
+            // Refractory (Generations) states fade out towards death
+            uint32_t remaining = static_cast<uint32_t>(rule.states - st);
+            uint32_t den = static_cast<uint32_t>(rule.states) * 2u;
+            strip.set_pixel(physical_idx, scale(base_r_, remaining, den), scale(base_g_, remaining, den),
+                            scale(base_b_, remaining, den), scale(base_w_, remaining, den));
         }
     }
 }
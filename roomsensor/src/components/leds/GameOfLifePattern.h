@@ -1,11 +1,16 @@
 #pragma once
 
 #include "LEDPattern.h"
+#include "CellularAutomaton.h"
 #include <vector>
 #include <string>
 
 namespace leds {
 
+// Cellular automaton display. Runs Conway's Life by default; life.rule selects any outer-totalistic B/S rule,
+// multi-state Generations rules (e.g. Brian's Brain) or Wireworld, and life.wrap chooses torus or bounded
+// edges. Cells are colored by state and by how long they have held it, so stable debris dims while active
+// regions stay bright.
 class GameOfLifePattern final : public LEDPattern {
 public:
     const char* name() const override { return "LIFE"; }
@@ -40,8 +45,8 @@ private:
     StartSpec parse_start_spec() const;
     bool apply_rle_seed(const char* rle, size_t rows, size_t cols);
     void compute_rle_dimensions(const char* rle, size_t& out_width, size_t& out_height) const;
+    void configure_automaton(size_t rows, size_t cols);
     void randomize_state(size_t rows, size_t cols, uint32_t seed);
-    unsigned count_live_neighbors(size_t rows, size_t cols, size_t r, size_t c) const;
     void render_current(LEDStrip& strip) const;
     struct Hash256 { uint64_t x[4]; };
     Hash256 compute_state_hash() const;
@@ -49,10 +54,12 @@ private:
         return a.x[0] == b.x[0] && a.x[1] == b.x[1] && a.x[2] == b.x[2] && a.x[3] == b.x[3];
     }
 
-    std::vector<uint8_t> current_; // 0 or 1 per cell
-    std::vector<uint8_t> next_;
-    std::vector<uint8_t> prev1_;
-    std::vector<uint8_t> prev2_;
+    internal::CellularAutomaton ca_;
+    std::string rule_string_;  // as configured; empty => B3/S23
+    bool wrap_ = true;
+    std::vector<uint32_t> prev1_; // state words one and two generations back (period 1/2 detection)
+    std::vector<uint32_t> prev2_;
+    std::vector<uint32_t> step_before_; // state before the current step; rotates with prev1_/prev2_
     uint64_t last_step_us_ = 0;
     uint64_t repeat_start_us_ = 0;
     uint32_t generation_count_ = 0;
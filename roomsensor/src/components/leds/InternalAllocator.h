@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include "esp_heap_caps.h"
+
+// Allocator that keeps allocations in internal RAM, for buffers read from ISRs while the flash/PSRAM cache
+// may be disabled (RMT TX buffers read by the encoder during a flash write).
+// Plain malloc would move buffers above CONFIG_SPIRAM_MALLOC_ALWAYSINTERNAL into PSRAM.
+template <class T>
+class InternalAllocator {
+public:
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    template <class U>
+    struct rebind { using other = InternalAllocator<U>; };
+
+    InternalAllocator() noexcept {}
+    template <class U>
+    InternalAllocator(const InternalAllocator<U>&) noexcept {}
+
+    [[nodiscard]] pointer allocate(size_type n) {
+        if (n > max_size()) return nullptr;
+        void* p = heap_caps_malloc(n * sizeof(T), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        return static_cast<pointer>(p);
+    }
+
+    void deallocate(pointer p, size_type) noexcept {
+        heap_caps_free(p);
+    }
+
+    constexpr size_type max_size() const noexcept {
+        return std::numeric_limits<size_type>::max() / sizeof(T);
+    }
+
+    using is_always_equal = std::true_type;
+};
+
+template <class T, class U>
+constexpr bool operator==(const InternalAllocator<T>&, const InternalAllocator<U>&) noexcept { return true; }
+template <class T, class U>
+constexpr bool operator!=(const InternalAllocator<T>&, const InternalAllocator<U>&) noexcept { return false; }
+
+
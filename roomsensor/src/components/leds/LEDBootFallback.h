@@ -0,0 +1,75 @@
+#pragma once
+
+#include "LEDBootState.h"
+#include "LEDConfig.h"
+#include <cstdint>
+
+namespace leds {
+
+// The boot record's pattern and knobs for one strip, standing in for the runtime keys its configuration
+// has not set. LEDConfig keeps pattern, R/G/B/W, brightness, speed and dma out of NVS, so after a reboot
+// the configuration only has them once they arrive again over MQTT; until then an instant-on strip keeps
+// what the record says instead of dropping to OFF at the handover. A key stops falling back as soon as the
+// configuration sets it, and stays with the configuration from then on, even if it is cleared again.
+// No IDF dependencies.
+class BootFallback {
+public:
+    enum Key : uint8_t {
+        kPattern = 1 << 0,
+        kColor = 1 << 1, // R, G, B and W together, the way patterns take them
+        kBrightness = 1 << 2,
+        kSpeed = 1 << 3,
+        kDma = 1 << 4,
+        kAll = 0x1f,
+    };
+
+    BootFallback() = default;
+    explicit BootFallback(const LEDBootStrip& rec) : rec_(rec), keys_(kAll) {}
+
+    // Same physical strip as 'cfg' (the record and the configuration may list strips differently)
+    bool matches(const config::LEDConfig& cfg) const {
+        return keys_ != 0 && cfg.has_data_gpio() && cfg.data_gpio() == rec_.data_gpio;
+    }
+
+    // Drop the keys 'cfg' has set; call with the strip's configuration before reading the others
+    void settle(const config::LEDConfig& cfg) {
+        if (cfg.has_pattern()) keys_ &= ~kPattern;
+        if (cfg.has_r() || cfg.has_g() || cfg.has_b() || cfg.has_w()) keys_ &= ~kColor;
+        if (cfg.has_brightness()) keys_ &= ~kBrightness;
+        if (cfg.has_speed()) keys_ &= ~kSpeed;
+        if (cfg.has_dma()) keys_ &= ~kDma;
+    }
+
+    bool has(Key k) const { return (keys_ & k) != 0; }
+    const LEDBootStrip& record() const { return rec_; }
+
+    config::LEDConfig::Pattern pattern(const config::LEDConfig& cfg) const {
+        return has(kPattern) ? static_cast<config::LEDConfig::Pattern>(rec_.pattern) : cfg.pattern_enum();
+    }
+    bool dma(const config::LEDConfig& cfg) const {
+        return has(kDma) ? (rec_.flags & LEDBootStrip::kDma) != 0 : cfg.has_dma() && cfg.dma();
+    }
+
+    // Copy the keys still falling back into 'out', a record made from the configuration, so saving the
+    // boot state keeps them rather than the configuration's unset defaults
+    void overlay(LEDBootStrip& out) const {
+        if (has(kPattern)) out.pattern = rec_.pattern;
+        if (has(kSpeed)) out.speed = rec_.speed;
+        if (has(kColor)) {
+            out.flags = static_cast<uint8_t>((out.flags & ~LEDBootStrip::kHasColor) | (rec_.flags & LEDBootStrip::kHasColor));
+            out.r = rec_.r; out.g = rec_.g; out.b = rec_.b; out.w = rec_.w;
+        }
+        if (has(kBrightness)) {
+            out.flags = static_cast<uint8_t>((out.flags & ~LEDBootStrip::kHasBrightness) |
+                                             (rec_.flags & LEDBootStrip::kHasBrightness));
+            out.brightness = rec_.brightness;
+        }
+        if (has(kDma)) out.flags = static_cast<uint8_t>((out.flags & ~LEDBootStrip::kDma) | (rec_.flags & LEDBootStrip::kDma));
+    }
+
+private:
+    LEDBootStrip rec_{};
+    uint8_t keys_ = 0;
+};
+
+} // namespace leds
@@ -0,0 +1,190 @@
+#include "LEDBootState.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "flash_window.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "nvs.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace leds {
+
+static const char* TAG = "LEDBootState";
+static const char* kNvsNamespace = "ledboot";
+static const char* kNvsKey = "state";
+
+RTC_NOINIT_ATTR static LEDBootRecord s_rtc_record;
+
+// Last NVS copy read or written, so saves that change nothing cost no flash access. Writer task only
+// (and load_led_boot_record, before the task exists).
+static LEDBootRecord s_nvs_record;
+static bool s_nvs_record_known = false;
+
+// Latest record handed over by save_led_boot_record, taken by the writer task
+static portMUX_TYPE s_pending_lock = portMUX_INITIALIZER_UNLOCKED;
+static LEDBootRecord s_pending;
+static TaskHandle_t s_writer_task = nullptr;
+static std::atomic<bool> s_writer_claimed{false};
+
+static uint8_t clamp_u8(int v) { return static_cast<uint8_t>(std::min(255, std::max(0, v))); }
+
+LEDBootStrip LEDBootStrip::from_config(const config::LEDConfig& cfg) {
+    LEDBootStrip s;
+    memset(&s, 0, sizeof(s));
+    s.data_gpio = static_cast<int8_t>(cfg.has_data_gpio() ? cfg.data_gpio() : -1);
+    std::vector<int> pins = cfg.all_enabled_gpios();
+    for (size_t i = 0; i < kBootStateMaxEnablePins; ++i) {
+        s.enable_gpios[i] = static_cast<int8_t>(i < pins.size() ? pins[i] : -1);
+    }
+    s.chip = static_cast<uint8_t>(cfg.chip_enum());
+    s.layout = static_cast<uint8_t>(cfg.layout_enum());
+    s.pattern = static_cast<int8_t>(cfg.pattern_enum());
+    s.rows = static_cast<uint16_t>(cfg.num_rows());
+    s.cols = static_cast<uint16_t>(cfg.num_columns());
+    s.segment_rows = static_cast<uint16_t>(cfg.has_segment_rows() ? cfg.segment_rows() : 0);
+    if (cfg.has_current_limit() && cfg.current_limit_ma() > 0) {
+        s.current_limit_ma = static_cast<uint16_t>(std::min(cfg.current_limit_ma(), 65535));
+    }
+    if (cfg.has_dma() && cfg.dma()) s.flags |= kDma;
+    s.speed = clamp_u8(cfg.has_speed() ? cfg.speed() : 50);
+    if (cfg.has_r() || cfg.has_g() || cfg.has_b() || cfg.has_w()) {
+        s.flags |= kHasColor;
+        s.r = clamp_u8(cfg.has_r() ? cfg.r() : 0);
+        s.g = clamp_u8(cfg.has_g() ? cfg.g() : 0);
+        s.b = clamp_u8(cfg.has_b() ? cfg.b() : 0);
+        s.w = clamp_u8(cfg.has_w() ? cfg.w() : 0);
+    }
+    if (cfg.has_brightness()) {
+        s.flags |= kHasBrightness;
+        s.brightness = clamp_u8(cfg.brightness());
+    }
+    if (cfg.has_message()) {
+        s.flags |= kHasMessage;
+        strncpy(s.message, cfg.message().c_str(), sizeof(s.message) - 1);
+    }
+    return s;
+}
+
+bool LEDBootStrip::valid() const {
+    using config::LEDConfig;
+    return LEDConfig::is_valid(static_cast<LEDConfig::Chip>(chip)) &&
+           LEDConfig::is_valid(static_cast<LEDConfig::Layout>(layout)) &&
+           LEDConfig::is_valid(static_cast<LEDConfig::Pattern>(pattern)) && rows > 0 && cols > 0;
+}
+
+static uint32_t record_crc(const LEDBootRecord& rec) {
+    return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&rec), offsetof(LEDBootRecord, crc));
+}
+
+static bool record_valid(const LEDBootRecord& rec) {
+    if (rec.magic != LEDBootRecord::kMagic || rec.version != LEDBootRecord::kVersion ||
+        rec.count > kBootStateMaxStrips || rec.crc != record_crc(rec)) {
+        return false;
+    }
+    for (size_t i = 0; i < rec.count; ++i) {
+        if (!rec.strips[i].valid()) return false;
+    }
+    return true;
+}
+
+static esp_err_t read_nvs_record(LEDBootRecord& out) {
+    nvs_handle_t h;
+    esp_err_t err = nvs_open(kNvsNamespace, NVS_READONLY, &h);
+    if (err != ESP_OK) return err;
+    size_t len = sizeof(out);
+    err = nvs_get_blob(h, kNvsKey, &out, &len);
+    nvs_close(h);
+    if (err != ESP_OK) return err;
+    if (len != sizeof(out) || !record_valid(out)) return ESP_ERR_INVALID_CRC;
+    return ESP_OK;
+}
+
+esp_err_t load_led_boot_record(LEDBootRecord& out, const char** source) {
+    if (record_valid(s_rtc_record)) {
+        out = s_rtc_record;
+        if (source) *source = "rtc";
+        return ESP_OK;
+    }
+    esp_err_t err = read_nvs_record(out);
+    if (err == ESP_OK) {
+        s_nvs_record = out;
+        s_nvs_record_known = true;
+        if (source) *source = "nvs";
+        return ESP_OK;
+    }
+    if (err != ESP_ERR_NVS_NOT_FOUND) {
+        ESP_LOGW(TAG, "NVS boot record unusable: %s", esp_err_to_name(err));
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+static esp_err_t write_nvs_record(const LEDBootRecord& rec) {
+    if (!s_nvs_record_known) {
+        s_nvs_record_known = (read_nvs_record(s_nvs_record) == ESP_OK);
+    }
+    // No padding anywhere, so the bytes (CRC included) compare exactly
+    if (s_nvs_record_known && memcmp(&s_nvs_record, &rec, sizeof(rec)) == 0) return ESP_OK;
+
+    flash_window::Scope flash;
+    nvs_handle_t h;
+    esp_err_t err = nvs_open(kNvsNamespace, NVS_READWRITE, &h);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(h, kNvsKey, &rec, sizeof(rec));
+        if (err == ESP_OK) err = nvs_commit(h);
+        nvs_close(h);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to persist boot record: %s", esp_err_to_name(err));
+        return err;
+    }
+    s_nvs_record = rec;
+    s_nvs_record_known = true;
+    ESP_LOGI(TAG, "Persisted boot record for %u strips", (unsigned)rec.count);
+    return ESP_OK;
+}
+
+static void boot_record_writer_task(void*) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // Wait for the changes to settle; every further save restarts the wait
+        while (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(kBootStateSettleMs)) != 0) {}
+        LEDBootRecord rec;
+        taskENTER_CRITICAL(&s_pending_lock);
+        rec = s_pending;
+        taskEXIT_CRITICAL(&s_pending_lock);
+        (void)write_nvs_record(rec);
+    }
+}
+
+esp_err_t save_led_boot_record(LEDBootRecord& rec) {
+    rec.magic = LEDBootRecord::kMagic;
+    rec.version = LEDBootRecord::kVersion;
+    rec.crc = record_crc(rec);
+    s_rtc_record = rec;
+
+    taskENTER_CRITICAL(&s_pending_lock);
+    s_pending = rec;
+    TaskHandle_t writer = s_writer_task;
+    taskEXIT_CRITICAL(&s_pending_lock);
+    if (!writer) {
+        // The first save creates the writer. A save racing it only needs its record in s_pending: the
+        // writer reads that after the settle wait.
+        if (s_writer_claimed.exchange(true)) return ESP_OK;
+        if (xTaskCreatePinnedToCore(&boot_record_writer_task, "ledboot", 3072, nullptr, tskIDLE_PRIORITY + 1,
+                                    &writer, tskNO_AFFINITY) != pdPASS) {
+            ESP_LOGW(TAG, "Failed to create boot record writer; NVS copy not updated");
+            s_writer_claimed.store(false);
+            return ESP_ERR_NO_MEM;
+        }
+        taskENTER_CRITICAL(&s_pending_lock);
+        s_writer_task = writer;
+        taskEXIT_CRITICAL(&s_pending_lock);
+    }
+    xTaskNotifyGive(writer);
+    return ESP_OK;
+}
+
+} // namespace leds
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "LEDConfig.h"
+#include "esp_err.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace leds {
+
+// Compact record of what the strips show: geometry, chip, pattern and its knobs. LEDManager lights the
+// strips from it early in boot (LEDManager::start_from_boot_state) and hands over to the loaded
+// configuration once it is available.
+//
+// Two copies:
+// - RTC memory (RTC_NOINIT), rewritten on every applied change. Survives software resets (OTA reboot,
+//   panic, esp_restart) but not power loss. No flash writes.
+// - NVS blob, rewritten whenever any stored field differs from it, so a cold boot starts from the same
+//   record as a warm one. The write runs on a low-priority task, never on the LED update task, and only
+//   once changes have been quiet for kBootStateSettleMs, so a burst of knob changes costs one write.
+constexpr size_t kBootStateMaxStrips = 8;
+constexpr size_t kBootStateMaxEnablePins = 4;
+constexpr size_t kBootStateMessageLen = 48;
+constexpr uint32_t kBootStateSettleMs = 5000;
+
+struct LEDBootStrip {
+    int8_t data_gpio;
+    int8_t enable_gpios[kBootStateMaxEnablePins]; // -1 => unused
+    uint8_t chip;          // config::LEDConfig::Chip
+    uint8_t layout;        // config::LEDConfig::Layout
+    int8_t pattern;        // config::LEDConfig::Pattern
+    uint16_t rows;
+    uint16_t cols;
+    uint16_t segment_rows;
+    uint16_t current_limit_ma; // 0 => unlimited; applied open loop until the configuration takes over
+    uint8_t flags;         // k* bits below
+    uint8_t speed;
+    uint8_t r, g, b, w;
+    uint8_t brightness;
+    uint8_t reserved;      // keeps the layout free of padding, so the CRC covers defined bytes only
+    char message[kBootStateMessageLen];
+
+    static constexpr uint8_t kDma = 1 << 0;
+    static constexpr uint8_t kHasColor = 1 << 1;
+    static constexpr uint8_t kHasBrightness = 1 << 2;
+    static constexpr uint8_t kHasMessage = 1 << 3;
+
+    static LEDBootStrip from_config(const config::LEDConfig& cfg);
+    // chip, layout and pattern name enumerators LEDConfig still has, and the geometry is not empty.
+    // kVersion covers the layout of this struct, not the numbering of those enums.
+    bool valid() const;
+};
+
+struct LEDBootRecord {
+    static constexpr uint32_t kMagic = 0x4C424F54; // "LBOT"
+    static constexpr uint16_t kVersion = 1; // bump when the fields change; enum values are checked on load
+
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    LEDBootStrip strips[kBootStateMaxStrips];
+    uint32_t crc; // CRC-32 of everything above
+};
+static_assert(sizeof(LEDBootStrip) == 72, "LEDBootStrip must not contain padding");
+static_assert(sizeof(LEDBootRecord) == 8 + kBootStateMaxStrips * sizeof(LEDBootStrip) + 4,
+              "LEDBootRecord must not contain padding");
+
+// RTC copy if valid, otherwise the NVS copy. 'source' receives "rtc" or "nvs".
+// ESP_ERR_NOT_FOUND when neither holds a valid record.
+esp_err_t load_led_boot_record(LEDBootRecord& out, const char** source = nullptr);
+
+// Update the RTC copy now and queue the NVS copy for the writer task, which skips the write when the
+// stored blob already matches. Cheap enough for the LED update task.
+esp_err_t save_led_boot_record(LEDBootRecord& rec);
+
+} // namespace leds
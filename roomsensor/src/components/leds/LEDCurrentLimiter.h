@@ -0,0 +1,188 @@
+#pragma once
+
+#include "PowerManager.h"
+#include "LEDConfig.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace leds {
+
+// Per-chip supply current model: draw at full drive for each channel plus idle draw per pixel.
+// Values are typical datasheet figures at the rail voltage the chip is normally run from.
+struct ChipCurrentModel {
+    float ma_full[4] = {0, 0, 0, 0}; // R, G, B, W at 255
+    float ma_idle = 0.0f;            // per pixel, all channels off
+
+    static ChipCurrentModel for_chip(config::LEDConfig::Chip chip) {
+        ChipCurrentModel m;
+        switch (chip) {
+            case config::LEDConfig::Chip::WS2812:
+                m.ma_full[0] = 12.0f; m.ma_full[1] = 12.0f; m.ma_full[2] = 12.0f; m.ma_idle = 0.6f; // 5V
+                break;
+            case config::LEDConfig::Chip::SK6812:
+                m.ma_full[0] = 12.0f; m.ma_full[1] = 12.0f; m.ma_full[2] = 12.0f; m.ma_full[3] = 18.0f; m.ma_idle = 1.0f; // 5V RGBW
+                break;
+            case config::LEDConfig::Chip::WS2814:
+                // 12/24V segments: constant-current channels shared by a series string of emitters
+                m.ma_full[0] = 10.0f; m.ma_full[1] = 10.0f; m.ma_full[2] = 10.0f; m.ma_full[3] = 10.0f; m.ma_idle = 0.8f;
+                break;
+            default:
+                break;
+        }
+        return m;
+    }
+
+    // Estimated draw in mA for a frame at unity scale.
+    float estimate_ma(const FrameView& f) const {
+        if (!f.rgba) return 0.0f;
+        size_t n = f.rows * f.cols;
+        uint32_t sum[4] = {0, 0, 0, 0};
+        for (size_t i = 0; i < n; ++i) {
+            const uint8_t* px = f.rgba + i * 4;
+            sum[0] += px[0]; sum[1] += px[1]; sum[2] += px[2]; sum[3] += px[3];
+        }
+        float ma = ma_idle * static_cast<float>(n);
+        for (int c = 0; c < 4; ++c) ma += ma_full[c] * (static_cast<float>(sum[c]) / 255.0f);
+        return ma;
+    }
+};
+
+// Automatic brightness limiter holding a strip's supply current under a configured budget.
+// - Open loop: estimates current each frame from the (pre-scale) pixel sums and the chip model.
+// - Closed loop (optional): when a measured rail current is supplied, a slowly adapting gain corrects
+//   the model for rail voltage, chip batch and other loads sharing the rail.
+// - Output is a global scale in Q16 (65535 = unity). It drops quickly when over budget to protect the
+//   supply, and recovers gradually so the limiting is not visible as pumping.
+// Pure logic with no IDF dependencies so it can be exercised on the host with synthetic frames.
+class CurrentLimiter {
+public:
+    static constexpr uint32_t kUnity = 65535;
+
+    void configure(const ChipCurrentModel& model, float budget_ma) {
+        model_ = model;
+        budget_ma_ = budget_ma;
+    }
+    bool enabled() const { return budget_ma_ > 0.0f; }
+
+    // Estimated draw in mA for a frame at unity scale.
+    float estimate_ma(const FrameView& f) const { return model_.estimate_ma(f); }
+
+    // Feed a measured rail current sampled at 'sample_us'. Only call when a new sample is available. The
+    // prediction uses the estimate and scale update() applied to the frame on display at that time, not
+    // the current ones. Returns false when the sample is ignored: near-dark frame, or older than the
+    // kHistory frames kept.
+    bool on_measurement(float measured_ma, uint64_t sample_us) {
+        const Applied* a = applied_at(sample_us);
+        if (!a) return false;
+        float predicted = a->estimate_ma * (static_cast<float>(a->scale_q16) / kUnity);
+        // Ignore near-dark frames: idle current and sensor offset dominate and the ratio is meaningless
+        if (predicted < 0.05f * budget_ma_ || measured_ma < 0.0f) return false;
+        float ratio = measured_ma / predicted;
+        if (ratio < 0.5f) ratio = 0.5f;
+        if (ratio > 2.0f) ratio = 2.0f;
+        gain_ += (ratio - gain_) * kGainAlpha;
+        return true;
+    }
+
+    // Advance the limiter to 'now_us' for a frame whose unity-scale estimate is 'frame_estimate_ma'.
+    // Returns the scale (Q16) to apply to this frame.
+    uint32_t update(float frame_estimate_ma, uint64_t now_us) {
+        float dt_s = (last_us_ == 0 || now_us <= last_us_) ? 0.0f : static_cast<float>(now_us - last_us_) / 1'000'000.0f;
+        last_us_ = now_us;
+        if (!enabled()) { scale_ = 1.0f; return kUnity; }
+
+        float predicted = frame_estimate_ma * gain_;
+        float target = (predicted > budget_ma_) ? (budget_ma_ / predicted) : 1.0f;
+        if (target < scale_) {
+            // Over budget: clamp immediately; the supply cannot wait for a ramp
+            scale_ = target;
+        } else {
+            float rise = kReleasePerSecond * dt_s;
+            scale_ = (target - scale_ > rise) ? (scale_ + rise) : target;
+        }
+        if (scale_ < 0.0f) scale_ = 0.0f;
+        if (scale_ > 1.0f) scale_ = 1.0f;
+        uint32_t q16 = static_cast<uint32_t>(scale_ * kUnity + 0.5f);
+        history_[history_next_ % kHistory] = Applied{now_us, frame_estimate_ma, q16};
+        history_next_++;
+        return q16;
+    }
+
+    float gain() const { return gain_; }
+    float budget_ma() const { return budget_ma_; }
+
+    // Updates remembered for matching measurements; 160 ms at the 5 ms LED tick with one update per tick,
+    // well over the delay between an ADC sample and the LED task picking it up. A rail with several strips
+    // (RailLimiter) records one update per strip per tick.
+    static constexpr size_t kHistory = 32;
+
+private:
+    struct Applied {
+        uint64_t at_us;
+        float estimate_ma;
+        uint32_t scale_q16;
+    };
+
+    // Newest frame applied at or before t_us, nullptr if the history does not reach back that far
+    const Applied* applied_at(uint64_t t_us) const {
+        size_t n = history_next_ < kHistory ? history_next_ : kHistory;
+        for (size_t k = 1; k <= n; ++k) {
+            const Applied& a = history_[(history_next_ - k) % kHistory];
+            if (a.at_us <= t_us) return &a;
+        }
+        return nullptr;
+    }
+
+    static constexpr float kGainAlpha = 0.25f;        // per measurement; sensor samples are seconds apart
+    static constexpr float kReleasePerSecond = 0.5f;  // full recovery from 0 in ~2s
+
+    ChipCurrentModel model_;
+    float budget_ma_ = 0.0f; // <= 0 => limiter disabled
+    float gain_ = 1.0f;      // measured / modelled
+    float scale_ = 1.0f;
+    uint64_t last_us_ = 0;
+    Applied history_[kHistory] = {};
+    size_t history_next_ = 0;
+};
+
+// One supply rail feeding one or more strips: one budget, one learned gain and one scale shared by all of
+// them, so each strip's share of the budget follows its share of the estimated draw. A sensed rail
+// measures the members' combined draw; giving each strip its own limiter would have every one of them
+// learn the combined/own ratio as its gain and over-limit.
+// Members report their unity-scale frame estimate when they render; the limiter runs on the sum of the
+// latest estimates of all members.
+class RailLimiter {
+public:
+    // Resets the learned gain
+    void configure(float budget_ma, size_t members) {
+        limiter_ = CurrentLimiter();
+        limiter_.configure(ChipCurrentModel{}, budget_ma);
+        estimates_.assign(members, 0.0f);
+    }
+    bool enabled() const { return limiter_.enabled(); }
+    size_t members() const { return estimates_.size(); }
+
+    // Member 'k' has a new frame; returns the scale (Q16) for it, which is the rail's scale at 'now_us'
+    uint32_t update(size_t k, float estimate_ma, uint64_t now_us) {
+        if (k < estimates_.size()) estimates_[k] = estimate_ma;
+        return limiter_.update(total_estimate_ma(), now_us);
+    }
+
+    // Measured rail current; see CurrentLimiter::on_measurement
+    bool on_measurement(float measured_ma, uint64_t sample_us) { return limiter_.on_measurement(measured_ma, sample_us); }
+
+    float total_estimate_ma() const {
+        float sum = 0.0f;
+        for (float e : estimates_) sum += e;
+        return sum;
+    }
+    float gain() const { return limiter_.gain(); }
+    float budget_ma() const { return limiter_.budget_ma(); }
+
+private:
+    CurrentLimiter limiter_;
+    std::vector<float> estimates_;
+};
+
+} // namespace leds
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace leds {
+
+// Q16.16 fixed-point helpers for per-frame / per-pixel animation math.
+// Replaces powf/expf/sinf/sqrtf in pattern hot loops: the tables below are evaluated by the compiler,
+// so results are bit-identical on the host and on the target and cost a table lookup plus a multiply.
+// - Values are int32_t with 16 fractional bits (kQ16One == 1.0).
+// - Angles are 16-bit binary angles: 65536 units per turn, so wrap-around is free (uint16_t overflow).
+// - Accuracy (checked against double precision in util/tests/host/test_fixed_math.cpp): sin/cos, log2 and
+//   sqrt within 2 LSB absolute; exp2/exp within 2 LSB for results <= 1 and 1e-4 relative above; pow within
+//   1% relative (or 2 LSB, whichever is larger) for results in [1e-3, 1e3]. Easing within 2 LSB of its
+//   formula; noise is exact to its formula up to the same truncation.
+using q16_t = int32_t;
+static constexpr q16_t kQ16One = 1 << 16;
+static constexpr uint32_t kAngleTurn = 1u << 16;
+
+// Compile-time conversion for constants; never use on runtime floats in a hot loop.
+static constexpr q16_t q16_const(double v) {
+    return static_cast<q16_t>(v >= 0 ? v * kQ16One + 0.5 : v * kQ16One - 0.5);
+}
+static constexpr uint16_t angle_from_radians(double rad) {
+    double turns = rad / 6.283185307179586;
+    turns -= static_cast<double>(static_cast<int64_t>(turns));
+    if (turns < 0) turns += 1.0;
+    return static_cast<uint16_t>(static_cast<uint32_t>(turns * kAngleTurn + 0.5) & 0xFFFFu);
+}
+
+static inline q16_t q16_mul(q16_t a, q16_t b) {
+    return static_cast<q16_t>((static_cast<int64_t>(a) * b) >> 16);
+}
+static inline q16_t q16_div(q16_t a, q16_t b) {
+    if (b == 0) return (a >= 0) ? INT32_MAX : INT32_MIN;
+    return static_cast<q16_t>((static_cast<int64_t>(a) << 16) / b);
+}
+static inline q16_t q16_lerp(q16_t a, q16_t b, q16_t t) { return a + q16_mul(b - a, t); }
+static inline q16_t q16_clamp01(q16_t t) { return t < 0 ? 0 : (t > kQ16One ? kQ16One : t); }
+static inline q16_t q16_abs(q16_t v) { return v < 0 ? -v : v; }
+
+namespace internal {
+
+// constexpr series used only to build the tables below
+constexpr double cx_sin(double x) {
+    double term = x, sum = x;
+    for (int n = 1; n < 12; ++n) {
+        term *= -x * x / static_cast<double>((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+constexpr double cx_exp(double x) {
+    double term = 1.0, sum = 1.0;
+    for (int n = 1; n < 24; ++n) {
+        term *= x / static_cast<double>(n);
+        sum += term;
+    }
+    return sum;
+}
+constexpr double cx_log2_1p(double m) {
+    // ln(1+m) = 2 * atanh(m / (2 + m)); m in [0, 1] keeps the series argument <= 1/3
+    double y = m / (2.0 + m), y2 = y * y, term = y, sum = 0.0;
+    for (int n = 0; n < 24; ++n) {
+        sum += term / static_cast<double>(2 * n + 1);
+        term *= y2;
+    }
+    return 2.0 * sum / 0.6931471805599453;
+}
+
+// Quarter-wave sine, 256 steps (+2 guard entries so interpolation never branches)
+constexpr std::array<q16_t, 258> make_sine_quarter() {
+    std::array<q16_t, 258> t{};
+    for (size_t i = 0; i < 258; ++i) {
+        size_t k = i > 256 ? 256 : i;
+        t[i] = q16_const(cx_sin(static_cast<double>(k) * 1.5707963267948966 / 256.0));
+    }
+    return t;
+}
+// 2^(i/256) for i in 0..256, in Q16 (65536..131072)
+constexpr std::array<uint32_t, 257> make_exp2_frac() {
+    std::array<uint32_t, 257> t{};
+    for (size_t i = 0; i < 257; ++i) {
+        t[i] = static_cast<uint32_t>(cx_exp(static_cast<double>(i) / 256.0 * 0.6931471805599453) * kQ16One + 0.5);
+    }
+    return t;
+}
+// log2(1 + i/256) for i in 0..256, in Q16 (0..65536)
+constexpr std::array<q16_t, 257> make_log2_mant() {
+    std::array<q16_t, 257> t{};
+    for (size_t i = 0; i < 257; ++i) t[i] = q16_const(cx_log2_1p(static_cast<double>(i) / 256.0));
+    return t;
+}
+
+inline constexpr std::array<q16_t, 258> kSineQuarter = make_sine_quarter();
+inline constexpr std::array<uint32_t, 257> kExp2Frac = make_exp2_frac();
+inline constexpr std::array<q16_t, 257> kLog2Mant = make_log2_mant();
+
+static inline uint32_t noise_hash(int32_t x, int32_t y, int32_t z, uint32_t seed) {
+    uint32_t h = seed ^ (static_cast<uint32_t>(x) * 0x8da6b343u) ^ (static_cast<uint32_t>(y) * 0xd8163841u) ^
+                 (static_cast<uint32_t>(z) * 0xcb1ab31fu);
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+    return h;
+}
+
+// Gradient dot products; gradients are the classic improved-Perlin sets (unnormalized, components -1/0/+1)
+static inline q16_t grad2(uint32_t h, q16_t dx, q16_t dy) {
+    switch (h & 7u) {
+        case 0: return dx + dy;
+        case 1: return -dx + dy;
+        case 2: return dx - dy;
+        case 3: return -dx - dy;
+        case 4: return dx;
+        case 5: return -dx;
+        case 6: return dy;
+        default: return -dy;
+    }
+}
+static inline q16_t grad3(uint32_t h, q16_t dx, q16_t dy, q16_t dz) {
+    switch (h & 15u) {
+        case 0: case 12: return dx + dy;
+        case 1: case 13: return -dx + dy;
+        case 2: return dx - dy;
+        case 3: return -dx - dy;
+        case 4: return dx + dz;
+        case 5: return -dx + dz;
+        case 6: return dx - dz;
+        case 7: return -dx - dz;
+        case 8: return dy + dz;
+        case 9: case 14: return -dy + dz;
+        case 10: return dy - dz;
+        default: return -dy - dz;
+    }
+}
+
+} // namespace internal
+
+// sin/cos of a binary angle, Q16 in [-1, 1]
+static inline q16_t q16_sin(uint16_t angle) {
+    uint32_t quadrant = angle >> 14;
+    uint32_t x = angle & 0x3FFFu;
+    if (quadrant & 1u) x = 0x4000u - x;
+    uint32_t idx = x >> 6, frac = x & 63u;
+    q16_t a = internal::kSineQuarter[idx];
+    q16_t v = a + (((internal::kSineQuarter[idx + 1] - a) * static_cast<q16_t>(frac)) >> 6);
+    return (quadrant & 2u) ? -v : v;
+}
+static inline q16_t q16_cos(uint16_t angle) { return q16_sin(static_cast<uint16_t>(angle + 0x4000u)); }
+
+// 2^x; saturates to INT32_MAX for x >= 15 and flushes to 0 below 2^-16
+static inline q16_t q16_exp2(q16_t x) {
+    int32_t n = x >> 16; // floor
+    uint32_t f = static_cast<uint32_t>(x) & 0xFFFFu;
+    uint32_t idx = f >> 8, frac = f & 0xFFu;
+    uint32_t a = internal::kExp2Frac[idx];
+    uint32_t m = a + (((internal::kExp2Frac[idx + 1] - a) * frac + 128u) >> 8);
+    if (n >= 0) return (n >= 15 || m > (static_cast<uint32_t>(INT32_MAX) >> n)) ? INT32_MAX : static_cast<q16_t>(m << n);
+    if (n <= -18) return 0;
+    return static_cast<q16_t>(m >> -n);
+}
+
+// log2(x) for x > 0; returns INT32_MIN for x <= 0
+static inline q16_t q16_log2(q16_t x) {
+    if (x <= 0) return INT32_MIN;
+    uint32_t ux = static_cast<uint32_t>(x);
+    int msb = 31 - __builtin_clz(ux);
+    uint32_t m; // [1, 2) in Q16
+    if (msb > 16) {
+        // Round the dropped bits: truncating them costs up to 1.4 LSB on large inputs
+        const int sh = msb - 16;
+        m = (ux + (1u << (sh - 1))) >> sh;
+        if (m >> 17) {
+            m >>= 1;
+            ++msb;
+        }
+    } else {
+        m = ux << (16 - msb);
+    }
+    uint32_t f = m - kQ16One;
+    uint32_t idx = f >> 8, frac = f & 0xFFu;
+    q16_t a = internal::kLog2Mant[idx];
+    q16_t v = a + static_cast<q16_t>(((internal::kLog2Mant[idx + 1] - a) * static_cast<q16_t>(frac) + 128) >> 8);
+    return ((msb - 16) << 16) + v;
+}
+
+// e^x and e^-x (the latter is the common Gaussian / decay falloff)
+static inline q16_t q16_exp(q16_t x) { return q16_exp2(q16_mul(x, q16_const(1.4426950408889634))); }
+static inline q16_t q16_exp_neg(q16_t x) { return q16_exp(-x); }
+
+// base^e for base > 0
+static inline q16_t q16_pow(q16_t base, q16_t e) {
+    if (base <= 0) return 0;
+    return q16_exp2(q16_mul(e, q16_log2(base)));
+}
+
+static inline uint32_t isqrt64(uint64_t v) {
+    uint64_t res = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > v) bit >>= 2;
+    while (bit != 0) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return static_cast<uint32_t>(res);
+}
+static inline q16_t q16_sqrt(q16_t x) { return x <= 0 ? 0 : static_cast<q16_t>(isqrt64(static_cast<uint64_t>(x) << 16)); }
+
+// Distance sqrt(dx^2 + dy^2) in Q16 for integer offsets given in half units (dx2 = 2 * dx), computed in 64
+// bits so long strips do not overflow; saturates at INT32_MAX (32768 units).
+static inline q16_t q16_hypot_half(int64_t dx2, int64_t dy2) {
+    const uint64_t ax = static_cast<uint64_t>(dx2 < 0 ? -dx2 : dx2);
+    const uint64_t ay = static_cast<uint64_t>(dy2 < 0 ? -dy2 : dy2);
+    // Offsets this large are far past saturation anyway; keeps the sum and the shift below in range
+    const uint64_t kMaxHalf = 1ull << 16;
+    if (ax > kMaxHalf || ay > kMaxHalf) return INT32_MAX;
+    // sqrt(sum / 4) in Q16 = sqrt(sum << 30)
+    const uint32_t d = isqrt64((ax * ax + ay * ay) << 30);
+    return d > static_cast<uint32_t>(INT32_MAX) ? INT32_MAX : static_cast<q16_t>(d);
+}
+
+// Easing curves on t in [0, 1] (clamped). The factor > 1 is multiplied in first so that the truncation of
+// each step is scaled down by the remaining factors of t, not up.
+static inline q16_t q16_ease_in_quad(q16_t t) { t = q16_clamp01(t); return q16_mul(t, t); }
+static inline q16_t q16_ease_out_quad(q16_t t) { t = q16_clamp01(t); return q16_mul(t, 2 * kQ16One - t); }
+static inline q16_t q16_ease_in_out_cubic(q16_t t) {
+    t = q16_clamp01(t);
+    if (t < kQ16One / 2) return q16_mul(t, q16_mul(t, 4 * t));
+    q16_t u = 2 * kQ16One - 2 * t;
+    return kQ16One - q16_mul(u, q16_mul(u, u)) / 2;
+}
+static inline q16_t q16_smoothstep(q16_t t) {
+    t = q16_clamp01(t);
+    return q16_mul(t, q16_mul(t, 3 * kQ16One - 2 * t));
+}
+static inline q16_t q16_smootherstep(q16_t t) {
+    t = q16_clamp01(t);
+    // Quintic with a factor up to 10: evaluated in 64 bits (Q24 * Q24) so only the final shift truncates
+    const int64_t x = t;
+    const int64_t inner = x * (6 * x - 15 * kQ16One) + (static_cast<int64_t>(10 * kQ16One) << 16); // Q32
+    return static_cast<q16_t>(((x * x * x) >> 24) * (inner >> 8) >> 32);
+}
+
+// Gradient noise (improved Perlin with hashed lattice, no permutation table) at Q16 coordinates.
+// Output is roughly in [-1, 1], continuous with continuous first derivative; 'seed' selects the field.
+static inline q16_t q16_noise2(q16_t x, q16_t y, uint32_t seed = 0) {
+    int32_t xi = x >> 16, yi = y >> 16;
+    q16_t xf = x & 0xFFFF, yf = y & 0xFFFF;
+    q16_t u = q16_smootherstep(xf), v = q16_smootherstep(yf);
+    using internal::grad2;
+    using internal::noise_hash;
+    q16_t n00 = grad2(noise_hash(xi, yi, 0, seed), xf, yf);
+    q16_t n10 = grad2(noise_hash(xi + 1, yi, 0, seed), xf - kQ16One, yf);
+    q16_t n01 = grad2(noise_hash(xi, yi + 1, 0, seed), xf, yf - kQ16One);
+    q16_t n11 = grad2(noise_hash(xi + 1, yi + 1, 0, seed), xf - kQ16One, yf - kQ16One);
+    return q16_lerp(q16_lerp(n00, n10, u), q16_lerp(n01, n11, u), v);
+}
+static inline q16_t q16_noise3(q16_t x, q16_t y, q16_t z, uint32_t seed = 0) {
+    int32_t xi = x >> 16, yi = y >> 16, zi = z >> 16;
+    q16_t xf = x & 0xFFFF, yf = y & 0xFFFF, zf = z & 0xFFFF;
+    q16_t u = q16_smootherstep(xf), v = q16_smootherstep(yf), w = q16_smootherstep(zf);
+    using internal::grad3;
+    using internal::noise_hash;
+    q16_t n000 = grad3(noise_hash(xi, yi, zi, seed), xf, yf, zf);
+    q16_t n100 = grad3(noise_hash(xi + 1, yi, zi, seed), xf - kQ16One, yf, zf);
+    q16_t n010 = grad3(noise_hash(xi, yi + 1, zi, seed), xf, yf - kQ16One, zf);
+    q16_t n110 = grad3(noise_hash(xi + 1, yi + 1, zi, seed), xf - kQ16One, yf - kQ16One, zf);
+    q16_t n001 = grad3(noise_hash(xi, yi, zi + 1, seed), xf, yf, zf - kQ16One);
+    q16_t n101 = grad3(noise_hash(xi + 1, yi, zi + 1, seed), xf - kQ16One, yf, zf - kQ16One);
+    q16_t n011 = grad3(noise_hash(xi, yi + 1, zi + 1, seed), xf, yf - kQ16One, zf - kQ16One);
+    q16_t n111 = grad3(noise_hash(xi + 1, yi + 1, zi + 1, seed), xf - kQ16One, yf - kQ16One, zf - kQ16One);
+    q16_t x00 = q16_lerp(n000, n100, u), x10 = q16_lerp(n010, n110, u);
+    q16_t x01 = q16_lerp(n001, n101, u), x11 = q16_lerp(n011, n111, u);
+    return q16_lerp(q16_lerp(x00, x10, v), q16_lerp(x01, x11, v), w);
+}
+
+// Scale an 8-bit channel by a Q16 factor in [0, 1] with rounding
+static inline uint8_t q16_scale_u8(uint8_t c, q16_t f) {
+    uint32_t v = (static_cast<uint32_t>(c) * static_cast<uint32_t>(q16_clamp01(f)) + 32768u) >> 16;
+    return static_cast<uint8_t>(v > 255u ? 255u : v);
+}
+
+} // namespace leds
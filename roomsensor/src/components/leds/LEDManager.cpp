@@ -1,4 +1,5 @@
 #include "LEDManager.h"
+#include "LEDBootState.h"
 #include "LEDStripRmt.h"
 #include "LEDPattern.h"
 #include "LEDStripSurfaceAdapter.h"
@@ -6,6 +7,10 @@
 #include "LEDWireEncoderSK6812.h"
 #include "LEDWireEncoderWS2814.h"
 #include "LEDWireEncoderFlipdot.h"
+#include "LEDWireEncoderFlipdotPacked.h"
+#include "RmtSharedChannel.h"
+#include "RmtSchedule.h"
+#include "flash_window.h"
 #include "LEDCoordinateMapperRowMajor.h"
 #include "LEDCoordinateMapperSerpentineRow.h"
 #include "LEDCoordinateMapperSerpentineColumn.h"
@@ -29,12 +34,17 @@
 #include "CrossFadePattern.h"
 #include "FireworksPattern.h"
 #include "MarqueePattern.h"
+#include "DashboardPattern.h"
 #include "PowerManager.h"
+#include "LEDCurrentLimiter.h"
+#include "rail_current.h"
 // Calendar pattern forward include added later
 #include "ConfigurationManager.h"
 #include "LEDConfig.h"
 #include "esp_timer.h"
+#include "esp_cpu.h"
 #include "esp_log.h"
+#include "esp_system.h"
 #include "debug.h"
 #include <algorithm>
 #include <cstring>
@@ -48,28 +58,137 @@ LEDManager::LEDManager() = default;
 LEDManager::~LEDManager() = default;
 
 
-// Helper to apply common runtime knobs to a pattern from config
-static inline void apply_runtime_knobs(leds::LEDPattern& pat, const config::LEDConfig& cfg) {
-    pat.set_speed_percent(cfg.has_speed() ? cfg.speed() : 50);
-    if (cfg.has_r() || cfg.has_g() || cfg.has_b() || cfg.has_w()) {
-        pat.set_solid_color(cfg.has_r() ? cfg.r() : 0,
-                            cfg.has_g() ? cfg.g() : 0,
-                            cfg.has_b() ? cfg.b() : 0,
-                            cfg.has_w() ? cfg.w() : 0);
+LEDManager::PatternKnobs LEDManager::PatternKnobs::from_config(const config::LEDConfig& cfg) {
+    PatternKnobs k;
+    k.speed = cfg.has_speed() ? cfg.speed() : 50;
+    k.has_color = cfg.has_r() || cfg.has_g() || cfg.has_b() || cfg.has_w();
+    if (k.has_color) {
+        k.r = cfg.has_r() ? cfg.r() : 0;
+        k.g = cfg.has_g() ? cfg.g() : 0;
+        k.b = cfg.has_b() ? cfg.b() : 0;
+        k.w = cfg.has_w() ? cfg.w() : 0;
     }
-    if (cfg.has_brightness()) pat.set_brightness_percent(cfg.brightness());
-    if (cfg.has_message()) pat.set_start_string(cfg.message().c_str());
+    k.has_brightness = cfg.has_brightness();
+    k.brightness = cfg.brightness();
+    k.has_message = cfg.has_message();
+    if (k.has_message) k.message = cfg.message();
+    return k;
 }
 
+LEDManager::PatternKnobs LEDManager::PatternKnobs::from_record(const LEDBootStrip& b) {
+    PatternKnobs k;
+    k.speed = b.speed;
+    k.has_color = (b.flags & LEDBootStrip::kHasColor) != 0;
+    k.r = b.r; k.g = b.g; k.b = b.b; k.w = b.w;
+    k.has_brightness = (b.flags & LEDBootStrip::kHasBrightness) != 0;
+    k.brightness = b.brightness;
+    k.has_message = (b.flags & LEDBootStrip::kHasMessage) != 0;
+    if (k.has_message) k.message.assign(b.message, strnlen(b.message, sizeof(b.message)));
+    return k;
+}
+
+// Apply common runtime knobs to a pattern
+void LEDManager::PatternKnobs::apply(leds::LEDPattern& pat) const {
+    pat.set_speed_percent(speed);
+    if (has_color) pat.set_solid_color(r, g, b, w);
+    if (has_brightness) pat.set_brightness_percent(brightness);
+    if (has_message) pat.set_start_string(message.c_str());
+}
+
+
+LEDManager::StripSpec LEDManager::StripSpec::from_config(const config::LEDConfig& cfg) {
+    StripSpec sp;
+    sp.data_gpio = cfg.data_gpio();
+    sp.enable_gpios = cfg.all_enabled_gpios();
+    sp.chip = cfg.chip_enum();
+    sp.layout = cfg.layout_enum();
+    sp.rows = static_cast<size_t>(cfg.num_rows());
+    sp.cols = static_cast<size_t>(cfg.num_columns());
+    sp.segment_rows = static_cast<size_t>(cfg.has_segment_rows() ? cfg.segment_rows() : 0);
+    sp.dma = cfg.has_dma() && cfg.dma();
+    return sp;
+}
 
 esp_err_t LEDManager::init(config::ConfigurationManager& cfg_manager) {
-    cfg_manager_ = &cfg_manager;
-    if (cfg_manager_ == nullptr) {
-        ESP_LOGE(TAG, "LEDManager init requires a ConfigurationManager instance");
-        return ESP_FAIL;
+    if (update_task_) {
+        // Running from the boot record: the update loop adopts the configuration on its next tick
+        ESP_LOGI(TAG, "Handing instant-on strips over to the configuration");
+        cfg_manager_.store(&cfg_manager);
+        return ESP_OK;
     }
+    cfg_manager_.store(&cfg_manager);
     ESP_LOGI(TAG, "Initializing LEDManager");
     refresh_configuration(cfg_manager);
+    return start_tasks();
+}
+
+esp_err_t LEDManager::start_from_boot_state() {
+    if (update_task_) return ESP_ERR_INVALID_STATE;
+    // The last pattern may be what brought the device down: wait for the configuration instead
+    const esp_reset_reason_t reason = esp_reset_reason();
+    if (reason == ESP_RST_PANIC || reason == ESP_RST_INT_WDT || reason == ESP_RST_TASK_WDT || reason == ESP_RST_WDT) {
+        ESP_LOGW(TAG, "Instant-on skipped after reset reason %d", (int)reason);
+        return ESP_ERR_INVALID_STATE;
+    }
+    uint64_t t0 = esp_timer_get_time();
+    LEDBootRecord rec;
+    const char* source = "";
+    if (load_led_boot_record(rec, &source) != ESP_OK || rec.count == 0) return ESP_ERR_NOT_FOUND;
+
+    std::vector<StripSpec> specs;
+    for (size_t i = 0; i < rec.count; ++i) {
+        const LEDBootStrip& b = rec.strips[i];
+        StripSpec sp;
+        sp.data_gpio = b.data_gpio;
+        for (int8_t pin : b.enable_gpios) {
+            if (pin >= 0) sp.enable_gpios.push_back(pin);
+        }
+        sp.chip = static_cast<LEDConfig::Chip>(b.chip);
+        sp.layout = static_cast<LEDConfig::Layout>(b.layout);
+        sp.rows = b.rows;
+        sp.cols = b.cols;
+        sp.segment_rows = b.segment_rows;
+        sp.dma = (b.flags & LEDBootStrip::kDma) != 0;
+        specs.push_back(std::move(sp));
+    }
+    // No clear frame: after a software reset the strips may still show the previous frame, and the
+    // pattern's first frame replaces it directly
+    std::vector<size_t> built = build_strips(specs, false);
+    for (size_t i = 0; i < built.size(); ++i) {
+        const LEDBootStrip& b = rec.strips[built[i]];
+        LEDConfig::Pattern pat = static_cast<LEDConfig::Pattern>(b.pattern);
+        patterns_.push_back(create_pattern(pat));
+        PatternKnobs::from_record(b).apply(*patterns_.back());
+        last_patterns_.push_back(pat);
+        // Open loop until the configuration brings the sensed rail, if any
+        if (b.current_limit_ma > 0) {
+            current_limits_[i].model = ChipCurrentModel::for_chip(specs[built[i]].chip);
+            current_limits_[i].budget_ma = static_cast<float>(b.current_limit_ma);
+        }
+    }
+    rebuild_current_rails();
+    if (strips_.empty()) return ESP_FAIL;
+    on_boot_state_ = true;
+    boot_fallbacks_.clear();
+    for (size_t i = 0; i < rec.count; ++i) boot_fallbacks_.emplace_back(rec.strips[i]);
+    ESP_LOGI(TAG, "Instant-on: %u strips from %s boot record, set up in %uus", (unsigned)strips_.size(), source,
+             (unsigned)(esp_timer_get_time() - t0));
+    return start_tasks();
+}
+
+esp_err_t LEDManager::start_tasks() {
+    // Pattern switches are prepared on a lower-priority task; if it cannot be created, switches fall
+    // back to constructing the pattern inline on the update loop.
+    prepare_requests_ = xQueueCreate(4, sizeof(PrepareJob*));
+    prepare_results_ = xQueueCreate(4, sizeof(PrepareJob*));
+    if (prepare_requests_ && prepare_results_) {
+        BaseType_t pok = xTaskCreatePinnedToCore(
+            &LEDManager::PrepareTaskEntry, "led-prepare", 6144, this, prepare_task_priority_, &prepare_task_, update_task_core_);
+        if (pok != pdPASS) {
+            ESP_LOGW(TAG, "Failed to create LED prepare task; pattern switches will run inline");
+            prepare_task_ = nullptr;
+        }
+    }
     // Create update task pinned to APP core with a small stack and low priority
     BaseType_t ok = xTaskCreatePinnedToCore(
         &LEDManager::UpdateTaskEntry, "led-update", 6144, this, update_task_priority_, &update_task_, update_task_core_);
@@ -84,20 +203,7 @@ esp_err_t LEDManager::init(config::ConfigurationManager& cfg_manager) {
 void LEDManager::refresh_configuration(config::ConfigurationManager& cfg_manager) {
     // Build strips array from active LED configs (clean slate)
     std::vector<LEDConfig*> active = cfg_manager.active_leds();
-    strips_.clear();
-    patterns_.clear();
-    power_mgrs_.clear();
-    prev_frames_rgba_.clear();
-    scratch_frames_rgba_.clear();
-    last_layouts_.clear();
-    last_patterns_.clear();
-    last_enable_pins_.clear();
-    frames_tx_counts_.assign(active.size(), 0);
-    last_generations_.assign(active.size(), 0);
-    last_power_enabled_.assign(active.size(), false);
-    power_on_hold_until_us_.assign(active.size(), 0);
-    strips_.reserve(active.size());
-    patterns_.reserve(active.size());
+    on_boot_state_ = false;
 
     ESP_LOGI(TAG, "Config refresh: %zu active strips", active.size());
     for (LEDConfig* c : active) {
@@ -122,68 +228,183 @@ void LEDManager::refresh_configuration(config::ConfigurationManager& cfg_manager
                  c->has_pattern() ? c->pattern().c_str() : "<unset>");
     }
 
+    std::vector<StripSpec> specs;
+    specs.reserve(active.size());
+    for (LEDConfig* c : active) {
+        specs.push_back(StripSpec::from_config(*c));
+        if (BootFallback* fb = boot_fallback(*c)) specs.back().dma = fb->dma(*c);
+    }
+    std::vector<size_t> built = build_strips(specs, true);
+
+    std::vector<LEDConfig*> built_cfgs;
+    for (size_t idx : built) {
+        LEDConfig* c = active[idx];
+        patterns_.push_back(create_pattern_from_config(*c));
+        last_patterns_.push_back(desired_pattern(*c));
+        built_cfgs.push_back(c);
+    }
+
+    // Initial pattern application
+    uint64_t now = esp_timer_get_time();
+    for (size_t i = 0; i < strips_.size(); ++i) {
+        if (i < built_cfgs.size()) {
+            apply_pattern_updates_from_config(i, *built_cfgs[i], now);
+            apply_current_limit_from_config(i, *built_cfgs[i]);
+        }
+    }
+    save_boot_state(cfg_manager);
+}
+
+std::vector<size_t> LEDManager::build_strips(const std::vector<StripSpec>& specs, bool prime_clear) {
+    strips_.clear();
+    shared_channels_.clear();
+    patterns_.clear();
+    power_mgrs_.clear();
+    current_limits_.clear();
+    current_rails_.clear();
+    transitions_.clear();
+    // Any prepare still in flight targets the old strip set; its result is discarded on arrival
+    prepare_tracker_.reset(specs.size());
+    prev_frames_rgba_.clear();
+    scratch_frames_rgba_.clear();
+    last_layouts_.clear();
+    last_patterns_.clear();
+    last_enable_pins_.clear();
+    frames_tx_counts_.assign(specs.size(), 0);
+    render_cycles_window_.assign(specs.size(), RenderCycles());
+    last_generations_.assign(specs.size(), 0);
+    last_power_enabled_.assign(specs.size(), false);
+    power_on_hold_until_us_.assign(specs.size(), 0);
+    strips_.reserve(specs.size());
+    patterns_.reserve(specs.size());
+
     // Determine which strip should use DMA without reordering strips.
     // Priority: explicit config (first with dma=true), otherwise the longest strip.
     size_t selected_dma_idx = static_cast<size_t>(-1);
-    for (size_t i = 0; i < active.size(); ++i) {
-        if (active[i]->has_dma() && active[i]->dma()) { selected_dma_idx = i; break; }
+    for (size_t i = 0; i < specs.size(); ++i) {
+        if (specs[i].dma) { selected_dma_idx = i; break; }
     }
     if (selected_dma_idx == static_cast<size_t>(-1)) {
         size_t longest_len = 0;
-        for (size_t i = 0; i < active.size(); ++i) {
-            size_t len = static_cast<size_t>(active[i]->num_columns() * active[i]->num_rows());
+        for (size_t i = 0; i < specs.size(); ++i) {
+            size_t len = specs[i].rows * specs[i].cols;
             if (len > longest_len) { longest_len = len; selected_dma_idx = i; }
         }
     }
 
+    std::vector<leds::internal::RmtSharedChannel*> shared_for;
+    plan_shared_channels(specs, selected_dma_idx, shared_for);
+
     // Build strips in the same order as provided by the configuration
-    std::vector<LEDConfig*> built_cfgs;
-    for (size_t i = 0; i < active.size(); ++i) {
-        LEDConfig* c = active[i];
+    std::vector<size_t> built;
+    for (size_t i = 0; i < specs.size(); ++i) {
+        const StripSpec& sp = specs[i];
         bool use_dma = (i == selected_dma_idx);
-        size_t rows = static_cast<size_t>(c->num_rows());
-        size_t cols = static_cast<size_t>(c->num_columns());
-        auto chip = c->chip_enum();
-        std::unique_ptr<LEDStrip> s = create_strip(*c, use_dma);
+        size_t rows = sp.rows;
+        size_t cols = sp.cols;
+        auto chip = sp.chip;
+        std::unique_ptr<LEDStrip> s = create_strip(sp, use_dma, shared_for[i]);
         if (!s) {
-            ESP_LOGE(TAG, "Failed to create strip on GPIO %d (dma=%d)", c->data_gpio(), (int)use_dma);
+            ESP_LOGE(TAG, "Failed to create strip on GPIO %d (dma=%d)", sp.data_gpio, (int)use_dma);
             continue;
         }
-        // Prime hardware with a clear frame to establish known state
-        s->clear();
-        s->flush_if_dirty(esp_timer_get_time(), 0);
+        if (prime_clear) {
+            // Prime hardware with a clear frame to establish known state
+            s->clear();
+            s->flush_if_dirty(esp_timer_get_time(), 0);
+        }
         // Install power manager by chip type
-        if (chip == config::LEDConfig::Chip::FLIPDOT) power_mgrs_.push_back(std::unique_ptr<PowerManager>(new FlipDotPower()));
+        if (config::LEDConfig::is_flipdot(chip)) power_mgrs_.push_back(std::unique_ptr<PowerManager>(new FlipDotPower()));
         else power_mgrs_.push_back(std::unique_ptr<PowerManager>(new LedPower()));
+        current_limits_.emplace_back();
+        transitions_.emplace_back();
         prev_frames_rgba_.emplace_back(rows * cols * 4, 0);
         scratch_frames_rgba_.emplace_back(rows * cols * 4, 0);
         strips_.push_back(std::move(s));
-        patterns_.push_back(create_pattern_from_config(*c));
-        last_layouts_.push_back(c->layout_enum());
-        last_patterns_.push_back(c->pattern_enum());
-        last_enable_pins_.push_back(c->all_enabled_gpios());
-        built_cfgs.push_back(c);
+        last_layouts_.push_back(sp.layout);
+        last_enable_pins_.push_back(sp.enable_gpios);
+        built.push_back(i);
     }
+    return built;
+}
 
-    // Initial pattern application
-    uint64_t now = esp_timer_get_time();
-    for (size_t i = 0; i < strips_.size(); ++i) {
-        if (i < built_cfgs.size()) apply_pattern_updates_from_config(i, *built_cfgs[i], now);
+void LEDManager::save_boot_state(config::ConfigurationManager& cfg_manager) {
+    LEDBootRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    for (LEDConfig* c : cfg_manager.active_leds()) {
+        if (!c || rec.count >= kBootStateMaxStrips) break;
+        LEDBootStrip& b = rec.strips[rec.count++];
+        b = LEDBootStrip::from_config(*c);
+        if (BootFallback* fb = boot_fallback(*c)) fb->overlay(b);
+    }
+    (void)save_led_boot_record(rec);
+}
+
+void LEDManager::plan_shared_channels(const std::vector<StripSpec>& specs, size_t dma_idx,
+                                      std::vector<leds::internal::RmtSharedChannel*>& shared_for) {
+    using namespace leds::internal;
+    shared_for.assign(specs.size(), nullptr);
+    if (specs.size() <= kRmtTxChannels) return;
+
+    // The DMA strip and chips with their own RMT encoder keep a channel each; the rest share what is left
+    std::vector<size_t> shareable;
+    std::vector<uint32_t> slots;
+    size_t dedicated = 0;
+    for (size_t i = 0; i < specs.size(); ++i) {
+        WireEncoderShared::Format fmt;
+        if (i == dma_idx || !WireEncoderShared::format_for(specs[i].chip, fmt)) {
+            ++dedicated;
+            continue;
+        }
+        size_t logical = specs[i].rows * specs[i].cols;
+        size_t physical = fmt.frame_bytes(logical) / fmt.bytes_per_pixel;
+        shareable.push_back(i);
+        slots.push_back(rmt_slot_us(physical, fmt.bytes_per_pixel * 8u));
+    }
+    if (dedicated >= kRmtTxChannels || shareable.empty()) {
+        ESP_LOGE(TAG, "%u strips need their own RMT channel; no channel left to share", (unsigned)dedicated);
+        return;
+    }
+    size_t channels = std::min(kRmtTxChannels - dedicated, shareable.size());
+    RmtChannelPlan plan = plan_rmt_channels(slots, channels, shared_channel_target_fps_);
+
+    for (size_t ch = 0; ch < channels; ++ch) {
+        RmtSharedChannel* channel = nullptr;
+        size_t members = 0;
+        for (size_t k = 0; k < shareable.size(); ++k) {
+            if (plan.channel_of[k] != ch) continue;
+            size_t i = shareable[k];
+            if (!channel) {
+                shared_channels_.emplace_back(new RmtSharedChannel(specs[i].data_gpio, 10 * 1000 * 1000, 48));
+                channel = shared_channels_.back().get();
+                if (!channel->ok()) break;
+            }
+            shared_for[i] = channel;
+            ++members;
+        }
+        ESP_LOGI(TAG, "Shared RMT channel %u: %u strips, %uus of %uus per frame at %u fps", (unsigned)ch,
+                 (unsigned)members, (unsigned)plan.load_us[ch], (unsigned)plan.budget_us,
+                 (unsigned)shared_channel_target_fps_);
+    }
+    if (!plan.fits) {
+        ESP_LOGW(TAG, "Shared RMT channels exceed the %u fps frame budget; shared strips will refresh slower",
+                 (unsigned)shared_channel_target_fps_);
     }
 }
 
-std::unique_ptr<LEDStrip> LEDManager::create_strip(const config::LEDConfig& cfg, bool use_dma) {
-    size_t rows = static_cast<size_t>(cfg.num_rows());
-    size_t cols = static_cast<size_t>(cfg.num_columns());
-    auto chip = cfg.chip_enum();
+std::unique_ptr<LEDStrip> LEDManager::create_strip(const StripSpec& spec, bool use_dma,
+                                                   leds::internal::RmtSharedChannel* shared) {
+    size_t rows = spec.rows;
+    size_t cols = spec.cols;
+    auto chip = spec.chip;
     std::unique_ptr<LEDStrip> s;
     std::unique_ptr<leds::internal::LEDCoordinateMapper> mapper;
-    switch (cfg.layout_enum()) {
+    switch (spec.layout) {
         case config::LEDConfig::Layout::SERPENTINE_ROW:
             mapper.reset(new leds::internal::SerpentineRowMapper(rows, cols));
             break;
         case config::LEDConfig::Layout::SERPENTINE_COLUMN:
-            mapper.reset(new leds::internal::SerpentineColumnMapper(rows, cols, static_cast<size_t>(cfg.has_segment_rows() ? cfg.segment_rows() : 0)));
+            mapper.reset(new leds::internal::SerpentineColumnMapper(rows, cols, spec.segment_rows));
             break;
         case config::LEDConfig::Layout::COLUMN_MAJOR:
             mapper.reset(new leds::internal::ColumnMajorMapper(rows, cols));
@@ -196,43 +417,104 @@ std::unique_ptr<LEDStrip> LEDManager::create_strip(const config::LEDConfig& cfg,
             mapper.reset(new leds::internal::RowMajorMapper(rows, cols));
             break;
     }
+    // Temporal dithering of the 16-bit pipeline only works when the strip refreshes fast enough for the
+    // alternating LSBs to average out. A strip refreshes at most once per tick, so the frame rate is the
+    // slower of its wire time and the update loop.
+    bool dither = false;
+    if (!config::LEDConfig::is_flipdot(chip)) {
+        size_t bits_per_led = (chip == config::LEDConfig::Chip::WS2812) ? 24 : 32;
+        uint32_t wire_us = leds::internal::estimate_frame_wire_time_us(rows * cols, bits_per_led);
+        uint32_t frame_us = std::max(wire_us, update_interval_us_);
+        uint32_t fps = frame_us ? 1'000'000u / frame_us : 0;
+        dither = fps >= dither_min_refresh_hz_;
+        ESP_LOGI(TAG, "Strip on GPIO %d: est. wire time %uus/frame, %u fps, temporal dither %s",
+                 spec.data_gpio, (unsigned)wire_us, (unsigned)fps, dither ? "on" : "off");
+    }
+    leds::internal::WireEncoderShared::Format shared_fmt;
+    if (shared && shared->ok() && leds::internal::WireEncoderShared::format_for(chip, shared_fmt)) {
+        // No dithering: a shared channel refreshes each strip only once per round of its members
+        LEDStripSurfaceAdapter::Params ap{spec.data_gpio, spec.enable_gpios, rows, cols, false};
+        auto enc = std::unique_ptr<leds::internal::LEDWireEncoder>(new leds::internal::WireEncoderShared(*shared, ap.gpio, shared_fmt, rows * cols));
+        s.reset(new LEDStripSurfaceAdapter(ap, std::move(mapper), std::move(enc)));
+        return s;
+    }
     switch (chip) {
         case config::LEDConfig::Chip::WS2812: {
-            LEDStripSurfaceAdapter::Params ap{cfg.data_gpio(), cfg.all_enabled_gpios(), rows, cols};
+            LEDStripSurfaceAdapter::Params ap{spec.data_gpio, spec.enable_gpios, rows, cols, dither};
             // Encoder does not manage enable pins; LEDStripSurfaceAdapter handles power control
             auto enc = std::unique_ptr<leds::internal::LEDWireEncoder>(new leds::internal::WireEncoderWS2812(ap.gpio, use_dma, 10 * 1000 * 1000, use_dma ? 256 : 48, rows * cols));
             s.reset(new LEDStripSurfaceAdapter(ap, std::move(mapper), std::move(enc)));
             break;
         }
         case config::LEDConfig::Chip::SK6812: {
-            LEDStripSurfaceAdapter::Params ap{cfg.data_gpio(), cfg.all_enabled_gpios(), rows, cols};
+            LEDStripSurfaceAdapter::Params ap{spec.data_gpio, spec.enable_gpios, rows, cols, dither};
             auto enc = std::unique_ptr<leds::internal::LEDWireEncoder>(new leds::internal::WireEncoderSK6812(ap.gpio, use_dma, 10 * 1000 * 1000, use_dma ? 256 : 48, rows * cols));
             s.reset(new LEDStripSurfaceAdapter(ap, std::move(mapper), std::move(enc)));
             break;
         }
         case config::LEDConfig::Chip::WS2814: {
-            LEDStripSurfaceAdapter::Params ap{cfg.data_gpio(), cfg.all_enabled_gpios(), rows, cols};
+            LEDStripSurfaceAdapter::Params ap{spec.data_gpio, spec.enable_gpios, rows, cols, dither};
             auto enc = std::unique_ptr<leds::internal::LEDWireEncoder>(new leds::internal::WireEncoderWS2814(ap.gpio, use_dma, 10 * 1000 * 1000, use_dma ? 256 : 48, rows * cols));
             s.reset(new LEDStripSurfaceAdapter(ap, std::move(mapper), std::move(enc)));
             break;
         }
         case config::LEDConfig::Chip::FLIPDOT: {
-            LEDStripSurfaceAdapter::Params ap{cfg.data_gpio(), cfg.all_enabled_gpios(), rows, cols};
+            LEDStripSurfaceAdapter::Params ap{spec.data_gpio, spec.enable_gpios, rows, cols};
             auto enc = std::unique_ptr<leds::internal::LEDWireEncoder>(new leds::internal::WireEncoderFlipdot(ap.gpio, use_dma, 10 * 1000 * 1000, use_dma ? 256 : 48, ((rows * cols) + 2) / 3));
             s.reset(new LEDStripSurfaceAdapter(ap, std::move(mapper), std::move(enc)));
             break;
         }
+        case config::LEDConfig::Chip::FLIPDOT_PACKED: {
+            LEDStripSurfaceAdapter::Params ap{spec.data_gpio, spec.enable_gpios, rows, cols};
+            auto enc = std::unique_ptr<leds::internal::LEDWireEncoder>(new leds::internal::WireEncoderFlipdotPacked(ap.gpio, use_dma, 10 * 1000 * 1000, use_dma ? 256 : 48, rows * cols));
+            s.reset(new LEDStripSurfaceAdapter(ap, std::move(mapper), std::move(enc)));
+            break;
+        }
         default:
             ESP_LOGE(TAG, "Unknown LED chip enum");
             return nullptr;
     }
-    if (!s) ESP_LOGE(TAG, "Failed to create strip on GPIO %d (dma=%d)", cfg.data_gpio(), (int)use_dma);
+    if (!s) ESP_LOGE(TAG, "Failed to create strip on GPIO %d (dma=%d)", spec.data_gpio, (int)use_dma);
     return s;
 }
 
 std::unique_ptr<LEDPattern> LEDManager::create_pattern_from_config(const config::LEDConfig& cfg) {
+    return create_pattern(desired_pattern(cfg));
+}
+
+BootFallback* LEDManager::boot_fallback(const config::LEDConfig& cfg) {
+    for (BootFallback& fb : boot_fallbacks_) {
+        if (!fb.matches(cfg)) continue;
+        fb.settle(cfg);
+        return &fb;
+    }
+    return nullptr;
+}
+
+config::LEDConfig::Pattern LEDManager::desired_pattern(const config::LEDConfig& cfg) {
+    BootFallback* fb = boot_fallback(cfg);
+    return fb ? fb->pattern(cfg) : cfg.pattern_enum();
+}
+
+LEDManager::PatternKnobs LEDManager::knobs_for(const config::LEDConfig& cfg) {
+    PatternKnobs k = PatternKnobs::from_config(cfg);
+    BootFallback* fb = boot_fallback(cfg);
+    if (!fb) return k;
+    const PatternKnobs rec = PatternKnobs::from_record(fb->record());
+    if (fb->has(BootFallback::kSpeed)) k.speed = rec.speed;
+    if (fb->has(BootFallback::kColor)) {
+        k.has_color = rec.has_color;
+        k.r = rec.r; k.g = rec.g; k.b = rec.b; k.w = rec.w;
+    }
+    if (fb->has(BootFallback::kBrightness)) {
+        k.has_brightness = rec.has_brightness;
+        k.brightness = rec.brightness;
+    }
+    return k;
+}
+
+std::unique_ptr<LEDPattern> LEDManager::create_pattern(config::LEDConfig::Pattern pat) {
     using P = config::LEDConfig::Pattern;
-    P pat = cfg.pattern_enum();
     std::unique_ptr<LEDPattern> p;
     switch (pat) {
         case P::OFF: p.reset(new OffPattern()); break;
@@ -253,6 +535,7 @@ std::unique_ptr<LEDPattern> LEDManager::create_pattern_from_config(const config:
         case P::CROSS_FADE: p.reset(new CrossFadePattern()); break;
         case P::FIREWORKS: p.reset(new FireworksPattern()); break;
         case P::MARQUEE: p.reset(new MarqueePattern()); break;
+        case P::DASHBOARD: p.reset(new DashboardPattern()); break;
         case P::INVALID: default: p.reset(new OffPattern()); break;
     }
     return p;
@@ -262,18 +545,122 @@ void LEDManager::UpdateTaskEntry(void* arg) {
     static_cast<LEDManager*>(arg)->run_update_loop();
 }
 
+void LEDManager::PrepareTaskEntry(void* arg) {
+    static_cast<LEDManager*>(arg)->run_prepare_loop();
+}
+
+void LEDManager::run_prepare_loop() {
+    while (true) {
+        PrepareJob* job = nullptr;
+        if (xQueueReceive(prepare_requests_, &job, portMAX_DELAY) != pdTRUE || !job) continue;
+        uint64_t t0 = esp_timer_get_time();
+        // Everything expensive about a switch happens here: construction, knob application (e.g. text
+        // layout), reset() and the first rendered frame, all against a private buffer.
+        job->pattern_obj = create_pattern(job->pattern);
+        job->buffer.reset(new LEDStripBuffer(job->rows, job->cols, job->chip));
+        if (job->pattern_obj) {
+            job->knobs.apply(*job->pattern_obj);
+            job->pattern_obj->reset(*job->buffer, t0);
+            job->pattern_obj->update(*job->buffer, esp_timer_get_time());
+        }
+        job->prepare_us = static_cast<uint32_t>(esp_timer_get_time() - t0);
+        if (xQueueSend(prepare_results_, &job, portMAX_DELAY) != pdTRUE) delete job;
+    }
+}
+
+bool LEDManager::submit_prepare(size_t idx, const config::LEDConfig& cfg) {
+    if (!prepare_task_ || !prepare_requests_ || idx >= strips_.size() || !strips_[idx]) return false;
+    LEDStrip* s = strips_[idx].get();
+    std::unique_ptr<PrepareJob> job(new PrepareJob());
+    job->strip_idx = idx;
+    job->generation = cfg.generation();
+    job->pattern = desired_pattern(cfg);
+    job->knobs = knobs_for(cfg);
+    job->rows = s->rows();
+    job->cols = s->cols();
+    job->chip = cfg.chip_enum();
+    // Blending is meaningless on binary flip-dot displays
+    job->fade_us = config::LEDConfig::is_flipdot(cfg.chip_enum()) ? 0 : static_cast<uint64_t>(cfg.crossfade_ms()) * 1000ull;
+    job->ticket = prepare_tracker_.submit(idx, job->pattern);
+    PrepareJob* raw = job.get();
+    if (xQueueSend(prepare_requests_, &raw, 0) != pdTRUE) {
+        prepare_tracker_.abandon(idx);
+        return false;
+    }
+    job.release();
+    return true;
+}
+
+void LEDManager::install_prepared_patterns(uint64_t now_us) {
+    if (!prepare_results_) return;
+    PrepareJob* raw = nullptr;
+    while (xQueueReceive(prepare_results_, &raw, 0) == pdTRUE) {
+        std::unique_ptr<PrepareJob> job(raw);
+        size_t i = job->strip_idx;
+        // Drop results for strips that were rebuilt or requests that were superseded
+        if (!prepare_tracker_.accept(i, job->ticket) || i >= strips_.size() || !strips_[i] || !job->pattern_obj) {
+            continue;
+        }
+        LEDStrip* s = strips_[i].get();
+        PatternTransition& tr = transitions_[i];
+        if (tr.active()) {
+            // A fade is still running: settle it and fade from the pattern it was heading to
+            tr.complete(*s);
+            patterns_[i] = tr.take_incoming();
+        }
+        // Knobs changed while preparing: apply the latest values before the pattern goes live
+        config::ConfigurationManager* cfg = cfg_manager_.load();
+        if (i < last_generations_.size() && last_generations_[i] != job->generation && cfg) {
+            auto active = cfg->active_leds();
+            if (i < active.size() && active[i]) knobs_for(*active[i]).apply(*job->pattern_obj);
+        }
+        const char* new_name = job->pattern_obj->name();
+        if (tr.begin(std::move(patterns_[i]), std::move(job->pattern_obj), std::move(job->buffer), *s, now_us, job->fade_us)) {
+            patterns_[i] = tr.take_incoming();
+        }
+        last_patterns_[i] = job->pattern;
+        tick_switching_ = true;
+        switches_window_++;
+        ESP_LOGI(TAG, "Pattern swapped for strip %u -> %s (prepared in %uus, fade %ums)", (unsigned)i, new_name,
+                 (unsigned)job->prepare_us, (unsigned)(job->fade_us / 1000));
+    }
+}
+
 void LEDManager::run_update_loop() {
     TickType_t tick_delay = pdMS_TO_TICKS(update_interval_us_ / 1000);
     if (tick_delay == 0) tick_delay = 1; // ensure at least one tick to yield CPU
+    // Gap until the next tick, offered to deferred flash writes (flash_window.h)
+    const uint32_t gap_us = static_cast<uint32_t>(tick_delay) * portTICK_PERIOD_MS * 1000u;
     while (true) {
+        // A pause for a long flash operation parks the task here; that gap is not a late tick
+        if (flash_window_close()) last_tick_start_us_ = 0;
         uint64_t now = esp_timer_get_time();
+        if (last_tick_start_us_ != 0) {
+            uint64_t gap = now - last_tick_start_us_;
+            if (gap > UINT32_MAX) gap = UINT32_MAX;
+            if (gap > max_tick_gap_us_window_) max_tick_gap_us_window_ = static_cast<uint32_t>(gap);
+            if (gap > 2ull * gap_us) late_ticks_window_++;
+        }
+        last_tick_start_us_ = now;
         // Periodically log tick rate and yield behavior to diagnose WDT issues
         static uint32_t loop_count = 0;
         if ((loop_count++ % 2000u) == 0u) {
             ESP_LOGD(TAG, "update loop tick; delay_ticks=%u, strips=%u", (unsigned)tick_delay, (unsigned)strips_.size());
         }
-        // Cheap per-tick generation check; if changed, reconcile immediately
-        reconcile_with_config(*cfg_manager_);
+        // Cheap per-tick generation check; if changed, reconcile immediately. Nothing to reconcile against
+        // while running from the boot record before init().
+        if (config::ConfigurationManager* cfg = cfg_manager_.load()) {
+            if (on_boot_state_) {
+                // Adopt the configuration: every strip counts as changed, so reconcile compares hardware
+                // and applies the configured pattern and knobs
+                on_boot_state_ = false;
+                last_generations_.assign(strips_.size(), UINT32_MAX);
+                ESP_LOGI(TAG, "Adopting configuration %ums after start", (unsigned)(now / 1000));
+            }
+            reconcile_with_config(*cfg);
+        }
+        // Swap in patterns finished by the prepare task; this is the frame boundary
+        install_prepared_patterns(now);
 
         // Update patterns and flush strips. Skip pattern update if strip is transmitting,
         // and record backpressure ticks for diagnostics.
@@ -282,7 +669,21 @@ void LEDManager::run_update_loop() {
             LEDPattern* p = (i < patterns_.size()) ? patterns_[i].get() : nullptr;
             if (!s) continue;
             if (!s->is_transmitting()) {
-                if (p) p->update(*s, now);
+                const uint32_t c0 = esp_cpu_get_cycle_count();
+                if (i < transitions_.size() && transitions_[i].active()) {
+                    tick_switching_ = true;
+                    if (transitions_[i].step(*s, now)) patterns_[i] = transitions_[i].take_incoming();
+                } else if (p) {
+                    p->update(*s, now);
+                }
+                if (i < render_cycles_window_.size()) {
+                    // Includes preemption by interrupts; max shows outliers, avg the steady cost
+                    const uint32_t cycles = esp_cpu_get_cycle_count() - c0;
+                    RenderCycles& rc = render_cycles_window_[i];
+                    rc.sum += cycles;
+                    if (cycles > rc.max) rc.max = cycles;
+                    rc.frames++;
+                }
             } else if (s->uses_dma()) {
                 // Record that this tick was backpressured by an in-flight transmit.
                 // We only know how to expose detailed stats for RMT-based strips.
@@ -304,6 +705,22 @@ void LEDManager::run_update_loop() {
                 FrameView cur{current.data(), rows, cols};
                 FrameView prev{prev_frames_rgba_[i].data(), rows, cols};
                 (void)power_mgrs_[i]->on_frame(cur, prev, now);
+                // Supply current limiting: estimate this frame's draw and scale the output to stay in budget
+                if (i < current_limits_.size() && current_limits_[i].rail >= 0) {
+                    CurrentLimitState& cl = current_limits_[i];
+                    RailLimitState& rail = current_rails_[cl.rail];
+                    cl.last_estimate_ma = cl.model.estimate_ma(cur);
+                    if (rail.sense_module > 0) {
+                        rail_current::Sample m = rail_current::latest(rail.sense_module, rail.sense_channel);
+                        if (m.timestamp_us != 0 && m.timestamp_us != rail.last_sample_us) {
+                            rail.last_sample_us = m.timestamp_us;
+                            rail.limiter.on_measurement(m.amps * 1000.0f, m.timestamp_us);
+                        }
+                    }
+                    cl.scale_q16 = rail.limiter.update(cl.member, cl.last_estimate_ma, now);
+                    if (cl.scale_q16 < cl.min_scale_q16_window) cl.min_scale_q16_window = cl.scale_q16;
+                    s->set_output_scale(cl.scale_q16);
+                }
                 // Apply power state; log transitions
                 if (s->has_enable_pin()) {
                     bool new_state = power_mgrs_[i]->power_enabled();
@@ -325,13 +742,49 @@ void LEDManager::run_update_loop() {
 
             bool hold_active = (i < power_on_hold_until_us_.size()) && (now < power_on_hold_until_us_[i]);
             if (!hold_active) {
-                if (s->flush_if_dirty(now)) frames_tx_counts_[i]++;
+                if (s->flush_if_dirty(now)) {
+                    frames_tx_counts_[i]++;
+                    if (!first_frame_logged_) {
+                        // esp_timer counts from app start; ROM and bootloader time come on top
+                        first_frame_logged_ = true;
+                        ESP_LOGI(TAG, "First frame out %ums after start (%s)", (unsigned)(now / 1000),
+                                 on_boot_state_ ? "boot record" : "configuration");
+                    }
+                }
             }
         }
 
+        // Frames are with RMT until the next tick: let waiting flash writes run now
+        flash_window_open(gap_us);
+
+        // Tick duration: longest overall, and longest among ticks that installed or blended a switch
+        uint32_t tick_us = static_cast<uint32_t>(esp_timer_get_time() - now);
+        if (tick_us > max_tick_us_window_) max_tick_us_window_ = tick_us;
+        if (tick_switching_ && tick_us > max_switch_tick_us_window_) max_switch_tick_us_window_ = tick_us;
+        tick_switching_ = false;
+
         // Periodic telemetry/logging: once per minute
         if (now - last_telemetry_log_us_ > 60ull * 1000 * 1000) {
             last_telemetry_log_us_ = now;
+            ESP_LOGI(TAG, "Update loop: max_tick_us=%u max_switch_tick_us=%u switches=%u max_tick_gap_us=%u late_ticks=%u",
+                     (unsigned)max_tick_us_window_, (unsigned)max_switch_tick_us_window_, (unsigned)switches_window_,
+                     (unsigned)max_tick_gap_us_window_, (unsigned)late_ticks_window_);
+            flash_window_stats_t fw;
+            flash_window_take_stats(&fw);
+            if (fw.writes > 0) {
+                ESP_LOGI(TAG, "Flash writes: %u (deferred=%u timed_out=%u max_wait_ms=%u overlapping_ticks=%u)",
+                         (unsigned)fw.writes, (unsigned)fw.deferred, (unsigned)fw.timed_out, (unsigned)fw.max_wait_ms,
+                         (unsigned)fw.overlaps);
+            }
+            if (fw.pauses > 0) {
+                ESP_LOGI(TAG, "Update loop paused for flash: %u times, longest %u ms", (unsigned)fw.pauses,
+                         (unsigned)fw.max_pause_ms);
+            }
+            max_tick_us_window_ = 0;
+            max_switch_tick_us_window_ = 0;
+            switches_window_ = 0;
+            max_tick_gap_us_window_ = 0;
+            late_ticks_window_ = 0;
             for (size_t i = 0; i < strips_.size(); ++i) {
                 unsigned idx = static_cast<unsigned>(i);
                 unsigned frames = (i < frames_tx_counts_.size()) ? static_cast<unsigned>(frames_tx_counts_[i]) : 0u;
@@ -368,10 +821,31 @@ void LEDManager::run_update_loop() {
 
                     // Reset per-window stats after logging.
                     rmt->reset_window_stats();
+                } else if (base && base->temporal_dither_enabled()) {
+                    ESP_LOGI(TAG, "Strip %u: frames=%u fps=%.2f avg_period_ms=%.2f dither_ns_per_px=%u",
+                             idx, frames, fps, avg_period_ms, (unsigned)base->take_dither_ns_per_pixel());
                 } else {
                     ESP_LOGI(TAG, "Strip %u: frames=%u fps=%.2f avg_period_ms=%.2f",
                              idx, frames, fps, avg_period_ms);
                 }
+                if (i < current_limits_.size() && current_limits_[i].rail >= 0) {
+                    CurrentLimitState& cl = current_limits_[i];
+                    const RailLimiter& rail = current_rails_[cl.rail].limiter;
+                    ESP_LOGI(TAG, "Strip %u: rail=%d (%u strips) current_limit=%.0fmA est=%.0fmA rail_est=%.0fmA "
+                             "scale=%.3f min_scale=%.3f gain=%.2f",
+                             idx, cl.rail, (unsigned)rail.members(), rail.budget_ma(), cl.last_estimate_ma,
+                             rail.total_estimate_ma(), cl.scale_q16 / 65535.0, cl.min_scale_q16_window / 65535.0,
+                             rail.gain());
+                    cl.min_scale_q16_window = cl.scale_q16;
+                }
+                if (i < render_cycles_window_.size() && render_cycles_window_[i].frames > 0) {
+                    RenderCycles& rc = render_cycles_window_[i];
+                    const LEDPattern* pat = (i < patterns_.size()) ? patterns_[i].get() : nullptr;
+                    ESP_LOGI(TAG, "Strip %u: pattern=%s render_cycles avg=%u max=%u renders=%u", idx,
+                             pat ? pat->name() : "<none>", (unsigned)(rc.sum / rc.frames), (unsigned)rc.max,
+                             (unsigned)rc.frames);
+                    rc = RenderCycles();
+                }
             }
             std::fill(frames_tx_counts_.begin(), frames_tx_counts_.end(), 0);
         }
@@ -387,22 +861,98 @@ void LEDManager::apply_pattern_updates_from_config(size_t idx, const config::LED
     LEDPattern* pat = (idx < patterns_.size()) ? patterns_[idx].get() : nullptr;
     if (!strip) return;
 
-    // Decide if pattern type changed using last_patterns_
+    // Decide if pattern type changed using last_patterns_ (during a fade, the incoming pattern is current)
     size_t ensure = idx + 1;
     if (last_patterns_.size() < ensure) last_patterns_.resize(ensure, config::LEDConfig::Pattern::INVALID);
-    bool type_changed = (!pat) || (last_patterns_[idx] != cfg.pattern_enum());
+    bool fading = (idx < transitions_.size()) && transitions_[idx].active();
+    if (fading) pat = transitions_[idx].incoming();
+    config::LEDConfig::Pattern desired = desired_pattern(cfg);
+    bool type_changed = (!pat) || (last_patterns_[idx] != desired);
+
+    if (!type_changed) {
+        // Back to (or still on) the running pattern: abandon any prepare in flight and apply knobs
+        prepare_tracker_.abandon(idx);
+        knobs_for(cfg).apply(*pat);
+        return;
+    }
+    if (prepare_tracker_.pending(idx, desired)) {
+        // Already being prepared; latest knobs are applied when it is installed
+        return;
+    }
+    if (pat && submit_prepare(idx, cfg)) return;
 
-    if (type_changed) {
-        patterns_[idx] = create_pattern_from_config(cfg);
-        pat = patterns_[idx].get();
-        if (pat) { apply_runtime_knobs(*pat, cfg); pat->reset(*strip, now_us); }
-        ESP_LOGI(TAG, "Pattern swapped for strip %u -> %s", (unsigned)idx, pat ? pat->name() : "<null>");
-    } else if (pat) {
-        // Apply runtime knobs
-        apply_runtime_knobs(*pat, cfg);
+    // Inline fallback (no prepare task, queue full, or nothing installed yet)
+    if (fading) {
+        transitions_[idx].complete(*strip);
+        patterns_[idx] = transitions_[idx].take_incoming();
     }
+    prepare_tracker_.abandon(idx);
+    patterns_[idx] = create_pattern_from_config(cfg);
+    pat = patterns_[idx].get();
+    if (pat) { knobs_for(cfg).apply(*pat); pat->reset(*strip, now_us); }
+    tick_switching_ = true;
+    switches_window_++;
+    ESP_LOGI(TAG, "Pattern swapped for strip %u -> %s", (unsigned)idx, pat ? pat->name() : "<null>");
     // Record last applied pattern type
-    last_patterns_[idx] = cfg.pattern_enum();
+    last_patterns_[idx] = desired;
+}
+
+void LEDManager::apply_current_limit_from_config(size_t idx, const config::LEDConfig& cfg) {
+    if (idx >= current_limits_.size()) return;
+    CurrentLimitState& cl = current_limits_[idx];
+    float budget = cfg.has_current_limit() ? static_cast<float>(cfg.current_limit_ma()) : 0.0f;
+    int module = cfg.has_current_sense() ? cfg.current_sense_module() : 0;
+    int channel = cfg.has_current_sense() ? cfg.current_sense_channel() : 0;
+    bool changed = (budget != cl.budget_ma) || (module != cl.sense_module) || (channel != cl.sense_channel);
+    if (!changed) return;
+    cl.model = ChipCurrentModel::for_chip(cfg.chip_enum());
+    cl.budget_ma = budget;
+    cl.sense_module = module;
+    cl.sense_channel = channel;
+    rebuild_current_rails();
+    if (budget > 0.0f) {
+        ESP_LOGI(TAG, "Strip %u: current limit %dmA, sense=%s, rail %d", (unsigned)idx, cfg.current_limit_ma(),
+                 cfg.has_current_sense() ? cfg.current_sense().c_str() : "none (open loop)", cl.rail);
+    }
+}
+
+void LEDManager::rebuild_current_rails() {
+    current_rails_.clear();
+    std::vector<float> budgets;
+    std::vector<size_t> members;
+    for (size_t i = 0; i < current_limits_.size(); ++i) {
+        CurrentLimitState& cl = current_limits_[i];
+        cl.rail = -1;
+        if (cl.budget_ma <= 0.0f) {
+            if (cl.scale_q16 != CurrentLimiter::kUnity && i < strips_.size() && strips_[i]) {
+                cl.scale_q16 = CurrentLimiter::kUnity;
+                strips_[i]->set_output_scale(CurrentLimiter::kUnity);
+            }
+            continue;
+        }
+        int r = -1;
+        if (cl.sense_module > 0) {
+            for (size_t k = 0; k < current_rails_.size(); ++k) {
+                if (current_rails_[k].sense_module == cl.sense_module && current_rails_[k].sense_channel == cl.sense_channel) {
+                    r = static_cast<int>(k);
+                    break;
+                }
+            }
+        }
+        if (r < 0) {
+            current_rails_.emplace_back();
+            current_rails_.back().sense_module = cl.sense_module;
+            current_rails_.back().sense_channel = cl.sense_channel;
+            budgets.push_back(cl.budget_ma);
+            members.push_back(0);
+            r = static_cast<int>(current_rails_.size() - 1);
+        } else if (cl.budget_ma < budgets[r]) {
+            budgets[r] = cl.budget_ma;
+        }
+        cl.rail = r;
+        cl.member = members[r]++;
+    }
+    for (size_t k = 0; k < current_rails_.size(); ++k) current_rails_[k].limiter.configure(budgets[k], members[k]);
 }
 
 void LEDManager::reconcile_with_config(config::ConfigurationManager& cfg_manager) {
@@ -461,7 +1011,9 @@ void LEDManager::reconcile_with_config(config::ConfigurationManager& cfg_manager
         // Conservative: record first to avoid skipping updates if generation advances mid-apply
         last_generations_[i] = current_gen;
         apply_pattern_updates_from_config(i, *c, now);
+        apply_current_limit_from_config(i, *c);
     }
+    save_boot_state(cfg_manager);
     // No pattern-specific restarts here; patterns handle their own config changes
 }
 
@@ -1,29 +1,42 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <vector>
 #include "PsramAllocator.h"
+#include "LEDBootFallback.h"
 #include "LEDConfig.h"
+#include "LEDCurrentLimiter.h"
+#include "LEDPatternTransition.h"
+#include "LEDPrepareTracker.h"
 #include "esp_err.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include <string>
 
 namespace config { class ConfigurationManager; class LEDConfig; }
 namespace leds { class LEDStrip; class LEDPattern; }
-namespace leds { class PowerManager; }
+namespace leds { class PowerManager; struct LEDBootRecord; }
+namespace leds { namespace internal { class RmtSharedChannel; } }
 
 namespace leds {
 
 // Coordinates multiple LED strips and their animation patterns.
-// - Initializes from config::ConfigurationManager (up to four strips)
+// - Initializes from config::ConfigurationManager (up to eight strips)
+// - With more strips than RMT TX channels, batches strips onto time-shared channels (RmtSharedChannel)
+//   so that every channel's strips fit the target frame rate (RmtSchedule.h)
 // - Chooses which strip should use DMA (by default the longest strip), and can reassign at runtime
 // - DMA management is centralized: reassigning DMA frees the existing RMT channel and allocates a new one
 //   with DMA on the selected strip (and non-DMA on others). The reconfiguration is triggered inside the
 //   update loop when needed, not from individual strips.
 // - Owns a pinned FreeRTOS task on the APP CPU to periodically update patterns and flush strips
 // - Avoids pattern updates while a transmit is in-flight; prioritizes strips that are not backpressured
+// - Opens the flash-write window (flash_window.h) once its frames are with RMT, so NVS, LittleFS and OTA
+//   writes stall the cache between frames rather than in the middle of rendering one
+// - Can light the strips before configuration is loaded, from the record of what they last showed
+//   (LEDBootState.h), and adopt the configuration on a later tick without restarting the output
 class LEDManager {
 public:
     LEDManager();
@@ -33,6 +46,14 @@ public:
     // Returns ESP_OK on success. This does not block; the update task runs independently.
     esp_err_t init(config::ConfigurationManager& cfg_manager);
 
+    // Instant-on: build strips and patterns from the boot record and start the update task, before the
+    // configuration is available. A later init() hands the running strips over to the configuration:
+    // strips whose hardware matches keep running and only take up changed pattern/knobs (with the usual
+    // crossfade), anything else is rebuilt. Runtime keys the configuration has not set yet keep the
+    // record's values (LEDBootFallback.h). Returns ESP_ERR_NOT_FOUND when there is no valid record, and
+    // ESP_ERR_INVALID_STATE after a panic or watchdog reset.
+    esp_err_t start_from_boot_state();
+
     // Trigger a re-evaluation of configuration (e.g., after MQTT update). The manager may:
     // - Recreate strips when hardware parameters change (pin/chip/length)
     // - Reallocate DMA to a different strip
@@ -45,21 +66,116 @@ public:
     const std::vector<std::unique_ptr<LEDStrip>>& strips() const { return strips_; }
 
 private:
+    // Snapshot of the runtime knobs a pattern honors, so they can be handed to another task
+    struct PatternKnobs {
+        int speed = 50;
+        bool has_color = false; uint8_t r = 0, g = 0, b = 0, w = 0;
+        bool has_brightness = false; int brightness = 100;
+        bool has_message = false; std::string message;
+        static PatternKnobs from_config(const config::LEDConfig& cfg);
+        static PatternKnobs from_record(const LEDBootStrip& b);
+        void apply(LEDPattern& pat) const;
+    };
+
+    // Pattern switch prepared off the update loop: constructed, configured, reset and rendered once on
+    // the prepare task, then swapped in by the update loop at a frame boundary.
+    struct PrepareJob {
+        size_t strip_idx = 0;
+        PrepareTracker::Ticket ticket; // installed only if still current (see LEDPrepareTracker.h)
+        uint32_t generation = 0; // config generation the knobs were taken from
+        config::LEDConfig::Pattern pattern = config::LEDConfig::Pattern::OFF;
+        PatternKnobs knobs;
+        size_t rows = 1, cols = 1;
+        config::LEDConfig::Chip chip = config::LEDConfig::Chip::WS2812;
+        uint64_t fade_us = 0;
+        // Filled in by the prepare task
+        std::unique_ptr<LEDPattern> pattern_obj;
+        std::unique_ptr<LEDStripBuffer> buffer;
+        uint32_t prepare_us = 0;
+    };
+
+    // Hardware description of one strip, taken from its LEDConfig or from the boot record
+    struct StripSpec {
+        int data_gpio = -1;
+        std::vector<int> enable_gpios;
+        config::LEDConfig::Chip chip = config::LEDConfig::Chip::WS2812;
+        config::LEDConfig::Layout layout = config::LEDConfig::Layout::ROW_MAJOR;
+        size_t rows = 1, cols = 1;
+        size_t segment_rows = 0; // 0 => whole height
+        bool dma = false;        // explicitly requested
+        static StripSpec from_config(const config::LEDConfig& cfg);
+    };
+
     // Internal helpers
-    std::unique_ptr<LEDStrip> create_strip(const config::LEDConfig& cfg, bool use_dma);
+    // Rebuild all strips (clean slate) from specs. Returns the spec index of every strip built, in
+    // strips_ order; the caller installs one pattern per built strip.
+    std::vector<size_t> build_strips(const std::vector<StripSpec>& specs, bool prime_clear);
+    std::unique_ptr<LEDStrip> create_strip(const StripSpec& spec, bool use_dma,
+                                           internal::RmtSharedChannel* shared = nullptr);
+    // Plan and create time-shared channels when there are more strips than RMT channels; fills
+    // shared_for (1:1 with specs) with the channel each strip should use, or nullptr for its own
+    void plan_shared_channels(const std::vector<StripSpec>& specs, size_t dma_idx,
+                              std::vector<internal::RmtSharedChannel*>& shared_for);
+    esp_err_t start_tasks();
+    // Mirror the active configuration into the boot record
+    void save_boot_state(config::ConfigurationManager& cfg_manager);
+    static std::unique_ptr<LEDPattern> create_pattern(config::LEDConfig::Pattern pat);
     std::unique_ptr<LEDPattern> create_pattern_from_config(const config::LEDConfig& cfg);
+    // The strip's pattern and knobs: the configuration's, with boot record values for the runtime keys it
+    // has not set yet (LEDBootFallback.h)
+    BootFallback* boot_fallback(const config::LEDConfig& cfg);
+    config::LEDConfig::Pattern desired_pattern(const config::LEDConfig& cfg);
+    PatternKnobs knobs_for(const config::LEDConfig& cfg);
+    bool submit_prepare(size_t idx, const config::LEDConfig& cfg);
+    void install_prepared_patterns(uint64_t now_us);
     void reconcile_with_config(config::ConfigurationManager& cfg_manager);
     void apply_pattern_updates_from_config(size_t idx, const config::LEDConfig& cfg, uint64_t now_us);
+    void apply_current_limit_from_config(size_t idx, const config::LEDConfig& cfg);
+    // Regroup the limited strips into rails after a budget or sense channel changed; resets learned gains
+    void rebuild_current_rails();
 
     // Task management
     static void UpdateTaskEntry(void* arg); // FreeRTOS C entry point
     void run_update_loop();                 // instance method executed by the task
+    static void PrepareTaskEntry(void* arg);
+    void run_prepare_loop();
 
     // State
-    config::ConfigurationManager* cfg_manager_ = nullptr; // not owned
+    // Not owned. Set from the app task by init() while the update task may already run (instant-on),
+    // hence atomic; nullptr until the configuration is available.
+    std::atomic<config::ConfigurationManager*> cfg_manager_{nullptr};
+    // Strips were built from the boot record and the configuration has not been adopted yet
+    bool on_boot_state_ = false;
+    // One per boot record strip when started from it; consulted until the configuration sets each key
+    std::vector<BootFallback> boot_fallbacks_;
+    bool first_frame_logged_ = false;
+    // Time-shared RMT channels; declared before strips_ so they outlive the strips using them
+    std::vector<std::unique_ptr<internal::RmtSharedChannel>> shared_channels_;
     std::vector<std::unique_ptr<LEDStrip>> strips_;
     std::vector<std::unique_ptr<LEDPattern>> patterns_; // 1:1 with strips_
     std::vector<std::unique_ptr<PowerManager>> power_mgrs_; // 1:1 with strips_
+    // Supply current limiting, disabled unless max_current_ma is configured. Strips naming the same
+    // current_sense channel share one rail limiter whose budget is the smallest max_current_ma among
+    // them; a limited strip without a sense channel is a rail of its own, open loop.
+    struct CurrentLimitState { // 1:1 with strips_
+        ChipCurrentModel model;
+        float budget_ma = 0.0f;        // configured max_current_ma, 0 => unlimited
+        int sense_module = 0;          // A2D module index of the measured rail (1..4), 0 => open loop
+        int sense_channel = 0;         // channel on that module (1..4)
+        int rail = -1;                 // index into current_rails_, -1 => not limited
+        size_t member = 0;             // position among the rail's strips
+        uint32_t scale_q16 = CurrentLimiter::kUnity;
+        float last_estimate_ma = 0.0f; // unity-scale estimate of the most recent frame
+        uint32_t min_scale_q16_window = CurrentLimiter::kUnity; // telemetry: deepest limiting since last log
+    };
+    struct RailLimitState {
+        RailLimiter limiter;
+        int sense_module = 0;
+        int sense_channel = 0;
+        uint64_t last_sample_us = 0;   // timestamp of the last measurement fed to the limiter
+    };
+    std::vector<CurrentLimitState> current_limits_;
+    std::vector<RailLimitState> current_rails_;
     // Store per-strip RGBA frames in PSRAM to free internal RAM
     std::vector<std::vector<uint8_t, PsramAllocator<uint8_t>>> prev_frames_rgba_; // rows*cols*4 per strip
     std::vector<std::vector<uint8_t, PsramAllocator<uint8_t>>> scratch_frames_rgba_; // reusable buffer for current frame
@@ -71,6 +187,14 @@ private:
     // Track last applied pattern to avoid reinstalling the same type repeatedly
     std::vector<config::LEDConfig::Pattern> last_patterns_;
     std::vector<uint32_t> last_generations_; // per-strip generation snapshot
+    // Background pattern switching (1:1 with strips_)
+    std::vector<PatternTransition> transitions_;
+    PrepareTracker prepare_tracker_; // requests in flight; reset on every strip rebuild
+    QueueHandle_t prepare_requests_ = nullptr; // PrepareJob*
+    QueueHandle_t prepare_results_ = nullptr;  // PrepareJob*
+    TaskHandle_t prepare_task_ = nullptr;
+    // Runs below the update task on the same core, so preparation only uses time between frames
+    int prepare_task_priority_ = 1;
     // Track last configured enable GPIOs list to detect hardware pin changes
     std::vector<std::vector<int>> last_enable_pins_;
     TaskHandle_t update_task_ = nullptr;
@@ -84,11 +208,32 @@ private:
     // - Use RMT events to call on_transmit_complete and to pace patterns (skip updates while busy)
     // - Ensure a forced refresh at least every ~10s to recover from transient glitches
     uint32_t update_interval_us_ = 5'000; // default cadence; pattern may skip if transmitting
+    // Minimum frame rate (frames/s, wire time and update loop) for a strip to get temporal dithering of
+    // 16-bit pixels. The dither pattern repeats within 8 frames, so this keeps it at 25 Hz or faster.
+    uint32_t dither_min_refresh_hz_ = 200;
+    // Frame rate every strip on a time-shared RMT channel must still reach
+    uint32_t shared_channel_target_fps_ = 60;
 
 
     // Per-strip frame counters for periodic telemetry
     std::vector<uint32_t> frames_tx_counts_;
     uint64_t last_telemetry_log_us_ = 0;
+    // Update-loop tick duration, overall and for ticks that installed or blended a pattern switch
+    uint32_t max_tick_us_window_ = 0;
+    uint32_t max_switch_tick_us_window_ = 0;
+    uint32_t switches_window_ = 0;
+    bool tick_switching_ = false;
+    // Frame-time outliers: ticks starting more than one interval late (flash writes, preemption)
+    uint64_t last_tick_start_us_ = 0;
+    uint32_t max_tick_gap_us_window_ = 0;
+    uint32_t late_ticks_window_ = 0;
+    // CPU cycles per pattern update (render) per strip; compares code placements (profiler.h)
+    struct RenderCycles {
+        uint64_t sum = 0;
+        uint32_t max = 0;
+        uint32_t frames = 0;
+    };
+    std::vector<RenderCycles> render_cycles_window_;
 };
 
 } // namespace leds
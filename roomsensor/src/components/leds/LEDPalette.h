@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "LEDTemporalDither.h"
+
+namespace leds {
+
+// 256-entry RGBW palette for the palette-indexed strip mode (see LEDStrip::set_indexed_mode).
+// Entries use 16-bit channels like set_pixel16 so dithered strips keep the extra precision.
+// Animating the palette recolors every pixel that references an entry without touching the pixels.
+struct LEDPalette {
+    static constexpr size_t kSize = 256;
+    uint16_t rgbw[kSize][4] = {};
+
+    void set(uint8_t i, uint16_t r, uint16_t g, uint16_t b, uint16_t w = 0) {
+        rgbw[i][0] = r; rgbw[i][1] = g; rgbw[i][2] = b; rgbw[i][3] = w;
+    }
+    void set8(uint8_t i, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) {
+        set(i, widen_u8(r), widen_u8(g), widen_u8(b), widen_u8(w));
+    }
+    bool operator==(const LEDPalette& o) const { return std::memcmp(rgbw, o.rgbw, sizeof(rgbw)) == 0; }
+    bool operator!=(const LEDPalette& o) const { return !(*this == o); }
+};
+
+} // namespace leds
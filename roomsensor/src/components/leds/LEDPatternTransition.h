@@ -0,0 +1,117 @@
+#pragma once
+
+#include "LEDPattern.h"
+#include "LEDStripBuffer.h"
+#include <cstdint>
+#include <memory>
+
+namespace leds {
+
+// Switches a strip from one pattern to another at a frame boundary.
+// The incoming pattern arrives already reset and warmed up on its own LEDStripBuffer (see LEDManager's
+// prepare task), so the swap itself never runs pattern construction or reset() on the update loop.
+// - Hard cut (fade_us == 0): the warmed frame is copied onto the strip in begin().
+// - Crossfade: both patterns keep animating on private buffers and the strip shows a linear blend;
+//   when the fade ends the incoming buffer is copied to the strip and the pattern draws directly again.
+// No IDF dependencies; the caller owns scheduling and the strip.
+class PatternTransition {
+public:
+    // Start a switch. Returns true if the switch completed immediately (hard cut); in that case, or when
+    // step() later returns true, take_incoming() yields the pattern to install.
+    bool begin(std::unique_ptr<LEDPattern> outgoing,
+               std::unique_ptr<LEDPattern> incoming,
+               std::unique_ptr<LEDStripBuffer> incoming_buf,
+               LEDStrip& strip,
+               uint64_t now_us,
+               uint64_t fade_us) {
+        cancel();
+        incoming_ = std::move(incoming);
+        incoming_buf_ = std::move(incoming_buf);
+        if (!incoming_buf_ || !outgoing || fade_us == 0) {
+            if (incoming_buf_) incoming_buf_->copy_to(strip);
+            incoming_buf_.reset();
+            done_ = true;
+            return true;
+        }
+        outgoing_ = std::move(outgoing);
+        // Outgoing pattern continues from exactly what is displayed now
+        outgoing_buf_.reset(new LEDStripBuffer(strip.rows(), strip.cols(), strip.chip()));
+        outgoing_buf_->copy_from(strip);
+        start_us_ = now_us;
+        fade_us_ = fade_us;
+        active_ = true;
+        return false;
+    }
+
+    bool active() const { return active_; }
+    // True once the incoming pattern is ready to be taken
+    bool done() const { return done_; }
+
+    // Render one blended frame. Returns true when the fade finished on this call.
+    bool step(LEDStrip& strip, uint64_t now_us) {
+        if (!active_) return false;
+        outgoing_->update(*outgoing_buf_, now_us);
+        incoming_->update(*incoming_buf_, now_us);
+        uint64_t elapsed = (now_us > start_us_) ? (now_us - start_us_) : 0;
+        if (elapsed >= fade_us_) {
+            complete(strip);
+            return true;
+        }
+        uint32_t t = static_cast<uint32_t>((elapsed * 256u) / fade_us_); // 0..255
+        const uint8_t* a = outgoing_buf_->data();
+        const uint8_t* b = incoming_buf_->data();
+        size_t n = std::min(strip.length(), incoming_buf_->length());
+        for (size_t i = 0; i < n; ++i) {
+            const uint8_t* pa = a + i * 4;
+            const uint8_t* pb = b + i * 4;
+            strip.set_pixel(i, blend(pa[0], pb[0], t), blend(pa[1], pb[1], t),
+                            blend(pa[2], pb[2], t), blend(pa[3], pb[3], t));
+        }
+        return false;
+    }
+
+    // Finish a running fade immediately, showing the incoming frame (e.g. another switch is starting).
+    void complete(LEDStrip& strip) {
+        if (!active_) return;
+        incoming_buf_->copy_to(strip);
+        outgoing_.reset();
+        outgoing_buf_.reset();
+        incoming_buf_.reset();
+        active_ = false;
+        done_ = true;
+    }
+
+    // Hand over the incoming pattern after completion; resets the transition.
+    std::unique_ptr<LEDPattern> take_incoming() {
+        done_ = false;
+        return std::move(incoming_);
+    }
+
+    // Forward runtime knob changes while a fade is running (only the incoming pattern is affected).
+    LEDPattern* incoming() const { return incoming_.get(); }
+
+    void cancel() {
+        outgoing_.reset();
+        incoming_.reset();
+        outgoing_buf_.reset();
+        incoming_buf_.reset();
+        active_ = false;
+        done_ = false;
+    }
+
+private:
+    static inline uint8_t blend(uint8_t a, uint8_t b, uint32_t t) {
+        return static_cast<uint8_t>((a * (256u - t) + b * t) >> 8);
+    }
+
+    std::unique_ptr<LEDPattern> outgoing_;
+    std::unique_ptr<LEDPattern> incoming_;
+    std::unique_ptr<LEDStripBuffer> outgoing_buf_;
+    std::unique_ptr<LEDStripBuffer> incoming_buf_;
+    uint64_t start_us_ = 0;
+    uint64_t fade_us_ = 0;
+    bool active_ = false;
+    bool done_ = false;
+};
+
+} // namespace leds
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "LEDConfig.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace leds {
+
+// Bookkeeping for pattern switches prepared off the update loop (LEDManager's prepare task).
+// Each request gets a ticket: the strip set epoch and a sequence number. A finished preparation is
+// installed only if its ticket still matches, i.e. the strips were not rebuilt since the request, it is
+// the newest request for its strip and that request was not abandoned (config went back to the running
+// pattern, or the switch was done inline). At most one request per strip is live.
+// No IDF dependencies; the caller owns the queues and the task.
+class PrepareTracker {
+public:
+    struct Ticket {
+        uint32_t epoch = 0;
+        uint32_t seq = 0; // never 0 for an issued ticket
+    };
+
+    // New strip set: every request in flight becomes stale
+    void reset(size_t strips) {
+        ++epoch_;
+        pending_.assign(strips, Pending());
+    }
+
+    // Issue the ticket for a new request on strip idx; it supersedes any earlier one
+    Ticket submit(size_t idx, config::LEDConfig::Pattern pattern) {
+        if (idx >= pending_.size()) pending_.resize(idx + 1);
+        if (++seq_ == 0) ++seq_;
+        pending_[idx] = Pending{seq_, pattern};
+        return Ticket{epoch_, seq_};
+    }
+
+    // True while a request for 'pattern' on strip idx is in flight
+    bool pending(size_t idx, config::LEDConfig::Pattern pattern) const {
+        return idx < pending_.size() && pending_[idx].seq != 0 && pending_[idx].pattern == pattern;
+    }
+
+    // Drop the live request of strip idx; its result will be discarded
+    void abandon(size_t idx) {
+        if (idx < pending_.size()) pending_[idx] = Pending();
+    }
+
+    // A preparation finished. True if it should be installed; the request is then no longer pending.
+    bool accept(size_t idx, const Ticket& t) {
+        if (t.epoch != epoch_ || idx >= pending_.size() || t.seq == 0 || pending_[idx].seq != t.seq) return false;
+        pending_[idx] = Pending();
+        return true;
+    }
+
+private:
+    struct Pending {
+        uint32_t seq = 0; // 0 => nothing in flight
+        config::LEDConfig::Pattern pattern = config::LEDConfig::Pattern::INVALID;
+    };
+
+    std::vector<Pending> pending_;
+    uint32_t epoch_ = 0;
+    uint32_t seq_ = 0;
+};
+
+} // namespace leds
@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <cstddef>
 #include "LEDConfig.h"
+#include "LEDTemporalDither.h"
+#include "LEDPalette.h"
 
 namespace leds {
 
@@ -31,6 +33,26 @@ public:
     // Returns true if the stored pixel value changed (i.e., would mark strip dirty), false otherwise.
     virtual bool set_pixel(size_t index, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) = 0;
     virtual bool get_pixel(size_t index, uint8_t& r, uint8_t& g, uint8_t& b, uint8_t& w) const = 0;
+    // High-precision write with 16-bit logical channels (0..65535). Strips with temporal dithering keep
+    // the extra precision and spread it over successive frames; others round to 8 bits. get_pixel()
+    // always reports the rounded 8-bit value.
+    virtual bool set_pixel16(size_t index, uint16_t r, uint16_t g, uint16_t b, uint16_t w = 0) {
+        return set_pixel(index, narrow_u16(r), narrow_u16(g), narrow_u16(b), narrow_u16(w));
+    }
+
+    // Palette-indexed mode: pixels hold an 8-bit index into a 256-entry palette that is expanded at flush
+    // time. Patterns whose colors are a function of a small parameter (hue, position band) can then update
+    // 256 palette entries per frame instead of every pixel, and the strip keeps 1 byte per pixel instead
+    // of a full RGBA shadow. Any RGB write (set_pixel, set_pixel16, clear) returns the strip to RGB mode,
+    // so patterns that do not use palettes never need to know about it.
+    // - set_indexed_mode: returns false if the strip does not support indexed mode (use the RGB path).
+    // - set_pixel_index: returns true if the stored index changed; false in RGB mode.
+    // - set_palette: marks the strip dirty if any entry changed; ignored in RGB mode.
+    // get_pixel() reports the palette color of the pixel, rounded to 8 bits.
+    virtual bool set_indexed_mode(bool on) { return !on; }
+    virtual bool indexed_mode() const { return false; }
+    virtual bool set_pixel_index(size_t index, uint8_t palette_index) { (void)index; (void)palette_index; return false; }
+    virtual void set_palette(const LEDPalette& palette) { (void)palette; }
 
     // Global operations
     virtual void clear() = 0;                 // set all pixels to 0; marks strip dirty only if some pixel changed
@@ -48,6 +70,14 @@ public:
 
     // Resource info
     virtual bool uses_dma() const = 0; // current mode
+    // Temporal dithering of the 16-bit pipeline (see set_pixel16). Only enabled on strips that refresh fast
+    // enough for the dither to be invisible.
+    virtual bool temporal_dither_enabled() const { return false; }
+    // Average CPU cost of the dither pass in ns/pixel since the previous call; 0 when not dithering.
+    virtual uint32_t take_dither_ns_per_pixel() { return 0; }
+    // Global output scale applied on the way to the wire (Q16, 65535 = unity), independent of the pixel
+    // values patterns write. Used by the manager's current limiter; strips without support ignore it.
+    virtual void set_output_scale(uint32_t q16) { (void)q16; }
 
     // Optional hardware power control (enable pin). When present, driving the pin HIGH powers LEDs on,
     // and driving it LOW powers LEDs off.
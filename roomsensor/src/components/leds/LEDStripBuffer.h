@@ -0,0 +1,82 @@
+#pragma once
+
+#include "LEDStrip.h"
+#include <algorithm>
+#include <vector>
+#include "PsramAllocator.h"
+
+namespace leds {
+
+// Off-screen LEDStrip: same geometry and pixel API as a real strip, backed only by memory.
+// Used to run a pattern without touching hardware, e.g. to warm up the next pattern on a background task
+// or to render the outgoing and incoming patterns separately during a crossfade.
+class LEDStripBuffer final : public LEDStrip {
+public:
+    LEDStripBuffer(size_t rows, size_t cols, config::LEDConfig::Chip chip)
+        : rows_(rows ? rows : 1), cols_(cols ? cols : 1), chip_(chip) {
+        rgba_.assign(rows_ * cols_ * 4, 0);
+    }
+
+    // Copy all pixels from another strip of the same geometry (e.g. to seed with what is on the wire).
+    void copy_from(const LEDStrip& src) {
+        size_t n = std::min(length(), src.length());
+        for (size_t i = 0; i < n; ++i) {
+            uint8_t* px = &rgba_[i * 4];
+            src.get_pixel(i, px[0], px[1], px[2], px[3]);
+        }
+    }
+
+    // Write all pixels to another strip; only pixels that differ mark it dirty.
+    void copy_to(LEDStrip& dst) const {
+        size_t n = std::min(length(), dst.length());
+        for (size_t i = 0; i < n; ++i) {
+            const uint8_t* px = &rgba_[i * 4];
+            dst.set_pixel(i, px[0], px[1], px[2], px[3]);
+        }
+    }
+
+    const uint8_t* data() const { return rgba_.data(); }
+
+    // LEDStrip interface
+    int pin() const override { return -1; }
+    size_t length() const override { return rows_ * cols_; }
+    config::LEDConfig::Chip chip() const override { return chip_; }
+    size_t rows() const override { return rows_; }
+    size_t cols() const override { return cols_; }
+    size_t index_for_row_col(size_t row, size_t col) const override {
+        if (row >= rows_) row = rows_ - 1;
+        if (col >= cols_) col = cols_ - 1;
+        return row * cols_ + col; // row-major, matches LEDStripSurfaceAdapter
+    }
+
+    bool set_pixel(size_t index, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) override {
+        if (index >= length()) return false;
+        uint8_t* px = &rgba_[index * 4];
+        bool changed = (px[0] != r) || (px[1] != g) || (px[2] != b) || (px[3] != w);
+        px[0] = r; px[1] = g; px[2] = b; px[3] = w;
+        return changed;
+    }
+    bool get_pixel(size_t index, uint8_t& r, uint8_t& g, uint8_t& b, uint8_t& w) const override {
+        if (index >= length()) return false;
+        const uint8_t* px = &rgba_[index * 4];
+        r = px[0]; g = px[1]; b = px[2]; w = px[3];
+        return true;
+    }
+
+    void clear() override { std::fill(rgba_.begin(), rgba_.end(), 0u); }
+
+    bool flush_if_dirty(uint64_t, uint64_t) override { return false; }
+    bool is_transmitting() const override { return false; }
+    void on_transmit_complete(uint64_t) override {}
+    bool uses_dma() const override { return false; }
+    bool has_enable_pin() const override { return false; }
+    void set_power_enabled(bool) override {}
+
+private:
+    size_t rows_;
+    size_t cols_;
+    config::LEDConfig::Chip chip_;
+    std::vector<uint8_t, PsramAllocator<uint8_t>> rgba_;
+};
+
+} // namespace leds
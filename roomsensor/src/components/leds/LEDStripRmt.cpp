@@ -1,4 +1,5 @@
 #include "LEDStripRmt.h"
+#include "esp_attr.h"
 #include "esp_log.h"
 #include "driver/gpio.h"
 #include <memory>
@@ -7,6 +8,13 @@ namespace leds {
 
 static const char* TAG = "LEDStripRmt";
 
+// TX-done ISR; with CONFIG_RMT_ISR_IRAM_SAFE it also runs while the flash cache is disabled
+static bool IRAM_ATTR strip_rmt_tx_done(rmt_channel_handle_t, const rmt_tx_done_event_data_t*, void* user) {
+    static_cast<LEDStripRmt*>(user)->on_transmit_complete(esp_timer_get_time());
+    // No need to yield from ISR; LED updates are paced by the manager task
+    return false;
+}
+
 std::unique_ptr<LEDStripRmt> LEDStripRmt::Create(const CreateParams& params) {
     std::unique_ptr<LEDStripRmt> s(new LEDStripRmt(params));
     if (!s->init_handle()) return nullptr;
@@ -107,13 +115,7 @@ bool LEDStripRmt::init_handle() {
 
     // Register TX-done callback to drive non-blocking completion.
     rmt_tx_event_callbacks_t cbs = {};
-    cbs.on_trans_done = [](rmt_channel_handle_t, const rmt_tx_done_event_data_t*, void* user) noexcept -> bool {
-        auto* self = static_cast<LEDStripRmt*>(user);
-        uint64_t now = esp_timer_get_time();
-        self->on_transmit_complete(now);
-        // No need to yield from ISR; LED updates are paced by the manager task
-        return false;
-    };
+    cbs.on_trans_done = strip_rmt_tx_done;
     err = rmt_tx_register_event_callbacks(rmt_chan_, &cbs, this);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "rmt_tx_register_event_callbacks failed: %s", esp_err_to_name(err));
@@ -316,7 +318,7 @@ bool LEDStripRmt::flush_if_dirty(uint64_t now_us, uint64_t max_quiescent_us) {
     return true;
 }
 
-void LEDStripRmt::on_transmit_complete(uint64_t now_us) {
+void IRAM_ATTR LEDStripRmt::on_transmit_complete(uint64_t now_us) {
     transmitting_ = false;
     if (now_us > expected_done_us_) expected_done_us_ = now_us;
 
@@ -3,6 +3,7 @@
 #include "LEDStrip.h"
 #include "esp_timer.h"
 #include "PsramAllocator.h"
+#include "InternalAllocator.h"
 #include <vector>
 #include <memory>
 #include "esp_err.h"
@@ -115,8 +116,9 @@ private:
     rmt_encoder_handle_t strip_encoder_ = nullptr;
     // Number of bytes per *physical* LED the encoder expects (3 = GRB, 4 = GRBW).
     uint8_t bytes_per_pixel_ = 3;
-    // Staging buffer passed to rmt_transmit(), ordered as GRB/GRBW per physical LED.
-    std::vector<uint8_t, PsramAllocator<uint8_t>> tx_buf_;
+    // Staging buffer passed to rmt_transmit(), ordered as GRB/GRBW per physical LED. Read by the encoder
+    // from the RMT ISR, also during flash writes: internal RAM.
+    std::vector<uint8_t, InternalAllocator<uint8_t>> tx_buf_;
 
     Stats stats_;
 
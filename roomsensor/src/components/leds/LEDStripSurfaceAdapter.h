@@ -20,14 +20,18 @@ public:
         std::vector<int> enable_gpios;
         size_t rows = 1;
         size_t cols = 1;
+        // Carry 16-bit pixels to the output stage and temporally dither them down to 8 bits.
+        // The manager only enables this for strips short enough to refresh at several hundred Hz.
+        bool temporal_dither = false;
     };
 
     LEDStripSurfaceAdapter(const Params& p,
                            std::unique_ptr<internal::LEDCoordinateMapper> mapper,
                            std::unique_ptr<internal::LEDWireEncoder> encoder)
-        : gpio_(p.gpio), enable_gpios_(p.enable_gpios), rows_(p.rows), cols_(p.cols) {
-        surface_.reset(new LEDSurfaceImpl(rows_, cols_, std::move(mapper), std::move(encoder)));
+        : gpio_(p.gpio), enable_gpios_(p.enable_gpios), rows_(p.rows), cols_(p.cols), temporal_dither_(p.temporal_dither) {
+        surface_.reset(new LEDSurfaceImpl(rows_, cols_, std::move(mapper), std::move(encoder), p.temporal_dither));
         shadow_rgba_.assign(rows_ * cols_ * 4, 0);
+        if (p.temporal_dither) shadow_rgba16_.assign(rows_ * cols_ * 4, 0);
         if (!enable_gpios_.empty()) {
             uint64_t mask = 0;
             for (int pin : enable_gpios_) { if (pin >= 0) mask |= (1ULL << pin); }
@@ -59,6 +63,7 @@ public:
     }
 
     bool set_pixel(size_t index, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) override {
+        if (indexed_) set_indexed_mode(false);
         if (index >= length()) return false;
         size_t row = index / cols_;
         size_t col = index % cols_;
@@ -66,11 +71,79 @@ public:
         size_t off = index * 4;
         bool changed = (shadow_rgba_[off] != r) || (shadow_rgba_[off+1] != g) || (shadow_rgba_[off+2] != b) || (shadow_rgba_[off+3] != w);
         shadow_rgba_[off] = r; shadow_rgba_[off+1] = g; shadow_rgba_[off+2] = b; shadow_rgba_[off+3] = w;
+        if (!shadow_rgba16_.empty()) {
+            // Keep the 16-bit shadow in sync so a later set_pixel16 compares against what is displayed
+            uint16_t* p16 = &shadow_rgba16_[off];
+            uint16_t r16 = widen_u8(r), g16 = widen_u8(g), b16 = widen_u8(b), w16 = widen_u8(w);
+            if (p16[0] != r16 || p16[1] != g16 || p16[2] != b16 || p16[3] != w16) changed = true;
+            p16[0] = r16; p16[1] = g16; p16[2] = b16; p16[3] = w16;
+        }
+        if (changed) dirty_ = true;
+        return changed;
+    }
+
+    bool set_pixel16(size_t index, uint16_t r, uint16_t g, uint16_t b, uint16_t w = 0) override {
+        if (indexed_) set_indexed_mode(false);
+        if (shadow_rgba16_.empty()) {
+            return set_pixel(index, narrow_u16(r), narrow_u16(g), narrow_u16(b), narrow_u16(w));
+        }
+        if (index >= length()) return false;
+        size_t row = index / cols_;
+        size_t col = index % cols_;
+        surface_->set16(row, col, r, g, b, w);
+        size_t off = index * 4;
+        uint16_t* p16 = &shadow_rgba16_[off];
+        bool changed = (p16[0] != r) || (p16[1] != g) || (p16[2] != b) || (p16[3] != w);
+        p16[0] = r; p16[1] = g; p16[2] = b; p16[3] = w;
+        // 8-bit shadow holds the rounded value for get_pixel() and power decisions
+        shadow_rgba_[off] = narrow_u16(r); shadow_rgba_[off+1] = narrow_u16(g);
+        shadow_rgba_[off+2] = narrow_u16(b); shadow_rgba_[off+3] = narrow_u16(w);
+        if (changed) dirty_ = true;
+        return changed;
+    }
+
+    bool set_indexed_mode(bool on) override {
+        if (on == indexed_) return true;
+        if (on) {
+            if (!surface_->set_indexed(true)) return false;
+            // The surface's index buffer replaces the RGBA shadows while indexed
+            decltype(shadow_rgba_)().swap(shadow_rgba_);
+            decltype(shadow_rgba16_)().swap(shadow_rgba16_);
+        } else {
+            // Rebuild the shadows from what is displayed so change detection continues seamlessly
+            shadow_rgba_.assign(rows_ * cols_ * 4, 0);
+            if (temporal_dither_) shadow_rgba16_.assign(rows_ * cols_ * 4, 0);
+            for (size_t i = 0; i < length(); ++i) {
+                uint8_t* px = &shadow_rgba_[i * 4];
+                surface_->get_indexed_color(i / cols_, i % cols_, px[0], px[1], px[2], px[3]);
+                if (!shadow_rgba16_.empty()) {
+                    for (int c = 0; c < 4; ++c) shadow_rgba16_[i * 4 + c] = widen_u8(px[c]);
+                }
+            }
+            surface_->set_indexed(false);
+        }
+        indexed_ = on;
+        dirty_ = true;
+        return true;
+    }
+    bool indexed_mode() const override { return indexed_; }
+
+    bool set_pixel_index(size_t index, uint8_t palette_index) override {
+        if (!indexed_ || index >= length()) return false;
+        bool changed = surface_->set_index(index / cols_, index % cols_, palette_index);
         if (changed) dirty_ = true;
         return changed;
     }
 
+    void set_palette(const LEDPalette& palette) override {
+        if (indexed_ && surface_->set_palette(palette)) dirty_ = true;
+    }
+
     bool get_pixel(size_t index, uint8_t& r, uint8_t& g, uint8_t& b, uint8_t& w) const override {
+        if (indexed_) {
+            if (index >= length()) return false;
+            return surface_->get_indexed_color(index / cols_, index % cols_, r, g, b, w);
+        }
         if (index >= shadow_rgba_.size() / 4) return false;
         size_t off = index * 4;
         r = shadow_rgba_[off]; g = shadow_rgba_[off+1]; b = shadow_rgba_[off+2]; w = shadow_rgba_[off+3];
@@ -78,15 +151,18 @@ public:
     }
 
     void clear() override {
+        if (indexed_) set_indexed_mode(false);
         surface_->clear();
         std::fill(shadow_rgba_.begin(), shadow_rgba_.end(), 0u);
+        std::fill(shadow_rgba16_.begin(), shadow_rgba16_.end(), 0u);
         dirty_ = true;
     }
 
     bool flush_if_dirty(uint64_t now_us, uint64_t max_quiescent_us) override {
         (void)now_us;
         if (!dirty_) {
-            if (max_quiescent_us == 0) {
+            // A dithered frame with fractional values only looks right when refreshed every tick
+            if (max_quiescent_us == 0 || surface_->dither_active()) {
                 // Force a transmit even if not marked dirty
                 return surface_->flush();
             }
@@ -101,6 +177,11 @@ public:
     void on_transmit_complete(uint64_t now_us) override { (void)now_us; /* no-op */ }
 
     bool uses_dma() const override { return false; }
+    bool temporal_dither_enabled() const override { return surface_->dither_enabled(); }
+    uint32_t take_dither_ns_per_pixel() override { return surface_->take_dither_ns_per_pixel(); }
+    void set_output_scale(uint32_t q16) override {
+        if (surface_->set_output_scale(q16)) dirty_ = true;
+    }
     bool has_enable_pin() const override { return !enable_gpios_.empty(); }
     void set_power_enabled(bool on) override {
         if (enable_gpios_.empty()) return;
@@ -126,10 +207,14 @@ private:
     std::vector<int> enable_gpios_;
     size_t rows_ = 1;
     size_t cols_ = 1;
+    bool temporal_dither_ = false;
     bool power_enabled_ = false;
+    bool indexed_ = false; // palette-indexed mode; RGBA shadows are released while set
     std::unique_ptr<LEDSurfaceImpl> surface_;
     // Shadow buffer can be large: rows*cols*4
     std::vector<uint8_t, PsramAllocator<uint8_t>> shadow_rgba_;
+    // 16-bit shadow for change detection; only allocated when temporal dithering is enabled
+    std::vector<uint16_t, PsramAllocator<uint16_t>> shadow_rgba16_;
     bool dirty_ = false;
 };
 
@@ -17,6 +17,10 @@ public:
     // Set logical RGBA at (row, col), row-major coordinates.
     virtual void set(size_t row, size_t col, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) = 0;
 
+    // Set logical RGBA at (row, col) with 16-bit channels. Surfaces without a high-precision
+    // buffer round to 8 bits.
+    virtual void set16(size_t row, size_t col, uint16_t r, uint16_t g, uint16_t b, uint16_t w = 0) = 0;
+
     // Clear entire logical surface to zeros.
     virtual void clear() = 0;
 
@@ -3,9 +3,13 @@
 #include "LEDSurface.h"
 #include "LEDGrid.h"
 #include "LEDWireEncoder.h"
+#include "LEDTemporalDither.h"
+#include "LEDPalette.h"
+#include "esp_timer.h"
 #include <vector>
 #include "PsramAllocator.h"
 #include <memory>
+#include <cstring>
 
 namespace leds {
 
@@ -14,39 +18,186 @@ public:
     LEDSurfaceImpl(size_t rows,
                    size_t cols,
                    std::unique_ptr<internal::LEDCoordinateMapper> mapper,
-                   std::unique_ptr<internal::LEDWireEncoder> encoder)
+                   std::unique_ptr<internal::LEDWireEncoder> encoder,
+                   bool temporal_dither = false)
         : rows_(rows), cols_(cols), mapper_(std::move(mapper)), encoder_(std::move(encoder)) {
         logical_rgba_.assign(rows_ * cols_ * 4, 0);
         frame_bytes_.resize(encoder_->frame_size_for(rows_, cols_));
+        if (temporal_dither) {
+            // 16-bit logical frame is the source of truth; logical_rgba_ becomes the per-frame quantized copy
+            logical_rgba16_.assign(rows_ * cols_ * 4, 0);
+            dither_.resize(rows_ * cols_ * 4);
+        }
     }
 
     size_t rows() const override { return rows_; }
     size_t cols() const override { return cols_; }
 
     void set(size_t row, size_t col, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) override {
-        size_t mr = row, mc = col;
-        if (mapper_) mapper_->map(row, col, mr, mc);
-        if (mr >= rows_ || mc >= cols_) return;
-        size_t idx = (mr * cols_ + mc) * 4;
+        size_t idx = 0;
+        if (!mapped_index(row, col, idx)) return;
         logical_rgba_[idx+0] = r;
         logical_rgba_[idx+1] = g;
         logical_rgba_[idx+2] = b;
         logical_rgba_[idx+3] = w;
+        if (!logical_rgba16_.empty()) {
+            logical_rgba16_[idx+0] = widen_u8(r);
+            logical_rgba16_[idx+1] = widen_u8(g);
+            logical_rgba16_[idx+2] = widen_u8(b);
+            logical_rgba16_[idx+3] = widen_u8(w);
+        }
+    }
+
+    void set16(size_t row, size_t col, uint16_t r, uint16_t g, uint16_t b, uint16_t w = 0) override {
+        size_t idx = 0;
+        if (!mapped_index(row, col, idx)) return;
+        if (logical_rgba16_.empty()) {
+            logical_rgba_[idx+0] = narrow_u16(r);
+            logical_rgba_[idx+1] = narrow_u16(g);
+            logical_rgba_[idx+2] = narrow_u16(b);
+            logical_rgba_[idx+3] = narrow_u16(w);
+            return;
+        }
+        logical_rgba16_[idx+0] = r;
+        logical_rgba16_[idx+1] = g;
+        logical_rgba16_[idx+2] = b;
+        logical_rgba16_[idx+3] = w;
     }
 
     void clear() override {
         std::fill(logical_rgba_.begin(), logical_rgba_.end(), 0u);
+        std::fill(logical_rgba16_.begin(), logical_rgba16_.end(), 0u);
+    }
+
+    // Palette-indexed mode. Indices are stored in mapped (wire) order and expanded into the logical frame
+    // at flush time, only when an index or the palette changed. Leaving the mode expands once more so the
+    // logical frame continues from what was displayed.
+    bool set_indexed(bool on) {
+        if (on == indexed()) return true;
+        if (on) {
+            indices_.assign(rows_ * cols_, 0);
+            palette_.reset(new LEDPalette());
+            palette8_.reset(new uint8_t[LEDPalette::kSize * 4]());
+            indexed_dirty_ = true;
+            return true;
+        }
+        expand_indexed();
+        decltype(indices_)().swap(indices_);
+        palette_.reset();
+        palette8_.reset();
+        return true;
+    }
+    bool indexed() const { return !indices_.empty(); }
+
+    bool set_index(size_t row, size_t col, uint8_t v) {
+        size_t idx = 0;
+        if (!indexed() || !mapped_index(row, col, idx)) return false;
+        uint8_t& cur = indices_[idx / 4];
+        if (cur == v) return false;
+        cur = v;
+        indexed_dirty_ = true;
+        return true;
+    }
+    // Palette color (8-bit) of the pixel at (row, col); false if not in indexed mode
+    bool get_indexed_color(size_t row, size_t col, uint8_t& r, uint8_t& g, uint8_t& b, uint8_t& w) const {
+        size_t idx = 0;
+        if (!indexed() || !mapped_index(row, col, idx)) return false;
+        const uint8_t* p = &palette8_[indices_[idx / 4] * 4];
+        r = p[0]; g = p[1]; b = p[2]; w = p[3];
+        return true;
+    }
+    const LEDPalette* palette() const { return palette_.get(); }
+    // Returns true if any entry changed
+    bool set_palette(const LEDPalette& pal) {
+        if (!indexed() || *palette_ == pal) return false;
+        *palette_ = pal;
+        for (size_t i = 0; i < LEDPalette::kSize; ++i) {
+            for (int c = 0; c < 4; ++c) palette8_[i * 4 + c] = narrow_u16(pal.rgbw[i][c]);
+        }
+        indexed_dirty_ = true;
+        return true;
     }
 
     bool flush() override {
         if (!encoder_ || encoder_->is_busy()) return false;
-        encoder_->encode_frame(logical_rgba_.data(), rows_, cols_, frame_bytes_.data());
+        if (indexed_dirty_) expand_indexed();
+        const uint8_t* out = logical_rgba_.data();
+        if (!logical_rgba16_.empty()) {
+            // Quantize the 16-bit frame for this refresh; time it so the cost per pixel can be reported
+            int64_t t0 = esp_timer_get_time();
+            const uint16_t* src = logical_rgba16_.data();
+            if (output_scale_q16_ < kScaleUnity) {
+                scaled_rgba16_.resize(logical_rgba16_.size());
+                for (size_t i = 0; i < logical_rgba16_.size(); ++i) {
+                    scaled_rgba16_[i] = static_cast<uint16_t>((static_cast<uint32_t>(src[i]) * output_scale_q16_) / kScaleUnity);
+                }
+                src = scaled_rgba16_.data();
+            }
+            dither_active_ = dither_.quantize(src, logical_rgba_.data(), logical_rgba16_.size());
+            dither_busy_us_ += static_cast<uint64_t>(esp_timer_get_time() - t0);
+            dither_pixels_ += rows_ * cols_;
+        } else if (output_scale_q16_ < kScaleUnity) {
+            // Scale a copy so the logical frame keeps full precision for when the limit is lifted
+            scaled_rgba_.resize(logical_rgba_.size());
+            for (size_t i = 0; i < logical_rgba_.size(); ++i) {
+                scaled_rgba_[i] = static_cast<uint8_t>((static_cast<uint32_t>(logical_rgba_[i]) * output_scale_q16_ + (kScaleUnity / 2)) / kScaleUnity);
+            }
+            out = scaled_rgba_.data();
+        }
+        encoder_->encode_frame(out, rows_, cols_, frame_bytes_.data());
         return encoder_->transmit_frame(frame_bytes_.data(), frame_bytes_.size());
     }
 
+    // Global output scale applied at flush time (Q16, 65535 = unity), used by the current limiter.
+    // Returns true if the value changed.
+    bool set_output_scale(uint32_t q16) {
+        if (q16 > kScaleUnity) q16 = kScaleUnity;
+        if (q16 == output_scale_q16_) return false;
+        output_scale_q16_ = q16;
+        if (q16 == kScaleUnity) {
+            // Release scratch buffers once limiting ends
+            decltype(scaled_rgba_)().swap(scaled_rgba_);
+            decltype(scaled_rgba16_)().swap(scaled_rgba16_);
+        }
+        return true;
+    }
+    uint32_t output_scale() const { return output_scale_q16_; }
+
     bool is_busy() const override { return encoder_ ? encoder_->is_busy() : false; }
 
+    // Temporal dithering state: enabled at construction; active while the last quantized frame
+    // carried fractional values and therefore needs continuous refresh to average out.
+    bool dither_enabled() const { return !logical_rgba16_.empty(); }
+    bool dither_active() const { return dither_active_; }
+
+    // Average quantize cost in ns/pixel since the previous call (0 if no frames were dithered).
+    uint32_t take_dither_ns_per_pixel() {
+        uint32_t ns = dither_pixels_ ? static_cast<uint32_t>((dither_busy_us_ * 1000ull) / dither_pixels_) : 0;
+        dither_busy_us_ = 0;
+        dither_pixels_ = 0;
+        return ns;
+    }
+
 private:
+    void expand_indexed() {
+        if (!indexed() || !indexed_dirty_) return;
+        const size_t n = indices_.size();
+        if (!logical_rgba16_.empty()) {
+            for (size_t i = 0; i < n; ++i) std::memcpy(&logical_rgba16_[i * 4], palette_->rgbw[indices_[i]], 4 * sizeof(uint16_t));
+        } else {
+            for (size_t i = 0; i < n; ++i) std::memcpy(&logical_rgba_[i * 4], &palette8_[indices_[i] * 4], 4);
+        }
+        indexed_dirty_ = false;
+    }
+
+    bool mapped_index(size_t row, size_t col, size_t& idx) const {
+        size_t mr = row, mc = col;
+        if (mapper_) mapper_->map(row, col, mr, mc);
+        if (mr >= rows_ || mc >= cols_) return false;
+        idx = (mr * cols_ + mc) * 4;
+        return true;
+    }
+
     size_t rows_ = 0;
     size_t cols_ = 0;
     std::unique_ptr<internal::LEDCoordinateMapper> mapper_;
@@ -54,8 +205,22 @@ private:
     // Large frame buffers → store in PSRAM
     std::vector<uint8_t, PsramAllocator<uint8_t>> logical_rgba_;
     std::vector<uint8_t, PsramAllocator<uint8_t>> frame_bytes_;
+    // Optional 16-bit logical frame (temporal dithering only)
+    std::vector<uint16_t, PsramAllocator<uint16_t>> logical_rgba16_;
+    internal::TemporalDither dither_;
+    bool dither_active_ = false;
+    uint64_t dither_busy_us_ = 0;
+    uint64_t dither_pixels_ = 0;
+    // Palette-indexed mode state; only allocated while the mode is active
+    std::vector<uint8_t, PsramAllocator<uint8_t>> indices_;
+    std::unique_ptr<LEDPalette> palette_;
+    std::unique_ptr<uint8_t[]> palette8_; // palette_ rounded to 8 bits, for non-dithered expansion
+    bool indexed_dirty_ = false;
+    // Output scaling (current limiter); scratch buffers are only allocated while scaling is active
+    static constexpr uint32_t kScaleUnity = 65535;
+    uint32_t output_scale_q16_ = kScaleUnity;
+    std::vector<uint8_t, PsramAllocator<uint8_t>> scaled_rgba_;
+    std::vector<uint16_t, PsramAllocator<uint16_t>> scaled_rgba16_;
 };
 
 } // namespace leds
-
-
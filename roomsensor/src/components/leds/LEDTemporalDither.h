@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "PsramAllocator.h"
+
+namespace leds {
+
+// 8 <-> 16 bit channel helpers for the high-precision pixel path.
+// 16-bit channels use the full 0..65535 range; an 8-bit value v maps to v * 257 so that
+// 8-bit sources survive a round trip exactly.
+static inline uint16_t widen_u8(uint8_t v) { return static_cast<uint16_t>(v * 257u); }
+static inline uint8_t narrow_u16(uint16_t v) { return static_cast<uint8_t>((static_cast<uint32_t>(v) + 128u) / 257u); }
+
+namespace internal {
+
+// Temporal (frame-to-frame) first-order error diffusion from 16-bit to 8-bit channels.
+// Only the top kFractionBits of the fraction are diffused, the rest is truncated: each channel keeps a
+// residual below 1 << kFractionBits and emits an occasional +1 LSB, so the time-averaged output matches
+// the input to 1/8 LSB. The +1 pattern repeats within 8 frames, so its slowest component is fps / 8
+// (25 Hz at the 200 Hz LED tick); diffusing all 8 bits would blink once every 256 frames at the low
+// levels this is meant to smooth.
+class TemporalDither {
+public:
+    static constexpr uint32_t kFractionBits = 3;
+    static constexpr uint32_t kPeriodFrames = 1u << kFractionBits;
+
+    void resize(size_t channels) { residual_.assign(channels, 0); }
+    size_t size() const { return residual_.size(); }
+
+    // Quantize 'n' channels (n <= size()). Returns true if any channel carried a dithered fraction,
+    // i.e. the output will keep changing between frames and the strip should keep refreshing.
+    bool quantize(const uint16_t* in, uint8_t* out, size_t n) {
+        bool fractional = false;
+        uint8_t* res = residual_.data();
+        for (size_t i = 0; i < n; ++i) {
+            // Rescale 0..65535 onto 8.8 fixed point 0..0xFF00 (exact for widened 8-bit values)
+            uint32_t x = in[i] - (in[i] >> 8);
+            uint32_t level = x >> 8;
+            uint32_t frac = (x & 0xFFu) >> (8 - kFractionBits);
+            uint32_t acc = frac + res[i];
+            if (acc >= kPeriodFrames) { ++level; acc -= kPeriodFrames; }
+            res[i] = static_cast<uint8_t>(acc);
+            out[i] = static_cast<uint8_t>(level);
+            fractional |= (frac != 0);
+        }
+        return fractional;
+    }
+
+private:
+    std::vector<uint8_t, PsramAllocator<uint8_t>> residual_;
+};
+
+// Rough on-wire duration of a full frame for 800 kHz one-wire LED chips, including the reset gap.
+// Used to decide whether a strip refreshes fast enough for temporal dithering to be invisible.
+static inline uint32_t estimate_frame_wire_time_us(size_t physical_leds, size_t bits_per_led) {
+    const uint32_t reset_us = 80; // typical >50us latch gap
+    return static_cast<uint32_t>(physical_leds * bits_per_led * 1250u / 1000u) + reset_us; // 1.25us/bit
+}
+
+} // namespace internal
+} // namespace leds
@@ -9,17 +9,21 @@ public:
     WireEncoderFlipdot(int gpio, bool with_dma, uint32_t rmt_resolution_hz, size_t mem_block_symbols, size_t max_leds);
     ~WireEncoderFlipdot();
 
-    size_t frame_size_for(size_t rows, size_t cols) const override {
-        size_t logical = rows * cols;
-        size_t physical = (logical + 2) / 3; // 3 logical -> 1 physical
-        return physical * 3; // RGB channels carry three logical dots
-    }
+    size_t frame_size_for(size_t rows, size_t cols) const override { return frame_bytes_for(rows * cols); }
 
     void encode_frame(const uint8_t* logical_rgba,
                       size_t rows,
                       size_t cols,
                       uint8_t* out_frame_bytes) const override {
-        size_t logical = rows * cols;
+        encode_pixels(logical_rgba, rows * cols, out_frame_bytes);
+    }
+
+    // Frame format, also used by WireEncoderShared
+    static size_t frame_bytes_for(size_t logical) {
+        size_t physical = (logical + 2) / 3; // 3 logical -> 1 physical
+        return physical * 3; // RGB channels carry three logical dots
+    }
+    static void encode_pixels(const uint8_t* logical_rgba, size_t logical, uint8_t* out_frame_bytes) {
         size_t physical = (logical + 2) / 3;
         for (size_t p = 0; p < physical; ++p) {
             size_t li0 = p * 3 + 0;
@@ -0,0 +1,123 @@
+#include "LEDWireEncoderFlipdotPacked.h"
+#include "driver/rmt_tx.h"
+#include "driver/rmt_encoder.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+
+namespace leds { namespace internal {
+
+static const char* TAG_FDP = "WireEncoderFlipdotPacked";
+
+static bool IRAM_ATTR flipdot_packed_tx_done(rmt_channel_handle_t, const rmt_tx_done_event_data_t*, void* user) {
+    static_cast<WireEncoderFlipdotPacked*>(user)->on_tx_done_isr();
+    return false;
+}
+
+void IRAM_ATTR WireEncoderFlipdotPacked::on_tx_done_isr() {
+    busy_ = false;
+}
+
+WireEncoderFlipdotPacked::WireEncoderFlipdotPacked(int gpio, bool with_dma, uint32_t rmt_resolution_hz, size_t mem_block_symbols, size_t dots)
+    : gpio_(gpio), with_dma_(with_dma), rmt_resolution_hz_(rmt_resolution_hz), mem_block_symbols_(mem_block_symbols),
+      boxes_(flipdot::boxes_for_dots(dots)) {
+    sent_.assign(boxes_ * flipdot::kBoxBytes, 0);
+    packet_.assign(flipdot::max_packet_bytes(boxes_), 0);
+
+    rmt_tx_channel_config_t chan_cfg = {};
+    chan_cfg.gpio_num = static_cast<gpio_num_t>(gpio_);
+    chan_cfg.clk_src = RMT_CLK_SRC_DEFAULT;
+    chan_cfg.mem_block_symbols = mem_block_symbols_;
+    chan_cfg.resolution_hz = rmt_resolution_hz_;
+    chan_cfg.trans_queue_depth = 1; // one packet in flight
+    chan_cfg.flags.with_dma = with_dma_ ? 1u : 0u;
+    rmt_channel_handle_t chan = nullptr;
+    esp_err_t err = rmt_new_tx_channel(&chan_cfg, &chan);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG_FDP, "rmt_new_tx_channel failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    // WS2812 symbol timing (0.3/0.9 us and 0.9/0.3 us), MSB first; packets are framed by the idle gap
+    const uint32_t t_short = rmt_resolution_hz_ / 1000000u * 3u / 10u;
+    const uint32_t t_long = rmt_resolution_hz_ / 1000000u * 9u / 10u;
+    rmt_bytes_encoder_config_t enc_cfg = {};
+    enc_cfg.bit0.duration0 = t_short;
+    enc_cfg.bit0.level0 = 1;
+    enc_cfg.bit0.duration1 = t_long;
+    enc_cfg.bit0.level1 = 0;
+    enc_cfg.bit1.duration0 = t_long;
+    enc_cfg.bit1.level0 = 1;
+    enc_cfg.bit1.duration1 = t_short;
+    enc_cfg.bit1.level1 = 0;
+    enc_cfg.flags.msb_first = 1;
+    rmt_encoder_handle_t enc = nullptr;
+    err = rmt_new_bytes_encoder(&enc_cfg, &enc);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG_FDP, "rmt_new_bytes_encoder failed: %s", esp_err_to_name(err));
+        rmt_del_channel(chan);
+        return;
+    }
+
+    rmt_tx_event_callbacks_t cbs = {};
+    cbs.on_trans_done = flipdot_packed_tx_done;
+    err = rmt_tx_register_event_callbacks(chan, &cbs, this);
+    if (err == ESP_OK) err = rmt_enable(chan);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG_FDP, "RMT channel setup failed: %s", esp_err_to_name(err));
+        rmt_del_encoder(enc);
+        rmt_del_channel(chan);
+        return;
+    }
+    channel_ = chan;
+    encoder_ = enc;
+    ESP_LOGI(TAG_FDP, "Packed flipdot output on GPIO %d: %u boxes, keyframe %u bytes", gpio_, (unsigned)boxes_,
+             (unsigned)packet_.size());
+}
+
+WireEncoderFlipdotPacked::~WireEncoderFlipdotPacked() {
+    if (channel_) {
+        auto chan = static_cast<rmt_channel_handle_t>(channel_);
+        (void)rmt_tx_wait_all_done(chan, 100);
+        (void)rmt_disable(chan);
+        rmt_del_channel(chan);
+        channel_ = nullptr;
+    }
+    if (encoder_) {
+        rmt_del_encoder(static_cast<rmt_encoder_handle_t>(encoder_));
+        encoder_ = nullptr;
+    }
+}
+
+bool WireEncoderFlipdotPacked::transmit_frame(const uint8_t* frame_bytes, size_t frame_size_bytes) {
+    if (!channel_ || !frame_bytes || frame_size_bytes != sent_.size()) return false;
+    if (busy_) return false;
+
+    bool keyframe = !have_sent_ || since_keyframe_ >= kKeyframeInterval;
+    size_t len = flipdot::encode_packet(frame_bytes, have_sent_ ? sent_.data() : nullptr, boxes_, keyframe, seq_,
+                                        packet_.data());
+    if (len == 0) {
+        // Nothing changed since the last packet
+        ++since_keyframe_;
+        return true;
+    }
+    since_keyframe_ = (packet_[2] & flipdot::kFlagFull) ? 0 : since_keyframe_ + 1;
+    memcpy(sent_.data(), frame_bytes, frame_size_bytes);
+    have_sent_ = true;
+    ++seq_;
+
+    rmt_transmit_config_t tx_conf = {};
+    tx_conf.loop_count = 0;
+    tx_conf.flags.eot_level = 0;
+    busy_ = true;
+    esp_err_t err = rmt_transmit(static_cast<rmt_channel_handle_t>(channel_), static_cast<rmt_encoder_handle_t>(encoder_),
+                                 packet_.data(), len, &tx_conf);
+    if (err != ESP_OK) {
+        busy_ = false;
+        have_sent_ = false; // receivers may be out of sync; start over with a keyframe
+        ESP_LOGW(TAG_FDP, "rmt_transmit failed: %s", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+} } // namespace leds::internal
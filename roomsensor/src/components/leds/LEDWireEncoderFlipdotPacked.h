@@ -0,0 +1,67 @@
+#pragma once
+
+#include "LEDWireEncoder.h"
+#include "FlipdotPacket.h"
+#include "InternalAllocator.h"
+#include <vector>
+
+namespace leds { namespace internal {
+
+// Flipdot output using the bit-packed protocol in FlipdotPacket.h (1 bit per dot, dirty 8x8 boxes only)
+// instead of one WS2812 byte per dot. Needs receivers running the matching decoder.
+// encode_frame() packs the frame into box bitmaps; transmit_frame() diffs them against what was last sent
+// and sends one packet through an RMT bytes encoder. A keyframe goes out first and then every
+// kKeyframeInterval transmits, so a receiver that dropped a packet resynchronizes.
+class WireEncoderFlipdotPacked final : public LEDWireEncoder {
+public:
+    WireEncoderFlipdotPacked(int gpio, bool with_dma, uint32_t rmt_resolution_hz, size_t mem_block_symbols, size_t dots);
+    ~WireEncoderFlipdotPacked();
+
+    size_t frame_size_for(size_t rows, size_t cols) const override {
+        return flipdot::boxes_for_dots(rows * cols) * flipdot::kBoxBytes;
+    }
+
+    void encode_frame(const uint8_t* logical_rgba,
+                      size_t rows,
+                      size_t cols,
+                      uint8_t* out_frame_bytes) const override {
+        // Frame arrives in chain order (FlipdotGridMapper); pad the last box with dark dots
+        size_t dots = rows * cols;
+        size_t bytes = frame_size_for(rows, cols);
+        for (size_t i = 0; i < bytes; ++i) {
+            uint8_t bits = 0;
+            for (size_t k = 0; k < 8; ++k) {
+                size_t idx = i * 8 + k;
+                if (idx >= dots) break;
+                const uint8_t* px = logical_rgba + idx * 4;
+                if (px[0] | px[1] | px[2] | px[3]) bits |= static_cast<uint8_t>(1u << k);
+            }
+            out_frame_bytes[i] = bits;
+        }
+    }
+
+    bool transmit_frame(const uint8_t* frame_bytes, size_t frame_size_bytes) override;
+    bool is_busy() const override { return busy_; }
+    // RMT TX-done, from the ISR (IRAM)
+    void on_tx_done_isr();
+
+    static constexpr uint32_t kKeyframeInterval = 100;
+
+private:
+    int gpio_ = -1;
+    bool with_dma_ = false;
+    uint32_t rmt_resolution_hz_ = 10 * 1000 * 1000;
+    size_t mem_block_symbols_ = 48;
+    size_t boxes_ = 0;
+    void* channel_ = nullptr;  // rmt_channel_handle_t
+    void* encoder_ = nullptr;  // rmt_encoder_handle_t
+    std::vector<uint8_t> sent_;   // box bitmaps as last transmitted
+    // Read by the encoder from the RMT ISR, also during flash writes: internal RAM
+    std::vector<uint8_t, InternalAllocator<uint8_t>> packet_; // must stay untouched while the RMT transfer runs
+    bool have_sent_ = false;
+    uint32_t since_keyframe_ = 0;
+    uint8_t seq_ = 0;
+    volatile bool busy_ = false;
+};
+
+} } // namespace leds::internal
@@ -9,15 +9,20 @@ public:
     WireEncoderSK6812(int gpio, bool with_dma, uint32_t rmt_resolution_hz, size_t mem_block_symbols, size_t max_leds);
     ~WireEncoderSK6812();
 
-    size_t frame_size_for(size_t rows, size_t cols) const override {
-        return rows * cols * 4; // RGBW per LED
-    }
+    size_t frame_size_for(size_t rows, size_t cols) const override { return frame_bytes_for(rows * cols); }
 
     void encode_frame(const uint8_t* logical_rgba,
                       size_t rows,
                       size_t cols,
                       uint8_t* out_frame_bytes) const override {
-        size_t count = rows * cols;
+        encode_pixels(logical_rgba, rows * cols, out_frame_bytes);
+    }
+
+    // Frame format, also used by WireEncoderShared
+    static size_t frame_bytes_for(size_t count) {
+        return count * 4; // RGBW per LED
+    }
+    static void encode_pixels(const uint8_t* logical_rgba, size_t count, uint8_t* out_frame_bytes) {
         for (size_t i = 0; i < count; ++i) {
             const uint8_t* px = logical_rgba + i * 4;
             // Driver API takes (r,g,b,w)
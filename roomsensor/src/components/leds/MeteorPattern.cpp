@@ -3,7 +3,6 @@
 #include "esp_random.h"
 #include "esp_log.h"
 #include <algorithm>
-#include <cmath>
 
 namespace leds {
 
@@ -49,7 +48,7 @@ void MeteorPattern::spawn_meteor(uint64_t now_us) {
     m.start_us = now_us;
     // Choose a random center in [0, strip_length_ - 1]
     uint32_t r = esp_random();
-    m.center = static_cast<float>(r % (strip_length_ == 0 ? 1 : strip_length_));
+    m.center = r % strip_length_;
     meteors_.push_back(m);
     last_spawn_us_ = now_us;
 }
@@ -83,49 +82,41 @@ void MeteorPattern::update(LEDStrip& strip, uint64_t now_us) {
         spawn_meteor(now_us);
     }
 
-    // Compute brightness scale
-    float brightness_scale = static_cast<float>(brightness_percent_) / 100.0f;
-
-    // For each pixel, accumulate contribution from all active meteors
-    for (size_t i = 0; i < strip_length_; ++i) {
-        float best_amp = 0.0f;
-        float pos = static_cast<float>(i);
-
-        for (const auto& m : meteors_) {
-            uint64_t elapsed_us = now_us - m.start_us;
-            if (elapsed_us >= dur_us) continue;
-
-            float p = static_cast<float>(elapsed_us) / static_cast<float>(dur_us); // 0..1
-            if (p < 0.0f) p = 0.0f;
-            if (p > 1.0f) p = 1.0f;
-
-            // Meteor grows in radius and fades out over time.
-            // Start as a single bright pixel, then expand and fade over ~duration.
-            float max_radius = std::max(2.0f, static_cast<float>(strip_length_) * 0.2f); // up to 20% of strip
-            float radius = max_radius * p;
-            float dist = std::fabs(pos - m.center);
-            if (dist > radius) continue;
-
-            // Shell profile: strongest near the center, decays with distance.
-            float spatial = 1.0f - (dist / (radius + 1.0f)); // 1 at center, ~0 at radius
-            if (spatial < 0.0f) spatial = 0.0f;
-
-            // Temporal fade: starts bright, fades to 0 by the end.
-            float temporal = 1.0f - p;
-
-            float amp = spatial * temporal;
-            if (amp > best_amp) best_amp = amp;
+    // Strongest contribution per pixel. Each meteor only touches the pixels inside its radius, so the
+    // cost scales with lit pixels rather than strip length x meteors.
+    best_.assign(strip_length_, 0);
+    const q16_t max_radius = std::max<q16_t>(2 * kQ16One, static_cast<q16_t>(strip_length_) * kQ16One / 5); // up to 20% of strip
+    for (const auto& m : meteors_) {
+        uint64_t elapsed_us = now_us - m.start_us;
+        if (elapsed_us >= dur_us) continue;
+
+        q16_t p = static_cast<q16_t>((elapsed_us << 16) / dur_us); // 0..1
+
+        // Meteor grows in radius and fades out over time.
+        // Start as a single bright pixel, then expand and fade over ~duration.
+        q16_t radius = q16_mul(max_radius, p);
+        // Shell profile: strongest near the center, decays with distance (1 at center, ~0 at radius)
+        q16_t inv_extent = q16_div(kQ16One, radius + kQ16One);
+        // Temporal fade: starts bright, fades to 0 by the end.
+        q16_t temporal = kQ16One - p;
+
+        size_t reach = static_cast<size_t>(radius >> 16);
+        size_t lo = (m.center > reach) ? (m.center - reach) : 0;
+        size_t hi = std::min(strip_length_ - 1, m.center + reach);
+        for (size_t i = lo; i <= hi; ++i) {
+            q16_t dist = static_cast<q16_t>(i > m.center ? i - m.center : m.center - i);
+            q16_t spatial = kQ16One - dist * inv_extent;
+            if (spatial <= 0) continue;
+            q16_t amp = q16_mul(spatial, temporal);
+            if (amp > best_[i]) best_[i] = amp;
         }
+    }
 
-        if (best_amp <= 0.0f) {
-            strip.set_pixel(i, 0, 0, 0, 0);
-        } else {
-            float v = best_amp * brightness_scale;
-            if (v > 1.0f) v = 1.0f;
-            uint8_t val = static_cast<uint8_t>(v * 255.0f + 0.5f);
-            // Bright white meteor; favor RGB so it works on RGB strips.
-            strip.set_pixel(i, val, val, val, 0);
-        }
+    q16_t brightness_scale = static_cast<q16_t>(brightness_percent_) * kQ16One / 100;
+    for (size_t i = 0; i < strip_length_; ++i) {
+        // Bright white meteor; favor RGB so it works on RGB strips.
+        uint8_t val = q16_scale_u8(255, q16_mul(best_[i], brightness_scale));
+        strip.set_pixel(i, val, val, val, 0);
     }
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "LEDPattern.h"
+#include "LEDFixedMath.h"
 #include <cstddef>
 #include <vector>
 
@@ -22,7 +23,7 @@ public:
 private:
     struct Meteor {
         uint64_t start_us = 0;  // when this meteor started
-        float center = 0.0f;    // center position in LED index space
+        size_t center = 0;      // center position in LED index space
     };
 
     // Parameters
@@ -34,6 +35,7 @@ private:
     size_t strip_length_ = 0;
     uint64_t last_spawn_us_ = 0;
     std::vector<Meteor> meteors_;
+    std::vector<q16_t> best_; // per-pixel amplitude scratch for update()
 
     // Helpers
     uint64_t meteor_duration_us() const;
@@ -4,7 +4,9 @@
 
 namespace leds {
 
-static void hsv_to_rgb(float h, float s, float v, uint8_t& r, uint8_t& g, uint8_t& b) {
+// HSV -> RGB with 16-bit output so low brightness levels keep their gradient through the
+// high-precision pipeline (see LEDStrip::set_pixel16).
+static void hsv_to_rgb16(float h, float s, float v, uint16_t& r, uint16_t& g, uint16_t& b) {
     float c = v * s;
     float x = c * (1 - fabsf(fmodf(h / 60.0f, 2) - 1));
     float m = v - c;
@@ -15,24 +17,38 @@ static void hsv_to_rgb(float h, float s, float v, uint8_t& r, uint8_t& g, uint8_
     else if (h < 240) { rf = 0; gf = x; bf = c; }
     else if (h < 300) { rf = x; gf = 0; bf = c; }
     else { rf = c; gf = 0; bf = x; }
-    r = static_cast<uint8_t>((rf + m) * 255);
-    g = static_cast<uint8_t>((gf + m) * 255);
-    b = static_cast<uint8_t>((bf + m) * 255);
+    r = static_cast<uint16_t>((rf + m) * 65535.0f + 0.5f);
+    g = static_cast<uint16_t>((gf + m) * 65535.0f + 0.5f);
+    b = static_cast<uint16_t>((bf + m) * 65535.0f + 0.5f);
 }
 
 void RainbowPattern::update(LEDStrip& strip, uint64_t now_us) {
     float speed = (speed_percent_ <= 0) ? 0.01f : (speed_percent_ / 100.0f);
     float t = (now_us - start_us_) * speed / 1'000'000.0f; // seconds
-    for (size_t i = 0; i < strip.length(); ++i) {
-        float hue = fmodf((i * 360.0f / strip.length()) + (t * 60.0f), 360.0f);
-        uint8_t r, g, b;
-        hsv_to_rgb(hue, 1.0f, 1.0f, r, g, b);
-        if (brightness_percent_ < 100) {
-            r = static_cast<uint8_t>((r * brightness_percent_) / 100);
-            g = static_cast<uint8_t>((g * brightness_percent_) / 100);
-            b = static_cast<uint8_t>((b * brightness_percent_) / 100);
+    // Brightness is folded into V so scaling happens at full precision
+    float v = static_cast<float>(brightness_percent_) / 100.0f;
+    size_t n = strip.length();
+    if (n == 0) return;
+    if (n > LEDPalette::kSize && (strip.indexed_mode() || strip.set_indexed_mode(true))) {
+        // Indexed path for long strips: each pixel keeps a fixed hue band; rotating the palette moves the
+        // rainbow, so per-frame color math is bounded by the palette size rather than the strip length.
+        // Shorter strips gain nothing over per-pixel evaluation and stay on the RGB path.
+        const size_t bands = LEDPalette::kSize;
+        for (size_t i = 0; i < n; ++i) strip.set_pixel_index(i, static_cast<uint8_t>((i * bands) / n));
+        for (size_t k = 0; k < bands; ++k) {
+            float hue = fmodf((k * 360.0f / bands) + (t * 60.0f), 360.0f);
+            uint16_t r, g, b;
+            hsv_to_rgb16(hue, 1.0f, v, r, g, b);
+            palette_.set(static_cast<uint8_t>(k), r, g, b, 0);
         }
-        strip.set_pixel(i, r, g, b, 0);
+        strip.set_palette(palette_);
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        float hue = fmodf((i * 360.0f / n) + (t * 60.0f), 360.0f);
+        uint16_t r, g, b;
+        hsv_to_rgb16(hue, 1.0f, v, r, g, b);
+        strip.set_pixel16(i, r, g, b, 0);
     }
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "LEDPattern.h"
+#include "LEDPalette.h"
 
 namespace leds {
 
@@ -20,6 +21,7 @@ private:
     uint64_t start_us_ = 0;
     int speed_percent_ = 50; // 0..100
     int brightness_percent_ = 100; // 0..100
+    LEDPalette palette_; // hue ring for the indexed path
 };
 
 } // namespace leds
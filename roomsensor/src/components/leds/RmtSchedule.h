@@ -0,0 +1,81 @@
+#pragma once
+
+#include "LEDTemporalDither.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace leds {
+namespace internal {
+
+// Planning for time-shared RMT TX channels (RmtSharedChannel.h). Pure arithmetic, no driver calls.
+//
+// A shared channel sends its strips back to back. Each strip occupies one slot per frame: its wire time
+// (estimate_frame_wire_time_us, which already includes the latch gap) plus the cost of moving the channel
+// to the next pin. A channel meets the frame deadline when its slots add up to no more than the frame
+// period at the target rate.
+
+constexpr size_t kRmtTxChannels = 4;            // ESP32-S3
+constexpr uint32_t kRmtRerouteOverheadUs = 40;  // TX-done ISR, pickup on the update task, GPIO matrix switch
+
+static inline uint32_t rmt_slot_us(size_t physical_leds, size_t bits_per_led) {
+    return estimate_frame_wire_time_us(physical_leds, bits_per_led) + kRmtRerouteOverheadUs;
+}
+
+static inline uint32_t rmt_frame_budget_us(uint32_t target_fps) {
+    return target_fps ? 1'000'000u / target_fps : UINT32_MAX;
+}
+
+// Number of strips of this length one channel can serve at target_fps. Never less than 1: a strip that
+// is too long for the rate on its own still gets a channel, just at a lower rate.
+static inline size_t max_strips_per_channel(size_t physical_leds, size_t bits_per_led, uint32_t target_fps) {
+    size_t n = rmt_frame_budget_us(target_fps) / rmt_slot_us(physical_leds, bits_per_led);
+    return n ? n : 1;
+}
+
+struct RmtChannelPlan {
+    std::vector<size_t> channel_of; // per strip: shared channel it is batched on
+    std::vector<uint32_t> load_us;  // per channel: sum of its strips' slots
+    uint32_t budget_us = 0;
+    bool fits = false;              // every channel's load is within budget_us
+};
+
+// Batch strips with the given slot times onto 'channels' shared channels: longest strip first, each onto
+// the least loaded channel (ties to the lower index, so the plan is deterministic).
+static inline RmtChannelPlan plan_rmt_channels(const std::vector<uint32_t>& slot_us, size_t channels,
+                                               uint32_t target_fps) {
+    RmtChannelPlan plan;
+    plan.budget_us = rmt_frame_budget_us(target_fps);
+    plan.channel_of.assign(slot_us.size(), 0);
+    if (channels == 0) return plan;
+    plan.load_us.assign(channels, 0);
+
+    std::vector<size_t> order(slot_us.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    // Insertion sort, stable on index: strip counts are single digits
+    for (size_t i = 1; i < order.size(); ++i) {
+        size_t v = order[i];
+        size_t j = i;
+        while (j > 0 && slot_us[order[j - 1]] < slot_us[v]) {
+            order[j] = order[j - 1];
+            --j;
+        }
+        order[j] = v;
+    }
+    for (size_t idx : order) {
+        size_t best = 0;
+        for (size_t c = 1; c < channels; ++c) {
+            if (plan.load_us[c] < plan.load_us[best]) best = c;
+        }
+        plan.channel_of[idx] = best;
+        plan.load_us[best] += slot_us[idx];
+    }
+    plan.fits = true;
+    for (uint32_t load : plan.load_us) {
+        if (load > plan.budget_us) plan.fits = false;
+    }
+    return plan;
+}
+
+} // namespace internal
+} // namespace leds
@@ -0,0 +1,199 @@
+#include "RmtSharedChannel.h"
+#include "LEDWireEncoderWS2812.h"
+#include "LEDWireEncoderSK6812.h"
+#include "LEDWireEncoderWS2814.h"
+#include "LEDWireEncoderFlipdot.h"
+#include "led_strip_rmt_encoder.h"
+#include "driver/rmt_tx.h"
+#include "driver/gpio.h"
+#include "esp_rom_gpio.h"
+#include "soc/gpio_reg.h"
+#include "soc/gpio_sig_map.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include <algorithm>
+
+namespace leds { namespace internal {
+
+static const char* TAG_SH = "RmtSharedChannel";
+
+static bool IRAM_ATTR shared_channel_tx_done(rmt_channel_handle_t, const rmt_tx_done_event_data_t*, void* user) {
+    static_cast<RmtSharedChannel*>(user)->on_tx_done_isr();
+    return false;
+}
+
+void IRAM_ATTR RmtSharedChannel::on_tx_done_isr() {
+    in_flight_.store(nullptr);
+}
+
+RmtSharedChannel::RmtSharedChannel(int first_gpio, uint32_t rmt_resolution_hz, size_t mem_block_symbols)
+    : resolution_hz_(rmt_resolution_hz) {
+    rmt_tx_channel_config_t chan_cfg = {};
+    chan_cfg.gpio_num = static_cast<gpio_num_t>(first_gpio);
+    chan_cfg.clk_src = RMT_CLK_SRC_DEFAULT;
+    chan_cfg.mem_block_symbols = mem_block_symbols;
+    chan_cfg.resolution_hz = resolution_hz_;
+    chan_cfg.trans_queue_depth = 1; // one member in flight
+    rmt_channel_handle_t chan = nullptr;
+    esp_err_t err = rmt_new_tx_channel(&chan_cfg, &chan);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG_SH, "rmt_new_tx_channel failed: %s", esp_err_to_name(err));
+        return;
+    }
+    // The driver routed its TX signal to first_gpio; remember which signal that is so it can be moved
+    out_signal_ = static_cast<int>(REG_READ(GPIO_FUNC0_OUT_SEL_CFG_REG + 4 * first_gpio) & GPIO_FUNC0_OUT_SEL_V);
+    if (out_signal_ == SIG_GPIO_OUT_IDX) {
+        ESP_LOGE(TAG_SH, "RMT signal not found on GPIO %d", first_gpio);
+        rmt_del_channel(chan);
+        return;
+    }
+
+    rmt_tx_event_callbacks_t cbs = {};
+    cbs.on_trans_done = shared_channel_tx_done;
+    err = rmt_tx_register_event_callbacks(chan, &cbs, this);
+    if (err == ESP_OK) err = rmt_enable(chan);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG_SH, "RMT channel setup failed: %s", esp_err_to_name(err));
+        rmt_del_channel(chan);
+        return;
+    }
+    channel_ = chan;
+    routed_gpio_ = first_gpio;
+}
+
+RmtSharedChannel::~RmtSharedChannel() {
+    if (!channel_) return;
+    auto chan = static_cast<rmt_channel_handle_t>(channel_);
+    (void)rmt_tx_wait_all_done(chan, 100);
+    (void)rmt_disable(chan);
+    rmt_del_channel(chan);
+    channel_ = nullptr;
+}
+
+void RmtSharedChannel::attach(WireEncoderShared* member) {
+    if (member->gpio_ != routed_gpio_) {
+        // Parked pins idle low until the channel is routed to them
+        gpio_config_t io_conf = {};
+        io_conf.mode = GPIO_MODE_OUTPUT;
+        io_conf.pin_bit_mask = 1ULL << member->gpio_;
+        gpio_config(&io_conf);
+        gpio_set_level(static_cast<gpio_num_t>(member->gpio_), 0);
+    }
+    members_.push_back(member);
+}
+
+void RmtSharedChannel::detach(WireEncoderShared* member) {
+    // Its tx buffer is about to go away
+    if (channel_ && in_flight_.load() == member) {
+        (void)rmt_tx_wait_all_done(static_cast<rmt_channel_handle_t>(channel_), 100);
+    }
+    members_.erase(std::remove(members_.begin(), members_.end(), member), members_.end());
+    next_ = 0;
+}
+
+void RmtSharedChannel::route_to(int gpio) {
+    if (gpio == routed_gpio_) return;
+    // The channel is idle (output low), so switching pins cannot cut a bit short
+    if (routed_gpio_ >= 0) {
+        gpio_set_level(static_cast<gpio_num_t>(routed_gpio_), 0);
+        esp_rom_gpio_connect_out_signal(routed_gpio_, SIG_GPIO_OUT_IDX, false, false);
+    }
+    esp_rom_gpio_connect_out_signal(gpio, out_signal_, false, false);
+    routed_gpio_ = gpio;
+}
+
+void RmtSharedChannel::pump() {
+    if (!channel_ || in_flight_.load() != nullptr) return;
+    const size_t n = members_.size();
+    for (size_t k = 0; k < n; ++k) {
+        WireEncoderShared* m = members_[(next_ + k) % n];
+        if (!m->queued_) continue;
+        next_ = (next_ + k + 1) % n;
+        m->queued_ = false;
+        route_to(m->gpio_);
+        in_flight_.store(m);
+        rmt_transmit_config_t tx_conf = {};
+        esp_err_t err = rmt_transmit(static_cast<rmt_channel_handle_t>(channel_),
+                                     static_cast<rmt_encoder_handle_t>(m->encoder_), m->tx_buf_.data(),
+                                     m->tx_len_, &tx_conf);
+        if (err != ESP_OK) {
+            // Drop this frame; the strip sends again on its next flush
+            in_flight_.store(nullptr);
+            ESP_LOGW(TAG_SH, "rmt_transmit failed on GPIO %d: %s", m->gpio_, esp_err_to_name(err));
+            continue;
+        }
+        return;
+    }
+}
+
+bool WireEncoderShared::format_for(config::LEDConfig::Chip chip, Format& out) {
+    using Chip = config::LEDConfig::Chip;
+    switch (chip) {
+        case Chip::WS2812:
+            out = {&WireEncoderWS2812::frame_bytes_for, &WireEncoderWS2812::encode_pixels, 3, LED_MODEL_WS2812};
+            return true;
+        case Chip::SK6812:
+            out = {&WireEncoderSK6812::frame_bytes_for, &WireEncoderSK6812::encode_pixels, 4, LED_MODEL_SK6812};
+            return true;
+        case Chip::WS2814:
+            // WS2812 timings; the WRGB remap is part of the frame format
+            out = {&WireEncoderWS2814::frame_bytes_for, &WireEncoderWS2814::encode_pixels, 4, LED_MODEL_WS2812};
+            return true;
+        case Chip::FLIPDOT:
+            out = {&WireEncoderFlipdot::frame_bytes_for, &WireEncoderFlipdot::encode_pixels, 3, LED_MODEL_WS2812};
+            return true;
+        default:
+            return false;
+    }
+}
+
+WireEncoderShared::WireEncoderShared(RmtSharedChannel& channel, int gpio, const Format& format, size_t logical_leds)
+    : channel_(channel), gpio_(gpio), format_(format) {
+    tx_buf_.assign(format_.frame_bytes(logical_leds), 0);
+    led_strip_encoder_config_t enc_cfg = {
+        .resolution = channel_.resolution_hz(),
+        .led_model = static_cast<led_model_t>(format_.led_model),
+    };
+    rmt_encoder_handle_t enc = nullptr;
+    esp_err_t err = rmt_new_led_strip_encoder(&enc_cfg, &enc);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG_SH, "rmt_new_led_strip_encoder failed: %s", esp_err_to_name(err));
+        return;
+    }
+    encoder_ = enc;
+    channel_.attach(this);
+}
+
+WireEncoderShared::~WireEncoderShared() {
+    if (!encoder_) return;
+    channel_.detach(this);
+    rmt_del_encoder(static_cast<rmt_encoder_handle_t>(encoder_));
+    encoder_ = nullptr;
+}
+
+bool WireEncoderShared::transmit_frame(const uint8_t* frame_bytes, size_t frame_size_bytes) {
+    const size_t bpp = format_.bytes_per_pixel;
+    if (!encoder_ || !channel_.ok() || !frame_bytes || frame_size_bytes % bpp != 0) return false;
+    if (is_busy()) return false;
+    if (frame_size_bytes > tx_buf_.size()) frame_size_bytes = tx_buf_.size() - tx_buf_.size() % bpp;
+    // Driver argument order (r,g,b[,w]) -> GRB/GRBW on the wire, as led_strip_set_pixel{,_rgbw} does
+    for (size_t off = 0; off < frame_size_bytes; off += bpp) {
+        const uint8_t* p = frame_bytes + off;
+        uint8_t* q = tx_buf_.data() + off;
+        q[0] = p[1];
+        q[1] = p[0];
+        q[2] = p[2];
+        if (bpp > 3) q[3] = p[3];
+    }
+    tx_len_ = frame_size_bytes;
+    queued_ = true;
+    channel_.pump();
+    return true;
+}
+
+bool WireEncoderShared::is_busy() const {
+    channel_.pump();
+    return queued_ || channel_.in_flight_.load() == this;
+}
+
+} } // namespace leds::internal
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "LEDWireEncoder.h"
+#include "LEDConfig.h"
+#include "InternalAllocator.h"
+#include <atomic>
+#include <vector>
+
+namespace leds { namespace internal {
+
+class WireEncoderShared;
+
+// One RMT TX channel time-shared by several strips on different data GPIOs, for setups with more strips
+// than the four hardware channels (batching is planned by RmtSchedule.h).
+// - Only one member transmits at a time. Between transmissions the channel output is moved to the next
+//   member's pin through the GPIO matrix; every other member pin is driven low as a plain GPIO, so each
+//   strip latches its frame on its own reset gap while the channel is already serving the next one.
+// - Members queue a frame with transmit_frame() and the channel starts queued frames round-robin when it
+//   is idle. Starting happens on the LED update task (from the members' transmit_frame()/is_busy()); the
+//   TX-done ISR only marks the channel idle.
+// - No DMA; each member keeps its own led_strip encoder, so chips with different timings can share.
+class RmtSharedChannel {
+public:
+    RmtSharedChannel(int first_gpio, uint32_t rmt_resolution_hz, size_t mem_block_symbols);
+    ~RmtSharedChannel();
+
+    bool ok() const { return channel_ != nullptr; }
+    uint32_t resolution_hz() const { return resolution_hz_; }
+    // RMT TX-done, from the ISR (IRAM)
+    void on_tx_done_isr();
+
+private:
+    friend class WireEncoderShared;
+    void attach(WireEncoderShared* member);
+    void detach(WireEncoderShared* member);
+    void pump();
+    void route_to(int gpio);
+
+    void* channel_ = nullptr; // rmt_channel_handle_t
+    uint32_t resolution_hz_ = 10 * 1000 * 1000;
+    int out_signal_ = -1;     // GPIO matrix index of this channel's TX signal
+    int routed_gpio_ = -1;    // pin currently driven by the channel
+    std::vector<WireEncoderShared*> members_;
+    size_t next_ = 0;         // round-robin position
+    std::atomic<WireEncoderShared*> in_flight_{nullptr};
+};
+
+// LEDWireEncoder for a strip on a shared channel. Uses the same frame format as the chip's dedicated
+// encoder (driver argument order), reordered to GRB/GRBW on the wire at transmit time.
+class WireEncoderShared final : public LEDWireEncoder {
+public:
+    struct Format {
+        size_t (*frame_bytes)(size_t logical_leds);
+        void (*encode)(const uint8_t* logical_rgba, size_t logical_leds, uint8_t* out_frame_bytes);
+        uint8_t bytes_per_pixel; // 3 (r,g,b) or 4 (r,g,b,w) per physical LED
+        int led_model;           // led_model_t
+    };
+    // False for chips that need their own channel (FLIPDOT_PACKED)
+    static bool format_for(config::LEDConfig::Chip chip, Format& out);
+
+    WireEncoderShared(RmtSharedChannel& channel, int gpio, const Format& format, size_t logical_leds);
+    ~WireEncoderShared();
+
+    size_t frame_size_for(size_t rows, size_t cols) const override { return format_.frame_bytes(rows * cols); }
+
+    void encode_frame(const uint8_t* logical_rgba,
+                      size_t rows,
+                      size_t cols,
+                      uint8_t* out_frame_bytes) const override {
+        format_.encode(logical_rgba, rows * cols, out_frame_bytes);
+    }
+
+    bool transmit_frame(const uint8_t* frame_bytes, size_t frame_size_bytes) override;
+    // Busy from queueing until the channel finished sending this strip. Also gives the channel a chance
+    // to start the next queued member, since the update loop asks every strip once per tick.
+    bool is_busy() const override;
+
+private:
+    friend class RmtSharedChannel;
+    RmtSharedChannel& channel_;
+    int gpio_ = -1;
+    Format format_;
+    void* encoder_ = nullptr;     // rmt_encoder_handle_t
+    // Wire order; untouched while queued or in flight. Read by the encoder from the RMT ISR, also during
+    // flash writes: internal RAM
+    std::vector<uint8_t, InternalAllocator<uint8_t>> tx_buf_;
+    size_t tx_len_ = 0;
+    bool queued_ = false;
+};
+
+} } // namespace leds::internal
@@ -4,8 +4,8 @@
 #include "esp_mac.h"
 #include "esp_netif.h"
 #include "esp_netif_ip_addr.h"
+#include <algorithm>
 #include <cstdio>
-#include <cmath>
 
 namespace leds {
 
@@ -41,40 +41,40 @@ void StatusPattern::update(LEDStrip& strip, uint64_t now_us) {
         case WIFI_CONNECTING:
         case WIFI_CONNECTED_MQTT_CONNECTING: {
             // Single-dot ping-pong with shallow angle and trailing fade
-            float t_s = (now_us - ball_motion_epoch_us_) / 1000000.0f;
-            auto tri_pos = [](float t, float max_val, float speed_cells_per_s) -> float {
-                if (max_val <= 0.0f || speed_cells_per_s <= 0.0f) return 0.0f;
-                float L = 2.0f * max_val;
-                float pos = fmodf(speed_cells_per_s * t, L);
-                if (pos < 0.0f) pos += L;
-                return (pos <= max_val) ? pos : (2.0f * max_val - pos);
+            int64_t t_us = static_cast<int64_t>(now_us - ball_motion_epoch_us_);
+            // Position along a triangle wave 0..max..0 (Q16 cells) for a speed in Q16 cells per second
+            auto tri_pos = [](int64_t t, q16_t max_val, q16_t speed) -> q16_t {
+                if (max_val <= 0 || speed <= 0) return 0;
+                int64_t L = 2 * static_cast<int64_t>(max_val);
+                int64_t pos = (static_cast<int64_t>(speed) * t / 1000000) % L;
+                if (pos < 0) pos += L;
+                return static_cast<q16_t>((pos <= max_val) ? pos : (L - pos));
             };
 
             // Choose speeds: mostly horizontal motion; slow vertical drift
-            float max_col = cols > 0 ? static_cast<float>(cols - 1) : 0.0f;
-            float max_row = rows > 0 ? static_cast<float>(rows - 1) : 0.0f;
-            float speed_scale = 2.5f; // 2-3x faster
-            float vx = fmaxf(0.5f, (max_col / 1.2f) * speed_scale); // traverse width ~1.2s -> ~0.5s
-            float vy = fmaxf(0.2f, (max_row / 6.0f) * speed_scale); // traverse height ~6s -> ~2.4s
+            q16_t max_col = cols > 0 ? static_cast<q16_t>(cols - 1) * kQ16One : 0;
+            q16_t max_row = rows > 0 ? static_cast<q16_t>(rows - 1) * kQ16One : 0;
+            // 2.5x speed scale: traverse width in ~0.5s, height in ~2.4s
+            q16_t vx = std::max<q16_t>(q16_const(0.5), max_col / 12 * 25);
+            q16_t vy = std::max<q16_t>(q16_const(0.2), max_row / 12 * 5);
 
-            // Tail samples (head at i=0)
+            // Tail samples (head at i=0), 80ms spacing, each 0.6x the previous
             const int tail_count = 5;
-            const float tail_dt_s = 0.08f; // 80ms spacing
+            const int64_t tail_dt_us = 80000;
+            q16_t falloff = kQ16One;
             for (int i = 0; i < tail_count; ++i) {
-                float t_i = t_s - i * tail_dt_s;
-                float col_f = tri_pos(t_i, max_col, vx);
-                float row_f = tri_pos(t_i, max_row, vy);
-                size_t col = static_cast<size_t>(col_f + 0.5f);
-                size_t row = static_cast<size_t>(row_f + 0.5f);
+                int64_t t_i = t_us - i * tail_dt_us;
+                size_t col = static_cast<size_t>((tri_pos(t_i, max_col, vx) + kQ16One / 2) >> 16);
+                size_t row = static_cast<size_t>((tri_pos(t_i, max_row, vy) + kQ16One / 2) >> 16);
                 size_t idx = strip.index_for_row_col(row, col);
-                float falloff = powf(0.6f, static_cast<float>(i));
                 if (s == WIFI_CONNECTING) {
-                    strip.set_pixel(idx, 0, 0, clamp_u8(static_cast<int>(180.0f * falloff)), 0);
+                    strip.set_pixel(idx, 0, 0, clamp_u8((180 * falloff) >> 16), 0);
                 } else { // WIFI_CONNECTED_MQTT_CONNECTING
-                    uint8_t r = clamp_u8(static_cast<int>(200.0f * falloff));
-                    uint8_t g = clamp_u8(static_cast<int>(100.0f * falloff));
+                    uint8_t r = clamp_u8((200 * falloff) >> 16);
+                    uint8_t g = clamp_u8((100 * falloff) >> 16);
                     strip.set_pixel(idx, r, g, 0, 0);
                 }
+                falloff = q16_mul(falloff, q16_const(0.6));
             }
             break;
         }
@@ -82,32 +82,15 @@ void StatusPattern::update(LEDStrip& strip, uint64_t now_us) {
             // One-shot white ripple (RGB) from center over ~5 seconds, then show ID/IP one char per second
             if (connect_anim_start_us_ == 0) connect_anim_start_us_ = now_us;
             uint64_t dt_us = now_us - connect_anim_start_us_;
-            const float duration_ms = 5000.0f; // 5 seconds
-            const uint64_t duration_us = (uint64_t)(duration_ms * 1000.0f);
-            float dt_ms = dt_us / 1000.0f;
-            float progress = fminf(1.0f, dt_ms / duration_ms);
+            const uint64_t duration_us = 5000000; // 5 seconds
 
             if (dt_us < duration_us) {
-                float center_r = (rows - 1) * 0.5f;
-                float center_c = (cols - 1) * 0.5f;
-                float max_radius = hypotf(center_r, center_c) + 1.0f;
-                float radius = progress * max_radius;
-                float thickness = 1.2f;
-                float amplitude = 180.0f * (1.0f - progress); // fade as it expands
-
-                for (size_t r = 0; r < rows; ++r) {
-                    for (size_t c = 0; c < cols; ++c) {
-                        float dr = (float)r - center_r;
-                        float dc = (float)c - center_c;
-                        float d = sqrtf(dr*dr + dc*dc);
-                        float band = 1.0f - fminf(1.0f, fabsf(d - radius) / thickness);
-                        if (band > 0.0f) {
-                            uint8_t v = clamp_u8((int)(band * amplitude));
-                            size_t idx = strip.index_for_row_col(r, c);
-                            strip.set_pixel(idx, v, v, v, 0); // use RGB so it works on WS2812 and SK6812
-                        }
-                    }
-                }
+                ensure_distances(rows, cols);
+                q16_t progress = static_cast<q16_t>((dt_us << 16) / duration_us);
+                q16_t max_radius = corner_distance_ + kQ16One;
+                q16_t radius = q16_mul(progress, max_radius);
+                q16_t amplitude = 180 * (kQ16One - progress); // fade as it expands
+                draw_ring(strip, radius, q16_const(1.2), amplitude, 255, 255, 255); // RGB so it works on WS2812 and SK6812
             } else {
                 // After completion, render MAC (last 4 hex) followed by IP, one glyph per second
                 char mac4[5] = {0};
@@ -149,26 +132,11 @@ void StatusPattern::update(LEDStrip& strip, uint64_t now_us) {
         }
         case MQTT_ERROR_STATE: {
             // Repeating outward ripple in red
-            float period_ms = 1200.0f;
-            float t_ms = (now_us % (uint64_t)(period_ms * 1000.0f)) / 1000.0f;
-            float center_r = (rows - 1) * 0.5f;
-            float center_c = (cols - 1) * 0.5f;
-            float max_radius = hypotf((rows - 1) * 0.5f, (cols - 1) * 0.5f);
-            float radius = (t_ms / period_ms) * (max_radius + 1.0f);
-            float thickness = 1.0f;
-            for (size_t r = 0; r < rows; ++r) {
-                for (size_t c = 0; c < cols; ++c) {
-                    float dr = (float)r - center_r;
-                    float dc = (float)c - center_c;
-                    float d = sqrtf(dr*dr + dc*dc);
-                    float band = 1.0f - fminf(1.0f, fabsf(d - radius) / thickness);
-                    if (band > 0.0f) {
-                        uint8_t red = clamp_u8((int)(band * 128.0f));
-                        size_t idx = strip.index_for_row_col(r, c);
-                        strip.set_pixel(idx, red, 0, 0, 0);
-                    }
-                }
-            }
+            const uint64_t period_us = 1200000;
+            ensure_distances(rows, cols);
+            q16_t phase = static_cast<q16_t>(((now_us % period_us) << 16) / period_us);
+            q16_t radius = q16_mul(phase, corner_distance_ + kQ16One);
+            draw_ring(strip, radius, kQ16One, 128 * kQ16One, 255, 0, 0);
             break;
         }
         default: {
@@ -178,6 +146,38 @@ void StatusPattern::update(LEDStrip& strip, uint64_t now_us) {
     }
 }
 
+void StatusPattern::ensure_distances(size_t rows, size_t cols) {
+    if (rows == dist_rows_ && cols == dist_cols_ && dist_.size() == rows * cols) return;
+    dist_rows_ = rows;
+    dist_cols_ = cols;
+    dist_.assign(rows * cols, 0);
+    // Offsets from the center in half-cell units keep the center exact for even sizes
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            int64_t dr2 = 2 * static_cast<int64_t>(r) - static_cast<int64_t>(rows - 1);
+            int64_t dc2 = 2 * static_cast<int64_t>(c) - static_cast<int64_t>(cols - 1);
+            dist_[r * cols + c] = q16_hypot_half(dr2, dc2);
+        }
+    }
+    corner_distance_ = (rows && cols) ? q16_hypot_half(static_cast<int64_t>(rows - 1), static_cast<int64_t>(cols - 1)) : 0;
+}
+
+void StatusPattern::draw_ring(LEDStrip& strip, q16_t radius, q16_t thickness, q16_t amplitude,
+                              uint8_t r, uint8_t g, uint8_t b) {
+    const size_t rows = dist_rows_;
+    const size_t cols = dist_cols_;
+    for (size_t row = 0; row < rows; ++row) {
+        for (size_t col = 0; col < cols; ++col) {
+            q16_t off = q16_abs(dist_[row * cols + col] - radius);
+            if (off >= thickness) continue;
+            q16_t band = kQ16One - q16_div(off, thickness);
+            int v = q16_mul(band, amplitude) >> 16;
+            size_t idx = strip.index_for_row_col(row, col);
+            strip.set_pixel(idx, clamp_u8((v * r) / 255), clamp_u8((v * g) / 255), clamp_u8((v * b) / 255), 0);
+        }
+    }
+}
+
 } // namespace leds
 
 
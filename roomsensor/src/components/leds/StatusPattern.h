@@ -1,7 +1,9 @@
 #pragma once
 
 #include "LEDPattern.h"
+#include "LEDFixedMath.h"
 #include "system_state.h"
+#include <vector>
 
 namespace leds {
 
@@ -29,6 +31,16 @@ private:
     uint64_t state_change_us_ = 0;
     uint64_t connect_anim_start_us_ = 0;
     uint64_t ball_motion_epoch_us_ = 0;
+
+    // Per-pixel distance from the grid center (Q16 cells) for the ripples; rebuilt on geometry change
+    std::vector<q16_t> dist_;
+    size_t dist_rows_ = 0;
+    size_t dist_cols_ = 0;
+    q16_t corner_distance_ = 0;
+
+    void ensure_distances(size_t rows, size_t cols);
+    // Light pixels within 'thickness' of 'radius' with a linear falloff; 'amplitude' is Q16 0..255
+    void draw_ring(LEDStrip& strip, q16_t radius, q16_t thickness, q16_t amplitude, uint8_t r, uint8_t g, uint8_t b);
 };
 
 } // namespace leds
@@ -1,7 +1,6 @@
 #include "SunsetPattern.h"
 #include "LEDStrip.h"
 #include "esp_random.h"
-#include <cmath>
 #include <algorithm>
 
 namespace leds {
@@ -18,6 +17,16 @@ void SunsetPattern::set_brightness_percent(int brightness_percent) {
     brightness_percent_ = brightness_percent;
 }
 
+// Angular speed in radians per second -> binary angle units per second, Q8
+static constexpr uint32_t angle_speed_q8(double rad_per_s) {
+    return static_cast<uint32_t>(rad_per_s / 6.283185307179586 * kAngleTurn * 256.0 + 0.5);
+}
+
+// Angle reached after 't_us' of effective time at 'speed_q8' (wraps naturally)
+static inline uint16_t angle_at(uint16_t phase, uint32_t speed_q8, uint64_t t_us) {
+    return static_cast<uint16_t>(phase + (static_cast<uint64_t>(speed_q8) * t_us) / (256ull * 1000000ull));
+}
+
 void SunsetPattern::init_lobes(size_t length) {
     lobes_.clear();
     if (length == 0) return;
@@ -30,17 +39,18 @@ void SunsetPattern::init_lobes(size_t length) {
         {255, 90, 160},  // pink
     };
 
-    float L = static_cast<float>(length);
+    q16_t L = static_cast<q16_t>(length) * kQ16One;
     for (int i = 0; i < 3; ++i) {
         Lobe l;
-        l.base_center = L * (static_cast<float>(i + 1) / 4.0f); // roughly 1/4, 2/4, 3/4
-        l.amplitude = L * 0.25f;                               // move over ~50% of strip
+        l.base_center = L / 4 * (i + 1); // roughly 1/4, 2/4, 3/4
+        l.amplitude = L / 4;            // move over ~50% of strip
         // randomize phase and speed a bit
         uint32_t r = esp_random();
-        l.phase = static_cast<float>(r & 0xFFFF) / 65535.0f * 2.0f * static_cast<float>(M_PI);
-        float base_speed = 0.03f; // rad/s baseline
-        float jitter = (static_cast<float>((r >> 16) & 0xFF) / 255.0f - 0.5f) * 0.02f; // +/-0.01
-        l.speed = base_speed + jitter;
+        l.phase = static_cast<uint16_t>(r & 0xFFFF);
+        const int32_t base_speed = static_cast<int32_t>(angle_speed_q8(0.03)); // rad/s baseline
+        const int32_t jitter_max = static_cast<int32_t>(angle_speed_q8(0.01));
+        int32_t jitter = ((static_cast<int32_t>((r >> 16) & 0xFF) * 2 - 255) * jitter_max) / 255; // +/-0.01 rad/s
+        l.speed_q8 = static_cast<uint32_t>(base_speed + jitter);
 
         l.r = colors[i][0];
         l.g = colors[i][1];
@@ -49,14 +59,13 @@ void SunsetPattern::init_lobes(size_t length) {
     }
 }
 
-float SunsetPattern::effective_time_seconds(uint64_t now_us) const {
-    float t = static_cast<float>(now_us - start_us_) / 1'000'000.0f;
-    if (t < 0.0f) t = 0.0f;
+uint64_t SunsetPattern::effective_time_us(uint64_t now_us) const {
+    uint64_t t = (now_us > start_us_) ? (now_us - start_us_) : 0;
 
     // Map speed_percent_ into a time scale; 0 => very slow, 100 => faster motion.
     // We treat this as a multiplier on base lobe speeds.
-    float speed_scale = 0.2f + (static_cast<float>(speed_percent_) / 100.0f) * 1.8f; // 0.2x .. 2.0x
-    return t * speed_scale;
+    uint64_t speed_scale_permille = 200 + static_cast<uint64_t>(speed_percent_) * 18; // 0.2x .. 2.0x
+    return t * speed_scale_permille / 1000;
 }
 
 void SunsetPattern::reset(LEDStrip& strip, uint64_t now_us) {
@@ -65,69 +74,87 @@ void SunsetPattern::reset(LEDStrip& strip, uint64_t now_us) {
     init_lobes(strip_length_);
 }
 
-void SunsetPattern::update(LEDStrip& strip, uint64_t now_us) {
-    strip_length_ = strip.length();
-    if (strip_length_ == 0 || lobes_.empty()) return;
+void SunsetPattern::color_at(q16_t pos, q16_t global_scale, uint16_t& r16, uint16_t& g16, uint16_t& b16) const {
+    q16_t L = static_cast<q16_t>(strip_length_) * kQ16One;
+    int32_t R = 0, G = 0, B = 0; // Q16, 0..255 per lobe
 
-    float t = effective_time_seconds(now_us);
-    float L = static_cast<float>(strip_length_);
+    for (const auto& l : lobes_) {
+        q16_t dist = q16_abs(pos - l.center);
+        // Take shortest distance on ring to avoid hard edges near endpoints
+        if (dist > L / 2) dist = L - dist;
 
-    // Global "breathing" brightness modulation for extra motion
-    float breathe = 0.75f + 0.25f * std::sin(t * 0.25f); // very slow 0.25 Hz-ish
-    float global_scale = (static_cast<float>(brightness_percent_) / 100.0f) * breathe;
-
-    for (size_t i = 0; i < strip_length_; ++i) {
-        float pos = static_cast<float>(i);
+        q16_t x = q16_mul(dist, inv_sigma_);
+        // Gaussian-ish falloff
+        q16_t weight = q16_exp_neg(q16_mul(x, x) / 2);
 
-        float R = 0.0f, G = 0.0f, B = 0.0f;
+        R += l.r * weight;
+        G += l.g * weight;
+        B += l.b * weight;
+    }
 
-        for (const auto& l : lobes_) {
-            // Compute moving center for this lobe
-            float center = l.base_center + l.amplitude * std::sin(l.speed * t + l.phase);
-            // Wrap center into [0, L)
-            if (center < 0.0f) center += L;
-            if (center >= L) center -= L;
+    // Normalize if too bright
+    const int32_t full = 255 * kQ16One;
+    int32_t maxC = std::max({R, G, B});
+    if (maxC > full) {
+        R = static_cast<int32_t>(static_cast<int64_t>(R) * full / maxC);
+        G = static_cast<int32_t>(static_cast<int64_t>(G) * full / maxC);
+        B = static_cast<int32_t>(static_cast<int64_t>(B) * full / maxC);
+    }
 
-            float dist = std::fabs(pos - center);
-            // Take shortest distance on ring to avoid hard edges near endpoints
-            if (dist > L * 0.5f) dist = L - dist;
+    // Apply global_scale to modulate intensity, then emit at 16-bit precision (x257 maps 255 -> 65535)
+    // so dim sunsets keep smooth gradients
+    auto to16 = [global_scale, full](int32_t c) -> uint16_t {
+        c = q16_mul(c, global_scale);
+        if (c < 0) c = 0;
+        if (c > full) c = full;
+        return static_cast<uint16_t>((static_cast<uint64_t>(c) * 257u + 32768u) >> 16);
+    };
+    r16 = to16(R);
+    g16 = to16(G);
+    b16 = to16(B);
+}
 
-            float sigma = L * 0.25f; // wide, soft lobes (~1/4 strip)
-            if (sigma <= 0.0f) continue;
+void SunsetPattern::update(LEDStrip& strip, uint64_t now_us) {
+    strip_length_ = strip.length();
+    if (strip_length_ == 0 || lobes_.empty()) return;
 
-            float x = dist / sigma;
-            // Gaussian-ish falloff
-            float weight = std::exp(-0.5f * x * x);
+    uint64_t t_us = effective_time_us(now_us);
 
-            R += static_cast<float>(l.r) * weight;
-            G += static_cast<float>(l.g) * weight;
-            B += static_cast<float>(l.b) * weight;
-        }
+    // Moving lobe centers for this frame, wrapped into [0, L)
+    q16_t L = static_cast<q16_t>(strip_length_) * kQ16One;
+    for (auto& l : lobes_) {
+        q16_t center = l.base_center + q16_mul(l.amplitude, q16_sin(angle_at(l.phase, l.speed_q8, t_us)));
+        if (center < 0) center += L;
+        if (center >= L) center -= L;
+        l.center = center;
+    }
+    inv_sigma_ = q16_div(kQ16One, L / 4); // wide, soft lobes (sigma ~1/4 strip)
 
-        // Normalize if too bright
-        float maxC = std::max({R, G, B, 1.0f});
-        if (maxC > 255.0f) {
-            float inv = 255.0f / maxC;
-            R *= inv; G *= inv; B *= inv;
+    // Global "breathing" brightness modulation for extra motion
+    static constexpr uint32_t kBreatheSpeedQ8 = angle_speed_q8(0.25); // very slow
+    q16_t breathe = q16_const(0.75) + q16_sin(angle_at(0, kBreatheSpeedQ8, t_us)) / 4;
+    q16_t global_scale = breathe * brightness_percent_ / 100;
+
+    uint16_t r16, g16, b16;
+    if (strip_length_ > LEDPalette::kSize && (strip.indexed_mode() || strip.set_indexed_mode(true))) {
+        // Indexed path for long strips: the lobes are a quarter of the strip wide, so sampling them at 256
+        // position bands is indistinguishable from per-pixel evaluation; pixels just point at their band.
+        const size_t n = strip_length_;
+        const size_t bands = LEDPalette::kSize;
+        for (size_t i = 0; i < n; ++i) strip.set_pixel_index(i, static_cast<uint8_t>((i * bands) / n));
+        for (size_t k = 0; k < bands; ++k) {
+            // Sample at the band center: (k + 0.5) * n / bands - 0.5
+            q16_t pos = static_cast<q16_t>((static_cast<int64_t>(2 * k + 1) * n * kQ16One) / (2 * bands)) - kQ16One / 2;
+            color_at(pos, global_scale, r16, g16, b16);
+            palette_.set(static_cast<uint8_t>(k), r16, g16, b16, 0);
         }
+        strip.set_palette(palette_);
+        return;
+    }
 
-        // Apply global_scale to modulate intensity
-        R *= global_scale;
-        G *= global_scale;
-        B *= global_scale;
-
-        if (R < 0.0f) R = 0.0f;
-        if (G < 0.0f) G = 0.0f;
-        if (B < 0.0f) B = 0.0f;
-        if (R > 255.0f) R = 255.0f;
-        if (G > 255.0f) G = 255.0f;
-        if (B > 255.0f) B = 255.0f;
-
-        uint8_t r8 = static_cast<uint8_t>(R + 0.5f);
-        uint8_t g8 = static_cast<uint8_t>(G + 0.5f);
-        uint8_t b8 = static_cast<uint8_t>(B + 0.5f);
-
-        strip.set_pixel(i, r8, g8, b8, 0);
+    for (size_t i = 0; i < strip_length_; ++i) {
+        color_at(static_cast<q16_t>(i) * kQ16One, global_scale, r16, g16, b16);
+        strip.set_pixel16(i, r16, g16, b16, 0);
     }
 }
 
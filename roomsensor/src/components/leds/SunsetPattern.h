@@ -1,6 +1,8 @@
 #pragma once
 
 #include "LEDPattern.h"
+#include "LEDFixedMath.h"
+#include "LEDPalette.h"
 #include <cstddef>
 #include <vector>
 
@@ -21,10 +23,11 @@ public:
 
 private:
     struct Lobe {
-        float base_center = 0.0f;  // nominal center in [0, length)
-        float amplitude = 0.0f;    // movement amplitude in LEDs
-        float phase = 0.0f;        // initial phase offset (radians)
-        float speed = 0.0f;        // angular speed (radians per second)
+        q16_t base_center = 0;     // nominal center in [0, length), Q16 LEDs
+        q16_t amplitude = 0;       // movement amplitude, Q16 LEDs
+        uint16_t phase = 0;        // initial phase offset (binary angle)
+        uint32_t speed_q8 = 0;     // angular speed (binary angle units per second, Q8)
+        q16_t center = 0;          // center for the current frame
         uint8_t r = 0, g = 0, b = 0;
     };
 
@@ -35,10 +38,16 @@ private:
     int brightness_percent_ = 100; // 0..100
 
     std::vector<Lobe> lobes_;
+    q16_t inv_sigma_ = 0;          // 1 / lobe width for the current strip length
+    LEDPalette palette_; // position bands for the indexed path
 
     // Helpers
     void init_lobes(size_t length);
-    float effective_time_seconds(uint64_t now_us) const;
+    // Elapsed time scaled by the speed knob
+    uint64_t effective_time_us(uint64_t now_us) const;
+    // 16-bit color at strip position 'pos' (Q16 LEDs) for the current lobe centers and overall intensity
+    // 'global_scale' (Q16)
+    void color_at(q16_t pos, q16_t global_scale, uint16_t& r16, uint16_t& g16, uint16_t& b16) const;
 };
 
 } // namespace leds
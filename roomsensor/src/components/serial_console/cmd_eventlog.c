@@ -0,0 +1,61 @@
+#include "cmd_eventlog.h"
+#include "esp_console.h"
+#include "argtable3/argtable3.h"
+#include "event_log.h"
+#include <stdio.h>
+
+static struct {
+    struct arg_int* count;
+    struct arg_int* boot;
+    struct arg_lit* stats;
+    struct arg_end* end;
+} eventlog_args;
+
+static int do_eventlog(int argc, char** argv) {
+    int nerrors = arg_parse(argc, argv, (void**)&eventlog_args);
+    if (nerrors != 0) {
+        arg_print_errors(stdout, eventlog_args.end, argv[0]);
+        return 1;
+    }
+
+    event_log_stats_t st;
+    if (event_log_get_stats(&st) != ESP_OK) {
+        printf("event log not mounted (no eventlog partition?)\n");
+        return 1;
+    }
+
+    if (eventlog_args.stats->count > 0) {
+        printf("boot %u: %u records, %u bytes, %u erases, %u dropped, %u write errors, %u torn at mount\n",
+               (unsigned)st.boot, (unsigned)st.records, (unsigned)st.bytes, (unsigned)st.erases,
+               (unsigned)st.dropped, (unsigned)st.write_errors, (unsigned)st.torn);
+        printf("write us/record: avg %u max %u; with rollover erase: max %u\n",
+               (unsigned)st.write_us_avg, (unsigned)st.write_us_max, (unsigned)st.erase_us_max);
+        return 0;
+    }
+
+    int count = eventlog_args.count->count > 0 ? eventlog_args.count->ival[0] : 40;
+    int boot = eventlog_args.boot->count > 0 ? eventlog_args.boot->ival[0] : 0;
+    if (count <= 0 || boot < 0) {
+        printf("count must be positive, boot 0 (all) or a boot number\n");
+        return 1;
+    }
+    printf(" boot      seq  uptime_ms   message\n");
+    event_log_dump(stdout, (uint32_t)count, (uint32_t)boot);
+    return 0;
+}
+
+void register_eventlog(void) {
+    eventlog_args.count = arg_int0("n", "count", "<records>", "newest records to print, default 40");
+    eventlog_args.boot = arg_int0("b", "boot", "<boot>", "only this boot number, default all");
+    eventlog_args.stats = arg_lit0("s", "stats", "write cost and wear counters of this boot");
+    eventlog_args.end = arg_end(4);
+
+    const esp_console_cmd_t cmd = {
+        .command = "eventlog",
+        .help = "Print the persistent event log (warnings and errors kept across reboots)",
+        .hint = NULL,
+        .func = &do_eventlog,
+        .argtable = &eventlog_args,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
+}
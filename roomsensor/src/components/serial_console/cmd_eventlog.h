@@ -0,0 +1,12 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Register the persistent event log console command
+void register_eventlog(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -20,6 +20,8 @@
 #include "esp_err.h"
 #include "cmd_nvs.h"
 #include "nvs.h"
+#include "ConfigSnapshot.h"
+#include "flash_window.h"
 
 typedef struct {
     nvs_type_t type;
@@ -161,6 +163,15 @@ static void print_blob(const char *blob, size_t len)
 }
 
 
+// Configuration namespaces are mirrored in a boot snapshot; drop it before editing them by hand so the
+// next boot reloads from the per-key values
+static void drop_config_snapshot(const char *name)
+{
+    if (strcmp(name, CONFIG_SNAPSHOT_NAMESPACE) != 0) {
+        config_snapshot_invalidate();
+    }
+}
+
 static esp_err_t set_value_in_nvs(const char *key, const char *str_type, const char *str_value)
 {
     esp_err_t err;
@@ -174,6 +185,7 @@ static esp_err_t set_value_in_nvs(const char *key, const char *str_type, const c
         return ESP_ERR_NVS_TYPE_MISMATCH;
     }
 
+    drop_config_snapshot(current_namespace);
     err = nvs_open(current_namespace, NVS_READWRITE, &nvs);
     if (err != ESP_OK) {
         return err;
@@ -337,6 +349,7 @@ static esp_err_t erase(const char *key)
 {
     nvs_handle_t nvs;
 
+    drop_config_snapshot(current_namespace);
     esp_err_t err = nvs_open(current_namespace, NVS_READWRITE, &nvs);
     if (err == ESP_OK) {
         err = nvs_erase_key(nvs, key);
@@ -356,6 +369,7 @@ static esp_err_t erase_all(const char *name)
 {
     nvs_handle_t nvs;
 
+    drop_config_snapshot(name);
     esp_err_t err = nvs_open(name, NVS_READWRITE, &nvs);
     if (err == ESP_OK) {
         err = nvs_erase_all(nvs);
@@ -415,7 +429,9 @@ static int set_value(int argc, char **argv)
     const char *type = set_args.type->sval[0];
     const char *values = set_args.value->sval[0];
 
+    flash_window_begin(FLASH_WINDOW_DEFAULT_DEFER_MS);
     esp_err_t err = set_value_in_nvs(key, type, values);
+    flash_window_end();
 
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "%s", esp_err_to_name(err));
@@ -456,7 +472,9 @@ static int erase_value(int argc, char **argv)
 
     const char *key = erase_args.key->sval[0];
 
+    flash_window_begin(FLASH_WINDOW_DEFAULT_DEFER_MS);
     esp_err_t err = erase(key);
+    flash_window_end();
 
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "%s", esp_err_to_name(err));
@@ -476,7 +494,9 @@ static int erase_namespace(int argc, char **argv)
 
     const char *name = erase_all_args.namespace->sval[0];
 
+    flash_window_begin(FLASH_WINDOW_DEFAULT_DEFER_MS);
     esp_err_t err = erase_all(name);
+    flash_window_end();
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "%s", esp_err_to_name(err));
         return 1;
@@ -0,0 +1,54 @@
+#include "cmd_profile.h"
+#include "esp_console.h"
+#include "argtable3/argtable3.h"
+#include "esp_log.h"
+#include "profiler.h"
+#include <stdio.h>
+
+static const char* TAG = "cmd_profile";
+
+static struct {
+    struct arg_int* seconds;
+    struct arg_int* hz;
+    struct arg_int* top;
+    struct arg_end* end;
+} prof_hot_args;
+
+static int do_prof_hot(int argc, char** argv) {
+    int nerrors = arg_parse(argc, argv, (void**)&prof_hot_args);
+    if (nerrors != 0) {
+        arg_print_errors(stdout, prof_hot_args.end, argv[0]);
+        return 1;
+    }
+
+    int seconds = prof_hot_args.seconds->count > 0 ? prof_hot_args.seconds->ival[0] : 30;
+    int hz = prof_hot_args.hz->count > 0 ? prof_hot_args.hz->ival[0] : PROFILER_DEFAULT_RATE_HZ;
+    int top = prof_hot_args.top->count > 0 ? prof_hot_args.top->ival[0] : 200;
+    if (seconds <= 0 || seconds > 600 || hz <= 0 || top <= 0) {
+        printf("seconds must be 1..600, hz and top positive\n");
+        return 1;
+    }
+
+    esp_err_t err = profiler_hot_run((uint32_t)seconds * 1000, (uint32_t)hz, (size_t)top, stdout, NULL);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "prof_hot failed: %s", esp_err_to_name(err));
+        return 1;
+    }
+    return 0;
+}
+
+void register_profile(void) {
+    prof_hot_args.seconds = arg_int0(NULL, NULL, "<seconds>", "sampling time, default 30");
+    prof_hot_args.hz = arg_int0("r", "rate", "<hz>", "samples per second and core, default 997");
+    prof_hot_args.top = arg_int0("n", "top", "<count>", "number of PCs to print, default 200");
+    prof_hot_args.end = arg_end(4);
+
+    const esp_console_cmd_t cmd = {
+        .command = "prof_hot",
+        .help = "Sample program counters on both cores and print the hottest ones (input for hot_placement.py)",
+        .hint = NULL,
+        .func = &do_prof_hot,
+        .argtable = &prof_hot_args,
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&cmd));
+}
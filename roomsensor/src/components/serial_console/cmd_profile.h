@@ -0,0 +1,12 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Register profiling console commands
+void register_profile(void);
+
+#ifdef __cplusplus
+}
+#endif
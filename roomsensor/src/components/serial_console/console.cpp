@@ -10,6 +10,8 @@
 #include "cmd_nvs.h"
 #include "cmd_system.h"
 #include "cmd_ota.h"
+#include "cmd_profile.h"
+#include "cmd_eventlog.h"
 #include "gpio.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -151,6 +153,8 @@ static void console_task(void *arg)
     register_wifi();
     register_gpio();
     register_ota();
+    register_profile();
+    register_eventlog();
     register_console_commands();
 
     ESP_LOGI(TAG_CONSOLE, "Console initialized. Type 'help' to list commands.");
@@ -2,7 +2,7 @@
 #include "esp_heap_caps.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
+#include "instrumented_lock.h"
 #include <string.h>
 
 typedef struct {
@@ -12,12 +12,15 @@ typedef struct {
     // followed by len bytes payload
 } __attribute__((packed)) console_rec_hdr_t;
 
+// Taken for every log line; waits over this are reported with the holder (instrumented_lock.h)
+#define CONSOLE_LOCK_SLOW_US 1000
+
 typedef struct {
     uint8_t* buf;
     size_t capacity;
     size_t head; // write pos
     size_t tail; // oldest pos
-    SemaphoreHandle_t mutex;
+    instrumented_lock_t* mutex;
     bool inited;
 } console_ring_t;
 
@@ -47,7 +50,7 @@ bool console_buffer_init(size_t capacity_bytes) {
     s_ring.capacity = capacity_bytes;
     s_ring.head = 0;
     s_ring.tail = 0;
-    s_ring.mutex = xSemaphoreCreateMutex();
+    s_ring.mutex = instrumented_lock_create("console", CONSOLE_LOCK_SLOW_US);
     s_ring.inited = (s_ring.mutex != NULL);
     return s_ring.inited;
 }
@@ -81,7 +84,7 @@ void console_buffer_append(const char* data, size_t len, console_dir_t dir) {
     };
     size_t total = sizeof(hdr) + hdr.len;
 
-    xSemaphoreTake(s_ring.mutex, portMAX_DELAY);
+    instrumented_lock_take(s_ring.mutex, portMAX_DELAY);
 
     // Ensure we have space; leave at least one byte between head and tail to differentiate empty/full
     while (true) {
@@ -115,13 +118,13 @@ void console_buffer_append(const char* data, size_t len, console_dir_t dir) {
         s_ring.head = hdr.len - part;
     }
 
-    xSemaphoreGive(s_ring.mutex);
+    instrumented_lock_give(s_ring.mutex);
 }
 
 void console_buffer_iterate(console_buffer_iter_cb cb, void* ctx) {
     if (!cb) return;
     if (!s_ring.inited) return;
-    xSemaphoreTake(s_ring.mutex, portMAX_DELAY);
+    instrumented_lock_take(s_ring.mutex, portMAX_DELAY);
     size_t pos = s_ring.tail;
     while (pos != s_ring.head) {
         console_rec_hdr_t hdr;
@@ -153,7 +156,7 @@ void console_buffer_iterate(console_buffer_iter_cb cb, void* ctx) {
         heap_caps_free(temp);
         if (stop) break;
     }
-    xSemaphoreGive(s_ring.mutex);
+    instrumented_lock_give(s_ring.mutex);
 }
 
 
@@ -9,6 +9,7 @@
 
 static const char* TAG = "StatusLED";
 static int status_gpio = -1;
+static volatile bool s_alarm_active = false;
 
 // Forward declaration
 void status_led_task(void* pvParameters);
@@ -44,8 +45,23 @@ esp_err_t init_status_led() {
     return ESP_OK;
 }
 
+void status_led_set_alarm(bool active) {
+    s_alarm_active = active;
+}
+
 void status_led_task(void* pvParameters) {
     while (1) {
+        if (s_alarm_active) {
+            // Double flash, distinct from the connection patterns
+            for (int i = 0; i < 2; i++) {
+                gpio_set_level((gpio_num_t)status_gpio, 0); // ON
+                vTaskDelay(pdMS_TO_TICKS(80));
+                gpio_set_level((gpio_num_t)status_gpio, 1); // OFF
+                vTaskDelay(pdMS_TO_TICKS(80));
+            }
+            vTaskDelay(pdMS_TO_TICKS(440));
+            continue;
+        }
         SystemState state = get_system_state();
         switch (state) {
             case WIFI_CONNECTING:
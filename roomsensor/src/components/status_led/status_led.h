@@ -4,4 +4,5 @@
 
 esp_err_t init_status_led();
 
-
+// While set, the status LED double-flashes regardless of the connection state (alarms.h)
+void status_led_set_alarm(bool active);
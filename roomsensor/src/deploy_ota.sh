@@ -140,6 +140,20 @@ MANIFEST_FILE="manifest.json"
 # Produce gzipped web asset in repo root for upload
 gzip -c -9 "$INDEX_HTML" > "$WEB_FILENAME"
 
+# Compressed firmware (zlib, 32 KB window): devices inflate it while streaming into the OTA partition and
+# check the SHA-256 of the result. Set OTA_COMPRESSION=none to publish only the plain image.
+OTA_COMPRESSION="${OTA_COMPRESSION:-zlib}"
+BIN_SHA256=$(shasum -a 256 "$BIN_FILE" | cut -d' ' -f1)
+BIN_Z_FILENAME="firmware-${ARTIFACT_SUFFIX}.bin.zz"
+COMPRESSED_MANIFEST_LINE=""
+if [[ "$OTA_COMPRESSION" == "zlib" ]]; then
+    python3 -c 'import sys, zlib; open(sys.argv[2], "wb").write(zlib.compress(open(sys.argv[1], "rb").read(), 9))' \
+        "$BIN_FILE" "$BIN_Z_FILENAME"
+    BIN_Z_SIZE=$(stat -f%z "$BIN_Z_FILENAME")
+    echo "Compressed firmware: $BIN_Z_FILENAME ($BIN_Z_SIZE of $BIN_SIZE bytes)"
+    COMPRESSED_MANIFEST_LINE="\"compressed_url\": \"${BASE_URL}/${BIN_Z_FILENAME}\","
+fi
+
 MANIFEST_NAME="manifest.json"
 if [[ "$CHANNEL" != "prod" ]]; then
   MANIFEST_NAME="manifest-${CHANNEL}.json"
@@ -153,6 +167,10 @@ cat > ${MANIFEST_NAME} << EOF
     "build_timestamp_epoch": ${BUILD_TIMESTAMP},
     "git_describe": "${GIT_DESCRIBE}",
     "url": "${BASE_URL}/${BIN_FILENAME}",
+    "size": ${BIN_SIZE},
+    "sha256": "${BIN_SHA256}",
+    "compression": "${OTA_COMPRESSION}",
+    ${COMPRESSED_MANIFEST_LINE}
     "web_version": "${WEB_VERSION}",
     "web_build_timestamp": "${WEB_BUILD_ISO_TIME}",
     "web_build_timestamp_epoch": ${WEB_BUILD_TIMESTAMP},
@@ -170,9 +188,13 @@ cp "${BIN_FILE}" "${BIN_FILENAME}"
 
 # Upload files to server
 echo "Uploading firmware, web asset, and manifest to ${SERVER}:${REMOTE_DIR} (channel=${CHANNEL})..."
-scp "${BIN_FILENAME}" "${WEB_FILENAME}" "${MANIFEST_NAME}" "${SERVER}:${REMOTE_DIR}/"
+UPLOADS=("${BIN_FILENAME}" "${WEB_FILENAME}" "${MANIFEST_NAME}")
+if [[ "$OTA_COMPRESSION" == "zlib" ]]; then
+    UPLOADS+=("${BIN_Z_FILENAME}")
+fi
+scp "${UPLOADS[@]}" "${SERVER}:${REMOTE_DIR}/"
 
 # Clean up local temporary files
-rm "${BIN_FILENAME}" "${WEB_FILENAME}" "${MANIFEST_NAME}"
+rm "${UPLOADS[@]}"
 
 echo "Deployment complete. OTA update is available at ${BASE_URL}/${MANIFEST_NAME}"
\ No newline at end of file
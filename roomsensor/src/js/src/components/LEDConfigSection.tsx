@@ -128,7 +128,7 @@ function LEDCard({ ledKey, led, onEdit, publish }: {
                   else onEdit(ledKey, 'pattern', v)
                 }}
               >
-                {['OFF','SOLID','FADE','STATUS','RAINBOW','CHASE','LIFE','POSITION','CLOCK','CALENDAR','SUMMARY','SWEEP','METEOR','SUNSET','CROSS_WIPE','CROSS_FADE','FIREWORKS','MARQUEE'].map((opt) => (
+                {['OFF','SOLID','FADE','STATUS','RAINBOW','CHASE','LIFE','POSITION','CLOCK','CALENDAR','SUMMARY','SWEEP','METEOR','SUNSET','CROSS_WIPE','CROSS_FADE','FIREWORKS','MARQUEE','DASHBOARD'].map((opt) => (
                   <MenuItem key={opt} value={opt}>{opt}</MenuItem>
                 ))}
               </Select>
@@ -220,7 +220,7 @@ function LEDCard({ ledKey, led, onEdit, publish }: {
                   <Chip
                     label={`Chip: ${led.chip}`}
                     size="small"
-                    onClick={() => onEdit(ledKey, 'chip', led.chip, { type: 'select', options: ['WS2812', 'SK6812', 'WS2814', 'FLIPDOT'], label: 'Chip' })}
+                    onClick={() => onEdit(ledKey, 'chip', led.chip, { type: 'select', options: ['WS2812', 'SK6812', 'WS2814', 'FLIPDOT', 'FLIPDOT_PACKED'], label: 'Chip' })}
                   />
                 )}
                 <Chip
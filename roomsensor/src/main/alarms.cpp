@@ -0,0 +1,298 @@
+#include "alarms.h"
+#include "communication.h"
+#include "system_state.h"
+#include "status_led.h"
+#include "ConfigurationManager.h"
+#include "AlarmConfig.h"
+#include "flash_window.h"
+#include "metrics_bus.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "nvs.h"
+#include "cJSON.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// External function declarations from wifi.cpp and metrics.cpp
+extern const uint8_t* get_device_mac(void);
+extern SystemState get_system_state(void);
+extern void format_iso8601_utc(char* buffer, size_t buffer_size, int64_t sample_us);
+
+static const char* TAG = "alarms";
+
+// Reserved queue, separate from the 50-entry metrics queue so a metrics backlog cannot delay or drop alarms
+#define ALARM_QUEUE_SIZE 8
+// Alarms held until published; oldest dropped first when full
+#define ALARM_PENDING_MAX 8
+// Raised alarms tracked for annunciation
+#define ALARM_ACTIVE_MAX 16
+// Above the metrics task (5) so alarms are published ahead of a metrics batch
+#define ALARM_TASK_PRIORITY 6
+#define ALARM_RETRY_MS 1000
+
+static const char* NVS_NAMESPACE = "alarms";
+static const char* NVS_KEY = "pending";
+
+// One alarm transition. Tags are rendered when the alarm is reported, since drivers reuse their tag
+// collections (e.g. one per IO expander for all its pins). Holds no pointers, so it can be kept in NVS.
+typedef struct {
+    char alarm[24];
+    uint8_t raised;
+    uint8_t restored; // loaded from NVS: sample_us belongs to an earlier boot
+    uint8_t reserved[2];
+    float value;
+    float threshold;
+    int64_t sample_us;
+    char ts[32];
+    char tags_json[256];
+} PendingAlarm;
+
+typedef struct {
+    uint32_t count;
+    PendingAlarm items[ALARM_PENDING_MAX];
+} PendingAlarmList;
+
+
+static QueueHandle_t s_alarm_queue = NULL;
+static TaskHandle_t s_alarm_task = NULL;
+static PendingAlarmList s_pending;
+static bool s_nvs_has_pending = false;
+static uint32_t s_dropped = 0;
+static uint32_t s_active[ALARM_ACTIVE_MAX]; // key_of() of each raised alarm
+static int s_active_count = 0;
+static int s_alarm_gpio = -1;
+static uint32_t s_alarm_config_generation = UINT32_MAX;
+static uint32_t s_latency_max_ms = 0;
+
+static esp_err_t save_pending(void) {
+    flash_window::Scope flash;
+    nvs_handle_t h;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &h);
+    if (err != ESP_OK) return err;
+    if (s_pending.count == 0) {
+        err = nvs_erase_key(h, NVS_KEY);
+        if (err == ESP_ERR_NVS_NOT_FOUND) err = ESP_OK;
+    } else {
+        size_t len = offsetof(PendingAlarmList, items) + s_pending.count * sizeof(PendingAlarm);
+        err = nvs_set_blob(h, NVS_KEY, &s_pending, len);
+    }
+    if (err == ESP_OK) err = nvs_commit(h);
+    nvs_close(h);
+    if (err == ESP_OK) s_nvs_has_pending = s_pending.count > 0;
+    return err;
+}
+
+static void load_pending(void) {
+    nvs_handle_t h;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &h) != ESP_OK) return;
+    size_t len = sizeof(s_pending);
+    esp_err_t err = nvs_get_blob(h, NVS_KEY, &s_pending, &len);
+    nvs_close(h);
+    if (err != ESP_OK || len < offsetof(PendingAlarmList, items) || s_pending.count > ALARM_PENDING_MAX ||
+        len != offsetof(PendingAlarmList, items) + s_pending.count * sizeof(PendingAlarm)) {
+        s_pending.count = 0;
+        return;
+    }
+    for (uint32_t i = 0; i < s_pending.count; i++) {
+        s_pending.items[i].restored = 1;
+    }
+    s_nvs_has_pending = true;
+    ESP_LOGW(TAG, "Restored %lu alarms that were not published before reboot", (unsigned long)s_pending.count);
+}
+
+// Keep the alarm GPIO in line with the configuration and the raised alarms
+static void update_annunciation(void) {
+    config::AlarmConfig& cfg = config::GetConfigurationManager().alarm();
+    if (cfg.generation() != s_alarm_config_generation) {
+        s_alarm_config_generation = cfg.generation();
+        int pin = cfg.has_gpio() ? cfg.gpio() : -1;
+        if (pin != s_alarm_gpio) {
+            if (s_alarm_gpio >= 0) {
+                gpio_set_level((gpio_num_t)s_alarm_gpio, 0);
+                gpio_reset_pin((gpio_num_t)s_alarm_gpio);
+            }
+            s_alarm_gpio = -1;
+            if (pin >= 0) {
+                gpio_config_t io_conf = {};
+                io_conf.mode = GPIO_MODE_OUTPUT;
+                io_conf.pin_bit_mask = 1ULL << pin;
+                if (gpio_config(&io_conf) == ESP_OK) {
+                    s_alarm_gpio = pin;
+                    ESP_LOGI(TAG, "Alarm output on GPIO %d", pin);
+                } else {
+                    ESP_LOGE(TAG, "Failed to configure alarm GPIO %d", pin);
+                }
+            }
+        }
+    }
+    if (s_alarm_gpio >= 0) {
+        gpio_set_level((gpio_num_t)s_alarm_gpio, s_active_count > 0 ? 1 : 0);
+    }
+    status_led_set_alarm(s_active_count > 0);
+}
+
+// Identity of an alarm source: alarm name and rendered tags, hashed like a metrics bus source
+static uint32_t key_of(const PendingAlarm* a) {
+    return metrics_bus::SourceKey().add(a->alarm).add(a->tags_json).value();
+}
+
+static void track_active(const PendingAlarm* a) {
+    uint32_t key = key_of(a);
+    int idx = -1;
+    for (int i = 0; i < s_active_count; i++) {
+        if (s_active[i] == key) {
+            idx = i;
+            break;
+        }
+    }
+    if (a->raised && idx < 0 && s_active_count < ALARM_ACTIVE_MAX) {
+        s_active[s_active_count++] = key;
+    } else if (!a->raised && idx >= 0) {
+        s_active[idx] = s_active[--s_active_count];
+    }
+}
+
+static void render_tags(char* out, size_t out_size, const TagCollection* tags) {
+    cJSON* obj = cJSON_CreateObject();
+    out[0] = '\0';
+    if (obj == NULL) return;
+    for (int i = 0; tags && i < tags->count && i < MAX_DEVICE_TAGS; i++) {
+        cJSON_AddStringToObject(obj, tags->tags[i].key, tags->tags[i].value);
+    }
+    if (!cJSON_PrintPreallocated(obj, out, (int)out_size, false)) {
+        snprintf(out, out_size, "{}");
+    }
+    cJSON_Delete(obj);
+}
+
+static void enqueue_pending(const PendingAlarm* a) {
+    if (s_pending.count == ALARM_PENDING_MAX) {
+        memmove(&s_pending.items[0], &s_pending.items[1], (ALARM_PENDING_MAX - 1) * sizeof(PendingAlarm));
+        s_pending.count--;
+        s_dropped++;
+        ESP_LOGE(TAG, "Alarm backlog full; dropped oldest (%lu dropped so far)", (unsigned long)s_dropped);
+    }
+    s_pending.items[s_pending.count++] = *a;
+}
+
+static esp_err_t publish_pending(const PendingAlarm* p) {
+    const uint8_t* mac = get_device_mac();
+    if (mac == NULL) return ESP_ERR_INVALID_STATE;
+    char topic[96];
+    snprintf(topic, sizeof(topic), "sensor/%02x%02x%02x%02x%02x%02x/alarms/%s", mac[0], mac[1], mac[2], mac[3],
+             mac[4], mac[5], p->alarm);
+
+    int64_t latency_ms = p->restored ? -1 : (esp_timer_get_time() - p->sample_us) / 1000;
+    char payload[480];
+    int n = snprintf(payload, sizeof(payload),
+                     "{\"alarm\":\"%s\",\"state\":\"%s\",\"value\":%.2f,\"threshold\":%.2f,\"ts\":\"%s\"", p->alarm,
+                     p->raised ? "raised" : "cleared", p->value, p->threshold, p->ts);
+    if (latency_ms >= 0) {
+        n += snprintf(payload + n, sizeof(payload) - n, ",\"latency_ms\":%lld", (long long)latency_ms);
+    }
+    snprintf(payload + n, sizeof(payload) - n, ",\"tags\":%s}", p->tags_json[0] ? p->tags_json : "{}");
+
+    // QoS 1 straight to the client, no publish slot and no pacing
+    esp_err_t err = publish_to_topic(topic, payload, 1, 0);
+    if (err == ESP_OK) {
+        if (latency_ms >= 0) {
+            if ((uint32_t)latency_ms > s_latency_max_ms) s_latency_max_ms = (uint32_t)latency_ms;
+            ESP_LOGW(TAG, "Alarm %s %s (value %.2f, threshold %.2f) published %lld ms after sample (max %lu ms)",
+                     p->alarm, p->raised ? "raised" : "cleared", p->value, p->threshold, (long long)latency_ms,
+                     (unsigned long)s_latency_max_ms);
+        } else {
+            ESP_LOGW(TAG, "Alarm %s %s from before reboot published", p->alarm, p->raised ? "raised" : "cleared");
+        }
+    }
+    return err;
+}
+
+// Publish pending alarms in order; stops at the first failure so the order is kept
+static void flush_pending(void) {
+    uint32_t sent = 0;
+    if (get_system_state() == FULLY_CONNECTED) {
+        while (sent < s_pending.count && publish_pending(&s_pending.items[sent]) == ESP_OK) {
+            sent++;
+        }
+    }
+    if (sent > 0) {
+        memmove(&s_pending.items[0], &s_pending.items[sent], (s_pending.count - sent) * sizeof(PendingAlarm));
+        s_pending.count -= sent;
+    }
+}
+
+static void alarm_task(void* arg) {
+    (void)arg;
+    PendingAlarm report;
+    while (1) {
+        TickType_t wait = s_pending.count > 0 ? pdMS_TO_TICKS(ALARM_RETRY_MS) : pdMS_TO_TICKS(ALARM_RETRY_MS * 5);
+        bool changed = false;
+        if (xQueueReceive(s_alarm_queue, &report, wait) == pdTRUE) {
+            do {
+                track_active(&report);
+                enqueue_pending(&report);
+                changed = true;
+            } while (xQueueReceive(s_alarm_queue, &report, 0) == pdTRUE);
+        }
+        update_annunciation();
+        if (s_pending.count == 0 && !s_nvs_has_pending) continue;
+
+        uint32_t before = s_pending.count;
+        flush_pending();
+        if (s_pending.count != before) changed = true;
+
+        // Persist only what could not be sent, so an alarm raised offline survives a reboot
+        if ((changed && s_pending.count > 0) || (s_pending.count == 0 && s_nvs_has_pending)) {
+            esp_err_t err = save_pending();
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to persist pending alarms: %s", esp_err_to_name(err));
+            }
+        }
+    }
+}
+
+esp_err_t report_alarm(const char* alarm_name, bool raised, float value, float threshold, TagCollection* tags) {
+    if (alarm_name == NULL) return ESP_ERR_INVALID_ARG;
+    if (s_alarm_queue == NULL) {
+        ESP_LOGE(TAG, "Alarm system not initialized; %s %s lost", alarm_name, raised ? "raised" : "cleared");
+        return ESP_ERR_INVALID_STATE;
+    }
+    PendingAlarm report;
+    memset(&report, 0, sizeof(report));
+    strncpy(report.alarm, alarm_name, sizeof(report.alarm) - 1);
+    report.raised = raised ? 1 : 0;
+    report.value = value;
+    report.threshold = threshold;
+    report.sample_us = esp_timer_get_time();
+    format_iso8601_utc(report.ts, sizeof(report.ts), report.sample_us);
+    render_tags(report.tags_json, sizeof(report.tags_json), tags);
+    if (xQueueSend(s_alarm_queue, &report, 0) != pdTRUE) {
+        s_dropped++;
+        ESP_LOGE(TAG, "Alarm queue full; %s %s dropped", alarm_name, raised ? "raised" : "cleared");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t initialize_alarm_system(void) {
+    if (s_alarm_queue != NULL) return ESP_OK;
+    s_alarm_queue = xQueueCreate(ALARM_QUEUE_SIZE, sizeof(PendingAlarm));
+    if (s_alarm_queue == NULL) {
+        ESP_LOGE(TAG, "Failed to create alarm queue");
+        return ESP_ERR_NO_MEM;
+    }
+    load_pending();
+    if (xTaskCreate(alarm_task, "alarm_task", 4096, NULL, ALARM_TASK_PRIORITY, &s_alarm_task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create alarm task");
+        vQueueDelete(s_alarm_queue);
+        s_alarm_queue = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "Alarm system started");
+    return ESP_OK;
+}
@@ -0,0 +1,341 @@
+#include "event_log.h"
+#include "event_log_ring.h"
+
+#include "cJSON.h"
+#include "communication.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "flash_window.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "wifi.h"
+#include <cstring>
+#include <new>
+
+static const char* TAG = "event_log";
+
+using event_log_ring::RecordHeader;
+using event_log_ring::Type;
+
+namespace {
+
+struct PartitionFlash {
+    const esp_partition_t* part = nullptr;
+    const uint8_t* mapped = nullptr; // reads through the cache instead of cache-disabling SPI reads
+
+    bool read(uint32_t offset, void* buf, size_t len) {
+        if (mapped) {
+            memcpy(buf, mapped + offset, len);
+            return true;
+        }
+        return esp_partition_read(part, offset, buf, len) == ESP_OK;
+    }
+    bool write(uint32_t offset, const void* buf, size_t len) {
+        return esp_partition_write(part, offset, buf, len) == ESP_OK;
+    }
+    bool erase_sector(uint32_t offset) {
+        return esp_partition_erase_range(part, offset, event_log_ring::kSectorSize) == ESP_OK;
+    }
+};
+
+// A line waiting for the writer task
+struct Pending {
+    uint32_t uptime_ms;
+    uint8_t level;
+    uint8_t len;
+    char text[160];
+};
+
+constexpr size_t kPendingSlots = 16;
+constexpr size_t kUploadBatch = 16; // records per MQTT message
+
+using Ring = event_log_ring::Ring<PartitionFlash>;
+
+} // namespace
+
+static PartitionFlash s_flash;
+static esp_partition_mmap_handle_t s_mmap;
+static Ring* s_ring = nullptr;
+static SemaphoreHandle_t s_ring_mutex = nullptr; // ring access: writer task, restart flush, dump
+static TaskHandle_t s_task = nullptr;
+static volatile bool s_ready = false;
+
+// Staging, filled from any task by event_log_write()
+static portMUX_TYPE s_stage_lock = portMUX_INITIALIZER_UNLOCKED;
+static Pending s_pending[kPendingSlots];
+static size_t s_pending_head = 0;
+static size_t s_pending_count = 0;
+static uint32_t s_tokens = 0;
+static int64_t s_tokens_at_us = 0;
+static uint32_t s_dropped = 0;
+
+// Write cost, under s_ring_mutex
+static uint64_t s_write_us_total = 0;
+static uint32_t s_write_count = 0;
+static uint32_t s_write_us_max = 0;
+static uint32_t s_erase_us_max = 0;
+
+static char level_char(uint8_t level) {
+    static const char kLevels[] = "NEWIDV";
+    return level < sizeof(kLevels) - 1 ? kLevels[level] : '?';
+}
+
+// Append under s_ring_mutex and an open flash window
+static void append_timed(Type type, uint8_t level, uint32_t uptime_ms, const char* text, uint16_t len) {
+    const uint32_t erases = s_ring->stats().erases;
+    const int64_t start = esp_timer_get_time();
+    s_ring->append(type, level, uptime_ms, text, len);
+    const uint32_t us = static_cast<uint32_t>(esp_timer_get_time() - start);
+    if (s_ring->stats().erases != erases) {
+        // Rolled over into the next sector and erased the one after it
+        if (us > s_erase_us_max) s_erase_us_max = us;
+        return;
+    }
+    s_write_us_total += us;
+    s_write_count++;
+    if (us > s_write_us_max) s_write_us_max = us;
+}
+
+static void flush_pending(void) {
+    if (xSemaphoreTake(s_ring_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) return;
+    bool window = false;
+    Pending p;
+    for (;;) {
+        taskENTER_CRITICAL(&s_stage_lock);
+        if (s_pending_count == 0) {
+            taskEXIT_CRITICAL(&s_stage_lock);
+            break;
+        }
+        p = s_pending[s_pending_head];
+        s_pending_head = (s_pending_head + 1) % kPendingSlots;
+        s_pending_count--;
+        taskEXIT_CRITICAL(&s_stage_lock);
+
+        if (!window) {
+            flash_window_begin(FLASH_WINDOW_DEFAULT_DEFER_MS);
+            window = true;
+        }
+        append_timed(Type::Text, p.level, p.uptime_ms, p.text, p.len);
+    }
+    if (window) flash_window_end();
+    xSemaphoreGive(s_ring_mutex);
+}
+
+static void flush_on_restart(void) {
+    if (s_ready) flush_pending();
+}
+
+static cJSON* record_json(const RecordHeader& h, const char* payload) {
+    char text[event_log_ring::kMaxPayload + 1];
+    memcpy(text, payload, h.len);
+    text[h.len] = '\0';
+    cJSON* rec = cJSON_CreateObject();
+    cJSON_AddNumberToObject(rec, "seq", (double)h.seq);
+    cJSON_AddNumberToObject(rec, "uptime_ms", (double)h.uptime_ms);
+    if (h.type == static_cast<uint8_t>(Type::Boot)) {
+        cJSON_AddStringToObject(rec, "type", "boot");
+    } else {
+        const char level[2] = {level_char(h.level), '\0'};
+        cJSON_AddStringToObject(rec, "level", level);
+    }
+    cJSON_AddStringToObject(rec, "msg", text);
+    return rec;
+}
+
+// Publish the newest EVENT_LOG_UPLOAD_RECORDS records of the previous boot. False to retry later.
+static bool upload_previous_boot(void) {
+    const uint16_t prev = static_cast<uint16_t>(s_ring->boot() - 1);
+    const uint8_t* mac = get_device_mac();
+    if (prev == 0 || !mac) return prev == 0;
+
+    char topic[64];
+    snprintf(topic, sizeof(topic), "sensor/%02x%02x%02x%02x%02x%02x/device/eventlog",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+
+    xSemaphoreTake(s_ring_mutex, portMAX_DELAY);
+    uint32_t total = 0;
+    s_ring->for_each([&](const RecordHeader& h, const char*, uint32_t) {
+        if (h.boot == prev) total++;
+        return true;
+    });
+    const uint32_t skip = total > EVENT_LOG_UPLOAD_RECORDS ? total - EVENT_LOG_UPLOAD_RECORDS : 0;
+    const uint32_t count = total - skip;
+    const uint32_t parts = (count + kUploadBatch - 1) / kUploadBatch;
+
+    uint32_t index = 0;
+    uint32_t part = 0;
+    bool ok = true;
+    cJSON* root = nullptr;
+    cJSON* records = nullptr;
+    auto publish = [&]() {
+        char* json = cJSON_PrintUnformatted(root);
+        if (!json || publish_to_topic(topic, json, 1, 0) != ESP_OK) ok = false;
+        cJSON_free(json);
+        cJSON_Delete(root);
+        root = nullptr;
+    };
+    s_ring->for_each([&](const RecordHeader& h, const char* payload, uint32_t) {
+        if (h.boot != prev || index++ < skip) return true;
+        if (!root) {
+            root = cJSON_CreateObject();
+            cJSON_AddNumberToObject(root, "boot", prev);
+            cJSON_AddNumberToObject(root, "part", ++part);
+            cJSON_AddNumberToObject(root, "parts", parts);
+            cJSON_AddNumberToObject(root, "dropped_older", skip);
+            records = cJSON_AddArrayToObject(root, "records");
+        }
+        cJSON_AddItemToArray(records, record_json(h, payload));
+        if (cJSON_GetArraySize(records) == (int)kUploadBatch) publish();
+        return ok;
+    });
+    if (root) publish();
+    xSemaphoreGive(s_ring_mutex);
+
+    if (ok) ESP_LOGI(TAG, "Uploaded %u records of boot %u", (unsigned)count, (unsigned)prev);
+    return ok;
+}
+
+static void event_log_task(void* arg) {
+    (void)arg;
+    bool uploaded = false;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(EVENT_LOG_FLUSH_MS));
+        flush_pending();
+        if (!uploaded && get_system_state() == FULLY_CONNECTED) {
+            uploaded = upload_previous_boot();
+        }
+    }
+}
+
+esp_err_t event_log_init(void) {
+    if (s_ready) return ESP_OK;
+
+    const esp_partition_t* part =
+        esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "eventlog");
+    if (!part) {
+        ESP_LOGW(TAG, "No eventlog partition; flash the partition table to keep logs across reboots");
+        return ESP_ERR_NOT_FOUND;
+    }
+    s_flash.part = part;
+    const void* mapped = nullptr;
+    if (esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &mapped, &s_mmap) == ESP_OK) {
+        s_flash.mapped = static_cast<const uint8_t*>(mapped);
+    } else {
+        ESP_LOGW(TAG, "mmap failed, reading through SPI");
+    }
+
+    s_ring_mutex = xSemaphoreCreateMutex();
+    s_ring = new (std::nothrow) Ring(s_flash, part->size);
+    if (!s_ring_mutex || !s_ring) return ESP_ERR_NO_MEM;
+
+    char boot[48];
+    const int n = snprintf(boot, sizeof(boot), "reset_reason=%d", (int)esp_reset_reason());
+    {
+        flash_window::Scope window;
+        if (!s_ring->mount()) {
+            ESP_LOGE(TAG, "Mount failed");
+            delete s_ring;
+            s_ring = nullptr;
+            return ESP_FAIL;
+        }
+        append_timed(Type::Boot, ESP_LOG_INFO, (uint32_t)(esp_timer_get_time() / 1000), boot, (uint16_t)n);
+    }
+
+    s_tokens = EVENT_LOG_BURST_BYTES;
+    s_tokens_at_us = esp_timer_get_time();
+    s_ready = true;
+
+    const event_log_ring::Stats& st = s_ring->stats();
+    ESP_LOGI(TAG, "Boot %u: %u sectors, next seq %u, %u torn records",
+             (unsigned)s_ring->boot(), (unsigned)s_ring->sectors(), (unsigned)s_ring->next_seq(), (unsigned)st.torn);
+
+    if (xTaskCreatePinnedToCore(&event_log_task, "eventlog", 4096, nullptr, tskIDLE_PRIORITY + 1, &s_task,
+                                tskNO_AFFINITY) != pdPASS) {
+        s_task = nullptr;
+        ESP_LOGE(TAG, "Failed to create writer task");
+        return ESP_FAIL;
+    }
+    esp_register_shutdown_handler(&flush_on_restart);
+    return ESP_OK;
+}
+
+void event_log_write(int level, const char* text, size_t len) {
+    if (!s_ready || !text) return;
+    if (len > sizeof(Pending::text)) len = sizeof(Pending::text);
+    const uint32_t cost = event_log_ring::record_size(static_cast<uint16_t>(len));
+    const int64_t now = esp_timer_get_time();
+
+    bool wake = false;
+    taskENTER_CRITICAL(&s_stage_lock);
+    // Token bucket: EVENT_LOG_RATE_BYTES_PER_S of flash, bursts up to EVENT_LOG_BURST_BYTES
+    const uint64_t earned = (uint64_t)(now - s_tokens_at_us) * EVENT_LOG_RATE_BYTES_PER_S / 1000000;
+    if (earned > 0) {
+        s_tokens_at_us += (int64_t)(earned * 1000000 / EVENT_LOG_RATE_BYTES_PER_S);
+        s_tokens = earned >= EVENT_LOG_BURST_BYTES - s_tokens ? EVENT_LOG_BURST_BYTES : s_tokens + (uint32_t)earned;
+    }
+    if (s_tokens < cost || s_pending_count == kPendingSlots) {
+        s_dropped++;
+    } else {
+        s_tokens -= cost;
+        Pending& p = s_pending[(s_pending_head + s_pending_count) % kPendingSlots];
+        p.uptime_ms = (uint32_t)(now / 1000);
+        p.level = (uint8_t)level;
+        p.len = (uint8_t)len;
+        memcpy(p.text, text, len);
+        s_pending_count++;
+        wake = level <= ESP_LOG_ERROR || s_pending_count >= kPendingSlots / 2;
+    }
+    taskEXIT_CRITICAL(&s_stage_lock);
+
+    // Errors go out right away: a crash may follow
+    if (wake && s_task) xTaskNotifyGive(s_task);
+}
+
+esp_err_t event_log_get_stats(event_log_stats_t* out) {
+    if (!s_ready || !out) return ESP_ERR_INVALID_STATE;
+    memset(out, 0, sizeof(*out));
+    xSemaphoreTake(s_ring_mutex, portMAX_DELAY);
+    const event_log_ring::Stats& st = s_ring->stats();
+    out->boot = s_ring->boot();
+    out->records = st.records;
+    out->bytes = st.bytes;
+    out->erases = st.erases;
+    out->write_errors = st.write_errors;
+    out->torn = st.torn;
+    out->write_us_avg = s_write_count ? (uint32_t)(s_write_us_total / s_write_count) : 0;
+    out->write_us_max = s_write_us_max;
+    out->erase_us_max = s_erase_us_max;
+    xSemaphoreGive(s_ring_mutex);
+    taskENTER_CRITICAL(&s_stage_lock);
+    out->dropped = s_dropped;
+    taskEXIT_CRITICAL(&s_stage_lock);
+    return ESP_OK;
+}
+
+esp_err_t event_log_dump(FILE* out, uint32_t max_records, uint32_t boot) {
+    if (!s_ready) return ESP_ERR_INVALID_STATE;
+    xSemaphoreTake(s_ring_mutex, portMAX_DELAY);
+    uint32_t total = 0;
+    s_ring->for_each([&](const RecordHeader& h, const char*, uint32_t) {
+        if (boot == 0 || h.boot == boot) total++;
+        return true;
+    });
+    const uint32_t skip = total > max_records ? total - max_records : 0;
+    uint32_t index = 0;
+    s_ring->for_each([&](const RecordHeader& h, const char* payload, uint32_t) {
+        if ((boot != 0 && h.boot != boot) || index++ < skip) return true;
+        if (h.type == static_cast<uint8_t>(Type::Boot)) {
+            fprintf(out, "%5u %8u %10u -- boot %.*s\n", (unsigned)h.boot, (unsigned)h.seq, (unsigned)h.uptime_ms,
+                    (int)h.len, payload);
+        } else {
+            fprintf(out, "%5u %8u %10u %c %.*s\n", (unsigned)h.boot, (unsigned)h.seq, (unsigned)h.uptime_ms,
+                    level_char(h.level), (int)h.len, payload);
+        }
+        return true;
+    });
+    xSemaphoreGive(s_ring_mutex);
+    return ESP_OK;
+}
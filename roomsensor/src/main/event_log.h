@@ -0,0 +1,59 @@
+#pragma once
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Persistent event log: log lines that survive a reboot or crash, in a ring of binary records on the raw
+// "eventlog" partition (format and recovery in event_log_ring.h).
+// - netlog hands every warning and error line to event_log_write(). Lines are staged in RAM under a
+//   token bucket (EVENT_LOG_RATE_BYTES_PER_S, bursts up to EVENT_LOG_BURST_BYTES) and written by a
+//   low-priority task every EVENT_LOG_FLUSH_MS, right away for errors, and on esp_restart().
+// - Each boot starts with a boot record (reset reason). Once MQTT is up, the tail of the previous boot
+//   (at most EVENT_LOG_UPLOAD_RECORDS records) is published to sensor/$mac/device/eventlog.
+// - Writes go through the flash window (flash_window.h), like the other flash writers.
+//
+// Wear: 16 sectors, one always erased ahead. The cap is about 1.4 MB/day, some 24 erases per sector and
+// day (11 years to 100k cycles); a warning per minute is 2.
+//
+// Devices flashed before the partition existed have no "eventlog" partition until the partition table is
+// flashed over serial; event_log_init() then returns ESP_ERR_NOT_FOUND and the rest is a no-op.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EVENT_LOG_RATE_BYTES_PER_S 16
+#define EVENT_LOG_BURST_BYTES 4096
+#define EVENT_LOG_FLUSH_MS 2000
+#define EVENT_LOG_UPLOAD_RECORDS 64
+
+// Mount the partition, write the boot record and start the writer task. Call before netlog_init_early().
+esp_err_t event_log_init(void);
+
+// Queue a line for the log; never blocks, drops over the rate budget. level is an esp_log_level_t.
+void event_log_write(int level, const char* text, size_t len);
+
+typedef struct {
+    uint32_t boot;           // boot number of this session
+    uint32_t records;        // written this session
+    uint32_t bytes;          // flash bytes written this session
+    uint32_t erases;         // sectors erased this session
+    uint32_t dropped;        // lines over the rate budget or staging full
+    uint32_t write_errors;
+    uint32_t torn;           // torn records found at mount (power lost mid-write)
+    uint32_t write_us_avg;   // per record, flash write only
+    uint32_t write_us_max;
+    uint32_t erase_us_max;   // a record that rolled over: sector header, record and erase-ahead
+} event_log_stats_t;
+
+// ESP_ERR_INVALID_STATE when the log is not mounted
+esp_err_t event_log_get_stats(event_log_stats_t* out);
+
+// Print the newest max_records records ("boot seq uptime level text"), of one boot or of all (boot 0)
+esp_err_t event_log_dump(FILE* out, uint32_t max_records, uint32_t boot);
+
+#ifdef __cplusplus
+}
+#endif
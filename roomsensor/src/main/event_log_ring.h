@@ -0,0 +1,305 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace event_log_ring {
+
+// Append-only ring of small binary records in a raw flash partition (event_log.cpp). Pure, no driver
+// calls: the partition is reached through a Flash type with NOR semantics, so the same code runs on the
+// device (esp_partition) and against a file-backed emulator on a host.
+//
+// Layout, per 4 KB sector:
+//   SectorHeader | Record | Record | ... | erased (0xFF)
+// A record is RecordHeader + payload, padded to 4 bytes. Sector and record headers carry a CRC32; records
+// carry a sequence number that keeps counting across sectors and reboots, and the boot number they were
+// written in.
+//
+// - The sector after the current one is always erased ahead, so a rollover never erases and writes in
+//   the same step, and the oldest sector is what gets dropped.
+// - Power loss mid-write leaves a record whose CRC fails. mount() stops at the first such record and
+//   seals the sector; appends continue in the next one, or in the same one erased again when the torn
+//   record was its first. Nothing after a torn record is trusted.
+// - Each mount() starts a new boot number (last boot seen + 1).
+//
+// Flash must provide:
+//   bool read(uint32_t offset, void* buf, size_t len);
+//   bool write(uint32_t offset, const void* buf, size_t len);   // only clears bits
+//   bool erase_sector(uint32_t offset);                          // 4 KB aligned, sets to 0xFF
+
+constexpr uint32_t kSectorSize = 4096;
+constexpr uint32_t kSectorMagic = 0x31474C45; // "ELG1"
+constexpr uint16_t kMaxPayload = 256;
+
+enum class Type : uint8_t { Text = 1, Boot = 2 };
+
+struct SectorHeader {
+    uint32_t magic;
+    uint32_t sector_seq; // +1 per sector used, never reused
+    uint32_t first_seq;  // sequence number of the first record in the sector
+    uint32_t crc;        // over the fields above
+};
+
+struct RecordHeader {
+    uint32_t seq;
+    uint32_t uptime_ms;
+    uint16_t boot;
+    uint16_t len;       // payload bytes; 0xFFFF with seq 0xFFFFFFFF => erased
+    uint8_t type;       // Type
+    uint8_t level;      // esp_log_level_t
+    uint16_t reserved;  // 0xFFFF
+    uint32_t crc;       // over the fields above and the payload
+};
+
+static_assert(sizeof(SectorHeader) == 16, "on-flash layout");
+static_assert(sizeof(RecordHeader) == 20, "on-flash layout");
+
+constexpr uint32_t record_size(uint16_t len) { return (sizeof(RecordHeader) + len + 3u) & ~3u; }
+
+inline uint32_t crc32(uint32_t crc, const void* data, size_t len) {
+    static const uint32_t kNibble[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) {
+        crc = kNibble[(crc ^ p[i]) & 0x0F] ^ (crc >> 4);
+        crc = kNibble[(crc ^ (p[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+inline uint32_t sector_crc(const SectorHeader& h) { return crc32(0, &h, offsetof(SectorHeader, crc)); }
+
+inline uint32_t record_crc(const RecordHeader& h, const void* payload) {
+    return crc32(crc32(0, &h, offsetof(RecordHeader, crc)), payload, h.len);
+}
+
+inline bool record_blank(const RecordHeader& h) { return h.seq == 0xFFFFFFFF && h.len == 0xFFFF; }
+
+struct Stats {
+    uint32_t records = 0;        // appended since mount
+    uint32_t bytes = 0;          // flash bytes written since mount, headers and padding included
+    uint32_t erases = 0;         // sectors erased since mount
+    uint32_t write_errors = 0;
+    uint32_t torn = 0;           // torn records found by mount()
+};
+
+template <typename Flash>
+class Ring {
+public:
+    Ring(Flash& flash, uint32_t size) : flash_(flash), sectors_(size / kSectorSize) {}
+
+    // Find the newest sector and the end of its records, erase ahead, start a new boot. False if the
+    // partition is too small or flash fails.
+    bool mount() {
+        if (sectors_ < 3) return false;
+        bool found = false;
+        SectorHeader newest{};
+        for (uint32_t s = 0; s < sectors_; ++s) {
+            SectorHeader h;
+            if (!read_sector_header(s, &h)) continue;
+            if (!found || h.sector_seq > newest.sector_seq) {
+                newest = h;
+                cur_ = s;
+                found = true;
+            }
+        }
+
+        boot_ = 1;
+        next_seq_ = 0;
+        sealed_ = false;
+        if (!found) {
+            // Blank or foreign contents: start over at sector 0
+            sector_seq_ = 0;
+            if (!start_sector(0) || !erase_ahead()) return false;
+        } else {
+            sector_seq_ = newest.sector_seq;
+            next_seq_ = newest.first_seq;
+            offset_ = sizeof(SectorHeader);
+            uint16_t last_boot = 0;
+            RecordHeader h;
+            while (offset_ + sizeof(RecordHeader) <= kSectorSize) {
+                const uint32_t at = cur_ * kSectorSize + offset_;
+                if (!flash_.read(at, &h, sizeof(h))) return false;
+                if (record_blank(h)) break;
+                if (!record_valid(at, h)) {
+                    stats_.torn++;
+                    sealed_ = true;
+                    break;
+                }
+                next_seq_ = h.seq + 1;
+                last_boot = h.boot;
+                offset_ += record_size(h.len);
+            }
+            if (last_boot == 0) last_boot = last_boot_before(cur_);
+            boot_ = static_cast<uint16_t>(last_boot + 1);
+            if (boot_ == 0) boot_ = 1; // 0 marks "no records"
+            if (!erase_ahead()) return false;
+        }
+        mounted_ = true;
+        return true;
+    }
+
+    bool append(Type type, uint8_t level, uint32_t uptime_ms, const void* payload, uint16_t len) {
+        if (!mounted_) return false;
+        if (len > kMaxPayload) len = kMaxPayload;
+        const uint32_t size = record_size(len);
+        if (sealed_ || offset_ + size > kSectorSize) {
+            // A sealed sector without a single record is started again in place: moving on would erase
+            // the oldest sector ahead, and repeated power cuts would burn through the ring
+            const bool empty = offset_ == sizeof(SectorHeader);
+            if (!start_sector(empty ? cur_ : (cur_ + 1) % sectors_) || !erase_ahead()) {
+                stats_.write_errors++;
+                return false;
+            }
+        }
+
+        uint8_t buf[record_size(kMaxPayload)];
+        memset(buf, 0xFF, size);
+        RecordHeader h{};
+        h.seq = next_seq_;
+        h.uptime_ms = uptime_ms;
+        h.boot = boot_;
+        h.len = len;
+        h.type = static_cast<uint8_t>(type);
+        h.level = level;
+        h.reserved = 0xFFFF;
+        h.crc = record_crc(h, payload);
+        memcpy(buf, &h, sizeof(h));
+        memcpy(buf + sizeof(h), payload, len);
+
+        if (!flash_.write(cur_ * kSectorSize + offset_, buf, size)) {
+            // Whatever landed is torn; continue in a fresh sector
+            stats_.write_errors++;
+            sealed_ = true;
+            return false;
+        }
+        offset_ += size;
+        next_seq_++;
+        stats_.records++;
+        stats_.bytes += size;
+        return true;
+    }
+
+    // Visit every valid record, oldest first: fn(const RecordHeader&, const char* payload, uint32_t offset)
+    // returns false to stop. The payload is not NUL-terminated.
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        if (!mounted_) return;
+        uint32_t prev_seq = 0;
+        bool any = false;
+        char payload[kMaxPayload];
+        // cur_ + 1 is the erased-ahead sector; cur_ + 2 holds the oldest records
+        for (uint32_t i = 2; i <= sectors_; ++i) {
+            const uint32_t s = (cur_ + i) % sectors_;
+            SectorHeader sh;
+            if (!read_sector_header(s, &sh)) continue;
+            if (any && sh.sector_seq <= prev_seq) continue; // stale header from an older lap
+            if (sh.sector_seq > sector_seq_) continue;
+            prev_seq = sh.sector_seq;
+            any = true;
+            uint32_t off = sizeof(SectorHeader);
+            RecordHeader h;
+            while (off + sizeof(RecordHeader) <= kSectorSize) {
+                const uint32_t at = s * kSectorSize + off;
+                if (!flash_.read(at, &h, sizeof(h)) || record_blank(h)) break;
+                if (h.len > kMaxPayload || off + record_size(h.len) > kSectorSize) break;
+                if (!flash_.read(at + sizeof(h), payload, h.len)) break;
+                if (record_crc(h, payload) != h.crc) break;
+                if (!fn(static_cast<const RecordHeader&>(h), static_cast<const char*>(payload), at)) return;
+                off += record_size(h.len);
+            }
+        }
+    }
+
+    uint16_t boot() const { return boot_; }
+    uint32_t next_seq() const { return next_seq_; }
+    uint32_t sectors() const { return sectors_; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    bool read_sector_header(uint32_t s, SectorHeader* h) const {
+        return flash_.read(s * kSectorSize, h, sizeof(*h)) && h->magic == kSectorMagic && sector_crc(*h) == h->crc;
+    }
+
+    bool record_valid(uint32_t at, const RecordHeader& h) const {
+        if (h.len > kMaxPayload || (at % kSectorSize) + record_size(h.len) > kSectorSize) return false;
+        char payload[kMaxPayload];
+        return flash_.read(at + sizeof(h), payload, h.len) && record_crc(h, payload) == h.crc;
+    }
+
+    // Boot number of the newest record in the sectors before s, for a current sector without records
+    uint16_t last_boot_before(uint32_t s) const {
+        for (uint32_t i = 1; i < sectors_; ++i) {
+            const uint32_t p = (s + sectors_ - i) % sectors_;
+            SectorHeader sh;
+            if (!read_sector_header(p, &sh)) return 0;
+            uint16_t boot = 0;
+            uint32_t off = sizeof(SectorHeader);
+            RecordHeader h;
+            while (off + sizeof(RecordHeader) <= kSectorSize) {
+                const uint32_t at = p * kSectorSize + off;
+                if (!flash_.read(at, &h, sizeof(h)) || record_blank(h) || !record_valid(at, h)) break;
+                boot = h.boot;
+                off += record_size(h.len);
+            }
+            if (boot) return boot;
+        }
+        return 0;
+    }
+
+    bool erase(uint32_t s) {
+        if (!flash_.erase_sector(s * kSectorSize)) return false;
+        stats_.erases++;
+        return true;
+    }
+
+    bool is_erased(uint32_t s) const {
+        uint32_t words[64];
+        for (uint32_t off = 0; off < kSectorSize; off += sizeof(words)) {
+            if (!flash_.read(s * kSectorSize + off, words, sizeof(words))) return false;
+            for (uint32_t w : words) {
+                if (w != 0xFFFFFFFF) return false;
+            }
+        }
+        return true;
+    }
+
+    bool erase_ahead() {
+        const uint32_t ahead = (cur_ + 1) % sectors_;
+        return is_erased(ahead) || erase(ahead);
+    }
+
+    // Make s the current sector. It was erased ahead, except on a fresh partition.
+    bool start_sector(uint32_t s) {
+        if (!is_erased(s) && !erase(s)) return false;
+        SectorHeader h{};
+        h.magic = kSectorMagic;
+        h.sector_seq = sector_seq_ + 1;
+        h.first_seq = next_seq_;
+        h.crc = sector_crc(h);
+        if (!flash_.write(s * kSectorSize, &h, sizeof(h))) return false;
+        stats_.bytes += sizeof(h);
+        cur_ = s;
+        sector_seq_ = h.sector_seq;
+        offset_ = sizeof(SectorHeader);
+        sealed_ = false;
+        return true;
+    }
+
+    Flash& flash_;
+    const uint32_t sectors_;
+    uint32_t cur_ = 0;
+    uint32_t sector_seq_ = 0;
+    uint32_t offset_ = 0;
+    uint32_t next_seq_ = 0;
+    uint16_t boot_ = 1;
+    bool sealed_ = false;
+    bool mounted_ = false;
+    Stats stats_;
+};
+
+} // namespace event_log_ring
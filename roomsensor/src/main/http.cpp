@@ -10,6 +10,10 @@
 #include <sys/time.h>
 #include <cstdio>
 #include "console_buffer.h"
+#include "link_manager.h"
+#include "profiler.h"
+#include <cstdlib>
+#include <cstring>
 
 static const char *TAG = "http_server";
 
@@ -135,6 +139,7 @@ static esp_err_t index_get_handler(httpd_req_t *req)
     do {
         bytes_read = fread(buffer, 1, kChunkSize, file);
         if (bytes_read > 0) {
+            link_manager_hold_busy(2000);
             esp_err_t r = httpd_resp_send_chunk(req, buffer, bytes_read);
             if (r != ESP_OK) {
                 fclose(file);
@@ -281,6 +286,112 @@ static esp_err_t console_get_handler(httpd_req_t *req)
     return ESP_OK;
 }
 
+static esp_err_t send_profile_status(httpd_req_t *req, const char* status)
+{
+    cJSON *root = profiler_capture_status_json();
+    char *json_response = cJSON_PrintUnformatted(root);
+    if (status) httpd_resp_set_status(req, status);
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, json_response);
+    cJSON_Delete(root);
+    free(json_response);
+    return ESP_OK;
+}
+
+// Handler for /profile/start?seconds=30&hz=199: starts a stack capture (profiler.h), answers with its status
+static esp_err_t profile_start_handler(httpd_req_t *req)
+{
+    uint32_t seconds = 30;
+    uint32_t hz = PROFILER_CAPTURE_DEFAULT_RATE_HZ;
+    char query[64];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+        char value[12];
+        if (httpd_query_key_value(query, "seconds", value, sizeof(value)) == ESP_OK) seconds = strtoul(value, NULL, 10);
+        if (httpd_query_key_value(query, "hz", value, sizeof(value)) == ESP_OK) hz = strtoul(value, NULL, 10);
+    }
+
+    esp_err_t err = profiler_capture_start(seconds * 1000, hz);
+    if (err == ESP_ERR_INVALID_ARG) return send_profile_status(req, "400 Bad Request");
+    if (err == ESP_ERR_INVALID_STATE) return send_profile_status(req, "409 Conflict");
+    if (err != ESP_OK) return send_profile_status(req, "500 Internal Server Error");
+    return send_profile_status(req, NULL);
+}
+
+static esp_err_t profile_status_handler(httpd_req_t *req)
+{
+    return send_profile_status(req, NULL);
+}
+
+// Handler for /profile/collapsed: the finished capture as collapsed stacks with raw addresses; symbolize
+// with util/roomsensor_util/flamegraph.py and the ELF of the running firmware
+static esp_err_t profile_collapsed_handler(httpd_req_t *req)
+{
+    profiler_capture_status_t st;
+    profiler_capture_status(&st);
+    if (st.state != PROFILER_CAPTURE_DONE) {
+        return send_profile_status(req, st.state == PROFILER_CAPTURE_RUNNING ? "409 Conflict" : "404 Not Found");
+    }
+
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    httpd_resp_set_type(req, "text/plain");
+
+    // Lines are batched into chunks of about kChunkSize
+    static const size_t kChunkSize = 2048;
+    struct Ctx {
+        httpd_req_t* req;
+        char buf[kChunkSize];
+        size_t used;
+    };
+    Ctx* ctx = (Ctx*)malloc(sizeof(Ctx));
+    if (!ctx) return httpd_resp_send_500(req);
+    ctx->req = req;
+    ctx->used = 0;
+    auto cb = [](const char* line, size_t len, void* vctx) -> int {
+        Ctx* c = (Ctx*)vctx;
+        if (c->used + len + 1 > sizeof(c->buf)) {
+            link_manager_hold_busy(2000);
+            if (httpd_resp_send_chunk(c->req, c->buf, c->used) != ESP_OK) return -1;
+            c->used = 0;
+        }
+        memcpy(c->buf + c->used, line, len);
+        c->buf[c->used + len] = '\n';
+        c->used += len + 1;
+        return 0;
+    };
+    esp_err_t err = profiler_capture_export(cb, ctx);
+    if (err == ESP_OK && ctx->used > 0) err = httpd_resp_send_chunk(req, ctx->buf, ctx->used);
+    free(ctx);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Profile export failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+static const httpd_uri_t profile_start = {
+    .uri       = "/profile/start",
+    .method    = HTTP_GET,
+    .handler   = profile_start_handler,
+    .user_ctx  = NULL
+};
+
+static const httpd_uri_t profile_status = {
+    .uri       = "/profile/status",
+    .method    = HTTP_GET,
+    .handler   = profile_status_handler,
+    .user_ctx  = NULL
+};
+
+static const httpd_uri_t profile_collapsed = {
+    .uri       = "/profile/collapsed",
+    .method    = HTTP_GET,
+    .handler   = profile_collapsed_handler,
+    .user_ctx  = NULL
+};
+
 static const httpd_uri_t index_page = {
     .uri       = "/*",
     .method    = HTTP_GET,
@@ -303,6 +414,7 @@ esp_err_t start_webserver(void)
     config.stack_size = 8192;
     // Enable wildcard URI matching so we can serve SPA fallback for any path
     config.uri_match_fn = httpd_uri_match_wildcard;
+    config.max_uri_handlers = 12;
     
     // Start the httpd server
     ESP_LOGI(TAG, "Starting server on port: %d", config.server_port);
@@ -313,6 +425,9 @@ esp_err_t start_webserver(void)
         httpd_register_uri_handler(server, &metrics);
         httpd_register_uri_handler(server, &mqttconfig);
         httpd_register_uri_handler(server, &console_route);
+        httpd_register_uri_handler(server, &profile_start);
+        httpd_register_uri_handler(server, &profile_status);
+        httpd_register_uri_handler(server, &profile_collapsed);
         httpd_register_uri_handler(server, &index_page);
         return ESP_OK;
     }
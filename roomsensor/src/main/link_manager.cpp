@@ -0,0 +1,243 @@
+#include "link_manager.h"
+#include "link_policy.h"
+#include "wifi.h"
+#include "communication.h"
+#include "ConfigurationManager.h"
+#include "WifiConfig.h"
+#include "cJSON.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "mqtt_client.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+static const char* TAG = "link";
+
+static constexpr uint32_t kTickMs = 5000;
+static constexpr uint32_t kTicksPerReport = 12; // link stats once a minute
+
+static TaskHandle_t s_link_task = nullptr;
+
+// Hints from other tasks; the link task takes and resets the counters once per tick
+static std::atomic<uint32_t> s_tx_bytes{0};
+static std::atomic<uint32_t> s_beacon_timeouts{0};
+static std::atomic<uint32_t> s_disconnects{0};
+static std::atomic<uint32_t> s_streams{0};        // open stream_begin() brackets
+static std::atomic<uint32_t> s_busy_until_ms{0};  // hold_busy() deadline
+static std::atomic<bool> s_busy_seen{false};      // a stream was active at some point during this tick
+
+static uint32_t now_ms() { return static_cast<uint32_t>(esp_timer_get_time() / 1000); }
+
+static bool busy_now() {
+    return s_streams.load() > 0 || static_cast<int32_t>(s_busy_until_ms.load() - now_ms()) > 0;
+}
+
+// First busy hint after a quiet spell wakes the task so PS_NONE applies before the transfer gets going
+static void mark_busy() {
+    if (!s_busy_seen.exchange(true) && s_link_task) xTaskNotifyGive(s_link_task);
+}
+
+void link_manager_note_tx(size_t bytes) { s_tx_bytes.fetch_add(static_cast<uint32_t>(bytes)); }
+
+void link_manager_hold_busy(uint32_t ms) {
+    const uint32_t until = now_ms() + ms;
+    uint32_t cur = s_busy_until_ms.load();
+    while (static_cast<int32_t>(until - cur) > 0 && !s_busy_until_ms.compare_exchange_weak(cur, until)) {}
+    mark_busy();
+}
+
+void link_manager_stream_begin(void) {
+    s_streams.fetch_add(1);
+    mark_busy();
+}
+
+void link_manager_stream_end(void) {
+    uint32_t cur = s_streams.load();
+    while (cur > 0 && !s_streams.compare_exchange_weak(cur, cur - 1)) {}
+}
+
+void link_manager_note_beacon_timeout(void) { s_beacon_timeouts.fetch_add(1); }
+void link_manager_note_disconnect(void) { s_disconnects.fetch_add(1); }
+
+static wifi_ps_type_t to_wifi_ps(link_policy::PowerSave ps) {
+    switch (ps) {
+        case link_policy::PowerSave::None: return WIFI_PS_NONE;
+        case link_policy::PowerSave::MaxModem: return WIFI_PS_MAX_MODEM;
+        default: return WIFI_PS_MIN_MODEM;
+    }
+}
+
+static const char* ps_name(wifi_ps_type_t ps) {
+    switch (ps) {
+        case WIFI_PS_NONE: return "NONE";
+        case WIFI_PS_MAX_MODEM: return "MAX_MODEM";
+        default: return "MIN_MODEM";
+    }
+}
+
+// Pinned mode from wifi.power_save; false for AUTO
+static bool pinned_ps(const config::WifiConfig& w, wifi_ps_type_t& out) {
+    const auto& v = w.power_save();
+    if (v == "NONE") out = WIFI_PS_NONE;
+    else if (v == "MIN_MODEM") out = WIFI_PS_MIN_MODEM;
+    else if (v == "MAX_MODEM") out = WIFI_PS_MAX_MODEM;
+    else return false;
+    return true;
+}
+
+struct LinkStats {
+    uint32_t ticks = 0;
+    int32_t rssi_sum = 0;
+    int8_t rssi_min = 0;
+    uint32_t rssi_samples = 0;
+    uint32_t tx_bytes = 0;
+    uint32_t beacon_timeouts = 0;
+    uint32_t disconnects = 0;
+    uint32_t unhealthy_ticks = 0;
+    uint32_t ps_changes = 0;
+    uint32_t tx_power_changes = 0;
+    uint32_t ps_ticks[3] = {0, 0, 0}; // NONE, MIN_MODEM, MAX_MODEM
+};
+
+static void publish_link_stats(const LinkStats& st, wifi_ps_type_t ps, uint8_t tx_qdbm, uint32_t outbox,
+                               bool pinned) {
+    if (get_system_state() != FULLY_CONNECTED) return;
+
+    cJSON* root = cJSON_CreateObject();
+    if (st.rssi_samples) {
+        cJSON_AddNumberToObject(root, "rssi_avg", (double)st.rssi_sum / st.rssi_samples);
+        cJSON_AddNumberToObject(root, "rssi_min", st.rssi_min);
+    }
+    cJSON_AddStringToObject(root, "power_save", ps_name(ps));
+    cJSON_AddBoolToObject(root, "power_save_pinned", pinned);
+    cJSON_AddNumberToObject(root, "tx_power_dbm", tx_qdbm / 4.0);
+    cJSON_AddNumberToObject(root, "tx_bytes", st.tx_bytes);
+    cJSON_AddNumberToObject(root, "beacon_timeouts", st.beacon_timeouts);
+    cJSON_AddNumberToObject(root, "disconnects", st.disconnects);
+    cJSON_AddNumberToObject(root, "outbox_bytes", outbox);
+    cJSON_AddNumberToObject(root, "unhealthy_s", st.unhealthy_ticks * kTickMs / 1000);
+    cJSON_AddNumberToObject(root, "ps_changes", st.ps_changes);
+    cJSON_AddNumberToObject(root, "tx_power_changes", st.tx_power_changes);
+    cJSON* ps_s = cJSON_CreateObject();
+    cJSON_AddNumberToObject(ps_s, "NONE", st.ps_ticks[0] * kTickMs / 1000);
+    cJSON_AddNumberToObject(ps_s, "MIN_MODEM", st.ps_ticks[1] * kTickMs / 1000);
+    cJSON_AddNumberToObject(ps_s, "MAX_MODEM", st.ps_ticks[2] * kTickMs / 1000);
+    cJSON_AddItemToObject(root, "power_save_s", ps_s);
+
+    char* json = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (!json) return;
+
+    const uint8_t* mac = get_device_mac();
+    char topic[64];
+    snprintf(topic, sizeof(topic), "sensor/%02x%02x%02x%02x%02x%02x/device/link", mac[0], mac[1], mac[2], mac[3],
+             mac[4], mac[5]);
+    publish_to_topic(topic, json, 0, 0);
+    cJSON_free(json);
+}
+
+static void link_task(void*) {
+    link_policy::State state;
+    LinkStats stats;
+    // Settings currently applied to the driver; wifi_init_sta() starts with PS_NONE for association
+    wifi_ps_type_t applied_ps = WIFI_PS_NONE;
+    uint8_t applied_tx = 0;
+    TickType_t next_tick = xTaskGetTickCount() + pdMS_TO_TICKS(kTickMs);
+
+    while (true) {
+        const TickType_t now = xTaskGetTickCount();
+        const TickType_t wait = static_cast<int32_t>(next_tick - now) > 0 ? next_tick - now : 0;
+        const bool woken =
+            ulTaskNotifyTake(pdTRUE, wait) > 0 && static_cast<int32_t>(next_tick - xTaskGetTickCount()) > 0;
+        auto& w = config::GetConfigurationManager().wifi();
+        wifi_ps_type_t pinned = WIFI_PS_NONE;
+        const bool is_pinned = pinned_ps(w, pinned);
+
+        wifi_ap_record_t ap = {};
+        const bool associated = esp_wifi_sta_get_ap_info(&ap) == ESP_OK && ap.rssi != 0;
+
+        if (woken) {
+            // Stream starting mid-tick: drop out of modem sleep now, the regular tick settles the rest
+            if (associated && !is_pinned && applied_ps != WIFI_PS_NONE && esp_wifi_set_ps(WIFI_PS_NONE) == ESP_OK) {
+                applied_ps = WIFI_PS_NONE;
+                stats.ps_changes++;
+            }
+            continue;
+        }
+        next_tick += pdMS_TO_TICKS(kTickMs);
+
+        link_policy::Params params;
+        params.tx_max_qdbm = static_cast<uint8_t>(w.tx_power_max_dbm() * 4);
+        if (params.tx_min_qdbm > params.tx_max_qdbm) params.tx_min_qdbm = params.tx_max_qdbm;
+
+        link_policy::Sample sample;
+        sample.rssi_dbm = associated ? ap.rssi : 0;
+        sample.tx_bytes = s_tx_bytes.exchange(0);
+        sample.beacon_timeouts = static_cast<uint16_t>(s_beacon_timeouts.exchange(0));
+        sample.disconnects = static_cast<uint16_t>(s_disconnects.exchange(0));
+        sample.streaming = s_busy_seen.exchange(false) || busy_now();
+        if (busy_now()) s_busy_seen.store(true); // still streaming: no wake-up needed for the next hint
+        esp_mqtt_client_handle_t client = get_mqtt_client();
+        const int outbox = client ? esp_mqtt_client_get_outbox_size(client) : 0;
+        sample.outbox_bytes = outbox > 0 ? static_cast<uint32_t>(outbox) : 0;
+
+        const link_policy::Decision d = link_policy::step(state, sample, params);
+
+        stats.ticks++;
+        stats.tx_bytes += sample.tx_bytes;
+        stats.beacon_timeouts += sample.beacon_timeouts;
+        stats.disconnects += sample.disconnects;
+        if (d.unhealthy) stats.unhealthy_ticks++;
+        if (associated) {
+            if (stats.rssi_samples == 0 || ap.rssi < stats.rssi_min) stats.rssi_min = ap.rssi;
+            stats.rssi_sum += ap.rssi;
+            stats.rssi_samples++;
+        }
+
+        // Not associated: back to PS_NONE for reliable (re)association, settings resume on reconnect
+        const wifi_ps_type_t want_ps = !associated ? WIFI_PS_NONE : (is_pinned ? pinned : to_wifi_ps(d.ps));
+        if (want_ps != applied_ps) {
+            esp_err_t err = esp_wifi_set_ps(want_ps);
+            if (err == ESP_OK) {
+                ESP_LOGI(TAG, "Power save %s -> %s (rssi=%d tx_bytes=%u%s)", ps_name(applied_ps), ps_name(want_ps),
+                         sample.rssi_dbm, (unsigned)sample.tx_bytes, sample.streaming ? " streaming" : "");
+                applied_ps = want_ps;
+                stats.ps_changes++;
+            } else {
+                ESP_LOGW(TAG, "esp_wifi_set_ps(%s) failed: %s", ps_name(want_ps), esp_err_to_name(err));
+            }
+        }
+        stats.ps_ticks[applied_ps == WIFI_PS_NONE ? 0 : (applied_ps == WIFI_PS_MAX_MODEM ? 2 : 1)]++;
+
+        if (associated && d.tx_qdbm != applied_tx) {
+            esp_err_t err = esp_wifi_set_max_tx_power(static_cast<int8_t>(d.tx_qdbm));
+            if (err == ESP_OK) {
+                ESP_LOGI(TAG, "TX power %.2f -> %.2f dBm (rssi=%d%s)", applied_tx / 4.0, d.tx_qdbm / 4.0,
+                         sample.rssi_dbm, d.unhealthy ? " unhealthy" : "");
+                applied_tx = d.tx_qdbm;
+                stats.tx_power_changes++;
+            } else {
+                ESP_LOGW(TAG, "esp_wifi_set_max_tx_power(%u) failed: %s", (unsigned)d.tx_qdbm, esp_err_to_name(err));
+            }
+        }
+
+        if (stats.ticks >= kTicksPerReport) {
+            publish_link_stats(stats, applied_ps, applied_tx, sample.outbox_bytes, is_pinned);
+            stats = LinkStats();
+        }
+    }
+}
+
+esp_err_t init_link_manager(void) {
+    if (s_link_task) return ESP_OK;
+    if (xTaskCreatePinnedToCore(link_task, "link", 4096, nullptr, tskIDLE_PRIORITY + 2, &s_link_task, tskNO_AFFINITY) !=
+        pdPASS) {
+        ESP_LOGE(TAG, "Failed to create link manager task");
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
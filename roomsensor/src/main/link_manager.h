@@ -0,0 +1,32 @@
+#pragma once
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Adaptive WiFi link settings (decision logic in link_policy.h):
+// - Power save follows traffic: NONE while a stream is active, MIN_MODEM normally, MAX_MODEM when idle
+// - TX power is lowered while RSSI has margin and the link stays healthy, raised on trouble
+// - Link statistics are published every minute to sensor/$mac/device/link
+// wifi.power_save pins the power-save mode instead of AUTO; wifi.max_tx_dbm caps TX power.
+esp_err_t init_link_manager(void);
+
+// Traffic hints, safe to call from any task
+void link_manager_note_tx(size_t bytes);
+// Keep the link in WIFI_PS_NONE for at least the next ms (call per chunk from streaming loops)
+void link_manager_hold_busy(uint32_t ms);
+// Bracket a blocking transfer that has no per-chunk hook
+void link_manager_stream_begin(void);
+void link_manager_stream_end(void);
+
+// Link events from the WiFi event handler
+void link_manager_note_beacon_timeout(void);
+void link_manager_note_disconnect(void);
+
+#ifdef __cplusplus
+}
+#endif
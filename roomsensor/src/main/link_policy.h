@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+
+namespace link_policy {
+
+// Decision logic for the WiFi link manager (link_manager.cpp). Pure, no driver calls: one step() per
+// sample period, fed with what happened on the link during that period.
+//
+// Power save:
+// - Streaming (HTTP transfer, OTA download) needs low latency: WIFI_PS_NONE.
+// - Otherwise MIN_MODEM (wake for every DTIM), and MAX_MODEM (listen interval) once the node has been
+//   quiet for idle_ticks_for_max periods with a healthy link. Bulk traffic or trouble returns to MIN_MODEM.
+//
+// TX power: as low as keeps the link healthy.
+// - The received RSSI stands in for path loss. With margin (rssi >= rssi_strong_dbm) and a healthy link for
+//   healthy_ticks_for_step periods, step down tx_step_qdbm.
+// - Uplink trouble shows up as beacon timeouts, disconnects or an MQTT outbox that does not drain. Any of
+//   these, or a weak signal, steps up twice as fast, and sets a floor one step above the failing level so
+//   the next descent stops short of it. The floor relaxes after floor_hold_ticks healthy periods.
+//
+// TX power is in the driver's units of 0.25 dBm (esp_wifi_set_max_tx_power).
+
+enum class PowerSave : uint8_t { None, MinModem, MaxModem };
+
+struct Params {
+    uint32_t busy_tx_bytes = 4096;          // per period: bulk traffic, no MAX_MODEM
+    uint32_t idle_tx_bytes = 512;           // per period: at or below counts as quiet
+    uint32_t idle_ticks_for_max = 12;       // quiet periods before MAX_MODEM
+    int8_t rssi_strong_dbm = -60;           // margin to shave TX power
+    int8_t rssi_weak_dbm = -72;             // raise TX power
+    uint32_t outbox_unhealthy_bytes = 2048; // MQTT bytes awaiting ack
+    uint8_t tx_step_qdbm = 8;               // 2 dBm
+    uint8_t tx_min_qdbm = 34;               // 8.5 dBm
+    uint8_t tx_max_qdbm = 80;               // 20 dBm
+    uint32_t healthy_ticks_for_step = 6;
+    uint32_t floor_hold_ticks = 720;
+};
+
+struct Sample {
+    int8_t rssi_dbm = 0;          // 0 => not associated
+    uint32_t tx_bytes = 0;        // application payload sent during the period
+    bool streaming = false;       // a streaming source held the link busy during the period
+    uint16_t beacon_timeouts = 0; // during the period
+    uint16_t disconnects = 0;     // during the period
+    uint32_t outbox_bytes = 0;    // at the end of the period
+};
+
+struct State {
+    PowerSave ps = PowerSave::MinModem;
+    uint8_t tx_qdbm = 80;
+    uint8_t floor_qdbm = 0;
+    uint32_t quiet_ticks = 0;
+    uint32_t healthy_ticks = 0;
+    uint32_t floor_age_ticks = 0;
+};
+
+struct Decision {
+    PowerSave ps;
+    uint8_t tx_qdbm;
+    bool unhealthy;
+};
+
+static inline uint8_t clamp_qdbm(int v, const Params& p) {
+    if (v < p.tx_min_qdbm) v = p.tx_min_qdbm;
+    if (v > p.tx_max_qdbm) v = p.tx_max_qdbm;
+    return static_cast<uint8_t>(v);
+}
+
+static inline Decision step(State& s, const Sample& x, const Params& p) {
+    // The limits come from the configuration and may have moved since the last period
+    s.tx_qdbm = clamp_qdbm(s.tx_qdbm, p);
+    const bool associated = x.rssi_dbm != 0;
+    const bool unhealthy = x.beacon_timeouts > 0 || x.disconnects > 0 || x.outbox_bytes > p.outbox_unhealthy_bytes ||
+                           (associated && x.rssi_dbm < p.rssi_weak_dbm);
+
+    // TX power
+    if (unhealthy) {
+        if (s.tx_qdbm < p.tx_max_qdbm) s.floor_qdbm = clamp_qdbm(s.tx_qdbm + p.tx_step_qdbm, p);
+        s.floor_age_ticks = 0;
+        s.tx_qdbm = clamp_qdbm(s.tx_qdbm + 2 * p.tx_step_qdbm, p);
+        s.healthy_ticks = 0;
+    } else if (associated) {
+        if (s.floor_qdbm && ++s.floor_age_ticks >= p.floor_hold_ticks) {
+            s.floor_qdbm = 0;
+            s.floor_age_ticks = 0;
+        }
+        if (x.rssi_dbm >= p.rssi_strong_dbm && ++s.healthy_ticks >= p.healthy_ticks_for_step) {
+            s.healthy_ticks = 0;
+            int next = s.tx_qdbm - p.tx_step_qdbm;
+            if (next < s.floor_qdbm) next = s.floor_qdbm;
+            s.tx_qdbm = clamp_qdbm(next, p);
+        } else if (x.rssi_dbm < p.rssi_strong_dbm) {
+            s.healthy_ticks = 0;
+        }
+    }
+
+    // Power save
+    if (x.streaming) {
+        s.quiet_ticks = 0;
+        s.ps = PowerSave::None;
+    } else {
+        if (x.tx_bytes > p.idle_tx_bytes || unhealthy) {
+            s.quiet_ticks = 0;
+        } else {
+            ++s.quiet_ticks;
+        }
+        s.ps = (s.quiet_ticks >= p.idle_ticks_for_max && x.tx_bytes < p.busy_tx_bytes) ? PowerSave::MaxModem
+                                                                                         : PowerSave::MinModem;
+    }
+    return {s.ps, s.tx_qdbm, unhealthy};
+}
+
+} // namespace link_policy
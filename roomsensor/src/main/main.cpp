@@ -9,6 +9,7 @@
 #include "LEDManager.h"
 #include "cJSON.h"
 #include "communication.h"
+#include "alarms.h"
 #include "i2c.h"
 #include "http.h"
 #include "ota.h"
@@ -16,8 +17,11 @@
 #include "ConfigurationManager.h"
 #include "WifiConfig.h"
 #include "gpio.h"
+#include "pwm.h"
+#include "link_manager.h"
 #include "filesystem.h"
 #include "netlog.h"
+#include "event_log.h"
 #include "debug.h"
 #include "status_led.h"
 #include "freertos/FreeRTOS.h"
@@ -37,6 +41,16 @@ extern "C" void app_main(void)
     }
     ESP_ERROR_CHECK(ret);
 
+    // Persistent event log before anything that can crash, so this boot's record lands first
+    event_log_init();
+
+    // Light the strips from the record of what they last showed, before the configuration is loaded.
+    // LEDManager::init() below hands them over to the configuration without restarting the output.
+    static leds::LEDManager led_manager;
+    if (led_manager.start_from_boot_state() == ESP_OK) {
+        ESP_LOGI(TAG, "LED instant-on started");
+    }
+
     // Initialize configuration subsystem (loads NVS, publishes current config)
     config::ConfigurationManager& cfg = config::GetConfigurationManager();
     esp_err_t cfg_err = cfg.initialize();
@@ -52,7 +66,6 @@ extern "C" void app_main(void)
     tzset();
 
     // Initialize LEDs manager
-    static leds::LEDManager led_manager;
     if (led_manager.init(cfg) != ESP_OK) {
         ESP_LOGE(TAG, "LEDManager initialization failed");
         log_memory_snapshot(TAG, "led_manager_init_failed");
@@ -64,6 +77,11 @@ extern "C" void app_main(void)
     // Initialize WiFi and MQTT
     wifi_mqtt_init();
 
+    // Adaptive power save / TX power; keeps PS_NONE until associated
+    if (init_link_manager() != ESP_OK) {
+        ESP_LOGW(TAG, "Link manager failed to start; WiFi stays at PS_NONE");
+    }
+
     // Block until retained boot/device message has been published (or timeout).
     // This includes the boot message that may wait up to 60s for SNTP before publishing.
     // If WiFi credentials or broker are not configured, skip waiting to reach console quickly.
@@ -103,6 +121,12 @@ extern "C" void app_main(void)
         ESP_LOGI(TAG, "Metrics reporting system started successfully");
     }
 
+    // Alarm path: own queue and task, publishes ahead of metrics; sensors report into it at sample time
+    if (initialize_alarm_system() != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize alarm system");
+        log_memory_snapshot(TAG, "alarm_init_failed");
+    }
+
     // Install GPIO ISR service once, before any modules add handlers
     {
         esp_err_t isr_err = gpio_install_isr_service(0);
@@ -118,6 +142,12 @@ extern "C" void app_main(void)
         log_memory_snapshot(TAG, "gpio_init_failed");
     }
 
+    // PWM outputs (LEDC); outputs following IO expander switches pick them up once I2C is running
+    if (init_pwm() != ESP_OK) {
+        ESP_LOGE(TAG, "PWM initialization failed");
+        log_memory_snapshot(TAG, "pwm_init_failed");
+    }
+
     // Initialize I2C subsystem
     if (!init_i2c()) {
         ESP_LOGE(TAG, "Failed to initialize I2C subsystem");
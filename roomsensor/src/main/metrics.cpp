@@ -1,4 +1,7 @@
 #include "communication.h"
+#include "metrics_bus.h"
+#include "publish_slot.h"
+#include "config.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -8,7 +11,11 @@
 #include <string.h>
 #include "esp_timer.h"
 #include <time.h>
-#include "freertos/semphr.h"
+#include <sys/time.h>
+#include "esp_random.h"
+#include "instrumented_lock.h"
+#include "esp_heap_caps.h"
+#include <atomic>
 
 // External function declarations from wifi.cpp
 extern const uint8_t* get_device_mac(void);
@@ -16,9 +23,39 @@ extern SystemState get_system_state(void);
 
 static const char* TAG = "metrics";
 
-// Queue handle for metric reports
+// Queue handle for metric reports. Only a handoff (report_metric may run in an ISR): the reporting task
+// drains it into the batch below as reports arrive, so it needs to hold one burst, e.g. every contact of
+// all eight MCP23008 expanders changing in one poll.
 static QueueHandle_t metrics_queue = NULL;
-#define METRICS_QUEUE_SIZE 50
+#define METRICS_QUEUE_SIZE 64
+
+// Reports waiting for the device's publish slot, one publish interval's worth. Worst case per interval with
+// every candidate sensor of i2c.cpp present:
+//   periodic: SEN55 8 + LIS2DH 9 + BME280 3 + SCD4x 3 + OPT3001 1 + 4 x ADS1115 4 + LED life 2 = 42
+//   LIS2DH motion follow-up polls, 1 s apart: 8 x 10 = 80; PIR motion edges: ~10
+//   contacts: 8 MCP23008 x 8 pins x 2 edges = 128
+// => 260; rounded to 320 so a burst of bouncing contacts does not drop the periodic values. 24 bytes each.
+#define METRICS_BATCH_MAX 320
+static MetricReport* metrics_batch = NULL;
+static int metrics_batch_count = 0;
+
+// Stable copies of the reporters' tags, one per distinct tag content. Queued reports point here rather than
+// at the caller's collection: drivers rewrite theirs for the next source (MCP23008 pins) long before the
+// report is published in the device's slot. Entries are never removed, like metrics bus series.
+#define METRICS_MAX_SOURCES 64
+typedef struct {
+    std::atomic<uint32_t> ready;
+    uint32_t key;
+    TagCollection tags;
+} TagSnapshot;
+static TagSnapshot* tag_snapshots = NULL;
+static std::atomic<uint32_t> tag_snapshots_claimed{0};
+
+// Reports lost, by cause; logged per slot and published with the device status (get_metrics_drop_counts)
+static std::atomic<uint32_t> drops_queue_full{0};
+static std::atomic<uint32_t> drops_batch_full{0};
+static std::atomic<uint32_t> drops_offline{0};
+static std::atomic<uint32_t> tag_snapshot_overflow{0};
 
 // Task handle for the metrics reporting task
 static TaskHandle_t metrics_task_handle = NULL;
@@ -29,20 +66,24 @@ static TaskHandle_t metrics_task_handle = NULL;
 static StoredMetric* latest_metrics = NULL;
 static int metrics_count = 0;
 static int metrics_capacity = 0;
-static SemaphoreHandle_t metrics_mutex = NULL;
+// Metrics store lock; waits over METRICS_LOCK_SLOW_US are reported with the holder (instrumented_lock.h)
+#define METRICS_LOCK_SLOW_US 2000
+static instrumented_lock_t* metrics_mutex = NULL;
 
-// Format current UTC time as ISO 8601 string with milliseconds: YYYY-MM-DDTHH:MM:SS.mmmZ
-static void format_iso8601_utc(char* buffer, size_t buffer_size) {
+// Format the UTC time of an esp_timer timestamp as ISO 8601 with milliseconds: YYYY-MM-DDTHH:MM:SS.mmmZ
+// (the sample may be older than now when its publish was deferred to the device's slot). Also used by alarms.cpp.
+void format_iso8601_utc(char* buffer, size_t buffer_size, int64_t sample_us) {
     if (buffer == NULL || buffer_size == 0) {
         return;
     }
 
-    time_t now_seconds;
-    time(&now_seconds);
-
-    // Use esp_timer for sub-second precision (microseconds since boot)
-    int64_t now_microseconds = esp_timer_get_time();
-    int milliseconds = (int)((now_microseconds / 1000) % 1000);
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    int64_t age_us = esp_timer_get_time() - sample_us;
+    if (age_us < 0) age_us = 0;
+    int64_t wall_us = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec - age_us;
+    time_t now_seconds = (time_t)(wall_us / 1000000);
+    int milliseconds = (int)((wall_us / 1000) % 1000);
 
     struct tm tm_utc;
     gmtime_r(&now_seconds, &tm_utc);
@@ -122,7 +163,7 @@ static char* create_json_message(const MetricReport* report) {
 
     // Add ISO 8601 UTC timestamp string (ts)
     char iso_ts[32];
-    format_iso8601_utc(iso_ts, sizeof(iso_ts));
+    format_iso8601_utc(iso_ts, sizeof(iso_ts), report->timestamp_us);
     cJSON_AddStringToObject(root, "ts", iso_ts);
 
     // Add tags as a nested object
@@ -218,29 +259,27 @@ static int find_metric_index(const char* metric_name, const TagCollection* tags)
     return -1; // Not found
 }
 
-// Store a metric in the latest metrics storage
-static esp_err_t store_latest_metric(const char* metric_name, float value, const TagCollection* tags) {
+// Store a metric in the latest metrics storage, stamped with when it was sampled (sample_us, esp_timer time):
+// batched reports are stored at the device's publish slot, up to one interval after they were taken
+static esp_err_t store_latest_metric(const char* metric_name, float value, const TagCollection* tags,
+                                     int64_t sample_us) {
     if (metrics_mutex == NULL) {
         ESP_LOGE(TAG, "Metrics mutex not initialized");
         return ESP_ERR_INVALID_STATE;
     }
     
-    // Get current timestamp 
-    // esp_timer_get_time returns microseconds since boot, not since epoch
-    int64_t now_microsec = esp_timer_get_time();
-    
-    // For timestamps we need time since epoch, not since boot
-    // Get current time as seconds since epoch
-    time_t now_sec;
-    time(&now_sec);
-    
-    // Convert to milliseconds and add the sub-second part from esp_timer
-    int64_t timestamp = (now_sec * 1000) + ((now_microsec / 1000) % 1000);
+    // esp_timer_get_time returns microseconds since boot, not since epoch; take the sample's age off the
+    // wall clock to get its epoch time in milliseconds
+    int64_t age_us = esp_timer_get_time() - sample_us;
+    if (age_us < 0) age_us = 0;
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    int64_t timestamp = ((int64_t)tv.tv_sec * 1000000 + tv.tv_usec - age_us) / 1000;
     
     ESP_LOGD(TAG, "Storing metric '%s' with timestamp: %lld ms", metric_name, timestamp);
     
     // Take mutex for the update
-    if (xSemaphoreTake(metrics_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+    if (!instrumented_lock_take(metrics_mutex, pdMS_TO_TICKS(100))) {
         ESP_LOGE(TAG, "Failed to take metrics mutex");
         return ESP_ERR_TIMEOUT;
     }
@@ -252,7 +291,7 @@ static esp_err_t store_latest_metric(const char* metric_name, float value, const
         // Update existing metric (no need for lock since we're just updating a value)
         latest_metrics[index].value = value;
         latest_metrics[index].timestamp = timestamp;
-        xSemaphoreGive(metrics_mutex);
+        instrumented_lock_give(metrics_mutex);
         return ESP_OK;
     }
     
@@ -266,7 +305,7 @@ static esp_err_t store_latest_metric(const char* metric_name, float value, const
         
         if (metrics_count >= MAX_METRICS_CAPACITY) {
             ESP_LOGE(TAG, "Maximum metrics capacity reached (%d)", MAX_METRICS_CAPACITY);
-            xSemaphoreGive(metrics_mutex);
+            instrumented_lock_give(metrics_mutex);
             return ESP_ERR_NO_MEM;
         }
         
@@ -274,7 +313,7 @@ static esp_err_t store_latest_metric(const char* metric_name, float value, const
         StoredMetric* new_metrics = (StoredMetric*)realloc(latest_metrics, new_capacity * sizeof(StoredMetric));
         if (new_metrics == NULL) {
             ESP_LOGE(TAG, "Failed to allocate memory for metrics storage");
-            xSemaphoreGive(metrics_mutex);
+            instrumented_lock_give(metrics_mutex);
             return ESP_ERR_NO_MEM;
         }
         
@@ -311,11 +350,107 @@ static esp_err_t store_latest_metric(const char* metric_name, float value, const
     
     ESP_LOGI(TAG, "Added new metric '%s' (total: %d/%d)", metric_name, metrics_count, metrics_capacity);
     
-    xSemaphoreGive(metrics_mutex);
+    instrumented_lock_give(metrics_mutex);
     return ESP_OK;
 }
 
-// The metrics reporting task
+// Publish one queued report and record it as the latest value
+static void publish_metric_report(const MetricReport* report) {
+    // Build the topic string
+    char* topic = build_metric_topic(report->metric_name, report->tags);
+    if (topic == NULL) {
+        ESP_LOGE(TAG, "Failed to build topic string");
+        return;
+    }
+
+    // Create the JSON message
+    char* json_str = create_json_message(report);
+    if (json_str == NULL) {
+        ESP_LOGE(TAG, "Failed to create JSON message");
+        free(topic);
+        return;
+    }
+
+    // Publish the message
+    esp_err_t err = publish_to_topic(topic, json_str, 1, 0);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to publish metric: %s", esp_err_to_name(err));
+    } else {
+        ESP_LOGD(TAG, "Published metric to %s: %s", topic, json_str);
+    }
+
+    // In addition to publishing, also store the latest value
+    store_latest_metric(report->metric_name, report->value, report->tags, report->timestamp_us);
+
+    // Clean up dynamically allocated memory
+    free(topic);
+    free(json_str);
+}
+
+// Milliseconds until this device's publish slot (see publish_slot.h). Uses SNTP time when it is set so slots
+// line up across the fleet, otherwise the boot clock.
+static uint32_t ms_until_publish_slot(void) {
+    if (METRICS_PUBLISH_SLOT_MS <= 0) return 0;
+    static uint32_t slot_offset_ms = UINT32_MAX;
+    if (slot_offset_ms == UINT32_MAX) {
+        const uint8_t* mac = get_device_mac();
+        static const uint8_t no_mac[6] = {0};
+        slot_offset_ms = publish_slot::offset_for_mac(mac ? mac : no_mac, METRICS_PUBLISH_SLOT_MS);
+        ESP_LOGI(TAG, "Metrics publish slot: +%lu ms every %d ms", (unsigned long)slot_offset_ms,
+                 METRICS_PUBLISH_SLOT_MS);
+    }
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    uint64_t now_ms;
+    if (tv.tv_sec >= 1609459200) { // after 2021-01-01 => SNTP has set the clock
+        now_ms = (uint64_t)tv.tv_sec * 1000 + (uint64_t)(tv.tv_usec / 1000);
+    } else {
+        now_ms = (uint64_t)(esp_timer_get_time() / 1000);
+    }
+    float jitter = (float)(esp_random() >> 8) / (float)(1u << 24);
+    return publish_slot::ms_until_slot(now_ms, METRICS_PUBLISH_SLOT_MS, slot_offset_ms, METRICS_PUBLISH_JITTER_MS,
+                                       jitter);
+}
+
+static void batch_add(const MetricReport* report) {
+    if (metrics_batch_count < METRICS_BATCH_MAX) {
+        metrics_batch[metrics_batch_count++] = *report;
+    } else {
+        drops_batch_full.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Move reports from the queue into the batch as they arrive, for wait_ms
+static void collect_reports(uint32_t wait_ms) {
+    const int64_t deadline_us = esp_timer_get_time() + (int64_t)wait_ms * 1000;
+    MetricReport report;
+    while (true) {
+        int64_t left_us = deadline_us - esp_timer_get_time();
+        TickType_t ticks = left_us > 0 ? pdMS_TO_TICKS((left_us + 999) / 1000) : 0;
+        if (left_us > 0 && ticks == 0) ticks = 1;
+        if (xQueueReceive(metrics_queue, &report, ticks) != pdTRUE) {
+            if (left_us <= 0) return;
+            continue;
+        }
+        batch_add(&report);
+    }
+}
+
+static void log_drops(void) {
+    static uint32_t logged_total = 0;
+    uint32_t q = drops_queue_full.load(std::memory_order_relaxed);
+    uint32_t b = drops_batch_full.load(std::memory_order_relaxed);
+    uint32_t o = drops_offline.load(std::memory_order_relaxed);
+    uint32_t t = tag_snapshot_overflow.load(std::memory_order_relaxed);
+    if (q + b + o == logged_total) return;
+    logged_total = q + b + o;
+    ESP_LOGW(TAG, "Metric reports dropped so far: queue full %lu, batch full %lu, offline %lu (untracked tags %lu)",
+             (unsigned long)q, (unsigned long)b, (unsigned long)o, (unsigned long)t);
+}
+
+// The metrics reporting task: collects reports into the batch until the device's slot, then publishes the
+// batch back to back (esp_mqtt_client_publish blocks on the socket, which paces it)
 static void metrics_reporting_task(void* pvParameters) {
     ESP_LOGI(TAG, "Metrics reporting task started");
 
@@ -323,69 +458,66 @@ static void metrics_reporting_task(void* pvParameters) {
 
     while (1) {
         // Wait for a new metric report
-        if (xQueueReceive(metrics_queue, &report, portMAX_DELAY) == pdTRUE) {
-            // Check system state before trying to publish
-            if (get_system_state() != FULLY_CONNECTED) {
-                ESP_LOGW(TAG, "System not fully connected, waiting before publishing metric %s", report.metric_name);
-
-                // Wait for system to be fully connected, checking every second
-                // Maximum retry count of 30 (30 seconds)
-                int retry_count = 0;
-                const int max_retries = 30;
+        if (metrics_batch_count == 0) {
+            if (xQueueReceive(metrics_queue, &report, portMAX_DELAY) != pdTRUE) {
+                continue;
+            }
+            batch_add(&report);
+        }
 
-                while (get_system_state() != FULLY_CONNECTED && retry_count < max_retries) {
-                    vTaskDelay(pdMS_TO_TICKS(1000)); // Wait 1 second
-                    retry_count++;
-                }
+        collect_reports(ms_until_publish_slot());
 
-                if (get_system_state() != FULLY_CONNECTED) {
-                    ESP_LOGW(TAG, "System still not connected after waiting, discarding metric %s", report.metric_name);
-                    continue; // Skip this metric
-                }
+        // Check system state before trying to publish
+        if (get_system_state() != FULLY_CONNECTED) {
+            ESP_LOGW(TAG, "System not fully connected, waiting before publishing %d metrics", metrics_batch_count);
 
-                ESP_LOGI(TAG, "System now connected, proceeding with publishing metric %s", report.metric_name);
-            }
+            // Wait for system to be fully connected, checking every second
+            // Maximum retry count of 30 (30 seconds)
+            int retry_count = 0;
+            const int max_retries = 30;
 
-            // Build the topic string
-            char* topic = build_metric_topic(report.metric_name, report.tags);
-            if (topic == NULL) {
-                ESP_LOGE(TAG, "Failed to build topic string");
-                continue;
+            while (get_system_state() != FULLY_CONNECTED && retry_count < max_retries) {
+                collect_reports(1000);
+                retry_count++;
             }
 
-            // Create the JSON message
-            char* json_str = create_json_message(&report);
-            if (json_str == NULL) {
-                ESP_LOGE(TAG, "Failed to create JSON message");
-                free(topic);
+            if (get_system_state() != FULLY_CONNECTED) {
+                drops_offline.fetch_add(metrics_batch_count, std::memory_order_relaxed);
+                ESP_LOGW(TAG, "System still not connected after waiting, discarding %d metrics", metrics_batch_count);
+                metrics_batch_count = 0;
+                log_drops();
                 continue;
             }
 
-            // Publish the message
-            esp_err_t err = publish_to_topic(topic, json_str, 1, 0);
-            if (err != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to publish metric: %s", esp_err_to_name(err));
-            } else {
-                ESP_LOGD(TAG, "Published metric to %s: %s", topic, json_str);
-            }
-            
-            // In addition to publishing, also store the latest value
-            store_latest_metric(report.metric_name, report.value, report.tags);
-
-            // Clean up dynamically allocated memory
-            free(topic);
-            free(json_str);
+            // Reconnected: publish the backlog in the next slot rather than all at once with the rest of the fleet
+            ESP_LOGI(TAG, "System now connected, publishing queued metrics in next slot");
+            collect_reports(ms_until_publish_slot());
+        }
 
-            // Add a small delay between publishing to prevent overwhelming MQTT
-            vTaskDelay(pdMS_TO_TICKS(20));
+        // Publish the batch; reports arriving meanwhile stay queued for the next slot
+        int64_t start_us = esp_timer_get_time();
+        for (int i = 0; i < metrics_batch_count; i++) {
+            publish_metric_report(&metrics_batch[i]);
         }
+        ESP_LOGD(TAG, "Published %d metrics in %lld ms", metrics_batch_count,
+                 (long long)((esp_timer_get_time() - start_us) / 1000));
+        metrics_batch_count = 0;
+        log_drops();
     }
 }
 
+void get_metrics_drop_counts(MetricsDropCounts* out) {
+    if (out == NULL) return;
+    out->queue_full = drops_queue_full.load(std::memory_order_relaxed);
+    out->batch_full = drops_batch_full.load(std::memory_order_relaxed);
+    out->offline = drops_offline.load(std::memory_order_relaxed);
+    out->untracked_tags = tag_snapshot_overflow.load(std::memory_order_relaxed);
+}
+
 // Initialize metrics system and start the reporting task
 esp_err_t initialize_metrics_system(void) {
     // Create the metrics mutex
-    metrics_mutex = xSemaphoreCreateMutex();
+    metrics_mutex = instrumented_lock_create("metrics", METRICS_LOCK_SLOW_US);
     if (metrics_mutex == NULL) {
         ESP_LOGE(TAG, "Failed to create metrics mutex");
         return ESP_FAIL;
@@ -396,7 +528,7 @@ esp_err_t initialize_metrics_system(void) {
     latest_metrics = (StoredMetric*)malloc(metrics_capacity * sizeof(StoredMetric));
     if (latest_metrics == NULL) {
         ESP_LOGE(TAG, "Failed to allocate memory for metrics storage");
-        vSemaphoreDelete(metrics_mutex);
+        instrumented_lock_delete(metrics_mutex);
         metrics_mutex = NULL;
         return ESP_FAIL;
     }
@@ -408,11 +540,33 @@ esp_err_t initialize_metrics_system(void) {
         ESP_LOGE(TAG, "Failed to create metrics queue");
         free(latest_metrics);
         latest_metrics = NULL;
-        vSemaphoreDelete(metrics_mutex);
+        instrumented_lock_delete(metrics_mutex);
         metrics_mutex = NULL;
         return ESP_FAIL;
     }
 
+    // The slot batch, and the tag snapshots (PSRAM only; without them reports keep the caller's pointer)
+    metrics_batch = (MetricReport*)heap_caps_malloc(METRICS_BATCH_MAX * sizeof(MetricReport),
+                                                    MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (metrics_batch == NULL) {
+        metrics_batch = (MetricReport*)malloc(METRICS_BATCH_MAX * sizeof(MetricReport));
+    }
+    if (metrics_batch == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate the metrics batch");
+        vQueueDelete(metrics_queue);
+        metrics_queue = NULL;
+        free(latest_metrics);
+        latest_metrics = NULL;
+        instrumented_lock_delete(metrics_mutex);
+        metrics_mutex = NULL;
+        return ESP_FAIL;
+    }
+    tag_snapshots = (TagSnapshot*)heap_caps_calloc(METRICS_MAX_SOURCES, sizeof(TagSnapshot),
+                                                   MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (tag_snapshots == NULL) {
+        ESP_LOGW(TAG, "No PSRAM for tag snapshots; sources sharing a tag collection may publish stale tags");
+    }
+
     // Create the reporting task
     BaseType_t ret = xTaskCreate(
         metrics_reporting_task,
@@ -427,9 +581,13 @@ esp_err_t initialize_metrics_system(void) {
         ESP_LOGE(TAG, "Failed to create metrics reporting task");
         vQueueDelete(metrics_queue);
         metrics_queue = NULL;
+        free(metrics_batch);
+        metrics_batch = NULL;
+        free(tag_snapshots);
+        tag_snapshots = NULL;
         free(latest_metrics);
         latest_metrics = NULL;
-        vSemaphoreDelete(metrics_mutex);
+        instrumented_lock_delete(metrics_mutex);
         metrics_mutex = NULL;
         return ESP_FAIL;
     }
@@ -438,8 +596,60 @@ esp_err_t initialize_metrics_system(void) {
     return ESP_OK;
 }
 
+// Value of a tag by key, or NULL
+static const char* find_tag_value(const TagCollection* tags, const char* key) {
+    for (int i = 0; i < tags->count && i < MAX_DEVICE_TAGS; i++) {
+        if (strcmp(tags->tags[i].key, key) == 0) {
+            return tags->tags[i].value;
+        }
+    }
+    return NULL;
+}
+
+// Identity of a reporting source on the metrics bus: all of its tags, so sources sharing one collection
+// stay apart
+static uint32_t bus_source_key(const TagCollection* tags) {
+    metrics_bus::SourceKey key;
+    for (int i = 0; i < tags->count && i < MAX_DEVICE_TAGS; i++) {
+        key.add(tags->tags[i].key).add(tags->tags[i].value);
+    }
+    return key.value();
+}
+
+// Stable copy of 'tags' for a queued report (see TagSnapshot). Lock-free like the metrics bus: two reporters
+// registering the same new source at once may create a duplicate, which only costs an entry.
+static TagCollection* snapshot_tags(TagCollection* tags, uint32_t key) {
+    if (tag_snapshots == NULL) return tags;
+    uint32_t n = tag_snapshots_claimed.load(std::memory_order_acquire);
+    if (n > METRICS_MAX_SOURCES) n = METRICS_MAX_SOURCES;
+    for (uint32_t i = 0; i < n; i++) {
+        TagSnapshot* s = &tag_snapshots[i];
+        if (s->ready.load(std::memory_order_acquire) && s->key == key) return &s->tags;
+    }
+    uint32_t idx = tag_snapshots_claimed.fetch_add(1, std::memory_order_acq_rel);
+    if (idx >= METRICS_MAX_SOURCES) {
+        tag_snapshots_claimed.store(METRICS_MAX_SOURCES, std::memory_order_relaxed);
+        tag_snapshot_overflow.fetch_add(1, std::memory_order_relaxed);
+        return tags;
+    }
+    TagSnapshot* s = &tag_snapshots[idx];
+    memcpy(&s->tags, tags, sizeof(TagCollection));
+    s->key = key;
+    s->ready.store(1, std::memory_order_release);
+    return &s->tags;
+}
+
 // Report a new metric (can be called from any task or interrupt handler)
 esp_err_t report_metric(const char* metric_name, float value, TagCollection* tags) {
+    // Feed the in-process bus first so local consumers (LED dashboards) see samples even before MQTT is up.
+    // Lock-free and allocation-free, so this is also safe from ISR context.
+    uint32_t source_key = 0;
+    if (metric_name != NULL && tags != NULL) {
+        source_key = bus_source_key(tags);
+        metrics_bus::publish(metric_name, source_key, find_tag_value(tags, "name"), value,
+                             (uint32_t)(esp_timer_get_time() / 1000));
+    }
+
     if (metrics_queue == NULL) {
         ESP_LOGE(TAG, "Metrics queue not initialized");
         return ESP_ERR_INVALID_STATE;
@@ -454,13 +664,15 @@ esp_err_t report_metric(const char* metric_name, float value, TagCollection* tag
     MetricReport report;
     report.metric_name = metric_name;  // Directly store the pointer to the static string
     report.value = value;
-    report.tags = tags;
+    report.tags = snapshot_tags(tags, source_key);
+    report.timestamp_us = esp_timer_get_time();
 
     // Send the report to the queue
     if (xPortInIsrContext()) {
         BaseType_t xHigherPriorityTaskWoken = pdFALSE;
         if (xQueueSendFromISR(metrics_queue, &report, &xHigherPriorityTaskWoken) != pdTRUE) {
-            // Avoid logging from ISR context; just drop silently
+            // Avoid logging from ISR context; counted and logged by the reporting task
+            drops_queue_full.fetch_add(1, std::memory_order_relaxed);
             if (xHigherPriorityTaskWoken == pdTRUE) {
                 portYIELD_FROM_ISR();
             }
@@ -476,6 +688,7 @@ esp_err_t report_metric(const char* metric_name, float value, TagCollection* tag
         UBaseType_t queue_messages = uxQueueMessagesWaiting(metrics_queue);
         UBaseType_t queue_size = METRICS_QUEUE_SIZE;
         if (xQueueSend(metrics_queue, &report, 0) != pdTRUE) {
+            drops_queue_full.fetch_add(1, std::memory_order_relaxed);
             ESP_LOGE(TAG, "Failed to send metric report to queue - metric: %s, value: %.3f, queue spaces: %d/%d",
                     metric_name, value, queue_spaces, queue_size);
 
@@ -503,7 +716,7 @@ StoredMetricCollection* get_latest_metrics(void) {
     }
     
     // Take mutex for the read
-    if (xSemaphoreTake(metrics_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+    if (!instrumented_lock_take(metrics_mutex, pdMS_TO_TICKS(100))) {
         ESP_LOGE(TAG, "Failed to take metrics mutex for read");
         return NULL;
     }
@@ -512,7 +725,7 @@ StoredMetricCollection* get_latest_metrics(void) {
     StoredMetricCollection* collection = (StoredMetricCollection*)malloc(sizeof(StoredMetricCollection));
     if (collection == NULL) {
         ESP_LOGE(TAG, "Failed to allocate memory for metrics collection");
-        xSemaphoreGive(metrics_mutex);
+        instrumented_lock_give(metrics_mutex);
         return NULL;
     }
     
@@ -522,7 +735,7 @@ StoredMetricCollection* get_latest_metrics(void) {
     
     if (metrics_count == 0) {
         collection->metrics = NULL;
-        xSemaphoreGive(metrics_mutex);
+        instrumented_lock_give(metrics_mutex);
         return collection;
     }
     
@@ -531,14 +744,14 @@ StoredMetricCollection* get_latest_metrics(void) {
     if (collection->metrics == NULL) {
         ESP_LOGE(TAG, "Failed to allocate memory for metrics array copy");
         free(collection);
-        xSemaphoreGive(metrics_mutex);
+        instrumented_lock_give(metrics_mutex);
         return NULL;
     }
     
     // Copy metrics
     memcpy(collection->metrics, latest_metrics, metrics_count * sizeof(StoredMetric));
     
-    xSemaphoreGive(metrics_mutex);
+    instrumented_lock_give(metrics_mutex);
     return collection;
 }
 
@@ -0,0 +1,148 @@
+#include "mqtt_tls.h"
+#include "esp_tls.h"
+#include "esp_crt_bundle.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+
+static const char *TAG = "mqtt_tls";
+
+#define MQTT_TLS_DEFAULT_PORT 8883
+
+struct mqtt_tls_ctx {
+    esp_tls_t* tls;
+};
+
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+// Ticket from the most recent handshake; one broker per device, so a single slot is enough
+static esp_tls_client_session_t* s_session = nullptr;
+#endif
+
+static int tls_close(esp_transport_handle_t t) {
+    mqtt_tls_ctx* ctx = (mqtt_tls_ctx*)esp_transport_get_context_data(t);
+    if (ctx && ctx->tls) {
+        esp_tls_conn_destroy(ctx->tls);
+        ctx->tls = nullptr;
+    }
+    return 0;
+}
+
+static int tls_connect(esp_transport_handle_t t, const char* host, int port, int timeout_ms) {
+    mqtt_tls_ctx* ctx = (mqtt_tls_ctx*)esp_transport_get_context_data(t);
+    tls_close(t);
+    ctx->tls = esp_tls_init();
+    if (!ctx->tls) {
+        ESP_LOGE(TAG, "Failed to allocate TLS connection");
+        return -1;
+    }
+
+    esp_tls_cfg_t cfg = {};
+    cfg.crt_bundle_attach = esp_crt_bundle_attach;
+    cfg.timeout_ms = timeout_ms;
+    bool offered_ticket = false;
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+    cfg.client_session = s_session;
+    offered_ticket = s_session != nullptr;
+#endif
+
+    size_t heap_before = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    int64_t t0 = esp_timer_get_time();
+    if (esp_tls_conn_new_sync(host, strlen(host), port, &cfg, ctx->tls) <= 0) {
+        ESP_LOGW(TAG, "TLS connect to %s:%d failed", host, port);
+        tls_close(t);
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+        // Start over with a full handshake in case the ticket itself is the problem
+        if (s_session) {
+            esp_tls_free_client_session(s_session);
+            s_session = nullptr;
+        }
+#endif
+        return -1;
+    }
+    int64_t elapsed_us = esp_timer_get_time() - t0;
+    size_t heap_after = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    ESP_LOGI(TAG, "TLS to %s:%d in %lld ms (%s), connection holds %d B internal heap", host, port,
+             (long long)(elapsed_us / 1000), offered_ticket ? "ticket offered" : "full handshake",
+             (int)heap_before - (int)heap_after);
+
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+    // Keep the newest ticket; servers rotate them and may reject an old one
+    esp_tls_client_session_t* fresh = esp_tls_get_client_session(ctx->tls);
+    if (fresh) {
+        if (s_session) esp_tls_free_client_session(s_session);
+        s_session = fresh;
+    }
+#endif
+    return 0;
+}
+
+// 1 when the socket is ready, 0 on timeout, -1 on error. A negative timeout waits forever.
+static int poll_socket(esp_tls_t* tls, int timeout_ms, bool for_read) {
+    int fd = -1;
+    if (!tls || esp_tls_get_conn_sockfd(tls, &fd) != ESP_OK || fd < 0) return -1;
+    fd_set ready, errors;
+    FD_ZERO(&ready);
+    FD_ZERO(&errors);
+    FD_SET(fd, &ready);
+    FD_SET(fd, &errors);
+    struct timeval tv = {.tv_sec = timeout_ms / 1000, .tv_usec = (timeout_ms % 1000) * 1000};
+    int r = select(fd + 1, for_read ? &ready : nullptr, for_read ? nullptr : &ready, &errors,
+                   timeout_ms < 0 ? nullptr : &tv);
+    if (r > 0 && FD_ISSET(fd, &errors)) return -1;
+    return r > 0 ? 1 : r;
+}
+
+static int tls_poll_read(esp_transport_handle_t t, int timeout_ms) {
+    mqtt_tls_ctx* ctx = (mqtt_tls_ctx*)esp_transport_get_context_data(t);
+    // Records already decrypted by mbedTLS are not visible on the socket
+    if (ctx->tls && esp_tls_get_bytes_avail(ctx->tls) > 0) return 1;
+    return poll_socket(ctx->tls, timeout_ms, true);
+}
+
+static int tls_poll_write(esp_transport_handle_t t, int timeout_ms) {
+    mqtt_tls_ctx* ctx = (mqtt_tls_ctx*)esp_transport_get_context_data(t);
+    return poll_socket(ctx->tls, timeout_ms, false);
+}
+
+static int tls_read(esp_transport_handle_t t, char* buffer, int len, int timeout_ms) {
+    mqtt_tls_ctx* ctx = (mqtt_tls_ctx*)esp_transport_get_context_data(t);
+    int poll = tls_poll_read(t, timeout_ms);
+    if (poll <= 0) return poll == 0 ? ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT : poll;
+    ssize_t r = esp_tls_conn_read(ctx->tls, buffer, len);
+    if (r == 0) return ERR_TCP_TRANSPORT_CONNECTION_CLOSED_BY_FIN;
+    if (r == ESP_TLS_ERR_SSL_WANT_READ || r == ESP_TLS_ERR_SSL_WANT_WRITE) return ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT;
+    return (int)r;
+}
+
+static int tls_write(esp_transport_handle_t t, const char* buffer, int len, int timeout_ms) {
+    mqtt_tls_ctx* ctx = (mqtt_tls_ctx*)esp_transport_get_context_data(t);
+    int poll = tls_poll_write(t, timeout_ms);
+    if (poll <= 0) return poll;
+    ssize_t r = esp_tls_conn_write(ctx->tls, buffer, len);
+    if (r == ESP_TLS_ERR_SSL_WANT_READ || r == ESP_TLS_ERR_SSL_WANT_WRITE) return 0;
+    return (int)r;
+}
+
+static int tls_destroy(esp_transport_handle_t t) {
+    tls_close(t);
+    free(esp_transport_get_context_data(t));
+    return 0;
+}
+
+esp_transport_handle_t mqtt_tls_transport_create(void) {
+    esp_transport_handle_t t = esp_transport_init();
+    if (!t) return nullptr;
+    mqtt_tls_ctx* ctx = (mqtt_tls_ctx*)calloc(1, sizeof(mqtt_tls_ctx));
+    if (!ctx) {
+        esp_transport_destroy(t);
+        return nullptr;
+    }
+    esp_transport_set_context_data(t, ctx);
+    esp_transport_set_func(t, tls_connect, tls_read, tls_write, tls_close, tls_poll_read, tls_poll_write, tls_destroy);
+    esp_transport_set_default_port(t, MQTT_TLS_DEFAULT_PORT);
+    return t;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "esp_transport.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// TLS transport for mqtts:// brokers, used instead of esp-mqtt's built-in SSL transport so the
+// session ticket from the last connection can be offered on the next one. A resumed handshake skips
+// certificate verification and the ECDHE exchange, which is most of the CPU time and transient heap
+// when the whole fleet reconnects after a broker restart.
+// - Certificates are checked against the IDF CA bundle.
+// - The ticket lives in RAM only: reconnects resume, reboots do a full handshake.
+// - The handle is owned (and destroyed) by the MQTT client once passed in network.transport.
+esp_transport_handle_t mqtt_tls_transport_create(void);
+
+#ifdef __cplusplus
+}
+#endif
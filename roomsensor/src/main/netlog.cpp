@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "console_buffer.h"
+#include "event_log.h"
 
 // Small log queue. Each item stores level, tag and a message string.
 // We keep messages reasonably small to avoid memory pressure.
@@ -149,17 +150,12 @@ static int netlog_vprintf_hook(const char* fmt, va_list args) {
         va_end(forward_args);
     }
 
-    // Cheap fast-path exits: disabled, ISR, tiny-stack task, not connected, or no queue
+    // Cheap fast-path exits: disabled, ISR, tiny-stack task, not connected, or no queue.
+    // A full queue is only checked at the send, so warnings still reach the event log while offline.
     if (!s_hook_enabled) return forwarded;
     if (xPortInIsrContext()) return forwarded;
     if (!s_log_queue) return forwarded;
 
-    // Drop immediately if queue is full
-    if (uxQueueSpacesAvailable(s_log_queue) == 0) {
-        s_dropped_logs++;
-        return forwarded;
-    }
-
     // Format into a small temporary buffer using a copy of args (avoid large stack)
     char buffer[160];
     va_list capture_args;
@@ -174,6 +170,18 @@ static int netlog_vprintf_hook(const char* fmt, va_list args) {
     item.level = ESP_LOG_INFO;
     parse_tag_level(buffer, item.tag, sizeof(item.tag), &item.level);
 
+    // Copy message, trimming trailing newlines to keep MQTT payload tidy
+    size_t len = strnlen(buffer, sizeof(buffer));
+    while (len > 0 && (buffer[len - 1] == '\n' || buffer[len - 1] == '\r')) len--;
+    size_t copy_len = len < sizeof(item.msg) - 1 ? len : sizeof(item.msg) - 1;
+    memcpy(item.msg, buffer, copy_len);
+    item.msg[copy_len] = '\0';
+
+    // Warnings and errors persist across reboots, whatever the network filter says
+    if (item.level != ESP_LOG_NONE && item.level <= ESP_LOG_WARN) {
+        event_log_write(item.level, item.msg, copy_len);
+    }
+
     // Apply wifi.loglevel filter for net publishing only (UART unaffected)
     int net_level = ESP_LOG_WARN;
     {
@@ -184,19 +192,12 @@ static int netlog_vprintf_hook(const char* fmt, va_list args) {
         return forwarded;
     }
 
-    // Copy message, trimming trailing newlines to keep MQTT payload tidy
-    size_t len = strnlen(buffer, sizeof(buffer));
-    while (len > 0 && (buffer[len - 1] == '\n' || buffer[len - 1] == '\r')) len--;
-    size_t copy_len = len < sizeof(item.msg) - 1 ? len : sizeof(item.msg) - 1;
-    memcpy(item.msg, buffer, copy_len);
-    item.msg[copy_len] = '\0';
-
     // Also append to console circular buffer as OUT
     console_buffer_append(item.msg, copy_len, CONSOLE_DIR_OUT);
 
     // Avoid recursion when we publish logs (publishing may log internally). Non-blocking.
-    if (!s_in_publish) {
-        (void)xQueueSend(s_log_queue, &item, 0);
+    if (!s_in_publish && xQueueSend(s_log_queue, &item, 0) != pdTRUE) {
+        s_dropped_logs++;
     }
 
     return forwarded;
@@ -1,7 +1,6 @@
 #include "ota.h"
 #include "esp_log.h"
 #include "esp_http_client.h"
-#include "esp_https_ota.h"
 #include "esp_crt_bundle.h"
 #include "esp_ota_ops.h"
 #include "cJSON.h"
@@ -24,6 +23,9 @@
 #include "debug.h"
 #include "ConfigurationManager.h"
 #include "WifiConfig.h"
+#include "ota_inflate.h"
+#include "link_manager.h"
+#include "flash_window.h"
 #include <string>
 
 /*
@@ -56,7 +58,9 @@
  * 2. Task waits for full system connectivity (WiFi + MQTT)
  * 3. When connected, periodically checks server for manifest
  * 4. Parses manifest and compares build timestamps
- * 5. If newer version exists, triggers OTA update (firmware first, then web)
+ * 5. If newer version exists, triggers OTA update (firmware first, then web). When the manifest
+ *    offers a zlib-compressed image it is inflated while streaming into the OTA partition and
+ *    checked against the manifest's SHA-256; otherwise the plain image is used.
  * 6. Reports status to MQTT at key points (boot, network connection, before/after updates)
  */
 
@@ -122,6 +126,7 @@ static char* read_text_file(const char* path);
 static bool write_text_file_atomic(const char* path, const char* text);
 static void report_ota_status(ota_status_t status, const char* error_message);
 static esp_err_t perform_https_ota_from_url(const char* firmware_url);
+static esp_err_t perform_firmware_ota(const cJSON* manifest, const char* firmware_url);
 
 // Read the OTA state file (/storage/ota_state.json)
 static bool read_ota_state(ota_state_t* state) {
@@ -230,6 +235,7 @@ static char* read_text_file(const char* path) {
 
 // Helper: write buffer to a file atomically via temp path then rename
 static bool write_text_file_atomic(const char* path, const char* text) {
+    flash_window::Scope flash;
     char tmp[128];
     snprintf(tmp, sizeof(tmp), "%s.tmp", path);
     FILE* f = fopen(tmp, "wb");
@@ -254,9 +260,11 @@ static bool copy_file(const char* src, const char* dst) {
     size_t n;
     bool ok = true;
     while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+        flash_window::Scope flash;
         if (fwrite(buf, 1, n, out) != n) { ok = false; break; }
     }
     fclose(in);
+    flash_window::Scope flash;
     if (fclose(out) != 0) ok = false;
     if (!ok) { remove(tmp); return false; }
     if (rename(tmp, dst) != 0) { remove(tmp); return false; }
@@ -358,6 +366,7 @@ static esp_err_t download_web_asset(const char* url, const char* version_hash) {
     uint8_t buf[2048];
     int read_total = 0;
     while (1) {
+        link_manager_hold_busy(2000);
         int r = esp_http_client_read(client, (char*)buf, sizeof(buf));
         if (r < 0) {
             ESP_LOGE(TAG, "Error reading web content: %d", r);
@@ -368,7 +377,12 @@ static esp_err_t download_web_asset(const char* url, const char* version_hash) {
             return ESP_FAIL;
         }
         if (r == 0) break; // connection closed
-        if (fwrite(buf, 1, (size_t)r, f) != (size_t)r) {
+        bool written;
+        {
+            flash_window::Scope flash;
+            written = fwrite(buf, 1, (size_t)r, f) == (size_t)r;
+        }
+        if (!written) {
             ESP_LOGE(TAG, "Error writing temp web file");
             fclose(f);
             remove(tmp_path);
@@ -444,6 +458,7 @@ void ota_notify_network_connected(void) {
 
 // Save OTA information for logging purposes (does not affect update decision)
 static void save_ota_info(time_t timestamp, const char* hash) {
+    flash_window::Scope flash;
     nvs_handle_t nvs_handle;
     esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
 
@@ -621,7 +636,8 @@ static bool parse_manifest_and_check_update(char *manifest_data) {
 
         report_ota_status(OTA_STATUS_UPGRADING_FIRMWARE, NULL);
         ESP_LOGI(TAG, "Force-updating firmware from %s", firmware_url);
-        esp_err_t ret = perform_https_ota_from_url(firmware_url);
+        esp_err_t ret = g_force_url[0] ? perform_https_ota_from_url(firmware_url)
+                                       : perform_firmware_ota(root, firmware_url);
         if (ret == ESP_OK) {
             ESP_LOGI(TAG, "Forced OTA successful; saving info and rebooting");
             time_t now_ts = time(NULL);
@@ -700,7 +716,7 @@ static bool parse_manifest_and_check_update(char *manifest_data) {
             // Perform the OTA update
             ESP_LOGI(TAG, "Starting firmware update from %s", firmware_url);
 
-            esp_err_t ret = perform_https_ota_from_url(firmware_url);
+            esp_err_t ret = perform_firmware_ota(root, firmware_url);
             if (ret == ESP_OK) {
                 ESP_LOGI(TAG, "OTA update successful! Saving update info and rebooting...");
 
@@ -977,27 +993,180 @@ static esp_err_t http_event_handler(esp_http_client_event_t *evt) {
     return ESP_OK;
 }
 
-static esp_err_t perform_https_ota_from_url(const char* firmware_url) {
+// The partition is erased up front by esp_ota_begin(), so these are page programs only. The inflater
+// hands over up to its whole window at once; split that so each piece fits one LED frame gap.
+static esp_err_t ota_partition_sink(void* ctx, const uint8_t* data, size_t len) {
+    while (len > 0) {
+        const size_t n = len < FLASH_WINDOW_WRITE_PIECE ? len : FLASH_WINDOW_WRITE_PIECE;
+        esp_err_t err;
+        {
+            flash_window::Scope flash;
+            err = esp_ota_write(*(esp_ota_handle_t*)ctx, data, n);
+        }
+        if (err != ESP_OK) return err;
+        data += n;
+        len -= n;
+    }
+    return ESP_OK;
+}
+
+// Download an image straight into the next OTA partition through ota_inflate: inflated on the fly when
+// compressed (zlib), passed through otherwise. The HTTP reads run outside any flash window; only the
+// partition writes in ota_partition_sink wait for a frame gap. expected_sha (NULL to skip the hash)
+// and image_size (0 if unknown) are those of the image as written, and are checked before the partition is
+// made bootable; esp_ota_end() validates the image either way.
+static esp_err_t stream_ota_from_url(const char* url, bool compressed, const uint8_t* expected_sha,
+                                     size_t image_size) {
+    const esp_partition_t* part = esp_ota_get_next_update_partition(NULL);
+    if (!part) {
+        ESP_LOGE(TAG, "No OTA partition available");
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (image_size > part->size) {
+        ESP_LOGE(TAG, "Image (%u bytes) does not fit partition %s (%u bytes)", (unsigned)image_size, part->label,
+                 (unsigned)part->size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
     esp_http_client_config_t config = {};
-    config.url = firmware_url;
+    config.url = url;
     config.crt_bundle_attach = esp_crt_bundle_attach;
     config.skip_cert_common_name_check = false;
     config.buffer_size = 1024;      // reduce RX buffer to save internal RAM
     config.buffer_size_tx = 512;    // reduce TX buffer
-    config.keep_alive_enable = false; // ensure server closes promptly
-    config.timeout_ms = 30000; // 30 second timeout for firmware download
-
-    esp_https_ota_config_t ota_config = {};
-    ota_config.http_config = &config;
-    ota_config.bulk_flash_erase = true;
-    // Add init callback to tweak headers before transfer
-    ota_config.http_client_init_cb = [](esp_http_client_handle_t client) -> esp_err_t {
-        esp_http_client_set_header(client, "User-Agent", "roomsensor-ota/1.0");
-        esp_http_client_set_header(client, "Connection", "close");
-        return ESP_OK;
-    };
+    config.keep_alive_enable = false;
+    config.timeout_ms = 30000;
+
+    esp_http_client_handle_t client = esp_http_client_init(&config);
+    if (!client) return ESP_FAIL;
+    esp_http_client_set_header(client, "User-Agent", "roomsensor-ota/1.0");
+    esp_http_client_set_header(client, "Connection", "close");
+    esp_http_client_set_header(client, "Accept-Encoding", "identity");
+    esp_err_t err = esp_http_client_open(client, 0);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open image URL: %s", esp_err_to_name(err));
+        esp_http_client_cleanup(client);
+        return err;
+    }
+    esp_http_client_fetch_headers(client);
+    int status = esp_http_client_get_status_code(client);
+    long long content_length = esp_http_client_get_content_length(client);
+    if (status < 200 || status >= 300) {
+        ESP_LOGE(TAG, "Unexpected HTTP status for image: %d", status);
+        esp_http_client_close(client);
+        esp_http_client_cleanup(client);
+        return ESP_FAIL;
+    }
+    // A plain image is the body itself
+    if (!compressed && image_size == 0 && content_length > 0) {
+        if ((unsigned long long)content_length > part->size) {
+            ESP_LOGE(TAG, "Image (%lld bytes) does not fit partition %s (%u bytes)", content_length, part->label,
+                     (unsigned)part->size);
+            esp_http_client_close(client);
+            esp_http_client_cleanup(client);
+            return ESP_ERR_INVALID_SIZE;
+        }
+        image_size = (size_t)content_length;
+    }
+
+    // Erase only what the image needs when its size is known; seconds either way, so the LED loop pauses
+    esp_ota_handle_t handle = 0;
+    {
+        flash_window::Pause pause;
+        err = esp_ota_begin(part, image_size > 0 ? image_size : OTA_SIZE_UNKNOWN, &handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_begin failed: %s", esp_err_to_name(err));
+        esp_http_client_close(client);
+        esp_http_client_cleanup(client);
+        return err;
+    }
+    ota_inflate_t* inflater = ota_inflate_create(compressed, ota_partition_sink, &handle);
+    if (!inflater) {
+        esp_ota_abort(handle);
+        esp_http_client_close(client);
+        esp_http_client_cleanup(client);
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint8_t buf[2048];
+    size_t read_total = 0;
+    while (err == ESP_OK) {
+        link_manager_hold_busy(2000);
+        int r = esp_http_client_read(client, (char*)buf, sizeof(buf));
+        if (r < 0) {
+            ESP_LOGE(TAG, "Error reading image: %d", r);
+            err = ESP_FAIL;
+            break;
+        }
+        if (r == 0) break; // connection closed
+        read_total += (size_t)r;
+        err = ota_inflate_feed(inflater, buf, (size_t)r);
+    }
+    esp_http_client_close(client);
+    esp_http_client_cleanup(client);
+
+    uint8_t actual_sha[32];
+    size_t written = 0;
+    if (err == ESP_OK) err = ota_inflate_finish(inflater, actual_sha, &written);
+    ota_inflate_destroy(inflater);
+    if (err == ESP_OK && image_size > 0 && written != image_size) {
+        ESP_LOGE(TAG, "Image is %u bytes, expected %u", (unsigned)written, (unsigned)image_size);
+        err = ESP_ERR_INVALID_SIZE;
+    }
+    if (err == ESP_OK && expected_sha && memcmp(actual_sha, expected_sha, 32) != 0) {
+        ESP_LOGE(TAG, "Image SHA-256 does not match manifest");
+        err = ESP_ERR_INVALID_CRC;
+    }
+    if (err != ESP_OK) {
+        esp_ota_abort(handle);
+        return err;
+    }
+
+    ESP_LOGI(TAG, "%s OTA: %u bytes downloaded (content_length=%lld), %u bytes written",
+             compressed ? "Compressed" : "Plain", (unsigned)read_total, content_length, (unsigned)written);
+    flash_window::Pause pause; // otadata sector erase in set_boot_partition()
+    err = esp_ota_end(handle); // validates the image
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_end failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    return esp_ota_set_boot_partition(part);
+}
+
+// The plain image at firmware_url; esp_ota_end() validates it
+static esp_err_t perform_https_ota_from_url(const char* firmware_url) {
+    return stream_ota_from_url(firmware_url, false, NULL, 0);
+}
+
+// Download a zlib-compressed image and inflate it straight into the next OTA partition.
+// The SHA-256 of the inflated image must match the manifest before the partition is made bootable.
+static esp_err_t perform_compressed_ota_from_url(const char* url, const char* sha256_hex, size_t image_size) {
+    uint8_t expected_sha[32];
+    if (!ota_parse_sha256_hex(sha256_hex, expected_sha)) {
+        ESP_LOGE(TAG, "Manifest sha256 missing or malformed");
+        return ESP_ERR_INVALID_ARG;
+    }
+    return stream_ota_from_url(url, true, expected_sha, image_size);
+}
 
-    return esp_https_ota(&ota_config);
+// Update from the manifest's firmware entry. If the manifest offers a compressed image
+// ("compression": "zlib" with "compressed_url", "sha256" and "size") that is downloaded and inflated on the
+// fly; otherwise, or if the compressed transfer fails, the plain image at firmware_url is used.
+static esp_err_t perform_firmware_ota(const cJSON* manifest, const char* firmware_url) {
+    const cJSON* compression = manifest ? cJSON_GetObjectItem(manifest, "compression") : NULL;
+    const cJSON* compressed_url = manifest ? cJSON_GetObjectItem(manifest, "compressed_url") : NULL;
+    const cJSON* sha256 = manifest ? cJSON_GetObjectItem(manifest, "sha256") : NULL;
+    const cJSON* size = manifest ? cJSON_GetObjectItem(manifest, "size") : NULL;
+    if (cJSON_IsString(compression) && strcmp(compression->valuestring, "zlib") == 0 &&
+        cJSON_IsString(compressed_url) && cJSON_IsString(sha256)) {
+        size_t image_size = cJSON_IsNumber(size) && size->valuedouble > 0 ? (size_t)size->valuedouble : 0;
+        ESP_LOGI(TAG, "Starting compressed firmware update from %s", compressed_url->valuestring);
+        esp_err_t ret = perform_compressed_ota_from_url(compressed_url->valuestring, sha256->valuestring, image_size);
+        if (ret == ESP_OK) return ESP_OK;
+        ESP_LOGW(TAG, "Compressed OTA failed (%s); falling back to uncompressed image", esp_err_to_name(ret));
+    }
+    return perform_https_ota_from_url(firmware_url);
 }
 
 extern "C" esp_err_t ota_force_update(const char* version_hash) {
@@ -1134,7 +1303,7 @@ static void ota_update_task(void *pvParameter) {
                         using namespace config;
                         auto& cfg = GetConfigurationManager();
                         if (cfg.wifi().has_channel()) {
-                            const std::string& ch = cfg.wifi().channel();
+                            const auto& ch = cfg.wifi().channel();
                             if (!ch.empty()) {
                                 // manifest-<channel>.json
                                 snprintf(url_buf, sizeof(url_buf), "https://updates.gaia.bio/manifest-%s.json", ch.c_str());
@@ -1379,7 +1548,7 @@ static void report_ota_status(ota_status_t status, const char* error_message) {
         ConfigurationManager& cfg = GetConfigurationManager();
         const char* ch = "prod";
         if (cfg.wifi().has_channel()) {
-            const std::string& s = cfg.wifi().channel();
+            const auto& s = cfg.wifi().channel();
             if (!s.empty()) ch = s.c_str();
         }
         cJSON_AddStringToObject(ota_json, "channel", ch);
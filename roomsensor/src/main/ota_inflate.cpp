@@ -0,0 +1,129 @@
+#include "ota_inflate.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "miniz.h"
+#include "mbedtls/sha256.h"
+#include <string.h>
+#include <stdlib.h>
+
+static const char* TAG = "ota_inflate";
+
+struct ota_inflate {
+    bool compressed;
+    bool done;
+    ota_inflate_sink_t sink;
+    void* sink_ctx;
+    size_t out_total;
+    mbedtls_sha256_context sha;
+    // Compressed mode only
+    tinfl_decompressor* decomp;
+    uint8_t* window;     // TINFL_LZ_DICT_SIZE circular output window
+    size_t window_ofs;
+};
+
+// Large buffers prefer PSRAM; the download runs alongside TLS, which needs the internal heap
+static void* alloc_prefer_spiram(size_t n) {
+    void* p = heap_caps_malloc(n, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!p) p = heap_caps_malloc(n, MALLOC_CAP_8BIT);
+    return p;
+}
+
+static esp_err_t emit(ota_inflate_t* s, const uint8_t* data, size_t len) {
+    if (len == 0) return ESP_OK;
+    mbedtls_sha256_update(&s->sha, data, len);
+    s->out_total += len;
+    return s->sink(s->sink_ctx, data, len);
+}
+
+ota_inflate_t* ota_inflate_create(bool compressed, ota_inflate_sink_t sink, void* sink_ctx) {
+    if (!sink) return NULL;
+    ota_inflate_t* s = (ota_inflate_t*)calloc(1, sizeof(ota_inflate_t));
+    if (!s) return NULL;
+    s->compressed = compressed;
+    s->sink = sink;
+    s->sink_ctx = sink_ctx;
+    mbedtls_sha256_init(&s->sha);
+    mbedtls_sha256_starts(&s->sha, 0);
+    if (compressed) {
+        s->decomp = (tinfl_decompressor*)alloc_prefer_spiram(sizeof(tinfl_decompressor));
+        s->window = (uint8_t*)alloc_prefer_spiram(TINFL_LZ_DICT_SIZE);
+        if (!s->decomp || !s->window) {
+            ESP_LOGE(TAG, "Failed to allocate %u byte inflate window", (unsigned)TINFL_LZ_DICT_SIZE);
+            ota_inflate_destroy(s);
+            return NULL;
+        }
+        tinfl_init(s->decomp);
+    }
+    return s;
+}
+
+esp_err_t ota_inflate_feed(ota_inflate_t* s, const uint8_t* data, size_t len) {
+    if (!s || (!data && len)) return ESP_ERR_INVALID_ARG;
+    if (!s->compressed) return emit(s, data, len);
+    if (s->done) {
+        // Trailing bytes after the zlib stream are not part of the image
+        if (len) ESP_LOGW(TAG, "Ignoring %u bytes after end of compressed stream", (unsigned)len);
+        return ESP_OK;
+    }
+
+    while (true) {
+        size_t in_bytes = len;
+        size_t out_bytes = TINFL_LZ_DICT_SIZE - s->window_ofs;
+        tinfl_status status = tinfl_decompress(s->decomp, data, &in_bytes, s->window, s->window + s->window_ofs,
+                                               &out_bytes, TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_HAS_MORE_INPUT);
+        data += in_bytes;
+        len -= in_bytes;
+        esp_err_t err = emit(s, s->window + s->window_ofs, out_bytes);
+        if (err != ESP_OK) return err;
+        s->window_ofs = (s->window_ofs + out_bytes) & (TINFL_LZ_DICT_SIZE - 1);
+
+        if (status < TINFL_STATUS_DONE) {
+            ESP_LOGE(TAG, "Corrupt compressed stream (status=%d) after %u output bytes", (int)status,
+                     (unsigned)s->out_total);
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        if (status == TINFL_STATUS_DONE) {
+            s->done = true;
+            return ESP_OK;
+        }
+        // NEEDS_MORE_INPUT: wait for the next chunk; HAS_MORE_OUTPUT: window flushed, keep going
+        if (status == TINFL_STATUS_NEEDS_MORE_INPUT && len == 0) return ESP_OK;
+    }
+}
+
+esp_err_t ota_inflate_finish(ota_inflate_t* s, uint8_t sha256_out[32], size_t* size_out) {
+    if (!s) return ESP_ERR_INVALID_ARG;
+    if (s->compressed && !s->done) {
+        ESP_LOGE(TAG, "Compressed stream ended early after %u output bytes", (unsigned)s->out_total);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (sha256_out) mbedtls_sha256_finish(&s->sha, sha256_out);
+    if (size_out) *size_out = s->out_total;
+    return ESP_OK;
+}
+
+void ota_inflate_destroy(ota_inflate_t* s) {
+    if (!s) return;
+    mbedtls_sha256_free(&s->sha);
+    heap_caps_free(s->decomp);
+    heap_caps_free(s->window);
+    free(s);
+}
+
+bool ota_parse_sha256_hex(const char* hex, uint8_t out[32]) {
+    if (!hex || strlen(hex) != 64) return false;
+    for (int i = 0; i < 32; i++) {
+        uint8_t b = 0;
+        for (int k = 0; k < 2; k++) {
+            char c = hex[i * 2 + k];
+            uint8_t v;
+            if (c >= '0' && c <= '9') v = (uint8_t)(c - '0');
+            else if (c >= 'a' && c <= 'f') v = (uint8_t)(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') v = (uint8_t)(c - 'A' + 10);
+            else return false;
+            b = (uint8_t)((b << 4) | v);
+        }
+        out[i] = b;
+    }
+    return true;
+}
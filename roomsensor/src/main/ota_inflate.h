@@ -0,0 +1,41 @@
+#pragma once
+
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Streaming stage between the HTTP download and the OTA partition writer:
+// - Compressed mode inflates a zlib stream (ROM miniz) through a fixed 32 KB window, so memory stays
+//   bounded regardless of image size. Uncompressed mode passes bytes through.
+// - Hashes the output (the image as it lands in flash) with SHA-256.
+// - Independent of esp_http_client / esp_ota_* so it can be exercised on a host with a file as the sink.
+
+// Receives output in order; a non-ESP_OK return aborts the stream.
+typedef esp_err_t (*ota_inflate_sink_t)(void* ctx, const uint8_t* data, size_t len);
+
+typedef struct ota_inflate ota_inflate_t;
+
+// Returns NULL if the window/decompressor cannot be allocated.
+ota_inflate_t* ota_inflate_create(bool compressed, ota_inflate_sink_t sink, void* sink_ctx);
+
+// Feed the next chunk of downloaded bytes. Returns ESP_ERR_INVALID_RESPONSE on corrupt input, or the
+// sink's error.
+esp_err_t ota_inflate_feed(ota_inflate_t* s, const uint8_t* data, size_t len);
+
+// Call once the download ended. Fails with ESP_ERR_INVALID_SIZE if a compressed stream is truncated.
+// On success reports the SHA-256 and size of the output.
+esp_err_t ota_inflate_finish(ota_inflate_t* s, uint8_t sha256_out[32], size_t* size_out);
+
+void ota_inflate_destroy(ota_inflate_t* s);
+
+// Parse 64 hex characters into a 32-byte digest.
+bool ota_parse_sha256_hex(const char* hex, uint8_t out[32]);
+
+#ifdef __cplusplus
+}
+#endif
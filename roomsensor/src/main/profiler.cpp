@@ -0,0 +1,438 @@
+#include "profiler.h"
+#include "cJSON.h"
+#include "driver/gptimer.h"
+#include "esp_attr.h"
+#include "esp_debug_helpers.h"
+#include "esp_heap_caps.h"
+#include "esp_ipc.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "xtensa_context.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+static const char* TAG = "profiler";
+
+// Open-addressed PC table; power of two. 2048 distinct PCs cover the hot code of a minute-long run.
+static constexpr uint32_t kTableSize = 2048;
+// Distinct tasks named in a capture; the last slot collects the rest as "[other]"
+static constexpr uint32_t kMaxTasks = 48;
+static constexpr uint8_t kIsrTask = 0xff;
+
+struct PcCount {
+    uint32_t pc;
+    uint32_t count;
+};
+
+// One capture sample: pcs[0] is the interrupted PC, then return addresses outward
+struct StackSample {
+    uint32_t pcs[PROFILER_MAX_DEPTH];
+    uint8_t depth;
+    uint8_t core;
+    uint8_t task;
+    uint8_t pad;
+};
+
+struct TaskName {
+    TaskHandle_t handle;
+    char name[configMAX_TASK_NAME_LEN];
+};
+
+enum class Mode : uint8_t { Hot, Capture };
+
+// Claimed by a hot run, a capture or an export
+static std::atomic<bool> s_running{false};
+static Mode s_mode = Mode::Hot;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static gptimer_handle_t s_timers[portNUM_PROCESSORS] = {};
+static profiler_hot_summary_t s_summary;
+
+// Hot run
+static PcCount* s_table = nullptr; // internal RAM
+
+// Capture
+static StackSample* s_ring = nullptr; // PSRAM
+static uint32_t s_ring_cap = 0;
+static uint32_t s_ring_count = 0;
+static TaskName s_tasks[kMaxTasks];
+static uint32_t s_task_count = 0;
+static profiler_capture_state_t s_capture_state = PROFILER_CAPTURE_NONE;
+static uint32_t s_capture_rate_hz = 0;
+static uint32_t s_capture_duration_ms = 0;
+static uint64_t s_capture_start_us = 0;
+static uint64_t s_capture_end_us = 0;
+static esp_timer_handle_t s_stop_timer = nullptr;
+
+// Interrupt nesting depth per core, kept by the Xtensa port in _frxt_int_enter/_frxt_int_exit; port.c defines
+// it but the public headers do not declare it
+extern "C" volatile unsigned port_interruptNesting[portNUM_PROCESSORS];
+
+static inline bool in_range(uint32_t pc, uint32_t lo, uint32_t hi) { return pc >= lo && pc < hi; }
+
+// Windowed ABI: the top two bits of a return address hold the caller's window increment. Map it back
+// into the instruction address space and step back to the call instruction.
+static inline uint32_t IRAM_ATTR call_site(uint32_t ra) {
+    if (ra & 0x80000000) ra = (ra & 0x3fffffff) | 0x40000000;
+    return ra - 3;
+}
+
+static inline void IRAM_ATTR classify(uint32_t pc) {
+    if (in_range(pc, 0x40370000, 0x403E0000)) s_summary.iram++;
+    else if (in_range(pc, 0x42000000, 0x44000000)) s_summary.flash++;
+    else if (in_range(pc, 0x40000000, 0x40060000)) s_summary.rom++;
+    else s_summary.other++;
+}
+
+static void IRAM_ATTR count_pc(uint32_t pc) {
+    uint32_t slot = ((pc >> 1) * 2654435761u) & (kTableSize - 1);
+    for (uint32_t probe = 0; probe < kTableSize; ++probe) {
+        PcCount& e = s_table[(slot + probe) & (kTableSize - 1)];
+        if (e.pc == pc) {
+            e.count++;
+            return;
+        }
+        if (e.pc == 0) {
+            e.pc = pc;
+            e.count = 1;
+            return;
+        }
+    }
+    s_summary.dropped++;
+}
+
+static uint8_t IRAM_ATTR task_slot(TaskHandle_t task) {
+    for (uint32_t i = 0; i < s_task_count; ++i) {
+        if (s_tasks[i].handle == task) return static_cast<uint8_t>(i);
+    }
+    if (s_task_count == kMaxTasks - 1) return kMaxTasks - 1;
+    TaskName& t = s_tasks[s_task_count];
+    t.handle = task;
+    // Copied now: the task may be gone by the time the capture is exported
+    strncpy(t.name, pcTaskGetName(task), sizeof(t.name) - 1);
+    t.name[sizeof(t.name) - 1] = '\0';
+    return static_cast<uint8_t>(s_task_count++);
+}
+
+// The ring keeps the first s_ring_cap samples; it is sized for the whole run, so overflow only happens
+// when the timer runs late and catches up
+static void IRAM_ATTR record_stack(const XtExcFrame* frame, TaskHandle_t task, int core) {
+    if (s_ring_count == s_ring_cap) {
+        s_summary.dropped++;
+        return;
+    }
+    StackSample& s = s_ring[s_ring_count++];
+    s.core = static_cast<uint8_t>(core);
+    if (!frame) {
+        s.task = kIsrTask;
+        s.depth = 0;
+        return;
+    }
+    s.task = task_slot(task);
+    s.pcs[0] = frame->pc;
+    uint8_t depth = 1;
+    // The port spills the register windows of the interrupted task when saving its context, so the
+    // caller chain is on the stack. get_next_frame() stops at an implausible SP or PC.
+    esp_backtrace_frame_t bt = {};
+    bt.pc = frame->pc;
+    bt.sp = frame->a1;
+    bt.next_pc = frame->a0;
+    bt.exc_frame = frame;
+    while (depth < PROFILER_MAX_DEPTH && bt.next_pc != 0) {
+        if (!esp_backtrace_get_next_frame(&bt)) break;
+        s.pcs[depth++] = call_site(bt.pc);
+    }
+    s.depth = depth;
+}
+
+// Interrupted context: outside a nested interrupt, the port has just saved the task's registers as an
+// exception frame on its stack and stored that stack pointer in pxTopOfStack, the first TCB field.
+// This ISR is nesting level 1, so only a deeper level means another ISR was interrupted.
+// (xPortInterruptedFromISRContext() tests the same counter for != 0, which is always true in here.)
+static bool IRAM_ATTR on_sample(gptimer_handle_t, const gptimer_alarm_event_data_t*, void*) {
+    const int core = xPortGetCoreID();
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    portENTER_CRITICAL_ISR(&s_lock);
+    s_summary.samples++;
+    const bool nested = port_interruptNesting[core] > 1 || !task;
+    const XtExcFrame* frame = nested ? nullptr : *reinterpret_cast<XtExcFrame* const*>(task);
+    if (nested) s_summary.isr++;
+    else if (task == xTaskGetIdleTaskHandleForCore(core)) s_summary.idle++;
+    else classify(frame->pc);
+
+    if (s_mode == Mode::Capture) {
+        if (s_ring) record_stack(frame, task, core);
+    } else if (s_table && frame && task != xTaskGetIdleTaskHandleForCore(core)) {
+        count_pc(frame->pc);
+    }
+    portEXIT_CRITICAL_ISR(&s_lock);
+    return false;
+}
+
+struct TimerSetup {
+    uint32_t rate_hz;
+    gptimer_handle_t timer;
+    esp_err_t err;
+};
+
+// Runs on the target core (esp_ipc): the timer interrupt is allocated on the core that registers it
+static void start_timer_on_core(void* arg) {
+    TimerSetup* setup = static_cast<TimerSetup*>(arg);
+    gptimer_config_t cfg = {};
+    cfg.clk_src = GPTIMER_CLK_SRC_DEFAULT;
+    cfg.direction = GPTIMER_COUNT_UP;
+    cfg.resolution_hz = 1000000;
+    gptimer_handle_t timer = nullptr;
+    esp_err_t err = gptimer_new_timer(&cfg, &timer);
+    if (err == ESP_OK) {
+        gptimer_event_callbacks_t cbs = {};
+        cbs.on_alarm = on_sample;
+        err = gptimer_register_event_callbacks(timer, &cbs, nullptr);
+    }
+    if (err == ESP_OK) {
+        gptimer_alarm_config_t alarm = {};
+        alarm.alarm_count = 1000000 / setup->rate_hz;
+        alarm.reload_count = 0;
+        alarm.flags.auto_reload_on_alarm = true;
+        err = gptimer_set_alarm_action(timer, &alarm);
+    }
+    if (err == ESP_OK) err = gptimer_enable(timer);
+    if (err == ESP_OK) err = gptimer_start(timer);
+    if (err != ESP_OK && timer) {
+        gptimer_disable(timer);
+        gptimer_del_timer(timer);
+        timer = nullptr;
+    }
+    setup->timer = timer;
+    setup->err = err;
+}
+
+static esp_err_t start_timers(uint32_t rate_hz) {
+    esp_err_t err = ESP_OK;
+    for (int core = 0; core < portNUM_PROCESSORS && err == ESP_OK; ++core) {
+        TimerSetup setup = {rate_hz, nullptr, ESP_FAIL};
+        err = esp_ipc_call_blocking(core, start_timer_on_core, &setup);
+        if (err == ESP_OK) err = setup.err;
+        s_timers[core] = setup.timer;
+    }
+    return err;
+}
+
+static void stop_timers() {
+    for (auto& timer : s_timers) {
+        if (!timer) continue;
+        gptimer_stop(timer);
+        gptimer_disable(timer);
+        gptimer_del_timer(timer);
+        timer = nullptr;
+    }
+}
+
+esp_err_t profiler_hot_run(uint32_t duration_ms, uint32_t rate_hz, size_t top_n, FILE* out,
+                           profiler_hot_summary_t* summary) {
+    if (rate_hz == 0) rate_hz = PROFILER_DEFAULT_RATE_HZ;
+    if (rate_hz > 10000 || duration_ms == 0) return ESP_ERR_INVALID_ARG;
+    if (s_running.exchange(true)) return ESP_ERR_INVALID_STATE;
+
+    PcCount* table = static_cast<PcCount*>(
+        heap_caps_calloc(kTableSize, sizeof(PcCount), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    if (!table) {
+        s_running.store(false);
+        return ESP_ERR_NO_MEM;
+    }
+    portENTER_CRITICAL(&s_lock);
+    memset(&s_summary, 0, sizeof(s_summary));
+    s_mode = Mode::Hot;
+    s_table = table;
+    portEXIT_CRITICAL(&s_lock);
+
+    esp_err_t err = start_timers(rate_hz);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Sampling PCs at %u Hz on %d cores for %u ms", (unsigned)rate_hz, portNUM_PROCESSORS,
+                 (unsigned)duration_ms);
+        vTaskDelay(pdMS_TO_TICKS(duration_ms));
+    } else {
+        ESP_LOGE(TAG, "Failed to start sample timers: %s", esp_err_to_name(err));
+    }
+    stop_timers();
+
+    portENTER_CRITICAL(&s_lock);
+    s_table = nullptr;
+    const profiler_hot_summary_t sum = s_summary;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (err == ESP_OK) {
+        std::vector<PcCount> hot;
+        for (uint32_t i = 0; i < kTableSize; ++i) {
+            if (table[i].pc) hot.push_back(table[i]);
+        }
+        const size_t n = std::min(top_n, hot.size());
+        std::partial_sort(hot.begin(), hot.begin() + n, hot.end(),
+                          [](const PcCount& a, const PcCount& b) { return a.count > b.count; });
+        if (out) {
+            fprintf(out, "# hot samples=%u idle=%u isr=%u dropped=%u iram=%u flash=%u rom=%u other=%u rate_hz=%u\n",
+                    (unsigned)sum.samples, (unsigned)sum.idle, (unsigned)sum.isr, (unsigned)sum.dropped,
+                    (unsigned)sum.iram, (unsigned)sum.flash, (unsigned)sum.rom, (unsigned)sum.other, (unsigned)rate_hz);
+            for (size_t i = 0; i < n; ++i) fprintf(out, "0x%08x %u\n", (unsigned)hot[i].pc, (unsigned)hot[i].count);
+        }
+        if (summary) *summary = sum;
+    }
+    heap_caps_free(table);
+    s_running.store(false);
+    return err;
+}
+
+// esp_timer task: the requested duration is over
+static void capture_stop(void*) {
+    stop_timers();
+    portENTER_CRITICAL(&s_lock);
+    s_capture_state = PROFILER_CAPTURE_DONE;
+    s_capture_end_us = esp_timer_get_time();
+    const uint32_t stored = s_ring_count;
+    const uint32_t dropped = s_summary.dropped;
+    portEXIT_CRITICAL(&s_lock);
+    ESP_LOGI(TAG, "Capture done: %u stacks (%u dropped)", (unsigned)stored, (unsigned)dropped);
+    s_running.store(false);
+}
+
+esp_err_t profiler_capture_start(uint32_t duration_ms, uint32_t rate_hz) {
+    if (rate_hz == 0) rate_hz = PROFILER_CAPTURE_DEFAULT_RATE_HZ;
+    if (rate_hz > PROFILER_CAPTURE_MAX_RATE_HZ || duration_ms == 0 ||
+        duration_ms > PROFILER_CAPTURE_MAX_SECONDS * 1000u ||
+        static_cast<uint64_t>(duration_ms) * rate_hz / 1000 > PROFILER_CAPTURE_MAX_SAMPLES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_running.exchange(true)) return ESP_ERR_INVALID_STATE;
+
+    if (!s_stop_timer) {
+        esp_timer_create_args_t args = {};
+        args.callback = capture_stop;
+        args.name = "prof_stop";
+        esp_err_t err = esp_timer_create(&args, &s_stop_timer);
+        if (err != ESP_OK) {
+            s_running.store(false);
+            return err;
+        }
+    }
+
+    // Previous capture goes now; size the ring for the whole run plus timer jitter
+    heap_caps_free(s_ring);
+    s_ring = nullptr;
+    const uint32_t cap = static_cast<uint32_t>(
+        (static_cast<uint64_t>(duration_ms) * rate_hz / 1000 + 16) * portNUM_PROCESSORS);
+    StackSample* ring = static_cast<StackSample*>(heap_caps_malloc(cap * sizeof(StackSample), MALLOC_CAP_SPIRAM));
+    if (!ring) {
+        s_capture_state = PROFILER_CAPTURE_NONE;
+        s_running.store(false);
+        return ESP_ERR_NO_MEM;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    memset(&s_summary, 0, sizeof(s_summary));
+    s_mode = Mode::Capture;
+    s_ring = ring;
+    s_ring_cap = cap;
+    s_ring_count = 0;
+    s_task_count = 0;
+    strcpy(s_tasks[kMaxTasks - 1].name, "[other]");
+    s_capture_state = PROFILER_CAPTURE_RUNNING;
+    s_capture_rate_hz = rate_hz;
+    s_capture_duration_ms = duration_ms;
+    s_capture_start_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&s_lock);
+
+    esp_err_t err = start_timers(rate_hz);
+    if (err == ESP_OK) err = esp_timer_start_once(s_stop_timer, static_cast<uint64_t>(duration_ms) * 1000);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start capture: %s", esp_err_to_name(err));
+        stop_timers();
+        portENTER_CRITICAL(&s_lock);
+        s_ring = nullptr;
+        s_capture_state = PROFILER_CAPTURE_NONE;
+        portEXIT_CRITICAL(&s_lock);
+        heap_caps_free(ring);
+        s_running.store(false);
+        return err;
+    }
+    ESP_LOGI(TAG, "Capturing stacks at %u Hz on %d cores for %u ms (%u KB ring)", (unsigned)rate_hz,
+             portNUM_PROCESSORS, (unsigned)duration_ms, (unsigned)(cap * sizeof(StackSample) / 1024));
+    return ESP_OK;
+}
+
+void profiler_capture_status(profiler_capture_status_t* out) {
+    if (!out) return;
+    portENTER_CRITICAL(&s_lock);
+    out->state = s_capture_state;
+    out->rate_hz = s_capture_rate_hz;
+    out->duration_ms = s_capture_duration_ms;
+    const uint64_t end = s_capture_state == PROFILER_CAPTURE_RUNNING ? esp_timer_get_time() : s_capture_end_us;
+    out->elapsed_ms = s_capture_state == PROFILER_CAPTURE_NONE ? 0
+                                                               : static_cast<uint32_t>((end - s_capture_start_us) / 1000);
+    out->stored = s_ring_count;
+    out->summary = s_mode == Mode::Capture ? s_summary : profiler_hot_summary_t{};
+    portEXIT_CRITICAL(&s_lock);
+}
+
+cJSON* profiler_capture_status_json(void) {
+    profiler_capture_status_t st;
+    profiler_capture_status(&st);
+    static const char* const kStates[] = {"none", "running", "done"};
+    cJSON* root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "state", kStates[st.state]);
+    cJSON_AddNumberToObject(root, "rate_hz", st.rate_hz);
+    cJSON_AddNumberToObject(root, "duration_ms", st.duration_ms);
+    cJSON_AddNumberToObject(root, "elapsed_ms", st.elapsed_ms);
+    cJSON_AddNumberToObject(root, "stacks", st.stored);
+    cJSON_AddNumberToObject(root, "samples", st.summary.samples);
+    cJSON_AddNumberToObject(root, "idle", st.summary.idle);
+    cJSON_AddNumberToObject(root, "isr", st.summary.isr);
+    cJSON_AddNumberToObject(root, "dropped", st.summary.dropped);
+    cJSON_AddNumberToObject(root, "flash", st.summary.flash);
+    cJSON_AddNumberToObject(root, "iram", st.summary.iram);
+    cJSON_AddStringToObject(root, "download", "/profile/collapsed");
+    return root;
+}
+
+static bool stack_less(const StackSample& a, const StackSample& b) {
+    if (a.task != b.task) return a.task < b.task;
+    if (a.depth != b.depth) return a.depth < b.depth;
+    return memcmp(a.pcs, b.pcs, a.depth * sizeof(uint32_t)) < 0;
+}
+
+static bool stack_equal(const StackSample& a, const StackSample& b) {
+    return a.task == b.task && a.depth == b.depth && memcmp(a.pcs, b.pcs, a.depth * sizeof(uint32_t)) == 0;
+}
+
+esp_err_t profiler_capture_export(profiler_line_cb_t line, void* ctx) {
+    if (!line) return ESP_ERR_INVALID_ARG;
+    if (s_running.exchange(true)) return ESP_ERR_INVALID_STATE;
+    if (s_capture_state != PROFILER_CAPTURE_DONE || !s_ring) {
+        s_running.store(false);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Identical stacks become adjacent; sample order does not matter for collapsed output. Sorting in
+    // place also makes a repeated export cheap.
+    std::sort(s_ring, s_ring + s_ring_count, stack_less);
+
+    // "task;0x<outermost>;...;0x<leaf> <count>"
+    char buf[configMAX_TASK_NAME_LEN + PROFILER_MAX_DEPTH * 11 + 16];
+    esp_err_t err = ESP_OK;
+    for (uint32_t i = 0; i < s_ring_count && err == ESP_OK;) {
+        const StackSample& s = s_ring[i];
+        uint32_t n = 1;
+        while (i + n < s_ring_count && stack_equal(s, s_ring[i + n])) ++n;
+        int len = snprintf(buf, sizeof(buf), "%s", s.task == kIsrTask ? "[isr]" : s_tasks[s.task].name);
+        for (int d = s.depth - 1; d >= 0; --d) {
+            len += snprintf(buf + len, sizeof(buf) - len, ";0x%08x", (unsigned)s.pcs[d]);
+        }
+        len += snprintf(buf + len, sizeof(buf) - len, " %u", (unsigned)n);
+        if (line(buf, static_cast<size_t>(len), ctx) != 0) err = ESP_FAIL;
+        i += n;
+    }
+    s_running.store(false);
+    return err;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stddef.h>
+
+// Sampling profiler. A hardware timer interrupt on each core looks at the task it interrupted, without
+// instrumenting the code. Two kinds of runs, one at a time:
+// - Hot PCs (profiler_hot_run): counts per program counter in an internal-RAM table. Feeds the placement
+//   generator (util/roomsensor_util/hot_placement.py).
+// - Stack capture (profiler_capture_*): the PC plus a shallow backtrace per sample, kept in a PSRAM ring
+//   and exported as collapsed stacks ("task;outer;...;leaf count"), the input format of flame graph tools.
+//   Addresses stay raw; util/roomsensor_util/flamegraph.py symbolizes them offline with the ELF.
+// Samples landing in another ISR are counted but carry no stack. PCs are classified by memory region: code
+// running from flash goes through the 32 KB instruction cache.
+//
+// Overhead is one short ISR per sample and core, plus a backtrace of up to PROFILER_MAX_DEPTH frames for
+// captures; nothing runs outside a run. Rate and duration are capped so production devices can be
+// profiled remotely (HTTP /profile, MQTT sensor/$mac/device/profile).
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PROFILER_DEFAULT_RATE_HZ 997 // prime: stays out of lockstep with the 1 kHz tick and LED cadence
+#define PROFILER_CAPTURE_DEFAULT_RATE_HZ 199
+#define PROFILER_CAPTURE_MAX_RATE_HZ 1000
+#define PROFILER_CAPTURE_MAX_SECONDS 120
+#define PROFILER_CAPTURE_MAX_SAMPLES 16384 // per core: seconds * rate_hz, 36 bytes each
+#define PROFILER_MAX_DEPTH 8
+
+typedef struct {
+    uint32_t samples;   // all timer interrupts
+    uint32_t idle;      // in an idle task
+    uint32_t isr;       // interrupted another ISR
+    uint32_t dropped;   // PC table or capture ring full
+    uint32_t iram;      // 0x4037_0000..0x403E_0000
+    uint32_t flash;     // cached flash text, 0x4200_0000..0x4400_0000
+    uint32_t rom;       // 0x4000_0000..0x4006_0000
+    uint32_t other;
+} profiler_hot_summary_t;
+
+// Sample both cores at rate_hz for duration_ms (blocking), then write the top_n PCs as
+// "0x<pc> <count>" lines, preceded by a "# hot ..." summary line, to out. The output is the input format
+// of hot_placement.py. ESP_ERR_INVALID_STATE while another run is active.
+esp_err_t profiler_hot_run(uint32_t duration_ms, uint32_t rate_hz, size_t top_n, FILE* out,
+                           profiler_hot_summary_t* summary);
+
+typedef enum {
+    PROFILER_CAPTURE_NONE = 0, // nothing captured since boot
+    PROFILER_CAPTURE_RUNNING,
+    PROFILER_CAPTURE_DONE,     // stacks ready for export
+} profiler_capture_state_t;
+
+typedef struct {
+    profiler_capture_state_t state;
+    uint32_t rate_hz;
+    uint32_t duration_ms;
+    uint32_t elapsed_ms;
+    uint32_t stored;      // stack samples in the ring
+    profiler_hot_summary_t summary;
+} profiler_capture_status_t;
+
+// Start a stack capture in the background; it stops by itself after duration_ms. The PSRAM ring holds
+// duration_ms * rate_hz samples per core (at most PROFILER_CAPTURE_MAX_SAMPLES) and stays allocated until
+// the next capture.
+// ESP_ERR_INVALID_ARG outside the caps, ESP_ERR_INVALID_STATE while any run or export is active.
+esp_err_t profiler_capture_start(uint32_t duration_ms, uint32_t rate_hz);
+
+void profiler_capture_status(profiler_capture_status_t* out);
+
+// Status as JSON for the HTTP and MQTT controls: {"state":"running","rate_hz":199,...}; caller deletes
+struct cJSON;
+struct cJSON* profiler_capture_status_json(void);
+
+// Export a finished capture as collapsed stacks, one line per distinct stack, handed to line() without a
+// trailing newline. A non-zero return from line() aborts the export. ESP_ERR_NOT_FOUND without a
+// finished capture, ESP_ERR_INVALID_STATE while a run is active.
+typedef int (*profiler_line_cb_t)(const char* line, size_t len, void* ctx);
+esp_err_t profiler_capture_export(profiler_line_cb_t line, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,253 @@
+#include "pwm.h"
+#include "pwm_plan.h"
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "driver/ledc.h"
+#include "ConfigurationManager.h"
+#include "PWMConfig.h"
+#include "IOConfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <cmath>
+
+static const char* TAG = "pwm";
+
+static constexpr int kNumOutputs = 4;                 // pwm1..pwm4 => LEDC timer/channel 0..3
+static constexpr TickType_t kPollTicks = pdMS_TO_TICKS(50);
+
+struct PwmOutput {
+    // Hardware setup currently applied; gpio < 0 => output not running
+    int gpio = -1;
+    uint32_t freq_hz = 0;
+    int bits = 0;
+    bool invert = false;
+    // Fade in progress
+    pwm::FadePlan plan;
+    size_t next_segment = 0;
+    bool fading = false;
+    int target_level = -1; // level the current plan ends at
+    // Configuration generation that failed to apply; not retried until the configuration changes
+    uint32_t failed_generation = 0;
+    bool failed = false;
+};
+
+static PwmOutput s_outputs[kNumOutputs];
+static TaskHandle_t s_pwm_task = nullptr;
+
+static config::PWMConfig& pwm_config(int k) {
+    config::ConfigurationManager& mgr = config::GetConfigurationManager();
+    switch (k) {
+        case 0: return mgr.pwm1();
+        case 1: return mgr.pwm2();
+        case 2: return mgr.pwm3();
+        default: return mgr.pwm4();
+    }
+}
+
+static config::IOConfig* io_config(int module) {
+    config::ConfigurationManager& mgr = config::GetConfigurationManager();
+    switch (module) {
+        case 1: return &mgr.io1(); case 2: return &mgr.io2();
+        case 3: return &mgr.io3(); case 4: return &mgr.io4();
+        case 5: return &mgr.io5(); case 6: return &mgr.io6();
+        case 7: return &mgr.io7(); case 8: return &mgr.io8();
+    }
+    return nullptr;
+}
+
+// Level the output should be at: the configured level, gated by the followed switch when set
+static int desired_level(const config::PWMConfig& cfg) {
+    int level = cfg.has_level() ? cfg.level() : (cfg.has_follow() ? 100 : 0);
+    if (cfg.has_follow()) {
+        config::IOConfig* io = io_config(cfg.follow_module());
+        if (io == nullptr || !io->switch_state(cfg.follow_pin())) level = 0;
+    }
+    return level;
+}
+
+// Runs in the LEDC ISR; the task starts the next segment
+static bool IRAM_ATTR pwm_fade_end_cb(const ledc_cb_param_t* param, void* user_arg) {
+    BaseType_t task_woken = pdFALSE;
+    if (param->event == LEDC_FADE_END_EVT && s_pwm_task) {
+        xTaskNotifyFromISR(s_pwm_task, 1u << reinterpret_cast<uintptr_t>(user_arg), eSetBits, &task_woken);
+    }
+    return task_woken == pdTRUE;
+}
+
+static void stop_output(int k) {
+    PwmOutput& out = s_outputs[k];
+    if (out.gpio < 0) return;
+    const ledc_channel_t ch = static_cast<ledc_channel_t>(k);
+    if (out.fading) ledc_fade_stop(LEDC_LOW_SPEED_MODE, ch);
+    ledc_stop(LEDC_LOW_SPEED_MODE, ch, out.invert ? 1 : 0);
+    ESP_LOGI(TAG, "pwm%d stopped (GPIO %d released)", k + 1, out.gpio);
+    out = PwmOutput();
+}
+
+static esp_err_t configure_output(int k, const config::PWMConfig& cfg, int bits, uint32_t duty) {
+    PwmOutput& out = s_outputs[k];
+    const ledc_channel_t ch = static_cast<ledc_channel_t>(k);
+    if (out.fading) ledc_fade_stop(LEDC_LOW_SPEED_MODE, ch);
+
+    ledc_timer_config_t timer_cfg = {};
+    timer_cfg.speed_mode = LEDC_LOW_SPEED_MODE;
+    timer_cfg.duty_resolution = static_cast<ledc_timer_bit_t>(bits);
+    timer_cfg.timer_num = static_cast<ledc_timer_t>(k);
+    timer_cfg.freq_hz = cfg.freq_hz();
+    timer_cfg.clk_cfg = LEDC_AUTO_CLK;
+    esp_err_t err = ledc_timer_config(&timer_cfg);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "pwm%d timer config failed (%lu Hz, %d bits): %s", k + 1,
+                 (unsigned long)cfg.freq_hz(), bits, esp_err_to_name(err));
+        return err;
+    }
+
+    ledc_channel_config_t ch_cfg = {};
+    ch_cfg.gpio_num = cfg.gpio();
+    ch_cfg.speed_mode = LEDC_LOW_SPEED_MODE;
+    ch_cfg.channel = ch;
+    ch_cfg.intr_type = LEDC_INTR_DISABLE;
+    ch_cfg.timer_sel = static_cast<ledc_timer_t>(k);
+    ch_cfg.duty = duty;
+    ch_cfg.hpoint = 0;
+    ch_cfg.flags.output_invert = cfg.active_low() ? 1 : 0;
+    err = ledc_channel_config(&ch_cfg);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "pwm%d channel config failed on GPIO %d: %s", k + 1, cfg.gpio(), esp_err_to_name(err));
+        return err;
+    }
+
+    ledc_cbs_t cbs = {};
+    cbs.fade_cb = pwm_fade_end_cb;
+    err = ledc_cb_register(LEDC_LOW_SPEED_MODE, ch, &cbs, reinterpret_cast<void*>(static_cast<uintptr_t>(k)));
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "pwm%d fade callback registration failed: %s", k + 1, esp_err_to_name(err));
+        return err;
+    }
+
+    if (out.gpio >= 0 && out.gpio != cfg.gpio()) {
+        // Moving to another pin; the old one goes back to a plain GPIO
+        ledc_stop(LEDC_LOW_SPEED_MODE, ch, out.invert ? 1 : 0);
+    }
+    out.gpio = cfg.gpio();
+    out.freq_hz = cfg.freq_hz();
+    out.bits = bits;
+    out.invert = cfg.active_low();
+    out.fading = false;
+    ESP_LOGI(TAG, "pwm%d on GPIO %d: %lu Hz, %d bits%s", k + 1, out.gpio, (unsigned long)out.freq_hz, bits,
+             out.invert ? ", active low" : "");
+    return ESP_OK;
+}
+
+// Start segments until one is running in hardware or the plan is done
+static void run_plan(int k) {
+    PwmOutput& out = s_outputs[k];
+    const ledc_channel_t ch = static_cast<ledc_channel_t>(k);
+    out.fading = false;
+    while (out.next_segment < out.plan.count) {
+        const pwm::FadeSegment& seg = out.plan.segments[out.next_segment++];
+        if (seg.time_ms == 0) {
+            ledc_set_duty_and_update(LEDC_LOW_SPEED_MODE, ch, seg.duty, 0);
+            continue;
+        }
+        esp_err_t err = ledc_set_fade_with_time(LEDC_LOW_SPEED_MODE, ch, seg.duty, static_cast<int>(seg.time_ms));
+        if (err == ESP_OK) err = ledc_fade_start(LEDC_LOW_SPEED_MODE, ch, LEDC_FADE_NO_WAIT);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "pwm%d fade failed: %s; setting duty directly", k + 1, esp_err_to_name(err));
+            ledc_set_duty_and_update(LEDC_LOW_SPEED_MODE, ch, seg.duty, 0);
+            continue;
+        }
+        out.fading = true;
+        return;
+    }
+}
+
+// Level the output shows right now, recovered from the duty so an interrupted fade continues smoothly
+static int current_level(int k, float gamma) {
+    const PwmOutput& out = s_outputs[k];
+    const uint32_t full = (1u << out.bits) - 1;
+    const uint32_t duty = ledc_get_duty(LEDC_LOW_SPEED_MODE, static_cast<ledc_channel_t>(k));
+    if (duty == 0 || full == 0) return 0;
+    if (duty >= full) return 100;
+    return static_cast<int>(std::lround(100.0 * std::pow(static_cast<double>(duty) / full, 1.0 / gamma)));
+}
+
+static void service_output(int k) {
+    config::PWMConfig& cfg = pwm_config(k);
+    PwmOutput& out = s_outputs[k];
+    if (!cfg.has_gpio()) {
+        stop_output(k);
+        return;
+    }
+    if (out.failed && out.failed_generation == cfg.generation()) return;
+
+    const int level = desired_level(cfg);
+    const int bits = pwm::effective_resolution_bits(cfg.freq_hz(), cfg.resolution_bits());
+    if (bits == 0) {
+        ESP_LOGE(TAG, "pwm%d: %lu Hz is out of LEDC range", k + 1, (unsigned long)cfg.freq_hz());
+        stop_output(k);
+        out.failed = true;
+        out.failed_generation = cfg.generation();
+        return;
+    }
+    if (out.gpio != cfg.gpio() || out.freq_hz != cfg.freq_hz() || out.bits != bits || out.invert != cfg.active_low()) {
+        // New hardware setup: jump straight to the target level
+        if (bits != cfg.resolution_bits() && bits != out.bits) {
+            ESP_LOGW(TAG, "pwm%d: %d-bit resolution not possible at %lu Hz, using %d bits", k + 1,
+                     cfg.resolution_bits(), (unsigned long)cfg.freq_hz(), bits);
+        }
+        if (configure_output(k, cfg, bits, pwm::gamma_duty(level, cfg.gamma(), bits)) != ESP_OK) {
+            stop_output(k);
+            out.failed = true;
+            out.failed_generation = cfg.generation();
+            return;
+        }
+        out.target_level = level;
+        out.plan = pwm::FadePlan();
+        out.next_segment = 0;
+        return;
+    }
+
+    if (level == out.target_level) return;
+    const ledc_channel_t ch = static_cast<ledc_channel_t>(k);
+    if (out.fading) ledc_fade_stop(LEDC_LOW_SPEED_MODE, ch);
+    const int from = current_level(k, cfg.gamma());
+    out.plan = pwm::plan_fade(from, level, cfg.gamma(), bits, cfg.fade_ms(), cfg.freq_hz());
+    out.next_segment = 0;
+    out.target_level = level;
+    run_plan(k);
+}
+
+static void pwm_task(void* arg) {
+    (void)arg;
+    for (;;) {
+        uint32_t done = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &done, kPollTicks);
+        for (int k = 0; k < kNumOutputs; ++k) {
+            if (!(done & (1u << k)) || !s_outputs[k].fading) continue;
+            // Ignore a late notification from a fade that was stopped and replaced
+            const PwmOutput& out = s_outputs[k];
+            const uint32_t duty = ledc_get_duty(LEDC_LOW_SPEED_MODE, static_cast<ledc_channel_t>(k));
+            if (duty == out.plan.segments[out.next_segment - 1].duty) run_plan(k);
+        }
+        for (int k = 0; k < kNumOutputs; ++k) {
+            service_output(k);
+        }
+    }
+}
+
+esp_err_t init_pwm(void) {
+    if (s_pwm_task != nullptr) return ESP_OK;
+    // Shared fade service for all channels; fades report back through pwm_fade_end_cb
+    esp_err_t err = ledc_fade_func_install(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "ledc_fade_func_install failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    BaseType_t ok = xTaskCreatePinnedToCore(&pwm_task, "pwm", 3072, nullptr, tskIDLE_PRIORITY + 2, &s_pwm_task, tskNO_AFFINITY);
+    if (ok != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create PWM task");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
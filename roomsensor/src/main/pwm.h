@@ -0,0 +1,17 @@
+#pragma once
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Start the PWM output task for the pwm1..pwm4 configuration modules:
+// - Each configured output gets its own LEDC low-speed timer and channel
+// - Level changes fade in hardware along a gamma curve (see pwm_plan.h)
+// - Outputs with 'follow' track an IO expander switch pin, including local rule overrides
+esp_err_t init_pwm(void);
+
+#ifdef __cplusplus
+}
+#endif
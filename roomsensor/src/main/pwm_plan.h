@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace pwm {
+
+// Planning for the LEDC PWM outputs (pwm.cpp). Pure arithmetic, no driver calls.
+//
+// LEDC fades are linear in duty: the hardware adds 'scale' to the duty every 'cycles' PWM periods. A
+// gamma-corrected fade is therefore split into a few linear segments between gamma-corrected points;
+// the fade-end interrupt of one segment starts the next. Each segment still runs entirely in hardware.
+// The hardware also runs at most 1023 steps per fade (the driver jumps whatever is left at the end), so
+// segments that would need more are split into linear pieces.
+
+constexpr uint32_t kLedcClockHz = 80'000'000;   // APB clock (LEDC_AUTO_CLK picks it on ESP32-S3)
+constexpr int kLedcMaxResolutionBits = 14;      // ESP32-S3
+constexpr uint32_t kLedcMaxClockDivider = 1023; // integer part of the timer divider
+constexpr uint32_t kLedcMaxCyclesPerStep = 1023; // LEDC_DUTY_CYCLE: PWM periods per fade step
+constexpr uint32_t kLedcMaxFadeSteps = 1023;     // LEDC_DUTY_NUM: steps per fade
+constexpr uint32_t kLedcMaxDutyScale = 1023;     // LEDC_DUTY_SCALE: counts per step
+constexpr size_t kMaxGammaPoints = 8;            // for a full 0..100 % fade
+// Gamma points plus the pieces they split into: at most (2^14 - 1) / 1023 + 1 extra for the whole fade
+constexpr size_t kMaxFadeSegments = 32;
+
+// Highest resolution the timer can reach at freq_hz: freq * 2^bits must not exceed the clock
+static inline int max_resolution_bits(uint32_t freq_hz) {
+    if (freq_hz == 0) return 0;
+    int bits = 0;
+    while (bits < kLedcMaxResolutionBits && (static_cast<uint64_t>(freq_hz) << (bits + 1)) <= kLedcClockHz) ++bits;
+    return bits;
+}
+
+// Resolution actually used: the requested one, lowered to what the frequency allows and raised when the
+// divider would overflow at low frequencies. 0 when no resolution works for freq_hz.
+static inline int effective_resolution_bits(uint32_t freq_hz, int requested_bits) {
+    const int hi = max_resolution_bits(freq_hz);
+    if (hi < 1) return 0;
+    int bits = requested_bits < 1 ? 1 : (requested_bits > hi ? hi : requested_bits);
+    while (bits <= hi && kLedcClockHz / (static_cast<uint64_t>(freq_hz) << bits) > kLedcMaxClockDivider) ++bits;
+    return bits <= hi ? bits : 0;
+}
+
+// Gamma-corrected duty for a level in percent. Any level above 0 gets at least one count so dim settings
+// never switch the load off.
+static inline uint32_t gamma_duty(int level_pct, float gamma, int bits) {
+    if (level_pct <= 0 || bits < 1) return 0;
+    const uint32_t full = (1u << bits) - 1;
+    if (level_pct >= 100) return full;
+    const double x = std::pow(level_pct / 100.0, static_cast<double>(gamma));
+    uint32_t duty = static_cast<uint32_t>(std::lround(x * full));
+    if (duty == 0) duty = 1;
+    return duty > full ? full : duty;
+}
+
+// Fade time for a level change; fade_ms is the time for a full 0..100 % change
+static inline uint32_t fade_time_ms(int from_pct, int to_pct, uint32_t fade_ms) {
+    const int delta = from_pct > to_pct ? from_pct - to_pct : to_pct - from_pct;
+    return static_cast<uint32_t>((static_cast<uint64_t>(fade_ms) * delta + 50) / 100);
+}
+
+// Longest time LEDC can spend on a linear fade across 'delta' duty counts at freq_hz
+static inline uint32_t max_linear_fade_ms(uint32_t delta, uint32_t freq_hz) {
+    if (freq_hz == 0) return 0;
+    return static_cast<uint32_t>(static_cast<uint64_t>(delta) * kLedcMaxCyclesPerStep * 1000 / freq_hz);
+}
+
+// Hardware steps ledc_set_fade_with_time asks for to move 'delta' counts in time_ms: one count per step
+// when there are more PWM periods than counts, otherwise delta / periods counts per step
+static inline uint32_t ledc_fade_steps(uint32_t delta, uint32_t time_ms, uint32_t freq_hz) {
+    const uint64_t cycles = static_cast<uint64_t>(time_ms) * freq_hz / 1000;
+    if (delta == 0 || cycles == 0) return 0;
+    if (cycles > delta) return delta;
+    uint32_t scale = static_cast<uint32_t>(delta / cycles);
+    if (scale > kLedcMaxDutyScale) scale = kLedcMaxDutyScale;
+    return delta / scale;
+}
+
+struct FadeSegment {
+    uint32_t duty;    // target duty at the end of the segment
+    uint32_t time_ms; // 0 => set the duty directly
+};
+
+struct FadePlan {
+    FadeSegment segments[kMaxFadeSegments];
+    size_t count = 0;
+};
+
+// Segments for a fade between two levels. The number of gamma points scales with the size of the change
+// (at least one), points are evenly spaced in level and gamma-corrected, and the time is split evenly.
+// Points whose gamma-corrected duties round to the same value hand their time to the next one, each
+// segment's time is clamped to what the hardware can stretch its duty delta over, and a segment needing
+// more than kLedcMaxFadeSteps steps is split into equal pieces that each fit.
+static inline FadePlan plan_fade(int from_pct, int to_pct, float gamma, int bits, uint32_t fade_ms, uint32_t freq_hz) {
+    FadePlan plan;
+    const uint32_t total_ms = fade_time_ms(from_pct, to_pct, fade_ms);
+    const int delta = to_pct - from_pct;
+    const int span = delta < 0 ? -delta : delta;
+    if (span == 0 || total_ms == 0) {
+        plan.segments[0] = {gamma_duty(to_pct, gamma, bits), 0};
+        plan.count = 1;
+        return plan;
+    }
+    size_t n = (gamma == 1.0f) ? 1 : (span * kMaxGammaPoints + 99) / 100;
+    if (n < 1) n = 1;
+    if (n > kMaxGammaPoints) n = kMaxGammaPoints;
+
+    uint32_t prev_duty = gamma_duty(from_pct, gamma, bits);
+    uint32_t carry_ms = 0;
+    for (size_t i = 1; i <= n; ++i) {
+        const int level = from_pct + static_cast<int>(delta * static_cast<int>(i) / static_cast<int>(n));
+        const uint32_t duty = gamma_duty(level, gamma, bits);
+        const uint32_t t = carry_ms + static_cast<uint32_t>(
+            static_cast<uint64_t>(total_ms) * i / n - static_cast<uint64_t>(total_ms) * (i - 1) / n);
+        if (duty == prev_duty && i < n) {
+            carry_ms = t;
+            continue;
+        }
+        carry_ms = 0;
+        const uint32_t d = duty > prev_duty ? duty - prev_duty : prev_duty - duty;
+        const uint32_t limit = max_linear_fade_ms(d, freq_hz);
+        const uint32_t seg_ms = d == 0 ? 0 : (t < limit ? t : limit);
+        size_t pieces = (ledc_fade_steps(d, seg_ms, freq_hz) + kLedcMaxFadeSteps - 1) / kLedcMaxFadeSteps;
+        if (pieces < 1) pieces = 1;
+        if (pieces > kMaxFadeSegments - plan.count) pieces = kMaxFadeSegments - plan.count;
+        for (size_t p = 1; p <= pieces; ++p) {
+            const int64_t step = (static_cast<int64_t>(duty) - prev_duty) * static_cast<int64_t>(p) / static_cast<int64_t>(pieces);
+            const uint32_t piece_ms = static_cast<uint32_t>(static_cast<uint64_t>(seg_ms) * p / pieces -
+                                                            static_cast<uint64_t>(seg_ms) * (p - 1) / pieces);
+            plan.segments[plan.count++] = {static_cast<uint32_t>(prev_duty + step), piece_ms};
+        }
+        prev_duty = duty;
+    }
+    return plan;
+}
+
+} // namespace pwm
@@ -15,6 +15,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "debug.h"
+#include "instrumented_lock.h"
 #include "esp_core_dump.h"  // ESP-IDF v5.3 coredump APIs
 
 static const char* TAG = "telemetry";
@@ -84,6 +85,14 @@ static void publish_device_status_once(void) {
     cJSON_AddNumberToObject(root, "total_internal_bytes", (double)total_internal);
     cJSON_AddNumberToObject(root, "total_spiram_bytes", (double)total_spiram);
 
+    MetricsDropCounts drops;
+    get_metrics_drop_counts(&drops);
+    cJSON* dropped = cJSON_AddObjectToObject(root, "metrics_dropped");
+    cJSON_AddNumberToObject(dropped, "queue_full", drops.queue_full);
+    cJSON_AddNumberToObject(dropped, "batch_full", drops.batch_full);
+    cJSON_AddNumberToObject(dropped, "offline", drops.offline);
+    cJSON_AddNumberToObject(dropped, "untracked_tags", drops.untracked_tags);
+
     // Absolute UTC timestamp in ISO 8601 format
     time_t now_secs = time(nullptr);
     struct tm tm_utc;
@@ -106,6 +115,66 @@ static void publish_device_status_once(void) {
 
 // No separate status task; heartbeats are handled inside the single telemetry task
 
+static cJSON* lock_histogram_json(const lock_histogram_t& h, uint32_t n) {
+    cJSON* obj = cJSON_CreateObject();
+    cJSON_AddNumberToObject(obj, "max", h.max_us);
+    cJSON_AddNumberToObject(obj, "avg", n ? (double)h.total_us / n : 0.0);
+    cJSON* hist = cJSON_AddArrayToObject(obj, "hist");
+    for (int b = 0; b < LOCK_STATS_BUCKETS; ++b) cJSON_AddItemToArray(hist, cJSON_CreateNumber(h.count[b]));
+    return obj;
+}
+
+// Lock contention windows (instrumented_lock.h), once a minute: sensor/<mac>/device/locks
+// {"metrics":{"acquisitions":..,"contended":..,"timeouts":..,"inversions":..,"wait_us":{"max":..,"avg":..,
+//  "hist":[<10us,<100us,<1ms,<10ms,<100ms,<1s,<10s,>=10s]},"hold_us":{...},"slow":[{"waiter":..,"owner":..}]}}
+// Slow waits are logged here too; the lock path itself cannot log.
+static void report_lock_stats(bool publish) {
+    cJSON* root = cJSON_CreateObject();
+    instrumented_lock_take_stats(
+        [](const char* name, const lock_stats_t* s, void* ctx) {
+            for (uint32_t i = 0; i < lock_stats_slow_count(s); ++i) {
+                const lock_slow_wait_t* w = lock_stats_slow_at(s, i);
+                ESP_LOGW(TAG, "Lock %s: %s (prio %u) waited %uus for %s (prio %u)", name, w->waiter,
+                         (unsigned)w->waiter_prio, (unsigned)w->wait_us, w->owner, (unsigned)w->owner_prio);
+            }
+            if (s->acquisitions == 0 && s->timeouts == 0) return;
+            cJSON* lock = cJSON_AddObjectToObject(static_cast<cJSON*>(ctx), name);
+            cJSON_AddNumberToObject(lock, "acquisitions", s->acquisitions);
+            cJSON_AddNumberToObject(lock, "contended", s->contended);
+            cJSON_AddNumberToObject(lock, "timeouts", s->timeouts);
+            cJSON_AddNumberToObject(lock, "inversions", s->inversions);
+            cJSON_AddNumberToObject(lock, "slow_waits", s->slow_waits);
+            cJSON_AddItemToObject(lock, "wait_us", lock_histogram_json(s->wait, s->acquisitions));
+            cJSON_AddItemToObject(lock, "hold_us", lock_histogram_json(s->hold, s->acquisitions));
+            cJSON* slow = cJSON_AddArrayToObject(lock, "slow");
+            for (uint32_t i = 0; i < lock_stats_slow_count(s); ++i) {
+                const lock_slow_wait_t* w = lock_stats_slow_at(s, i);
+                cJSON* e = cJSON_CreateObject();
+                cJSON_AddStringToObject(e, "waiter", w->waiter);
+                cJSON_AddNumberToObject(e, "waiter_prio", w->waiter_prio);
+                cJSON_AddStringToObject(e, "owner", w->owner);
+                cJSON_AddNumberToObject(e, "owner_prio", w->owner_prio);
+                cJSON_AddNumberToObject(e, "wait_us", w->wait_us);
+                cJSON_AddNumberToObject(e, "uptime_ms", (double)(w->at_us / 1000));
+                cJSON_AddItemToArray(slow, e);
+            }
+        },
+        root);
+
+    if (publish && root->child) {
+        char mac_nosep[13] = {0};
+        format_mac_nosep_lower(mac_nosep, sizeof(mac_nosep));
+        char topic[64];
+        snprintf(topic, sizeof(topic), "sensor/%s/device/locks", mac_nosep);
+        char* json = cJSON_PrintUnformatted(root);
+        if (json) {
+            publish_to_topic(topic, json, 0, 0);
+            cJSON_free(json);
+        }
+    }
+    cJSON_Delete(root);
+}
+
 static void publish_device_info(void) {
     cJSON *device_json = cJSON_CreateObject();
 
@@ -289,12 +358,14 @@ static void telemetry_task_entry(void* arg) {
 
     ESP_LOGI(TAG, "SNTP synchronized; starting heartbeats");
 
-    // 3) Heartbeat loop every 10 seconds, only when fully connected
+    // 3) Heartbeat loop every 10 seconds, only when fully connected; lock stats every sixth
     const TickType_t period_ticks = pdMS_TO_TICKS(10000);
-    for (;;) {
-        if (get_system_state() == FULLY_CONNECTED) {
+    for (uint32_t beat = 1;; ++beat) {
+        const bool connected = get_system_state() == FULLY_CONNECTED;
+        if (connected) {
             publish_device_status_once();
         }
+        if (beat % 6 == 0) report_lock_stats(connected);
         vTaskDelay(period_ticks);
     }
 }
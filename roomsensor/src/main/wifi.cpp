@@ -21,6 +21,11 @@
 #include "freertos/semphr.h"
 
 #include "communication.h"
+#include "publish_slot.h"
+#include "mqtt_tls.h"
+#include "link_manager.h"
+#include "profiler.h"
+#include "cJSON.h"
 
 static const char *TAG = "wifi";
 
@@ -134,9 +139,15 @@ void wifi_mqtt_init(void)
         if (cfg.wifi().has_mqtt_broker()) {
             mqtt_cfg.broker.address.uri = cfg.wifi().mqtt_broker().c_str();
             have_broker = true;
+            // TLS brokers go through our transport so reconnects resume the previous session
+            if (strncmp(mqtt_cfg.broker.address.uri, "mqtts://", 8) == 0) {
+                mqtt_cfg.network.transport = mqtt_tls_transport_create();
+            }
         }
     }
-    mqtt_cfg.network.reconnect_timeout_ms = MQTT_RECONNECT_TIMEOUT_MS;
+    // Per-device reconnect delay so the fleet does not hit the broker at the same instant after an outage
+    mqtt_cfg.network.reconnect_timeout_ms =
+        MQTT_RECONNECT_TIMEOUT_MS + (int)publish_slot::offset_for_mac(device_mac, MQTT_RECONNECT_SPREAD_MS);
     mqtt_cfg.network.timeout_ms = MQTT_OPERATION_TIMEOUT_MS;
     
     // Configure LWT via telemetry helper (reads TagsConfig directly)
@@ -242,6 +253,7 @@ static void event_handler(void* arg, esp_event_base_t event_base,
             case WIFI_EVENT_STA_DISCONNECTED: {
                 wifi_event_sta_disconnected_t* dis = (wifi_event_sta_disconnected_t*)event_data;
                 int reason = dis ? dis->reason : -1;
+                link_manager_note_disconnect();
                 if (dis) {
                     char ssid_buf[33];
                     int len = (dis->ssid_len < 32) ? dis->ssid_len : 32;
@@ -290,6 +302,10 @@ static void event_handler(void* arg, esp_event_base_t event_base,
                 schedule_wifi_retry(1000);
                 break;
             }
+            case WIFI_EVENT_STA_BEACON_TIMEOUT:
+                // Link manager reads these as a sign of a marginal link
+                link_manager_note_beacon_timeout();
+                break;
         }
     }
     // Handle IP events
@@ -405,6 +421,11 @@ static void mqtt_event_handler(void* arg, esp_event_base_t event_base,
             snprintf(restart_topic, sizeof(restart_topic), "sensor/%s/device/restart", mac_nosep);
             int msg_id = esp_mqtt_client_subscribe(mqtt_client, restart_topic, 1);
             ESP_LOGI(TAG, "Subscribed to restart topic %s (msg_id=%d)", restart_topic, msg_id);
+
+            char profile_topic[64];
+            snprintf(profile_topic, sizeof(profile_topic), "sensor/%s/device/profile", mac_nosep);
+            msg_id = esp_mqtt_client_subscribe(mqtt_client, profile_topic, 1);
+            ESP_LOGI(TAG, "Subscribed to profile topic %s (msg_id=%d)", profile_topic, msg_id);
         }
 
         // Publish current configuration now that we're connected
@@ -472,6 +493,36 @@ static void mqtt_event_handler(void* arg, esp_event_base_t event_base,
                 esp_restart();
                 return;
             }
+
+            // Profile command: sensor/<mac>/device/profile {"seconds":30,"hz":199}; the capture status goes to
+            // .../profile/status, the stacks are fetched from the HTTP server
+            char profile_topic[64];
+            snprintf(profile_topic, sizeof(profile_topic), "sensor/%s/device/profile", mac_nosep);
+            if (topic == profile_topic) {
+                uint32_t seconds = 30;
+                uint32_t hz = PROFILER_CAPTURE_DEFAULT_RATE_HZ;
+                if (cJSON* cmd = cJSON_Parse(payload.c_str())) {
+                    cJSON* s = cJSON_GetObjectItem(cmd, "seconds");
+                    cJSON* h = cJSON_GetObjectItem(cmd, "hz");
+                    if (cJSON_IsNumber(s) && s->valuedouble > 0) seconds = (uint32_t)s->valuedouble;
+                    if (cJSON_IsNumber(h) && h->valuedouble > 0) hz = (uint32_t)h->valuedouble;
+                    cJSON_Delete(cmd);
+                }
+                esp_err_t err = profiler_capture_start(seconds * 1000, hz);
+                ESP_LOGI(TAG, "MQTT profile command: %us at %uHz: %s", (unsigned)seconds, (unsigned)hz,
+                         esp_err_to_name(err));
+                cJSON* status = profiler_capture_status_json();
+                cJSON_AddStringToObject(status, "result", esp_err_to_name(err));
+                char* json = cJSON_PrintUnformatted(status);
+                cJSON_Delete(status);
+                if (json) {
+                    char status_topic[80];
+                    snprintf(status_topic, sizeof(status_topic), "%s/status", profile_topic);
+                    publish_to_topic(status_topic, json, 0, 0);
+                    cJSON_free(json);
+                }
+                return;
+            }
         }
 
         // Forward potential config updates to ConfigurationManager
@@ -676,6 +727,7 @@ esp_err_t publish_to_topic(const char* subtopic, const char* message, int qos, i
         ESP_LOGE(TAG, "MQTT publish failed, error code=%d", msg_id);
         return ESP_FAIL;
     }
+    link_manager_note_tx(strlen(full_topic) + strlen(message));
 
     // Track boot publish so callers can wait for PUBACK
     if (subtopic && strcmp(subtopic, "device") == 0 && qos > 0) {
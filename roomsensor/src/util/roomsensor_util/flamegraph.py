@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""Symbolize profiler stack captures and render flame graphs.
+
+The firmware's stack capture (main/profiler.h) exports collapsed stacks with raw addresses,
+"task;0x42001234;0x40378abc 17". This tool maps the addresses to function names with addr2line and the ELF
+of the firmware that ran, then writes symbolized collapsed stacks (for speedscope, flamegraph.pl, or
+anything else that reads the folded format) and a self-contained SVG flame graph.
+
+Usage (from roomsensor/src):
+
+    curl "http://<device>/profile/start?seconds=30&hz=199"      # or MQTT sensor/<mac>/device/profile
+    python -m roomsensor_util.flamegraph --url http://<device>/profile/collapsed \\
+        --elf build/roomsensor.elf -o profile.folded --svg profile.svg
+"""
+
+import argparse
+import html
+import json
+import shutil
+import subprocess
+import sys
+import time
+import urllib.request
+import zlib
+from collections import defaultdict
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+ADDR2LINE = "xtensa-esp32s3-elf-addr2line"
+
+
+def parse_collapsed(text: str) -> List[Tuple[List[str], int]]:
+    stacks: List[Tuple[List[str], int]] = []
+    for line in text.splitlines():
+        frames, _, count = line.strip().rpartition(" ")
+        if not frames or not count.isdigit():
+            continue
+        stacks.append((frames.split(";"), int(count)))
+    return stacks
+
+
+def symbolize(stacks: List[Tuple[List[str], int]], elf: Path, tool: str, with_lines: bool) -> Dict[str, str]:
+    addrs = sorted({f for frames, _ in stacks for f in frames[1:] if f.startswith("0x")})
+    if not addrs:
+        return {}
+    exe = shutil.which(tool)
+    if not exe:
+        print(f"{tool} not found; is the ESP-IDF environment exported? Keeping raw addresses.", file=sys.stderr)
+        return {}
+    out = subprocess.run([exe, "-f", "-C", "-e", str(elf)], input="\n".join(addrs), capture_output=True,
+                         text=True, check=True).stdout.splitlines()
+    names: Dict[str, str] = {}
+    for i, addr in enumerate(addrs):
+        func = out[2 * i] if 2 * i < len(out) else "??"
+        where = out[2 * i + 1] if 2 * i + 1 < len(out) else "??:0"
+        if func == "??":
+            names[addr] = addr
+            continue
+        # Drop parameter lists: frames of one function should merge regardless of overload noise
+        label = func.split("(", 1)[0] if "(" in func and not func.startswith("(") else func
+        if with_lines and not where.startswith("??"):
+            label += f" ({Path(where.split(' ', 1)[0]).name})"
+        names[addr] = label.replace(";", ":")
+    return names
+
+
+def fold(stacks: List[Tuple[List[str], int]], names: Dict[str, str]) -> Dict[Tuple[str, ...], int]:
+    folded: Dict[Tuple[str, ...], int] = defaultdict(int)
+    for frames, count in stacks:
+        key = tuple([frames[0]] + [names.get(f, f) for f in frames[1:]])
+        folded[key] += count
+    return folded
+
+
+def render_svg(folded: Dict[Tuple[str, ...], int], title: str, width: int = 1200) -> str:
+    """Classic flame graph: roots at the bottom, width proportional to samples."""
+    tree: dict = {"n": 0, "c": {}}
+    for frames, count in folded.items():
+        node = tree
+        node["n"] += count
+        for f in frames:
+            node = node["c"].setdefault(f, {"n": 0, "c": {}})
+            node["n"] += count
+    total = tree["n"] or 1
+
+    def depth(node: dict) -> int:
+        return 1 + max((depth(c) for c in node["c"].values()), default=0)
+
+    row, pad = 16, 30
+    levels = depth(tree) - 1
+    height = levels * row + pad * 2
+    scale = (width - 20) / total
+    rects: List[str] = []
+
+    def emit(node: dict, name: str, x: float, level: int) -> None:
+        w = node["n"] * scale
+        if w < 0.3:
+            return
+        y = height - pad - (level + 1) * row
+        h = zlib.crc32(name.encode()) & 0xffff
+        color = f"rgb({205 + h % 50},{(h >> 4) % 180 + 40},{(h >> 8) % 50})"
+        label = html.escape(f"{name} ({node['n']} samples, {100.0 * node['n'] / total:.2f}%)")
+        text = html.escape(name[: int(w / 7)]) if w > 21 else ""
+        rects.append(f'<g><title>{label}</title><rect x="{x:.1f}" y="{y}" width="{w:.1f}" height="{row - 1}" '
+                     f'fill="{color}"/><text x="{x + 3:.1f}" y="{y + row - 4}">{text}</text></g>')
+        cx = x
+        for child_name, child in sorted(node["c"].items()):
+            emit(child, child_name, cx, level + 1)
+            cx += child["n"] * scale
+
+    x = 10.0
+    for name, child in sorted(tree["c"].items()):
+        emit(child, name, x, 0)
+        x += child["n"] * scale
+
+    return (f'<svg xmlns="http://www.w3.org/2000/svg" width="{width}" height="{height}" '
+            f'font-family="monospace" font-size="11">'
+            f'<rect width="100%" height="100%" fill="#f8f8f8"/>'
+            f'<text x="10" y="20" font-size="14">{html.escape(title)}</text>'
+            + "".join(rects) + "</svg>\n")
+
+
+def fetch(url: str, wait: bool) -> str:
+    status_url = url.rsplit("/", 1)[0] + "/status"
+    while wait:
+        with urllib.request.urlopen(status_url, timeout=10) as r:
+            st = json.load(r)
+        if st.get("state") != "running":
+            break
+        remaining = max(1.0, (st.get("duration_ms", 0) - st.get("elapsed_ms", 0)) / 1000.0)
+        print(f"capture running, {remaining:.0f}s left", file=sys.stderr)
+        time.sleep(min(remaining, 10.0))
+    with urllib.request.urlopen(url, timeout=60) as r:
+        return r.read().decode(errors="replace")
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    src = ap.add_mutually_exclusive_group(required=True)
+    src.add_argument("--url", help="http://<device>/profile/collapsed")
+    src.add_argument("--input", type=Path, help="saved collapsed stacks")
+    ap.add_argument("--elf", type=Path, required=True, help="ELF of the firmware that was profiled")
+    ap.add_argument("--addr2line", default=ADDR2LINE)
+    ap.add_argument("--lines", action="store_true", help="append the source file to function names")
+    ap.add_argument("--no-wait", action="store_true", help="do not wait for a running capture to finish")
+    ap.add_argument("-o", "--output", type=Path, help="symbolized collapsed stacks")
+    ap.add_argument("--svg", type=Path, help="flame graph")
+    args = ap.parse_args(argv)
+
+    text = fetch(args.url, not args.no_wait) if args.url else args.input.read_text()
+    stacks = parse_collapsed(text)
+    if not stacks:
+        print("no stacks in capture", file=sys.stderr)
+        return 1
+    names = symbolize(stacks, args.elf, args.addr2line, args.lines)
+    folded = fold(stacks, names)
+    total = sum(folded.values())
+
+    lines = [f"{';'.join(k)} {v}" for k, v in sorted(folded.items(), key=lambda kv: -kv[1])]
+    if args.output:
+        args.output.write_text("\n".join(lines) + "\n")
+        print(f"wrote {args.output} ({len(lines)} stacks, {total} samples)")
+    else:
+        print("\n".join(lines))
+    if args.svg:
+        args.svg.write_text(render_svg(folded, f"{args.url or args.input}: {total} samples"))
+        print(f"wrote {args.svg}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
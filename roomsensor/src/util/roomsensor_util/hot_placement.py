@@ -0,0 +1,299 @@
+#!/usr/bin/env python3
+"""Profile-guided code and data placement.
+
+Turns a ``prof_hot`` console capture into an ESP-IDF linker fragment that moves the hottest flash-resident
+functions to IRAM and the read-only tables of their translation units to internal DRAM, within byte
+budgets. Code and constants in flash are fetched through the 32 KB cache, which misses whenever another
+task, a flash write or a big pattern evicts them; IRAM/DRAM never miss.
+
+Usage (from roomsensor/src):
+
+    # with the LED patterns of interest running, save the console output of "prof_hot 60" as hot.txt
+    python -m roomsensor_util.hot_placement generate --samples hot.txt --map build/roomsensor.map \\
+        --iram-budget 16384 --dram-budget 4096 -o main/hot_placement.lf
+    idf.py build flash
+
+    # compare LED render cost from the "render_cycles" log lines of two runs:
+    python -m roomsensor_util.hot_placement compare before.log after.log
+
+main/CMakeLists.txt picks up main/hot_placement.lf when it exists. Delete the file to go back.
+"""
+
+import argparse
+import bisect
+import re
+import shutil
+import subprocess
+import sys
+from collections import defaultdict
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Dict, Iterable, List, Optional, Tuple
+
+# ESP32-S3 address map
+FLASH_TEXT = (0x42000000, 0x44000000)
+FLASH_DATA = (0x3C000000, 0x3E000000)
+
+SAMPLE_RE = re.compile(r"^\s*0x([0-9a-fA-F]{8})\s+(\d+)\s*$")
+SUMMARY_RE = re.compile(r"#\s*hot\s+(.*)$")
+# " .text.sym  0xaddr  0xsize  path/libx.a(obj.cpp.obj)", long names wrap the rest onto the next line
+SECTION_RE = re.compile(r"^ (\.(?:text|literal|rodata)\.\S+)(?:\s+(0x[0-9a-f]+)\s+(0x[0-9a-f]+)\s+(\S+))?\s*$")
+CONT_RE = re.compile(r"^\s+(0x[0-9a-f]+)\s+(0x[0-9a-f]+)\s+(\S+)\s*$")
+ORIGIN_RE = re.compile(r"^(?:.*/)?([^/(]+\.a)\(([^)]+)\)$")
+RENDER_RE = re.compile(r"pattern=(\S+) render_cycles avg=(\d+) max=(\d+) renders=(\d+)")
+
+
+@dataclass
+class Section:
+    kind: str  # text, literal, rodata
+    symbol: str
+    addr: int
+    size: int
+    archive: str
+    obj: str
+
+
+@dataclass
+class Function:
+    symbol: str
+    archive: str
+    obj: str
+    addr: int
+    size: int = 0
+    samples: int = 0
+    literal_size: int = 0
+
+
+@dataclass
+class Placement:
+    functions: List[Function] = field(default_factory=list)
+    tables: List[Section] = field(default_factory=list)
+    iram_bytes: int = 0
+    dram_bytes: int = 0
+
+
+def parse_samples(paths: Iterable[Path]) -> Tuple[Dict[int, int], List[str]]:
+    """PC -> count from one or more captures; console noise between lines is ignored."""
+    counts: Dict[int, int] = defaultdict(int)
+    summaries: List[str] = []
+    for path in paths:
+        for line in path.read_text(errors="replace").splitlines():
+            m = SAMPLE_RE.match(line)
+            if m:
+                counts[int(m.group(1), 16)] += int(m.group(2))
+                continue
+            s = SUMMARY_RE.search(line)
+            if s:
+                summaries.append(s.group(1).strip())
+    return counts, summaries
+
+
+def parse_map(path: Path) -> List[Section]:
+    sections: List[Section] = []
+    pending: Optional[str] = None
+    in_body = False
+    for line in path.read_text(errors="replace").splitlines():
+        if not in_body:
+            in_body = line.startswith("Linker script and memory map")
+            continue
+        if pending:
+            c = CONT_RE.match(line)
+            name, pending = pending, None
+            if c:
+                _add_section(sections, name, c.group(1), c.group(2), c.group(3))
+                continue
+        m = SECTION_RE.match(line)
+        if not m:
+            continue
+        if m.group(2) is None:
+            pending = m.group(1)
+        else:
+            _add_section(sections, m.group(1), m.group(2), m.group(3), m.group(4))
+    return sections
+
+
+def _add_section(out: List[Section], name: str, addr: str, size: str, origin: str) -> None:
+    o = ORIGIN_RE.match(origin)
+    size_v = int(size, 16)
+    if not o or size_v == 0:
+        return
+    kind, _, symbol = name[1:].partition(".")
+    out.append(Section(kind, symbol, int(addr, 16), size_v, o.group(1), o.group(2)))
+
+
+def ldgen_object(obj: str) -> str:
+    # ldgen matches "LEDManager" against LEDManager.cpp.obj
+    return obj.split(".", 1)[0]
+
+
+def attribute(sections: List[Section], counts: Dict[int, int]) -> Tuple[List[Function], int, int]:
+    """Map sampled PCs to functions. Returns (functions by samples, samples in flash text, unmatched)."""
+    texts = sorted((s for s in sections if s.kind == "text"), key=lambda s: s.addr)
+    starts = [s.addr for s in texts]
+    literals = {(s.archive, s.obj, s.symbol): s.size for s in sections if s.kind == "literal"}
+    funcs: Dict[Tuple[str, str, str], Function] = {}
+    flash_samples = unmatched = 0
+    for pc, n in counts.items():
+        if not FLASH_TEXT[0] <= pc < FLASH_TEXT[1]:
+            continue
+        flash_samples += n
+        i = bisect.bisect_right(starts, pc) - 1
+        if i < 0 or pc >= texts[i].addr + texts[i].size:
+            unmatched += n
+            continue
+        s = texts[i]
+        key = (s.archive, s.obj, s.symbol)
+        f = funcs.get(key)
+        if f is None:
+            f = funcs[key] = Function(s.symbol, s.archive, s.obj, s.addr, s.size,
+                                      literal_size=literals.get(key, 0))
+        f.samples += n
+    return sorted(funcs.values(), key=lambda f: f.samples, reverse=True), flash_samples, unmatched
+
+
+def plan(sections: List[Section], funcs: List[Function], total: int, iram_budget: int, dram_budget: int,
+         min_share: float, max_table: int) -> Placement:
+    p = Placement()
+    # ldgen symbol entries cannot carry compiler suffixes such as ".constprop.0"
+    candidates = [f for f in funcs if total and f.samples / total >= min_share and "." not in f.symbol]
+    # Most samples per IRAM byte first, so the budget buys the most cache misses
+    candidates.sort(key=lambda f: f.samples / (f.size + f.literal_size), reverse=True)
+    for f in candidates:
+        cost = f.size + f.literal_size
+        if p.iram_bytes + cost <= iram_budget:
+            p.functions.append(f)
+            p.iram_bytes += cost
+
+    # Tables: flash rodata of the translation units that own the placed functions, hottest unit first
+    unit_samples: Dict[Tuple[str, str], int] = defaultdict(int)
+    for f in p.functions:
+        unit_samples[(f.archive, f.obj)] += f.samples
+    tables = [s for s in sections
+              if s.kind == "rodata" and (s.archive, s.obj) in unit_samples
+              and FLASH_DATA[0] <= s.addr < FLASH_DATA[1]
+              and not s.symbol.startswith(("str", "cst")) and "." not in s.symbol and s.size <= max_table]
+    tables.sort(key=lambda s: (-unit_samples[(s.archive, s.obj)], s.size))
+    for t in tables:
+        if p.dram_bytes + t.size <= dram_budget:
+            p.tables.append(t)
+            p.dram_bytes += t.size
+    return p
+
+
+def demangle(symbols: List[str]) -> Dict[str, str]:
+    tool = shutil.which("xtensa-esp32s3-elf-c++filt") or shutil.which("c++filt")
+    if not tool or not symbols:
+        return {s: s for s in symbols}
+    out = subprocess.run([tool], input="\n".join(symbols), capture_output=True, text=True).stdout.splitlines()
+    return dict(zip(symbols, out)) if len(out) == len(symbols) else {s: s for s in symbols}
+
+
+def write_fragment(p: Placement, out: Path, samples_desc: str, iram_budget: int, dram_budget: int) -> None:
+    by_archive: Dict[str, List[str]] = defaultdict(list)
+    for f in p.functions:
+        by_archive[f.archive].append(f"    {ldgen_object(f.obj)}:{f.symbol} (noflash_text)  # {f.samples} samples")
+    for t in p.tables:
+        by_archive[t.archive].append(f"    {ldgen_object(t.obj)}:{t.symbol} (noflash_data)  # {t.size} bytes")
+
+    lines = [
+        "# Generated by util/roomsensor_util/hot_placement.py; regenerate instead of editing.",
+        f"# Samples: {samples_desc}",
+        f"# IRAM {p.iram_bytes}/{iram_budget} bytes, DRAM {p.dram_bytes}/{dram_budget} bytes",
+    ]
+    for archive in sorted(by_archive):
+        name = re.sub(r"\W", "_", archive[:-2] if archive.endswith(".a") else archive)
+        lines += ["", f"[mapping:hot_{name}]", f"archive: {archive}", "entries:"]
+        lines += sorted(set(by_archive[archive]))
+    out.write_text("\n".join(lines) + "\n")
+
+
+def cmd_generate(args: argparse.Namespace) -> int:
+    counts, summaries = parse_samples(args.samples)
+    if not counts:
+        print("no samples found", file=sys.stderr)
+        return 1
+    sections = parse_map(args.map)
+    if not sections:
+        print(f"no input sections in {args.map}; is it the linker map of the firmware build?", file=sys.stderr)
+        return 1
+    total = sum(counts.values())
+    funcs, flash_samples, unmatched = attribute(sections, counts)
+    p = plan(sections, funcs, total, args.iram_budget, args.dram_budget, args.min_share, args.max_table)
+
+    names = demangle([f.symbol for f in funcs[: args.report]])
+    placed = {id(f) for f in p.functions}
+    for s in summaries:
+        print(f"# {s}")
+    print(f"{total} non-idle samples, {flash_samples} in flash text ({100.0 * flash_samples / total:.1f}%), "
+          f"{unmatched} unmatched")
+    print(f"{'samples':>8} {'share':>6} {'bytes':>6}  placed  function")
+    for f in funcs[: args.report]:
+        print(f"{f.samples:8d} {100.0 * f.samples / total:5.1f}% {f.size + f.literal_size:6d}  "
+              f"{'IRAM' if id(f) in placed else '':6}  {names.get(f.symbol, f.symbol)}")
+    print(f"IRAM: {len(p.functions)} functions, {p.iram_bytes}/{args.iram_budget} bytes")
+    print(f"DRAM: {len(p.tables)} tables, {p.dram_bytes}/{args.dram_budget} bytes")
+
+    desc = ", ".join(str(s) for s in args.samples) + f" ({total} samples)"
+    write_fragment(p, args.output, desc, args.iram_budget, args.dram_budget)
+    print(f"wrote {args.output}")
+    return 0
+
+
+def parse_render_cycles(path: Path) -> Dict[str, Tuple[float, int]]:
+    """pattern -> (render-weighted avg cycles, worst max) over all render_cycles lines of a log."""
+    acc: Dict[str, List[int]] = defaultdict(lambda: [0, 0, 0])
+    for line in path.read_text(errors="replace").splitlines():
+        m = RENDER_RE.search(line)
+        if not m:
+            continue
+        a = acc[m.group(1)]
+        renders = int(m.group(4))
+        a[0] += int(m.group(2)) * renders
+        a[1] += renders
+        a[2] = max(a[2], int(m.group(3)))
+    return {k: (v[0] / v[1], v[2]) for k, v in acc.items() if v[1]}
+
+
+def cmd_compare(args: argparse.Namespace) -> int:
+    before = parse_render_cycles(args.before)
+    after = parse_render_cycles(args.after)
+    patterns = sorted(set(before) | set(after))
+    if not patterns:
+        print("no render_cycles lines found", file=sys.stderr)
+        return 1
+    print(f"{'pattern':<16} {'avg before':>11} {'avg after':>11} {'change':>8} {'max before':>11} {'max after':>11}")
+    for name in patterns:
+        b = before.get(name)
+        a = after.get(name)
+        change = f"{100.0 * (a[0] - b[0]) / b[0]:+7.1f}%" if a and b else "       -"
+        print(f"{name:<16} {b[0] if b else 0:11.0f} {a[0] if a else 0:11.0f} {change} "
+              f"{b[1] if b else 0:11d} {a[1] if a else 0:11d}")
+    return 0
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    sub = ap.add_subparsers(dest="cmd", required=True)
+
+    g = sub.add_parser("generate", help="write a linker fragment from prof_hot captures")
+    g.add_argument("--samples", type=Path, nargs="+", required=True, help="prof_hot output (console captures)")
+    g.add_argument("--map", type=Path, required=True, help="linker map of the profiled build")
+    g.add_argument("--iram-budget", type=int, default=16384, help="bytes of code to move to IRAM")
+    g.add_argument("--dram-budget", type=int, default=4096, help="bytes of tables to move to DRAM")
+    g.add_argument("--min-share", type=float, default=0.002, help="ignore functions below this sample share")
+    g.add_argument("--max-table", type=int, default=2048, help="largest single table to move")
+    g.add_argument("--report", type=int, default=30, help="functions to list")
+    g.add_argument("-o", "--output", type=Path, default=Path("main/hot_placement.lf"))
+    g.set_defaults(func=cmd_generate)
+
+    c = sub.add_parser("compare", help="LED render cycles per pattern, before vs after")
+    c.add_argument("before", type=Path)
+    c.add_argument("after", type=Path)
+    c.set_defaults(func=cmd_compare)
+
+    args = ap.parse_args(argv)
+    return args.func(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
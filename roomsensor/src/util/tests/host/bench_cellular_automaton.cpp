@@ -0,0 +1,60 @@
+// Benchmark: generations per second of the bit-sliced CellularAutomaton against the naive reference, on the
+// 64x32 and 128x64 panel sizes. Both run from the same seed and must agree on every cell at the end.
+#include "host_test.h"
+#include "ca_reference.h"
+#include "CellularAutomaton.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+using leds::internal::CARule;
+using leds::internal::CellularAutomaton;
+
+namespace {
+
+template <typename Automaton>
+double generations_per_second(Automaton& a, int generations) {
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int g = 0; g < generations; ++g) a.step();
+    const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+    return generations / dt.count();
+}
+
+void bench(const char* rule_text, size_t rows, size_t cols) {
+    CARule r;
+    CHECK(CARule::parse(rule_text, r));
+    CellularAutomaton ca;
+    ca.configure(rows, cols, r, true);
+    ReferenceAutomaton ref;
+    ref.configure(rows, cols, r, true);
+    std::mt19937 rng(42);
+    for (size_t y = 0; y < rows; ++y) {
+        for (size_t x = 0; x < cols; ++x) {
+            uint8_t s = (rng() % 3 == 0) ? 1 : 0;
+            ca.set_state(y, x, s);
+            ref.set_state(y, x, s);
+        }
+    }
+    const int kFast = 20000, kSlow = 500;
+    // Same number of generations on both before comparing
+    const double ref_gps = generations_per_second(ref, kSlow);
+    const double ca_gps = generations_per_second(ca, kSlow);
+    bool same = true;
+    for (size_t y = 0; y < rows && same; ++y)
+        for (size_t x = 0; x < cols && same; ++x) same = ca.state(y, x) == ref.state(y, x);
+    CHECK(same);
+    // Longer run for the fast engine so the timer resolution does not matter
+    const double ca_best = std::max(ca_gps, generations_per_second(ca, kFast));
+    printf("%-12s %3zux%-3zu  bit-sliced %9.0f gen/s  naive %8.0f gen/s  x%.0f\n", rule_text, cols, rows, ca_best,
+           ref_gps, ca_best / ref_gps);
+}
+
+} // namespace
+
+TEST(generations_per_second) {
+    for (const char* r : {"B3/S23", "B2/S/C3", "WIREWORLD"}) {
+        bench(r, 32, 64);
+        bench(r, 64, 128);
+    }
+}
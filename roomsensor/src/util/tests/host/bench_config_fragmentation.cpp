@@ -0,0 +1,151 @@
+// Benchmark: internal-RAM fragmentation from configuration updates, std::string members against the
+// fixed-capacity storage of BoundedString.h. A first-fit heap model (8 B header, 8 B alignment, coalescing
+// on free) of a 96 KB region runs 200k steps of background churn (short-lived 64-1500 B MQTT/JSON buffers,
+// a few long-lived 2 KB ones) with a config update every 5 steps across 60 string values: 4 large
+// (seed/message sized, 300-700 chars), the rest names and enums (8-47 chars).
+// - std::string: each update frees the old buffer and allocates one for the new length (SSO up to 15 chars)
+// - bounded: the inline buffers are allocated once at boot with their modules; updates allocate nothing
+// A model, not the ESP-IDF allocator; it shows the trend, not the device's numbers.
+#include "host_test.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t kRegionBytes = 96 * 1024;
+constexpr int kSteps = 200000;
+constexpr int kValues = 60;
+constexpr int kLargeValues = 4;
+constexpr size_t kSsoChars = 15;
+
+class FirstFitHeap {
+public:
+    explicit FirstFitHeap(size_t bytes) { free_[0] = bytes; }
+
+    // Offset of the block, -1 when nothing fits
+    long allocate(size_t n) {
+        n = ((n + 7) & ~size_t(7)) + 8;
+        for (auto it = free_.begin(); it != free_.end(); ++it) {
+            if (it->second < n) continue;
+            const size_t off = it->first, size = it->second;
+            free_.erase(it);
+            if (size > n) free_[off + n] = size - n;
+            used_[off] = n;
+            return static_cast<long>(off);
+        }
+        return -1;
+    }
+
+    void release(long off) {
+        auto u = used_.find(static_cast<size_t>(off));
+        auto it = free_.emplace(u->first, u->second).first;
+        used_.erase(u);
+        auto next = std::next(it);
+        if (next != free_.end() && it->first + it->second == next->first) {
+            it->second += next->second;
+            free_.erase(next);
+        }
+        if (it != free_.begin()) {
+            auto prev = std::prev(it);
+            if (prev->first + prev->second == it->first) {
+                prev->second += it->second;
+                free_.erase(it);
+            }
+        }
+    }
+
+    size_t free_bytes() const {
+        size_t t = 0;
+        for (const auto& f : free_) t += f.second;
+        return t;
+    }
+    size_t largest_free() const {
+        size_t t = 0;
+        for (const auto& f : free_) t = std::max(t, f.second);
+        return t;
+    }
+    size_t free_blocks() const { return free_.size(); }
+
+private:
+    std::map<size_t, size_t> free_; // offset -> size
+    std::map<size_t, size_t> used_;
+};
+
+struct Result {
+    size_t free_bytes, largest, min_largest, free_blocks, failed;
+};
+
+size_t value_len(std::mt19937& rng, int i) { return i < kLargeValues ? 300 + rng() % 400 : 8 + rng() % 40; }
+
+Result run(bool std_string) {
+    std::mt19937 rng(7);
+    FirstFitHeap heap(kRegionBytes);
+    std::vector<long> values(kValues, -1);
+    for (int i = 0; i < kValues; ++i) {
+        const size_t len = value_len(rng, i);
+        if (std_string && len > kSsoChars) values[i] = heap.allocate(len + 1);
+    }
+    if (!std_string) heap.allocate((kValues - kLargeValues) * 48); // the modules' inline buffers
+
+    struct Live {
+        long off;
+        int until;
+    };
+    std::vector<Live> live;
+    int long_lived = 0;
+    Result r = {0, 0, kRegionBytes, 0, 0};
+    for (int step = 0; step < kSteps; ++step) {
+        if (rng() % 2) {
+            const long p = heap.allocate(64 + rng() % 1436);
+            if (p < 0) r.failed++;
+            else live.push_back({p, step + 1 + static_cast<int>(rng() % 50)});
+        }
+        for (size_t j = 0; j < live.size();) {
+            if (live[j].until <= step) {
+                heap.release(live[j].off);
+                live[j] = live.back();
+                live.pop_back();
+            } else {
+                j++;
+            }
+        }
+        if (step % 20000 == 0 && long_lived < 8 && heap.allocate(2048) >= 0) long_lived++;
+
+        if (step % 5 == 0) {
+            const int i = static_cast<int>(rng() % kValues);
+            const size_t len = value_len(rng, i);
+            if (std_string) {
+                if (values[i] >= 0) heap.release(values[i]);
+                values[i] = len > kSsoChars ? heap.allocate(len + 1) : -1;
+                if (len > kSsoChars && values[i] < 0) r.failed++;
+            }
+        }
+        if (step % 1000 == 999) r.min_largest = std::min(r.min_largest, heap.largest_free());
+    }
+    r.free_bytes = heap.free_bytes();
+    r.largest = heap.largest_free();
+    r.free_blocks = heap.free_blocks();
+    return r;
+}
+
+void print(const char* name, const Result& r) {
+    printf("%-12s free %zu B  largest %zu B  min largest %zu B  free blocks %zu  failed allocs %zu\n", name,
+           r.free_bytes, r.largest, r.min_largest, r.free_blocks, r.failed);
+}
+
+} // namespace
+
+TEST(config_update_fragmentation_std_string_vs_bounded) {
+    const Result heap_strings = run(true);
+    const Result bounded = run(false);
+    print("std::string", heap_strings);
+    print("bounded", bounded);
+    CHECK_EQ(bounded.failed, size_t(0));
+    CHECK(bounded.free_blocks < heap_strings.free_blocks);
+    CHECK(bounded.min_largest > heap_strings.min_largest);
+}
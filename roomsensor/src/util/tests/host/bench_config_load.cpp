@@ -0,0 +1,108 @@
+// Configuration load and update cost with every module populated (config_fixture.h), NVS in memory:
+// - apply: typed apply_value vs the apply_update text edge, per key, over every persisted key
+// - boot: initialize() from per-key NVS (first boot / after an update) and from the snapshot blob
+// - update: handle_update from MQTT text, including the NVS write and the config/current republish
+// Host timings only show relative cost; on the device flash reads dominate the boot load.
+#include "host_test.h"
+#include "config_fixture.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static size_t g_published_bytes = 0;
+
+esp_err_t publish_to_topic(const char*, const char* message, int, int) {
+    g_published_bytes = strlen(message);
+    return ESP_OK;
+}
+
+namespace {
+
+double us_per(Clock::time_point t0, size_t n) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - t0).count() / static_cast<double>(n);
+}
+
+struct Key {
+    config::ConfigurationModule* mod;
+    const config::ConfigurationValueDescriptor* desc;
+    std::string text;
+};
+
+} // namespace
+
+TEST(bench_config_load) {
+    host_nvs::clear();
+    const config_fixture::Population pop = config_fixture::populate_nvs();
+    printf("%zu modules, %zu of %zu persisted keys populated\n", pop.modules, pop.written, pop.keys);
+    CHECK(pop.unpopulated.empty());
+
+    // Apply: every populated key, read back from NVS as text and as a typed value
+    auto modules = config_fixture::make_modules();
+    std::vector<Key> keys;
+    std::string scratch;
+    for (auto& mod : modules) {
+        for (const auto& d : mod->descriptors()) {
+            if (!d.persisted) continue;
+            config::ConfigValue v = config_fixture::accepted_value(*mod, d, scratch);
+            if (v.is_set) keys.push_back({mod.get(), &d, scratch});
+        }
+    }
+    std::vector<config::ConfigValue> typed;
+    for (const Key& k : keys) {
+        config::ConfigValue v;
+        config::ConfigValue::parse(k.desc->type, k.text.c_str(), v);
+        typed.push_back(v);
+    }
+    const int rounds = 2000;
+    auto t0 = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < keys.size(); ++i) keys[i].mod->apply_value(keys[i].desc->name, typed[i]);
+    }
+    const double typed_ns = us_per(t0, rounds * keys.size()) * 1000.0;
+    t0 = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (const Key& k : keys) k.mod->apply_update(k.desc->name, k.text.c_str());
+    }
+    const double text_ns = us_per(t0, rounds * keys.size()) * 1000.0;
+    printf("apply %zu keys: typed %.0f ns/key, text edge %.0f ns/key\n", keys.size(), typed_ns, text_ns);
+
+    // Boot: per-key (snapshot erased before each boot) and from the snapshot
+    const int boots = 200;
+    host_nvs::read_count() = 0;
+    t0 = Clock::now();
+    for (int i = 0; i < boots; ++i) {
+        config_snapshot_invalidate();
+        config::ConfigurationManager m;
+        m.initialize();
+    }
+    const double per_key_us = us_per(t0, boots);
+    const uint32_t per_key_reads = host_nvs::read_count() / boots;
+    host_nvs::read_count() = 0;
+    t0 = Clock::now();
+    for (int i = 0; i < boots; ++i) {
+        config::ConfigurationManager m;
+        m.initialize();
+    }
+    const double snap_us = us_per(t0, boots);
+    const uint32_t snap_reads = host_nvs::read_count() / boots;
+    printf("boot: per-key %.0f us (%u NVS reads), snapshot %.0f us (%u NVS reads)\n", per_key_us, per_key_reads,
+           snap_us, snap_reads);
+    CHECK(snap_reads < per_key_reads);
+
+    // Update: MQTT text through parse, apply, persist and republish
+    config::ConfigurationManager m;
+    m.initialize();
+    const int updates = 2000;
+    t0 = Clock::now();
+    for (int i = 0; i < updates; ++i) {
+        char rows[8];
+        snprintf(rows, sizeof(rows), "%d", 1 + i % 32);
+        m.handle_update("led2", "num_rows", rows, true);
+    }
+    printf("update: %.1f us per handle_update (republishes %zu bytes of config JSON)\n", us_per(t0, updates),
+           g_published_bytes);
+}
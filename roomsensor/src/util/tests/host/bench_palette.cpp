@@ -0,0 +1,52 @@
+// Benchmark: pattern update plus flush (palette expansion, encode) per frame for Rainbow and Sunset on the
+// per-pixel path and the palette-indexed path, at 60, 300 and 1024 pixels. At 60 pixels both patterns stay
+// per-pixel, so there is no indexed figure. Host numbers; the crossover point is what carries over.
+#include "host_test.h"
+#include "fake_strip.h"
+#include "RainbowPattern.h"
+#include "SunsetPattern.h"
+
+#include <chrono>
+
+namespace {
+
+double us_per_frame(leds::LEDPattern& p, leds::LEDStrip& strip, int frames) {
+    p.reset(strip, 0);
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        const uint64_t now = static_cast<uint64_t>(f) * 5'000;
+        p.update(strip, now);
+        strip.flush_if_dirty(now, 0);
+    }
+    const std::chrono::duration<double, std::micro> dt = std::chrono::steady_clock::now() - t0;
+    return dt.count() / frames;
+}
+
+template <typename Pattern>
+void bench(const char* name, size_t n) {
+    const int kFrames = 2000;
+    std::vector<uint8_t> wire_rgb, wire_idx;
+    auto plain = make_adapter(n, &wire_rgb);
+    RgbOnlyStrip rgb(*plain);
+    Pattern a;
+    const double per_pixel = us_per_frame(a, rgb, kFrames);
+    auto indexed = make_adapter(n, &wire_idx);
+    Pattern b;
+    const double idx = us_per_frame(b, *indexed, kFrames);
+    CHECK(!wire_rgb.empty() && !wire_idx.empty());
+    if (indexed->indexed_mode()) {
+        printf("%-8s %5zu px  per-pixel %8.1f us/frame  indexed %8.1f us/frame  x%.2f\n", name, n, per_pixel, idx,
+               per_pixel / idx);
+    } else {
+        printf("%-8s %5zu px  per-pixel %8.1f us/frame  indexed      n/a\n", name, n, per_pixel);
+    }
+}
+
+} // namespace
+
+TEST(us_per_frame_per_pixel_vs_indexed) {
+    for (size_t n : {size_t(60), size_t(300), size_t(1024)}) {
+        bench<leds::RainbowPattern>("rainbow", n);
+        bench<leds::SunsetPattern>("sunset", n);
+    }
+}
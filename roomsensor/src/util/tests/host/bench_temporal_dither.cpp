@@ -0,0 +1,46 @@
+// Benchmark: CPU cost per channel of TemporalDither::quantize against plain rounding (narrow_u16), over a
+// 400-pixel RGB frame. Host numbers; they show the relative cost, not the ESP32-S3 cycle count.
+#include "host_test.h"
+#include "LEDTemporalDither.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+using leds::internal::TemporalDither;
+
+namespace {
+
+template <typename Fn>
+double ns_per_channel(size_t channels, int frames, Fn&& fn) {
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f) fn();
+    const std::chrono::duration<double, std::nano> dt = std::chrono::steady_clock::now() - t0;
+    return dt.count() / (static_cast<double>(frames) * channels);
+}
+
+} // namespace
+
+TEST(ns_per_channel_dither_vs_round) {
+    const size_t channels = 400 * 3;
+    std::mt19937 rng(1);
+    std::vector<uint16_t> in(channels);
+    for (auto& v : in) v = static_cast<uint16_t>(rng());
+    std::vector<uint8_t> out(channels);
+    TemporalDither d;
+    d.resize(channels);
+    const int kFrames = 20000;
+    uint32_t sink = 0;
+
+    const double round_ns = ns_per_channel(channels, kFrames, [&] {
+        for (size_t i = 0; i < channels; ++i) out[i] = leds::narrow_u16(in[i]);
+        sink += out[rng() % channels];
+    });
+    const double dither_ns = ns_per_channel(channels, kFrames, [&] {
+        d.quantize(in.data(), out.data(), channels);
+        sink += out[rng() % channels];
+    });
+    printf("400 px RGB: round %.2f ns/channel  dither %.2f ns/channel  (%.2f us/frame dithered)  [%u]\n", round_ns,
+           dither_ns, dither_ns * channels / 1000.0, sink & 1u);
+    CHECK(dither_ns > 0.0);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "CellularAutomaton.h"
+#include <cstdint>
+#include <vector>
+
+// Naive reference for CellularAutomaton: one byte per cell, neighbours counted one by one. Same rule
+// semantics (state 1 is the counted state, GENERATIONS cells age through C-2 refractory states, WIREWORLD
+// is empty/head/tail/conductor) and the same age tracking, written for obviousness rather than speed.
+class ReferenceAutomaton {
+public:
+    void configure(size_t rows, size_t cols, const leds::internal::CARule& rule, bool wrap) {
+        rows_ = rows;
+        cols_ = cols;
+        rule_ = rule;
+        wrap_ = wrap;
+        cells_.assign(rows * cols, 0);
+        ages_.assign(rows * cols, 0);
+    }
+
+    uint8_t state(size_t r, size_t c) const { return cells_[r * cols_ + c]; }
+    uint8_t age(size_t r, size_t c) const { return ages_[r * cols_ + c]; }
+    void set_state(size_t r, size_t c, uint8_t s) {
+        if (s >= rule_.states) s = static_cast<uint8_t>(rule_.states - 1);
+        cells_[r * cols_ + c] = s;
+        ages_[r * cols_ + c] = 0;
+    }
+
+    void step() {
+        std::vector<uint8_t> next(cells_.size());
+        for (size_t r = 0; r < rows_; ++r) {
+            for (size_t c = 0; c < cols_; ++c) {
+                const uint8_t s = state(r, c);
+                const unsigned n = live_neighbours(r, c);
+                const bool born = (rule_.birth >> n) & 1u;
+                const bool stays = (rule_.survive >> n) & 1u;
+                uint8_t out = 0;
+                switch (rule_.kind) {
+                    case leds::internal::CARule::Kind::LIFE_LIKE:
+                        out = s ? (stays ? 1 : 0) : (born ? 1 : 0);
+                        break;
+                    case leds::internal::CARule::Kind::GENERATIONS:
+                        if (s == 0) out = born ? 1 : 0;
+                        else if (s == 1 && stays) out = 1;
+                        else out = (s + 1u == rule_.states) ? 0 : static_cast<uint8_t>(s + 1);
+                        break;
+                    case leds::internal::CARule::Kind::WIREWORLD:
+                        out = s == 1 ? 2 : s == 2 ? 3 : s == 3 ? (born ? 1 : 3) : 0;
+                        break;
+                }
+                next[r * cols_ + c] = out;
+            }
+        }
+        for (size_t i = 0; i < cells_.size(); ++i) {
+            if (next[i] != cells_[i]) ages_[i] = 0;
+            else if (ages_[i] != 255) ++ages_[i];
+        }
+        cells_.swap(next);
+    }
+
+private:
+    unsigned live_neighbours(size_t r, size_t c) const {
+        unsigned n = 0;
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                if (!dr && !dc) continue;
+                long rr = static_cast<long>(r) + dr;
+                long cc = static_cast<long>(c) + dc;
+                if (wrap_) {
+                    rr = (rr + static_cast<long>(rows_)) % static_cast<long>(rows_);
+                    cc = (cc + static_cast<long>(cols_)) % static_cast<long>(cols_);
+                } else if (rr < 0 || cc < 0 || rr >= static_cast<long>(rows_) || cc >= static_cast<long>(cols_)) {
+                    continue;
+                }
+                n += state(static_cast<size_t>(rr), static_cast<size_t>(cc)) == 1;
+            }
+        }
+        return n;
+    }
+
+    size_t rows_ = 0, cols_ = 0;
+    leds::internal::CARule rule_;
+    bool wrap_ = true;
+    std::vector<uint8_t> cells_;
+    std::vector<uint8_t> ages_;
+};
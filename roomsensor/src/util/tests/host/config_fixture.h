@@ -0,0 +1,138 @@
+#pragma once
+
+// The configuration component on the host: the modules as ConfigurationManager registers them, and NVS
+// (stubs/nvs.h) populated with a value every persisted key accepts. Shared by the configuration tests and
+// bench_config_load.
+#include "A2DConfig.h"
+#include "AlarmConfig.h"
+#include "ConfigurationManager.h"
+#include "DeviceConfig.h"
+#include "GameOfLifeConfig.h"
+#include "I2CConfig.h"
+#include "IOConfig.h"
+#include "LEDConfig.h"
+#include "MotionConfig.h"
+#include "PWMConfig.h"
+#include "TagsConfig.h"
+#include "WifiConfig.h"
+#include "nvs.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace config_fixture {
+
+using config::ConfigurationModule;
+using config::ConfigValue;
+using config::ConfigValueType;
+
+// Same modules, names and order as ConfigurationManager::register_modules()
+inline std::vector<std::unique_ptr<ConfigurationModule>> make_modules() {
+    std::vector<std::unique_ptr<ConfigurationModule>> m;
+    m.emplace_back(new config::WifiConfig());
+    m.emplace_back(new config::TagsConfig());
+    m.emplace_back(new config::DeviceConfig());
+    m.emplace_back(new config::GameOfLifeConfig());
+    for (const char* n : {"led1", "led2", "led3", "led4", "led5", "led6", "led7", "led8"}) m.emplace_back(new config::LEDConfig(n));
+    for (const char* n : {"a2d1", "a2d2", "a2d3", "a2d4"}) m.emplace_back(new config::A2DConfig(n));
+    m.emplace_back(new config::MotionConfig());
+    for (const char* n : {"io1", "io2", "io3", "io4", "io5", "io6", "io7", "io8"}) m.emplace_back(new config::IOConfig(n));
+    for (const char* n : {"pwm1", "pwm2", "pwm3", "pwm4"}) m.emplace_back(new config::PWMConfig(n));
+    m.emplace_back(new config::AlarmConfig());
+    m.emplace_back(new config::I2CConfig());
+    return m;
+}
+
+// Tried in order until the key accepts one: enum spellings the modules know, then free text
+inline const std::vector<const char*>& string_candidates() {
+    static const std::vector<const char*> c = {
+        "true", "WS2812", "SERPENTINE_ROW", "RAINBOW", "FSR_4V096", "RSUV", "SWITCH_HIGH", "LOCK_KEYPAD",
+        "AUTO", "4,5", "a2d1.ch1", "io1.pin1", "north_bed",
+    };
+    return c;
+}
+
+// Store 'value' under 'key' in NVS the way ConfigurationManager does (F32 as its bit pattern)
+inline esp_err_t write_nvs(nvs_handle_t h, const char* key, const ConfigValue& v) {
+    switch (v.type) {
+        case ConfigValueType::String: return nvs_set_str(h, key, v.c_str());
+        case ConfigValueType::Blob: return nvs_set_blob(h, key, v.data, v.size);
+        case ConfigValueType::Bool: return nvs_set_u8(h, key, v.b ? 1 : 0);
+        case ConfigValueType::I32: return nvs_set_i32(h, key, v.i32);
+        case ConfigValueType::U32: return nvs_set_u32(h, key, v.u32);
+        case ConfigValueType::I64: return nvs_set_i64(h, key, v.i64);
+        case ConfigValueType::F32: {
+            uint32_t bits;
+            memcpy(&bits, &v.f32, sizeof(bits));
+            return nvs_set_u32(h, key, bits);
+        }
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+// First candidate 'mod' accepts for 'desc', applied to 'mod'; unset if none
+inline ConfigValue accepted_value(ConfigurationModule& mod, const config::ConfigurationValueDescriptor& desc,
+                                  std::string& text) {
+    std::vector<std::string> tries;
+    // Keys the generic candidates would only reach after a run of logged rejections
+    if (strcmp(desc.name, "password") == 0) tries.push_back("password123");
+    if (strcmp(desc.name, "power_save") == 0) tries.push_back("MIN_MODEM");
+    const char* field = strrchr(desc.name, '.');
+    field = field ? field + 1 : desc.name;
+    if (strcmp(field, "gain") == 0) tries.push_back("FSR_4V096");
+    if (strcmp(field, "sensor") == 0) tries.push_back("RSUV");
+    switch (desc.type) {
+        case ConfigValueType::String:
+            for (const char* s : string_candidates()) tries.push_back(s);
+            break;
+        case ConfigValueType::Bool: tries.push_back("true"); break;
+        case ConfigValueType::F32: tries.insert(tries.end(), {"2.5", "1"}); break;
+        case ConfigValueType::Blob: tries.push_back("blob"); break;
+        default: tries.insert(tries.end(), {"12", "4", "1", "0", "100"}); break;
+    }
+    for (const std::string& t : tries) {
+        ConfigValue v;
+        if (ConfigValue::parse(desc.type, t.c_str(), v) != ESP_OK) continue;
+        if (ConfigurationModule::check_size(&desc, v) != ESP_OK || mod.apply_value(desc.name, v) != ESP_OK) continue;
+        text = t;
+        ConfigValue v2;
+        ConfigValue::parse(desc.type, text.c_str(), v2); // re-borrow from 'text', which outlives the call
+        return v2;
+    }
+    return ConfigValue::unset(desc.type);
+}
+
+struct Population {
+    size_t modules = 0;
+    size_t keys = 0;     // persisted descriptors
+    size_t written = 0;  // keys that accepted a candidate
+    std::vector<std::string> unpopulated;
+};
+
+// Fill NVS with one accepted value per persisted key of every module
+inline Population populate_nvs() {
+    Population p;
+    std::string text;
+    for (auto& mod : make_modules()) {
+        ++p.modules;
+        nvs_handle_t h;
+        nvs_open(mod->name(), NVS_READWRITE, &h);
+        for (const auto& desc : mod->descriptors()) {
+            if (!desc.persisted) continue;
+            ++p.keys;
+            ConfigValue v = accepted_value(*mod, desc, text);
+            if (v.is_set && write_nvs(h, desc.name, v) == ESP_OK) {
+                ++p.written;
+            } else {
+                p.unpopulated.push_back(std::string(mod->name()) + "." + desc.name);
+            }
+        }
+        nvs_commit(h);
+        nvs_close(h);
+    }
+    return p;
+}
+
+} // namespace config_fixture
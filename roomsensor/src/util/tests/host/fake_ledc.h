@@ -0,0 +1,94 @@
+#pragma once
+
+#include "pwm_plan.h"
+#include <cstdint>
+#include <vector>
+
+// One LEDC channel for host tests, run one PWM period at a time. Models what pwm.cpp relies on, after
+// ledc_set_fade_with_time and the fade ISR in ESP-IDF 5.3:
+// - the fade time becomes total_cycles = time_ms * freq / 1000 periods; below one period per count the
+//   duty moves 'scale' counts every period, otherwise one count every 'cycle_num' periods (both <= 1023)
+// - the hardware runs at most kLedcMaxCyclesPerStep steps; whatever a capped step count or the scale
+//   remainder leaves is jumped to the target when the fade ends, just before the fade-end event
+class FakeLedc {
+public:
+    FakeLedc(uint32_t freq_hz, int bits) : freq_hz_(freq_hz), full_((1u << bits) - 1) {}
+
+    // ledc_set_duty_and_update: stops a running fade
+    void set_duty(uint32_t duty) {
+        move_to(duty > full_ ? full_ : duty);
+        fading_ = false;
+    }
+
+    // ledc_set_fade_with_time + ledc_fade_start
+    void start_fade(uint32_t target, uint32_t time_ms) {
+        target_ = target > full_ ? full_ : target;
+        const uint32_t delta = target_ > duty_ ? target_ - duty_ : duty_ - target_;
+        const uint32_t total_cycles = static_cast<uint32_t>(static_cast<uint64_t>(time_ms) * freq_hz_ / 1000);
+        scale_ = cycle_num_ = steps_left_ = 0;
+        if (delta != 0 && total_cycles != 0) {
+            if (total_cycles > delta) {
+                scale_ = 1;
+                cycle_num_ = total_cycles / delta;
+                if (cycle_num_ > pwm::kLedcMaxCyclesPerStep) cycle_num_ = pwm::kLedcMaxCyclesPerStep;
+            } else {
+                cycle_num_ = 1;
+                scale_ = delta / total_cycles;
+                if (scale_ > 1023) scale_ = 1023;
+            }
+            steps_left_ = delta / scale_;
+            if (steps_left_ > pwm::kLedcMaxCyclesPerStep) {
+                steps_left_ = pwm::kLedcMaxCyclesPerStep;
+                ++capped_fades;
+            }
+        }
+        up_ = target_ > duty_;
+        period_in_step_ = 0;
+        fading_ = true;
+    }
+
+    // One PWM period. True when a fade ended in it (the fade-end event).
+    bool tick() {
+        ++now_periods;
+        if (!fading_) return false;
+        if (steps_left_ > 0) {
+            if (++period_in_step_ < cycle_num_) return false;
+            period_in_step_ = 0;
+            move_to(up_ ? duty_ + scale_ : duty_ - scale_);
+            if (--steps_left_ > 0) return false;
+        }
+        move_to(target_);
+        fading_ = false;
+        return true;
+    }
+
+    uint32_t duty() const { return duty_; }
+    bool fading() const { return fading_; }
+    uint32_t freq_hz() const { return freq_hz_; }
+
+    uint64_t now_periods = 0;
+    uint32_t capped_fades = 0;   // fades whose step count hit the hardware limit
+    uint32_t max_jump = 0;       // largest duty change in one period
+    uint32_t max_end_jump = 0;   // largest jump to the target at a fade end
+    std::vector<uint32_t> trace; // duty after every change
+
+private:
+    void move_to(uint32_t duty) {
+        const uint32_t jump = duty > duty_ ? duty - duty_ : duty_ - duty;
+        if (jump > max_jump) max_jump = jump;
+        if (fading_ && duty == target_ && steps_left_ == 0 && jump > max_end_jump) max_end_jump = jump;
+        duty_ = duty;
+        trace.push_back(duty);
+    }
+
+    uint32_t freq_hz_;
+    uint32_t full_;
+    uint32_t duty_ = 0;
+    uint32_t target_ = 0;
+    uint32_t scale_ = 0;
+    uint32_t cycle_num_ = 0;
+    uint32_t steps_left_ = 0;
+    uint32_t period_in_step_ = 0;
+    bool up_ = false;
+    bool fading_ = false;
+};
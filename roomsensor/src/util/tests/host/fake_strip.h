@@ -0,0 +1,77 @@
+#pragma once
+
+#include "LEDStrip.h"
+#include "LEDStripSurfaceAdapter.h"
+#include "LEDWireEncoder.h"
+#include "LEDCoordinateMapperRowMajor.h"
+
+#include <memory>
+#include <vector>
+
+// Wire encoder that keeps the last frame handed to the wire as logical RGBA, so tests can check what a
+// strip would have sent
+class CaptureEncoder final : public leds::internal::LEDWireEncoder {
+public:
+    explicit CaptureEncoder(std::vector<uint8_t>* sink) : sink_(sink) {}
+    size_t frame_size_for(size_t rows, size_t cols) const override { return rows * cols * 4; }
+    void encode_frame(const uint8_t* logical_rgba, size_t rows, size_t cols, uint8_t* out) const override {
+        std::copy(logical_rgba, logical_rgba + rows * cols * 4, out);
+    }
+    bool transmit_frame(const uint8_t* frame, size_t size) override {
+        sink_->assign(frame, frame + size);
+        ++frames;
+        return true;
+    }
+    bool is_busy() const override { return false; }
+    int frames = 0;
+
+private:
+    std::vector<uint8_t>* sink_;
+};
+
+// 1-row LEDStripSurfaceAdapter writing into 'wire'
+inline std::unique_ptr<leds::LEDStripSurfaceAdapter> make_adapter(size_t n, std::vector<uint8_t>* wire,
+                                                                  bool dither = false) {
+    leds::LEDStripSurfaceAdapter::Params p;
+    p.gpio = 1;
+    p.rows = 1;
+    p.cols = n;
+    p.temporal_dither = dither;
+    return std::unique_ptr<leds::LEDStripSurfaceAdapter>(new leds::LEDStripSurfaceAdapter(
+        p, std::unique_ptr<leds::internal::LEDCoordinateMapper>(new leds::internal::RowMajorMapper(1, n)),
+        std::unique_ptr<leds::internal::LEDWireEncoder>(new CaptureEncoder(wire))));
+}
+
+// Forwards to another strip but refuses indexed mode, so patterns take their per-pixel path on it; counts
+// pixel writes
+class RgbOnlyStrip final : public leds::LEDStrip {
+public:
+    explicit RgbOnlyStrip(leds::LEDStrip& s) : s_(s) {}
+    int pin() const override { return s_.pin(); }
+    size_t length() const override { return s_.length(); }
+    config::LEDConfig::Chip chip() const override { return s_.chip(); }
+    size_t rows() const override { return s_.rows(); }
+    size_t cols() const override { return s_.cols(); }
+    size_t index_for_row_col(size_t row, size_t col) const override { return s_.index_for_row_col(row, col); }
+    bool set_pixel(size_t i, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) override {
+        ++writes;
+        return s_.set_pixel(i, r, g, b, w);
+    }
+    bool set_pixel16(size_t i, uint16_t r, uint16_t g, uint16_t b, uint16_t w = 0) override {
+        ++writes;
+        return s_.set_pixel16(i, r, g, b, w);
+    }
+    bool get_pixel(size_t i, uint8_t& r, uint8_t& g, uint8_t& b, uint8_t& w) const override { return s_.get_pixel(i, r, g, b, w); }
+    void clear() override { s_.clear(); }
+    bool flush_if_dirty(uint64_t now_us, uint64_t max_quiescent_us) override { return s_.flush_if_dirty(now_us, max_quiescent_us); }
+    bool is_transmitting() const override { return s_.is_transmitting(); }
+    void on_transmit_complete(uint64_t now_us) override { s_.on_transmit_complete(now_us); }
+    bool uses_dma() const override { return false; }
+    bool has_enable_pin() const override { return false; }
+    void set_power_enabled(bool) override {}
+
+    size_t writes = 0;
+
+private:
+    leds::LEDStrip& s_;
+};
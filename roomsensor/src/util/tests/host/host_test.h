@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Minimal test runner for the host tests. Each file declares cases with TEST(name); host_test_main.cpp
+// runs them all and exits non-zero if any check failed. Checks report and continue.
+namespace host_test {
+
+struct Case {
+    const char* name;
+    void (*fn)();
+};
+
+inline std::vector<Case>& cases() {
+    static std::vector<Case> c;
+    return c;
+}
+
+inline int& failures() {
+    static int f = 0;
+    return f;
+}
+
+struct Register {
+    Register(const char* name, void (*fn)()) { cases().push_back({name, fn}); }
+};
+
+inline void fail(const char* file, int line, const char* what) {
+    fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+    failures()++;
+}
+
+} // namespace host_test
+
+#define TEST(name)                                                   \
+    static void name();                                              \
+    static host_test::Register name##_registration(#name, &name);   \
+    static void name()
+
+#define CHECK(cond)                                                  \
+    do {                                                             \
+        if (!(cond)) host_test::fail(__FILE__, __LINE__, #cond);     \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                                           \
+    do {                                                                                         \
+        const auto va_ = (a);                                                                    \
+        const auto vb_ = (b);                                                                    \
+        if (!(va_ == vb_)) {                                                                     \
+            host_test::fail(__FILE__, __LINE__, #a " == " #b);                                   \
+            fprintf(stderr, "    %lld != %lld\n", (long long)va_, (long long)vb_);               \
+        }                                                                                        \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                                                    \
+    do {                                                                                         \
+        const double va_ = (a);                                                                  \
+        const double vb_ = (b);                                                                  \
+        if (!(std::fabs(va_ - vb_) <= (tol))) {                                                  \
+            host_test::fail(__FILE__, __LINE__, #a " ~= " #b);                                   \
+            fprintf(stderr, "    %.6g vs %.6g (tolerance %.3g)\n", va_, vb_, (double)(tol));     \
+        }                                                                                        \
+    } while (0)
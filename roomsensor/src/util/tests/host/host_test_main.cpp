@@ -0,0 +1,11 @@
+#include "host_test.h"
+
+int main() {
+    for (const host_test::Case& c : host_test::cases()) {
+        const int before = host_test::failures();
+        c.fn();
+        printf("%s %s\n", host_test::failures() == before ? "PASS" : "FAIL", c.name);
+    }
+    printf("%zu cases, %d failed checks\n", host_test::cases().size(), host_test::failures());
+    return host_test::failures() == 0 ? 0 : 1;
+}
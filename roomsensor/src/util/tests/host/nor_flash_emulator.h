@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// File-backed NOR flash for host tests of flash-layout code (event_log_ring.h). Same contract as the
+// esp_partition wrapper in event_log.cpp:
+// - write() can only clear bits: the result is old AND new, as on the chip.
+// - erase_sector() sets a 4 KB sector to 0xFF.
+// - Power loss: cut_power_after(n) lets n more writes or erases complete. The next one is interrupted
+//   and every operation after it fails until power_on(). An interrupted write programs a random prefix
+//   and part of the bits of the following byte. An interrupted erase restores a random prefix of the
+//   sector to 0xFF, leaves the rest as it was, and scrambles one byte at the boundary.
+// The contents live in a file, so a test can reboot by constructing its code under test again, and the
+// image can be inspected after a failure.
+class NorFlashFile {
+public:
+    static constexpr uint32_t kSector = 4096;
+
+    NorFlashFile(std::string path, uint32_t size, uint32_t seed = 1)
+        : path_(std::move(path)), size_(size), rng_(seed), erase_counts_(size / kSector, 0) {
+        file_ = fopen(path_.c_str(), "w+b");
+        if (file_) format();
+    }
+    ~NorFlashFile() {
+        if (file_) fclose(file_);
+        remove(path_.c_str());
+    }
+    NorFlashFile(const NorFlashFile&) = delete;
+    NorFlashFile& operator=(const NorFlashFile&) = delete;
+
+    bool ok() const { return file_ != nullptr; }
+
+    // Every byte back to 0xFF, counters cleared
+    void format() {
+        std::vector<uint8_t> ff(size_, 0xFF);
+        put(0, ff.data(), size_);
+        std::fill(erase_counts_.begin(), erase_counts_.end(), 0);
+        bytes_written_ = 0;
+    }
+
+    bool read(uint32_t offset, void* buf, size_t len) {
+        if (!powered_ || !in_range(offset, len)) return false;
+        return get(offset, buf, len);
+    }
+
+    bool write(uint32_t offset, const void* buf, size_t len) {
+        if (!powered_ || !in_range(offset, len)) return false;
+        std::vector<uint8_t> cur(len);
+        if (!get(offset, cur.data(), len)) return false;
+        const uint8_t* src = static_cast<const uint8_t*>(buf);
+        size_t n = len;
+        const bool cut = op_cut();
+        if (cut) n = len ? rng_() % len : 0;
+        for (size_t i = 0; i < n; ++i) cur[i] &= src[i];
+        if (cut && n < len) cur[n] &= static_cast<uint8_t>(src[n] | rng_()); // some of its bits made it
+        put(offset, cur.data(), cut ? (n < len ? n + 1 : n) : len);
+        bytes_written_ += n;
+        return !cut;
+    }
+
+    bool erase_sector(uint32_t offset) {
+        if (!powered_ || offset % kSector || !in_range(offset, kSector)) return false;
+        std::vector<uint8_t> ff(kSector, 0xFF);
+        if (op_cut()) {
+            const uint32_t n = rng_() % kSector;
+            put(offset, ff.data(), n);
+            const uint8_t junk = static_cast<uint8_t>(rng_());
+            put(offset + n, &junk, 1);
+            return false;
+        }
+        put(offset, ff.data(), kSector);
+        erase_counts_[offset / kSector]++;
+        return true;
+    }
+
+    // Power fails during the (n+1)-th write or erase from now
+    void cut_power_after(uint32_t n) { ops_left_ = static_cast<int64_t>(n); }
+    void power_on() {
+        powered_ = true;
+        ops_left_ = -1;
+    }
+    bool powered() const { return powered_; }
+
+    uint32_t size() const { return size_; }
+    uint64_t bytes_written() const { return bytes_written_; }
+    const std::vector<uint32_t>& erase_counts() const { return erase_counts_; }
+
+private:
+    bool in_range(uint32_t offset, size_t len) const { return offset <= size_ && len <= size_ - offset; }
+
+    bool op_cut() {
+        if (ops_left_ < 0) return false;
+        if (ops_left_-- > 0) return false;
+        powered_ = false;
+        return true;
+    }
+
+    bool get(uint32_t offset, void* buf, size_t len) {
+        return fseek(file_, offset, SEEK_SET) == 0 && fread(buf, 1, len, file_) == len;
+    }
+    void put(uint32_t offset, const void* buf, size_t len) {
+        if (!len) return;
+        fseek(file_, offset, SEEK_SET);
+        fwrite(buf, 1, len, file_);
+        fflush(file_);
+    }
+
+    std::string path_;
+    uint32_t size_;
+    std::mt19937 rng_;
+    FILE* file_ = nullptr;
+    bool powered_ = true;
+    int64_t ops_left_ = -1;
+    uint64_t bytes_written_ = 0;
+    std::vector<uint32_t> erase_counts_;
+};
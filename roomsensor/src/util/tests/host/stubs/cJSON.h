@@ -0,0 +1,338 @@
+#pragma once
+
+// Host stand-in for the cJSON calls the configuration component makes: building and printing objects,
+// and parsing a document (objects, arrays, strings, numbers, true/false/null). Same struct layout and
+// type bits as cJSON; object lookup is case-insensitive like cJSON_GetObjectItem. cJSON_Print does not
+// indent. Not a validator: escapes beyond \uXXXX in the Basic Multilingual Plane are not decoded.
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <string>
+
+#define cJSON_Invalid 0
+#define cJSON_False (1 << 0)
+#define cJSON_True (1 << 1)
+#define cJSON_NULL (1 << 2)
+#define cJSON_Number (1 << 3)
+#define cJSON_String (1 << 4)
+#define cJSON_Array (1 << 5)
+#define cJSON_Object (1 << 6)
+
+typedef struct cJSON {
+    struct cJSON* next;
+    struct cJSON* prev;
+    struct cJSON* child;
+    int type;
+    char* valuestring;
+    int valueint;
+    double valuedouble;
+    char* string;
+} cJSON;
+
+#define cJSON_ArrayForEach(element, array) \
+    for (element = (array != NULL) ? (array)->child : NULL; element != NULL; element = element->next)
+
+inline cJSON* host_cjson_new(int type) {
+    cJSON* item = static_cast<cJSON*>(calloc(1, sizeof(cJSON)));
+    item->type = type;
+    return item;
+}
+
+// valueint saturates like cJSON's
+inline int host_cjson_int(double d) {
+    if (isnan(d)) return 0;
+    if (d >= 2147483647.0) return 2147483647;
+    if (d <= -2147483648.0) return -2147483647 - 1;
+    return (int)d;
+}
+
+inline void cJSON_Delete(cJSON* item) {
+    while (item) {
+        cJSON* next = item->next;
+        cJSON_Delete(item->child);
+        free(item->valuestring);
+        free(item->string);
+        free(item);
+        item = next;
+    }
+}
+
+inline void cJSON_free(void* p) { free(p); }
+
+inline cJSON* cJSON_CreateObject(void) { return host_cjson_new(cJSON_Object); }
+inline cJSON* cJSON_CreateArray(void) { return host_cjson_new(cJSON_Array); }
+inline cJSON* cJSON_CreateNull(void) { return host_cjson_new(cJSON_NULL); }
+inline cJSON* cJSON_CreateBool(int b) { return host_cjson_new(b ? cJSON_True : cJSON_False); }
+inline cJSON* cJSON_CreateNumber(double d) {
+    cJSON* item = host_cjson_new(cJSON_Number);
+    item->valuedouble = d;
+    item->valueint = host_cjson_int(d);
+    return item;
+}
+inline cJSON* cJSON_CreateString(const char* s) {
+    cJSON* item = host_cjson_new(cJSON_String);
+    item->valuestring = strdup(s ? s : "");
+    return item;
+}
+
+inline int cJSON_AddItemToArray(cJSON* array, cJSON* item) {
+    if (!array || !item) return 0;
+    if (!array->child) {
+        array->child = item;
+        item->prev = item;
+        return 1;
+    }
+    cJSON* last = array->child->prev; // cJSON keeps the tail in child->prev
+    last->next = item;
+    item->prev = last;
+    array->child->prev = item;
+    return 1;
+}
+
+inline int cJSON_AddItemToObject(cJSON* object, const char* key, cJSON* item) {
+    if (!object || !key || !item) return 0;
+    free(item->string);
+    item->string = strdup(key);
+    return cJSON_AddItemToArray(object, item);
+}
+
+inline cJSON* host_cjson_add(cJSON* object, const char* key, cJSON* item) {
+    if (cJSON_AddItemToObject(object, key, item)) return item;
+    cJSON_Delete(item);
+    return NULL;
+}
+inline cJSON* cJSON_AddStringToObject(cJSON* o, const char* k, const char* s) { return host_cjson_add(o, k, cJSON_CreateString(s)); }
+inline cJSON* cJSON_AddNumberToObject(cJSON* o, const char* k, double d) { return host_cjson_add(o, k, cJSON_CreateNumber(d)); }
+inline cJSON* cJSON_AddBoolToObject(cJSON* o, const char* k, int b) { return host_cjson_add(o, k, cJSON_CreateBool(b)); }
+inline cJSON* cJSON_AddNullToObject(cJSON* o, const char* k) { return host_cjson_add(o, k, cJSON_CreateNull()); }
+inline cJSON* cJSON_AddObjectToObject(cJSON* o, const char* k) { return host_cjson_add(o, k, cJSON_CreateObject()); }
+inline cJSON* cJSON_AddArrayToObject(cJSON* o, const char* k) { return host_cjson_add(o, k, cJSON_CreateArray()); }
+
+inline cJSON* cJSON_GetObjectItem(const cJSON* object, const char* key) {
+    if (!object || !key) return NULL;
+    for (cJSON* c = object->child; c; c = c->next) {
+        if (c->string && strcasecmp(c->string, key) == 0) return c;
+    }
+    return NULL;
+}
+
+inline int cJSON_IsInvalid(const cJSON* i) { return i && (i->type & 0xFF) == cJSON_Invalid; }
+inline int cJSON_IsFalse(const cJSON* i) { return i && (i->type & 0xFF) == cJSON_False; }
+inline int cJSON_IsTrue(const cJSON* i) { return i && (i->type & 0xFF) == cJSON_True; }
+inline int cJSON_IsBool(const cJSON* i) { return i && (i->type & (cJSON_True | cJSON_False)) != 0; }
+inline int cJSON_IsNull(const cJSON* i) { return i && (i->type & 0xFF) == cJSON_NULL; }
+inline int cJSON_IsNumber(const cJSON* i) { return i && (i->type & 0xFF) == cJSON_Number; }
+inline int cJSON_IsString(const cJSON* i) { return i && (i->type & 0xFF) == cJSON_String; }
+inline int cJSON_IsArray(const cJSON* i) { return i && (i->type & 0xFF) == cJSON_Array; }
+inline int cJSON_IsObject(const cJSON* i) { return i && (i->type & 0xFF) == cJSON_Object; }
+
+// ---- printing ----
+
+inline void host_cjson_print_string(std::string& out, const char* s) {
+    out += '"';
+    for (; s && *s; ++s) {
+        const unsigned char c = static_cast<unsigned char>(*s);
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            default:
+                if (c < 0x20) {
+                    char esc[8];
+                    snprintf(esc, sizeof(esc), "\\u%04x", c);
+                    out += esc;
+                } else {
+                    out += static_cast<char>(c);
+                }
+        }
+    }
+    out += '"';
+}
+
+inline void host_cjson_print(std::string& out, const cJSON* item) {
+    switch (item->type & 0xFF) {
+        case cJSON_False: out += "false"; break;
+        case cJSON_True: out += "true"; break;
+        case cJSON_NULL: out += "null"; break;
+        case cJSON_Number: {
+            char num[32];
+            const double d = item->valuedouble;
+            if (isnan(d) || isinf(d)) {
+                snprintf(num, sizeof(num), "null");
+            } else if (d == (double)item->valueint) {
+                snprintf(num, sizeof(num), "%d", item->valueint);
+            } else {
+                // Shortest of 15/17 digits that reads back exactly, as cJSON does
+                snprintf(num, sizeof(num), "%1.15g", d);
+                if (strtod(num, NULL) != d) snprintf(num, sizeof(num), "%1.17g", d);
+            }
+            out += num;
+            break;
+        }
+        case cJSON_String: host_cjson_print_string(out, item->valuestring); break;
+        case cJSON_Array:
+        case cJSON_Object: {
+            const bool obj = (item->type & 0xFF) == cJSON_Object;
+            out += obj ? '{' : '[';
+            for (const cJSON* c = item->child; c; c = c->next) {
+                if (c != item->child) out += ',';
+                if (obj) {
+                    host_cjson_print_string(out, c->string);
+                    out += ':';
+                }
+                host_cjson_print(out, c);
+            }
+            out += obj ? '}' : ']';
+            break;
+        }
+        default: break;
+    }
+}
+
+inline char* cJSON_PrintUnformatted(const cJSON* item) {
+    if (!item) return NULL;
+    std::string out;
+    host_cjson_print(out, item);
+    return strdup(out.c_str());
+}
+
+inline char* cJSON_Print(const cJSON* item) { return cJSON_PrintUnformatted(item); }
+
+// Fails rather than truncates when the text and its terminator do not fit, like cJSON
+inline int cJSON_PrintPreallocated(cJSON* item, char* buffer, const int length, const int format) {
+    if (!item || !buffer || length <= 0) return 0;
+    std::string out;
+    host_cjson_print(out, item);
+    if (out.size() + 1 > static_cast<size_t>(length)) return 0;
+    memcpy(buffer, out.c_str(), out.size() + 1);
+    return 1;
+}
+
+// ---- parsing ----
+
+inline const char* host_cjson_skip(const char* p) {
+    while (*p && isspace(static_cast<unsigned char>(*p))) ++p;
+    return p;
+}
+
+inline const char* host_cjson_parse_value(cJSON* item, const char* p, int depth);
+
+inline const char* host_cjson_parse_string(char** out, const char* p) {
+    if (*p != '"') return NULL;
+    std::string s;
+    for (++p; *p != '"'; ++p) {
+        if (*p == '\0') return NULL;
+        if (*p != '\\') {
+            s += *p;
+            continue;
+        }
+        switch (*++p) {
+            case '"': s += '"'; break;
+            case '\\': s += '\\'; break;
+            case '/': s += '/'; break;
+            case 'b': s += '\b'; break;
+            case 'f': s += '\f'; break;
+            case 'n': s += '\n'; break;
+            case 'r': s += '\r'; break;
+            case 't': s += '\t'; break;
+            case 'u': {
+                unsigned cp = 0;
+                for (int i = 0; i < 4; ++i) {
+                    const char h = *++p;
+                    if (!isxdigit(static_cast<unsigned char>(h))) return NULL;
+                    cp = cp * 16 + (unsigned)(isdigit(static_cast<unsigned char>(h)) ? h - '0' : (tolower(h) - 'a' + 10));
+                }
+                if (cp < 0x80) {
+                    s += static_cast<char>(cp);
+                } else if (cp < 0x800) {
+                    s += static_cast<char>(0xC0 | (cp >> 6));
+                    s += static_cast<char>(0x80 | (cp & 0x3F));
+                } else {
+                    s += static_cast<char>(0xE0 | (cp >> 12));
+                    s += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                    s += static_cast<char>(0x80 | (cp & 0x3F));
+                }
+                break;
+            }
+            default: return NULL;
+        }
+    }
+    *out = strdup(s.c_str());
+    return p + 1;
+}
+
+inline const char* host_cjson_parse_container(cJSON* item, const char* p, int depth, bool obj) {
+    item->type = obj ? cJSON_Object : cJSON_Array;
+    p = host_cjson_skip(p + 1);
+    if (*p == (obj ? '}' : ']')) return p + 1;
+    while (true) {
+        cJSON* child = host_cjson_new(cJSON_Invalid);
+        cJSON_AddItemToArray(item, child);
+        if (obj) {
+            p = host_cjson_parse_string(&child->string, host_cjson_skip(p));
+            if (!p) return NULL;
+            p = host_cjson_skip(p);
+            if (*p != ':') return NULL;
+            ++p;
+        }
+        p = host_cjson_parse_value(child, host_cjson_skip(p), depth + 1);
+        if (!p) return NULL;
+        p = host_cjson_skip(p);
+        if (*p == ',') {
+            ++p;
+            continue;
+        }
+        if (*p == (obj ? '}' : ']')) return p + 1;
+        return NULL;
+    }
+}
+
+inline const char* host_cjson_parse_value(cJSON* item, const char* p, int depth) {
+    if (depth > 1000) return NULL; // CJSON_NESTING_LIMIT
+    if (strncmp(p, "null", 4) == 0) {
+        item->type = cJSON_NULL;
+        return p + 4;
+    }
+    if (strncmp(p, "false", 5) == 0) {
+        item->type = cJSON_False;
+        return p + 5;
+    }
+    if (strncmp(p, "true", 4) == 0) {
+        item->type = cJSON_True;
+        item->valueint = 1;
+        return p + 4;
+    }
+    if (*p == '"') {
+        item->type = cJSON_String;
+        return host_cjson_parse_string(&item->valuestring, p);
+    }
+    if (*p == '-' || isdigit(static_cast<unsigned char>(*p))) {
+        char* end = NULL;
+        const double d = strtod(p, &end);
+        if (end == p) return NULL;
+        item->type = cJSON_Number;
+        item->valuedouble = d;
+        item->valueint = host_cjson_int(d);
+        return end;
+    }
+    if (*p == '{' || *p == '[') return host_cjson_parse_container(item, p, depth, *p == '{');
+    return NULL;
+}
+
+inline cJSON* cJSON_Parse(const char* text) {
+    if (!text) return NULL;
+    cJSON* root = host_cjson_new(cJSON_Invalid);
+    const char* end = host_cjson_parse_value(root, host_cjson_skip(text), 0);
+    if (!end) {
+        cJSON_Delete(root);
+        return NULL;
+    }
+    return root;
+}
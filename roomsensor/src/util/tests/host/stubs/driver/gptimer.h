@@ -0,0 +1,71 @@
+#pragma once
+
+// Host stand-in for general-purpose timers: nothing counts. The last registered alarm callback is kept in
+// host_gptimer::on_alarm so a test can raise the interrupt itself, from whichever thread plays the core.
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+struct host_gptimer_t {
+    bool running;
+};
+typedef host_gptimer_t* gptimer_handle_t;
+
+typedef enum { GPTIMER_CLK_SRC_DEFAULT = 0 } gptimer_clock_source_t;
+typedef enum { GPTIMER_COUNT_DOWN, GPTIMER_COUNT_UP } gptimer_count_direction_t;
+
+typedef struct {
+    gptimer_clock_source_t clk_src;
+    gptimer_count_direction_t direction;
+    uint32_t resolution_hz;
+} gptimer_config_t;
+
+typedef struct {
+    uint64_t count_value;
+    uint64_t alarm_value;
+} gptimer_alarm_event_data_t;
+
+typedef bool (*gptimer_alarm_cb_t)(gptimer_handle_t timer, const gptimer_alarm_event_data_t* edata, void* user_ctx);
+
+typedef struct {
+    gptimer_alarm_cb_t on_alarm;
+} gptimer_event_callbacks_t;
+
+typedef struct {
+    uint64_t alarm_count;
+    uint64_t reload_count;
+    struct {
+        uint32_t auto_reload_on_alarm : 1;
+    } flags;
+} gptimer_alarm_config_t;
+
+namespace host_gptimer {
+inline gptimer_alarm_cb_t on_alarm = nullptr;
+inline int live = 0; // timers created and not yet deleted
+} // namespace host_gptimer
+
+inline esp_err_t gptimer_new_timer(const gptimer_config_t*, gptimer_handle_t* out) {
+    *out = new host_gptimer_t{false};
+    host_gptimer::live++;
+    return ESP_OK;
+}
+inline esp_err_t gptimer_register_event_callbacks(gptimer_handle_t, const gptimer_event_callbacks_t* cbs, void*) {
+    host_gptimer::on_alarm = cbs->on_alarm;
+    return ESP_OK;
+}
+inline esp_err_t gptimer_set_alarm_action(gptimer_handle_t, const gptimer_alarm_config_t*) { return ESP_OK; }
+inline esp_err_t gptimer_enable(gptimer_handle_t) { return ESP_OK; }
+inline esp_err_t gptimer_disable(gptimer_handle_t) { return ESP_OK; }
+inline esp_err_t gptimer_start(gptimer_handle_t t) {
+    t->running = true;
+    return ESP_OK;
+}
+inline esp_err_t gptimer_stop(gptimer_handle_t t) {
+    t->running = false;
+    return ESP_OK;
+}
+inline esp_err_t gptimer_del_timer(gptimer_handle_t t) {
+    delete t;
+    host_gptimer::live--;
+    return ESP_OK;
+}
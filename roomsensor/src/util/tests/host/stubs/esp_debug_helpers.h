@@ -0,0 +1,15 @@
+#pragma once
+
+// Host stand-in: the backtrace frame type. esp_backtrace_get_next_frame() is left to the test, which
+// decides what stack there is to walk.
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    uint32_t pc;
+    uint32_t sp;
+    uint32_t next_pc;
+    const void* exc_frame;
+} esp_backtrace_frame_t;
+
+bool esp_backtrace_get_next_frame(esp_backtrace_frame_t* frame);
@@ -0,0 +1,15 @@
+#pragma once
+
+// Host stand-in: capability allocations come from the C heap
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+
+static inline void* heap_caps_malloc(size_t size, uint32_t) { return malloc(size); }
+static inline void* heap_caps_calloc(size_t n, size_t size, uint32_t) { return calloc(n, size); }
+static inline void heap_caps_free(void* p) { free(p); }
@@ -0,0 +1,12 @@
+#pragma once
+
+// Host stand-in: the call runs on the calling thread
+#include "esp_err.h"
+#include <stdint.h>
+
+typedef void (*esp_ipc_func_t)(void* arg);
+
+inline esp_err_t esp_ipc_call_blocking(uint32_t, esp_ipc_func_t func, void* arg) {
+    func(arg);
+    return ESP_OK;
+}
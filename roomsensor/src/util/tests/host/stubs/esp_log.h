@@ -0,0 +1,25 @@
+#pragma once
+
+// Host stand-in: errors and warnings go to stderr; info and below are type-checked and dropped
+#include <stdio.h>
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+inline void esp_log_level_set(const char*, esp_log_level_t) {}
+
+#define ESP_LOGE(tag, fmt, ...) fprintf(stderr, "E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) fprintf(stderr, "W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define HOST_LOG_DROP(tag, fmt, ...)                                  \
+    do {                                                              \
+        if (0) fprintf(stderr, "%s: " fmt "\n", tag, ##__VA_ARGS__); \
+    } while (0)
+#define ESP_LOGI(tag, fmt, ...) HOST_LOG_DROP(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) HOST_LOG_DROP(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...) HOST_LOG_DROP(tag, fmt, ##__VA_ARGS__)
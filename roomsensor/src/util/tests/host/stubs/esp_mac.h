@@ -0,0 +1,13 @@
+#pragma once
+
+// Host stand-in: a fixed MAC (Espressif OUI), the same for every interface
+#include "esp_err.h"
+#include <stdint.h>
+
+typedef enum { ESP_MAC_WIFI_STA, ESP_MAC_WIFI_SOFTAP, ESP_MAC_BT, ESP_MAC_ETH } esp_mac_type_t;
+
+inline esp_err_t esp_read_mac(uint8_t* mac, esp_mac_type_t) {
+    static const uint8_t kMac[6] = {0x24, 0x0A, 0xC4, 0x12, 0x34, 0x56};
+    for (int i = 0; i < 6; ++i) mac[i] = kMac[i];
+    return ESP_OK;
+}
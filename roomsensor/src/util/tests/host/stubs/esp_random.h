@@ -0,0 +1,17 @@
+#pragma once
+
+// Host stand-in: a reseedable xorshift sequence, so two pattern instances can be given the same draws
+#include <stdint.h>
+
+inline uint32_t& host_random_state() {
+    static uint32_t s = 0x12345678u;
+    return s;
+}
+inline void host_random_seed(uint32_t seed) { host_random_state() = seed ? seed : 1u; }
+inline uint32_t esp_random() {
+    uint32_t& x = host_random_state();
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
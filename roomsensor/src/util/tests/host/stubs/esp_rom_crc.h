@@ -0,0 +1,14 @@
+#pragma once
+
+// Host stand-in for the ROM CRC-32 (IEEE 802.3, reflected), with the ROM's convention of inverting on
+// entry and exit so calls can be chained
+#include <stdint.h>
+
+inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *buf++;
+        for (int i = 0; i < 8; ++i) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
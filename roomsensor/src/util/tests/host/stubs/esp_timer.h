@@ -0,0 +1,60 @@
+#pragma once
+
+// Host stand-in: microseconds on the steady clock. One-shot timers only record their start; a test fires
+// them with host_esp_timer_fire() (host_esp_timer_last() for one the code under test keeps to itself).
+#include "esp_err.h"
+#include <chrono>
+#include <cstdint>
+
+inline int64_t esp_timer_get_time() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+typedef void (*esp_timer_cb_t)(void* arg);
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void* arg;
+    int dispatch_method;
+    const char* name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+struct host_esp_timer {
+    esp_timer_cb_t callback;
+    void* arg;
+    bool armed;
+    uint64_t timeout_us;
+};
+typedef host_esp_timer* esp_timer_handle_t;
+
+inline esp_timer_handle_t& host_esp_timer_last() {
+    static esp_timer_handle_t t = nullptr;
+    return t;
+}
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out) {
+    *out = new host_esp_timer{args->callback, args->arg, false, 0};
+    host_esp_timer_last() = *out;
+    return ESP_OK;
+}
+inline esp_err_t esp_timer_start_once(esp_timer_handle_t t, uint64_t timeout_us) {
+    if (t->armed) return ESP_ERR_INVALID_STATE;
+    t->armed = true;
+    t->timeout_us = timeout_us;
+    return ESP_OK;
+}
+inline esp_err_t esp_timer_stop(esp_timer_handle_t t) {
+    if (!t->armed) return ESP_ERR_INVALID_STATE;
+    t->armed = false;
+    return ESP_OK;
+}
+
+// Run an armed one-shot timer's callback now, as the esp_timer task would when it expires
+inline bool host_esp_timer_fire(esp_timer_handle_t t) {
+    if (!t || !t->armed) return false;
+    t->armed = false;
+    t->callback(t->arg);
+    return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+// Host stand-in for the FreeRTOS pieces the code under test uses (instrumented_lock.cpp, the LED strip
+// adapter, the metrics and alarm tasks), on std::thread. C++ only.
+// Tasks are threads that named themselves with host_task_enter(); a tick is one millisecond; critical
+// sections are a plain mutex per portMUX_TYPE. Priorities are recorded, not scheduled on; no priority
+// inheritance; nothing runs in an ISR.
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define portMAX_DELAY UINT32_MAX
+#define pdMS_TO_TICKS(ms) static_cast<TickType_t>(ms)
+
+struct portMUX_TYPE {
+    std::mutex m;
+};
+#define portMUX_INITIALIZER_UNLOCKED {}
+#define taskENTER_CRITICAL(mux) (mux)->m.lock()
+#define taskEXIT_CRITICAL(mux) (mux)->m.unlock()
+
+#define portNUM_PROCESSORS 2
+#define configMAX_TASK_NAME_LEN 16
+#define portENTER_CRITICAL(mux) taskENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL(mux) taskEXIT_CRITICAL(mux)
+#define portENTER_CRITICAL_ISR(mux) taskENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_ISR(mux) taskEXIT_CRITICAL(mux)
+
+inline bool xPortInIsrContext() { return false; }
+#define portYIELD_FROM_ISR()
+
+// Core the calling thread runs on, as xPortGetCoreID() reports it; tests may move a thread
+inline int& host_core_id() {
+    static thread_local int core = 0;
+    return core;
+}
+inline int xPortGetCoreID() { return host_core_id(); }
+
+struct host_task {
+    void* top_of_stack = nullptr; // pxTopOfStack: first in the TCB, as code reading a task's saved frame expects
+    const char* name = nullptr;
+    UBaseType_t priority = 0;
+
+    host_task() = default;
+    host_task(const char* n, UBaseType_t p) : name(n), priority(p) {}
+};
+typedef host_task* TaskHandle_t;
+
+inline TaskHandle_t& host_current_task() {
+    static thread_local TaskHandle_t t = nullptr;
+    return t;
+}
+
+// Name the calling thread as a task; task must outlive the thread's use of FreeRTOS calls
+inline void host_task_enter(host_task* task) { host_current_task() = task; }
@@ -0,0 +1,54 @@
+#pragma once
+
+// Host stand-in for event groups on a mutex and condition variable
+#include "freertos/FreeRTOS.h"
+#include <condition_variable>
+
+typedef uint32_t EventBits_t;
+
+#ifndef BIT0
+#define BIT0 0x00000001u
+#define BIT1 0x00000002u
+#define BIT2 0x00000004u
+#define BIT3 0x00000008u
+#endif
+
+struct StaticEventGroup_t {
+    std::mutex m;
+    std::condition_variable cv;
+    EventBits_t bits = 0;
+};
+typedef StaticEventGroup_t* EventGroupHandle_t;
+
+inline EventGroupHandle_t xEventGroupCreateStatic(StaticEventGroup_t* storage) { return storage; }
+
+inline EventBits_t xEventGroupGetBits(EventGroupHandle_t g) {
+    std::lock_guard<std::mutex> lock(g->m);
+    return g->bits;
+}
+
+inline EventBits_t xEventGroupSetBits(EventGroupHandle_t g, EventBits_t bits) {
+    std::lock_guard<std::mutex> lock(g->m);
+    g->bits |= bits;
+    g->cv.notify_all();
+    return g->bits;
+}
+
+inline EventBits_t xEventGroupClearBits(EventGroupHandle_t g, EventBits_t bits) {
+    std::lock_guard<std::mutex> lock(g->m);
+    EventBits_t before = g->bits;
+    g->bits &= ~bits;
+    return before;
+}
+
+// Returns the bits at the time the wait ended (before clearing, like FreeRTOS)
+inline EventBits_t xEventGroupWaitBits(EventGroupHandle_t g, EventBits_t bits, BaseType_t clear_on_exit,
+                                       BaseType_t wait_for_all, TickType_t ticks) {
+    std::unique_lock<std::mutex> lock(g->m);
+    auto done = [&] { return wait_for_all ? (g->bits & bits) == bits : (g->bits & bits) != 0; };
+    if (ticks == portMAX_DELAY) g->cv.wait(lock, done);
+    else g->cv.wait_for(lock, std::chrono::milliseconds(ticks), done);
+    EventBits_t seen = g->bits;
+    if (done() && clear_on_exit) g->bits &= ~bits;
+    return seen;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+// Host stand-in for FreeRTOS queues: fixed-size items copied in and out under a mutex, FIFO, with the
+// same full/empty and timeout behaviour. The FromISR variant is the plain send.
+#include "freertos/FreeRTOS.h"
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+struct host_queue {
+    std::mutex m;
+    std::condition_variable cv;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    std::deque<std::vector<uint8_t>> items;
+};
+typedef host_queue* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    QueueHandle_t q = new host_queue;
+    q->length = length;
+    q->item_size = item_size;
+    return q;
+}
+inline void vQueueDelete(QueueHandle_t q) { delete q; }
+
+inline BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t ticks) {
+    std::unique_lock<std::mutex> lock(q->m);
+    auto room = [&] { return q->items.size() < q->length; };
+    if (ticks == portMAX_DELAY) q->cv.wait(lock, room);
+    else q->cv.wait_for(lock, std::chrono::milliseconds(ticks), room);
+    if (!room()) return pdFALSE;
+    const uint8_t* p = static_cast<const uint8_t*>(item);
+    q->items.emplace_back(p, p + q->item_size);
+    q->cv.notify_all();
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueSendFromISR(QueueHandle_t q, const void* item, BaseType_t* woken) {
+    if (woken) *woken = pdFALSE;
+    return xQueueSend(q, item, 0);
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t q, void* out, TickType_t ticks) {
+    std::unique_lock<std::mutex> lock(q->m);
+    auto ready = [&] { return !q->items.empty(); };
+    if (ticks == portMAX_DELAY) q->cv.wait(lock, ready);
+    else q->cv.wait_for(lock, std::chrono::milliseconds(ticks), ready);
+    if (!ready()) return pdFALSE;
+    memcpy(out, q->items.front().data(), q->item_size);
+    q->items.pop_front();
+    q->cv.notify_all();
+    return pdTRUE;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+    std::lock_guard<std::mutex> lock(q->m);
+    return static_cast<UBaseType_t>(q->items.size());
+}
+inline UBaseType_t uxQueueSpacesAvailable(QueueHandle_t q) {
+    std::lock_guard<std::mutex> lock(q->m);
+    return q->length - static_cast<UBaseType_t>(q->items.size());
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include <atomic>
+
+struct host_mutex {
+    std::timed_mutex m;
+    std::atomic<TaskHandle_t> holder{nullptr};
+};
+typedef host_mutex* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return new host_mutex; }
+inline void vSemaphoreDelete(SemaphoreHandle_t s) { delete s; }
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks) {
+    bool ok;
+    if (ticks == 0) ok = s->m.try_lock();
+    else if (ticks == portMAX_DELAY) ok = (s->m.lock(), true);
+    else ok = s->m.try_lock_for(std::chrono::milliseconds(ticks));
+    if (ok) s->holder.store(host_current_task());
+    return ok ? pdTRUE : pdFALSE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+    s->holder.store(nullptr);
+    s->m.unlock();
+    return pdTRUE;
+}
+
+inline TaskHandle_t xSemaphoreGetMutexHolder(SemaphoreHandle_t s) { return s->holder.load(); }
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include <thread>
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { return host_current_task(); }
+inline const char* pcTaskGetName(TaskHandle_t t) { return t ? t->name : "main"; }
+inline UBaseType_t uxTaskPriorityGet(TaskHandle_t t) { return t ? t->priority : 1; }
+inline TaskHandle_t xTaskGetIdleTaskHandleForCore(int core) {
+    static host_task idle[portNUM_PROCESSORS] = {{"IDLE0", 0}, {"IDLE1", 0}};
+    return &idle[core];
+}
+inline void vTaskDelay(TickType_t ticks) { std::this_thread::sleep_for(std::chrono::milliseconds(ticks)); }
+
+// A detached thread running fn(arg) as a task; the task record is never freed, like a task that never exits
+inline BaseType_t xTaskCreate(void (*fn)(void*), const char* name, uint32_t stack, void* arg, UBaseType_t priority,
+                              TaskHandle_t* out) {
+    host_task* task = new host_task{name, priority};
+    if (out) *out = task;
+    std::thread([=] {
+        host_task_enter(task);
+        fn(arg);
+    }).detach();
+    return pdPASS;
+}
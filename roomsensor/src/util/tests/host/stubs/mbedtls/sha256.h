@@ -0,0 +1,24 @@
+#pragma once
+
+// Host stand-in for the mbedtls streaming SHA-256 calls, over OpenSSL's EVP digests
+#include <openssl/evp.h>
+#include <stddef.h>
+
+typedef struct {
+    EVP_MD_CTX* ctx;
+} mbedtls_sha256_context;
+
+static inline void mbedtls_sha256_init(mbedtls_sha256_context* c) { c->ctx = EVP_MD_CTX_new(); }
+static inline int mbedtls_sha256_starts(mbedtls_sha256_context* c, int is224) {
+    return EVP_DigestInit_ex(c->ctx, is224 ? EVP_sha224() : EVP_sha256(), NULL) == 1 ? 0 : -1;
+}
+static inline int mbedtls_sha256_update(mbedtls_sha256_context* c, const unsigned char* data, size_t len) {
+    return EVP_DigestUpdate(c->ctx, data, len) == 1 ? 0 : -1;
+}
+static inline int mbedtls_sha256_finish(mbedtls_sha256_context* c, unsigned char out[32]) {
+    return EVP_DigestFinal_ex(c->ctx, out, NULL) == 1 ? 0 : -1;
+}
+static inline void mbedtls_sha256_free(mbedtls_sha256_context* c) {
+    EVP_MD_CTX_free(c->ctx);
+    c->ctx = NULL;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// Host stand-in for the ROM miniz inflater: the tinfl calls ota_inflate.cpp makes, over the system zlib.
+// zlib keeps its own dictionary, so the caller's circular window is only used as the output buffer.
+#include <string.h>
+#include <zlib.h>
+
+#define TINFL_LZ_DICT_SIZE 32768
+#define TINFL_FLAG_PARSE_ZLIB_HEADER 1
+#define TINFL_FLAG_HAS_MORE_INPUT 2
+
+typedef enum {
+    TINFL_STATUS_BAD_PARAM = -3,
+    TINFL_STATUS_ADLER32_MISMATCH = -2,
+    TINFL_STATUS_FAILED = -1,
+    TINFL_STATUS_DONE = 0,
+    TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+    TINFL_STATUS_HAS_MORE_OUTPUT = 2,
+} tinfl_status;
+
+typedef struct {
+    z_stream z;
+    bool open;
+    bool ended;
+} tinfl_decompressor;
+
+#define tinfl_init(r) memset((r), 0, sizeof(*(r)))
+
+// The zlib state is released when the stream ends or fails; a truncated stream keeps it (test-only leak)
+static inline tinfl_status tinfl_decompress(tinfl_decompressor* r, const unsigned char* in, size_t* in_size,
+                                            unsigned char*, unsigned char* out, size_t* out_size, int) {
+    if (r->ended) return TINFL_STATUS_FAILED;
+    if (!r->open) {
+        if (inflateInit(&r->z) != Z_OK) return TINFL_STATUS_BAD_PARAM;
+        r->open = true;
+    }
+    r->z.next_in = (Bytef*)in;
+    r->z.avail_in = (uInt)*in_size;
+    r->z.next_out = out;
+    r->z.avail_out = (uInt)*out_size;
+    int rc = inflate(&r->z, Z_NO_FLUSH);
+    *in_size -= r->z.avail_in;
+    *out_size -= r->z.avail_out;
+    if (rc == Z_STREAM_END || (rc != Z_OK && rc != Z_BUF_ERROR)) {
+        inflateEnd(&r->z);
+        r->ended = true;
+        return rc == Z_STREAM_END ? TINFL_STATUS_DONE : TINFL_STATUS_FAILED;
+    }
+    return r->z.avail_out == 0 ? TINFL_STATUS_HAS_MORE_OUTPUT : TINFL_STATUS_NEEDS_MORE_INPUT;
+}
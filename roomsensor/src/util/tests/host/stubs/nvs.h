@@ -0,0 +1,148 @@
+#pragma once
+
+// Host stand-in for NVS: namespaces of typed entries in memory, shared by every handle in the process.
+// Like the real thing, an entry is found by key and type, a read-only open of a namespace that was never
+// written fails with ESP_ERR_NVS_NOT_FOUND, and keys are limited to 15 characters. Commit is a no-op.
+// host_nvs:: gives tests the raw entries (to corrupt or drop them) and counts reads.
+#include "esp_err.h"
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#define ESP_ERR_NVS_BASE 0x1100
+#define ESP_ERR_NVS_NOT_FOUND (ESP_ERR_NVS_BASE + 0x02)
+#define ESP_ERR_NVS_READ_ONLY (ESP_ERR_NVS_BASE + 0x04)
+#define ESP_ERR_NVS_INVALID_HANDLE (ESP_ERR_NVS_BASE + 0x07)
+#define ESP_ERR_NVS_KEY_TOO_LONG (ESP_ERR_NVS_BASE + 0x09)
+#define ESP_ERR_NVS_INVALID_LENGTH (ESP_ERR_NVS_BASE + 0x0c)
+#define ESP_ERR_NVS_VALUE_TOO_LONG (ESP_ERR_NVS_BASE + 0x0e)
+
+#define NVS_KEY_NAME_MAX_SIZE 16
+
+typedef uint32_t nvs_handle_t;
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+namespace host_nvs {
+
+enum Kind : char { U8 = 'B', I32 = 'i', U32 = 'I', I64 = 'l', STR = 's', BLOB = 'b' };
+
+struct Entry {
+    Kind kind;
+    std::vector<uint8_t> bytes; // strings include the terminator
+};
+
+using Namespace = std::map<std::string, Entry>;
+
+inline std::map<std::string, Namespace>& store() {
+    static std::map<std::string, Namespace> s;
+    return s;
+}
+
+struct Handle {
+    std::string ns;
+    bool writable;
+};
+
+inline std::vector<Handle>& handles() {
+    static std::vector<Handle> h;
+    return h;
+}
+
+inline uint32_t& read_count() {
+    static uint32_t n = 0;
+    return n;
+}
+
+inline void clear() { store().clear(); }
+
+// nullptr if ns/key does not exist
+inline Entry* find(const char* ns, const char* key) {
+    auto n = store().find(ns);
+    if (n == store().end()) return nullptr;
+    auto e = n->second.find(key);
+    return e == n->second.end() ? nullptr : &e->second;
+}
+
+inline Namespace* ns_of(nvs_handle_t h) {
+    if (h == 0 || h > handles().size()) return nullptr;
+    return &store()[handles()[h - 1].ns];
+}
+
+inline esp_err_t get(nvs_handle_t h, const char* key, Kind kind, void* out, size_t* len) {
+    Namespace* ns = ns_of(h);
+    if (!ns) return ESP_ERR_NVS_INVALID_HANDLE;
+    ++read_count();
+    auto e = ns->find(key);
+    if (e == ns->end() || e->second.kind != kind) return ESP_ERR_NVS_NOT_FOUND;
+    const std::vector<uint8_t>& b = e->second.bytes;
+    if (!len) { // fixed-size integer
+        memcpy(out, b.data(), b.size());
+        return ESP_OK;
+    }
+    if (out) {
+        if (*len < b.size()) return ESP_ERR_NVS_INVALID_LENGTH;
+        memcpy(out, b.data(), b.size());
+    }
+    *len = b.size();
+    return ESP_OK;
+}
+
+inline esp_err_t set(nvs_handle_t h, const char* key, Kind kind, const void* data, size_t len) {
+    Namespace* ns = ns_of(h);
+    if (!ns) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (!handles()[h - 1].writable) return ESP_ERR_NVS_READ_ONLY;
+    if (strlen(key) >= NVS_KEY_NAME_MAX_SIZE) return ESP_ERR_NVS_KEY_TOO_LONG;
+    if (kind == STR && len > 4000) return ESP_ERR_NVS_VALUE_TOO_LONG;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    (*ns)[key] = Entry{kind, std::vector<uint8_t>(p, p + len)};
+    return ESP_OK;
+}
+
+} // namespace host_nvs
+
+inline esp_err_t nvs_open(const char* name, nvs_open_mode_t mode, nvs_handle_t* out) {
+    if (mode == NVS_READONLY && host_nvs::store().count(name) == 0) return ESP_ERR_NVS_NOT_FOUND;
+    host_nvs::store()[name];
+    host_nvs::handles().push_back({name, mode == NVS_READWRITE});
+    *out = static_cast<nvs_handle_t>(host_nvs::handles().size());
+    return ESP_OK;
+}
+inline void nvs_close(nvs_handle_t) {}
+inline esp_err_t nvs_commit(nvs_handle_t h) { return host_nvs::ns_of(h) ? ESP_OK : ESP_ERR_NVS_INVALID_HANDLE; }
+
+inline esp_err_t nvs_get_str(nvs_handle_t h, const char* k, char* out, size_t* len) {
+    return host_nvs::get(h, k, host_nvs::STR, out, len);
+}
+inline esp_err_t nvs_set_str(nvs_handle_t h, const char* k, const char* v) {
+    return host_nvs::set(h, k, host_nvs::STR, v, strlen(v) + 1);
+}
+inline esp_err_t nvs_get_blob(nvs_handle_t h, const char* k, void* out, size_t* len) {
+    return host_nvs::get(h, k, host_nvs::BLOB, out, len);
+}
+inline esp_err_t nvs_set_blob(nvs_handle_t h, const char* k, const void* v, size_t n) {
+    return host_nvs::set(h, k, host_nvs::BLOB, v, n);
+}
+inline esp_err_t nvs_get_u8(nvs_handle_t h, const char* k, uint8_t* o) { return host_nvs::get(h, k, host_nvs::U8, o, nullptr); }
+inline esp_err_t nvs_set_u8(nvs_handle_t h, const char* k, uint8_t v) { return host_nvs::set(h, k, host_nvs::U8, &v, sizeof(v)); }
+inline esp_err_t nvs_get_i32(nvs_handle_t h, const char* k, int32_t* o) { return host_nvs::get(h, k, host_nvs::I32, o, nullptr); }
+inline esp_err_t nvs_set_i32(nvs_handle_t h, const char* k, int32_t v) { return host_nvs::set(h, k, host_nvs::I32, &v, sizeof(v)); }
+inline esp_err_t nvs_get_u32(nvs_handle_t h, const char* k, uint32_t* o) { return host_nvs::get(h, k, host_nvs::U32, o, nullptr); }
+inline esp_err_t nvs_set_u32(nvs_handle_t h, const char* k, uint32_t v) { return host_nvs::set(h, k, host_nvs::U32, &v, sizeof(v)); }
+inline esp_err_t nvs_get_i64(nvs_handle_t h, const char* k, int64_t* o) { return host_nvs::get(h, k, host_nvs::I64, o, nullptr); }
+inline esp_err_t nvs_set_i64(nvs_handle_t h, const char* k, int64_t v) { return host_nvs::set(h, k, host_nvs::I64, &v, sizeof(v)); }
+
+inline esp_err_t nvs_erase_key(nvs_handle_t h, const char* k) {
+    host_nvs::Namespace* ns = host_nvs::ns_of(h);
+    if (!ns) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (!host_nvs::handles()[h - 1].writable) return ESP_ERR_NVS_READ_ONLY;
+    return ns->erase(k) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+inline esp_err_t nvs_erase_all(nvs_handle_t h) {
+    host_nvs::Namespace* ns = host_nvs::ns_of(h);
+    if (!ns) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (!host_nvs::handles()[h - 1].writable) return ESP_ERR_NVS_READ_ONLY;
+    ns->clear();
+    return ESP_OK;
+}
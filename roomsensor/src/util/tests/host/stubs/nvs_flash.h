@@ -0,0 +1,10 @@
+#pragma once
+
+// Host stand-in: the in-memory NVS needs no partition
+#include "nvs.h"
+
+inline esp_err_t nvs_flash_init(void) { return ESP_OK; }
+inline esp_err_t nvs_flash_erase(void) {
+    host_nvs::clear();
+    return ESP_OK;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+// Host stand-in: the leading registers of the Xtensa exception frame, 32-bit like the target
+#include <stdint.h>
+
+typedef struct {
+    uint32_t exit;
+    uint32_t pc;
+    uint32_t ps;
+    uint32_t a0;
+    uint32_t a1;
+} XtExcFrame;
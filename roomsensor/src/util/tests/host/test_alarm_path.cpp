@@ -0,0 +1,188 @@
+// main/alarms.cpp against main/metrics.cpp under load: a full metrics batch publishing back to back in the
+// device's slot with the metrics queue full behind it, and an alarm raised in the middle of it. The alarm
+// has to go out after at most the metrics publish already in progress, not after the backlog.
+// publish_to_topic is a stand-in for the MQTT client: one publish at a time, kPublishMs each, the client
+// lock handed to the highest-priority waiter as a FreeRTOS mutex would (the host threads have no priorities).
+#include "host_test.h"
+#include "alarms.h"
+#include "communication.h"
+#include "ConfigurationManager.h"
+#include "config.h"
+#include "nvs.h"
+#include "publish_slot.h"
+#include "status_led.h"
+#include "system_state.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <sys/time.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kPublishMs = 4;
+constexpr int kSensors = 8;
+constexpr int kReports = 400;    // more than the batch (320)
+constexpr int kQueueLength = 64; // METRICS_QUEUE_SIZE
+
+uint8_t g_mac[6] = {0x24, 0x0A, 0xC4, 0x3A, 0x12, 0x00};
+
+class ClientLock {
+public:
+    void lock(UBaseType_t prio) {
+        std::unique_lock<std::mutex> l(m_);
+        waiting_.insert(prio);
+        cv_.wait(l, [&] { return !held_ && *waiting_.rbegin() == prio; });
+        waiting_.erase(waiting_.find(prio));
+        held_ = true;
+    }
+    void unlock() {
+        {
+            std::lock_guard<std::mutex> l(m_);
+            held_ = false;
+        }
+        cv_.notify_all();
+    }
+
+private:
+    std::mutex m_;
+    std::condition_variable cv_;
+    std::multiset<UBaseType_t> waiting_;
+    bool held_ = false;
+};
+
+struct Published {
+    std::string topic, payload;
+    int64_t at_us;
+};
+
+ClientLock g_client;
+std::mutex g_log_m;
+std::condition_variable g_log_cv;
+std::vector<Published> g_log;
+
+bool is_alarm(const Published& p) { return p.topic.find("/alarms/") != std::string::npos; }
+
+// Wait until 'done' holds for the publish log, at most timeout_ms
+template <typename Pred>
+bool wait_log(int timeout_ms, Pred done) {
+    std::unique_lock<std::mutex> l(g_log_m);
+    return g_log_cv.wait_for(l, std::chrono::milliseconds(timeout_ms), [&] { return done(g_log); });
+}
+
+// A MAC whose publish slot starts 300-1300 ms from now, so the backlog is queued before it and the test
+// does not wait most of an interval
+void pick_mac_for_slot_soon() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    const uint64_t now_ms = (uint64_t)tv.tv_sec * 1000 + (uint64_t)(tv.tv_usec / 1000);
+    for (int i = 0; i < 65536; ++i) {
+        g_mac[4] = (uint8_t)(i >> 8);
+        g_mac[5] = (uint8_t)i;
+        const uint32_t off = publish_slot::offset_for_mac(g_mac, METRICS_PUBLISH_SLOT_MS);
+        const uint32_t until = publish_slot::ms_until_slot(now_ms, METRICS_PUBLISH_SLOT_MS, off, 0, 0.0f);
+        if (until >= 300 && until <= 1300) return;
+    }
+}
+
+TagCollection make_tags(const char* key, const char* value) {
+    TagCollection t = {};
+    snprintf(t.tags[0].key, MAX_TAG_KEY_LEN, "%s", key);
+    snprintf(t.tags[0].value, MAX_TAG_VALUE_LEN, "%s", value);
+    t.count = 1;
+    return t;
+}
+
+} // namespace
+
+const uint8_t* get_device_mac(void) { return g_mac; }
+SystemState get_system_state(void) { return FULLY_CONNECTED; }
+void status_led_set_alarm(bool) {}
+
+esp_err_t publish_to_topic(const char* topic, const char* message, int, int) {
+    g_client.lock(uxTaskPriorityGet(xTaskGetCurrentTaskHandle()));
+    std::this_thread::sleep_for(std::chrono::milliseconds(kPublishMs));
+    g_client.unlock();
+    {
+        std::lock_guard<std::mutex> l(g_log_m);
+        g_log.push_back({topic, message, esp_timer_get_time()});
+    }
+    g_log_cv.notify_all();
+    return ESP_OK;
+}
+
+TEST(alarm_is_not_delayed_behind_the_metrics_backlog) {
+    host_nvs::clear();
+    CHECK_EQ(config::GetConfigurationManager().initialize(), ESP_OK); // before the tasks, as in app_main
+    pick_mac_for_slot_soon();
+    CHECK_EQ(initialize_metrics_system(), ESP_OK);
+    CHECK_EQ(initialize_alarm_system(), ESP_OK);
+
+    // One interval's worth and more, queued ahead of the slot: the batch fills, then the queue
+    static const char* metrics[] = {"temperature", "humidity", "pressure", "co2", "pm25", "lux"};
+    TagCollection sensors[kSensors];
+    for (int s = 0; s < kSensors; ++s) {
+        char name[16];
+        snprintf(name, sizeof(name), "room%d", s);
+        sensors[s] = make_tags("name", name);
+    }
+    for (int i = 0; i < kReports; ++i) {
+        CHECK_EQ(report_metric(metrics[i % 6], (float)i, &sensors[i % kSensors]), ESP_OK);
+        if (i % 32 == 31) std::this_thread::yield(); // let the metrics task move the queue into its batch
+    }
+
+    // The slot opens. A few publishes into the batch, reports arriving meanwhile fill the queue for the
+    // next slot until it refuses them; then the alarm is raised
+    CHECK(wait_log(3000, [](const std::vector<Published>& log) { return log.size() >= 10; }));
+    MetricsDropCounts drops;
+    get_metrics_drop_counts(&drops);
+    const size_t batch = (size_t)kReports - drops.batch_full;
+    int refused = 0;
+    for (int i = 0; i < kQueueLength + 8; ++i) {
+        if (report_metric(metrics[i % 6], (float)i, &sensors[i % kSensors]) != ESP_OK) refused++;
+    }
+    printf("%d reports before the slot, %zu in the batch; %d of %d refused during it\n", kReports, batch, refused,
+           kQueueLength + 8);
+    CHECK_EQ(batch, size_t(320));
+    CHECK_EQ(refused, 8);
+    TagCollection contact = make_tags("name", "basement.water");
+    const int64_t raised_us = esp_timer_get_time();
+    CHECK_EQ(report_alarm("contact", true, 1.0f, 1.0f, &contact), ESP_OK);
+
+    CHECK(wait_log(2000, [](const std::vector<Published>& log) {
+        for (const Published& p : log) if (is_alarm(p)) return true;
+        return false;
+    }));
+    // Let the batch finish so nothing publishes while the test exits
+    CHECK(wait_log(batch * kPublishMs * 4 + 3000, [&](const std::vector<Published>& log) {
+        return log.size() >= batch + 1;
+    }));
+
+    std::lock_guard<std::mutex> l(g_log_m);
+    size_t at = g_log.size();
+    for (size_t i = 0; i < g_log.size(); ++i) {
+        if (is_alarm(g_log[i])) at = i;
+    }
+    CHECK(at < g_log.size());
+    if (at == g_log.size()) return;
+    const Published& alarm = g_log[at];
+    const int64_t latency_ms = (alarm.at_us - raised_us) / 1000;
+    const int64_t drain_ms = (g_log.back().at_us - g_log.front().at_us) / 1000;
+    printf("alarm published %lld ms after report_alarm, %zu metrics after it; batch of %zu took %lld ms\n",
+           (long long)latency_ms, g_log.size() - at - 1, batch, (long long)drain_ms);
+    char topic[64];
+    snprintf(topic, sizeof(topic), "sensor/%02x%02x%02x%02x%02x%02x/alarms/contact", g_mac[0], g_mac[1], g_mac[2],
+             g_mac[3], g_mac[4], g_mac[5]);
+    CHECK(alarm.topic == topic);
+    CHECK(alarm.payload.find("\"state\":\"raised\"") != std::string::npos);
+    CHECK(alarm.payload.find("\"latency_ms\":") != std::string::npos);
+    CHECK(alarm.payload.find("\"name\":\"basement.water\"") != std::string::npos);
+    // The publish in progress, then the alarm: a few publish times, not the batch's
+    CHECK(latency_ms < 10 * kPublishMs + 50);
+    CHECK(g_log.size() - at - 1 > batch / 2);
+}
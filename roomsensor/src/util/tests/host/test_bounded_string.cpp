@@ -0,0 +1,120 @@
+// BoundedString and PooledString (BoundedString.h): assign up to capacity and refusal one past it with the
+// old value kept, clear and null, overlapping assigns, the std::string-like read side and its comparisons,
+// pool-backed capacity; and the max_len edge in front of them, through check_size and a module's
+// apply_update.
+#include "host_test.h"
+#include "BoundedString.h"
+#include "ConfigBlobPool.h"
+#include "ConfigurationModule.h"
+#include "WifiConfig.h"
+
+#include <string>
+
+using config::BoundedString;
+using config::ConfigValue;
+using config::PooledString;
+
+TEST(bounded_assign_takes_capacity_and_refuses_one_more) {
+    BoundedString<8> s;
+    CHECK(s.empty());
+    CHECK(std::string(s.c_str()).empty());
+    CHECK(s.assign("12345678"));
+    CHECK_EQ(s.size(), size_t(8));
+    CHECK(s == "12345678");
+    CHECK(!s.assign("123456789"));
+    CHECK(s == "12345678"); // unchanged on refusal
+    CHECK(!s.assign(std::string_view("abcdefghi")));
+    CHECK(s.assign("abc", 2));
+    CHECK(s == "ab");
+    CHECK_EQ(s.c_str()[2], '\0');
+    CHECK(s.assign(static_cast<const char*>(nullptr)));
+    CHECK(s.empty());
+    CHECK(s.assign("xyz"));
+    s.clear();
+    CHECK(s.empty());
+    CHECK(s == "");
+    CHECK_EQ(BoundedString<8>::capacity(), size_t(8));
+}
+
+TEST(bounded_assign_from_itself_overlaps_safely) {
+    BoundedString<16> s("hello world");
+    CHECK(s.assign(s.c_str() + 6));
+    CHECK(s == "world");
+    CHECK(s.assign(s.view().substr(1, 3)));
+    CHECK(s == "orl");
+}
+
+TEST(read_side_compares_like_std_string) {
+    BoundedString<16> s("north_bed");
+    CHECK(s == "north_bed");
+    CHECK(s != "north_be");
+    CHECK(s != "north_bed2");
+    CHECK(s != static_cast<const char*>(nullptr));
+    CHECK(s == std::string("north_bed"));
+    CHECK(s != std::string_view("north"));
+    CHECK(s == std::string_view("north_bed_x", 9));
+    CHECK_EQ(s.length(), size_t(9));
+    CHECK_EQ(s[0], 'n');
+    CHECK(std::string(s.begin(), s.end()) == "north_bed");
+    const std::string_view v = s;
+    CHECK(v == "north_bed");
+    // Embedded NUL from a counted assign: size, not strlen, decides
+    CHECK(s.assign("a\0b", 3));
+    CHECK_EQ(s.size(), size_t(3));
+    CHECK(s == std::string_view("a\0b", 3));
+    CHECK(s != "a");
+}
+
+TEST(pooled_string_holds_capacity_from_the_pool) {
+    const auto before = config::ConfigBlobPool::stats();
+    PooledString p(511);
+    const auto after = config::ConfigBlobPool::stats();
+    CHECK_EQ(p.capacity(), size_t(511));
+    CHECK(after.used >= before.used + 512);
+    CHECK(p.empty());
+    CHECK(p == "");
+    const std::string text(511, 'm');
+    CHECK(p.assign(text.c_str()));
+    CHECK_EQ(p.size(), size_t(511));
+    CHECK(p == text);
+    CHECK(!p.assign((text + "m").c_str()));
+    CHECK(p == text);
+    CHECK(p.assign("short"));
+    CHECK(p == "short");
+    CHECK(p != "shor");
+    CHECK(p.assign(static_cast<const char*>(nullptr)));
+    CHECK(p.empty());
+
+    // Two strings never share storage
+    PooledString q(16);
+    CHECK(q.assign("second"));
+    CHECK(p.assign("first"));
+    CHECK(q == "second");
+    CHECK(p.data() != q.data());
+}
+
+TEST(check_size_rejects_over_max_len_only_for_strings_and_blobs) {
+    const config::ConfigurationValueDescriptor str = {"name", config::ConfigValueType::String, nullptr, true, 4};
+    const config::ConfigurationValueDescriptor unbounded = {"name", config::ConfigValueType::String, nullptr, true};
+    const config::ConfigurationValueDescriptor blob = {"seed", config::ConfigValueType::Blob, nullptr, true, 2};
+    const uint8_t bytes[3] = {1, 2, 3};
+    using config::ConfigurationModule;
+    CHECK_EQ(ConfigurationModule::check_size(&str, ConfigValue::of_string("abcd")), ESP_OK);
+    CHECK_EQ(ConfigurationModule::check_size(&str, ConfigValue::of_string("abcde")), ESP_ERR_INVALID_SIZE);
+    CHECK_EQ(ConfigurationModule::check_size(&unbounded, ConfigValue::of_string("abcde")), ESP_OK);
+    CHECK_EQ(ConfigurationModule::check_size(nullptr, ConfigValue::of_string("abcde")), ESP_OK);
+    CHECK_EQ(ConfigurationModule::check_size(&blob, ConfigValue::of_blob(bytes, 2)), ESP_OK);
+    CHECK_EQ(ConfigurationModule::check_size(&blob, ConfigValue::of_blob(bytes, 3)), ESP_ERR_INVALID_SIZE);
+    CHECK_EQ(ConfigurationModule::check_size(&str, ConfigValue::unset(config::ConfigValueType::String)), ESP_OK);
+}
+
+TEST(module_refuses_oversize_value_and_keeps_the_old_one) {
+    config::WifiConfig wifi;
+    const std::string fits(config::WifiConfig::kSsidMaxLen, 's');
+    CHECK_EQ(wifi.apply_update("ssid", fits.c_str()), ESP_OK);
+    CHECK(wifi.ssid() == fits);
+    CHECK_EQ(wifi.apply_update("ssid", (fits + "s").c_str()), ESP_ERR_INVALID_SIZE);
+    CHECK(wifi.ssid() == fits);
+    CHECK_EQ(wifi.apply_update("ssid", "north_bed"), ESP_OK);
+    CHECK(wifi.ssid() == "north_bed");
+}
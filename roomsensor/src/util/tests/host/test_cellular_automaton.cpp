@@ -0,0 +1,166 @@
+// CellularAutomaton: rule parsing, known patterns, and generation-by-generation equality (states and ages)
+// with the naive reference over every rule kind, odd grid sizes and both edge modes.
+#include "host_test.h"
+#include "ca_reference.h"
+#include "CellularAutomaton.h"
+
+#include <random>
+
+using leds::internal::CARule;
+using leds::internal::CellularAutomaton;
+
+namespace {
+
+CARule rule(const char* text) {
+    CARule r;
+    CHECK(CARule::parse(text, r));
+    return r;
+}
+
+// Runs both implementations from the same random seed; returns the first generation they disagree
+// on, or -1
+int first_mismatch(const char* rule_text, size_t rows, size_t cols, bool wrap, int generations, uint32_t seed) {
+    const CARule r = rule(rule_text);
+    CellularAutomaton ca;
+    ca.configure(rows, cols, r, wrap);
+    ca.set_track_age(true);
+    ReferenceAutomaton ref;
+    ref.configure(rows, cols, r, wrap);
+    std::mt19937 rng(seed);
+    for (size_t y = 0; y < rows; ++y) {
+        for (size_t x = 0; x < cols; ++x) {
+            uint8_t s = (rng() % 3 == 0) ? static_cast<uint8_t>(1 + rng() % (r.states - 1)) : 0;
+            ca.set_state(y, x, s);
+            ref.set_state(y, x, s);
+        }
+    }
+    for (int g = 0; g <= generations; ++g) {
+        for (size_t y = 0; y < rows; ++y) {
+            for (size_t x = 0; x < cols; ++x) {
+                if (ca.state(y, x) != ref.state(y, x) || ca.age(y, x) != ref.age(y, x)) {
+                    fprintf(stderr, "    %s %zux%zu %s gen %d cell (%zu,%zu): state %u/%u age %u/%u\n", rule_text,
+                            rows, cols, wrap ? "wrap" : "bounded", g, y, x, ca.state(y, x), ref.state(y, x),
+                            ca.age(y, x), ref.age(y, x));
+                    return g;
+                }
+            }
+        }
+        ca.step();
+        ref.step();
+    }
+    return -1;
+}
+
+} // namespace
+
+TEST(parse_rules) {
+    CARule r = rule("B3/S23");
+    CHECK(r.kind == CARule::Kind::LIFE_LIKE);
+    CHECK_EQ(r.birth, 1u << 3);
+    CHECK_EQ(r.survive, (1u << 2) | (1u << 3));
+    // Classic S/B order and names
+    CARule classic = rule("23/3");
+    CHECK_EQ(classic.birth, r.birth);
+    CHECK_EQ(classic.survive, r.survive);
+    CHECK_EQ(rule("highlife").birth, (1u << 3) | (1u << 6));
+    CARule brian = rule("BRIAN");
+    CHECK(brian.kind == CARule::Kind::GENERATIONS);
+    CHECK_EQ(brian.states, 3);
+    CHECK_EQ(brian.survive, 0);
+    CHECK(rule("WIREWORLD").kind == CARule::Kind::WIREWORLD);
+    CHECK_EQ(rule("s23/b3/c4").states, 4);
+
+    CARule bad;
+    CHECK(!CARule::parse("B9/S23", bad));
+    CHECK(!CARule::parse("B3/S23/C1", bad));
+    CHECK(!CARule::parse("B3/S23/C4/X", bad));
+    CHECK(!CARule::parse("B3/S2x", bad));
+    CHECK(!CARule::parse("hello", bad));
+    CHECK(!CARule::parse(nullptr, bad));
+    CHECK(!CARule::parse("", bad));
+}
+
+TEST(blinker_and_glider) {
+    CellularAutomaton ca;
+    ca.configure(8, 40, rule("LIFE"), true);
+    ca.set_state(3, 4, 1);
+    ca.set_state(3, 5, 1);
+    ca.set_state(3, 6, 1);
+    ca.step();
+    CHECK(ca.state(2, 5) == 1 && ca.state(3, 5) == 1 && ca.state(4, 5) == 1);
+    CHECK(ca.state(3, 4) == 0 && ca.state(3, 6) == 0);
+    ca.step();
+    CHECK(ca.state(3, 4) == 1 && ca.state(3, 6) == 1 && ca.state(2, 5) == 0);
+
+    // A glider crosses the 32-column word boundary and the wrap edge: after 4 generations it has
+    // moved one cell down and right
+    CellularAutomaton g;
+    g.configure(6, 34, rule("B3/S23"), true);
+    const int cells[5][2] = {{0, 1}, {1, 2}, {2, 0}, {2, 1}, {2, 2}};
+    for (auto& c : cells) g.set_state(c[0], 31 + c[1], 1);
+    for (int i = 0; i < 4; ++i) g.step();
+    for (auto& c : cells) CHECK_EQ(g.state(c[0] + 1, (31 + c[1] + 1) % 34), 1);
+    size_t alive = 0;
+    for (size_t y = 0; y < 6; ++y)
+        for (size_t x = 0; x < 34; ++x) alive += g.state(y, x) != 0;
+    CHECK_EQ(alive, 5u);
+}
+
+TEST(bounded_edges_are_dead) {
+    // A blinker against the edge loses cells on a bounded grid but not on a torus
+    CellularAutomaton bounded, torus;
+    bounded.configure(5, 5, rule("LIFE"), false);
+    torus.configure(5, 5, rule("LIFE"), true);
+    for (int c = 0; c < 3; ++c) {
+        bounded.set_state(0, c + 1, 1);
+        torus.set_state(0, c + 1, 1);
+    }
+    bounded.step();
+    torus.step();
+    CHECK_EQ(bounded.state(4, 2), 0);
+    CHECK_EQ(torus.state(4, 2), 1);
+}
+
+TEST(wireworld_diode_signal) {
+    // Electron on a straight wire moves one cell per generation
+    CellularAutomaton ca;
+    ca.configure(3, 10, rule("WIREWORLD"), false);
+    for (size_t x = 0; x < 10; ++x) ca.set_state(1, x, 3);
+    ca.set_state(1, 1, 1);
+    ca.set_state(1, 0, 2);
+    for (int g = 0; g < 5; ++g) ca.step();
+    CHECK_EQ(ca.state(1, 6), 1);
+    CHECK_EQ(ca.state(1, 5), 2);
+    CHECK_EQ(ca.state(1, 4), 3);
+}
+
+TEST(matches_reference_for_every_rule_kind) {
+    const char* rules[] = {"B3/S23", "B36/S23", "B2/S", "B3678/S34678", "B2/S/C3", "B2/S345/C5", "B34/S34/C9", "WIREWORLD"};
+    const size_t sizes[][2] = {{1, 1}, {2, 2}, {3, 31}, {5, 32}, {7, 33}, {17, 45}, {32, 64}, {9, 100}};
+    uint32_t seed = 1;
+    for (const char* r : rules) {
+        for (auto& sz : sizes) {
+            for (bool wrap : {true, false}) {
+                CHECK_EQ(first_mismatch(r, sz[0], sz[1], wrap, 60, seed++), -1);
+            }
+        }
+    }
+}
+
+TEST(ages_saturate) {
+    // Block still life: ages count up and stop at 255
+    CellularAutomaton ca;
+    ca.configure(4, 4, rule("LIFE"), false);
+    ca.set_track_age(true);
+    ca.set_state(1, 1, 1);
+    ca.set_state(1, 2, 1);
+    ca.set_state(2, 1, 1);
+    ca.set_state(2, 2, 1);
+    for (int i = 0; i < 300; ++i) ca.step();
+    CHECK_EQ(ca.age(1, 1), 255);
+    CHECK_EQ(ca.age(0, 0), 255);
+    ca.set_state(0, 0, 1);
+    CHECK_EQ(ca.age(0, 0), 0);
+    ca.set_track_age(false);
+    CHECK_EQ(ca.age(1, 1), 0);
+}
@@ -0,0 +1,271 @@
+// ConfigSnapshot serialize/parse: round trip of every value type, set() replace/remove and module grouping,
+// and rejection without a single callback for a bad CRC, another version, a bad magic, every truncation, and
+// structural damage under a valid CRC. Boot falls back to the per-key load on a damaged blob and rewrites it,
+// leaving out persisted values over their max_len.
+#include "host_test.h"
+#include "config_fixture.h"
+#include "ConfigSnapshot.h"
+#include "esp_rom_crc.h"
+
+#include <string>
+#include <vector>
+
+using config::ConfigSnapshot;
+using config::ConfigValue;
+using config::ConfigValueType;
+
+esp_err_t publish_to_topic(const char*, const char*, int, int) { return ESP_OK; }
+
+namespace {
+
+struct Seen {
+    std::string module, key;
+    ConfigValueType type;
+    std::vector<uint8_t> bytes;
+};
+
+std::vector<Seen> g_seen;
+
+esp_err_t parse(const std::vector<uint8_t>& blob, size_t* entries = nullptr) {
+    g_seen.clear();
+    return ConfigSnapshot::parse(
+        blob.data(), blob.size(),
+        [](const char* module, const char* key, const ConfigValue& v) {
+            Seen s{module, key, v.type, {}};
+            if (v.type == ConfigValueType::String) {
+                s.bytes.assign(v.c_str(), v.c_str() + v.size);
+            } else if (v.type == ConfigValueType::Blob) {
+                const uint8_t* d = static_cast<const uint8_t*>(v.data);
+                s.bytes.assign(d, d + v.size);
+            } else {
+                const int64_t x = v.as_i64(0);
+                const uint8_t* d = reinterpret_cast<const uint8_t*>(&x);
+                s.bytes.assign(d, d + 8);
+            }
+            g_seen.push_back(std::move(s));
+        },
+        entries);
+}
+
+const uint8_t kBlob[] = {0x00, 0xff, 0x10, 0x00, 0x7f};
+
+ConfigSnapshot sample() {
+    ConfigSnapshot s;
+    s.set("led1", "num_rows", ConfigValue::of_i32(-8));
+    s.set("wifi", "ssid", ConfigValue::of_string("north_bed"));
+    s.set("led1", "max_current_ma", ConfigValue::of_u32(1500));
+    s.set("device", "uptime_base", ConfigValue::of_i64(INT64_MIN));
+    s.set("device", "enabled", ConfigValue::of_bool(true));
+    s.set("a2d1", "scale", ConfigValue::of_f32(2.5f));
+    s.set("tags", "blob", ConfigValue::of_blob(kBlob, sizeof(kBlob)));
+    s.set("tags", "empty", ConfigValue::of_string(""));
+    return s;
+}
+
+// Recompute the header CRC after editing the payload, so only the structure check can catch the damage
+void reseal(std::vector<uint8_t>& blob) {
+    const uint32_t crc = esp_rom_crc32_le(0, blob.data() + ConfigSnapshot::kHeaderBytes,
+                                          static_cast<uint32_t>(blob.size() - ConfigSnapshot::kHeaderBytes));
+    for (int i = 0; i < 4; ++i) blob[12 + i] = static_cast<uint8_t>(crc >> (8 * i));
+}
+
+} // namespace
+
+TEST(round_trip_keeps_every_type_grouped_by_module) {
+    std::vector<uint8_t> blob;
+    sample().serialize(blob);
+    size_t entries = 0;
+    CHECK_EQ(parse(blob, &entries), ESP_OK);
+    CHECK_EQ(entries, size_t(8));
+    CHECK_EQ(g_seen.size(), size_t(8));
+
+    // led1's second key lands next to its first, not after wifi
+    const char* order[][2] = {{"led1", "num_rows"}, {"led1", "max_current_ma"}, {"wifi", "ssid"},
+                              {"device", "uptime_base"}, {"device", "enabled"}, {"a2d1", "scale"},
+                              {"tags", "blob"}, {"tags", "empty"}};
+    for (size_t i = 0; i < g_seen.size() && i < 8; ++i) {
+        CHECK(g_seen[i].module == order[i][0]);
+        CHECK(g_seen[i].key == order[i][1]);
+    }
+    CHECK(g_seen[2].type == ConfigValueType::String);
+    CHECK(std::string(g_seen[2].bytes.begin(), g_seen[2].bytes.end()) == "north_bed");
+    CHECK(g_seen[6].type == ConfigValueType::Blob);
+    CHECK(g_seen[6].bytes == std::vector<uint8_t>(kBlob, kBlob + sizeof(kBlob)));
+    CHECK(g_seen[7].type == ConfigValueType::String && g_seen[7].bytes.empty());
+
+    // Typed values come back bit for bit
+    ConfigSnapshot::parse(blob.data(), blob.size(), [&](const char*, const char* k, const ConfigValue& v) {
+        if (strcmp(k, "num_rows") == 0) CHECK_EQ(v.i32, -8);
+        if (strcmp(k, "max_current_ma") == 0) CHECK_EQ(v.u32, 1500u);
+        if (strcmp(k, "uptime_base") == 0) CHECK_EQ(v.i64, INT64_MIN);
+        if (strcmp(k, "enabled") == 0) CHECK(v.b);
+        if (strcmp(k, "scale") == 0) CHECK_EQ(v.f32, 2.5f);
+    });
+}
+
+TEST(set_replaces_and_unset_removes) {
+    ConfigSnapshot s = sample();
+    s.set("led1", "num_rows", ConfigValue::of_i32(16));
+    s.set("wifi", "ssid", ConfigValue::unset(ConfigValueType::String));
+    s.set("wifi", "absent", ConfigValue::unset(ConfigValueType::I32)); // removing a missing key is a no-op
+    CHECK_EQ(s.entry_count(), size_t(7));
+    std::vector<uint8_t> blob;
+    s.serialize(blob);
+    CHECK_EQ(parse(blob), ESP_OK);
+    for (const Seen& e : g_seen) CHECK(e.module != "wifi");
+    int32_t rows = 0;
+    ConfigSnapshot::parse(blob.data(), blob.size(), [&](const char*, const char* k, const ConfigValue& v) {
+        if (strcmp(k, "num_rows") == 0) rows = v.i32;
+    });
+    CHECK_EQ(rows, 16);
+
+    s.clear();
+    s.serialize(blob);
+    CHECK_EQ(blob.size(), ConfigSnapshot::kHeaderBytes);
+    size_t entries = 99;
+    CHECK_EQ(parse(blob, &entries), ESP_OK);
+    CHECK_EQ(entries, size_t(0));
+}
+
+TEST(crc_mismatch_is_rejected) {
+    std::vector<uint8_t> good;
+    sample().serialize(good);
+    for (size_t i = ConfigSnapshot::kHeaderBytes; i < good.size(); ++i) {
+        std::vector<uint8_t> blob = good;
+        blob[i] ^= 0x01;
+        CHECK_EQ(parse(blob), ESP_ERR_INVALID_CRC);
+        CHECK(g_seen.empty());
+    }
+    std::vector<uint8_t> blob = good;
+    blob[12] ^= 0x80; // the stored CRC itself
+    CHECK_EQ(parse(blob), ESP_ERR_INVALID_CRC);
+    CHECK(g_seen.empty());
+}
+
+TEST(other_version_and_bad_magic_are_rejected) {
+    std::vector<uint8_t> blob;
+    sample().serialize(blob);
+    std::vector<uint8_t> older = blob;
+    older[4] = static_cast<uint8_t>(ConfigSnapshot::kVersion + 1);
+    CHECK_EQ(parse(older), ESP_ERR_INVALID_VERSION);
+    CHECK(g_seen.empty());
+    older[4] = 0;
+    CHECK_EQ(parse(older), ESP_ERR_INVALID_VERSION);
+
+    std::vector<uint8_t> magic = blob;
+    magic[0] ^= 0xff;
+    CHECK_EQ(parse(magic), ESP_ERR_INVALID_SIZE);
+    CHECK(g_seen.empty());
+    CHECK_EQ(ConfigSnapshot::parse(nullptr, 0, [](const char*, const char*, const ConfigValue&) {}),
+             ESP_ERR_INVALID_SIZE);
+}
+
+TEST(every_truncation_is_rejected) {
+    std::vector<uint8_t> good;
+    sample().serialize(good);
+    for (size_t len = 0; len < good.size(); ++len) {
+        std::vector<uint8_t> blob(good.begin(), good.begin() + len);
+        CHECK(parse(blob) != ESP_OK);
+        CHECK(g_seen.empty());
+    }
+    // Truncated with the header length and CRC patched to match: the structure walk still catches it
+    for (size_t cut = 1; cut < good.size() - ConfigSnapshot::kHeaderBytes; ++cut) {
+        std::vector<uint8_t> blob(good.begin(), good.end() - cut);
+        const uint32_t payload = static_cast<uint32_t>(blob.size() - ConfigSnapshot::kHeaderBytes);
+        for (int i = 0; i < 4; ++i) blob[8 + i] = static_cast<uint8_t>(payload >> (8 * i));
+        reseal(blob);
+        CHECK_EQ(parse(blob), ESP_ERR_INVALID_SIZE);
+        CHECK(g_seen.empty());
+    }
+}
+
+TEST(structural_damage_under_a_valid_crc_is_rejected) {
+    ConfigSnapshot s;
+    s.set("led1", "num_rows", ConfigValue::of_i32(8));
+    std::vector<uint8_t> good;
+    s.serialize(good);
+    // payload: [4]"led1" [1 0] [8]"num_rows" [type] [4 0] value
+    const size_t type_at = ConfigSnapshot::kHeaderBytes + 1 + 4 + 2 + 1 + 8;
+
+    std::vector<uint8_t> blob = good;
+    blob[type_at] = 0x7f; // unknown ConfigValueType
+    reseal(blob);
+    CHECK_EQ(parse(blob), ESP_ERR_INVALID_SIZE);
+
+    blob = good;
+    blob[type_at] = static_cast<uint8_t>(ConfigValueType::I64); // fixed-size type with a 4-byte value
+    reseal(blob);
+    CHECK_EQ(parse(blob), ESP_ERR_INVALID_SIZE);
+
+    blob = good;
+    blob[ConfigSnapshot::kHeaderBytes] = 0; // empty module name
+    reseal(blob);
+    CHECK_EQ(parse(blob), ESP_ERR_INVALID_SIZE);
+
+    blob = good;
+    blob[6] = 2; // module count past the payload
+    CHECK_EQ(parse(blob), ESP_ERR_INVALID_SIZE);
+
+    ConfigSnapshot str;
+    str.set("wifi", "ssid", ConfigValue::of_string("abc"));
+    str.serialize(blob);
+    blob.back() = 'x'; // string without its terminator
+    reseal(blob);
+    CHECK_EQ(parse(blob), ESP_ERR_INVALID_SIZE);
+    CHECK(g_seen.empty());
+}
+
+TEST(boot_falls_back_to_per_key_on_a_damaged_snapshot) {
+    host_nvs::clear();
+    config_fixture::populate_nvs();
+    auto boot_rows = [] {
+        config::ConfigurationManager m;
+        m.initialize();
+        return m.led2().num_rows();
+    };
+    const int32_t rows = boot_rows(); // per key; writes the snapshot
+    host_nvs::Entry* snap = host_nvs::find(CONFIG_SNAPSHOT_NAMESPACE, CONFIG_SNAPSHOT_KEY);
+    CHECK(snap != nullptr);
+    if (!snap) return;
+    const std::vector<uint8_t> written = snap->bytes;
+
+    for (int damage = 0; damage < 3; ++damage) {
+        snap = host_nvs::find(CONFIG_SNAPSHOT_NAMESPACE, CONFIG_SNAPSHOT_KEY);
+        snap->bytes = written;
+        if (damage == 0) snap->bytes[ConfigSnapshot::kHeaderBytes + 3] ^= 0x20;   // CRC
+        if (damage == 1) snap->bytes[4] ^= 0x01;                                   // version
+        if (damage == 2) snap->bytes.resize(snap->bytes.size() / 2);               // truncated
+        host_nvs::read_count() = 0;
+        CHECK_EQ(boot_rows(), rows);
+        CHECK(host_nvs::read_count() > 100); // went through every per-key namespace
+        snap = host_nvs::find(CONFIG_SNAPSHOT_NAMESPACE, CONFIG_SNAPSHOT_KEY);
+        CHECK(snap != nullptr && snap->bytes == written); // and rewrote the snapshot
+    }
+}
+
+TEST(per_key_load_keeps_oversize_values_out_of_the_snapshot) {
+    host_nvs::clear();
+    config_fixture::populate_nvs();
+    nvs_handle_t h;
+    nvs_open("wifi", NVS_READWRITE, &h);
+    const std::string oversize(config::WifiConfig::kSsidMaxLen + 1, 's');
+    CHECK_EQ(nvs_set_str(h, "ssid", oversize.c_str()), ESP_OK);
+    nvs_close(h);
+    {
+        config::ConfigurationManager m;
+        m.initialize(); // per key; writes the snapshot
+        CHECK(m.wifi().ssid() != oversize);
+    }
+    host_nvs::Entry* snap = host_nvs::find(CONFIG_SNAPSHOT_NAMESPACE, CONFIG_SNAPSHOT_KEY);
+    CHECK(snap != nullptr);
+    if (!snap) return;
+    CHECK_EQ(parse(snap->bytes), ESP_OK);
+    bool wifi_password = false, wifi_ssid = false;
+    for (const Seen& s : g_seen) {
+        if (s.module != "wifi") continue;
+        wifi_password = wifi_password || s.key == "password";
+        wifi_ssid = wifi_ssid || s.key == "ssid";
+    }
+    CHECK(wifi_password); // its neighbours still load
+    CHECK(!wifi_ssid);
+}
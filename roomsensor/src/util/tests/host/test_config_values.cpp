@@ -0,0 +1,244 @@
+// ConfigValue::parse for every type (bounds, decimals, the 2^63 edge, junk), double_fits, the JSON reset edge
+// (value_from_json) with out-of-range numbers, and the typed boot load with every module populated: per-key
+// NVS and the snapshot give the same configuration, and updates survive a reboot.
+#include "host_test.h"
+#include "config_fixture.h"
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+using config::ConfigValue;
+using config::ConfigValueType;
+using config::double_fits;
+
+static std::string g_published; // last config/current payload
+
+esp_err_t publish_to_topic(const char* topic, const char* message, int, int) {
+    if (strstr(topic, "/config/current")) g_published = message;
+    return ESP_OK;
+}
+
+namespace {
+
+esp_err_t parse(ConfigValueType t, const char* text, ConfigValue& v) { return ConfigValue::parse(t, text, v); }
+
+bool rejects(ConfigValueType t, const char* text) {
+    ConfigValue v;
+    return parse(t, text, v) == ESP_ERR_INVALID_ARG;
+}
+
+int64_t parsed_i64(const char* text) {
+    ConfigValue v;
+    CHECK_EQ(parse(ConfigValueType::I64, text, v), ESP_OK);
+    return v.i64;
+}
+
+// Boot a manager on the current NVS contents and return its published configuration
+std::string boot() {
+    config::ConfigurationManager m;
+    m.initialize();
+    g_published.clear();
+    m.publish_full_configuration();
+    return g_published;
+}
+
+std::string reset_topic() {
+    config::ConfigurationManager m;
+    return m.get_mqtt_reset_subscription_topic();
+}
+
+} // namespace
+
+TEST(parse_i32_and_u32_bounds) {
+    ConfigValue v;
+    CHECK_EQ(parse(ConfigValueType::I32, "2147483647", v), ESP_OK);
+    CHECK_EQ(v.i32, INT32_MAX);
+    CHECK_EQ(parse(ConfigValueType::I32, "-2147483648", v), ESP_OK);
+    CHECK_EQ(v.i32, INT32_MIN);
+    CHECK(rejects(ConfigValueType::I32, "2147483648"));
+    CHECK(rejects(ConfigValueType::I32, "-2147483649"));
+    CHECK(rejects(ConfigValueType::I32, "2147483648.0"));
+
+    CHECK_EQ(parse(ConfigValueType::U32, "4294967295", v), ESP_OK);
+    CHECK_EQ(v.u32, UINT32_MAX);
+    CHECK(rejects(ConfigValueType::U32, "4294967296"));
+    CHECK(rejects(ConfigValueType::U32, "4294967296.0"));
+    CHECK(rejects(ConfigValueType::U32, "-1"));
+    CHECK(rejects(ConfigValueType::U32, " -0"));
+}
+
+TEST(parse_i64_rejects_two_to_the_63) {
+    CHECK_EQ(parsed_i64("9223372036854775807"), INT64_MAX);
+    CHECK_EQ(parsed_i64("-9223372036854775808"), INT64_MIN);
+    CHECK(rejects(ConfigValueType::I64, "9223372036854775808"));
+    // Decimal spellings go through strtod; 2^63 itself used to pass 'd > (double)INT64_MAX' and overflow the cast
+    CHECK(rejects(ConfigValueType::I64, "9223372036854775808.0"));
+    CHECK(rejects(ConfigValueType::I64, "9.223372036854775807e18"));
+    CHECK(rejects(ConfigValueType::I64, "1e19"));
+    CHECK(rejects(ConfigValueType::I64, "-9.3e18"));
+    CHECK_EQ(parsed_i64("9.2233720368547748e18"), (int64_t)9223372036854774784LL); // largest double below 2^63
+    CHECK_EQ(parsed_i64("-9.223372036854775808e18"), INT64_MIN);
+}
+
+TEST(parse_decimals_truncate_and_junk_is_rejected) {
+    ConfigValue v;
+    CHECK_EQ(parse(ConfigValueType::I32, "12.0", v), ESP_OK);
+    CHECK_EQ(v.i32, 12);
+    CHECK_EQ(parse(ConfigValueType::I32, "12.9", v), ESP_OK);
+    CHECK_EQ(v.i32, 12);
+    CHECK_EQ(parse(ConfigValueType::I32, "-12.9", v), ESP_OK);
+    CHECK_EQ(v.i32, -12);
+    CHECK_EQ(parse(ConfigValueType::I32, "1e3", v), ESP_OK);
+    CHECK_EQ(v.i32, 1000);
+    CHECK_EQ(parse(ConfigValueType::I32, " 42 \r\n", v), ESP_OK);
+    CHECK_EQ(v.i32, 42);
+    for (const char* junk : {"12abc", "abc", "0x10", "1.2.3", "nan", "inf", "-inf", "1e400", "--1", "1 2"}) {
+        CHECK(rejects(ConfigValueType::I32, junk));
+        CHECK(rejects(ConfigValueType::I64, junk));
+    }
+    CHECK(rejects(ConfigValueType::F32, "12abc"));
+}
+
+TEST(parse_bool_f32_string_blob_and_unset) {
+    ConfigValue v;
+    for (const char* t : {"1", "true", "TRUE", "on", "Yes"}) {
+        CHECK_EQ(parse(ConfigValueType::Bool, t, v), ESP_OK);
+        CHECK(v.is_set && v.b);
+    }
+    for (const char* t : {"0", "false", "Off", "no"}) {
+        CHECK_EQ(parse(ConfigValueType::Bool, t, v), ESP_OK);
+        CHECK(v.is_set && !v.b);
+    }
+    CHECK(rejects(ConfigValueType::Bool, "2"));
+    CHECK(rejects(ConfigValueType::Bool, "enabled"));
+
+    CHECK_EQ(parse(ConfigValueType::F32, "2.2", v), ESP_OK);
+    CHECK_NEAR(v.f32, 2.2f, 1e-6f);
+
+    const char* text = "north_bed";
+    CHECK_EQ(parse(ConfigValueType::String, text, v), ESP_OK);
+    CHECK(v.c_str() == text); // borrowed, not copied
+    CHECK_EQ(v.size, strlen(text));
+    CHECK_EQ(parse(ConfigValueType::String, "", v), ESP_OK);
+    CHECK(v.is_set && v.size == 0); // an empty string is a value for string keys
+
+    CHECK_EQ(parse(ConfigValueType::Blob, "abc", v), ESP_OK);
+    CHECK(v.type == ConfigValueType::Blob && v.size == 3);
+
+    for (ConfigValueType t : {ConfigValueType::I32, ConfigValueType::U32, ConfigValueType::I64, ConfigValueType::Bool,
+                              ConfigValueType::F32}) {
+        CHECK_EQ(parse(t, "", v), ESP_OK);
+        CHECK(!v.is_set && v.type == t);
+        CHECK_EQ(parse(t, nullptr, v), ESP_OK);
+        CHECK(!v.is_set);
+    }
+}
+
+TEST(format_round_trips_through_parse) {
+    char buf[64];
+    ConfigValue v, back;
+    for (ConfigValue x : {ConfigValue::of_i32(INT32_MIN), ConfigValue::of_u32(UINT32_MAX), ConfigValue::of_i64(INT64_MIN),
+                          ConfigValue::of_i64(INT64_MAX), ConfigValue::of_bool(true)}) {
+        CHECK_EQ(parse(x.type, x.format(buf, sizeof(buf)), back), ESP_OK);
+        CHECK_EQ(back.as_i64(0), x.as_i64(1));
+    }
+    CHECK(strcmp(ConfigValue::unset(ConfigValueType::I32).format(buf, sizeof(buf)), "(unset)") == 0);
+}
+
+TEST(double_fits_is_exclusive_at_the_top) {
+    const double two63 = 9223372036854775808.0;
+    CHECK(!double_fits(two63, INT64_MIN, INT64_MAX));
+    CHECK(double_fits(std::nextafter(two63, 0.0), INT64_MIN, INT64_MAX));
+    CHECK(double_fits(-two63, INT64_MIN, INT64_MAX));
+    CHECK(!double_fits(std::nextafter(-two63, -1e300), INT64_MIN, INT64_MAX));
+    CHECK(double_fits(2147483647.5, INT32_MIN, INT32_MAX));
+    CHECK(!double_fits(2147483648.0, INT32_MIN, INT32_MAX));
+    CHECK(!double_fits(-0.5, 0, UINT32_MAX));
+    CHECK(double_fits(4294967295.9, 0, UINT32_MAX));
+    CHECK(!double_fits(4294967296.0, 0, UINT32_MAX));
+    CHECK(!double_fits(std::numeric_limits<double>::quiet_NaN(), INT32_MIN, INT32_MAX));
+    CHECK(!double_fits(std::numeric_limits<double>::infinity(), INT64_MIN, INT64_MAX));
+    CHECK(!double_fits(-std::numeric_limits<double>::infinity(), INT64_MIN, INT64_MAX));
+}
+
+TEST(json_reset_rejects_out_of_range_numbers) {
+    host_nvs::clear();
+    config::ConfigurationManager m;
+    m.initialize();
+    const std::string topic = reset_topic();
+    CHECK_EQ(m.handle_mqtt_message(topic.c_str(),
+                                   "{\"led1\":{\"max_current_ma\":1e300,\"num_rows\":8},"
+                                   "\"led2\":{\"max_current_ma\":-9.3e18},"
+                                   "\"led3\":{\"max_current_ma\":1500.7},"
+                                   "\"tags\":{\"area\":1e300,\"room\":-9.3e18,\"id\":42}}"),
+             ESP_OK);
+    CHECK(host_nvs::find("led1", "max_current_ma") == nullptr);
+    CHECK(host_nvs::find("led1", "num_rows") != nullptr);
+    CHECK(host_nvs::find("led2", "max_current_ma") == nullptr);
+    CHECK_EQ(m.led3().current_limit_ma(), 1500);
+    // Numbers for string keys: integral ones print as integers, the rest (including ones past int64) as %g
+    CHECK(m.tags().area() == "1e+300");
+    CHECK(m.tags().room() == "-9.3e+18");
+    CHECK(m.tags().id() == "42");
+}
+
+TEST(every_persisted_key_fits_an_nvs_key) {
+    for (auto& mod : config_fixture::make_modules()) {
+        for (const auto& d : mod->descriptors()) {
+            if (!d.persisted) continue;
+            if (strlen(d.name) >= NVS_KEY_NAME_MAX_SIZE) {
+                fprintf(stderr, "%s.%s is longer than 15 characters\n", mod->name(), d.name);
+                CHECK(false);
+            }
+        }
+    }
+}
+
+TEST(populated_boot_matches_across_per_key_and_snapshot_loads) {
+    host_nvs::clear();
+    const config_fixture::Population pop = config_fixture::populate_nvs();
+    printf("%zu modules, %zu of %zu persisted keys populated\n", pop.modules, pop.written, pop.keys);
+    for (const auto& k : pop.unpopulated) fprintf(stderr, "not populated: %s\n", k.c_str());
+    CHECK_EQ(pop.modules, size_t(31));
+    CHECK(pop.unpopulated.empty());
+
+    const std::string defaults = [] {
+        auto saved = host_nvs::store();
+        host_nvs::clear();
+        std::string json = boot();
+        host_nvs::store() = saved;
+        return json;
+    }();
+
+    host_nvs::read_count() = 0;
+    const std::string per_key = boot(); // no snapshot yet: reads every key, then writes the snapshot
+    const uint32_t per_key_reads = host_nvs::read_count();
+    CHECK(host_nvs::find(CONFIG_SNAPSHOT_NAMESPACE, CONFIG_SNAPSHOT_KEY) != nullptr);
+
+    host_nvs::read_count() = 0;
+    const std::string snap = boot();
+    const uint32_t snap_reads = host_nvs::read_count();
+    CHECK(per_key == snap);
+    CHECK(per_key != defaults);
+    CHECK(per_key_reads > pop.keys);
+    CHECK(snap_reads <= 2);
+
+    // An update invalidates the snapshot, persists per key, and the next boot sees it
+    {
+        config::ConfigurationManager m;
+        m.initialize();
+        CHECK_EQ(m.handle_update("led2", "num_rows", "16", true), ESP_OK);
+        CHECK_EQ(m.handle_update("wifi", "max_tx_dbm", "99", true), ESP_OK); // clamped to 20 before it is stored
+        CHECK(host_nvs::find(CONFIG_SNAPSHOT_NAMESPACE, CONFIG_SNAPSHOT_KEY) == nullptr);
+    }
+    config::ConfigurationManager after;
+    after.initialize();
+    CHECK_EQ(after.led2().num_rows(), 16);
+    CHECK_EQ(after.wifi().tx_power_max_dbm(), 20);
+    int32_t stored = 0;
+    nvs_handle_t h;
+    nvs_open("wifi", NVS_READONLY, &h);
+    CHECK_EQ(nvs_get_i32(h, "max_tx_dbm", &stored), ESP_OK);
+    CHECK_EQ(stored, 20);
+}
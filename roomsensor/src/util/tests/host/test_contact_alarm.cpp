@@ -0,0 +1,123 @@
+// Contact alarms: alarms::ContactAlarm (alarms.h) evaluated per pin on every poll, and AlarmConfig's
+// contact list read by one thread while another replaces it (the I2C and MQTT tasks on the device).
+#include "host_test.h"
+#include "AlarmConfig.h"
+#include "alarms.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+esp_err_t report_alarm(const char*, bool, float, float, TagCollection*) { return ESP_OK; }
+
+namespace {
+
+struct Sent {
+    bool raised;
+    std::string name;
+};
+
+// One poll of one pin, the way the MCP23008 driver evaluates it
+void poll(alarms::ContactAlarm& a, const config::AlarmConfig& cfg, bool closed, const char* name,
+          std::vector<Sent>& out) {
+    a.update(closed && cfg.is_alarm_contact(name), name,
+             [&](bool raised, const char* n) { out.push_back({raised, n}); });
+}
+
+esp_err_t set_contacts(config::AlarmConfig& cfg, const char* list) {
+    return cfg.apply_value("contacts", config::ConfigValue::of_string(list));
+}
+
+} // namespace
+
+TEST(contact_list_parsing) {
+    config::AlarmConfig cfg;
+    CHECK(cfg.is_alarm_contact("front.door.override"));
+    CHECK(cfg.is_alarm_contact("basement.water"));
+    CHECK(!cfg.is_alarm_contact("front.door"));
+    CHECK(!cfg.is_alarm_contact(nullptr));
+    CHECK_EQ(set_contacts(cfg, " .leak , ,.smoke "), ESP_OK);
+    CHECK(cfg.is_alarm_contact("attic.smoke"));
+    CHECK(cfg.is_alarm_contact(".leak"));
+    CHECK(!cfg.is_alarm_contact("basement.water"));
+    CHECK(!cfg.is_alarm_contact("attic.smoke "));
+    CHECK_EQ(set_contacts(cfg, ""), ESP_OK);
+    CHECK(!cfg.is_alarm_contact("basement.water"));
+    const std::string too_long(config::AlarmConfig::kContactsMaxLen + 1, 'x');
+    CHECK_EQ(set_contacts(cfg, too_long.c_str()), ESP_ERR_INVALID_SIZE);
+}
+
+TEST(closed_at_boot_raises_and_open_at_boot_is_silent) {
+    config::AlarmConfig cfg;
+    std::vector<Sent> sent;
+    alarms::ContactAlarm closed, open;
+    poll(closed, cfg, true, "basement.water", sent);
+    poll(open, cfg, false, "hall.door.override", sent);
+    CHECK_EQ(sent.size(), size_t(1));
+    CHECK(sent[0].raised && sent[0].name == "basement.water");
+    // Steady state reports nothing more
+    for (int i = 0; i < 5; ++i) {
+        poll(closed, cfg, true, "basement.water", sent);
+        poll(open, cfg, false, "hall.door.override", sent);
+    }
+    CHECK_EQ(sent.size(), size_t(1));
+    poll(closed, cfg, false, "basement.water", sent);
+    CHECK_EQ(sent.size(), size_t(2));
+    CHECK(!sent[1].raised && sent[1].name == "basement.water");
+}
+
+TEST(configuration_changes_apply_while_closed) {
+    config::AlarmConfig cfg;
+    CHECK_EQ(set_contacts(cfg, ".leak"), ESP_OK);
+    std::vector<Sent> sent;
+    alarms::ContactAlarm a;
+    poll(a, cfg, true, "basement.water", sent);
+    CHECK(sent.empty());
+
+    // The suffix is added while the contact is closed: raises on the next poll
+    CHECK_EQ(set_contacts(cfg, ".leak,.water"), ESP_OK);
+    poll(a, cfg, true, "basement.water", sent);
+    CHECK_EQ(sent.size(), size_t(1));
+    CHECK(sent.back().raised);
+
+    // Renamed while raised: cleared under the old name, raised under the new one
+    poll(a, cfg, true, "cellar.water", sent);
+    CHECK_EQ(sent.size(), size_t(3));
+    CHECK(!sent[1].raised && sent[1].name == "basement.water");
+    CHECK(sent[2].raised && sent[2].name == "cellar.water");
+
+    // Renamed to something that is not an alarm contact: cleared, not raised again
+    poll(a, cfg, true, "cellar", sent);
+    CHECK_EQ(sent.size(), size_t(4));
+    CHECK(!sent[3].raised && sent[3].name == "cellar.water");
+
+    // Suffix removed while raised: the clear still goes out, so the alarm task drops it from its raised set
+    poll(a, cfg, true, "cellar.water", sent);
+    CHECK_EQ(set_contacts(cfg, ".leak"), ESP_OK);
+    poll(a, cfg, true, "cellar.water", sent);
+    CHECK_EQ(sent.size(), size_t(6));
+    CHECK(!sent[5].raised && sent[5].name == "cellar.water");
+    CHECK(!a.active);
+}
+
+TEST(contact_list_replaced_while_read) {
+    // Each read sees one whole list: never the cleared or half-parsed list the old in-place rebuild exposed
+    config::AlarmConfig cfg;
+    std::atomic<bool> stop{false};
+    std::atomic<uint32_t> reads{0}, bad{0};
+    std::thread reader([&] {
+        while (!stop.load()) {
+            // Every list below treats .water as an alarm contact and .door as none
+            if (!cfg.is_alarm_contact("basement.water")) bad++;
+            if (cfg.is_alarm_contact("front.door")) bad++;
+            reads++;
+        }
+    });
+    const char* lists[] = {".water", ".door.override,.water", " .water , .leak ,.smoke,.gas,.heat,.flood"};
+    for (int i = 0; i < 20000; ++i) CHECK_EQ(set_contacts(cfg, lists[i % 3]), ESP_OK);
+    stop = true;
+    reader.join();
+    printf("%u reads during 20000 updates\n", (unsigned)reads.load());
+    CHECK_EQ(bad.load(), 0u);
+}
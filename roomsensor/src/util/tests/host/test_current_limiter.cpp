@@ -0,0 +1,255 @@
+// CurrentLimiter and RailLimiter (LEDCurrentLimiter.h) and rail_current.h: scale computation from synthetic
+// frames, the closed loop against a simulated supply whose real draw differs from the chip model, and
+// several strips sharing one sensed rail.
+#include "host_test.h"
+#include "LEDCurrentLimiter.h"
+#include "rail_current.h"
+
+#include <vector>
+
+using leds::ChipCurrentModel;
+using leds::CurrentLimiter;
+using leds::FrameView;
+
+namespace {
+
+constexpr uint64_t kTickUs = 5'000;
+
+struct Frame {
+    std::vector<uint8_t> rgba;
+    FrameView view;
+    Frame(size_t pixels, uint8_t r, uint8_t g, uint8_t b) : rgba(pixels * 4) {
+        for (size_t i = 0; i < pixels; ++i) {
+            rgba[i * 4] = r;
+            rgba[i * 4 + 1] = g;
+            rgba[i * 4 + 2] = b;
+        }
+        view = FrameView{rgba.data(), 1, pixels};
+    }
+};
+
+ChipCurrentModel ws2812() { return ChipCurrentModel::for_chip(config::LEDConfig::Chip::WS2812); }
+
+double scale(uint32_t q16) { return static_cast<double>(q16) / CurrentLimiter::kUnity; }
+
+// Supply that draws true_gain times the modelled current of what is on display, sampled by the ADC
+// every sample_every_us
+struct SimulatedSupply {
+    double true_gain;
+    uint64_t sample_every_us;
+    uint64_t next_sample_us = 0;
+};
+
+} // namespace
+
+TEST(estimate_matches_chip_model) {
+    CurrentLimiter cl;
+    cl.configure(ws2812(), 1000.0f);
+    Frame white(60, 255, 255, 255);
+    Frame red_half(60, 128, 0, 0);
+    Frame dark(60, 0, 0, 0);
+    CHECK_NEAR(cl.estimate_ma(white.view), 60 * (36.0 + 0.6), 0.01);
+    CHECK_NEAR(cl.estimate_ma(red_half.view), 60 * (12.0 * 128 / 255 + 0.6), 0.01);
+    CHECK_NEAR(cl.estimate_ma(dark.view), 60 * 0.6, 0.01);
+    CHECK_NEAR(cl.estimate_ma(FrameView{}), 0.0, 0.0);
+}
+
+TEST(disabled_limiter_passes_unity) {
+    CurrentLimiter cl;
+    cl.configure(ws2812(), 0.0f);
+    CHECK(!cl.enabled());
+    CHECK_EQ(cl.update(5000.0f, kTickUs), CurrentLimiter::kUnity);
+}
+
+TEST(over_budget_clamps_on_the_first_frame) {
+    CurrentLimiter cl;
+    cl.configure(ws2812(), 1000.0f);
+    Frame white(60, 255, 255, 255);
+    const float est = cl.estimate_ma(white.view);
+    const uint32_t q = cl.update(est, kTickUs);
+    CHECK_NEAR(scale(q), 1000.0 / est, 1e-4);
+    // Under budget stays at unity
+    CurrentLimiter cl2;
+    cl2.configure(ws2812(), 1000.0f);
+    CHECK_EQ(cl2.update(900.0f, kTickUs), CurrentLimiter::kUnity);
+}
+
+TEST(release_is_gradual_and_bounded) {
+    CurrentLimiter cl;
+    cl.configure(ws2812(), 1000.0f);
+    uint64_t t = kTickUs;
+    cl.update(4000.0f, t); // scale 0.25
+    double prev = 0.25;
+    // Frame drops well under budget: the scale rises at 0.5/s, never jumps, reaches unity after ~1.5s
+    for (int i = 0; i < 400; ++i) {
+        t += kTickUs;
+        const double s = scale(cl.update(100.0f, t));
+        CHECK(s >= prev - 1e-6);
+        CHECK(s - prev <= 0.5 * kTickUs / 1e6 + 1e-4);
+        if (i == 99) CHECK_NEAR(s, 0.25 + 0.5 * 0.5, 0.01);
+        prev = s;
+    }
+    CHECK_NEAR(prev, 1.0, 1e-6);
+}
+
+TEST(closed_loop_converges_on_the_real_draw) {
+    // The strip really draws 30% more than the model (higher rail voltage, brighter batch); the limiter
+    // has to learn that from the rail measurement and hold the measured current at the budget
+    CurrentLimiter cl;
+    const float budget = 1500.0f;
+    cl.configure(ws2812(), budget);
+    Frame white(60, 255, 255, 255);
+    const float est = cl.estimate_ma(white.view);
+    SimulatedSupply supply{1.3, 1'000'000};
+    supply.next_sample_us = supply.sample_every_us;
+
+    double on_display_ma = 0.0;
+    uint64_t t = 0;
+    for (int i = 0; i < 30 * 200; ++i) {
+        t += kTickUs;
+        if (t >= supply.next_sample_us) {
+            // The sample covers the frame sent on the previous tick
+            CHECK(cl.on_measurement(static_cast<float>(on_display_ma), t - 2'000));
+            supply.next_sample_us += supply.sample_every_us;
+        }
+        const uint32_t q = cl.update(est, t);
+        on_display_ma = supply.true_gain * est * scale(q);
+    }
+    CHECK_NEAR(cl.gain(), 1.3, 0.01);
+    CHECK_NEAR(on_display_ma, budget, budget * 0.01);
+}
+
+TEST(measurement_uses_the_scale_of_the_sampled_frame) {
+    // A bright frame is clamped to 0.5, then the content goes dim and the scale recovers. A sample taken
+    // while the bright frame was on display must be judged against that frame, not the current one.
+    CurrentLimiter cl;
+    cl.configure(ws2812(), 1000.0f);
+    const float bright = 2000.0f;
+    const float dim = 400.0f;
+    uint64_t t = 1'000'000;
+    const uint32_t q_bright = cl.update(bright, t);
+    const uint64_t bright_on_display = t + 1'000;
+    for (int i = 0; i < 10; ++i) cl.update(dim, t += kTickUs);
+
+    const float measured = static_cast<float>(bright * scale(q_bright)); // supply matches the model
+    CHECK(cl.on_measurement(measured, bright_on_display));
+    CHECK_NEAR(cl.gain(), 1.0, 1e-4);
+}
+
+TEST(stale_and_dark_samples_are_ignored) {
+    CurrentLimiter cl;
+    cl.configure(ws2812(), 1000.0f);
+    uint64_t t = 1'000'000;
+    cl.update(2000.0f, t);
+    for (size_t i = 0; i < CurrentLimiter::kHistory; ++i) cl.update(2000.0f, t += kTickUs);
+    // Older than the remembered frames
+    CHECK(!cl.on_measurement(800.0f, 1'000'000));
+    // Before any frame
+    CurrentLimiter fresh;
+    fresh.configure(ws2812(), 1000.0f);
+    CHECK(!fresh.on_measurement(800.0f, 10));
+    // Near-dark frame: idle current and ADC offset dominate
+    fresh.update(20.0f, t);
+    CHECK(!fresh.on_measurement(35.0f, t));
+    CHECK_NEAR(fresh.gain(), 1.0, 0.0);
+}
+
+TEST(gain_correction_is_clamped) {
+    CurrentLimiter cl;
+    cl.configure(ws2812(), 1000.0f);
+    uint64_t t = kTickUs;
+    cl.update(800.0f, t);
+    // A shorted sense resistor reads ten times the draw; the gain moves toward 2x at most
+    for (int i = 0; i < 50; ++i) {
+        cl.update(800.0f, t += kTickUs);
+        cl.on_measurement(8000.0f, t);
+    }
+    CHECK(cl.gain() <= 2.0f + 1e-6f);
+    CHECK_NEAR(cl.gain(), 2.0, 0.01);
+}
+
+TEST(strips_on_one_rail_share_the_budget_and_learn_the_true_gain) {
+    // Two strips on one sensed 2 A rail, drawing exactly what the model says. The sensor reads their sum.
+    const float budget = 2000.0f;
+    const float est[2] = {1800.0f, 900.0f};
+    leds::RailLimiter rail;
+    rail.configure(budget, 2);
+    CHECK_EQ(rail.members(), 2u);
+    double on_display[2] = {0.0, 0.0};
+    uint64_t t = 0;
+    for (int i = 0; i < 30 * 200; ++i) {
+        t += kTickUs;
+        if (i % 200 == 199) CHECK(rail.on_measurement(static_cast<float>(on_display[0] + on_display[1]), t - 2'000));
+        for (size_t k = 0; k < 2; ++k) on_display[k] = est[k] * scale(rail.update(k, est[k], t));
+    }
+    CHECK_NEAR(rail.gain(), 1.0, 0.01);
+    CHECK_NEAR(rail.total_estimate_ma(), 2700.0, 0.01);
+    // One scale for the rail: the budget splits in proportion to the estimates
+    CHECK_NEAR(on_display[0] + on_display[1], budget, budget * 0.01);
+    CHECK_NEAR(on_display[0] / on_display[1], 2.0, 0.01);
+
+}
+
+TEST(a_limiter_per_strip_misreads_a_shared_rail) {
+    // Three equal strips on one sensed 2 A rail, each with its own limiter fed the rail measurement. Each
+    // sees the others' draw as its own model error, heads for a gain of 3, stops at the 2x clamp, and
+    // together they overdraw the rail by half. The rail limiter holds the budget.
+    const float budget = 2000.0f;
+    const float est = 1200.0f;
+    CurrentLimiter own[3];
+    for (auto& cl : own) cl.configure(ws2812(), budget);
+    leds::RailLimiter rail;
+    rail.configure(budget, 3);
+    double own_draw = 0.0, rail_draw = 0.0;
+    uint64_t t = 0;
+    for (int i = 0; i < 30 * 200; ++i) {
+        t += kTickUs;
+        if (i % 200 == 199) {
+            for (auto& cl : own) cl.on_measurement(static_cast<float>(own_draw), t - 2'000);
+            rail.on_measurement(static_cast<float>(rail_draw), t - 2'000);
+        }
+        own_draw = rail_draw = 0.0;
+        for (size_t k = 0; k < 3; ++k) {
+            own_draw += est * scale(own[k].update(est, t));
+            rail_draw += est * scale(rail.update(k, est, t));
+        }
+    }
+    for (auto& cl : own) CHECK_NEAR(cl.gain(), 2.0, 0.01);
+    CHECK_NEAR(own_draw, 1.5 * budget, budget * 0.01);
+    CHECK_NEAR(rail.gain(), 1.0, 0.01);
+    CHECK_NEAR(rail_draw, budget, budget * 0.01);
+}
+
+TEST(rail_reconfigure_resets_the_gain) {
+    leds::RailLimiter rail;
+    rail.configure(1000.0f, 1);
+    uint64_t t = kTickUs;
+    rail.update(0, 800.0f, t);
+    for (int i = 0; i < 20; ++i) {
+        rail.update(0, 800.0f, t += kTickUs);
+        rail.on_measurement(1200.0f, t);
+    }
+    CHECK(rail.gain() > 1.4f);
+    rail.configure(1000.0f, 3);
+    CHECK_NEAR(rail.gain(), 1.0, 0.0);
+    CHECK_NEAR(rail.total_estimate_ma(), 0.0, 0.0);
+    // Unknown member index only re-evaluates the rail
+    CHECK_EQ(rail.update(7, 5000.0f, t += kTickUs), CurrentLimiter::kUnity);
+}
+
+TEST(rail_current_slots) {
+    CHECK(!rail_current::valid_slot(0, 1));
+    CHECK(!rail_current::valid_slot(5, 1));
+    CHECK(!rail_current::valid_slot(1, 0));
+    CHECK(rail_current::valid_slot(4, 4));
+
+    CHECK_EQ(rail_current::latest(2, 3).timestamp_us, 0u);
+    rail_current::publish(2, 3, 1.25f, 42);
+    rail_current::Sample s = rail_current::latest(2, 3);
+    CHECK_EQ(s.timestamp_us, 42u);
+    CHECK_NEAR(s.amps, 1.25, 0.0);
+    // Neighbouring slots are untouched, invalid slots are dropped
+    CHECK_EQ(rail_current::latest(3, 2).timestamp_us, 0u);
+    rail_current::publish(9, 1, 3.0f, 7);
+    CHECK_EQ(rail_current::latest(9, 1).timestamp_us, 0u);
+}
@@ -0,0 +1,178 @@
+// DashboardPattern fed by synthetic metric streams on the in-process metrics bus: level bar length and
+// threshold colors (normal and inverted scales), the sparkline on a grid, redraws only on new samples, and
+// no heap allocation in update(). The bus is process-wide, so every case uses its own metric names.
+#include "host_test.h"
+#include "fake_strip.h"
+#include "DashboardPattern.h"
+#include "LEDStripBuffer.h"
+#include "metrics_bus.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counts every heap allocation in this test process
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(size_t n) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+using config::LEDConfig;
+using leds::DashboardPattern;
+using leds::LEDStripBuffer;
+
+namespace {
+
+constexpr uint64_t kTickUs = 5'000;
+
+void publish(const char* metric, float v, uint32_t t_ms) {
+    metrics_bus::publish(metric, metrics_bus::SourceKey().add("name").add(metric).value(), "", v, t_ms);
+}
+
+struct Px {
+    uint8_t r, g, b, w;
+    bool operator==(const Px& o) const { return r == o.r && g == o.g && b == o.b && w == o.w; }
+};
+
+Px px(const leds::LEDStrip& s, size_t i) {
+    Px p{};
+    s.get_pixel(i, p.r, p.g, p.b, p.w);
+    return p;
+}
+
+size_t lit(const leds::LEDStrip& s) {
+    size_t n = 0;
+    for (size_t i = 0; i < s.length(); ++i) n += !(px(s, i) == Px{0, 0, 0, 0});
+    return n;
+}
+
+const Px kNormal{0, 160, 0, 0}; // default configured color
+const Px kWarn{255, 120, 0, 0};
+const Px kAlarm{255, 0, 0, 0};
+
+} // namespace
+
+TEST(bar_length_and_threshold_colors) {
+    LEDStripBuffer strip(1, 20, LEDConfig::Chip::WS2812);
+    DashboardPattern p;
+    p.set_start_string("dash_co2:1000:1500");
+    uint64_t t = 0;
+    p.reset(strip, t);
+    CHECK_EQ(lit(strip), 0u); // nothing published yet
+
+    // Full scale is the alarm threshold
+    const struct {
+        float v;
+        size_t lit;
+        Px color;
+    } steps[] = {{750.0f, 10, kNormal}, {1200.0f, 16, kWarn}, {1500.0f, 20, kAlarm}, {4000.0f, 20, kAlarm},
+                 {10.0f, 1, kNormal}};
+    uint32_t t_ms = 0;
+    for (const auto& s : steps) {
+        publish("dash_co2", s.v, ++t_ms);
+        p.update(strip, t += kTickUs);
+        CHECK_EQ(lit(strip), s.lit);
+        CHECK(px(strip, 0) == s.color);
+        CHECK(px(strip, s.lit - 1) == s.color);
+    }
+}
+
+TEST(inverted_thresholds_flag_low_values) {
+    LEDStripBuffer strip(1, 10, LEDConfig::Chip::WS2812);
+    DashboardPattern p;
+    p.set_start_string("dash_battery:20:10");
+    uint64_t t = 0;
+    p.reset(strip, t);
+    const struct {
+        float v;
+        Px color;
+    } steps[] = {{50.0f, kNormal}, {20.0f, kWarn}, {15.0f, kWarn}, {10.0f, kAlarm}, {3.0f, kAlarm}, {21.0f, kNormal}};
+    uint32_t t_ms = 0;
+    for (const auto& s : steps) {
+        publish("dash_battery", s.v, ++t_ms);
+        p.update(strip, t += kTickUs);
+        CHECK(px(strip, 0) == s.color);
+    }
+}
+
+TEST(brightness_scales_the_threshold_colors) {
+    LEDStripBuffer strip(1, 4, LEDConfig::Chip::WS2812);
+    DashboardPattern p;
+    p.set_start_string("dash_dim:10:20");
+    p.set_brightness_percent(50);
+    p.reset(strip, 0);
+    publish("dash_dim", 25.0f, 1);
+    p.update(strip, kTickUs);
+    CHECK(px(strip, 0) == (Px{127, 0, 0, 0}));
+}
+
+TEST(grid_sparkline_follows_the_samples) {
+    // 16 rows: value text on the top 8, sparkline on rows 8..15, newest sample in the rightmost column
+    const size_t rows = 16, cols = 32;
+    LEDStripBuffer strip(rows, cols, LEDConfig::Chip::WS2812);
+    DashboardPattern p;
+    p.set_start_string("dash_temp:8:10");
+    uint64_t t = 0;
+    p.reset(strip, t);
+    for (uint32_t i = 1; i <= 10; ++i) publish("dash_temp", static_cast<float>(i), i);
+    p.update(strip, t += kTickUs);
+
+    auto at = [&](size_t row, size_t col) { return px(strip, strip.index_for_row_col(row, col)); };
+    const size_t first = cols - 10;
+    // Lowest sample: one pixel on the bottom row; highest: the full 8 rows
+    CHECK(!(at(15, first) == Px{0, 0, 0, 0}));
+    CHECK(at(14, first) == (Px{0, 0, 0, 0}));
+    CHECK(at(8, cols - 1) == kAlarm);
+    CHECK(at(15, cols - 1) == (Px{127, 0, 0, 0})); // bar body at half intensity
+    // Heights rise with the values, colors follow each sample's level
+    size_t prev_h = 0;
+    for (size_t i = 0; i < 10; ++i) {
+        size_t h = 0;
+        while (h < 8 && !(at(15 - h, first + i) == Px{0, 0, 0, 0})) ++h;
+        CHECK(h >= prev_h);
+        prev_h = h;
+        const Px tip = at(16 - h, first + i);
+        const float v = static_cast<float>(i + 1);
+        CHECK(tip == (v >= 10.0f ? kAlarm : v >= 8.0f ? kWarn : kNormal));
+    }
+    // Nothing left of the sparkline
+    for (size_t c = 0; c < first; ++c) CHECK(at(15, c) == (Px{0, 0, 0, 0}));
+    // The value text is drawn in the current level's color somewhere in the top rows
+    size_t text_px = 0;
+    for (size_t r = 0; r < 8; ++r)
+        for (size_t c = 0; c < cols; ++c) text_px += at(r, c) == kAlarm;
+    CHECK(text_px > 0);
+}
+
+TEST(redraws_only_on_new_samples_and_never_allocates) {
+    LEDStripBuffer buf(16, 32, LEDConfig::Chip::WS2812);
+    RgbOnlyStrip strip(buf);
+    DashboardPattern p;
+    p.set_start_string("dash_alloc:50:80,dash_alloc_missing");
+    p.set_speed_percent(100); // 2 s dwell per entry, so both entries and the missing-series path run
+    uint64_t t = 0;
+    p.reset(strip, t);
+    publish("dash_alloc", 1.0f, 1);
+
+    size_t redraws = 0, new_samples = 0;
+    const size_t before = g_allocations.load();
+    for (uint32_t frame = 1; frame <= 3000; ++frame) {
+        if (frame % 20 == 0) {
+            publish("dash_alloc", static_cast<float>(frame % 100), frame);
+            ++new_samples;
+        }
+        const size_t w = strip.writes;
+        p.update(strip, t += kTickUs);
+        redraws += strip.writes != w;
+    }
+    const size_t allocations = g_allocations.load() - before;
+    CHECK_EQ(allocations, 0u);
+    // Short text never scrolls: one redraw per sample plus entry switches, not one per frame
+    CHECK(redraws > 0);
+    CHECK(redraws <= new_samples + 3000 * kTickUs / 2'000'000 + 2);
+}
@@ -0,0 +1,218 @@
+// LEDFixedMath.h: every Q16 helper against a double-precision reference, within the bounds documented in
+// the header. Angles and sqrt inputs up to 2^20 are checked exhaustively, the rest on dense sweeps.
+#include "host_test.h"
+#include "LEDFixedMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+using namespace leds;
+
+namespace {
+
+constexpr double kOne = 65536.0;
+
+double to_d(q16_t v) { return v / kOne; }
+
+// Tracks the worst error of a sweep and where it happened, so a failure names the input
+struct Worst {
+    double err = 0.0;
+    double at = 0.0;
+    void add(double e, double x) {
+        if (e > err) {
+            err = e;
+            at = x;
+        }
+    }
+    bool within(const char* what, double bound) const {
+        if (err <= bound) return true;
+        fprintf(stderr, "    %s: error %.4g at %.9g exceeds %.4g\n", what, err, at, bound);
+        return false;
+    }
+};
+
+} // namespace
+
+TEST(mul_div_lerp_round_toward_minus_infinity) {
+    const double vals[] = {0.0, 1.0, -1.0, 0.5, -0.25, 3.75, -100.125, 1.0 / kOne, 181.0, -181.0};
+    for (double a : vals) {
+        for (double b : vals) {
+            const q16_t qa = q16_const(a), qb = q16_const(b);
+            CHECK_EQ(q16_mul(qa, qb), static_cast<q16_t>(std::floor(a * b * kOne)));
+            if (qb != 0 && std::fabs(a / b) < 32767.0) CHECK_EQ(q16_div(qa, qb), static_cast<q16_t>(std::trunc(a / b * kOne)));
+            CHECK_NEAR(to_d(q16_lerp(qa, qb, q16_const(0.25))), a + (b - a) * 0.25, 1.0 / kOne);
+        }
+    }
+    CHECK_EQ(q16_div(kQ16One, 0), INT32_MAX);
+    CHECK_EQ(q16_div(-kQ16One, 0), INT32_MIN);
+    CHECK_EQ(q16_clamp01(-5), 0);
+    CHECK_EQ(q16_clamp01(kQ16One + 1), kQ16One);
+    CHECK_EQ(q16_abs(-7), 7);
+}
+
+TEST(angle_conversion) {
+    CHECK_EQ(angle_from_radians(0.0), 0);
+    CHECK_EQ(angle_from_radians(M_PI / 2), 0x4000);
+    CHECK_EQ(angle_from_radians(M_PI), 0x8000);
+    CHECK_EQ(angle_from_radians(-M_PI / 2), 0xC000);
+    CHECK_EQ(angle_from_radians(5 * M_PI), 0x8000);
+}
+
+TEST(sin_cos_within_2_lsb) {
+    Worst s, c;
+    for (uint32_t a = 0; a < kAngleTurn; ++a) {
+        const double rad = a * 2.0 * M_PI / kAngleTurn;
+        s.add(std::fabs(q16_sin(static_cast<uint16_t>(a)) - std::sin(rad) * kOne), a);
+        c.add(std::fabs(q16_cos(static_cast<uint16_t>(a)) - std::cos(rad) * kOne), a);
+    }
+    CHECK(s.within("sin", 2.0));
+    CHECK(c.within("cos", 2.0));
+    // Exact at the quadrant points
+    CHECK_EQ(q16_sin(0), 0);
+    CHECK_EQ(q16_sin(0x4000), kQ16One);
+    CHECK_EQ(q16_sin(0xC000), -kQ16One);
+}
+
+TEST(log2_within_2_lsb) {
+    Worst w;
+    for (int64_t x = 1; x <= INT32_MAX; x += (x < (1 << 20)) ? 1 : x / 8192) {
+        w.add(std::fabs(q16_log2(static_cast<q16_t>(x)) - std::log2(x / kOne) * kOne), x);
+    }
+    CHECK(w.within("log2", 2.0));
+    CHECK_EQ(q16_log2(kQ16One), 0);
+    CHECK_EQ(q16_log2(4 * kQ16One), 2 * kQ16One);
+    CHECK_EQ(q16_log2(0), INT32_MIN);
+    CHECK_EQ(q16_log2(-1), INT32_MIN);
+}
+
+TEST(exp2_and_exp_within_bounds) {
+    Worst abs2, rel2, abse, rele;
+    for (int32_t x = -17 * 65536; x < 15 * 65536; x += 3) {
+        const double r = std::exp2(x / kOne) * kOne;
+        const double d = std::fabs(q16_exp2(x) - r);
+        if (r <= kOne) abs2.add(d, x / kOne);
+        else if (r < INT32_MAX) rel2.add(d / r, x / kOne);
+    }
+    for (int32_t x = -12 * 65536; x < 10 * 65536; x += 3) {
+        const double r = std::exp(x / kOne) * kOne;
+        if (r >= INT32_MAX) continue;
+        const double d = std::fabs(q16_exp(x) - r);
+        if (r <= kOne) abse.add(d, x / kOne);
+        else rele.add(d / r, x / kOne);
+        if (x <= 0) CHECK_EQ(q16_exp_neg(-x), q16_exp(x));
+    }
+    CHECK(abs2.within("exp2 (<= 1)", 2.0));
+    CHECK(rel2.within("exp2 (> 1, relative)", 1e-4));
+    CHECK(abse.within("exp (<= 1)", 2.0));
+    CHECK(rele.within("exp (> 1, relative)", 1e-4));
+    // Saturation and flush
+    CHECK_EQ(q16_exp2(15 * kQ16One), INT32_MAX);
+    CHECK_EQ(q16_exp2(INT32_MAX), INT32_MAX);
+    CHECK_EQ(q16_exp2(-18 * kQ16One), 0);
+    CHECK_EQ(q16_exp2(0), kQ16One);
+}
+
+TEST(pow_within_1_percent) {
+    Worst w;
+    for (q16_t b = q16_const(0.001); b < q16_const(1000.0); b += b / 97 + 1) {
+        for (q16_t e = q16_const(-4.0); e <= q16_const(4.0); e += 997) {
+            const double r = std::pow(to_d(b), to_d(e));
+            if (r < 1e-3 || r > 1e3) continue;
+            const double d = std::fabs(to_d(q16_pow(b, e)) - r);
+            // 1% relative, or 2 LSB where one LSB is already more than 1% of the result
+            w.add(d / std::max(r * 0.01, 2.0 / kOne), to_d(b));
+        }
+    }
+    CHECK(w.within("pow (fraction of the bound)", 1.0));
+    CHECK_EQ(q16_pow(0, kQ16One), 0);
+    CHECK_EQ(q16_pow(-kQ16One, kQ16One), 0);
+}
+
+TEST(sqrt_within_1_lsb) {
+    Worst w;
+    for (int64_t x = 0; x <= INT32_MAX; x += (x < (1 << 20)) ? 1 : x / 8192) {
+        w.add(std::fabs(q16_sqrt(static_cast<q16_t>(x)) - std::sqrt(x / kOne) * kOne), x);
+    }
+    CHECK(w.within("sqrt", 1.0));
+    CHECK_EQ(q16_sqrt(-kQ16One), 0);
+    CHECK_EQ(q16_sqrt(4 * kQ16One), 2 * kQ16One);
+    CHECK_EQ(isqrt64(UINT64_MAX), 0xFFFFFFFFu);
+}
+
+TEST(hypot_half_within_1_lsb_on_long_strips) {
+    // Center distances as StatusPattern computes them, on strips long enough that the squared half-cell
+    // offset no longer fits 32 bits (1x400: 399^2 << 14 is about 2.6e9)
+    const size_t shapes[][2] = {{1, 400}, {1, 4096}, {8, 1200}, {64, 64}, {1, 1}};
+    Worst w;
+    for (const auto& shape : shapes) {
+        const int64_t rows = static_cast<int64_t>(shape[0]), cols = static_cast<int64_t>(shape[1]);
+        for (int64_t r = 0; r < rows; ++r) {
+            for (int64_t c = 0; c < cols; ++c) {
+                const int64_t dr2 = 2 * r - (rows - 1), dc2 = 2 * c - (cols - 1);
+                const double ref = std::sqrt(static_cast<double>(dr2 * dr2 + dc2 * dc2)) / 2.0 * kOne;
+                const q16_t d = q16_hypot_half(dr2, dc2);
+                CHECK(d >= 0);
+                w.add(std::fabs(d - ref), static_cast<double>(cols * 100000 + c));
+            }
+        }
+    }
+    CHECK(w.within("hypot_half", 1.0));
+    CHECK_EQ(q16_hypot_half(399, 0), q16_const(199.5));
+    CHECK_EQ(q16_hypot_half(-6, 8), 5 * kQ16One);
+    // Saturates instead of wrapping
+    CHECK_EQ(q16_hypot_half(65536, 65536), INT32_MAX);
+    CHECK_EQ(q16_hypot_half(INT64_MIN + 1, 0), INT32_MAX);
+    CHECK_EQ(q16_hypot_half(65535, 0), q16_const(32767.5));
+}
+
+TEST(easing_matches_formulas) {
+    Worst w;
+    for (q16_t t = -kQ16One / 4; t <= kQ16One + kQ16One / 4; t += 7) {
+        const double x = std::clamp(to_d(t), 0.0, 1.0);
+        w.add(std::fabs(to_d(q16_ease_in_quad(t)) - x * x) * kOne, x);
+        w.add(std::fabs(to_d(q16_ease_out_quad(t)) - x * (2 - x)) * kOne, x);
+        const double cubic = x < 0.5 ? 4 * x * x * x : 1 - std::pow(2 - 2 * x, 3) / 2;
+        w.add(std::fabs(to_d(q16_ease_in_out_cubic(t)) - cubic) * kOne, x);
+        w.add(std::fabs(to_d(q16_smoothstep(t)) - x * x * (3 - 2 * x)) * kOne, x);
+        w.add(std::fabs(to_d(q16_smootherstep(t)) - x * x * x * (x * (6 * x - 15) + 10)) * kOne, x);
+    }
+    CHECK(w.within("easing", 2.0));
+    CHECK_EQ(q16_smoothstep(kQ16One), kQ16One);
+    CHECK_EQ(q16_smootherstep(0), 0);
+}
+
+TEST(noise_is_bounded_continuous_and_zero_on_the_lattice) {
+    int64_t max_abs = 0, max_step = 0;
+    for (int i = 0; i < 4; ++i) {
+        const uint32_t seed = 0x1234u * (i + 1);
+        q16_t prev = q16_noise2(0, q16_const(0.37 + i), seed);
+        for (q16_t x = 1; x < 8 * kQ16One; x += 37) {
+            const q16_t n = q16_noise2(x, q16_const(0.37 + i), seed);
+            const q16_t n3 = q16_noise3(x, q16_const(0.37 + i), q16_const(1.9), seed);
+            max_abs = std::max<int64_t>(max_abs, std::max(q16_abs(n), q16_abs(n3)));
+            max_step = std::max<int64_t>(max_step, q16_abs(n - prev));
+            prev = n;
+        }
+        for (int k = -3; k <= 3; ++k) {
+            CHECK_EQ(q16_noise2(k * kQ16One, 5 * kQ16One, seed), 0);
+            CHECK_EQ(q16_noise3(k * kQ16One, -2 * kQ16One, 9 * kQ16One, seed), 0);
+        }
+    }
+    // Unnormalized gradients reach a little beyond 1; a 37-unit step moves the value by a few dozen LSB
+    CHECK(max_abs <= 2 * kQ16One);
+    CHECK(max_step <= 200);
+    CHECK(q16_noise2(q16_const(0.5), q16_const(0.5), 1) != q16_noise2(q16_const(0.5), q16_const(0.5), 2));
+}
+
+TEST(scale_u8_rounds) {
+    for (int c = 0; c < 256; ++c) {
+        for (q16_t f = 0; f <= kQ16One; f += 97) {
+            const double r = c * to_d(f);
+            CHECK_EQ(q16_scale_u8(static_cast<uint8_t>(c), f), static_cast<uint8_t>(std::floor(r + 0.5)));
+        }
+        CHECK_EQ(q16_scale_u8(static_cast<uint8_t>(c), kQ16One), c);
+        CHECK_EQ(q16_scale_u8(static_cast<uint8_t>(c), 2 * kQ16One), c);
+        CHECK_EQ(q16_scale_u8(static_cast<uint8_t>(c), -kQ16One), 0);
+    }
+}
@@ -0,0 +1,260 @@
+// FlipdotPacket.h: encode/decode round trips for keyframes and dirty-box packets over random frame
+// sequences, rejection of malformed packets without touching the receiver's frame, and wire time against
+// the legacy FLIPDOT encoding.
+#include "host_test.h"
+#include "FlipdotPacket.h"
+#include "LEDWireEncoderFlipdot.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace leds::flipdot;
+using Result = PacketDecoder::Result;
+
+namespace {
+
+std::vector<uint8_t> random_frame(std::mt19937& rng, size_t boxes) {
+    std::vector<uint8_t> f(boxes * kBoxBytes);
+    for (auto& b : f) b = static_cast<uint8_t>(rng());
+    return f;
+}
+
+// Change 'n' random boxes of 'f'
+void touch_boxes(std::mt19937& rng, std::vector<uint8_t>& f, size_t n) {
+    const size_t boxes = f.size() / kBoxBytes;
+    for (size_t i = 0; i < n; ++i) f[(rng() % boxes) * kBoxBytes + rng() % kBoxBytes] ^= static_cast<uint8_t>(1u << (rng() % 8));
+}
+
+std::vector<uint8_t> encode(const std::vector<uint8_t>& frame, const std::vector<uint8_t>* previous, bool full,
+                            uint8_t seq) {
+    const size_t boxes = frame.size() / kBoxBytes;
+    std::vector<uint8_t> pkt(max_packet_bytes(boxes));
+    size_t len = encode_packet(frame.data(), previous ? previous->data() : nullptr, boxes, full, seq, pkt.data());
+    pkt.resize(len);
+    return pkt;
+}
+
+// Rewrite the CRC after a deliberate edit so the decoder gets past the checksum to the field checks
+void reseal(std::vector<uint8_t>& pkt) {
+    put_u16(pkt.data() + pkt.size() - kCrcBytes, crc16_ccitt(pkt.data(), pkt.size() - kCrcBytes));
+}
+
+// Both encodings clock bytes with WS2812 symbol timing: 8 bits x 1.25 us
+double wire_ms(size_t bytes) { return static_cast<double>(bytes) * 8 * 1.25 / 1000.0; }
+
+} // namespace
+
+TEST(crc_matches_the_ccitt_false_check_value) {
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    CHECK_EQ(crc16_ccitt(check, sizeof(check)), 0x29B1);
+    CHECK_EQ(crc16_ccitt(nullptr, 0), 0xFFFF);
+    CHECK_EQ(boxes_for_dots(0), 0u);
+    CHECK_EQ(boxes_for_dots(64), 1u);
+    CHECK_EQ(boxes_for_dots(65), 2u);
+    CHECK_EQ(max_packet_bytes(3), kHeaderBytes + 3 * kBoxBytes + kCrcBytes);
+}
+
+TEST(keyframe_round_trip) {
+    std::mt19937 rng(7);
+    const size_t boxes = 12;
+    auto frame = random_frame(rng, boxes);
+    auto pkt = encode(frame, nullptr, false, 42);
+    CHECK_EQ(pkt.size(), max_packet_bytes(boxes));
+    CHECK_EQ(pkt[0], kMagic);
+    CHECK_EQ(pkt[2], kFlagFull);
+    CHECK_EQ(get_u16(pkt.data() + 4), boxes);
+
+    std::vector<uint8_t> rx(boxes * kBoxBytes, 0);
+    PacketDecoder dec(rx.data(), boxes);
+    CHECK(dec.apply(pkt.data(), pkt.size()) == Result::OK);
+    CHECK(rx == frame);
+    CHECK_EQ(dec.last_sequence(), 42);
+    // Dot order: byte j of a box holds positions 8j..8j+7, LSB first
+    for (size_t i = 0; i < boxes * kBoxDots; ++i) CHECK_EQ(dec.dot(i), (frame[i / 8] >> (i % 8)) & 1);
+}
+
+TEST(delta_sequence_round_trip) {
+    std::mt19937 rng(11);
+    for (size_t boxes : {1u, 2u, 5u, 30u, 128u}) {
+        auto frame = random_frame(rng, boxes);
+        auto sent = frame;
+        auto pkt = encode(frame, nullptr, true, 0);
+        std::vector<uint8_t> rx(boxes * kBoxBytes, 0);
+        PacketDecoder dec(rx.data(), boxes);
+        CHECK(dec.apply(pkt.data(), pkt.size()) == Result::OK);
+        for (int i = 1; i < 200; ++i) {
+            touch_boxes(rng, frame, rng() % (boxes + 1));
+            pkt = encode(frame, &sent, false, static_cast<uint8_t>(i));
+            if (frame == sent) {
+                CHECK(pkt.empty()); // nothing changed: nothing sent
+                continue;
+            }
+            CHECK(!pkt.empty());
+            // Never larger than a keyframe
+            CHECK(pkt.size() <= max_packet_bytes(boxes));
+            CHECK(dec.apply(pkt.data(), pkt.size()) == Result::OK);
+            CHECK_EQ(dec.last_sequence(), static_cast<uint8_t>(i));
+            sent = frame;
+            CHECK(rx == frame);
+        }
+    }
+}
+
+TEST(dirty_boxes_carry_indices_until_a_keyframe_is_smaller) {
+    std::mt19937 rng(3);
+    const size_t boxes = 20;
+    auto prev = random_frame(rng, boxes);
+    auto frame = prev;
+    frame[7 * kBoxBytes] ^= 1;
+    frame[13 * kBoxBytes + 5] ^= 0x80;
+    auto pkt = encode(frame, &prev, false, 1);
+    CHECK_EQ(pkt[2], 0);
+    CHECK_EQ(get_u16(pkt.data() + 4), 2);
+    CHECK_EQ(pkt.size(), kHeaderBytes + 2 * (kBoxBytes + 2) + kCrcBytes);
+    CHECK_EQ(get_u16(pkt.data() + kHeaderBytes), 7);
+    CHECK_EQ(get_u16(pkt.data() + kHeaderBytes + kBoxBytes + 2), 13);
+    // 16 of 20 dirty: 16 * 10 bytes >= 20 * 8, so a keyframe goes out instead
+    for (size_t b = 0; b < 16; ++b) frame[b * kBoxBytes + 1] ^= 0x10;
+    pkt = encode(frame, &prev, false, 2);
+    CHECK_EQ(pkt[2], kFlagFull);
+    CHECK_EQ(get_u16(pkt.data() + 4), boxes);
+    // Forced keyframe even without changes
+    pkt = encode(prev, &prev, true, 3);
+    CHECK_EQ(pkt.size(), max_packet_bytes(boxes));
+}
+
+TEST(every_corrupted_byte_and_length_is_rejected) {
+    std::mt19937 rng(5);
+    const size_t boxes = 6;
+    auto base = random_frame(rng, boxes);
+    auto frame = base;
+    touch_boxes(rng, frame, 2);
+    for (const auto& pkt : {encode(frame, nullptr, true, 9), encode(frame, &base, false, 9)}) {
+        std::vector<uint8_t> rx = base;
+        PacketDecoder dec(rx.data(), boxes);
+        for (size_t i = 0; i < pkt.size(); ++i) {
+            for (int bit = 0; bit < 8; ++bit) {
+                auto bad = pkt;
+                bad[i] ^= static_cast<uint8_t>(1u << bit);
+                CHECK(dec.apply(bad.data(), bad.size()) != Result::OK);
+            }
+        }
+        for (size_t len = 0; len < pkt.size(); ++len) CHECK(dec.apply(pkt.data(), len) != Result::OK);
+        auto longer = pkt;
+        longer.push_back(0);
+        CHECK(dec.apply(longer.data(), longer.size()) != Result::OK);
+        CHECK(rx == base); // untouched by all of the above
+        CHECK(dec.apply(pkt.data(), pkt.size()) == Result::OK);
+        CHECK(rx == frame);
+    }
+}
+
+TEST(well_formed_but_invalid_packets_are_rejected) {
+    std::mt19937 rng(9);
+    const size_t boxes = 4;
+    auto base = random_frame(rng, boxes);
+    auto frame = base;
+    frame[2 * kBoxBytes] ^= 1;
+    const auto delta = encode(frame, &base, false, 1);
+    const auto key = encode(frame, nullptr, true, 1);
+    std::vector<uint8_t> rx = base;
+    PacketDecoder dec(rx.data(), boxes);
+
+    uint8_t tiny[kHeaderBytes + kCrcBytes - 1] = {};
+    CHECK(dec.apply(tiny, sizeof(tiny)) == Result::BAD_LENGTH);
+
+    auto p = delta;
+    p[0] = 0xAA;
+    reseal(p);
+    CHECK(dec.apply(p.data(), p.size()) == Result::BAD_HEADER);
+    p = delta;
+    p[1] = kVersion + 1;
+    reseal(p);
+    CHECK(dec.apply(p.data(), p.size()) == Result::BAD_HEADER);
+
+    p = delta;
+    p[p.size() - 1] ^= 0xFF;
+    CHECK(dec.apply(p.data(), p.size()) == Result::BAD_CRC);
+
+    // Chain length disagrees with the receiver
+    p = delta;
+    put_u16(p.data() + 6, boxes + 1);
+    reseal(p);
+    CHECK(dec.apply(p.data(), p.size()) == Result::BAD_BOX);
+
+    // Box index past the chain
+    p = delta;
+    put_u16(p.data() + kHeaderBytes, boxes);
+    reseal(p);
+    CHECK(dec.apply(p.data(), p.size()) == Result::BAD_BOX);
+
+    // Record count that does not match the length
+    p = delta;
+    put_u16(p.data() + 4, 2);
+    reseal(p);
+    CHECK(dec.apply(p.data(), p.size()) == Result::BAD_LENGTH);
+    p = delta;
+    put_u16(p.data() + 4, 0xFFFF);
+    reseal(p);
+    CHECK(dec.apply(p.data(), p.size()) == Result::BAD_LENGTH);
+
+    // Delta records reinterpreted as a keyframe, and a keyframe with too few boxes
+    p = delta;
+    p[2] = kFlagFull;
+    reseal(p);
+    CHECK(dec.apply(p.data(), p.size()) != Result::OK);
+    p = key;
+    put_u16(p.data() + 4, boxes - 1);
+    p.erase(p.end() - kCrcBytes - kBoxBytes, p.end() - kCrcBytes);
+    reseal(p);
+    CHECK(dec.apply(p.data(), p.size()) == Result::BAD_BOX);
+
+    // A bad record after a good one must not apply the good one
+    auto two = frame;
+    two[0] ^= 1;
+    p = encode(two, &base, false, 2);
+    CHECK_EQ(get_u16(p.data() + 4), 2);
+    put_u16(p.data() + kHeaderBytes + kBoxBytes + 2, 77);
+    reseal(p);
+    CHECK(dec.apply(p.data(), p.size()) == Result::BAD_BOX);
+
+    CHECK(rx == base);
+    CHECK(dec.apply(delta.data(), delta.size()) == Result::OK);
+    CHECK(rx == frame);
+}
+
+TEST(wire_time_against_the_legacy_encoding) {
+    // 32x64 panel: 2048 dots, 32 boxes. Legacy sends one channel byte per dot (three dots per WS2812 LED).
+    const size_t dots = 32 * 64;
+    const size_t boxes = boxes_for_dots(dots);
+    const size_t legacy_bytes = leds::internal::WireEncoderFlipdot::frame_bytes_for(dots);
+    CHECK_EQ(legacy_bytes, 2049u);
+
+    std::mt19937 rng(5);
+    auto frame = random_frame(rng, boxes);
+    const size_t key_bytes = encode(frame, nullptr, true, 0).size();
+    auto next = frame;
+    next[17 * kBoxBytes + 3] ^= 0x10; // one dot flips
+    const size_t one_box_bytes = encode(next, &frame, false, 1).size();
+    CHECK(encode(frame, &frame, false, 2).empty()); // unchanged frame: nothing on the wire
+
+    // Clock face: a few boxes change per minute
+    double clock_ms = 0;
+    auto prev = frame;
+    for (int minute = 0; minute < 60; ++minute) {
+        auto cur = prev;
+        touch_boxes(rng, cur, 4);
+        clock_ms += wire_ms(encode(cur, &prev, false, static_cast<uint8_t>(minute)).size());
+        prev = cur;
+    }
+    clock_ms /= 60;
+
+    printf("32x64 wire time: legacy %.2f ms, keyframe %.2f ms, one box %.2f ms, 4-box update %.2f ms\n",
+           wire_ms(legacy_bytes), wire_ms(key_bytes), wire_ms(one_box_bytes), clock_ms);
+    CHECK_NEAR(wire_ms(legacy_bytes), 20.49, 0.01);
+    CHECK_NEAR(wire_ms(key_bytes), 2.66, 0.01);
+    CHECK_NEAR(wire_ms(one_box_bytes), 0.20, 0.01);
+    CHECK(wire_ms(key_bytes) * 7 < wire_ms(legacy_bytes));
+    CHECK(clock_ms < 0.6);
+}
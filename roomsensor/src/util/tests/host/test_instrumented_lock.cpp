@@ -0,0 +1,214 @@
+// instrumented_lock.cpp and lock_stats.h: histogram and slow-wait bookkeeping, then the real lock code
+// on std::thread (stubs/freertos) with tasks of different priorities contending for it.
+#include "host_test.h"
+#include "instrumented_lock.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void sleep_us(int us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+
+uint32_t histogram_total(const lock_histogram_t& h) {
+    uint32_t n = 0;
+    for (uint32_t c : h.count) n += c;
+    return n;
+}
+
+// The window of one lock from instrumented_lock_take_stats; other tests' locks are skipped
+lock_stats_t take_window(const char* name) {
+    struct Ctx {
+        const char* name;
+        lock_stats_t out;
+        int seen;
+    } ctx = {name, {}, 0};
+    instrumented_lock_take_stats(
+        [](const char* n, const lock_stats_t* w, void* p) {
+            Ctx* c = static_cast<Ctx*>(p);
+            if (strcmp(n, c->name) != 0) return;
+            c->out = *w;
+            c->seen++;
+        },
+        &ctx);
+    CHECK_EQ(ctx.seen, 1);
+    return ctx.out;
+}
+
+} // namespace
+
+TEST(histogram_buckets_are_decades) {
+    CHECK_EQ(lock_histogram_bucket(0), 0);
+    CHECK_EQ(lock_histogram_bucket(9), 0);
+    CHECK_EQ(lock_histogram_bucket(10), 1);
+    CHECK_EQ(lock_histogram_bucket(99), 1);
+    CHECK_EQ(lock_histogram_bucket(999), 2);
+    CHECK_EQ(lock_histogram_bucket(1000), 3);
+    CHECK_EQ(lock_histogram_bucket(9'999'999), 6);
+    CHECK_EQ(lock_histogram_bucket(10'000'000), 7);
+    CHECK_EQ(lock_histogram_bucket(UINT32_MAX), 7);
+    lock_histogram_t h = {};
+    lock_histogram_add(&h, 5);
+    lock_histogram_add(&h, 50'000);
+    CHECK_EQ(h.count[0], 1u);
+    CHECK_EQ(h.count[4], 1u);
+    CHECK_EQ(h.max_us, 50'000u);
+    CHECK_EQ(h.total_us, 50'005u);
+}
+
+TEST(slow_waits_keep_the_latest_oldest_first) {
+    lock_stats_t s = {};
+    const char* names[] = {"a", "b", "c", "d", "e", "f"};
+    lock_stats_on_acquired(&s, 5, nullptr, 100, 1); // uncontended: no record
+    for (uint32_t i = 0; i < 6; ++i) {
+        lock_contention_t who = {names[i], "owner-with-a-long-name", 5, static_cast<uint8_t>(i < 3 ? 9 : 2)};
+        lock_stats_on_acquired(&s, 100 + i, &who, 100, 1000 + i);
+        lock_stats_on_acquired(&s, 99, &who, 100, 0); // contended but under the threshold
+    }
+    CHECK_EQ(s.acquisitions, 13u);
+    CHECK_EQ(s.contended, 12u);
+    CHECK_EQ(s.inversions, 6u);
+    CHECK_EQ(s.slow_waits, 6u);
+    CHECK_EQ(lock_stats_slow_count(&s), static_cast<uint32_t>(LOCK_STATS_SLOW_WAITS));
+    for (uint32_t i = 0; i < lock_stats_slow_count(&s); ++i) {
+        const lock_slow_wait_t* w = lock_stats_slow_at(&s, i);
+        CHECK_EQ(w->wait_us, 102u + i);
+        CHECK_EQ(w->waiter[0], names[2 + i][0]);
+        CHECK_EQ(strlen(w->owner), static_cast<size_t>(LOCK_STATS_NAME_LEN - 1));
+    }
+    lock_contention_t who = {nullptr, nullptr, 1, 1};
+    lock_stats_on_timeout(&s, &who);
+    CHECK_EQ(s.timeouts, 1u);
+    CHECK_EQ(s.inversions, 6u);
+}
+
+TEST(counts_are_exact_under_heavy_contention) {
+    instrumented_lock_t* lock = instrumented_lock_create("hammer", 0);
+    CHECK(lock != nullptr);
+    if (!lock) return;
+    take_window("hammer");
+    constexpr int kThreads = 8, kTakes = 20000;
+    std::vector<host_task> tasks(kThreads);
+    uint64_t counter = 0; // guarded by the lock only
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        tasks[t] = {"hammer", static_cast<UBaseType_t>(t + 1)};
+        threads.emplace_back([&, t] {
+            host_task_enter(&tasks[t]);
+            for (int i = 0; i < kTakes; ++i) {
+                CHECK(instrumented_lock_take(lock, portMAX_DELAY));
+                ++counter;
+                instrumented_lock_give(lock);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    CHECK_EQ(counter, static_cast<uint64_t>(kThreads) * kTakes);
+    const lock_stats_t s = take_window("hammer");
+    CHECK_EQ(s.acquisitions, static_cast<uint32_t>(kThreads * kTakes));
+    CHECK_EQ(histogram_total(s.wait), s.acquisitions);
+    CHECK_EQ(histogram_total(s.hold), s.acquisitions);
+    CHECK(s.contended > 0);
+    CHECK(s.contended <= s.acquisitions);
+    CHECK(s.inversions <= s.contended);
+    CHECK_EQ(s.timeouts, 0u);
+    CHECK_EQ(s.slow_waits, 0u); // threshold 0 disables the record
+    // The window was handed over and reset
+    const lock_stats_t again = take_window("hammer");
+    CHECK_EQ(again.acquisitions, 0u);
+    CHECK_EQ(histogram_total(again.hold), 0u);
+    instrumented_lock_delete(lock);
+}
+
+TEST(low_priority_holder_shows_up_as_inversion_and_slow_wait) {
+    // The console pattern: a low-priority logger holds the lock for milliseconds, a high-priority task
+    // needs it briefly
+    instrumented_lock_t* lock = instrumented_lock_create("console", 1000);
+    CHECK(lock != nullptr);
+    if (!lock) return;
+    host_task logger_task = {"logger", 1}, led_task = {"led", 20};
+    std::atomic<bool> stop{false};
+    std::atomic<uint32_t> logger_takes{0};
+    std::thread logger([&] {
+        host_task_enter(&logger_task);
+        while (!stop.load()) {
+            instrumented_lock_take(lock, portMAX_DELAY);
+            sleep_us(3000);
+            instrumented_lock_give(lock);
+            logger_takes++;
+            sleep_us(500);
+        }
+    });
+    std::thread led([&] {
+        host_task_enter(&led_task);
+        for (int i = 0; i < 200; ++i) {
+            instrumented_lock_take(lock, portMAX_DELAY);
+            sleep_us(20);
+            instrumented_lock_give(lock);
+            sleep_us(1500);
+        }
+    });
+    led.join();
+    stop = true;
+    logger.join();
+
+    const lock_stats_t s = take_window("console");
+    CHECK_EQ(s.acquisitions, 200u + logger_takes.load());
+    CHECK_EQ(histogram_total(s.hold), s.acquisitions);
+    CHECK(s.contended > 0);
+    CHECK(s.inversions > 0);
+    CHECK(s.slow_waits > 0);
+    CHECK(s.hold.max_us >= 3000);
+    // Every logger hold lands at 1 ms or above (a host sleep can overshoot past the 10 ms bucket)
+    uint32_t long_holds = 0;
+    for (int b = 3; b < LOCK_STATS_BUCKETS; ++b) long_holds += s.hold.count[b];
+    CHECK(long_holds >= logger_takes.load());
+    CHECK(s.wait.max_us >= 1000);
+    uint32_t led_behind_logger = 0;
+    for (uint32_t i = 0; i < lock_stats_slow_count(&s); ++i) {
+        const lock_slow_wait_t* w = lock_stats_slow_at(&s, i);
+        CHECK(w->wait_us >= 1000);
+        if (i > 0) CHECK(w->at_us >= lock_stats_slow_at(&s, i - 1)->at_us);
+        if (strcmp(w->waiter, "led") == 0 && strcmp(w->owner, "logger") == 0) {
+            CHECK_EQ(w->waiter_prio, 20);
+            CHECK_EQ(w->owner_prio, 1);
+            ++led_behind_logger;
+        }
+    }
+    CHECK(led_behind_logger > 0);
+    instrumented_lock_delete(lock);
+}
+
+TEST(timeouts_are_counted_and_leave_the_lock_usable) {
+    instrumented_lock_t* lock = instrumented_lock_create("timeout", 1000);
+    CHECK(lock != nullptr);
+    if (!lock) return;
+    host_task low = {"low", 2}, high = {"high", 9};
+    std::atomic<bool> held{false}, done{false};
+    std::thread holder([&] {
+        host_task_enter(&low);
+        instrumented_lock_take(lock, portMAX_DELAY);
+        held = true;
+        while (!done.load()) sleep_us(200);
+        instrumented_lock_give(lock);
+    });
+    while (!held.load()) sleep_us(100);
+    host_task_enter(&high);
+    CHECK(!instrumented_lock_take(lock, pdMS_TO_TICKS(5)));
+    CHECK(!instrumented_lock_take(lock, 0));
+    done = true;
+    holder.join();
+    CHECK(instrumented_lock_take(lock, pdMS_TO_TICKS(5)));
+    instrumented_lock_give(lock);
+    host_task_enter(nullptr);
+
+    const lock_stats_t s = take_window("timeout");
+    CHECK_EQ(s.timeouts, 2u);
+    CHECK_EQ(s.inversions, 2u);
+    CHECK_EQ(s.acquisitions, 2u);
+    CHECK_EQ(s.slow_waits, 0u);
+    instrumented_lock_delete(lock);
+}
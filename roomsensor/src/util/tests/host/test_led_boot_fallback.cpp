@@ -0,0 +1,125 @@
+// LEDBootFallback.h: the boot record's pattern and knobs stand in for runtime keys the configuration has
+// not set, per key, until the configuration sets them; the record stays matched to its strip by data GPIO.
+// Also LEDConfig::is_valid for enum values read back from the record.
+#include "host_test.h"
+#include "LEDBootFallback.h"
+
+#include <cstring>
+
+using config::LEDConfig;
+using leds::BootFallback;
+using leds::LEDBootStrip;
+
+namespace {
+
+LEDBootStrip record() {
+    LEDBootStrip b;
+    memset(&b, 0, sizeof(b));
+    b.data_gpio = 5;
+    b.pattern = static_cast<int8_t>(LEDConfig::Pattern::RAINBOW);
+    b.rows = 8;
+    b.cols = 32;
+    b.speed = 70;
+    b.r = 10; b.g = 20; b.b = 30; b.w = 40;
+    b.brightness = 35;
+    b.flags = LEDBootStrip::kDma | LEDBootStrip::kHasColor | LEDBootStrip::kHasBrightness;
+    return b;
+}
+
+// What LEDBootStrip::from_config makes of a configuration with no runtime keys
+LEDBootStrip unset_record() {
+    LEDBootStrip b;
+    memset(&b, 0, sizeof(b));
+    b.data_gpio = 5;
+    b.pattern = static_cast<int8_t>(LEDConfig::Pattern::OFF);
+    b.rows = 8;
+    b.cols = 32;
+    b.speed = 50;
+    return b;
+}
+
+void strip_on(LEDConfig& cfg, const char* gpio) { CHECK_EQ(cfg.apply_update("dataGPIO", gpio), ESP_OK); }
+
+} // namespace
+
+TEST(unset_keys_fall_back_to_the_record) {
+    LEDConfig cfg("led1");
+    strip_on(cfg, "5");
+    BootFallback fb(record());
+    CHECK(fb.matches(cfg));
+    fb.settle(cfg);
+    CHECK(fb.pattern(cfg) == LEDConfig::Pattern::RAINBOW);
+    CHECK(fb.dma(cfg));
+    CHECK(fb.has(BootFallback::kColor) && fb.has(BootFallback::kBrightness) && fb.has(BootFallback::kSpeed));
+
+    // Saving the boot state keeps the record's values instead of OFF and no colour
+    LEDBootStrip out = unset_record();
+    fb.overlay(out);
+    CHECK(memcmp(&out, &fb.record(), sizeof(out)) == 0);
+}
+
+TEST(each_key_goes_to_the_configuration_once_set) {
+    LEDConfig cfg("led1");
+    strip_on(cfg, "5");
+    BootFallback fb(record());
+
+    CHECK_EQ(cfg.apply_update("brightness", "80"), ESP_OK);
+    fb.settle(cfg);
+    CHECK(!fb.has(BootFallback::kBrightness));
+    CHECK(fb.pattern(cfg) == LEDConfig::Pattern::RAINBOW); // the rest still falls back
+    LEDBootStrip out = unset_record();
+    out.flags = LEDBootStrip::kHasBrightness;
+    out.brightness = 80;
+    fb.overlay(out);
+    CHECK_EQ(out.brightness, 80);
+    CHECK(out.pattern == static_cast<int8_t>(LEDConfig::Pattern::RAINBOW));
+
+    // One channel set takes the whole colour from the configuration
+    CHECK_EQ(cfg.apply_update("G", "255"), ESP_OK);
+    fb.settle(cfg);
+    CHECK(!fb.has(BootFallback::kColor));
+
+    CHECK_EQ(cfg.apply_update("pattern", "SOLID"), ESP_OK);
+    CHECK_EQ(cfg.apply_update("dma", "false"), ESP_OK);
+    fb.settle(cfg);
+    CHECK(fb.pattern(cfg) == LEDConfig::Pattern::SOLID);
+    CHECK(!fb.dma(cfg));
+
+    // Cleared again: the configuration's default, not the record
+    CHECK_EQ(cfg.apply_update("dma", ""), ESP_OK);
+    CHECK(!cfg.has_dma());
+    fb.settle(cfg);
+    CHECK(!fb.dma(cfg));
+
+    CHECK_EQ(cfg.apply_update("speed", "10"), ESP_OK);
+    fb.settle(cfg);
+    CHECK(!fb.matches(cfg)); // nothing left to fall back
+}
+
+TEST(record_only_matches_its_own_strip) {
+    BootFallback fb(record());
+    LEDConfig moved("led1");
+    strip_on(moved, "6");
+    CHECK(!fb.matches(moved));
+    LEDConfig unplaced("led2");
+    CHECK(!fb.matches(unplaced));
+    BootFallback none;
+    LEDConfig cfg("led1");
+    strip_on(cfg, "5");
+    CHECK(!none.matches(cfg));
+}
+
+TEST(enum_values_from_the_record_are_range_checked) {
+    CHECK(LEDConfig::is_valid(LEDConfig::Pattern::OFF));
+    CHECK(LEDConfig::is_valid(LEDConfig::Pattern::DASHBOARD));
+    CHECK(!LEDConfig::is_valid(LEDConfig::Pattern::INVALID));
+    CHECK(!LEDConfig::is_valid(static_cast<LEDConfig::Pattern>(19)));
+    CHECK(!LEDConfig::is_valid(static_cast<LEDConfig::Pattern>(127)));
+    CHECK(LEDConfig::is_valid(LEDConfig::Chip::WS2812));
+    CHECK(LEDConfig::is_valid(LEDConfig::Chip::FLIPDOT_PACKED));
+    CHECK(!LEDConfig::is_valid(LEDConfig::Chip::INVALID));
+    CHECK(!LEDConfig::is_valid(static_cast<LEDConfig::Chip>(5)));
+    CHECK(LEDConfig::is_valid(LEDConfig::Layout::FLIPDOT_GRID));
+    CHECK(!LEDConfig::is_valid(static_cast<LEDConfig::Layout>(5)));
+    CHECK(!LEDConfig::is_valid(static_cast<LEDConfig::Layout>(255)));
+}
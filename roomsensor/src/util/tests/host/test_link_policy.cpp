@@ -0,0 +1,194 @@
+// link_policy.h: the checked-in link traces (fixtures/link_policy/*.csv, one 5 s sample per line) replayed
+// through step(). Every trace is held to the rules in the header tick by tick, and each scenario to what
+// it is there for.
+#include "host_test.h"
+#include "link_policy.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace link_policy;
+
+namespace {
+
+struct Tick {
+    Sample in;
+    Decision out;
+};
+
+std::vector<Sample> load_trace(const char* name) {
+    std::vector<Sample> trace;
+    const std::string path = std::string("fixtures/link_policy/") + name + ".csv";
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) {
+        fprintf(stderr, "    cannot open %s\n", path.c_str());
+        return trace;
+    }
+    char line[160];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        int rssi = 0;
+        unsigned tx = 0, streaming = 0, bto = 0, disc = 0, outbox = 0;
+        if (sscanf(line, "%d,%u,%u,%u,%u,%u", &rssi, &tx, &streaming, &bto, &disc, &outbox) != 6) {
+            fprintf(stderr, "    %s: bad line: %s", path.c_str(), line);
+            trace.clear();
+            break;
+        }
+        Sample s;
+        s.rssi_dbm = static_cast<int8_t>(rssi);
+        s.tx_bytes = tx;
+        s.streaming = streaming != 0;
+        s.beacon_timeouts = static_cast<uint16_t>(bto);
+        s.disconnects = static_cast<uint16_t>(disc);
+        s.outbox_bytes = outbox;
+        trace.push_back(s);
+    }
+    fclose(f);
+    return trace;
+}
+
+bool unhealthy_sample(const Sample& x, const Params& p) {
+    return x.beacon_timeouts || x.disconnects || x.outbox_bytes > p.outbox_unhealthy_bytes ||
+           (x.rssi_dbm != 0 && x.rssi_dbm < p.rssi_weak_dbm);
+}
+
+// Replay from a fresh state, checking the rules that hold on every tick of every trace
+std::vector<Tick> replay(const char* name, const Params& p = Params()) {
+    const std::vector<Sample> trace = load_trace(name);
+    CHECK(trace.size() >= 100);
+    std::vector<Tick> ticks;
+    State s;
+    uint8_t floor = 0;        // one step above the last failing level
+    size_t floor_since = 0;   // healthy ticks since it was set
+    size_t healthy_run = 0;   // consecutive healthy, strong, associated ticks
+    size_t quiet_run = 0;     // consecutive quiet ticks
+    for (size_t i = 0; i < trace.size(); ++i) {
+        const Sample& x = trace[i];
+        const uint8_t before = clamp_qdbm(s.tx_qdbm, p); // State starts at 80 whatever the ceiling
+        const Decision d = step(s, x, p);
+        ticks.push_back({x, d});
+        const bool bad = unhealthy_sample(x, p);
+        CHECK_EQ(d.unhealthy, bad);
+        CHECK(d.tx_qdbm >= p.tx_min_qdbm && d.tx_qdbm <= p.tx_max_qdbm);
+
+        if (bad) {
+            // Trouble: up two steps, and the level that failed bounds the next descent
+            CHECK(d.tx_qdbm == p.tx_max_qdbm || d.tx_qdbm == before + 2 * p.tx_step_qdbm);
+            if (before < p.tx_max_qdbm) floor = clamp_qdbm(before + p.tx_step_qdbm, p);
+            floor_since = 0;
+            healthy_run = 0;
+        } else if (x.rssi_dbm != 0) {
+            if (floor && ++floor_since >= p.floor_hold_ticks) floor = 0;
+            healthy_run = x.rssi_dbm >= p.rssi_strong_dbm ? healthy_run + 1 : 0;
+            // Down one step at most, only after enough strong healthy ticks, never below the floor
+            CHECK(d.tx_qdbm <= before);
+            if (d.tx_qdbm < before) {
+                CHECK(before - d.tx_qdbm <= p.tx_step_qdbm);
+                CHECK(healthy_run >= p.healthy_ticks_for_step);
+                CHECK(d.tx_qdbm >= floor);
+            }
+        } else {
+            CHECK_EQ(d.tx_qdbm, before); // not associated, nothing to judge
+        }
+
+        const bool quiet = !x.streaming && !bad && x.tx_bytes <= p.idle_tx_bytes;
+        quiet_run = quiet ? quiet_run + 1 : 0;
+        if (x.streaming) {
+            CHECK(d.ps == PowerSave::None);
+        } else if (d.ps == PowerSave::MaxModem) {
+            CHECK(quiet_run >= p.idle_ticks_for_max);
+        } else {
+            CHECK(d.ps == PowerSave::MinModem);
+            if (quiet_run >= p.idle_ticks_for_max) CHECK(x.tx_bytes >= p.busy_tx_bytes);
+        }
+    }
+    return ticks;
+}
+
+size_t count_ps(const std::vector<Tick>& t, size_t from, size_t to, PowerSave ps) {
+    size_t n = 0;
+    for (size_t i = from; i < to && i < t.size(); ++i) n += t[i].out.ps == ps;
+    return n;
+}
+
+} // namespace
+
+TEST(quiet_strong_link_saves_power) {
+    const Params p;
+    const auto t = replay("quiet_strong");
+    if (t.empty()) return;
+    for (const Tick& k : t) CHECK(!k.out.unhealthy);
+    // 11.5 dB of TX power shaved in 2 dBm steps every 30 s, then held at the minimum
+    const size_t steps = (p.tx_max_qdbm - p.tx_min_qdbm + p.tx_step_qdbm - 1) / p.tx_step_qdbm;
+    CHECK(t[steps * p.healthy_ticks_for_step - 2].out.tx_qdbm > p.tx_min_qdbm);
+    CHECK_EQ(t[steps * p.healthy_ticks_for_step - 1].out.tx_qdbm, p.tx_min_qdbm);
+    CHECK_EQ(t.back().out.tx_qdbm, p.tx_min_qdbm);
+    // Between telemetry bursts the node sleeps through DTIMs
+    CHECK(count_ps(t, 0, t.size(), PowerSave::MaxModem) * 3 >= t.size());
+    CHECK_EQ(count_ps(t, 0, t.size(), PowerSave::None), 0u);
+}
+
+TEST(ota_download_holds_the_radio_awake) {
+    const auto t = replay("ota_download");
+    if (t.empty()) return;
+    for (size_t i = 0; i < t.size(); ++i) CHECK_EQ(t[i].out.ps == PowerSave::None, t[i].in.streaming);
+    CHECK_EQ(count_ps(t, 30, 90, PowerSave::None), 60u);
+    // Modem sleep picks up again once the download is over
+    CHECK(count_ps(t, 90, 90 + Params().idle_ticks_for_max, PowerSave::MaxModem) == 0);
+    CHECK(count_ps(t, 90, t.size(), PowerSave::MaxModem) > 0);
+}
+
+TEST(fading_edge_raises_power_and_remembers_where_it_failed) {
+    const Params p;
+    const auto t = replay("fading_edge");
+    if (t.empty()) return;
+    // Strong at the start: power comes down
+    uint8_t lowest_early = p.tx_max_qdbm;
+    for (size_t i = 0; i < 80; ++i) lowest_early = std::min(lowest_early, t[i].out.tx_qdbm);
+    CHECK(lowest_early < p.tx_max_qdbm);
+    // At the edge: full power
+    for (size_t i = 160; i < 200; ++i) CHECK_EQ(t[i].out.tx_qdbm, p.tx_max_qdbm);
+    // Back in range: power comes down again, but within the floor hold it stays above the early low
+    CHECK(t.back().out.tx_qdbm < p.tx_max_qdbm);
+    CHECK(t.back().out.tx_qdbm > lowest_early);
+    CHECK_EQ(count_ps(t, 150, 200, PowerSave::MaxModem), 0u);
+}
+
+TEST(broker_outage_counts_as_uplink_trouble) {
+    const Params p;
+    const auto t = replay("broker_outage");
+    if (t.empty()) return;
+    size_t unhealthy = 0;
+    for (size_t i = 0; i < t.size(); ++i) {
+        CHECK_EQ(t[i].out.unhealthy, t[i].in.outbox_bytes > p.outbox_unhealthy_bytes);
+        unhealthy += t[i].out.unhealthy;
+    }
+    CHECK(unhealthy >= 40);
+    CHECK_EQ(t[99].out.tx_qdbm, p.tx_max_qdbm);
+    CHECK_EQ(count_ps(t, 60, 100, PowerSave::MaxModem), 0u);
+    CHECK(t.back().out.tx_qdbm < p.tx_max_qdbm);
+}
+
+TEST(reassociation_goes_to_full_power) {
+    const Params p;
+    const auto t = replay("reassociation");
+    if (t.empty()) return;
+    CHECK(t[49].out.tx_qdbm < p.tx_max_qdbm);
+    CHECK(t[50].out.unhealthy);
+    CHECK(t[55].out.unhealthy);
+    CHECK_EQ(t[62].out.tx_qdbm, p.tx_max_qdbm);
+    CHECK(t.back().out.tx_qdbm < p.tx_max_qdbm);
+}
+
+TEST(lower_tx_ceiling_is_respected) {
+    // link_manager.cpp lowers tx_max_qdbm from the wifi configuration and tx_min with it when needed
+    Params p;
+    p.tx_max_qdbm = 40;
+    for (const char* name : {"quiet_strong", "fading_edge", "reassociation"}) {
+        for (const Tick& k : replay(name, p)) CHECK(k.out.tx_qdbm <= 40);
+    }
+    p.tx_max_qdbm = p.tx_min_qdbm = 20;
+    for (const Tick& k : replay("fading_edge", p)) CHECK_EQ(k.out.tx_qdbm, 20);
+}
@@ -0,0 +1,138 @@
+// metrics_bus.h: series identity from tag content, history and overwrite, lookups, a writer racing a reader,
+// and table exhaustion. The bus is a process-wide table, so every case uses its own metric names and the
+// exhaustion case runs last.
+#include "host_test.h"
+#include "metrics_bus.h"
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+namespace {
+
+// A driver's tag collection, reused for several sources the way MCP23008Sensor does for its pins
+struct Tags {
+    const char* keys[4] = {"type", "io", "index", "name"};
+    char values[4][24] = {"MCP23008", "1", "", ""};
+
+    uint32_t key() const {
+        metrics_bus::SourceKey k;
+        for (int i = 0; i < 4; ++i) k.add(keys[i]).add(values[i]);
+        return k.value();
+    }
+    void set_pin(int pin, const char* name) {
+        snprintf(values[2], sizeof(values[2]), "%d", pin);
+        snprintf(values[3], sizeof(values[3]), "%s", name);
+    }
+};
+
+} // namespace
+
+TEST(source_key_separates_strings) {
+    using metrics_bus::SourceKey;
+    CHECK(SourceKey().add("ab").add("c").value() != SourceKey().add("a").add("bc").value());
+    CHECK(SourceKey().add("index").add("1").value() != SourceKey().add("index").add("2").value());
+    CHECK_EQ(SourceKey().add("x").value(), SourceKey().add("x").value());
+    CHECK(SourceKey().add(nullptr).value() == SourceKey().add("").value());
+}
+
+TEST(one_series_per_pin_of_a_shared_tag_collection) {
+    Tags tags;
+    const char* names[8] = {"door", "window", "water", "p4", "p5", "p6", "p7", "p8"};
+    const size_t before = metrics_bus::series_count();
+    // Three rounds of contact changes on all eight pins through the one collection
+    for (int round = 0; round < 3; ++round) {
+        for (int pin = 1; pin <= 8; ++pin) {
+            tags.set_pin(pin, names[pin - 1]);
+            CHECK(metrics_bus::publish("contact", tags.key(), tags.values[3], static_cast<float>(pin * 10 + round),
+                                       round * 1000 + pin));
+        }
+    }
+    CHECK_EQ(metrics_bus::series_count() - before, 8u);
+    for (int pin = 1; pin <= 8; ++pin) {
+        const metrics_bus::Series* s = metrics_bus::find("contact", names[pin - 1]);
+        CHECK(s != nullptr);
+        if (!s) continue;
+        CHECK_EQ(s->sequence(), 3u);
+        metrics_bus::Sample sample;
+        CHECK(s->latest(sample));
+        CHECK_NEAR(sample.value, pin * 10 + 2, 0.0);
+        CHECK_EQ(sample.t_ms, 2000u + pin);
+    }
+    // The same metric from another expander with the same pin names is another source
+    Tags other;
+    snprintf(other.values[1], sizeof(other.values[1]), "2");
+    other.set_pin(1, "door");
+    CHECK(metrics_bus::publish("contact", other.key(), "door", 5.0f, 1));
+    CHECK_EQ(metrics_bus::series_count() - before, 9u);
+    // find() returns the first registered
+    metrics_bus::Sample first;
+    CHECK(metrics_bus::find("contact", "door")->latest(first));
+    CHECK_NEAR(first.value, 12.0, 0.0);
+}
+
+TEST(history_keeps_the_last_samples) {
+    const uint32_t key = metrics_bus::SourceKey().add("name").add("environment").value();
+    for (uint32_t i = 0; i < 100; ++i) metrics_bus::publish("temperature", key, "environment", 20.0f + i, i);
+    const metrics_bus::Series* s = metrics_bus::find("temperature", "environment");
+    CHECK(s != nullptr);
+    if (!s) return;
+    CHECK_EQ(s->sequence(), 100u);
+    metrics_bus::Sample sample;
+    for (uint32_t seq = 100 - metrics_bus::kHistory; seq < 100; ++seq) {
+        CHECK(s->read(seq, sample));
+        CHECK_EQ(sample.t_ms, seq);
+    }
+    CHECK(!s->read(100 - metrics_bus::kHistory - 1, sample)); // overwritten
+    CHECK(!s->read(100, sample));                              // not yet written
+    CHECK(metrics_bus::find("temperature") == s);
+    CHECK(metrics_bus::find("temperature", "kitchen") == nullptr);
+    CHECK(metrics_bus::find(nullptr) == nullptr);
+    CHECK(!metrics_bus::publish(nullptr, key, "environment", 1.0f, 0));
+}
+
+TEST(reader_never_sees_a_torn_sample) {
+    // The writer keeps value == t_ms; a successful read must return a matching pair
+    const uint32_t key = metrics_bus::SourceKey().add("name").add("race").value();
+    metrics_bus::Series* s = metrics_bus::find_or_create("race", key, "race");
+    CHECK(s != nullptr);
+    if (!s) return;
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        for (uint32_t i = 1; !stop.load(std::memory_order_relaxed); ++i) s->publish(static_cast<float>(i & 0xFFFFF), i & 0xFFFFF);
+    });
+    while (s->sequence() < metrics_bus::kHistory) std::this_thread::yield();
+    uint64_t reads = 0, torn = 0;
+    for (int i = 0; i < 200000; ++i) {
+        // The newest slot is usually still being written; look a few back, into the ones being overwritten
+        metrics_bus::Sample sample;
+        const uint32_t head = s->sequence();
+        for (uint32_t back = 2; back <= 8 && back <= head; ++back) {
+            if (!s->read(head - back, sample)) continue;
+            ++reads;
+            torn += static_cast<uint32_t>(sample.value) != sample.t_ms;
+        }
+    }
+    stop = true;
+    writer.join();
+    CHECK(reads > 0);
+    CHECK_EQ(torn, 0u);
+}
+
+TEST(full_table_drops_and_counts) {
+    // Runs last: fills the process-wide table
+    const uint32_t dropped_before = metrics_bus::dropped_series();
+    uint32_t created = 0;
+    for (uint32_t i = 0; i < metrics_bus::kMaxSeries + 5; ++i) {
+        if (metrics_bus::publish("filler", metrics_bus::SourceKey().add("n").add(std::to_string(i).c_str()).value(),
+                                 "", 1.0f, 0)) {
+            ++created;
+        }
+    }
+    CHECK_EQ(metrics_bus::series_count(), metrics_bus::kMaxSeries);
+    CHECK_EQ(metrics_bus::dropped_series() - dropped_before, metrics_bus::kMaxSeries + 5 - created);
+    // Existing series still take samples
+    const uint32_t key = metrics_bus::SourceKey().add("name").add("environment").value();
+    CHECK(metrics_bus::publish("temperature", key, "environment", 1.0f, 0));
+}
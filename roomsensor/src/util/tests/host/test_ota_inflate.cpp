@@ -0,0 +1,253 @@
+// ota_inflate.cpp with a file standing in for the OTA partition: good compressed and plain streams fed in
+// download-sized and odd chunks, truncated, corrupt and oversize streams, trailing bytes, and the SHA-256
+// check ota.cpp makes against the manifest digest.
+#include "host_test.h"
+#include "ota_inflate.h"
+
+#include <openssl/sha.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t kPartition = 4000 * 1024; // ota_0 in partitions.csv
+constexpr size_t kChunk = 2048;            // esp_http_client_read buffer in ota.cpp
+
+// Appends to a file and refuses to run past the partition end, like esp_partition_write
+struct FileSink {
+    FILE* f = nullptr;
+    size_t written = 0;
+    size_t capacity = kPartition;
+
+    explicit FileSink(const char* name) {
+        path = (std::filesystem::temp_directory_path() / (std::string("ota_inflate_") + name + ".bin")).string();
+        f = fopen(path.c_str(), "wb+");
+    }
+    ~FileSink() {
+        if (f) fclose(f);
+        std::filesystem::remove(path);
+    }
+    std::vector<uint8_t> contents() {
+        fflush(f);
+        std::vector<uint8_t> out(written);
+        rewind(f);
+        size_t n = fread(out.data(), 1, out.size(), f);
+        out.resize(n);
+        return out;
+    }
+
+    std::string path;
+};
+
+esp_err_t file_sink(void* ctx, const uint8_t* data, size_t len) {
+    auto* s = static_cast<FileSink*>(ctx);
+    if (s->written + len > s->capacity) return ESP_ERR_INVALID_SIZE;
+    if (fwrite(data, 1, len, s->f) != len) return ESP_FAIL;
+    s->written += len;
+    return ESP_OK;
+}
+
+// Firmware-like content: repeated instruction-ish runs with some entropy, so it compresses but not trivially
+std::vector<uint8_t> make_image(size_t n, uint32_t seed = 1) {
+    std::vector<uint8_t> img(n);
+    uint32_t x = seed * 2654435761u + 1;
+    for (size_t i = 0; i < n; ++i) {
+        if (i % 64 < 40) {
+            img[i] = (uint8_t)((i * 7) ^ (i >> 8));
+        } else {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            img[i] = (uint8_t)x;
+        }
+    }
+    return img;
+}
+
+std::vector<uint8_t> deflate_image(const std::vector<uint8_t>& img) {
+    uLongf n = compressBound(img.size());
+    std::vector<uint8_t> out(n);
+    compress2(out.data(), &n, img.data(), img.size(), Z_BEST_COMPRESSION);
+    out.resize(n);
+    return out;
+}
+
+std::string sha256_hex(const std::vector<uint8_t>& data) {
+    uint8_t d[32];
+    SHA256(data.data(), data.size(), d);
+    std::string hex;
+    char b[3];
+    for (uint8_t v : d) {
+        snprintf(b, sizeof(b), "%02x", v);
+        hex += b;
+    }
+    return hex;
+}
+
+struct Result {
+    esp_err_t feed = ESP_OK;
+    esp_err_t finish = ESP_OK;
+    uint8_t sha[32] = {};
+    size_t size = 0;
+};
+
+// Drives the stream the way stream_ota_from_url does: feed until an error, then finish
+Result run(bool compressed, const std::vector<uint8_t>& stream, size_t chunk, FileSink& sink) {
+    Result r;
+    ota_inflate_t* s = ota_inflate_create(compressed, file_sink, &sink);
+    CHECK(s != nullptr);
+    if (!s) return r;
+    for (size_t ofs = 0; ofs < stream.size() && r.feed == ESP_OK; ofs += chunk) {
+        r.feed = ota_inflate_feed(s, stream.data() + ofs, std::min(chunk, stream.size() - ofs));
+    }
+    if (r.feed == ESP_OK) r.finish = ota_inflate_finish(s, r.sha, &r.size);
+    ota_inflate_destroy(s);
+    return r;
+}
+
+bool digest_matches(const Result& r, const std::string& manifest_hex) {
+    uint8_t expected[32];
+    return ota_parse_sha256_hex(manifest_hex.c_str(), expected) && memcmp(expected, r.sha, 32) == 0;
+}
+
+} // namespace
+
+TEST(compressed_stream_lands_byte_exact) {
+    const auto img = make_image(900 * 1024);
+    const auto z = deflate_image(img);
+    CHECK(z.size() < img.size());
+    FileSink sink("good");
+    Result r = run(true, z, kChunk, sink);
+    CHECK_EQ(r.feed, ESP_OK);
+    CHECK_EQ(r.finish, ESP_OK);
+    CHECK_EQ(r.size, img.size());
+    CHECK(sink.contents() == img);
+    CHECK(digest_matches(r, sha256_hex(img)));
+}
+
+TEST(odd_chunk_sizes_give_the_same_image) {
+    const auto img = make_image(200 * 1024, 7);
+    const auto z = deflate_image(img);
+    for (size_t chunk : {size_t(1), size_t(13), size_t(4093), z.size()}) {
+        FileSink sink("chunks");
+        Result r = run(true, z, chunk, sink);
+        CHECK_EQ(r.finish, ESP_OK);
+        CHECK(sink.contents() == img);
+        CHECK(digest_matches(r, sha256_hex(img)));
+    }
+}
+
+TEST(plain_stream_passes_through) {
+    const auto img = make_image(100 * 1024, 3);
+    FileSink sink("plain");
+    Result r = run(false, img, kChunk, sink);
+    CHECK_EQ(r.finish, ESP_OK);
+    CHECK_EQ(r.size, img.size());
+    CHECK(sink.contents() == img);
+    CHECK(digest_matches(r, sha256_hex(img)));
+}
+
+TEST(truncated_stream_fails_at_finish) {
+    const auto img = make_image(300 * 1024);
+    auto z = deflate_image(img);
+    for (size_t keep : {z.size() - 1, z.size() / 2, size_t(2)}) {
+        FileSink sink("trunc");
+        Result r = run(true, std::vector<uint8_t>(z.begin(), z.begin() + keep), kChunk, sink);
+        CHECK_EQ(r.feed, ESP_OK);
+        CHECK_EQ(r.finish, ESP_ERR_INVALID_SIZE);
+        CHECK(keep == z.size() - 1 || sink.written < img.size()); // a cut trailer still has every byte out
+    }
+}
+
+TEST(corrupt_stream_is_rejected) {
+    const auto img = make_image(300 * 1024);
+    const auto z = deflate_image(img);
+
+    auto bad_header = z;
+    bad_header[0] ^= 0xFF;
+    FileSink sink_header("bad_header");
+    CHECK_EQ(run(true, bad_header, kChunk, sink_header).feed, ESP_ERR_INVALID_RESPONSE);
+    CHECK_EQ(sink_header.written, size_t(0));
+
+    // A flipped body byte fails either in the block structure or at the Adler-32 trailer
+    for (size_t at : {z.size() / 3, z.size() / 2, z.size() - 2}) {
+        auto bad = z;
+        bad[at] ^= 0x5A;
+        FileSink sink("bad_body");
+        CHECK_EQ(run(true, bad, kChunk, sink).feed, ESP_ERR_INVALID_RESPONSE);
+    }
+
+    FileSink sink_garbage("garbage");
+    CHECK_EQ(run(true, make_image(8 * 1024, 9), kChunk, sink_garbage).feed, ESP_ERR_INVALID_RESPONSE);
+}
+
+TEST(oversize_image_stops_at_the_partition_end) {
+    // A small download that inflates past the partition: the sink's error comes back from feed
+    const std::vector<uint8_t> img(kPartition + 64 * 1024, 0xFF);
+    const auto z = deflate_image(img);
+    CHECK(z.size() < 16 * 1024);
+    FileSink sink("oversize");
+    Result r = run(true, z, kChunk, sink);
+    CHECK_EQ(r.feed, ESP_ERR_INVALID_SIZE);
+    CHECK(sink.written <= kPartition);
+
+    FileSink plain_sink("oversize_plain");
+    CHECK_EQ(run(false, img, kChunk, plain_sink).feed, ESP_ERR_INVALID_SIZE);
+}
+
+TEST(sink_error_is_passed_through) {
+    const auto z = deflate_image(make_image(64 * 1024));
+    ota_inflate_t* s = ota_inflate_create(true, [](void*, const uint8_t*, size_t) -> esp_err_t { return ESP_FAIL; },
+                                          nullptr);
+    CHECK_EQ(ota_inflate_feed(s, z.data(), z.size()), ESP_FAIL);
+    ota_inflate_destroy(s);
+}
+
+TEST(trailing_bytes_after_stream_are_ignored) {
+    const auto img = make_image(50 * 1024);
+    auto z = deflate_image(img);
+    z.insert(z.end(), 100, 0xAB);
+    FileSink sink("trailing");
+    Result r = run(true, z, kChunk, sink);
+    CHECK_EQ(r.finish, ESP_OK);
+    CHECK(sink.contents() == img);
+}
+
+TEST(sha256_mismatch_is_detected) {
+    const auto img = make_image(256 * 1024);
+    const std::string manifest = sha256_hex(img);
+
+    // Well-formed stream of a different build: inflates cleanly, digest disagrees with the manifest
+    auto other = img;
+    other[other.size() / 2] ^= 1;
+    FileSink sink("mismatch");
+    Result r = run(true, deflate_image(other), kChunk, sink);
+    CHECK_EQ(r.finish, ESP_OK);
+    CHECK_EQ(r.size, img.size());
+    CHECK(!digest_matches(r, manifest));
+
+    FileSink sink_ok("match");
+    CHECK(digest_matches(run(true, deflate_image(img), kChunk, sink_ok), manifest));
+}
+
+TEST(manifest_digest_parsing) {
+    uint8_t d[32];
+    const std::string hex = sha256_hex(make_image(16));
+    CHECK(ota_parse_sha256_hex(hex.c_str(), d));
+    std::string upper = hex;
+    for (char& c : upper) c = (char)toupper((unsigned char)c);
+    uint8_t u[32];
+    CHECK(ota_parse_sha256_hex(upper.c_str(), u));
+    CHECK(memcmp(d, u, 32) == 0);
+    CHECK(!ota_parse_sha256_hex(hex.substr(1).c_str(), d));
+    CHECK(!ota_parse_sha256_hex((hex + "0").c_str(), d));
+    CHECK(!ota_parse_sha256_hex(("g" + hex.substr(1)).c_str(), d));
+    CHECK(!ota_parse_sha256_hex(nullptr, d));
+}
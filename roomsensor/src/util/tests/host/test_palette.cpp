@@ -0,0 +1,176 @@
+// Palette-indexed strip mode (LEDPalette.h, LEDStripSurfaceAdapter / LEDSurfaceImpl): index -> RGB expansion
+// on the 8-bit and dithered 16-bit paths, palette-only refreshes, leaving the mode, and the long-strip
+// Rainbow and Sunset paths against their per-pixel rendering of the same frame.
+#include "host_test.h"
+#include "fake_strip.h"
+#include "LEDStripBuffer.h"
+#include "RainbowPattern.h"
+#include "SunsetPattern.h"
+#include "esp_random.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using leds::LEDPalette;
+
+namespace {
+
+constexpr uint64_t kFlushAlways = 10ull * 1000 * 1000;
+
+LEDPalette test_palette() {
+    LEDPalette p;
+    for (int i = 0; i < 256; ++i) p.set8(static_cast<uint8_t>(i), i, 255 - i, (i * 3) & 0xFF, i / 2);
+    return p;
+}
+
+uint8_t index_of(size_t px) { return static_cast<uint8_t>((px * 7) % 256); }
+
+// Largest per-channel difference between two captured frames
+int max_diff(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b) {
+    if (a.size() != b.size()) return 256;
+    int d = 0;
+    for (size_t i = 0; i < a.size(); ++i) d = std::max(d, std::abs(a[i] - b[i]));
+    return d;
+}
+
+void check_expansion(bool dither) {
+    const size_t n = 300;
+    std::vector<uint8_t> wire;
+    auto strip = make_adapter(n, &wire, dither);
+    CHECK(strip->set_indexed_mode(true));
+    CHECK(strip->indexed_mode());
+    const LEDPalette pal = test_palette();
+    strip->set_palette(pal);
+    for (size_t i = 0; i < n; ++i) strip->set_pixel_index(i, index_of(i));
+    CHECK(strip->flush_if_dirty(0, kFlushAlways));
+    CHECK_EQ(wire.size(), n * 4);
+    size_t wrong = 0;
+    for (size_t i = 0; i < n && wire.size() == n * 4; ++i) {
+        const uint8_t k = index_of(i);
+        uint8_t r = 0, g = 0, b = 0, w = 0;
+        CHECK(strip->get_pixel(i, r, g, b, w));
+        for (int c = 0; c < 4; ++c) {
+            const uint8_t want = leds::narrow_u16(pal.rgbw[k][c]);
+            wrong += wire[i * 4 + c] != want;
+        }
+        wrong += r != leds::narrow_u16(pal.rgbw[k][0]) || w != leds::narrow_u16(pal.rgbw[k][3]);
+    }
+    CHECK_EQ(wrong, 0u);
+}
+
+} // namespace
+
+TEST(indices_expand_to_palette_colors) { check_expansion(false); }
+
+TEST(indices_expand_through_the_dithered_16_bit_path) { check_expansion(true); }
+
+TEST(rgb_strip_refuses_indexed_mode) {
+    leds::LEDStripBuffer buf(1, 8, config::LEDConfig::Chip::WS2812);
+    CHECK(!buf.set_indexed_mode(true));
+    CHECK(buf.set_indexed_mode(false));
+    CHECK(!buf.set_pixel_index(0, 1));
+}
+
+TEST(palette_change_alone_refreshes_the_frame) {
+    const size_t n = 64;
+    std::vector<uint8_t> wire;
+    auto strip = make_adapter(n, &wire);
+    strip->set_indexed_mode(true);
+    LEDPalette pal = test_palette();
+    strip->set_palette(pal);
+    for (size_t i = 0; i < n; ++i) strip->set_pixel_index(i, static_cast<uint8_t>(i % 4));
+    CHECK(strip->flush_if_dirty(0, kFlushAlways));
+    // Same indices, same palette: nothing to send
+    CHECK(!strip->set_pixel_index(3, 3));
+    strip->set_palette(pal);
+    CHECK(!strip->flush_if_dirty(1, kFlushAlways));
+    // One entry changes: every pixel that references it follows
+    pal.set8(2, 1, 2, 3, 4);
+    strip->set_palette(pal);
+    CHECK(strip->flush_if_dirty(2, kFlushAlways));
+    for (size_t i = 2; i < n; i += 4) {
+        CHECK_EQ(wire[i * 4], 1);
+        CHECK_EQ(wire[i * 4 + 3], 4);
+    }
+    CHECK_EQ(wire[0], 0);
+}
+
+TEST(rgb_write_leaves_indexed_mode_and_keeps_the_frame) {
+    const size_t n = 32;
+    std::vector<uint8_t> wire;
+    auto strip = make_adapter(n, &wire, true);
+    strip->set_indexed_mode(true);
+    const LEDPalette pal = test_palette();
+    strip->set_palette(pal);
+    for (size_t i = 0; i < n; ++i) strip->set_pixel_index(i, index_of(i));
+    strip->flush_if_dirty(0, kFlushAlways);
+    const std::vector<uint8_t> before = wire;
+
+    strip->set_pixel(0, 9, 9, 9, 9);
+    CHECK(!strip->indexed_mode());
+    CHECK(!strip->set_pixel_index(1, 0));
+    CHECK(strip->flush_if_dirty(1, kFlushAlways));
+    CHECK_EQ(wire[0], 9);
+    // Everything else continues from the palette colors it showed
+    CHECK(std::equal(wire.begin() + 4, wire.end(), before.begin() + 4));
+    // A pixel rewritten with the color it already shows is not a change
+    uint8_t r = 0, g = 0, b = 0, w = 0;
+    CHECK(strip->get_pixel(5, r, g, b, w));
+    CHECK(!strip->set_pixel(5, r, g, b, w));
+}
+
+TEST(long_strip_rainbow_matches_per_pixel) {
+    // Hue bands are 360/256 degrees wide: at most about 6 LSB from evaluating every pixel
+    for (size_t n : {size_t(257), size_t(1024)}) {
+        std::vector<uint8_t> wire_idx, wire_rgb;
+        auto indexed = make_adapter(n, &wire_idx);
+        auto plain = make_adapter(n, &wire_rgb);
+        RgbOnlyStrip rgb(*plain);
+        leds::RainbowPattern a, b;
+        a.reset(*indexed, 0);
+        b.reset(rgb, 0);
+        int worst = 0;
+        for (uint64_t t = 0; t < 3'000'000; t += 250'000) {
+            a.update(*indexed, t);
+            b.update(rgb, t);
+            indexed->flush_if_dirty(t, kFlushAlways);
+            rgb.flush_if_dirty(t, kFlushAlways);
+            worst = std::max(worst, max_diff(wire_idx, wire_rgb));
+        }
+        CHECK(indexed->indexed_mode());
+        CHECK(!plain->indexed_mode());
+        CHECK(worst <= 7);
+    }
+    // Up to one pixel per band the pattern stays per-pixel
+    std::vector<uint8_t> wire;
+    auto short_strip = make_adapter(LEDPalette::kSize, &wire);
+    leds::RainbowPattern p;
+    p.reset(*short_strip, 0);
+    p.update(*short_strip, 0);
+    CHECK(!short_strip->indexed_mode());
+}
+
+TEST(long_strip_sunset_matches_per_pixel) {
+    // Lobes are a quarter of the strip wide; sampling them at band centers stays within a few LSB
+    const size_t n = 1024;
+    std::vector<uint8_t> wire_idx, wire_rgb;
+    auto indexed = make_adapter(n, &wire_idx, true);
+    auto plain = make_adapter(n, &wire_rgb, true);
+    RgbOnlyStrip rgb(*plain);
+    leds::SunsetPattern a, b;
+    host_random_seed(77);
+    a.reset(*indexed, 0);
+    host_random_seed(77);
+    b.reset(rgb, 0);
+    int worst = 0;
+    for (uint64_t t = 0; t < 60'000'000; t += 2'000'000) {
+        a.update(*indexed, t);
+        b.update(rgb, t);
+        indexed->flush_if_dirty(t, kFlushAlways);
+        rgb.flush_if_dirty(t, kFlushAlways);
+        worst = std::max(worst, max_diff(wire_idx, wire_rgb));
+    }
+    CHECK(indexed->indexed_mode());
+    if (worst > 4) fprintf(stderr, "    sunset: max difference %d LSB\n", worst);
+    CHECK(worst <= 4);
+}
@@ -0,0 +1,305 @@
+// Pattern switching: PatternTransition (hard cut and crossfade at a frame boundary) and PrepareTracker
+// (which prepared switches the update loop installs), plus the handoff between them as LEDManager
+// drives it.
+#include "host_test.h"
+#include "LEDPatternTransition.h"
+#include "LEDPrepareTracker.h"
+
+#include <deque>
+#include <memory>
+
+using config::LEDConfig;
+using leds::LEDPattern;
+using leds::LEDStrip;
+using leds::LEDStripBuffer;
+using leds::PatternTransition;
+using leds::PrepareTracker;
+
+namespace {
+
+constexpr uint64_t kTickUs = 5'000;
+
+// Fills the strip with one color on every update and counts the calls
+class FillPattern : public LEDPattern {
+public:
+    FillPattern(uint8_t r, uint8_t g, uint8_t b, int* updates = nullptr) : r_(r), g_(g), b_(b), updates_(updates) {}
+    const char* name() const override { return "fill"; }
+    void update(LEDStrip& strip, uint64_t) override {
+        if (updates_) ++*updates_;
+        for (size_t i = 0; i < strip.length(); ++i) strip.set_pixel(i, r_, g_, b_, 0);
+    }
+    uint8_t r_, g_, b_;
+
+private:
+    int* updates_;
+};
+
+// Never writes: whatever was on the strip stays
+class StillPattern : public LEDPattern {
+public:
+    const char* name() const override { return "still"; }
+    void update(LEDStrip&, uint64_t) override {}
+};
+
+LEDStripBuffer make_strip() { return LEDStripBuffer(1, 8, LEDConfig::Chip::WS2812); }
+
+// Incoming pattern warmed up on its own buffer, as the prepare task hands it over
+std::unique_ptr<LEDStripBuffer> warmed(LEDPattern& p) {
+    std::unique_ptr<LEDStripBuffer> buf(new LEDStripBuffer(1, 8, LEDConfig::Chip::WS2812));
+    p.reset(*buf, 0);
+    p.update(*buf, 0);
+    return buf;
+}
+
+void pixel(const LEDStrip& s, size_t i, uint8_t* rgbw) { s.get_pixel(i, rgbw[0], rgbw[1], rgbw[2], rgbw[3]); }
+
+bool all_pixels(const LEDStrip& s, uint8_t r, uint8_t g, uint8_t b) {
+    for (size_t i = 0; i < s.length(); ++i) {
+        uint8_t px[4] = {};
+        pixel(s, i, px);
+        if (px[0] != r || px[1] != g || px[2] != b) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(hard_cut_installs_the_warmed_frame) {
+    LEDStripBuffer strip = make_strip();
+    FillPattern(255, 0, 0).update(strip, 0);
+    std::unique_ptr<LEDPattern> incoming(new FillPattern(0, 0, 255));
+    auto buf = warmed(*incoming);
+    PatternTransition tr;
+    CHECK(tr.begin(std::unique_ptr<LEDPattern>(new FillPattern(255, 0, 0)), std::move(incoming), std::move(buf),
+                   strip, 1000, 0));
+    CHECK(tr.done());
+    CHECK(!tr.active());
+    // The first frame is on the strip before the incoming pattern ever ran against it
+    CHECK(all_pixels(strip, 0, 0, 255));
+    std::unique_ptr<LEDPattern> p = tr.take_incoming();
+    CHECK(p != nullptr);
+    CHECK(!tr.done());
+}
+
+TEST(no_outgoing_pattern_is_a_hard_cut) {
+    LEDStripBuffer strip = make_strip();
+    std::unique_ptr<LEDPattern> incoming(new FillPattern(0, 255, 0));
+    auto buf = warmed(*incoming);
+    PatternTransition tr;
+    CHECK(tr.begin(nullptr, std::move(incoming), std::move(buf), strip, 1000, 500'000));
+    CHECK(all_pixels(strip, 0, 255, 0));
+    CHECK(tr.take_incoming() != nullptr);
+}
+
+TEST(crossfade_blends_linearly_and_finishes_on_time) {
+    LEDStripBuffer strip = make_strip();
+    FillPattern(255, 0, 0).update(strip, 0);
+    int out_updates = 0, in_updates = 0;
+    std::unique_ptr<LEDPattern> incoming(new FillPattern(0, 0, 255, &in_updates));
+    auto buf = warmed(*incoming);
+    in_updates = 0;
+    PatternTransition tr;
+    const uint64_t start = 1'000'000, fade = 200'000;
+    CHECK(!tr.begin(std::unique_ptr<LEDPattern>(new FillPattern(255, 0, 0, &out_updates)), std::move(incoming),
+                    std::move(buf), strip, start, fade));
+    CHECK(tr.active());
+    CHECK(tr.incoming() != nullptr);
+
+    int prev_red = 256;
+    int prev_blue = -1;
+    uint64_t t = start;
+    int frames = 0;
+    while (!tr.step(strip, t)) {
+        uint8_t px[4] = {};
+        pixel(strip, 3, px);
+        // Monotonic, complementary and never overshooting
+        CHECK(px[0] <= prev_red);
+        CHECK(px[2] >= prev_blue);
+        CHECK(px[0] + px[2] >= 254 && px[0] + px[2] <= 255);
+        const double expect_blue = 255.0 * static_cast<double>(t - start) / fade;
+        CHECK_NEAR(px[2], expect_blue, 2.0); // blend weight and channel both truncate
+        prev_red = px[0];
+        prev_blue = px[2];
+        t += kTickUs;
+        ++frames;
+        if (frames > 1000) break;
+    }
+    CHECK_EQ(frames, static_cast<int>(fade / kTickUs));
+    CHECK(all_pixels(strip, 0, 0, 255));
+    CHECK(tr.done());
+    CHECK(!tr.active());
+    // Both patterns kept animating for every blended frame and the final one
+    CHECK_EQ(out_updates, frames + 1);
+    CHECK_EQ(in_updates, frames + 1);
+    CHECK(tr.take_incoming() != nullptr);
+}
+
+TEST(outgoing_continues_from_the_displayed_frame) {
+    LEDStripBuffer strip = make_strip();
+    FillPattern(200, 100, 0).update(strip, 0);
+    std::unique_ptr<LEDPattern> incoming(new FillPattern(0, 0, 0));
+    auto buf = warmed(*incoming);
+    PatternTransition tr;
+    tr.begin(std::unique_ptr<LEDPattern>(new StillPattern()), std::move(incoming), std::move(buf), strip, 0, 100'000);
+    // At t = 0 the blend is all outgoing, and the outgoing buffer holds what was on the strip
+    tr.step(strip, 0);
+    CHECK(all_pixels(strip, 200, 100, 0));
+    tr.step(strip, 50'000);
+    CHECK(all_pixels(strip, 100, 50, 0));
+}
+
+TEST(complete_settles_a_running_fade) {
+    LEDStripBuffer strip = make_strip();
+    std::unique_ptr<LEDPattern> incoming(new FillPattern(0, 0, 255));
+    auto buf = warmed(*incoming);
+    PatternTransition tr;
+    tr.begin(std::unique_ptr<LEDPattern>(new FillPattern(255, 0, 0)), std::move(incoming), std::move(buf), strip, 0,
+             1'000'000);
+    tr.step(strip, 10'000);
+    tr.complete(strip);
+    CHECK(!tr.active());
+    CHECK(tr.done());
+    CHECK(all_pixels(strip, 0, 0, 255));
+    CHECK(!tr.step(strip, 20'000)); // inactive: no-op
+    CHECK(tr.take_incoming() != nullptr);
+}
+
+TEST(cancel_drops_everything) {
+    LEDStripBuffer strip = make_strip();
+    std::unique_ptr<LEDPattern> incoming(new FillPattern(0, 0, 255));
+    auto buf = warmed(*incoming);
+    PatternTransition tr;
+    tr.begin(std::unique_ptr<LEDPattern>(new FillPattern(255, 0, 0)), std::move(incoming), std::move(buf), strip, 0,
+             1'000'000);
+    tr.cancel();
+    CHECK(!tr.active());
+    CHECK(!tr.done());
+    CHECK(tr.incoming() == nullptr);
+    CHECK(tr.take_incoming() == nullptr);
+}
+
+TEST(tracker_accepts_only_the_newest_request) {
+    PrepareTracker pt;
+    pt.reset(2);
+    PrepareTracker::Ticket a = pt.submit(0, LEDConfig::Pattern::RAINBOW);
+    PrepareTracker::Ticket b = pt.submit(0, LEDConfig::Pattern::SOLID);
+    CHECK(!pt.pending(0, LEDConfig::Pattern::RAINBOW));
+    CHECK(pt.pending(0, LEDConfig::Pattern::SOLID));
+    CHECK(!pt.accept(0, a));
+    CHECK(pt.accept(0, b));
+    // Installed once: a duplicate delivery is rejected and nothing is pending any more
+    CHECK(!pt.accept(0, b));
+    CHECK(!pt.pending(0, LEDConfig::Pattern::SOLID));
+}
+
+TEST(tracker_strips_are_independent) {
+    PrepareTracker pt;
+    pt.reset(2);
+    PrepareTracker::Ticket a = pt.submit(0, LEDConfig::Pattern::RAINBOW);
+    PrepareTracker::Ticket b = pt.submit(1, LEDConfig::Pattern::RAINBOW);
+    CHECK(!pt.accept(1, a)); // ticket of another strip
+    CHECK(pt.accept(1, b));
+    CHECK(pt.accept(0, a));
+}
+
+TEST(tracker_abandon_and_rebuild_discard_results) {
+    PrepareTracker pt;
+    pt.reset(1);
+    PrepareTracker::Ticket a = pt.submit(0, LEDConfig::Pattern::FADE);
+    pt.abandon(0);
+    CHECK(!pt.pending(0, LEDConfig::Pattern::FADE));
+    CHECK(!pt.accept(0, a));
+
+    PrepareTracker::Ticket b = pt.submit(0, LEDConfig::Pattern::FADE);
+    pt.reset(1); // strips rebuilt while b was in flight
+    CHECK(!pt.accept(0, b));
+    CHECK(!pt.accept(3, PrepareTracker::Ticket{})); // out of range, never issued
+    // Requests beyond the strip count grow the table
+    PrepareTracker::Ticket c = pt.submit(3, LEDConfig::Pattern::OFF);
+    CHECK(pt.accept(3, c));
+}
+
+TEST(handoff_installs_at_a_frame_boundary) {
+    // The update loop submits switches, the prepare task finishes them in order, and the update loop
+    // installs whatever is still current at the start of its next tick, as LEDManager does
+    struct Job {
+        size_t strip;
+        PrepareTracker::Ticket ticket;
+        LEDConfig::Pattern pattern;
+        std::unique_ptr<LEDPattern> obj;
+        std::unique_ptr<LEDStripBuffer> buf;
+    };
+    std::deque<Job> requests, results;
+    PrepareTracker pt;
+    pt.reset(1);
+    LEDStripBuffer strip = make_strip();
+    std::unique_ptr<LEDPattern> running(new FillPattern(255, 0, 0));
+    LEDConfig::Pattern running_type = LEDConfig::Pattern::SOLID;
+    running->update(strip, 0);
+    PatternTransition tr;
+    int installs = 0;
+
+    auto submit = [&](LEDConfig::Pattern p) {
+        if (p == running_type) {
+            pt.abandon(0);
+            return;
+        }
+        if (pt.pending(0, p)) return;
+        requests.push_back(Job{0, pt.submit(0, p), p, nullptr, nullptr});
+    };
+    auto prepare_one = [&]() {
+        if (requests.empty()) return;
+        Job j = std::move(requests.front());
+        requests.pop_front();
+        const uint8_t blue = j.pattern == LEDConfig::Pattern::RAINBOW ? 255 : 128;
+        j.obj.reset(new FillPattern(0, 0, blue));
+        j.buf = warmed(*j.obj);
+        results.push_back(std::move(j));
+    };
+    auto install = [&](uint64_t now) {
+        while (!results.empty()) {
+            Job j = std::move(results.front());
+            results.pop_front();
+            if (!pt.accept(j.strip, j.ticket)) continue;
+            if (tr.active()) {
+                tr.complete(strip);
+                running = tr.take_incoming();
+            }
+            if (tr.begin(std::move(running), std::move(j.obj), std::move(j.buf), strip, now, 0)) {
+                running = tr.take_incoming();
+            }
+            running_type = j.pattern;
+            ++installs;
+        }
+    };
+
+    // Switch requested, config flips back before the prepare task got to it: nothing is installed
+    submit(LEDConfig::Pattern::RAINBOW);
+    submit(LEDConfig::Pattern::SOLID);
+    prepare_one();
+    install(kTickUs);
+    CHECK_EQ(installs, 0);
+    CHECK(running_type == LEDConfig::Pattern::SOLID);
+    CHECK(all_pixels(strip, 255, 0, 0));
+
+    // The same switch requested twice while in flight is prepared once
+    submit(LEDConfig::Pattern::RAINBOW);
+    submit(LEDConfig::Pattern::RAINBOW);
+    CHECK_EQ(requests.size(), 1u);
+    // Superseded by a newer switch before it finished: only the newer one goes live
+    submit(LEDConfig::Pattern::FADE);
+    prepare_one();
+    prepare_one();
+    install(2 * kTickUs);
+    CHECK_EQ(installs, 1);
+    CHECK(running_type == LEDConfig::Pattern::FADE);
+    CHECK(all_pixels(strip, 0, 0, 128));
+
+    // Strips rebuilt with a result in flight: dropped
+    submit(LEDConfig::Pattern::RAINBOW);
+    prepare_one();
+    pt.reset(1);
+    install(3 * kTickUs);
+    CHECK_EQ(installs, 1);
+    CHECK(running_type == LEDConfig::Pattern::FADE);
+}
@@ -0,0 +1,194 @@
+// main/profiler.cpp with the sample interrupt raised by hand: stack captures exported as collapsed stacks
+// (task naming, outermost-first order, windowed return addresses mapped to call sites, depth cap, identical
+// stacks merged), samples that interrupted another ISR kept apart without a stack, and a hot run's PC table.
+// esp_backtrace_get_next_frame walks g_stack instead of a real task stack.
+#include "host_test.h"
+#include "profiler.h"
+#include "driver/gptimer.h"
+#include "esp_debug_helpers.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+#include "xtensa_context.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" volatile unsigned port_interruptNesting[portNUM_PROCESSORS];
+volatile unsigned port_interruptNesting[portNUM_PROCESSORS];
+
+namespace {
+
+// Return addresses of the sampled stack, innermost first; XtExcFrame::a1 indexes it
+std::vector<uint32_t> g_stack;
+
+// Windowed call8 return address into 'site' + 3, as a0 holds it
+constexpr uint32_t ra(uint32_t site) { return 0x80000000u | ((site + 3) & 0x3fffffffu); }
+
+struct Sampled {
+    host_task task;
+    XtExcFrame frame = {};
+
+    Sampled(const char* name) : task(name, 5) { task.top_of_stack = &frame; }
+};
+
+// One sample interrupt on 'core' while 'task' runs at pc with 'stack' above it; nesting 2 means the
+// interrupt landed in another ISR
+void sample(host_task* task, uint32_t pc, std::vector<uint32_t> stack, int core = 0, unsigned nesting = 1) {
+    g_stack = std::move(stack);
+    if (task && task->top_of_stack) {
+        XtExcFrame* f = static_cast<XtExcFrame*>(task->top_of_stack);
+        f->pc = pc;
+        f->a0 = g_stack.empty() ? 0 : g_stack[0];
+        f->a1 = 0;
+    }
+    host_core_id() = core;
+    host_task_enter(task);
+    port_interruptNesting[core] = nesting;
+    host_gptimer::on_alarm(nullptr, nullptr, nullptr);
+    port_interruptNesting[core] = 0;
+    host_task_enter(nullptr);
+    host_core_id() = 0;
+}
+
+std::vector<std::string> export_lines(esp_err_t* err = nullptr) {
+    std::vector<std::string> lines;
+    esp_err_t e = profiler_capture_export(
+        [](const char* line, size_t len, void* ctx) {
+            static_cast<std::vector<std::string>*>(ctx)->emplace_back(line, len);
+            return 0;
+        },
+        &lines);
+    if (err) *err = e;
+    std::sort(lines.begin(), lines.end());
+    return lines;
+}
+
+std::string hex(uint32_t v) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "0x%08x", (unsigned)v);
+    return buf;
+}
+
+} // namespace
+
+bool esp_backtrace_get_next_frame(esp_backtrace_frame_t* f) {
+    f->pc = f->next_pc;
+    f->sp++;
+    f->next_pc = f->sp < g_stack.size() ? g_stack[f->sp] : 0;
+    return true;
+}
+
+TEST(export_needs_a_finished_capture) {
+    esp_err_t err;
+    export_lines(&err);
+    CHECK_EQ(err, ESP_ERR_NOT_FOUND);
+    CHECK_EQ(profiler_capture_export(nullptr, nullptr), ESP_ERR_INVALID_ARG);
+    CHECK_EQ(profiler_capture_start(1000, PROFILER_CAPTURE_MAX_RATE_HZ + 1), ESP_ERR_INVALID_ARG);
+    CHECK_EQ(profiler_capture_start(PROFILER_CAPTURE_MAX_SECONDS * 1000 + 1, 10), ESP_ERR_INVALID_ARG);
+}
+
+TEST(capture_exports_collapsed_stacks) {
+    CHECK_EQ(profiler_capture_start(1000, 100), ESP_OK);
+    CHECK_EQ(host_gptimer::live, portNUM_PROCESSORS);
+    CHECK(host_gptimer::on_alarm != nullptr);
+    if (!host_gptimer::on_alarm) return;
+    CHECK_EQ(profiler_capture_start(1000, 100), ESP_ERR_INVALID_STATE);
+
+    Sampled sensor("sensor"), led("led");
+    const std::vector<uint32_t> chain = {ra(0x42002000), ra(0x42003000), ra(0x40378010)};
+    for (int i = 0; i < 3; ++i) sample(&sensor.task, 0x42001234, chain);
+    sample(&sensor.task, 0x42001300, chain);
+    // Deeper than PROFILER_MAX_DEPTH: the outermost frames are cut
+    std::vector<uint32_t> deep;
+    for (uint32_t i = 0; i < 12; ++i) deep.push_back(ra(0x42006000 + i * 0x100));
+    sample(&led.task, 0x42005000, deep, 1);
+    sample(&led.task, 0x42005000, deep, 1);
+    // Interrupted another ISR, or no task yet: counted, no stack
+    sample(&sensor.task, 0x42001234, chain, 0, 2);
+    sample(&led.task, 0x42005000, deep, 1, 3);
+    sample(nullptr, 0, {});
+    // Idle is captured like any task
+    host_task* idle = xTaskGetIdleTaskHandleForCore(0);
+    XtExcFrame idle_frame = {};
+    idle->top_of_stack = &idle_frame;
+    sample(idle, 0x4037a000, {});
+
+    esp_err_t err;
+    export_lines(&err);
+    CHECK_EQ(err, ESP_ERR_INVALID_STATE); // still running
+    CHECK(host_esp_timer_fire(host_esp_timer_last()));
+    CHECK_EQ(host_gptimer::live, 0);
+
+    profiler_capture_status_t st;
+    profiler_capture_status(&st);
+    CHECK_EQ(st.state, PROFILER_CAPTURE_DONE);
+    CHECK_EQ(st.stored, 10u);
+    CHECK_EQ(st.summary.samples, 10u);
+    CHECK_EQ(st.summary.isr, 3u);
+    CHECK_EQ(st.summary.idle, 1u);
+    CHECK_EQ(st.summary.flash, 6u);
+    CHECK_EQ(st.summary.dropped, 0u);
+
+    std::string deep_line = "led";
+    for (int d = PROFILER_MAX_DEPTH - 2; d >= 0; --d) deep_line += ";" + hex(0x42006000 + d * 0x100);
+    deep_line += ";0x42005000 2";
+    std::vector<std::string> expected = {
+        "sensor;0x40378010;0x42003000;0x42002000;0x42001234 3",
+        "sensor;0x40378010;0x42003000;0x42002000;0x42001300 1",
+        deep_line,
+        "IDLE0;0x4037a000 1",
+        "[isr] 3",
+    };
+    std::sort(expected.begin(), expected.end());
+    std::vector<std::string> lines = export_lines(&err);
+    CHECK_EQ(err, ESP_OK);
+    CHECK(lines == expected);
+    for (const std::string& l : lines) printf("  %s\n", l.c_str());
+
+    // A callback error aborts; the capture stays exportable
+    int calls = 0;
+    CHECK_EQ(profiler_capture_export([](const char*, size_t, void* ctx) { return ++*static_cast<int*>(ctx); },
+                                     &calls),
+             ESP_FAIL);
+    CHECK_EQ(calls, 1);
+    CHECK(export_lines(&err) == expected);
+    CHECK_EQ(err, ESP_OK);
+    idle->top_of_stack = nullptr;
+
+    // The next capture starts empty
+    CHECK_EQ(profiler_capture_start(100, 10), ESP_OK);
+    CHECK(host_esp_timer_fire(host_esp_timer_last()));
+    CHECK(export_lines(&err).empty());
+    CHECK_EQ(err, ESP_OK);
+}
+
+TEST(hot_run_counts_task_pcs_only) {
+    Sampled sensor("sensor");
+    char* text = nullptr;
+    size_t text_len = 0;
+    FILE* out = open_memstream(&text, &text_len);
+    profiler_hot_summary_t sum = {};
+    esp_err_t err = ESP_FAIL;
+    std::thread run([&] { err = profiler_hot_run(300, 0, 4, out, &sum); });
+    while (host_gptimer::live < portNUM_PROCESSORS) std::this_thread::yield();
+    for (int i = 0; i < 5; ++i) sample(&sensor.task, 0x42001234, {});
+    sample(&sensor.task, 0x40379000, {});
+    sample(&sensor.task, 0x42001234, {}, 0, 2);
+    sample(nullptr, 0, {});
+    run.join();
+    fclose(out);
+
+    CHECK_EQ(err, ESP_OK);
+    CHECK_EQ(sum.samples, 8u);
+    CHECK_EQ(sum.isr, 2u);
+    CHECK_EQ(sum.flash, 5u);
+    CHECK_EQ(sum.iram, 1u);
+    const std::string s(text, text_len);
+    printf("%s", s.c_str());
+    CHECK(s.rfind("# hot samples=8 idle=0 isr=2 dropped=0 iram=1 flash=5", 0) == 0);
+    CHECK(s.find("\n0x42001234 5\n0x40379000 1\n") != std::string::npos);
+    free(text);
+}
@@ -0,0 +1,135 @@
+// publish_slot.h over a simulated fleet: sequential and random MACs, every device waking after the same
+// power outage, publishes bucketed per 100 ms and per second, peak-to-average against the unslotted fleet.
+#include "host_test.h"
+#include "publish_slot.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kInterval = 10000; // METRICS_PUBLISH_SLOT_MS (SENSOR_TASK_INTERVAL_MS)
+constexpr uint32_t kJitter = 500;     // METRICS_PUBLISH_JITTER_MS
+constexpr int kIntervals = 6;
+
+struct Mac {
+    uint8_t b[6];
+};
+
+// One production batch: Espressif OUI, consecutive NIC bytes
+std::vector<Mac> sequential_macs(int n) {
+    std::vector<Mac> macs(n);
+    for (int i = 0; i < n; ++i) {
+        uint32_t nic = 0x3A1200 + (uint32_t)i * 4; // ESP32-S3 burns 4 MACs per chip
+        macs[i] = {{0x24, 0x0A, 0xC4, (uint8_t)(nic >> 16), (uint8_t)(nic >> 8), (uint8_t)nic}};
+    }
+    return macs;
+}
+
+std::vector<Mac> random_macs(int n, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<Mac> macs(n);
+    for (auto& m : macs) {
+        for (auto& b : m.b) b = (uint8_t)rng();
+    }
+    return macs;
+}
+
+// Publish times of the fleet over kIntervals, the way metrics_task schedules them: every device starts at
+// the same wall time (power restored), waits for its slot, publishes, and collects until the next slot.
+// slotted=false is the old behaviour: a fixed interval from boot, so the whole fleet publishes together.
+std::vector<uint64_t> simulate(const std::vector<Mac>& macs, bool slotted, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> frac(0.0f, 1.0f);
+    std::uniform_int_distribution<uint32_t> boot_ms(1500, 2500); // Wi-Fi and SNTP up after the outage
+    const uint64_t outage_end = 1700000000000ull;
+    std::vector<uint64_t> times;
+    for (const auto& m : macs) {
+        uint64_t now = outage_end + boot_ms(rng);
+        const uint32_t offset = publish_slot::offset_for_mac(m.b, kInterval);
+        for (int k = 0; k < kIntervals; ++k) {
+            now += slotted ? publish_slot::ms_until_slot(now, kInterval, offset, kJitter, frac(rng)) : kInterval;
+            times.push_back(now);
+            now += 1; // the publish itself
+        }
+    }
+    return times;
+}
+
+// Peak bucket over the mean bucket, over whole intervals after the first (the first one is still the boot)
+double peak_to_average(const std::vector<uint64_t>& times, uint32_t bucket_ms) {
+    const uint64_t start = *std::min_element(times.begin(), times.end());
+    const uint64_t from = (start / kInterval + 1) * kInterval;
+    const uint64_t to = from + (uint64_t)(kIntervals - 2) * kInterval;
+    std::vector<int> buckets((to - from) / bucket_ms, 0);
+    int total = 0;
+    for (uint64_t t : times) {
+        if (t < from || t >= to) continue;
+        buckets[(t - from) / bucket_ms]++;
+        total++;
+    }
+    const int peak = *std::max_element(buckets.begin(), buckets.end());
+    return (double)peak / ((double)total / (double)buckets.size());
+}
+
+} // namespace
+
+TEST(offsets_stay_inside_the_interval) {
+    for (const auto& m : random_macs(1000, 1)) {
+        CHECK(publish_slot::offset_for_mac(m.b, kInterval) < kInterval);
+    }
+    const Mac m = sequential_macs(1)[0];
+    CHECK_EQ(publish_slot::offset_for_mac(m.b, 0), 0u);
+}
+
+TEST(wait_lands_on_the_slot) {
+    for (uint64_t now : {0ull, 1ull, 9999ull, 10000ull, 1700000012345ull}) {
+        for (uint32_t offset : {0u, 1u, 4321u, 9999u}) {
+            uint32_t wait = publish_slot::ms_until_slot(now, kInterval, offset, 0, 0.0f);
+            CHECK(wait < kInterval);
+            CHECK_EQ((uint32_t)((now + wait) % kInterval), offset);
+        }
+    }
+    CHECK_EQ(publish_slot::ms_until_slot(10000, kInterval, 0, kJitter, 0.5f), 250u);
+    CHECK_EQ(publish_slot::ms_until_slot(10000, kInterval, 0, kJitter, 2.0f), kJitter);
+    CHECK_EQ(publish_slot::ms_until_slot(10000, kInterval, 0, kJitter, -1.0f), 0u);
+}
+
+TEST(sequential_macs_spread_over_the_interval) {
+    // 1 s buckets: 10 per interval, so a 500-device batch averages 50 publishes per bucket
+    const auto macs = sequential_macs(500);
+    const double slotted = peak_to_average(simulate(macs, true, 11), 1000);
+    const double unslotted = peak_to_average(simulate(macs, false, 11), 1000);
+    printf("500 sequential MACs, 1 s buckets: peak/avg %.2f slotted, %.2f unslotted\n", slotted, unslotted);
+    CHECK(slotted < 1.6);
+    CHECK(unslotted > 4.0);
+}
+
+TEST(large_fleet_flattens_at_100ms) {
+    // 1000 devices in 100 ms buckets: 10 per bucket on average; a uniform spread peaks around 2x
+    const auto seq = sequential_macs(1000);
+    const auto rnd = random_macs(1000, 5);
+    const double p_seq = peak_to_average(simulate(seq, true, 3), 100);
+    const double p_rnd = peak_to_average(simulate(rnd, true, 3), 100);
+    const double p_old = peak_to_average(simulate(seq, false, 3), 100);
+    printf("1000 devices, 100 ms buckets: peak/avg %.2f sequential, %.2f random, %.2f unslotted\n", p_seq, p_rnd,
+           p_old);
+    CHECK(p_seq < 2.5);
+    CHECK(p_rnd < 2.5);
+    CHECK(p_old > 8.0);
+}
+
+TEST(every_device_publishes_once_per_interval) {
+    const auto macs = sequential_macs(50);
+    const auto times = simulate(macs, true, 17);
+    for (size_t d = 0; d < macs.size(); ++d) {
+        for (int k = 1; k < kIntervals; ++k) {
+            const uint64_t gap = times[d * kIntervals + k] - times[d * kIntervals + k - 1];
+            // Slot to slot is one interval; the jitter moves each end by up to kJitter
+            CHECK(gap + kJitter >= kInterval);
+            CHECK(gap <= kInterval + kJitter + 1);
+        }
+    }
+}
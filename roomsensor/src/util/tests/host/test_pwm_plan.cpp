@@ -0,0 +1,184 @@
+// pwm_plan.h: timer resolution, gamma duty and fade planning, with every planned fade replayed through
+// FakeLedc the way pwm.cpp chains segments from the fade-end event.
+#include "host_test.h"
+#include "fake_ledc.h"
+#include "pwm_plan.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+using namespace pwm;
+
+namespace {
+
+// pwm.cpp run_plan: direct-duty segments apply at once, a fading one runs until its fade-end event
+uint64_t replay(FakeLedc& led, const FadePlan& plan) {
+    size_t next = 0;
+    auto run = [&] {
+        while (next < plan.count) {
+            const FadeSegment& seg = plan.segments[next++];
+            if (seg.time_ms == 0) {
+                led.set_duty(seg.duty);
+                continue;
+            }
+            led.start_fade(seg.duty, seg.time_ms);
+            return;
+        }
+    };
+    const uint64_t t0 = led.now_periods;
+    run();
+    while (led.fading()) {
+        if (led.tick()) run();
+    }
+    return led.now_periods - t0;
+}
+
+uint32_t plan_ms(const FadePlan& plan) {
+    uint32_t ms = 0;
+    for (size_t i = 0; i < plan.count; ++i) ms += plan.segments[i].time_ms;
+    return ms;
+}
+
+} // namespace
+
+TEST(resolution_fits_the_timer) {
+    CHECK_EQ(max_resolution_bits(0), 0);
+    CHECK_EQ(max_resolution_bits(1000), 14);
+    CHECK_EQ(max_resolution_bits(5000), 13);  // 5 kHz * 2^14 is past 80 MHz
+    CHECK_EQ(max_resolution_bits(40'000'000), 1);
+    CHECK_EQ(max_resolution_bits(80'000'000), 0);
+    CHECK_EQ(effective_resolution_bits(5000, 14), 13);
+    CHECK_EQ(effective_resolution_bits(1000, 0), 7);  // raised: the divider would pass 1023 below 7 bits
+    CHECK_EQ(effective_resolution_bits(100, 8), 10);
+    CHECK_EQ(effective_resolution_bits(1, 8), 0);     // no resolution reaches 1 Hz
+    for (uint32_t f = 5; f <= 40'000'000; f += f / 3 + 1) {
+        for (int req = 0; req <= 16; ++req) {
+            const int bits = effective_resolution_bits(f, req);
+            if (bits == 0) continue;
+            CHECK(static_cast<uint64_t>(f) << bits <= kLedcClockHz);
+            CHECK(kLedcClockHz / (static_cast<uint64_t>(f) << bits) <= kLedcMaxClockDivider);
+        }
+    }
+}
+
+TEST(gamma_duty_is_monotonic_and_never_rounds_to_off) {
+    for (int bits : {1, 8, 10, 14}) {
+        const uint32_t full = (1u << bits) - 1;
+        for (float gamma : {1.0f, 2.2f, 2.8f}) {
+            uint32_t prev = 0;
+            CHECK_EQ(gamma_duty(0, gamma, bits), 0u);
+            CHECK_EQ(gamma_duty(-5, gamma, bits), 0u);
+            CHECK_EQ(gamma_duty(100, gamma, bits), full);
+            CHECK_EQ(gamma_duty(150, gamma, bits), full);
+            for (int level = 1; level <= 100; ++level) {
+                const uint32_t d = gamma_duty(level, gamma, bits);
+                CHECK(d >= 1);
+                CHECK(d >= prev);
+                prev = d;
+            }
+        }
+    }
+    CHECK_EQ(gamma_duty(50, 1.0f, 10), 512u);
+    CHECK_EQ(gamma_duty(50, 2.0f, 10), 256u);
+    CHECK_EQ(gamma_duty(50, 2.2f, 0), 0u);
+}
+
+TEST(fade_time_scales_with_the_change) {
+    CHECK_EQ(fade_time_ms(0, 100, 1000), 1000u);
+    CHECK_EQ(fade_time_ms(100, 0, 1000), 1000u);
+    CHECK_EQ(fade_time_ms(20, 30, 1000), 100u);
+    CHECK_EQ(fade_time_ms(40, 40, 1000), 0u);
+    CHECK_EQ(fade_time_ms(0, 1, 30), 0u); // rounds to a direct set
+    CHECK_EQ(max_linear_fade_ms(10, 1000), 10230u);
+    CHECK_EQ(max_linear_fade_ms(10, 0), 0u);
+}
+
+TEST(unchanged_level_or_zero_time_sets_the_duty) {
+    FadePlan p = plan_fade(30, 30, 2.2f, 12, 1000, 1000);
+    CHECK_EQ(p.count, 1u);
+    CHECK_EQ(p.segments[0].duty, gamma_duty(30, 2.2f, 12));
+    CHECK_EQ(p.segments[0].time_ms, 0u);
+    p = plan_fade(0, 80, 2.2f, 12, 0, 1000);
+    CHECK_EQ(p.count, 1u);
+    CHECK_EQ(p.segments[0].time_ms, 0u);
+}
+
+TEST(gamma_fades_split_into_segments) {
+    FadePlan p = plan_fade(0, 100, 2.2f, 10, 1000, 1000);
+    CHECK(p.count > 1);
+    CHECK_EQ(p.segments[p.count - 1].duty, 1023u);
+    CHECK_EQ(plan_ms(p), 1000u);
+    // Linear output needs no gamma points
+    p = plan_fade(0, 100, 1.0f, 10, 1000, 1000);
+    CHECK_EQ(p.segments[p.count - 1].duty, 1023u);
+    CHECK_EQ(plan_ms(p), 1000u);
+    // A small change gets fewer gamma points than a full one
+    CHECK(plan_fade(50, 55, 2.2f, 10, 1000, 1000).count < plan_fade(0, 100, 2.2f, 10, 1000, 1000).count);
+}
+
+TEST(planned_fades_replay_smoothly_on_ledc) {
+    const int levels[] = {0, 1, 5, 20, 50, 51, 80, 99, 100};
+    uint32_t checked = 0;
+    for (uint32_t freq : {100u, 1000u, 5000u, 20000u}) {
+        for (int req_bits : {8, 10, 12, 14}) {
+            const int bits = effective_resolution_bits(freq, req_bits);
+            if (bits == 0) continue;
+            for (float gamma : {1.0f, 2.2f, 2.8f}) {
+                for (uint32_t fade_ms : {0u, 50u, 400u, 1000u, 3000u}) {
+                    for (int from : levels) {
+                        for (int to : levels) {
+                            const FadePlan plan = plan_fade(from, to, gamma, bits, fade_ms, freq);
+                            CHECK(plan.count >= 1 && plan.count < kMaxFadeSegments); // never cut short by the array
+                            CHECK(plan_ms(plan) <= fade_time_ms(from, to, fade_ms));
+
+                            FakeLedc led(freq, bits);
+                            led.set_duty(gamma_duty(from, gamma, bits));
+                            led.trace.clear();
+                            led.max_jump = 0;
+                            const uint64_t periods = replay(led, plan);
+                            ++checked;
+
+                            // Ends exactly on the target, moving one way only
+                            CHECK_EQ(led.duty(), gamma_duty(to, gamma, bits));
+                            bool monotonic = true;
+                            for (size_t i = 1; i < led.trace.size(); ++i) {
+                                monotonic &= (to >= from) ? led.trace[i] >= led.trace[i - 1] : led.trace[i] <= led.trace[i - 1];
+                            }
+                            CHECK(monotonic);
+
+                            // Every segment runs in hardware to its end: no step count past the limit, so no
+                            // jump bigger than the per-period rate of the steepest segment
+                            CHECK_EQ(led.capped_fades, 0u);
+                            uint32_t rate = 1, prev = gamma_duty(from, gamma, bits);
+                            uint64_t min_periods = 0; // at most kLedcMaxDutyScale counts per period
+                            for (size_t i = 0; i < plan.count; ++i) {
+                                const FadeSegment& s = plan.segments[i];
+                                const uint32_t d = s.duty > prev ? s.duty - prev : prev - s.duty;
+                                const uint64_t cycles = static_cast<uint64_t>(s.time_ms) * freq / 1000;
+                                const uint32_t r = s.time_ms == 0 || cycles == 0 ? d
+                                                   : static_cast<uint32_t>((d + cycles - 1) / cycles);
+                                rate = std::max(rate, r);
+                                if (s.time_ms) min_periods += (d + kLedcMaxDutyScale - 1) / kLedcMaxDutyScale;
+                                prev = s.duty;
+                            }
+                            if (led.max_jump > 2 * rate) {
+                                fprintf(stderr, "    %u Hz %d bits gamma %.1f %u ms %d->%d: jump %u, rate %u\n", freq,
+                                        bits, gamma, fade_ms, from, to, led.max_jump, rate);
+                            }
+                            CHECK(led.max_jump <= 2 * rate);
+
+                            // The driver rounds both the counts per step and the periods per step down, so a
+                            // segment runs between half and twice its time, or longer when it needs more than
+                            // the largest step per period
+                            const uint64_t planned = static_cast<uint64_t>(plan_ms(plan)) * freq / 1000;
+                            CHECK(periods <= 2 * std::max(planned, min_periods) + plan.count);
+                            if (planned >= 20 * plan.count) CHECK(2 * periods >= planned);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    CHECK(checked > 10000);
+}
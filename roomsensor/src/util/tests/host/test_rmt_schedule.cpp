@@ -0,0 +1,114 @@
+// RmtSchedule.h: slot and budget arithmetic, and plan_rmt_channels against a brute-force optimum on small
+// random strip sets (longest-first greedy stays within 4/3 of the best makespan).
+#include "host_test.h"
+#include "RmtSchedule.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace leds::internal;
+
+namespace {
+
+uint32_t max_load(const RmtChannelPlan& plan) {
+    return plan.load_us.empty() ? 0 : *std::max_element(plan.load_us.begin(), plan.load_us.end());
+}
+
+// Smallest achievable max channel load, over every assignment
+uint32_t best_makespan(const std::vector<uint32_t>& slots, size_t channels) {
+    size_t combos = 1;
+    for (size_t i = 0; i < slots.size(); ++i) combos *= channels;
+    uint32_t best = UINT32_MAX;
+    std::vector<uint32_t> load(channels);
+    for (size_t code = 0; code < combos; ++code) {
+        std::fill(load.begin(), load.end(), 0);
+        size_t c = code;
+        for (uint32_t s : slots) {
+            load[c % channels] += s;
+            c /= channels;
+        }
+        best = std::min(best, *std::max_element(load.begin(), load.end()));
+    }
+    return best;
+}
+
+} // namespace
+
+TEST(slot_and_budget_arithmetic) {
+    // 300 RGB LEDs: 7200 bits at 1.25 us, 80 us latch, 40 us reroute
+    CHECK_EQ(rmt_slot_us(300, 24), 9000u + 80u + kRmtRerouteOverheadUs);
+    CHECK_EQ(rmt_slot_us(0, 24), 80u + kRmtRerouteOverheadUs);
+    CHECK_EQ(rmt_frame_budget_us(60), 16666u);
+    CHECK_EQ(rmt_frame_budget_us(100), 10000u);
+    CHECK_EQ(rmt_frame_budget_us(0), UINT32_MAX);
+}
+
+TEST(strips_per_channel) {
+    CHECK_EQ(max_strips_per_channel(100, 24, 60), 5u);  // 3120 us slots in 16666 us
+    CHECK_EQ(max_strips_per_channel(100, 32, 60), 4u);  // RGBW: 4120 us
+    CHECK_EQ(max_strips_per_channel(300, 24, 60), 1u);
+    CHECK_EQ(max_strips_per_channel(1000, 24, 60), 1u); // too long on its own: still one
+    CHECK_EQ(max_strips_per_channel(100, 24, 0), UINT32_MAX / rmt_slot_us(100, 24));
+}
+
+TEST(no_channels_plans_nothing) {
+    RmtChannelPlan plan = plan_rmt_channels({100, 200}, 0, 60);
+    CHECK(!plan.fits);
+    CHECK(plan.load_us.empty());
+    CHECK_EQ(plan.channel_of.size(), 2u);
+    plan = plan_rmt_channels({}, 2, 60);
+    CHECK(plan.fits);
+    CHECK_EQ(max_load(plan), 0u);
+}
+
+TEST(longest_first_onto_least_loaded) {
+    // Sorted: 9000(1) 7000(3) 5000(0) 4000(4) 2000(2)
+    RmtChannelPlan plan = plan_rmt_channels({5000, 9000, 2000, 7000, 4000}, 2, 60);
+    CHECK_EQ(plan.channel_of[1], 0u);
+    CHECK_EQ(plan.channel_of[3], 1u);
+    CHECK_EQ(plan.channel_of[0], 1u);
+    CHECK_EQ(plan.channel_of[4], 0u);
+    CHECK_EQ(plan.channel_of[2], 1u);
+    CHECK_EQ(plan.load_us[0], 13000u);
+    CHECK_EQ(plan.load_us[1], 14000u);
+    CHECK(plan.fits);
+    // Same strips at 100 fps: 10 ms budget
+    plan = plan_rmt_channels({5000, 9000, 2000, 7000, 4000}, 2, 100);
+    CHECK(!plan.fits);
+}
+
+TEST(equal_strips_alternate_by_index) {
+    RmtChannelPlan plan = plan_rmt_channels(std::vector<uint32_t>(6, rmt_slot_us(150, 24)), 3, 60);
+    for (size_t i = 0; i < 6; ++i) CHECK_EQ(plan.channel_of[i], i % 3);
+    CHECK(plan.fits);
+}
+
+TEST(plans_are_consistent_and_near_optimal) {
+    std::mt19937 rng(17);
+    for (int trial = 0; trial < 400; ++trial) {
+        const size_t strips = 1 + rng() % 8;
+        const size_t channels = 1 + rng() % 3;
+        const uint32_t fps = 30 + rng() % 90;
+        std::vector<uint32_t> slots(strips);
+        for (auto& s : slots) s = rmt_slot_us(10 + rng() % 600, (rng() & 1) ? 32 : 24);
+
+        const RmtChannelPlan plan = plan_rmt_channels(slots, channels, fps);
+        CHECK_EQ(plan.budget_us, rmt_frame_budget_us(fps));
+        CHECK_EQ(plan.load_us.size(), channels);
+        std::vector<uint32_t> load(channels, 0);
+        for (size_t i = 0; i < strips; ++i) {
+            CHECK(plan.channel_of[i] < channels);
+            if (plan.channel_of[i] < channels) load[plan.channel_of[i]] += slots[i];
+        }
+        CHECK(load == plan.load_us);
+        CHECK_EQ(plan.fits, max_load(plan) <= plan.budget_us);
+
+        const uint32_t best = best_makespan(slots, channels);
+        CHECK(3 * static_cast<uint64_t>(max_load(plan)) <= 4 * static_cast<uint64_t>(best));
+        // Never worse than the longest strip alone when there is a channel per strip
+        if (channels >= strips) CHECK_EQ(max_load(plan), *std::max_element(slots.begin(), slots.end()));
+        // Deterministic
+        CHECK(plan_rmt_channels(slots, channels, fps).channel_of == plan.channel_of);
+    }
+}
@@ -0,0 +1,100 @@
+// LEDTemporalDither.h: the 16 -> 8 bit quantizer. Every input level is checked for its mean over one dither
+// period, the bounded running error of the diffusion, and steady output (no flicker) where there is no
+// fraction to carry: full, zero and widened 8-bit values.
+#include "host_test.h"
+#include "LEDTemporalDither.h"
+
+#include <cmath>
+#include <vector>
+
+using leds::internal::TemporalDither;
+
+namespace {
+
+constexpr uint32_t kPeriod = TemporalDither::kPeriodFrames;
+
+// The level the quantizer aims for, in output LSBs (0..255)
+double ideal(uint16_t v) { return (v - (v >> 8)) / 256.0; }
+
+} // namespace
+
+TEST(widen_narrow_round_trip) {
+    for (int v = 0; v < 256; ++v) CHECK_EQ(leds::narrow_u16(leds::widen_u8(static_cast<uint8_t>(v))), v);
+    CHECK_EQ(leds::widen_u8(255), 65535);
+}
+
+TEST(full_zero_and_8_bit_levels_do_not_flicker) {
+    TemporalDither d;
+    d.resize(256);
+    std::vector<uint16_t> in(256);
+    for (int v = 0; v < 256; ++v) in[v] = leds::widen_u8(static_cast<uint8_t>(v));
+    std::vector<uint8_t> out(256);
+    for (uint32_t f = 0; f < 4 * kPeriod; ++f) {
+        CHECK(!d.quantize(in.data(), out.data(), in.size()));
+        for (int v = 0; v < 256; ++v) CHECK_EQ(out[v], v);
+    }
+}
+
+TEST(mean_over_one_period_is_within_an_eighth_lsb) {
+    // All 65536 levels at once; each channel starts with an empty residual
+    std::vector<uint16_t> in(65536);
+    for (uint32_t v = 0; v < in.size(); ++v) in[v] = static_cast<uint16_t>(v);
+    TemporalDither d;
+    d.resize(in.size());
+    std::vector<uint8_t> out(in.size());
+    std::vector<uint32_t> sum(in.size(), 0), lo(in.size(), 255), hi(in.size(), 0);
+    for (uint32_t f = 0; f < kPeriod; ++f) {
+        d.quantize(in.data(), out.data(), in.size());
+        for (size_t i = 0; i < in.size(); ++i) {
+            sum[i] += out[i];
+            lo[i] = std::min<uint32_t>(lo[i], out[i]);
+            hi[i] = std::max<uint32_t>(hi[i], out[i]);
+        }
+    }
+    double worst = 0.0;
+    uint32_t worst_at = 0, wide = 0;
+    for (size_t i = 0; i < in.size(); ++i) {
+        const double err = ideal(in[i]) - static_cast<double>(sum[i]) / kPeriod;
+        // Truncation only: never above the input, less than 1/8 LSB below it
+        CHECK(err >= 0.0);
+        if (err > worst) {
+            worst = err;
+            worst_at = static_cast<uint32_t>(i);
+        }
+        // Output toggles between two adjacent codes only
+        wide += hi[i] - lo[i] > 1;
+    }
+    if (worst >= 1.0 / kPeriod) fprintf(stderr, "    worst mean error %.4f LSB at input %u\n", worst, worst_at);
+    CHECK(worst < 1.0 / kPeriod);
+    CHECK_EQ(wide, 0u);
+}
+
+TEST(running_error_stays_bounded) {
+    // Over any number of frames the emitted total tracks the carried level to within one LSB, so the mean
+    // error falls as 1/frames down to the truncation floor
+    const uint16_t levels[] = {1, 31, 257 + 32, 1000, 12345, 32768 + 96, 65534};
+    for (uint16_t v : levels) {
+        TemporalDither d;
+        d.resize(1);
+        const uint32_t x = v - (v >> 8);
+        const double carried = (x >> 8) + static_cast<double>((x & 0xFFu) >> (8 - TemporalDither::kFractionBits)) / kPeriod;
+        double total = 0.0, worst = 0.0;
+        for (uint32_t f = 1; f <= 1000; ++f) {
+            uint8_t out;
+            d.quantize(&v, &out, 1);
+            total += out;
+            worst = std::max(worst, std::fabs(total - f * carried));
+        }
+        CHECK(worst < 1.0);
+        CHECK_NEAR(total / 1000.0, ideal(v), 1.0 / kPeriod);
+    }
+}
+
+TEST(reports_fractional_levels) {
+    TemporalDither d;
+    d.resize(2);
+    const uint16_t in[2] = {leds::widen_u8(10), static_cast<uint16_t>(leds::widen_u8(10) + 64)};
+    uint8_t out[2];
+    CHECK(d.quantize(in, out, 2));
+    CHECK(!d.quantize(in, out, 1));
+}
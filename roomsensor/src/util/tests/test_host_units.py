@@ -0,0 +1,30 @@
+"""
+Host unit tests for the pure firmware modules in tests/host, configured with CMake and run by ctest.
+These need a host C++ compiler and CMake, but no device.
+"""
+import shutil
+import subprocess
+from pathlib import Path
+
+import pytest
+
+HOST_DIR = Path(__file__).resolve().parent / "host"
+BUILD_DIR = HOST_DIR / "build"
+
+pytestmark = pytest.mark.skipif(shutil.which("cmake") is None, reason="cmake not installed")
+
+
+def _run(*args: str) -> subprocess.CompletedProcess:
+    return subprocess.run(args, capture_output=True, text=True)
+
+
+def test_host_units():
+    configure = _run("cmake", "-S", str(HOST_DIR), "-B", str(BUILD_DIR))
+    assert configure.returncode == 0, configure.stdout + configure.stderr
+
+    build = _run("cmake", "--build", str(BUILD_DIR), "-j")
+    assert build.returncode == 0, build.stdout + build.stderr
+
+    tests = _run("ctest", "--test-dir", str(BUILD_DIR), "--output-on-failure")
+    print(tests.stdout)
+    assert tests.returncode == 0, tests.stdout + tests.stderr